@@ -6,7 +6,7 @@ Integrates AI router with tool calling for autonomous task execution
 import json
 from typing import Any, Dict, List, Optional
 
-from ..tools import EditTool, GlobTool, GrepTool, ReadTool, ShellTool, WriteTool
+from ..tools import EditTool, GlobTool, GrepTool, ReadTool, ShellTool, WriteTool, flush_edits
 from .router import AIRouter
 
 
@@ -107,6 +107,8 @@ Be precise with file paths and edits. Always verify before making changes.""",
             return {"success": False, "error": f"Unknown tool: {tool_name}"}
 
         try:
+            if not tool.shares_edit_buffers:
+                flush_edits()
             result = tool.execute(**arguments)
             return result
         except Exception as e:
@@ -142,27 +144,31 @@ Be precise with file paths and edits. Always verify before making changes.""",
             response = self.router.chat(messages=self.messages, tools=self.tool_schemas, **kwargs)
 
             if not response.success:
-                return {
-                    "success": False,
-                    "error": response.error,
-                    "iterations": iterations,
-                    "tool_executions": tool_executions,
-                }
+                return self._end_turn(
+                    {
+                        "success": False,
+                        "error": response.error,
+                        "iterations": iterations,
+                        "tool_executions": tool_executions,
+                    }
+                )
 
             # Check if AI wants to use tools
             if not response.has_tool_calls:
                 # No more tools to execute, we're done
                 self.messages.append({"role": "assistant", "content": response.content})
 
-                return {
-                    "success": True,
-                    "response": response.content,
-                    "provider": response.provider,
-                    "model": response.model,
-                    "usage": response.usage,
-                    "iterations": iterations,
-                    "tool_executions": tool_executions,
-                }
+                return self._end_turn(
+                    {
+                        "success": True,
+                        "response": response.content,
+                        "provider": response.provider,
+                        "model": response.model,
+                        "usage": response.usage,
+                        "iterations": iterations,
+                        "tool_executions": tool_executions,
+                    }
+                )
 
             # Execute tool calls
             for tool_call in response.tool_calls:
@@ -205,12 +211,22 @@ Be precise with file paths and edits. Always verify before making changes.""",
                     )
 
         # Max iterations reached
-        return {
-            "success": False,
-            "error": f"Max iterations ({max_iterations}) reached",
-            "iterations": iterations,
-            "tool_executions": tool_executions,
-        }
+        return self._end_turn(
+            {
+                "success": False,
+                "error": f"Max iterations ({max_iterations}) reached",
+                "iterations": iterations,
+                "tool_executions": tool_executions,
+            }
+        )
+
+    def _end_turn(self, result: Dict[str, Any]) -> Dict[str, Any]:
+        """Write the turn's file edits to disk before reporting its result"""
+        try:
+            flush_edits()
+        except RuntimeError as e:
+            return {**result, "success": False, "error": f"Could not save edits: {e}"}
+        return result
 
     def reset_conversation(self):
         """Clear conversation history"""
@@ -30,6 +30,15 @@ except ImportError:
     FileSystemEventHandler = None
     FileSystemEvent = None
 
+# Optional native lexical index (C++ core)
+try:
+    from isaac.isaac_core import Bm25Index
+
+    NATIVE_SEARCH_AVAILABLE = True
+except ImportError:
+    Bm25Index = None
+    NATIVE_SEARCH_AVAILABLE = False
+
 
 class FileChunker:
     """Smart file chunking with language-aware parsing"""
@@ -458,6 +467,8 @@ class FileWatcherHandler(FileSystemEventHandler if WATCHDOG_AVAILABLE else objec
         # Remove from indexed files
         try:
             file_key = str(file_path.relative_to(self.knowledge_base.project_root))
+            self.knowledge_base.remove_local_file(file_key)
+            self.knowledge_base.notify_change_listeners([], [file_key])
             if file_key in self.knowledge_base.indexed_files:
                 del self.knowledge_base.indexed_files[file_key]
                 self.knowledge_base._save_state()
@@ -558,18 +569,22 @@ class FileWatcher:
 
                     # Index updated files
                     try:
+                        file_keys = []
                         for file_path in files_to_update:
                             # Chunk file
-                            self.knowledge_base.chunker.chunk_file(file_path)
+                            chunks = self.knowledge_base.chunker.chunk_file(file_path)
 
                             # Update hash
                             file_key = str(file_path.relative_to(self.knowledge_base.project_root))
+                            file_keys.append(file_key)
+                            self.knowledge_base.index_local_chunks(file_key, chunks)
                             file_hash = self.knowledge_base._compute_file_hash(file_path)
                             if file_hash:
                                 self.knowledge_base.indexed_files[file_key] = file_hash
 
                         # Save state
                         self.knowledge_base._save_state()
+                        self.knowledge_base.notify_change_listeners(file_keys, [])
 
                         # Notify callback
                         if self.update_callback:
@@ -623,6 +638,15 @@ class ProjectKnowledgeBase:
         self.state_file = Path.home() / ".isaac" / "collections_state.json"
         self.state_file.parent.mkdir(parents=True, exist_ok=True)
 
+        # Local lexical index (native BM25), rebuilt lazily on first search
+        self.local_index = Bm25Index() if NATIVE_SEARCH_AVAILABLE else None
+        self._local_chunks: Dict[int, Dict[str, Any]] = {}  # chunk_id -> chunk
+        self._local_file_chunks: Dict[str, List[int]] = {}  # file_key -> chunk_ids
+        self._local_index_built = False
+
+        # Callbacks (changed_keys, deleted_keys) for other indexes kept fresh by the watcher
+        self._change_listeners: List[Callable[[List[str], List[str]], None]] = []
+
         # Load previous state
         self._load_state()
 
@@ -782,6 +806,7 @@ class ProjectKnowledgeBase:
 
             # Update indexed files tracking
             file_key = str(file_path.relative_to(self.project_root))
+            self.index_local_chunks(file_key, chunks)
             file_hash = self._compute_file_hash(file_path)
             if file_hash:
                 self.indexed_files[file_key] = file_hash
@@ -831,6 +856,111 @@ class ProjectKnowledgeBase:
         except Exception as e:
             return {"success": False, "error": str(e)}
 
+    def index_local_chunks(self, file_key: str, chunks: List[Dict[str, Any]]):
+        """
+        Replace a file's chunks in the local lexical index
+
+        Args:
+            file_key: Project-relative file path
+            chunks: Chunks produced by FileChunker.chunk_file()
+        """
+        if self.local_index is None:
+            return
+
+        self.remove_local_file(file_key)
+
+        chunk_ids = []
+        for chunk in chunks:
+            metadata = chunk.get("metadata", {})
+            chunk_id = self.local_index.add_chunk(
+                file_key,
+                metadata.get("start_line", 0),
+                metadata.get("end_line", 0),
+                chunk.get("content", ""),
+            )
+            self._local_chunks[chunk_id] = chunk
+            chunk_ids.append(chunk_id)
+
+        if chunk_ids:
+            self._local_file_chunks[file_key] = chunk_ids
+
+    def remove_local_file(self, file_key: str):
+        """Drop a file's chunks from the local lexical index"""
+        if self.local_index is None:
+            return
+
+        self.local_index.remove_file(file_key)
+        for chunk_id in self._local_file_chunks.pop(file_key, []):
+            self._local_chunks.pop(chunk_id, None)
+
+    def _ensure_local_index(self):
+        """Chunk every indexable file into the local index on first use"""
+        if self._local_index_built or self.local_index is None:
+            return
+
+        for file_path in self.project_root.rglob("*"):
+            if file_path.is_dir() or self.ignore.should_ignore(file_path):
+                continue
+            file_key = str(file_path.relative_to(self.project_root))
+            if file_key not in self._local_file_chunks:
+                self.index_local_chunks(file_key, self.chunker.chunk_file(file_path))
+
+        self._local_index_built = True
+        logger.info(f"Local index ready: {self.local_index.size()} chunks")
+
+    def local_search(self, query: str, top_k: int = 5) -> Dict[str, Any]:
+        """
+        Search the local BM25 index without a network round trip
+
+        Scores are normalized so the best hit is 1.0.
+
+        Args:
+            query: Search query (identifiers are split on camelCase/snake_case)
+            top_k: Number of results to return
+
+        Returns:
+            Search results in the same shape as search()
+        """
+        if self.local_index is None:
+            return {"success": False, "error": "Native search index not available"}
+
+        self._ensure_local_index()
+
+        hits = self.local_index.search(query, top_k)
+        top_score = hits[0].score if hits else 1.0
+
+        results = []
+        for hit in hits:
+            chunk = self._local_chunks.get(hit.chunk_id)
+            if chunk is None:
+                continue
+            results.append(
+                {
+                    "content": chunk.get("content", ""),
+                    "metadata": chunk.get("metadata", {}),
+                    "score": hit.score / top_score,
+                }
+            )
+
+        return {"success": True, "results": results, "query": query, "source": "local"}
+
+    def add_change_listener(self, listener: Callable[[List[str], List[str]], None]):
+        """
+        Register a callback for watched file changes
+
+        Args:
+            listener: Called with (changed_keys, deleted_keys) of project-relative paths
+        """
+        self._change_listeners.append(listener)
+
+    def notify_change_listeners(self, changed: List[str], deleted: List[str]):
+        """Forward watched file changes to registered listeners"""
+        for listener in self._change_listeners:
+            try:
+                listener(changed, deleted)
+            except Exception as e:
+                logger.error(f"Change listener failed: {e}")
+
     def start_watching(self):
         """Start file watcher for incremental updates"""
         if self.watcher is not None:
@@ -879,6 +1009,7 @@ class ProjectKnowledgeBase:
             "files_indexed": len(self.indexed_files),
             "chunker_stats": self.chunker.stats,
             "watching": self.watcher is not None,
+            "local_chunks": self.local_index.size() if self.local_index is not None else 0,
         }
 
 
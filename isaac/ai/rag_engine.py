@@ -6,11 +6,28 @@ Combines semantic search from xAI Collections with AI chat for context-aware res
 """
 
 import logging
+import re
 from pathlib import Path
 from typing import Any, Dict, List
 
 logger = logging.getLogger(__name__)
 
+# Identifier-like tokens (snake_case, camelCase, calls, dotted paths) mark a lexical query
+_CODE_TOKEN = re.compile(
+    r"\w+_\w+|[a-z]+[A-Z]\w*|[A-Z][a-z0-9]+[A-Z]\w*|\w+\(\)|[A-Za-z_]\w*\.[A-Za-z_]\w*"
+)
+_QUESTION_WORDS = {"how", "why", "what", "explain", "describe", "where", "when", "which"}
+
+# Optional native context packer (C++ core)
+try:
+    from isaac.isaac_core import ContextBuilder, ContextChunk
+
+    NATIVE_CONTEXT_AVAILABLE = True
+except ImportError:
+    ContextBuilder = None
+    ContextChunk = None
+    NATIVE_CONTEXT_AVAILABLE = False
+
 
 class RAGQueryEngine:
     """
@@ -36,8 +53,13 @@ class RAGQueryEngine:
         # Configuration
         self.max_context_chunks = 5  # Max search results to include
         self.context_char_limit = 4000  # Max characters of context
+        self.context_token_budget = 1000  # Max estimated tokens of context (native builder)
         self.relevance_threshold = 0.5  # Minimum relevance score
 
+        self.context_builder = ContextBuilder() if NATIVE_CONTEXT_AVAILABLE else None
+        self.last_context_stats: Dict[str, int] = {}
+        self.last_context_results: List[Dict] = []  # search results the last context includes
+
         logger.info("RAG query engine initialized")
 
     def query(
@@ -60,7 +82,7 @@ class RAGQueryEngine:
             {
                 'success': bool,
                 'response': str,
-                'context_used': List[Dict],  # Search results used
+                'context_used': List[Dict],  # Search results packed into the prompt
                 'tokens_saved': int,  # Tokens saved by not including irrelevant context
                 'source': str  # 'rag' or 'direct'
             }
@@ -83,10 +105,50 @@ class RAGQueryEngine:
         context = self._build_context(search_results, include_file_paths)
 
         # Generate response with context
-        return self._rag_query(user_prompt, context, search_results)
+        return self._rag_query(user_prompt, context, self.last_context_results)
 
     def _search_codebase(self, query: str, top_k: int) -> List[Dict]:
-        """Search codebase for relevant context"""
+        """
+        Search codebase for relevant context
+
+        Lexical queries are answered by the local BM25 index when available;
+        only semantic queries pay for the remote knowledge base search.
+        """
+        has_local = getattr(self.knowledge_base, "local_index", None) is not None
+
+        if has_local and not self._is_semantic_query(query):
+            return self._search_local(query, top_k)
+
+        results = self._search_remote(query, top_k)
+        if not results and has_local:
+            # Remote unavailable or empty - local matches beat no context
+            results = self._search_local(query, top_k)
+        return results
+
+    def _is_semantic_query(self, query: str) -> bool:
+        """Check if a query needs semantic (remote) rather than lexical search"""
+        if _CODE_TOKEN.search(query):
+            return False
+
+        words = query.lower().split()
+        return bool(words) and (words[0] in _QUESTION_WORDS or len(words) > 6)
+
+    def _search_local(self, query: str, top_k: int) -> List[Dict]:
+        """Search the local lexical index (no network)"""
+        try:
+            result = self.knowledge_base.local_search(query, top_k=top_k)
+            results = result.get("results", []) if result.get("success") else []
+
+            # BM25 only returns chunks sharing query terms, so no threshold applies
+            logger.info(f"Found {len(results)} local results")
+            return results
+
+        except Exception as e:
+            logger.error(f"Local search error: {e}")
+            return []
+
+    def _search_remote(self, query: str, top_k: int) -> List[Dict]:
+        """Search the remote knowledge base"""
         try:
             result = self.knowledge_base.search(query, top_k=top_k)
 
@@ -108,6 +170,11 @@ class RAGQueryEngine:
 
     def _build_context(self, search_results: List[Dict], include_file_paths: bool) -> str:
         """Build context string from search results"""
+        self.last_context_stats = {}
+        self.last_context_results = []
+        if self.context_builder is not None:
+            return self._build_context_native(search_results, include_file_paths)
+
         context_parts = []
         total_chars = 0
 
@@ -146,13 +213,42 @@ class RAGQueryEngine:
             total_chars += len(block)
 
         context = "\n\n---\n\n".join(context_parts)
+        self.last_context_results = search_results[: len(context_parts)]
 
         logger.debug(f"Built context: {total_chars} chars from {len(context_parts)} chunks")
 
         return context
 
+    def _build_context_native(self, search_results: List[Dict], include_file_paths: bool) -> str:
+        """Pack the best-scoring, non-overlapping chunks into the token budget"""
+        chunks = []
+        for result in search_results:
+            metadata = result.get("metadata", {})
+            chunks.append(
+                ContextChunk(
+                    file=str(metadata.get("file", "")),
+                    start_line=int(metadata.get("start_line") or 0),
+                    end_line=int(metadata.get("end_line") or 0),
+                    content=result.get("content", ""),
+                    score=float(result.get("score", 0)),
+                )
+            )
+
+        packed = self.context_builder.build(chunks, self.context_token_budget, include_file_paths)
+        self.last_context_results = [search_results[index] for index in packed.selected]
+
+        self.last_context_stats = {
+            "tokens": packed.tokens,
+            "tokens_saved": max(0, packed.candidate_tokens - packed.tokens),
+            "chunks_used": len(packed.selected),
+            "overlaps_removed": packed.overlaps_removed,
+        }
+        logger.debug(f"Built context: ~{packed.tokens} tokens from {len(packed.selected)} chunks")
+
+        return packed.context
+
     def _rag_query(
-        self, user_prompt: str, context: str, search_results: List[Dict]
+        self, user_prompt: str, context: str, context_used: List[Dict]
     ) -> Dict[str, Any]:
         """Query with RAG (context injection)"""
         # Build system prompt with context
@@ -180,7 +276,7 @@ Include file paths and line numbers when referencing specific code."""
                     return {
                         "success": False,
                         "error": result.get("error", "AI service unavailable"),
-                        "context_used": search_results,
+                        "context_used": context_used,
                         "source": "rag_failed",
                     }
 
@@ -192,8 +288,8 @@ Include file paths and line numbers when referencing specific code."""
             return {
                 "success": True,
                 "response": response,
-                "context_used": search_results,
-                "tokens_saved": 0,  # TODO: Calculate based on filtered results
+                "context_used": context_used,
+                "tokens_saved": self.last_context_stats.get("tokens_saved", 0),
                 "source": "rag",
             }
 
@@ -202,7 +298,7 @@ Include file paths and line numbers when referencing specific code."""
             return {
                 "success": False,
                 "error": str(e),
-                "context_used": search_results,
+                "context_used": context_used,
                 "source": "rag_failed",
             }
 
@@ -247,6 +343,7 @@ Include file paths and line numbers when referencing specific code."""
         Args:
             max_context_chunks: Max search results to include
             context_char_limit: Max characters of context
+            context_token_budget: Max estimated tokens of context (native builder)
             relevance_threshold: Minimum relevance score
         """
         if "max_context_chunks" in kwargs:
@@ -255,12 +352,16 @@ Include file paths and line numbers when referencing specific code."""
         if "context_char_limit" in kwargs:
             self.context_char_limit = kwargs["context_char_limit"]
 
+        if "context_token_budget" in kwargs:
+            self.context_token_budget = kwargs["context_token_budget"]
+
         if "relevance_threshold" in kwargs:
             self.relevance_threshold = kwargs["relevance_threshold"]
 
         logger.info(
             f"RAG engine configured: max_chunks={self.max_context_chunks}, "
-            f"char_limit={self.context_char_limit}, threshold={self.relevance_threshold}"
+            f"char_limit={self.context_char_limit}, token_budget={self.context_token_budget}, "
+            f"threshold={self.relevance_threshold}"
         )
 
 
@@ -78,6 +78,9 @@ class UnifiedChatRouter:
                     project_root=self.workspace_context._current_workspace_path,
                     rag_engine=self.rag_engine,
                 )
+                if kb:
+                    # Keep the dependency graph in step with the knowledge base watcher
+                    kb.add_change_listener(self.multifile_mgr.on_files_changed)
 
         except Exception as e:
             logger.error(f"Failed to initialize components: {e}")
@@ -356,36 +356,18 @@ class CodeQualityTracker:
         """Get quality trend over time"""
         start_date = (datetime.now() - timedelta(days=days)).isoformat()
 
-        metrics = self.db.query_metrics("code_quality_metrics", start_date=start_date)
+        rollups = self.db.get_daily_rollups("code_quality_metrics", start_date=start_date)
 
-        # Group by day
-        daily_metrics = {}
-        for metric in metrics:
-            date = metric["timestamp"][:10]
-            if date not in daily_metrics:
-                daily_metrics[date] = {"quality_scores": [], "patterns": 0, "anti_patterns": 0}
-
-            if metric["metric_type"] == "quality_score":
-                daily_metrics[date]["quality_scores"].append(metric["metric_value"])
-            elif metric["metric_type"] == "pattern_detection":
-                daily_metrics[date]["patterns"] += 1
-            elif metric["metric_type"] == "anti_pattern_detection":
-                daily_metrics[date]["anti_patterns"] += 1
-
-        # Convert to list
         trend = []
-        for date, data in sorted(daily_metrics.items()):
-            avg_quality = (
-                sum(data["quality_scores"]) / len(data["quality_scores"])
-                if data["quality_scores"]
-                else 50.0
-            )
+        for date, by_type in sorted(rollups.items()):
+            scores = by_type.get("quality_score")
+            avg_quality = scores["sum"] / scores["count"] if scores else 50.0
             trend.append(
                 {
                     "date": date,
                     "average_quality": avg_quality,
-                    "patterns": data["patterns"],
-                    "anti_patterns": data["anti_patterns"],
+                    "patterns": by_type.get("pattern_detection", {}).get("count", 0),
+                    "anti_patterns": by_type.get("anti_pattern_detection", {}).get("count", 0),
                 }
             )
 
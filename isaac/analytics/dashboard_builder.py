@@ -46,10 +46,10 @@ class DashboardBuilder:
     def __init__(self, db: Optional[AnalyticsDatabase] = None):
         """Initialize dashboard builder"""
         self.db = db or AnalyticsDatabase()
-        self.productivity = ProductivityTracker(db)
-        self.code_quality = CodeQualityTracker(db)
-        self.learning = LearningTracker(db)
-        self.team = TeamTracker(db=db)
+        self.productivity = ProductivityTracker(self.db)
+        self.code_quality = CodeQualityTracker(self.db)
+        self.learning = LearningTracker(self.db)
+        self.team = TeamTracker(db=self.db)
 
         # Built-in dashboards
         self.built_in_dashboards = {
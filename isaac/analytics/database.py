@@ -4,15 +4,69 @@ Analytics Database
 Stores all analytics data with efficient querying capabilities.
 """
 
+import atexit
 import os
 import sqlite3
+import threading
 from contextlib import contextmanager
-from datetime import datetime
-from typing import Any, Dict, List, Optional
+from datetime import datetime, timedelta
+from typing import Any, Dict, List, Optional, Tuple
+
+try:
+    from isaac.isaac_core import MetricStore
+
+    NATIVE_METRIC_STORE_AVAILABLE = True
+except ImportError:
+    MetricStore = None
+    NATIVE_METRIC_STORE_AVAILABLE = False
+
+
+# Per table: the column naming a series and the column holding its value.
+# Every recorded row is also appended to the series "<table>/<dimension>".
+_SERIES_COLUMNS = {
+    "productivity_metrics": ("metric_type", "metric_value"),
+    "code_quality_metrics": ("metric_type", "metric_value"),
+    "learning_analytics": ("learning_type", "confidence"),
+    "team_analytics": ("activity_type", "activity_value"),
+    "command_analytics": ("command_name", "execution_time"),
+    "custom_metrics": ("metric_category", "metric_value"),
+}
+
+# One store per file, shared by every AnalyticsDatabase in the process
+_metric_stores: Dict[str, Any] = {}
+_metric_stores_lock = threading.Lock()
+
+
+def _open_metric_store(db_path: str) -> Any:
+    """Return the native series store beside db_path."""
+    path = os.path.realpath(os.path.splitext(db_path)[0] + ".tsdb")
+    with _metric_stores_lock:
+        store = _metric_stores.get(path)
+        if store is None:
+            store = MetricStore(path)
+            _metric_stores[path] = store
+        return store
+
+
+@atexit.register
+def _flush_metric_stores():
+    with _metric_stores_lock:
+        for store in _metric_stores.values():
+            store.flush()
+
+
+def _epoch(value: Optional[str]) -> Optional[float]:
+    return datetime.fromisoformat(value).timestamp() if value else None
 
 
 class AnalyticsDatabase:
-    """Database for storing analytics data"""
+    """Database for storing analytics data.
+
+    Rows live in SQLite for query_metrics(); the numeric value of every row is
+    also kept in a compressed native series store (when isaac_core is built)
+    so aggregates and daily trends read pre-computed rollups instead of
+    scanning rows.
+    """
 
     def __init__(self, db_path: Optional[str] = None):
         """Initialize analytics database"""
@@ -22,8 +76,18 @@ class AnalyticsDatabase:
             db_path = os.path.join(isaac_dir, "analytics.db")
 
         self.db_path = db_path
+        self._lock = threading.RLock()
+        self._conn = sqlite3.connect(db_path, check_same_thread=False)
+        self._conn.row_factory = sqlite3.Row
+        self._conn.execute("PRAGMA journal_mode=WAL")
+        self._conn.execute("PRAGMA synchronous=NORMAL")
         self._init_database()
 
+        self._series = None
+        if NATIVE_METRIC_STORE_AVAILABLE and db_path != ":memory:":
+            self._series = _open_metric_store(db_path)
+            self._import_series()
+
     def _init_database(self):
         """Initialize database schema"""
         with self._get_connection() as conn:
@@ -125,6 +189,30 @@ class AnalyticsDatabase:
             """
             )
 
+            # Latest exported value of each core metric stat; overwritten, not appended
+            conn.execute(
+                """
+                CREATE TABLE IF NOT EXISTS metric_snapshots (
+                    metric_name TEXT NOT NULL,
+                    stat TEXT NOT NULL,
+                    kind TEXT NOT NULL,
+                    value REAL NOT NULL,
+                    timestamp TEXT NOT NULL,
+                    PRIMARY KEY (metric_name, stat)
+                )
+            """
+            )
+
+            # Key/value state of the database itself (e.g. series store seeding)
+            conn.execute(
+                """
+                CREATE TABLE IF NOT EXISTS analytics_meta (
+                    key TEXT PRIMARY KEY,
+                    value TEXT
+                )
+            """
+            )
+
             # Create indexes for efficient querying
             conn.execute(
                 """
@@ -161,13 +249,65 @@ class AnalyticsDatabase:
 
     @contextmanager
     def _get_connection(self):
-        """Get database connection with context manager"""
-        conn = sqlite3.connect(self.db_path)
-        conn.row_factory = sqlite3.Row
-        try:
-            yield conn
-        finally:
-            conn.close()
+        """Get the shared database connection with context manager"""
+        with self._lock:
+            yield self._conn
+
+    def close(self):
+        """Close the database connection"""
+        with self._lock:
+            self._conn.close()
+
+    def _import_series(self):
+        """Seed the series store with the rows already in SQLite, once.
+
+        The .tsdb file only appears when the first chunk is written, so
+        whether it exists says nothing about seeding. The import is recorded
+        in analytics_meta instead, inside a write transaction, so processes
+        opening the database together import exactly once.
+        """
+        with self._get_connection() as conn:
+            conn.execute("BEGIN IMMEDIATE")
+            try:
+                seeded = conn.execute(
+                    "SELECT 1 FROM analytics_meta WHERE key = 'series_imported'"
+                ).fetchone()
+                # Stores seeded before the marker existed already hold the rows
+                if not seeded and not self._series.series():
+                    for table, (dimension, value) in _SERIES_COLUMNS.items():
+                        cursor = conn.execute(
+                            f"SELECT timestamp, {dimension}, {value} FROM {table} "
+                            f"WHERE {value} IS NOT NULL ORDER BY timestamp"
+                        )
+                        for timestamp, name, number in cursor:
+                            self._series.append(f"{table}/{name}", float(number), _epoch(timestamp))
+                    self._series.flush()
+                if not seeded:
+                    conn.execute(
+                        "INSERT INTO analytics_meta (key, value) VALUES ('series_imported', ?)",
+                        (datetime.now().isoformat(),),
+                    )
+                conn.commit()
+            except BaseException:
+                conn.rollback()
+                raise
+
+    def _record(self, table: str, row: Dict[str, Any]):
+        """Insert one row and append its value to the table's series"""
+        now = datetime.now()
+        row = {"timestamp": now.isoformat(), **row}
+        columns = ", ".join(row)
+        placeholders = ", ".join("?" for _ in row)
+        with self._get_connection() as conn:
+            conn.execute(
+                f"INSERT INTO {table} ({columns}) VALUES ({placeholders})", tuple(row.values())
+            )
+            conn.commit()
+
+        if self._series is not None:
+            dimension, value = _SERIES_COLUMNS[table]
+            if row.get(value) is not None:
+                self._series.append(f"{table}/{row[dimension]}", float(row[value]), now.timestamp())
 
     def record_productivity_metric(
         self,
@@ -178,23 +318,16 @@ class AnalyticsDatabase:
         metadata: Optional[str] = None,
     ):
         """Record a productivity metric"""
-        with self._get_connection() as conn:
-            conn.execute(
-                """
-                INSERT INTO productivity_metrics
-                (timestamp, session_id, metric_type, metric_name, metric_value, metadata)
-                VALUES (?, ?, ?, ?, ?, ?)
-            """,
-                (
-                    datetime.now().isoformat(),
-                    session_id,
-                    metric_type,
-                    metric_name,
-                    metric_value,
-                    metadata,
-                ),
-            )
-            conn.commit()
+        self._record(
+            "productivity_metrics",
+            {
+                "session_id": session_id,
+                "metric_type": metric_type,
+                "metric_name": metric_name,
+                "metric_value": metric_value,
+                "metadata": metadata,
+            },
+        )
 
     def record_code_quality_metric(
         self,
@@ -208,27 +341,19 @@ class AnalyticsDatabase:
         metadata: Optional[str] = None,
     ):
         """Record a code quality metric"""
-        with self._get_connection() as conn:
-            conn.execute(
-                """
-                INSERT INTO code_quality_metrics
-                (timestamp, session_id, file_path, metric_type, metric_name,
-                 metric_value, before_value, after_value, metadata)
-                VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
-            """,
-                (
-                    datetime.now().isoformat(),
-                    session_id,
-                    file_path,
-                    metric_type,
-                    metric_name,
-                    metric_value,
-                    before_value,
-                    after_value,
-                    metadata,
-                ),
-            )
-            conn.commit()
+        self._record(
+            "code_quality_metrics",
+            {
+                "session_id": session_id,
+                "file_path": file_path,
+                "metric_type": metric_type,
+                "metric_name": metric_name,
+                "metric_value": metric_value,
+                "before_value": before_value,
+                "after_value": after_value,
+                "metadata": metadata,
+            },
+        )
 
     def record_learning_metric(
         self,
@@ -241,26 +366,18 @@ class AnalyticsDatabase:
         metadata: Optional[str] = None,
     ):
         """Record a learning analytics metric"""
-        with self._get_connection() as conn:
-            conn.execute(
-                """
-                INSERT INTO learning_analytics
-                (timestamp, session_id, learning_type, learning_item,
-                 confidence, usage_count, success_rate, metadata)
-                VALUES (?, ?, ?, ?, ?, ?, ?, ?)
-            """,
-                (
-                    datetime.now().isoformat(),
-                    session_id,
-                    learning_type,
-                    learning_item,
-                    confidence,
-                    usage_count,
-                    success_rate,
-                    metadata,
-                ),
-            )
-            conn.commit()
+        self._record(
+            "learning_analytics",
+            {
+                "session_id": session_id,
+                "learning_type": learning_type,
+                "learning_item": learning_item,
+                "confidence": confidence,
+                "usage_count": usage_count,
+                "success_rate": success_rate,
+                "metadata": metadata,
+            },
+        )
 
     def record_team_activity(
         self,
@@ -272,25 +389,17 @@ class AnalyticsDatabase:
         metadata: Optional[str] = None,
     ):
         """Record a team analytics activity"""
-        with self._get_connection() as conn:
-            conn.execute(
-                """
-                INSERT INTO team_analytics
-                (timestamp, team_id, user_id, activity_type, activity_name,
-                 activity_value, metadata)
-                VALUES (?, ?, ?, ?, ?, ?, ?)
-            """,
-                (
-                    datetime.now().isoformat(),
-                    team_id,
-                    user_id,
-                    activity_type,
-                    activity_name,
-                    activity_value,
-                    metadata,
-                ),
-            )
-            conn.commit()
+        self._record(
+            "team_analytics",
+            {
+                "team_id": team_id,
+                "user_id": user_id,
+                "activity_type": activity_type,
+                "activity_name": activity_name,
+                "activity_value": activity_value,
+                "metadata": metadata,
+            },
+        )
 
     def record_command_execution(
         self,
@@ -302,25 +411,17 @@ class AnalyticsDatabase:
         metadata: Optional[str] = None,
     ):
         """Record command execution analytics"""
-        with self._get_connection() as conn:
-            conn.execute(
-                """
-                INSERT INTO command_analytics
-                (timestamp, session_id, command_name, execution_time,
-                 success, error_message, metadata)
-                VALUES (?, ?, ?, ?, ?, ?, ?)
-            """,
-                (
-                    datetime.now().isoformat(),
-                    session_id,
-                    command_name,
-                    execution_time,
-                    1 if success else 0,
-                    error_message,
-                    metadata,
-                ),
-            )
-            conn.commit()
+        self._record(
+            "command_analytics",
+            {
+                "session_id": session_id,
+                "command_name": command_name,
+                "execution_time": execution_time,
+                "success": 1 if success else 0,
+                "error_message": error_message,
+                "metadata": metadata,
+            },
+        )
 
     def record_custom_metric(
         self,
@@ -332,26 +433,39 @@ class AnalyticsDatabase:
         metadata: Optional[str] = None,
     ):
         """Record a custom metric"""
+        self._record(
+            "custom_metrics",
+            {
+                "session_id": session_id,
+                "metric_category": metric_category,
+                "metric_name": metric_name,
+                "metric_value": metric_value,
+                "tags": tags,
+                "metadata": metadata,
+            },
+        )
+
+    def record_metric_snapshot(self, samples: List[Tuple[str, str, str, float]]):
+        """Replace the stored value of each (metric_name, stat, kind, value)"""
+        timestamp = datetime.now().isoformat()
         with self._get_connection() as conn:
-            conn.execute(
-                """
-                INSERT INTO custom_metrics
-                (timestamp, session_id, metric_category, metric_name,
-                 metric_value, tags, metadata)
-                VALUES (?, ?, ?, ?, ?, ?, ?)
-            """,
-                (
-                    datetime.now().isoformat(),
-                    session_id,
-                    metric_category,
-                    metric_name,
-                    metric_value,
-                    tags,
-                    metadata,
-                ),
+            conn.executemany(
+                "INSERT OR REPLACE INTO metric_snapshots (metric_name, stat, kind, value, timestamp) "
+                "VALUES (?, ?, ?, ?, ?)",
+                [(name, stat, kind, float(value), timestamp) for name, stat, kind, value in samples],
             )
             conn.commit()
 
+    def query_metric_snapshot(self, start_date: Optional[str] = None) -> List[Dict[str, Any]]:
+        """Stored metric snapshot values, optionally only those written since start_date"""
+        query = "SELECT metric_name, stat, kind, value, timestamp FROM metric_snapshots"
+        params = []
+        if start_date:
+            query += " WHERE timestamp >= ?"
+            params.append(start_date)
+        with self._get_connection() as conn:
+            return [dict(row) for row in conn.execute(query, params)]
+
     def query_metrics(
         self,
         table: str,
@@ -395,6 +509,11 @@ class AnalyticsDatabase:
         group_by: Optional[str] = None,
     ) -> Dict[str, Any]:
         """Get aggregate statistics for a metric"""
+        if self._series is not None and table in _SERIES_COLUMNS:
+            dimension, value = _SERIES_COLUMNS[table]
+            if metric_column == value and group_by in (None, dimension):
+                return self._series_stats(table, start_date, end_date, group_by)
+
         query = f"""
             SELECT
                 COUNT(*) as count,
@@ -429,10 +548,108 @@ class AnalyticsDatabase:
                 row = cursor.fetchone()
                 return dict(row) if row else {}
 
+    def _series_range(self, start_date: Optional[str], end_date: Optional[str]) -> Dict[str, float]:
+        bounds = {"since": _epoch(start_date), "until": _epoch(end_date)}
+        return {key: bound for key, bound in bounds.items() if bound is not None}
+
+    def _series_stats(
+        self,
+        table: str,
+        start_date: Optional[str],
+        end_date: Optional[str],
+        group_by: Optional[str],
+    ):
+        """get_aggregate_stats() answered from the series rollups"""
+        bounds = self._series_range(start_date, end_date)
+        groups = {}
+        for name in self._series.series(f"{table}/"):
+            summary = self._series.summarize(name, **bounds)
+            if summary.count:
+                groups[name[len(table) + 1 :]] = summary
+
+        if group_by:
+            return [
+                {
+                    "count": s.count,
+                    "avg": s.sum / s.count,
+                    "min": s.min,
+                    "max": s.max,
+                    "sum": s.sum,
+                    group_by: key,
+                }
+                for key, s in groups.items()
+            ]
+
+        if not groups:
+            return {"count": 0, "avg": None, "min": None, "max": None, "sum": None}
+        count = sum(s.count for s in groups.values())
+        total = sum(s.sum for s in groups.values())
+        return {
+            "count": count,
+            "avg": total / count,
+            "min": min(s.min for s in groups.values()),
+            "max": max(s.max for s in groups.values()),
+            "sum": total,
+        }
+
+    def get_daily_rollups(
+        self,
+        table: str,
+        start_date: Optional[str] = None,
+        end_date: Optional[str] = None,
+    ) -> Dict[str, Dict[str, Dict[str, float]]]:
+        """Per-day count/sum/min/max of a table's value column.
+
+        Returns {"YYYY-MM-DD": {dimension: {"count", "sum", "min", "max"}}},
+        where the dimension is the table's series column (metric_type,
+        learning_type, command_name, ...).
+        """
+        dimension, value = _SERIES_COLUMNS[table]
+        daily: Dict[str, Dict[str, Dict[str, float]]] = {}
+
+        if self._series is not None:
+            bounds = self._series_range(start_date, end_date)
+            for name in self._series.series(f"{table}/"):
+                key = name[len(table) + 1 :]
+                for bucket in self._series.rollups(name, "day", **bounds):
+                    date = datetime.fromtimestamp(bucket.start).date().isoformat()
+                    daily.setdefault(date, {})[key] = {
+                        "count": bucket.count,
+                        "sum": bucket.sum,
+                        "min": bucket.min,
+                        "max": bucket.max,
+                    }
+            return daily
+
+        query = f"""
+            SELECT substr(timestamp, 1, 10) AS day, {dimension} AS dimension,
+                   COUNT({value}) AS count, SUM({value}) AS sum,
+                   MIN({value}) AS min, MAX({value}) AS max
+            FROM {table} WHERE {value} IS NOT NULL
+        """
+        params = []
+        if start_date:
+            query += " AND timestamp >= ?"
+            params.append(start_date)
+        if end_date:
+            query += " AND timestamp <= ?"
+            params.append(end_date)
+        query += " GROUP BY day, dimension"
+
+        with self._get_connection() as conn:
+            for row in conn.execute(query, params):
+                daily.setdefault(row["day"], {})[row["dimension"]] = {
+                    "count": row["count"],
+                    "sum": row["sum"],
+                    "min": row["min"],
+                    "max": row["max"],
+                }
+        return daily
+
     def clear_old_data(self, days: int = 90):
         """Clear analytics data older than specified days"""
         cutoff = datetime.now().replace(hour=0, minute=0, second=0, microsecond=0)
-        cutoff = cutoff.replace(day=cutoff.day - days)
+        cutoff -= timedelta(days=days)
         cutoff_str = cutoff.isoformat()
 
         tables = [
@@ -448,3 +665,6 @@ class AnalyticsDatabase:
             for table in tables:
                 conn.execute(f"DELETE FROM {table} WHERE timestamp < ?", (cutoff_str,))
             conn.commit()
+
+        if self._series is not None:
+            self._series.drop_before(cutoff.timestamp())
@@ -302,36 +302,21 @@ class LearningTracker:
         """Get learning trend over time"""
         start_date = (datetime.now() - timedelta(days=days)).isoformat()
 
-        metrics = self.db.query_metrics("learning_analytics", start_date=start_date)
+        rollups = self.db.get_daily_rollups("learning_analytics", start_date=start_date)
 
-        # Group by day
-        daily_learning = {}
-        for metric in metrics:
-            date = metric["timestamp"][:10]
-            if date not in daily_learning:
-                daily_learning[date] = {
-                    "patterns": 0,
-                    "preferences": 0,
-                    "mistakes": 0,
-                    "behaviors": 0,
-                    "total": 0,
-                }
-
-            daily_learning[date]["total"] += 1
-
-            if metric["learning_type"] == "pattern_learned":
-                daily_learning[date]["patterns"] += 1
-            elif metric["learning_type"] == "preference_adapted":
-                daily_learning[date]["preferences"] += 1
-            elif metric["learning_type"] == "mistake_learned":
-                daily_learning[date]["mistakes"] += 1
-            elif metric["learning_type"] == "behavior_adjustment":
-                daily_learning[date]["behaviors"] += 1
-
-        # Convert to list
         trend = []
-        for date, data in sorted(daily_learning.items()):
-            trend.append({"date": date, **data})
+        for date, by_type in sorted(rollups.items()):
+            counts = {kind: stats["count"] for kind, stats in by_type.items()}
+            trend.append(
+                {
+                    "date": date,
+                    "patterns": counts.get("pattern_learned", 0),
+                    "preferences": counts.get("preference_adapted", 0),
+                    "mistakes": counts.get("mistake_learned", 0),
+                    "behaviors": counts.get("behavior_adjustment", 0),
+                    "total": sum(counts.values()),
+                }
+            )
 
         return trend
 
@@ -286,28 +286,19 @@ class ProductivityTracker:
         """Get efficiency trend over time"""
         start_date = (datetime.now() - timedelta(days=days)).isoformat()
 
-        metrics = self.db.query_metrics("productivity_metrics", start_date=start_date)
+        rollups = self.db.get_daily_rollups("productivity_metrics", start_date=start_date)
 
-        # Group by day
         daily_metrics = {}
-        for metric in metrics:
-            date = metric["timestamp"][:10]  # Get just the date part
-            if date not in daily_metrics:
-                daily_metrics[date] = {
-                    "commands": 0,
-                    "time_saved": 0.0,
-                    "automations": 0,
-                    "patterns": 0,
-                }
-
-            if metric["metric_type"] == "command_execution":
-                daily_metrics[date]["commands"] += 1
-            elif metric["metric_type"] in ["time_saved", "automation", "error_prevention"]:
-                daily_metrics[date]["time_saved"] += metric["metric_value"]
-            elif metric["metric_type"] == "automation":
-                daily_metrics[date]["automations"] += 1
-            elif metric["metric_type"] == "pattern_application":
-                daily_metrics[date]["patterns"] += 1
+        for date, by_type in rollups.items():
+            daily_metrics[date] = {
+                "commands": by_type.get("command_execution", {}).get("count", 0),
+                "time_saved": sum(
+                    by_type.get(kind, {}).get("sum", 0.0)
+                    for kind in ("time_saved", "automation", "error_prevention")
+                ),
+                "automations": by_type.get("automation", {}).get("count", 0),
+                "patterns": by_type.get("pattern_application", {}).get("count", 0),
+            }
 
         # Convert to list and calculate efficiency scores
         trend = []
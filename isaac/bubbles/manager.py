@@ -5,6 +5,7 @@ Workspace Bubbles - Complete workspace state capture and restoration
 import json
 import os
 import subprocess
+import threading
 import time
 import uuid
 from dataclasses import asdict, dataclass
@@ -13,6 +14,30 @@ from typing import Any, Dict, List, Optional
 
 import psutil
 
+# Optional native snapshot store (C++ core)
+try:
+    from isaac.isaac_core import SnapshotStore
+
+    NATIVE_SNAPSHOTS_AVAILABLE = True
+except ImportError:
+    SnapshotStore = None
+    NATIVE_SNAPSHOTS_AVAILABLE = False
+
+# Optional native state capture from /proc and .git (C++ core)
+try:
+    from isaac.isaac_core import WorkspaceCapture
+
+    NATIVE_CAPTURE_AVAILABLE = True
+except ImportError:
+    WorkspaceCapture = None
+    NATIVE_CAPTURE_AVAILABLE = False
+
+SHELL_NAMES = ("powershell", "bash", "zsh", "fish", "cmd")
+
+# One native store per directory, shared by every BubbleManager in the process
+_native_stores: Dict[str, Any] = {}
+_native_stores_lock = threading.Lock()
+
 
 @dataclass
 class WorkspaceState:
@@ -55,9 +80,19 @@ class WorkspaceState:
 
 
 class BubbleManager:
-    """Manages workspace bubbles - complete state snapshots"""
+    """Manages workspace bubbles - complete state snapshots
+
+    With the native core, bubbles go to a content-addressed snapshot store
+    (storage_path/store): each state is chunked and only chunks that changed
+    since earlier bubbles are written, so consecutive snapshots of the same
+    workspace cost a few KB instead of a full JSON file each. Without it,
+    every bubble is its own JSON file.
+
+    State capture likewise reads /proc and .git directly when the core is
+    built, instead of iterating psutil and running git.
+    """
 
-    def __init__(self, storage_path: Optional[Path] = None):
+    def __init__(self, storage_path: Optional[Path] = None, use_native: bool = True):
         if storage_path is None:
             isaac_dir = Path.home() / ".isaac"
             isaac_dir.mkdir(exist_ok=True)
@@ -65,6 +100,53 @@ class BubbleManager:
 
         self.storage_path = storage_path
         self.storage_path.mkdir(exist_ok=True)
+        self._store = None
+        self._capture = WorkspaceCapture() if use_native and NATIVE_CAPTURE_AVAILABLE else None
+
+        if use_native and NATIVE_SNAPSHOTS_AVAILABLE:
+            self._store = self._open_native(self.storage_path / "store")
+
+    def _open_native(self, store_dir: Path):
+        """Open (or reuse) the store for store_dir, importing JSON bubbles once."""
+        key = str(store_dir.resolve())
+        with _native_stores_lock:
+            store = _native_stores.get(key)
+            if store is None:
+                store = SnapshotStore(key)
+                _native_stores[key] = store
+                self._migrate_json(store)
+        return store
+
+    def _migrate_json(self, store):
+        """Move bubbles saved as JSON files into the native store."""
+        for bubble_file in sorted(self.storage_path.glob("*.json")):
+            try:
+                with open(bubble_file, "r") as f:
+                    state = WorkspaceState(**json.load(f))
+            except Exception as e:
+                print(f"Warning: Could not migrate bubble {bubble_file}: {e}")
+                continue
+            store.put(state.bubble_id, self._encode(state), state.name, state.timestamp)
+            bubble_file.rename(bubble_file.with_name(bubble_file.name + ".migrated"))
+
+    @staticmethod
+    def _encode(state: WorkspaceState) -> str:
+        # Stable field order keeps unchanged sections byte-identical between snapshots
+        return json.dumps(asdict(state), indent=1)
+
+    def storage_stats(self) -> Optional[Dict[str, Any]]:
+        """Deduplication figures for the native store, or None without it."""
+        if self._store is None:
+            return None
+        stats = self._store.stats()
+        return {
+            "bubbles": stats.snapshots,
+            "chunks": stats.chunks,
+            "logical_bytes": stats.logical_bytes,
+            "stored_bytes": stats.stored_bytes,
+            "disk_bytes": stats.disk_bytes,
+            "dedup_ratio": stats.logical_bytes / stats.stored_bytes if stats.stored_bytes else 1.0,
+        }
 
     def create_bubble(
         self, name: str = "", description: str = "", tags: Optional[List[str]] = None
@@ -75,14 +157,15 @@ class BubbleManager:
         bubble_id = str(uuid.uuid4())[:8]
 
         # Capture all state components
+        git_branch, git_status = self._get_git_state()
         state = WorkspaceState(
             bubble_id=bubble_id,
             timestamp=time.time(),
             name=name or f"Bubble {bubble_id}",
             description=description,
             cwd=os.getcwd(),
-            git_branch=self._get_git_branch(),
-            git_status=self._get_git_status(),
+            git_branch=git_branch,
+            git_status=git_status,
             environment=self._get_environment(),
             running_processes=self._get_running_processes(),
             open_files=self._get_open_files(),
@@ -100,6 +183,14 @@ class BubbleManager:
     def list_bubbles(self) -> List[WorkspaceState]:
         """List all saved bubbles"""
         bubbles = []
+        if self._store is not None:
+            for info in self._store.list():
+                bubble = self.get_bubble(info.id)
+                if bubble:
+                    bubbles.append(bubble)
+            bubbles.sort(key=lambda b: b.timestamp, reverse=True)
+            return bubbles
+
         for bubble_file in self.storage_path.glob("*.json"):
             try:
                 with open(bubble_file, "r") as f:
@@ -114,6 +205,14 @@ class BubbleManager:
 
     def get_bubble(self, bubble_id: str) -> Optional[WorkspaceState]:
         """Get a specific bubble by ID"""
+        if self._store is not None:
+            try:
+                data = self._store.get(bubble_id)
+                return WorkspaceState(**json.loads(data)) if data is not None else None
+            except Exception as e:
+                print(f"Error loading bubble {bubble_id}: {e}")
+                return None
+
         bubble_file = self.storage_path / f"{bubble_id}.json"
         if bubble_file.exists():
             try:
@@ -126,6 +225,9 @@ class BubbleManager:
 
     def delete_bubble(self, bubble_id: str) -> bool:
         """Delete a bubble"""
+        if self._store is not None:
+            return self._store.remove(bubble_id)
+
         bubble_file = self.storage_path / f"{bubble_id}.json"
         if bubble_file.exists():
             bubble_file.unlink()
@@ -158,10 +260,28 @@ class BubbleManager:
 
     def _save_bubble(self, state: WorkspaceState):
         """Save bubble to disk"""
+        if self._store is not None:
+            self._store.put(state.bubble_id, self._encode(state), state.name, state.timestamp)
+            return
+
         bubble_file = self.storage_path / f"{state.bubble_id}.json"
         with open(bubble_file, "w") as f:
             json.dump(asdict(state), f, indent=2)
 
+    def _get_git_state(self):
+        """Branch and status; natively one read of .git/HEAD and the index."""
+        if self._capture is None:
+            return self._get_git_branch(), self._get_git_status()
+
+        git = self._capture.git(os.getcwd())
+        status = {
+            "is_git_repo": git.is_repo,
+            "modified_files": list(git.modified_files) + list(git.deleted_files),
+            "untracked_files": list(git.untracked_files),
+            "staged_files": [],
+        }
+        return (git.branch if git.is_repo else None), status
+
     def _get_git_branch(self) -> Optional[str]:
         """Get current git branch"""
         try:
@@ -230,6 +350,18 @@ class BubbleManager:
 
     def _get_running_processes(self) -> List[Dict[str, Any]]:
         """Get information about running processes"""
+        if self._capture is not None:
+            return [
+                {
+                    "pid": proc.pid,
+                    "name": proc.name,
+                    "cmdline": list(proc.cmdline),
+                    "cwd": proc.cwd,
+                    "open_files": list(proc.open_files),
+                }
+                for proc in self._capture.processes(os.getcwd(), 20)
+            ]
+
         processes = []
 
         try:
@@ -256,25 +388,29 @@ class BubbleManager:
     def _get_open_files(self) -> List[str]:
         """Get list of potentially open/active files (best effort)"""
         open_files = []
-        os.getcwd()
+        patterns = ["**/*.py", "**/*.md", "**/*.txt", "**/*.json", "**/*.yaml", "**/*.yml"]
 
         try:
             # Look for recently modified files (last 30 minutes)
             import glob
 
-            recent_files = []
-            cutoff_time = time.time() - (30 * 60)  # 30 minutes ago
+            if self._capture is not None:
+                # One parallel walk instead of a recursive glob per pattern
+                open_files = list(self._capture.recent_files(os.getcwd(), patterns, 30 * 60, 10))
+            else:
+                recent_files = []
+                cutoff_time = time.time() - (30 * 60)  # 30 minutes ago
 
-            for pattern in ["**/*.py", "**/*.md", "**/*.txt", "**/*.json", "**/*.yaml", "**/*.yml"]:
-                for file_path in glob.glob(pattern, recursive=True):
-                    if os.path.isfile(file_path):
-                        mtime = os.path.getmtime(file_path)
-                        if mtime > cutoff_time:
-                            recent_files.append(file_path)
+                for pattern in patterns:
+                    for file_path in glob.glob(pattern, recursive=True):
+                        if os.path.isfile(file_path):
+                            mtime = os.path.getmtime(file_path)
+                            if mtime > cutoff_time:
+                                recent_files.append(file_path)
 
-            # Sort by modification time (most recent first) and take top 10
-            recent_files.sort(key=lambda f: os.path.getmtime(f), reverse=True)
-            open_files = recent_files[:10]
+                # Sort by modification time (most recent first) and take top 10
+                recent_files.sort(key=lambda f: os.path.getmtime(f), reverse=True)
+                open_files = recent_files[:10]
 
             # Look for editor-specific indicators
             editor_indicators = [
@@ -329,6 +465,18 @@ class BubbleManager:
 
     def _get_background_jobs(self) -> List[Dict[str, Any]]:
         """Get background jobs/processes"""
+        if self._capture is not None:
+            jobs = []
+            for proc in self._capture.processes(os.getcwd(), 100, False):
+                command = " ".join(proc.cmdline).lower()
+                if proc.cmdline and proc.state in ("R", "S") and not any(
+                    term in command for term in SHELL_NAMES
+                ):
+                    jobs.append(
+                        {"pid": proc.pid, "name": proc.name, "cmdline": list(proc.cmdline), "cwd": proc.cwd}
+                    )
+            return jobs[:10]
+
         background_jobs = []
 
         try:
@@ -341,7 +489,7 @@ class BubbleManager:
                         cmdline = info.get("cmdline", [])
                         if cmdline and not any(
                             term in " ".join(cmdline).lower()
-                            for term in ["powershell", "bash", "zsh", "fish", "cmd"]
+                            for term in SHELL_NAMES
                         ):
                             background_jobs.append(
                                 {
@@ -360,6 +508,19 @@ class BubbleManager:
 
     def _get_system_info(self) -> Dict[str, Any]:
         """Get system information"""
+        if self._capture is not None:
+            # CPU is measured since the previous capture rather than sampled for a second
+            system = self._capture.system(os.getcwd())
+            return {
+                "cpu_percent": round(system.cpu_percent, 1),
+                "memory_percent": round(system.memory_percent, 1),
+                "memory_used_gb": round(system.memory_used / (1024**3), 2),
+                "memory_total_gb": round(system.memory_total / (1024**3), 2),
+                "disk_percent": round(system.disk_percent, 1),
+                "disk_free_gb": round(system.disk_free / (1024**3), 2),
+                "network_connections": system.network_connections,
+            }
+
         system_info = {}
 
         try:
@@ -12,7 +12,7 @@ from typing import Any, Dict, List, Optional
 sys.path.insert(0, str(Path(__file__).parent.parent.parent.parent))
 
 from isaac.commands.base import BaseCommand, CommandManifest, FlagParser, CommandResponse
-from isaac.tools import EditTool
+from isaac.tools import EditTool, flush_edits
 
 
 class EditCommand(BaseCommand):
@@ -68,6 +68,7 @@ class EditCommand(BaseCommand):
                 new_string=new_string,
                 replace_all=replace_all
             )
+            flush_edits()
 
             if result["success"]:
                 # Prepare response
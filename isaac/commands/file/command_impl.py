@@ -12,7 +12,7 @@ from typing import Any, Dict, List, Optional
 sys.path.insert(0, str(Path(__file__).parent.parent.parent.parent))
 
 from isaac.commands.base import BaseCommand, CommandManifest, FlagParser, CommandResponse
-from isaac.tools import EditTool, ReadTool, WriteTool
+from isaac.tools import EditTool, ReadTool, WriteTool, flush_edits
 
 
 class FileCommand(BaseCommand):
@@ -191,6 +191,7 @@ class FileCommand(BaseCommand):
                 new_string=new_string,
                 replace_all=replace_all
             )
+            flush_edits()
 
             if result["success"]:
                 output = f"Edited: {result['file_path']}\n"
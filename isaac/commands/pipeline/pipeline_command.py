@@ -178,6 +178,7 @@ class PipelineCommand:
             if execution.end_time and execution.start_time:
                 duration = execution.end_time - execution.start_time
                 output += f"Duration: {duration:.2f}s\n"
+            output += self._format_critical_path(execution)
             if execution.error_message:
                 output += f"Error: {execution.error_message}\n"
         else:
@@ -189,6 +190,14 @@ class PipelineCommand:
 
         return {"success": True, "output": output, "exit_code": 0}
 
+    def _format_critical_path(self, execution) -> str:
+        """One line naming the steps that determined the run time."""
+        path = execution.metadata.get("critical_path")
+        if not path:
+            return ""
+        seconds = execution.metadata.get("critical_path_seconds", 0)
+        return f"Critical path: {' -> '.join(path)} ({seconds:.2f}s)\n"
+
     def _show_status(self, args: List[str]) -> Dict[str, Any]:
         """Show pipeline execution status."""
         if not args:
@@ -249,6 +258,7 @@ class PipelineCommand:
         if execution.end_time:
             duration = execution.end_time - execution.start_time
             output += f"Duration: {duration:.2f} seconds\n"
+            output += self._format_critical_path(execution)
 
         if execution.error_message:
             output += f"Error: {execution.error_message}\n"
@@ -259,7 +269,8 @@ class PipelineCommand:
             for step_id, result in execution.steps_results.items():
                 status = "✅" if result["success"] else "❌"
                 duration = result.get("duration", 0)
-                output += f"  {status} {step_id}: {duration:.2f}s\n"
+                cached = " (cached)" if result.get("cached") else ""
+                output += f"  {status} {step_id}: {duration:.2f}s{cached}\n"
 
                 if not result["success"]:
                     error_output = result.get("output", "")[:100]
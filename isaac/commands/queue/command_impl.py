@@ -35,7 +35,7 @@ class QueueCommand(BaseCommand):
 
             # Get queue status
             status = session.get_queue_status()
-            pending = session.queue.dequeue_pending(limit=50)
+            pending = session.queue.list_pending(limit=50)
 
             # Format output
             output = []
@@ -23,7 +23,7 @@ class StatusCommand(BaseCommand):
         Execute status command.
 
         Args:
-            args: Command arguments (flags like -v for verbose)
+            args: Command arguments (flags like -v for verbose, or "metrics")
             context: Optional execution context (includes session info)
 
         Returns:
@@ -38,7 +38,9 @@ class StatusCommand(BaseCommand):
         session = context.get("session", {}) if context else {}
 
         try:
-            if verbose:
+            if "metrics" in parser.positional:
+                output = self._get_metrics_status()
+            elif verbose:
                 # Detailed status with AI session info
                 output = self._get_detailed_status(session)
             else:
@@ -214,16 +216,49 @@ class StatusCommand(BaseCommand):
 
         return "\n".join(lines)
 
+    def _get_metrics_status(self) -> str:
+        """Return latency percentiles and counters from the last metrics export"""
+        from isaac.core.performance_manager import read_exported_metrics
+
+        metrics = read_exported_metrics()
+        if not metrics:
+            return "No metrics exported yet (the shell exports them every minute)"
+
+        histograms = {n: m for n, m in metrics.items() if m["kind"] == "histogram"}
+        others = {n: m for n, m in metrics.items() if m["kind"] != "histogram"}
+
+        lines = []
+        lines.append(f"{'Latency (ms)':<32} {'count':>8} {'p50':>9} {'p99':>9} {'p999':>9}")
+        # Command types (router.*) first, then everything else
+        for name in sorted(histograms, key=lambda n: (not n.startswith("router."), n)):
+            stats = histograms[name]
+            lines.append(
+                f"{name:<32} {int(stats.get('count', 0)):>8} "
+                f"{stats.get('p50_ms', 0):>9.2f} {stats.get('p99_ms', 0):>9.2f} "
+                f"{stats.get('p999_ms', 0):>9.2f}"
+            )
+
+        if others:
+            lines.append("")
+            for name in sorted(others):
+                value = others[name].get("value", 0)
+                lines.append(f"{name:<32} {value:>8g}  ({others[name]['kind']})")
+
+        newest = max(m["timestamp"] for m in metrics.values())
+        lines.append(f"\nExported {newest[:19].replace('T', ' ')}")
+        return "\n".join(lines)
+
     def get_manifest(self) -> CommandManifest:
         """Get command manifest"""
         return CommandManifest(
             name="status",
             description="Display Isaac system status",
-            usage="/status [-v|--verbose]",
+            usage="/status [metrics] [-v|--verbose]",
             examples=[
                 "/status",
                 "/status -v",
-                "/status --verbose"
+                "/status --verbose",
+                "/status metrics"
             ],
             tier=1,  # Safe - read-only information
             aliases=[],
@@ -40,7 +40,7 @@ class SyncCommand(BaseCommand):
 
             if dry_run:
                 # Show what would be synced
-                pending = session.queue.dequeue_pending(limit=100)
+                pending = session.queue.list_pending(limit=100)
                 output = []
                 output.append(f"Dry run: {len(pending)} commands would be synced")
                 output.append("")
@@ -163,15 +163,18 @@ class TimeMachineCommand:
         if not args:
             return {
                 "success": False,
-                "output": "Usage: /timemachine restore <timestamp|index>\n\n"
+                "output": "Usage: /timemachine restore <timestamp|index|time|branch:name>\n\n"
                 "Examples:\n"
                 "  /timemachine restore 1640995200  # Unix timestamp\n"
                 "  /timemachine restore 5           # Timeline index\n"
-                '  /timemachine restore "2024-01-01 12:00:00"  # Date string',
+                '  /timemachine restore "2024-01-01 12:00:00"  # Date string\n'
+                "  /timemachine restore 14:32 yesterday     # Clock time\n"
+                "  /timemachine restore 2h ago              # Relative time\n"
+                "  /timemachine restore branch:main         # Last snapshot on a branch",
                 "exit_code": 1,
             }
 
-        time_spec = args[0]
+        time_spec = " ".join(args)
 
         try:
             # Try as timeline index first
@@ -179,17 +182,21 @@ class TimeMachineCommand:
                 index = int(time_spec)
                 success = self.time_machine.restore_to_entry(index)
                 action = f"timeline entry {index}"
+            elif time_spec.startswith("branch:"):
+                branch = time_spec[len("branch:") :]
+                entry = self.time_machine.last_snapshot_on_branch(branch)
+                if entry is None:
+                    return {
+                        "success": False,
+                        "output": f"No snapshots on branch {branch}",
+                        "exit_code": 1,
+                    }
+                index = self.time_machine.timeline.entries.index(entry)
+                success = self.time_machine.restore_to_entry(index)
+                action = f"last snapshot on branch {branch}"
             else:
-                # Try to parse as timestamp or datetime string
-                try:
-                    # Try unix timestamp
-                    timestamp = float(time_spec)
-                except ValueError:
-                    # Try datetime string
-                    dt = datetime.strptime(time_spec, "%Y-%m-%d %H:%M:%S")
-                    timestamp = dt.timestamp()
-
-                success = self.time_machine.restore_to_timestamp(timestamp)
+                # Timestamps, dates, clock times and relative times
+                success = self.time_machine.restore_to_timestamp(time_spec)
                 action = f"timestamp {time_spec}"
 
             if success:
@@ -323,7 +330,7 @@ USAGE:
 ACTIONS:
   snapshot [-d desc] [-f]           Create manual snapshot
   timeline [-f type] [-s query]     Show timeline entries
-  restore <time>                   Restore to timestamp/index
+  restore <time>                   Restore to timestamp/index/time/branch:name
   browse                           Interactive timeline browser
   playback [--start n] [--end n]   Playback timeline evolution
   search <query>                   Search timeline entries
@@ -11,6 +11,7 @@ from typing import Any, AsyncGenerator, Callable, Dict, List, Optional
 from ..adapters.base_adapter import CommandResult
 from ..ai import AIRouter
 from ..core.session_manager import SessionManager
+from ..tools import flush_edits
 from ..tools.registry import ToolRegistry
 from ..ui.progress_indicator import ProgressIndicator
 from ..ui.streaming_display import DisplayMode, StreamingDisplay
@@ -114,6 +115,9 @@ class AgenticOrchestrator:
             async for event in self._stream_agentic_loop(user_input, selected_ai, context):
                 yield event
 
+            # End of turn: edits held in the file tools' buffers go to disk
+            flush_edits()
+
         except Exception as e:
             error_event = {"type": "task_error", "error": str(e), "timestamp": time.time()}
             self._emit_event("task_error", error_event)
@@ -3,11 +3,13 @@ CommandRouter - Routes commands through safety tiers and AI processing
 SAFETY-CRITICAL: Ensures all commands go through appropriate validation
 """
 
+import re
 from pathlib import Path
 from typing import Optional
 
 from isaac.adapters.base_adapter import CommandResult
 from isaac.ai.query_classifier import QueryClassifier
+from isaac.core.performance_manager import performance_monitor
 from isaac.core.tier_validator import TierValidator
 from isaac.orchestration import LoadBalancingStrategy, RemoteExecutor
 from isaac.runtime import CommandDispatcher
@@ -874,6 +876,14 @@ class TierExecutionStrategy(BaseStrategy):
             logger.debug(f"Failed to track correction acceptance: {e}")
 
 
+def _latency_name(strategy) -> str:
+    """Histogram name for a strategy, e.g. PipeStrategy -> router.pipe"""
+    name = type(strategy).__name__
+    if name.endswith("Strategy"):
+        name = name[: -len("Strategy")]
+    return "router." + re.sub(r"(?<!^)(?=[A-Z])", "_", name).lower()
+
+
 class CommandRouter:
     """Routes commands through tier validation and AI processing."""
 
@@ -952,7 +962,8 @@ class CommandRouter:
         for strategy in self.strategies:
             if strategy.can_handle(input_text):
                 self.current_strategy = strategy
-                return strategy.execute(input_text, context)
+                with performance_monitor.time_block(_latency_name(strategy)):
+                    return strategy.execute(input_text, context)
 
         # Should never reach here - TierExecutionStrategy should handle all
         return CommandResult(
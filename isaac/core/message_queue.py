@@ -4,12 +4,14 @@
 Message Queue System - Notification management for autonomous AI assistant
 
 Handles queuing and management of system and code-related notifications
-with persistent storage and priority-based retrieval.
+with persistent storage and priority-based retrieval. Uses the native
+message log when the C++ core is built, SQLite otherwise.
 """
 
 import json
 import logging
 import sqlite3
+import threading
 from datetime import datetime, timedelta
 from enum import Enum
 from pathlib import Path
@@ -17,6 +19,19 @@ from typing import Any, Dict, List, Optional
 
 logger = logging.getLogger(__name__)
 
+# Optional native message store (C++ core)
+try:
+    from isaac.isaac_core import MessageStore
+
+    NATIVE_MESSAGES_AVAILABLE = True
+except ImportError:
+    MessageStore = None
+    NATIVE_MESSAGES_AVAILABLE = False
+
+# One native store per log directory, shared by every MessageQueue in the process
+_native_stores: Dict[str, Any] = {}
+_native_stores_lock = threading.Lock()
+
 
 class MessageType(Enum):
     """Types of messages in the queue."""
@@ -40,23 +55,94 @@ class MessageQueue:
 
     Stores messages by type (system/code) with priority and metadata.
     Provides queue management and retrieval operations.
+
+    With the native core, messages live in an in-memory index backed by an
+    append log, and pending counts are counters next to it, so the prompt
+    indicator costs a lock and a stat of the log rather than a query. The
+    shell, the monitors and subprocesses share the log under a file lock,
+    each catching up on the others' records before it reads or writes.
     """
 
-    def __init__(self, db_path: Optional[Path] = None):
+    def __init__(self, db_path: Optional[Path] = None, use_native: bool = True):
         """
         Initialize message queue.
 
         Args:
             db_path: Path to SQLite database file. If None, uses default location.
+                The native log lives beside it.
+            use_native: Use the native message store when available
         """
         if db_path is None:
             db_path = Path.home() / ".isaac" / "message_queue.db"
 
         self.db_path = db_path
         self.db_path.parent.mkdir(parents=True, exist_ok=True)
-        self._init_db()
+        self._native = None
+
+        if use_native and NATIVE_MESSAGES_AVAILABLE:
+            self._native = self._open_native(db_path.with_name(f"{db_path.stem}_log"))
+        else:
+            self._init_db()
         logger.info(f"Message queue initialized at {db_path}")
 
+    def _open_native(self, log_dir: Path):
+        """Open (or reuse) the store for log_dir, migrating an existing SQLite queue once."""
+        key = str(log_dir.resolve())
+        with _native_stores_lock:
+            store = _native_stores.get(key)
+            if store is None:
+                store = MessageStore(key)
+                _native_stores[key] = store
+                if self.db_path.exists():
+                    self._migrate_sqlite(store)
+        return store
+
+    def _migrate_sqlite(self, store):
+        """Move messages from an existing SQLite queue into the native store."""
+        conn = sqlite3.connect(str(self.db_path))
+        try:
+            rows = conn.execute(
+                """
+                SELECT created_at, message_type, priority, title, content, metadata, acknowledged_at
+                FROM messages ORDER BY id
+            """
+            ).fetchall()
+        except sqlite3.DatabaseError:
+            rows = []
+        conn.close()
+
+        def to_us(text):
+            return int(datetime.fromisoformat(text).timestamp() * 1_000_000) if text else 0
+
+        migrated = 0
+        for created_at, message_type, priority, title, content, metadata, acknowledged_at in rows:
+            try:
+                message_id = store.add(
+                    message_type, priority, title, content or "", metadata, to_us(created_at)
+                )
+            except ValueError:
+                continue  # unknown type or priority
+            if acknowledged_at:
+                store.acknowledge(message_id, to_us(acknowledged_at))
+            migrated += 1
+        self.db_path.rename(self.db_path.with_name(self.db_path.name + ".migrated"))
+        logger.info(f"Migrated {migrated} messages to the native message store")
+
+    @staticmethod
+    def _to_dict(message, empty_metadata=None) -> Dict[str, Any]:
+        """Native StoredMessage -> dict in the SQLite row shape"""
+        return {
+            "id": message.id,
+            "created_at": message.created_at,
+            "message_type": message.message_type,
+            "priority": message.priority,
+            "title": message.title,
+            "content": message.content,
+            "metadata": json.loads(message.metadata) if message.metadata else empty_metadata,
+            "acknowledged_at": message.acknowledged_at,
+            "status": message.status,
+        }
+
     def _init_db(self):
         """Create message queue table and indexes."""
         conn = sqlite3.connect(str(self.db_path))
@@ -114,6 +200,17 @@ class MessageQueue:
         Returns:
             Message ID
         """
+        if self._native is not None:
+            message_id = self._native.add(
+                message_type.value,
+                priority.value,
+                title,
+                content,
+                json.dumps(metadata) if metadata else None,
+            )
+            logger.info(f"Added {message_type.value} message: {title}")
+            return message_id
+
         conn = sqlite3.connect(str(self.db_path))
         try:
             cursor = conn.cursor()
@@ -145,6 +242,9 @@ class MessageQueue:
         Returns:
             Dict with 'system' and 'code' counts
         """
+        if self._native is not None:
+            return {"system": self._native.pending("system"), "code": self._native.pending("code")}
+
         conn = sqlite3.connect(str(self.db_path))
         try:
             cursor = conn.cursor()
@@ -179,6 +279,12 @@ class MessageQueue:
         Returns:
             List of message dictionaries
         """
+        if self._native is not None:
+            messages = self._native.list(
+                message_type.value if message_type else None, status, limit
+            )
+            return [self._to_dict(message) for message in messages]
+
         conn = sqlite3.connect(str(self.db_path))
         try:
             cursor = conn.cursor()
@@ -235,6 +341,12 @@ class MessageQueue:
         Returns:
             True if message was acknowledged, False if not found
         """
+        if self._native is not None:
+            success = self._native.acknowledge(message_id)
+            if success:
+                logger.info(f"Acknowledged message {message_id}")
+            return success
+
         conn = sqlite3.connect(str(self.db_path))
         try:
             cursor = conn.cursor()
@@ -267,6 +379,11 @@ class MessageQueue:
         Returns:
             Number of messages acknowledged
         """
+        if self._native is not None:
+            count = self._native.acknowledge_all(message_type.value if message_type else None)
+            logger.info(f"Acknowledged {count} messages")
+            return count
+
         conn = sqlite3.connect(str(self.db_path))
         try:
             cursor = conn.cursor()
@@ -308,6 +425,12 @@ class MessageQueue:
         Returns:
             Number of messages removed
         """
+        if self._native is not None:
+            count = self._native.cleanup(days)
+            if count > 0:
+                logger.info(f"Cleaned up {count} old messages")
+            return count
+
         cutoff_date = datetime.now() - timedelta(days=days)
 
         conn = sqlite3.connect(str(self.db_path))
@@ -341,6 +464,10 @@ class MessageQueue:
         Returns:
             Message dict or None if not found
         """
+        if self._native is not None:
+            message = self._native.get(message_id)
+            return self._to_dict(message, empty_metadata={}) if message is not None else None
+
         conn = sqlite3.connect(str(self.db_path))
         try:
             cursor = conn.cursor()
@@ -385,6 +512,12 @@ class MessageQueue:
         Returns:
             True if message was deleted, False if not found
         """
+        if self._native is not None:
+            success = self._native.remove(message_id)
+            if success:
+                logger.info(f"Deleted message {message_id}")
+            return success
+
         conn = sqlite3.connect(str(self.db_path))
         try:
             cursor = conn.cursor()
@@ -412,6 +545,12 @@ class MessageQueue:
         Returns:
             Number of messages deleted
         """
+        if self._native is not None:
+            count = self._native.clear(message_type.value if message_type else None, status)
+            if count > 0:
+                logger.info(f"Cleared {count} messages")
+            return count
+
         conn = sqlite3.connect(str(self.db_path))
         try:
             cursor = conn.cursor()
@@ -446,8 +585,11 @@ class MessageQueue:
         Returns:
             String like '[7$]>' for 7 messages or '$>' if no messages
         """
-        counts = self.get_pending_counts()
-        total_count = counts["system"] + counts["code"]
+        if self._native is not None:
+            total_count = self._native.pending_total()
+        else:
+            counts = self.get_pending_counts()
+            total_count = counts["system"] + counts["code"]
 
         if total_count == 0:
             return "$>"
@@ -5,13 +5,92 @@ Multi-file Operations - Batch file operations with AI assistance
 Enables cross-file refactoring, batch operations, and project-wide analysis.
 """
 
+import fnmatch
 import logging
 import re
+from collections import namedtuple
 from pathlib import Path
-from typing import Any, Dict, List
+from typing import Any, Dict, Iterator, List, Tuple
 
 logger = logging.getLogger(__name__)
 
+# Optional native search engine (C++ core)
+try:
+    from isaac.isaac_core import BatchReplacer, DependencyGraph, FileSearcher, SymbolIndex
+
+    NATIVE_GREP_AVAILABLE = True
+except ImportError:
+    BatchReplacer = None
+    DependencyGraph = None
+    FileSearcher = None
+    SymbolIndex = None
+    NATIVE_GREP_AVAILABLE = False
+
+# Native import kinds -> analyze_dependencies keys
+_DEPENDENCY_KEYS = {
+    "import": "imports",
+    "from": "from_imports",
+    "require": "requires",
+    "include": "includes",
+}
+
+# Extensions covered by the native symbol index -> _DEFINITION_TYPES language
+_INDEXED_LANGUAGES = {
+    ".py": "py", ".pyi": "py",
+    ".js": "js", ".jsx": "js", ".ts": "js", ".tsx": "js", ".mjs": "js", ".cjs": "js",
+    ".c": "c", ".cc": "c", ".cpp": "c", ".cxx": "c", ".h": "c", ".hh": "c", ".hpp": "c", ".hxx": "c",
+}
+
+# Native symbol kinds -> find_definition "type" values of the regex scan
+_DEFINITION_TYPES = {
+    ("py", "function"): "^def",
+    ("py", "method"): "^def",
+    ("py", "class"): "^class",
+    ("js", "function"): "function",
+    ("js", "method"): "function",
+    ("js", "class"): "class",
+    ("js", "variable"): "const",
+}
+
+
+def _matches_any(rel_path: str, patterns: List[str]) -> bool:
+    """fnmatch against project globs, letting a leading **/ also match top-level files"""
+    for pattern in patterns:
+        if fnmatch.fnmatch(rel_path, pattern):
+            return True
+        if pattern.startswith("**/") and fnmatch.fnmatch(rel_path, pattern[3:]):
+            return True
+    return False
+
+# Python-only regex syntax stays on the re path, including escapes ECMAScript
+# reads differently (\101 is octal in re but a backreference natively)
+_PYTHON_ONLY_SYNTAX = re.compile(r"\\[AZ]|\(\?[aiLmsux]|\(\?P|\\[0-7]{3}|\\0[0-7]|\\N\{|\\U")
+# Search is line-oriented natively, so patterns that can span lines also stay on re
+_PYTHON_ONLY_REGEX = re.compile(_PYTHON_ONLY_SYNTAX.pattern + r"|\\[nr]|\n")
+# re-path stand-ins for the native LineMatch / FileMatches
+_LineMatch = namedtuple("_LineMatch", "line column match context")
+_FileMatches = namedtuple("_FileMatches", "path matches long_lines")
+_REPLACEMENT_ESCAPE = re.compile(r"\\(?:g<(\d+)>|(\d{1,2})|(.))", re.DOTALL)
+_REPLACEMENT_CHARS = {"\\": "\\", "n": "\n", "t": "\t", "r": "\r"}
+
+
+def _to_ecma_replacement(replacement: str):
+    """Translate an re.sub replacement into ECMAScript format syntax, or None if unsupported"""
+    parts = []
+    pos = 0
+    for escape in _REPLACEMENT_ESCAPE.finditer(replacement):
+        parts.append(replacement[pos : escape.start()].replace("$", "$$"))
+        group = escape.group(1) or escape.group(2)
+        if group is not None:
+            parts.append(f"${int(group):02d}" if int(group) < 100 else None)
+        else:
+            parts.append(_REPLACEMENT_CHARS.get(escape.group(3)))
+        if parts[-1] is None:
+            return None
+        pos = escape.end()
+    parts.append(replacement[pos:].replace("$", "$$"))
+    return "".join(parts)
+
 
 class MultiFileOperationManager:
     """
@@ -34,6 +113,55 @@ class MultiFileOperationManager:
         """
         self.project_root = project_root
         self.rag_engine = rag_engine
+        self.searcher = FileSearcher(str(project_root)) if NATIVE_GREP_AVAILABLE else None
+        self.replacer = BatchReplacer(str(project_root)) if NATIVE_GREP_AVAILABLE else None
+        self.dependency_graph = DependencyGraph(str(project_root)) if NATIVE_GREP_AVAILABLE else None
+        self.symbol_index = SymbolIndex(str(project_root)) if NATIVE_GREP_AVAILABLE else None
+        self._dependency_graph_ready = False
+        self._symbol_index_ready = False
+
+        if self.replacer is not None:
+            # Roll back any replace interrupted mid-commit by a crash; a commit
+            # still running in another process holds the journal lock
+            for transaction_id in BatchReplacer.recover(str(project_root)):
+                logger.warning(f"Rolled back interrupted batch replace {transaction_id}")
+
+    def _native_search(self, pattern: str, file_patterns: List[str]):
+        """Run a search on the native engine, or return None to use the re path"""
+        if self.searcher is None or _PYTHON_ONLY_REGEX.search(pattern):
+            return None
+        try:
+            results = self.searcher.search(pattern, include_globs=file_patterns)
+        except ValueError as e:
+            logger.debug(f"Native search unavailable for pattern, using re: {e}")
+            return None
+        results = [self._rescan_long_lines(file_matches, pattern) for file_matches in results]
+        return [file_matches for file_matches in results if file_matches.matches]
+
+    def _rescan_long_lines(self, file_matches, pattern: str):
+        """
+        Search with re a file the native engine skipped because a line was too
+        long for std::regex to match without overflowing the stack. Matching
+        stays line-oriented, like the native search.
+        """
+        if not file_matches.long_lines:
+            return file_matches
+
+        matches = []
+        try:
+            content = (self.project_root / file_matches.path).read_text(encoding="utf-8", errors="ignore")
+            offset = 0
+            for number, line in enumerate(content.split("\n"), 1):
+                for match in re.finditer(pattern, line):
+                    start = offset + match.start()
+                    end = offset + match.end()
+                    matches.append(
+                        _LineMatch(number, match.start(), match.group(), content[max(0, start - 50) : end + 50])
+                    )
+                offset += len(line) + 1
+        except (OSError, re.error) as e:
+            logger.error(f"Error searching {file_matches.path}: {e}")
+        return _FileMatches(file_matches.path, matches, False)
 
     def batch_search(self, pattern: str, file_patterns: List[str] = None) -> Dict[str, List[Dict]]:
         """
@@ -51,6 +179,16 @@ class MultiFileOperationManager:
         if file_patterns is None:
             file_patterns = ["**/*.py", "**/*.js", "**/*.ts"]
 
+        native = self._native_search(pattern, file_patterns)
+        if native is not None:
+            for file_matches in native:
+                results[file_matches.path] = [
+                    {"line": m.line, "match": m.match, "context": m.context}
+                    for m in file_matches.matches
+                ]
+            logger.info(f"Batch search found {len(results)} files with matches")
+            return results
+
         for glob_pattern in file_patterns:
             for file_path in self.project_root.glob(glob_pattern):
                 if not file_path.is_file():
@@ -84,17 +222,63 @@ class MultiFileOperationManager:
         logger.info(f"Batch search found {len(results)} files with matches")
         return results
 
+    def batch_search_stream(
+        self, pattern: str, file_patterns: List[str] = None, timeout_ms: int = 100
+    ) -> Iterator[Tuple[str, List[Dict]]]:
+        """
+        Search for pattern, yielding (file path, matches) as each file completes
+
+        Falls back to yielding the batch_search results when the native
+        engine is unavailable or cannot run the pattern.
+        """
+        if file_patterns is None:
+            file_patterns = ["**/*.py", "**/*.js", "**/*.ts"]
+
+        stream = None
+        if self.searcher is not None and not _PYTHON_ONLY_REGEX.search(pattern):
+            try:
+                stream = self.searcher.search_stream(pattern, include_globs=file_patterns)
+            except ValueError:
+                stream = None
+
+        if stream is None:
+            yield from self.batch_search(pattern, file_patterns).items()
+            return
+
+        try:
+            while not stream.finished():
+                for file_matches in stream.next_batch(timeout_ms):
+                    file_matches = self._rescan_long_lines(file_matches, pattern)
+                    if not file_matches.matches:
+                        continue
+                    yield file_matches.path, [
+                        {"line": m.line, "match": m.match, "context": m.context}
+                        for m in file_matches.matches
+                    ]
+        finally:
+            stream.cancel()
+
     def batch_replace(
-        self, pattern: str, replacement: str, file_patterns: List[str] = None, dry_run: bool = True
+        self,
+        pattern: str,
+        replacement: str,
+        file_patterns: List[str] = None,
+        dry_run: bool = True,
+        show_diff: bool = False,
     ) -> Dict[str, Any]:
         """
         Replace pattern across multiple files
 
+        With the native engine every file is rewritten in parallel into a temp
+        file and the whole set is committed at once (or not at all); the
+        returned transaction_id can be passed to undo_batch_replace.
+
         Args:
             pattern: Regex pattern to replace
             replacement: Replacement string
             file_patterns: Optional list of file glob patterns
             dry_run: If True, only show what would be changed
+            show_diff: If True, include a unified diff per changed file
 
         Returns:
             Operation results with changes per file
@@ -105,6 +289,10 @@ class MultiFileOperationManager:
         if file_patterns is None:
             file_patterns = ["**/*.py", "**/*.js", "**/*.ts"]
 
+        native = self._native_replace(pattern, replacement, file_patterns, dry_run, show_diff)
+        if native is not None:
+            return native
+
         for glob_pattern in file_patterns:
             for file_path in self.project_root.glob(glob_pattern):
                 if not file_path.is_file():
@@ -142,6 +330,221 @@ class MultiFileOperationManager:
             "dry_run": dry_run,
         }
 
+    def _native_replace(
+        self,
+        pattern: str,
+        replacement: str,
+        file_patterns: List[str],
+        dry_run: bool,
+        show_diff: bool,
+    ):
+        """Run batch_replace on the native engine, or return None to use the re path"""
+        ecma_replacement = _to_ecma_replacement(replacement)
+        if self.replacer is None or ecma_replacement is None or _PYTHON_ONLY_SYNTAX.search(pattern):
+            return None
+        try:
+            plan = self.replacer.prepare(
+                pattern, ecma_replacement, include_globs=file_patterns, dry_run=dry_run
+            )
+        except ValueError as e:
+            logger.debug(f"Native replace unavailable for pattern, using re: {e}")
+            return None
+        except RuntimeError as e:
+            return self._replace_error(e, dry_run)
+
+        changes = {}
+        for edit in plan.edits():
+            changes[edit.path] = {
+                "replacements": edit.replacements,
+                "original_size": edit.original_size,
+                "new_size": edit.new_size,
+            }
+            if show_diff:
+                changes[edit.path]["diff"] = plan.diff(edit.path)
+
+        if dry_run:
+            plan.discard()
+        else:
+            try:
+                plan.commit()
+            except RuntimeError as e:
+                return self._replace_error(e, dry_run)
+
+        total_replacements = plan.total_replacements()
+        mode = "dry-run" if dry_run else "applied"
+        logger.info(
+            f"Batch replace ({mode}): {total_replacements} replacements in {len(changes)} files"
+        )
+
+        result = {
+            "files_changed": len(changes),
+            "total_replacements": total_replacements,
+            "changes": changes,
+            "dry_run": dry_run,
+        }
+        if not dry_run:
+            result["transaction_id"] = plan.transaction_id()
+        return result
+
+    @staticmethod
+    def _replace_error(error: Exception, dry_run: bool) -> Dict[str, Any]:
+        """batch_replace result for a native replace that changed nothing"""
+        logger.error(f"Batch replace failed: {error}")
+        return {
+            "files_changed": 0,
+            "total_replacements": 0,
+            "changes": {},
+            "dry_run": dry_run,
+            "error": str(error),
+        }
+
+    def undo_batch_replace(self, transaction_id: str, force: bool = False) -> Dict[str, Any]:
+        """
+        Restore the files changed by a committed native batch_replace
+
+        Args:
+            transaction_id: Id returned by batch_replace
+            force: Restore even if a file was edited after the replace
+
+        Returns:
+            Operation result with the number of files restored
+        """
+        if self.replacer is None:
+            return {"success": False, "error": "Native replace engine not available"}
+        try:
+            restored = BatchReplacer.undo(str(self.project_root), transaction_id, force=force)
+        except (ValueError, RuntimeError) as e:
+            return {"success": False, "error": str(e)}
+        return {"success": True, "files_restored": restored}
+
+    def _load_native_index(self, index, cache_name: str) -> int:
+        """Load a cached native index, rescan changed files and save it back; returns files scanned"""
+        cache_path = self.project_root / ".isaac" / cache_name
+        index.load(str(cache_path))
+        cached_files = index.file_count()
+        scanned = index.build()
+        if scanned or index.file_count() != cached_files:
+            cache_path.parent.mkdir(parents=True, exist_ok=True)
+            index.save(str(cache_path))
+        return scanned
+
+    def _ensure_dependency_graph(self):
+        """Load the cached dependency graph and rescan changed files, once per session"""
+        if self.dependency_graph is None:
+            return None
+
+        if not self._dependency_graph_ready:
+            scanned = self._load_native_index(self.dependency_graph, "dependency_graph.bin")
+            logger.info(
+                f"Dependency graph ready: {self.dependency_graph.file_count()} files, "
+                f"{self.dependency_graph.edge_count()} edges ({scanned} scanned)"
+            )
+            self._dependency_graph_ready = True
+        return self.dependency_graph
+
+    def _ensure_symbol_index(self):
+        """Load the cached symbol index and rescan changed files, once per session"""
+        if self.symbol_index is None:
+            return None
+
+        if not self._symbol_index_ready:
+            scanned = self._load_native_index(self.symbol_index, "symbol_index.bin")
+            logger.info(
+                f"Symbol index ready: {self.symbol_index.symbol_count()} symbols in "
+                f"{self.symbol_index.file_count()} files ({scanned} scanned)"
+            )
+            self._symbol_index_ready = True
+        return self.symbol_index
+
+    def _relative_key(self, file_path) -> str:
+        """Project-relative POSIX path used as the dependency graph key"""
+        path = Path(file_path)
+        if path.is_absolute():
+            path = path.relative_to(self.project_root)
+        return path.as_posix()
+
+    def on_files_changed(self, changed: List[str], deleted: List[str]):
+        """
+        Apply watched file changes to the dependency graph and symbol index
+
+        Args:
+            changed: Project-relative paths created or modified
+            deleted: Project-relative paths removed
+        """
+        # Indexes not built yet pick the changes up on their first build
+        indexes = []
+        if self._dependency_graph_ready:
+            indexes.append(self.dependency_graph)
+        if self._symbol_index_ready:
+            indexes.append(self.symbol_index)
+
+        for index in indexes:
+            for key in changed:
+                index.update_file(self._relative_key(key))
+            for key in deleted:
+                index.remove_file(self._relative_key(key))
+
+    def find_symbols(self, prefix: str, limit: int = 100) -> List[Dict]:
+        """
+        Symbols whose name starts with prefix (native index only)
+
+        Args:
+            prefix: Name prefix, case-sensitive
+            limit: Maximum number of results
+
+        Returns:
+            Definitions sorted by name, then file and line
+        """
+        index = self._ensure_symbol_index()
+        if index is None:
+            return []
+
+        return [
+            {
+                "name": sym.name,
+                "file": sym.path,
+                "line": sym.line,
+                "kind": sym.kind,
+                "context": sym.signature,
+            }
+            for sym in index.find_prefix(prefix, limit)
+        ]
+
+    def find_dependents(self, file_path: Path, transitive: bool = False) -> List[str]:
+        """
+        Files that import a file or external module
+
+        Args:
+            file_path: Project file, or an external module name such as "requests"
+            transitive: Follow importers of importers
+
+        Returns:
+            Project-relative paths, sorted
+        """
+        graph = self._ensure_dependency_graph()
+        if graph is None:
+            return []
+
+        key = self._relative_key(file_path)
+        return graph.impacted([key]) if transitive else graph.dependents(key)
+
+    def impacted_files(self, changed_files: List[Path], max_depth: int = 0) -> List[str]:
+        """
+        Files affected by changes to changed_files (transitive importers)
+
+        Args:
+            changed_files: Changed project files
+            max_depth: Import hops to follow (0 = unbounded)
+
+        Returns:
+            Project-relative paths, sorted, excluding changed_files
+        """
+        graph = self._ensure_dependency_graph()
+        if graph is None:
+            return []
+
+        return graph.impacted([self._relative_key(path) for path in changed_files], max_depth)
+
     def analyze_dependencies(self, file_path: Path) -> Dict[str, Any]:
         """
         Analyze file dependencies (imports, requires)
@@ -152,6 +555,32 @@ class MultiFileOperationManager:
         Returns:
             Dependency analysis results
         """
+        graph = self._ensure_dependency_graph()
+        if graph is not None:
+            try:
+                key = self._relative_key(file_path)
+                graph.update_file(key)
+                if graph.contains(key):
+                    dependencies = {"imports": [], "from_imports": [], "requires": []}
+                    for ref in graph.imports(key):
+                        dependencies.setdefault(_DEPENDENCY_KEYS[ref.kind], []).append(ref.spec)
+                    return {
+                        "file": str(file_path.relative_to(self.project_root))
+                        if file_path.is_absolute()
+                        else str(file_path),
+                        "dependencies": dependencies,
+                        "dependency_count": sum(len(v) for v in dependencies.values()),
+                        "resolved": graph.dependencies(key),
+                        "external": [
+                            name
+                            for name in graph.dependencies(key, include_external=True)
+                            if not graph.contains(name)
+                        ],
+                        "dependents": graph.dependents(key),
+                    }
+            except ValueError:
+                pass  # outside the project root: fall back to the regex scan
+
         try:
             content = file_path.read_text(encoding="utf-8", errors="ignore")
             file_type = file_path.suffix
@@ -210,6 +639,47 @@ class MultiFileOperationManager:
             rf"class\s+{symbol}\s*\{{",  # JS class
         ]
 
+        # Indexed languages: answer from the symbol table without touching the tree
+        indexed = all(Path(pattern).suffix in _INDEXED_LANGUAGES for pattern in file_patterns)
+        index = self._ensure_symbol_index() if indexed else None
+        if index is not None:
+            for sym in index.find(symbol):
+                if not _matches_any(sym.path, file_patterns):
+                    continue
+                language = _INDEXED_LANGUAGES.get(Path(sym.path).suffix)
+                if language is None:
+                    continue
+                definitions.append(
+                    {
+                        "file": sym.path,
+                        "line": sym.line,
+                        "type": _DEFINITION_TYPES.get((language, sym.kind), sym.kind),
+                        "kind": sym.kind,
+                        "context": sym.signature,
+                    }
+                )
+            logger.info(f"Found {len(definitions)} definitions for '{symbol}' in symbol index")
+            return definitions
+
+        # One pass over the tree for all definition forms, classified afterwards
+        native = self._native_search("|".join(f"(?:{p})" for p in patterns), file_patterns)
+        if native is not None:
+            for file_matches in native:
+                for m in file_matches.matches:
+                    following = m.context[max(0, m.context.find(m.match)) :]
+                    for pattern in patterns:
+                        if re.match(pattern, m.match):
+                            definitions.append(
+                                {
+                                    "file": file_matches.path,
+                                    "line": m.line,
+                                    "type": pattern.split("\\")[0],  # Approximate type
+                                    "context": following,
+                                }
+                            )
+            logger.info(f"Found {len(definitions)} potential definitions for '{symbol}'")
+            return definitions
+
         for glob_pattern in file_patterns:
             for file_path in self.project_root.glob(glob_pattern):
                 if not file_path.is_file():
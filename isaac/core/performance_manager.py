@@ -3,18 +3,31 @@ Performance Manager - Comprehensive optimization system
 Handles lazy loading, memory management, and performance monitoring
 """
 
+import atexit
 import functools
 import gc
 import importlib
+import math
 import os
 import psutil
 import sys
+import threading
 import time
 import weakref
+from contextlib import contextmanager
+from datetime import datetime, timedelta
 from pathlib import Path
-from typing import Any, Callable, Dict, Optional, Set
+from typing import Any, Callable, Dict, List, Optional, Set
 import logging
 
+try:
+    from isaac.isaac_core import add_counter, metrics_snapshot, record_latency, set_gauge
+
+    NATIVE_METRICS_AVAILABLE = True
+except ImportError:
+    add_counter = metrics_snapshot = record_latency = set_gauge = None
+    NATIVE_METRICS_AVAILABLE = False
+
 logger = logging.getLogger(__name__)
 
 
@@ -137,13 +150,89 @@ class MemoryOptimizer:
         self._weak_refs.add(weakref.ref(obj))
 
 
+class LatencyHistogram:
+    """
+    Log-linear latency histogram, the Python fallback for the native one:
+    values under 16ns get a bucket each, every power of two above is split
+    into 16 sub-buckets, so quantiles are within 6.25% of the true value.
+    """
+
+    SUB_BITS = 4
+
+    def __init__(self):
+        self.buckets: Dict[int, int] = {}
+        self.count = 0
+        self.sum_ns = 0
+        self.min_ns = 0
+        self.max_ns = 0
+
+    @classmethod
+    def bucket_of(cls, nanos: int) -> int:
+        if nanos < (1 << cls.SUB_BITS):
+            return nanos
+        exponent = nanos.bit_length() - 1
+        sub = (nanos >> (exponent - cls.SUB_BITS)) & ((1 << cls.SUB_BITS) - 1)
+        return ((exponent - cls.SUB_BITS + 1) << cls.SUB_BITS) + sub
+
+    @classmethod
+    def bucket_floor(cls, bucket: int) -> int:
+        if bucket < (1 << cls.SUB_BITS):
+            return bucket
+        exponent = (bucket >> cls.SUB_BITS) + cls.SUB_BITS - 1
+        sub = bucket & ((1 << cls.SUB_BITS) - 1)
+        return ((1 << cls.SUB_BITS) + sub) << (exponent - cls.SUB_BITS)
+
+    def record(self, ms: float):
+        nanos = max(int(ms * 1e6), 0)
+        bucket = self.bucket_of(nanos)
+        self.buckets[bucket] = self.buckets.get(bucket, 0) + 1
+        self.min_ns = nanos if not self.count else min(self.min_ns, nanos)
+        self.max_ns = nanos if not self.count else max(self.max_ns, nanos)
+        self.count += 1
+        self.sum_ns += nanos
+
+    def quantile(self, q: float) -> float:
+        """Middle of the bucket holding the q-th value, in ms"""
+        if not self.count:
+            return 0.0
+        rank = max(1, math.ceil(q * self.count))
+        seen = 0
+        for bucket in sorted(self.buckets):
+            seen += self.buckets[bucket]
+            if seen >= rank:
+                floor = self.bucket_floor(bucket)
+                width = self.bucket_floor(bucket + 1) - floor
+                middle = floor + (width - 1) / 2
+                return min(max(middle, self.min_ns), self.max_ns) / 1e6
+        return self.max_ns / 1e6
+
+    def snapshot(self) -> Dict[str, float]:
+        return {
+            "count": self.count,
+            "sum_ms": self.sum_ns / 1e6,
+            "min_ms": self.min_ns / 1e6,
+            "max_ms": self.max_ns / 1e6,
+            "p50_ms": self.quantile(0.50),
+            "p99_ms": self.quantile(0.99),
+            "p999_ms": self.quantile(0.999),
+        }
+
+
 class PerformanceMonitor:
     """
-    Monitors system performance and provides optimization recommendations
+    Monitors system performance and provides optimization recommendations.
+
+    Latencies, counters and gauges go to the native metrics registry when
+    isaac_core is built (where the C++ router, shell adapter and tier
+    validator also report), otherwise to Python histograms.
     """
     
     def __init__(self):
         self.metrics = {}
+        self._lock = threading.Lock()
+        self._histograms: Dict[str, LatencyHistogram] = {}
+        self._counters: Dict[str, int] = {}
+        self._gauges: Dict[str, float] = {}
         self.thresholds = {
             'startup_time_ms': 2000,  # 2 seconds
             'command_latency_ms': 100,  # 100ms
@@ -159,10 +248,78 @@ class PerformanceMonitor:
             'timestamp': time.time()
         }
         
+        if unit == 'ms':
+            self.record_latency(name, value)
+        else:
+            self.set_gauge(name, value)
+
         # Check if metric exceeds threshold
         if name in self.thresholds:
             if value > self.thresholds[name]:
                 logger.warning(f"Performance threshold exceeded: {name}={value}{unit} (threshold: {self.thresholds[name]}{unit})")
+
+    def record_latency(self, name: str, ms: float):
+        """Add one observation to the named latency histogram"""
+        if NATIVE_METRICS_AVAILABLE:
+            record_latency(name, ms)
+            return
+        with self._lock:
+            self._histograms.setdefault(name, LatencyHistogram()).record(ms)
+
+    def increment(self, name: str, n: int = 1):
+        """Add to the named counter"""
+        if NATIVE_METRICS_AVAILABLE:
+            add_counter(name, n)
+            return
+        with self._lock:
+            self._counters[name] = self._counters.get(name, 0) + n
+
+    def set_gauge(self, name: str, value: float):
+        """Set the named gauge"""
+        if NATIVE_METRICS_AVAILABLE:
+            set_gauge(name, value)
+            return
+        with self._lock:
+            self._gauges[name] = value
+
+    @contextmanager
+    def time_block(self, name: str):
+        """Record the duration of the with-block as a latency"""
+        start = time.perf_counter()
+        try:
+            yield
+        finally:
+            self.record_latency(name, (time.perf_counter() - start) * 1000)
+
+    def snapshot(self) -> List[Dict[str, Any]]:
+        """Every counter, gauge and latency histogram, sorted by name"""
+        samples = []
+        if NATIVE_METRICS_AVAILABLE:
+            for sample in metrics_snapshot():
+                entry = {"name": sample.name, "kind": sample.kind, "value": sample.value}
+                if sample.kind == "histogram":
+                    latency = sample.latency
+                    entry.update(
+                        count=latency.count,
+                        sum_ms=latency.sum_ms,
+                        min_ms=latency.min_ms,
+                        max_ms=latency.max_ms,
+                        p50_ms=latency.p50_ms,
+                        p99_ms=latency.p99_ms,
+                        p999_ms=latency.p999_ms,
+                    )
+                samples.append(entry)
+            return samples
+
+        with self._lock:
+            for name, value in self._counters.items():
+                samples.append({"name": name, "kind": "counter", "value": value})
+            for name, value in self._gauges.items():
+                samples.append({"name": name, "kind": "gauge", "value": value})
+            for name, histogram in self._histograms.items():
+                stats = histogram.snapshot()
+                samples.append({"name": name, "kind": "histogram", "value": stats["count"], **stats})
+        return sorted(samples, key=lambda entry: entry["name"])
         
     def get_recommendations(self) -> list:
         """Get performance optimization recommendations"""
@@ -221,10 +378,88 @@ def memory_profile(func: Callable) -> Callable:
     return wrapper
 
 
+class MetricsExporter:
+    """
+    Periodically writes the monitor's snapshot to the analytics store so
+    other processes (such as /status metrics) can read it.
+
+    Only the latest value of each (metric, stat) is kept, in the
+    metric_snapshots table, so exporting costs one upsert per stat and the
+    table stays as small as the registry.
+    """
+
+    HISTOGRAM_STATS = ("count", "p50_ms", "p99_ms", "p999_ms", "max_ms")
+
+    def __init__(self, monitor: PerformanceMonitor, db=None, interval: float = 60.0):
+        self.monitor = monitor
+        self.db = db
+        self.interval = interval
+        self._stop = threading.Event()
+        self._thread: Optional[threading.Thread] = None
+
+    def export(self) -> int:
+        """Write one snapshot; returns the number of values written"""
+        if self.db is None:
+            from isaac.analytics.database import AnalyticsDatabase
+
+            self.db = AnalyticsDatabase()
+
+        rows = []
+        for sample in self.monitor.snapshot():
+            if sample["kind"] == "histogram":
+                stats = {stat: sample[stat] for stat in self.HISTOGRAM_STATS}
+            else:
+                stats = {"value": sample["value"]}
+            for stat, value in stats.items():
+                rows.append((sample["name"], stat, sample["kind"], float(value)))
+        if rows:
+            self.db.record_metric_snapshot(rows)
+        return len(rows)
+
+    def start(self):
+        if self._thread is not None:
+            return
+        self._thread = threading.Thread(target=self._run, name="metrics-export", daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join()
+            self._thread = None
+
+    def _run(self):
+        while not self._stop.wait(self.interval):
+            try:
+                self.export()
+            except Exception as e:
+                logger.debug(f"Metrics export failed: {e}")
+
+
+def read_exported_metrics(db=None, max_age_hours: float = 24) -> Dict[str, Dict[str, Any]]:
+    """
+    Latest exported value of every stat, by metric name:
+    {name: {"kind": ..., "timestamp": ..., stat: value, ...}}
+    """
+    if db is None:
+        from isaac.analytics.database import AnalyticsDatabase
+
+        db = AnalyticsDatabase()
+
+    since = (datetime.now() - timedelta(hours=max_age_hours)).isoformat()
+    metrics: Dict[str, Dict[str, Any]] = {}
+    for row in db.query_metric_snapshot(start_date=since):
+        entry = metrics.setdefault(row["metric_name"], {"kind": row["kind"], "timestamp": row["timestamp"]})
+        entry["timestamp"] = max(entry["timestamp"], row["timestamp"])
+        entry[row["stat"]] = row["value"]
+    return metrics
+
+
 # Global instances
 lazy_import_manager = LazyImportManager()
 memory_optimizer = MemoryOptimizer()
 performance_monitor = PerformanceMonitor()
+_metrics_exporter: Optional[MetricsExporter] = None
 
 
 # Convenience functions
@@ -238,11 +473,36 @@ def optimize_memory():
     return memory_optimizer.optimize_memory()
 
 
+def start_metrics_export(db=None, interval: float = 60.0) -> MetricsExporter:
+    """
+    Start exporting performance_monitor to the analytics store (once per
+    process). Meant for long-lived processes such as the interactive shell;
+    one-shot commands would only overwrite its numbers with their own.
+    """
+    global _metrics_exporter
+    if _metrics_exporter is None:
+        # Imported now so the store's own exit flush runs after our final export
+        import isaac.analytics.database  # noqa: F401
+
+        _metrics_exporter = MetricsExporter(performance_monitor, db, interval)
+        _metrics_exporter.start()
+        atexit.register(_export_at_exit)
+    return _metrics_exporter
+
+
+def _export_at_exit():
+    try:
+        _metrics_exporter.export()
+    except Exception as e:
+        logger.debug(f"Metrics export failed: {e}")
+
+
 def get_performance_stats():
     """Get comprehensive performance statistics"""
     return {
         'memory_usage': memory_optimizer.get_memory_usage(),
         'import_stats': lazy_import_manager.get_import_stats(),
         'metrics': performance_monitor.metrics,
+        'latency': performance_monitor.snapshot(),
         'recommendations': performance_monitor.get_recommendations()
-    }
\ No newline at end of file
+    }
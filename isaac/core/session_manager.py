@@ -223,7 +223,10 @@ class SessionManager:
         # Cloud sync (async-style error handling)
         if self.cloud:
             try:
-                self.cloud.save_session_file("command_history.json", self.command_history.to_dict())
+                if self.cloud.save_session_file("command_history.json", self.command_history.to_dict()):
+                    # Cloud is reachable again; let queued commands flush now
+                    if hasattr(self, "sync_worker"):
+                        self.sync_worker.notify_online()
             except Exception:
                 pass  # Don't block command execution if cloud fails
 
@@ -6,7 +6,9 @@ Manages background task execution with notification support.
 Tasks run asynchronously and notify via message queue on completion.
 """
 
+import atexit
 import json
+import os
 import shlex
 import sqlite3
 import subprocess
@@ -19,6 +21,17 @@ from enum import Enum
 from pathlib import Path
 from typing import Any, Callable, Dict, List, Optional
 
+# Optional native task engine and journal (C++ core, POSIX only)
+try:
+    from isaac.isaac_core import TaskEngine, TaskJournal, TaskRecord
+
+    NATIVE_TASKS_AVAILABLE = os.name == "posix"
+except ImportError:
+    TaskEngine = TaskJournal = TaskRecord = None
+    NATIVE_TASKS_AVAILABLE = False
+
+TASK_PRIORITIES = ("urgent", "high", "normal", "low")
+
 
 class TaskStatus(Enum):
     """Task execution status"""
@@ -101,6 +114,16 @@ class Task:
         return task
 
 
+def _timestamp(value: Optional[str]) -> float:
+    """ISO string from the tasks table -> unix seconds (0.0 = unset)"""
+    return datetime.fromisoformat(value).timestamp() if value else 0.0
+
+
+def _isoformat(seconds: float) -> Optional[str]:
+    """Unix seconds from the journal -> ISO string for Task.from_dict"""
+    return datetime.fromtimestamp(seconds).isoformat() if seconds else None
+
+
 class TaskManager:
     """
     Manages background task execution
@@ -110,19 +133,31 @@ class TaskManager:
     - Capture task output
     - Send notifications on completion
     - Task status queries
+
+    With the native TaskEngine, tasks beyond max_concurrent_tasks wait in
+    per-priority admission queues instead of failing, and cancellation
+    signals the task's whole process group. Task state then goes to a
+    group-committed TaskJournal next to db_path instead of SQLite.
     """
 
-    def __init__(self, max_concurrent_tasks: int = 10, db_path: Optional[Path] = None):
+    def __init__(
+        self,
+        max_concurrent_tasks: int = 10,
+        db_path: Optional[Path] = None,
+        use_native: bool = True,
+    ):
         """
         Initialize task manager
 
         Args:
             max_concurrent_tasks: Maximum number of concurrent background tasks
             db_path: Path to SQLite database for persistent storage
+            use_native: Run tasks on the native engine when available
         """
         self.max_concurrent_tasks = max_concurrent_tasks
         self.tasks: Dict[str, Task] = {}
         self.lock = threading.Lock()
+        self._callbacks: Dict[str, Callable[[Task], None]] = {}
 
         # Callback for task completion notifications
         self.on_task_complete: Optional[Callable[[Task], None]] = None
@@ -132,8 +167,31 @@ class TaskManager:
             db_path = Path.home() / ".isaac" / "tasks.db"
         self.db_path = db_path
         self.db_path.parent.mkdir(parents=True, exist_ok=True)
-        self._init_db()
-        self._load_tasks_from_db()
+
+        self._engine = None
+        self._journal = None
+        if use_native and NATIVE_TASKS_AVAILABLE:
+            self._journal = TaskJournal(str(db_path.with_name(f"{db_path.stem}_journal")))
+            if self.db_path.exists():
+                self._migrate_sqlite()
+            self._engine = TaskEngine(max_running=max_concurrent_tasks, journal=self._journal)
+            self._load_tasks_from_journal()
+        else:
+            self._init_db()
+            self._load_tasks_from_db()
+
+        self._stop = threading.Event()
+        self._collector: Optional[threading.Thread] = None
+        if self._engine is not None:
+            self._collector = threading.Thread(target=self._collect_loop, daemon=True)
+            self._collector.start()
+
+    def shutdown(self, timeout: float = 5.0):
+        """Stop the native result collector; tasks keep their journaled state"""
+        self._stop.set()
+        if self._collector is not None:
+            self._collector.join(timeout=timeout)
+            self._collector = None
 
     def _init_db(self):
         """Initialize task database schema"""
@@ -206,8 +264,8 @@ class TaskManager:
 
             task = Task.from_dict(task_data)
 
-            # Don't restart running tasks - mark them as failed
-            if task.status == TaskStatus.RUNNING:
+            # Don't restart queued or running tasks - mark them as failed
+            if task.status in (TaskStatus.PENDING, TaskStatus.RUNNING):
                 task.status = TaskStatus.FAILED
                 task.stderr = "Task was interrupted (ISAAC restart)"
                 task.end_time = datetime.now()
@@ -217,8 +275,82 @@ class TaskManager:
 
         conn.close()
 
+    def _migrate_sqlite(self):
+        """Copy tasks from an existing SQLite database into the journal, once"""
+        conn = sqlite3.connect(str(self.db_path))
+        conn.row_factory = sqlite3.Row
+        try:
+            rows = conn.execute("SELECT * FROM tasks ORDER BY created_at").fetchall()
+        except sqlite3.DatabaseError:
+            rows = []
+        conn.close()
+
+        for row in rows:
+            record = TaskRecord()
+            record.id = row["task_id"]
+            record.command = row["command"]
+            record.task_type = row["task_type"]
+            record.priority = row["priority"]
+            record.status = row["status"]
+            record.created_at = datetime.fromisoformat(row["created_at"]).timestamp()
+            record.start_time = _timestamp(row["start_time"])
+            record.end_time = _timestamp(row["end_time"])
+            record.exit_code = row["exit_code"]
+            record.stdout = row["stdout"] or ""
+            record.stderr = row["stderr"] or ""
+            record.metadata = row["metadata"] or "{}"
+            self._journal.record(record)
+        self._journal.flush()
+        self.db_path.rename(self.db_path.with_name(self.db_path.name + ".migrated"))
+
+    def _load_tasks_from_journal(self):
+        """Load recent tasks from the journal, dropping finished ones older than a day"""
+        cutoff = time.time() - 86400
+        for record in self._journal.records():
+            finished = record.status in ("completed", "failed", "cancelled")
+            if finished and record.created_at < cutoff:
+                self._journal.remove(record.id)
+                continue
+
+            task = Task.from_dict(
+                {
+                    "task_id": record.id,
+                    "command": record.command,
+                    "task_type": record.task_type,
+                    "priority": record.priority,
+                    "status": record.status,
+                    "start_time": _isoformat(record.start_time),
+                    "end_time": _isoformat(record.end_time),
+                    "exit_code": record.exit_code,
+                    "stdout": record.stdout,
+                    "stderr": record.stderr,
+                    "metadata": json.loads(record.metadata) if record.metadata else {},
+                }
+            )
+
+            # Don't restart queued or running tasks - mark them as failed
+            if task.status in (TaskStatus.PENDING, TaskStatus.RUNNING):
+                task.status = TaskStatus.FAILED
+                task.stderr = "Task was interrupted (ISAAC restart)"
+                task.end_time = datetime.now()
+                self._update_task_in_db(task)
+
+            self.tasks[task.task_id] = task
+
     def _save_task_to_db(self, task: Task):
         """Save task to database"""
+        if self._journal is not None:
+            record = TaskRecord()
+            record.id = task.task_id
+            record.command = task.command
+            record.task_type = task.task_type
+            record.priority = task.priority
+            record.status = task.status.value
+            record.created_at = (task.start_time or datetime.now()).timestamp()
+            record.metadata = json.dumps(task.metadata)
+            self._journal.record(record)
+            return
+
         conn = sqlite3.connect(str(self.db_path))
 
         conn.execute(
@@ -249,6 +381,19 @@ class TaskManager:
 
     def _update_task_in_db(self, task: Task):
         """Update task in database"""
+        if self._journal is not None:
+            # Queued for the journal writer; no disk I/O on this thread
+            self._journal.transition(
+                task.task_id,
+                task.status.value,
+                task.start_time.timestamp() if task.start_time else 0.0,
+                task.end_time.timestamp() if task.end_time else 0.0,
+                task.exit_code,
+                task.stdout,
+                task.stderr,
+            )
+            return
+
         conn = sqlite3.connect(str(self.db_path))
 
         conn.execute(
@@ -305,6 +450,9 @@ class TaskManager:
             metadata=metadata,
         )
 
+        if self._engine is not None:
+            return self._spawn_native(task, callback)
+
         # Check concurrent task limit
         with self.lock:
             running_count = sum(1 for t in self.tasks.values() if t.status == TaskStatus.RUNNING)
@@ -375,8 +523,69 @@ class TaskManager:
 
         # Persist final state
         self._update_task_in_db(task)
+        self._run_callbacks(task, callback)
 
-        # Trigger callbacks
+    def _spawn_native(self, task: Task, callback: Optional[Callable[[Task], None]]) -> str:
+        """Queue task on the native engine; it starts once a slot of its priority is free"""
+        with self.lock:
+            self.tasks[task.task_id] = task
+            self._save_task_to_db(task)
+            if callback:
+                self._callbacks[task.task_id] = callback
+
+        priority = task.priority if task.priority in TASK_PRIORITIES else "normal"
+        try:
+            self._engine.submit(task.task_id, shlex.split(task.command), priority)
+        except ValueError as e:
+            task.status = TaskStatus.FAILED
+            task.stderr = f"Task execution error: {str(e)}"
+            task.exit_code = -1
+            task.end_time = datetime.now()
+            self._update_task_in_db(task)
+            with self.lock:
+                callback = self._callbacks.pop(task.task_id, None)
+            self._run_callbacks(task, callback)
+
+        return task.task_id
+
+    def _collect_loop(self):
+        """Apply native results, persist them and run completion callbacks"""
+        while not self._stop.is_set():
+            for info in self._engine.wait_finished(1000):
+                with self.lock:
+                    task = self.tasks.get(info.id)
+                    callback = self._callbacks.pop(info.id, None)
+                self._engine.forget(info.id)
+                if task is None:
+                    continue
+
+                # The engine already journaled the final state
+                self._apply_native(task, info)
+                self._run_callbacks(task, callback)
+
+    @staticmethod
+    def _apply_native(task: Task, info):
+        """Copy native engine state onto a Task"""
+        if task.status != TaskStatus.CANCELLED:
+            task.status = TaskStatus(info.status)
+        task.start_time = datetime.fromtimestamp(info.start_time) if info.start_time else None
+        if info.end_time:
+            task.end_time = datetime.fromtimestamp(info.end_time)
+            task.exit_code = info.exit_code
+            task.stdout = info.stdout
+            task.stderr = info.stderr
+
+    def _refresh(self, task: Task):
+        """Pick up pending -> running transitions from the native engine"""
+        if self._engine is None or task.status not in (TaskStatus.PENDING, TaskStatus.RUNNING):
+            return
+        info = self._engine.get(task.task_id)
+        if info is not None and info.status in ("pending", "running"):
+            task.status = TaskStatus(info.status)
+            task.start_time = datetime.fromtimestamp(info.start_time) if info.start_time else None
+
+    def _run_callbacks(self, task: Task, callback: Optional[Callable[[Task], None]] = None):
+        """Run the per-task callback and the global completion handler"""
         if callback:
             try:
                 callback(task)
@@ -392,7 +601,10 @@ class TaskManager:
     def get_task(self, task_id: str) -> Optional[Task]:
         """Get task by ID"""
         with self.lock:
-            return self.tasks.get(task_id)
+            task = self.tasks.get(task_id)
+        if task:
+            self._refresh(task)
+        return task
 
     def get_all_tasks(
         self, status: Optional[TaskStatus] = None, task_type: Optional[str] = None
@@ -409,6 +621,8 @@ class TaskManager:
         """
         with self.lock:
             tasks = list(self.tasks.values())
+        for task in tasks:
+            self._refresh(task)
 
         if status:
             tasks = [t for t in tasks if t.status == status]
@@ -436,6 +650,15 @@ class TaskManager:
         if not task:
             return False
 
+        if self._engine is not None:
+            # Queued tasks are dropped; running ones get SIGTERM, then SIGKILL, on their process group
+            if not self._engine.cancel(task_id):
+                return False
+            task.status = TaskStatus.CANCELLED
+            task.end_time = datetime.now()
+            self._update_task_in_db(task)
+            return True
+
         if task.status != TaskStatus.RUNNING:
             return False
 
@@ -470,7 +693,10 @@ class TaskManager:
             ]
 
             # Remove from database
-            if to_remove:
+            if to_remove and self._journal is not None:
+                for tid in to_remove:
+                    self._journal.remove(tid)
+            elif to_remove:
                 conn = sqlite3.connect(str(self.db_path))
                 placeholders = ",".join("?" * len(to_remove))
                 conn.execute(f"DELETE FROM tasks WHERE task_id IN ({placeholders})", to_remove)
@@ -485,6 +711,11 @@ class TaskManager:
 
     def get_statistics(self) -> Dict[str, Any]:
         """Get task execution statistics"""
+        with self.lock:
+            tasks = list(self.tasks.values())
+        for task in tasks:
+            self._refresh(task)
+
         with self.lock:
             total = len(self.tasks)
             by_status = {}
@@ -499,13 +730,23 @@ class TaskManager:
                 task_type = task.task_type
                 by_type[task_type] = by_type.get(task_type, 0) + 1
 
-            return {
+            stats = {
                 "total_tasks": total,
                 "by_status": by_status,
                 "by_type": by_type,
                 "max_concurrent": self.max_concurrent_tasks,
             }
 
+        if self._engine is not None:
+            engine = self._engine.stats()
+            stats["engine"] = {
+                "queued": engine.queued,
+                "running": engine.running,
+                "workers": engine.workers,
+                "steals": engine.steals,
+            }
+        return stats
+
 
 # Global task manager instance
 _task_manager: Optional[TaskManager] = None
@@ -521,6 +762,16 @@ def get_task_manager() -> TaskManager:
     return _task_manager
 
 
+@atexit.register
+def shutdown_task_manager():
+    """Stop the global task manager's collector thread (runs at exit)"""
+    global _task_manager
+
+    if _task_manager is not None:
+        _task_manager.shutdown()
+        _task_manager = None
+
+
 def integrate_with_message_queue():
     """
     Integrate task manager with message queue for notifications
@@ -209,6 +209,21 @@ class DebugCommand:
 
         return result
 
+    def _get_command_tier(self, command: str):
+        """Safety tier of a command, or None when the validator is unavailable.
+
+        The validator classifies the first word only, so anything /bin/sh
+        would treat as a second command or a redirection counts as tier 3.
+        """
+        if any(c in command for c in ";&|<>`$\n"):
+            return 3
+        try:
+            from isaac.core.tier_validator import TierValidator
+            from isaac.models.preferences import Preferences
+        except ImportError:
+            return None
+        return TierValidator(Preferences(machine_id="debug-profiler")).get_tier(command)
+
     def execute_performance_analysis(self, command: str, iterations: int = 3) -> Dict[str, Any]:
         """Execute detailed performance analysis.
 
@@ -228,20 +243,24 @@ class DebugCommand:
             "optimization_suggestions": [],
         }
 
+        # Profiling really runs the command, repeatedly, so only safe tiers
+        tier = self._get_command_tier(command)
+        if tier is None or tier > 2:
+            result["error"] = (
+                f"Command not profiled: tier {tier} commands must be run through the shell"
+                if tier is not None
+                else "Command not profiled: could not load tier validator"
+            )
+            return result
+
         try:
             profiles = []
 
             for i in range(iterations):
                 print(f"📊 Running performance iteration {i + 1}/{iterations}...")
 
-                # Start profiling
-                self.performance_profiler.start_profiling(command)
-
-                # Execute command (simulated)
-                time.sleep(0.5)  # Simulate command execution
-
-                # Stop profiling
-                profile = self.performance_profiler.stop_profiling()
+                # Run the command under its own counters
+                profile = self.performance_profiler.profile_command(command)
                 if profile:
                     profiles.append(profile)
 
@@ -3,14 +3,107 @@ Performance Profiling - Identify bottlenecks and optimization opportunities
 Isaac's intelligent performance analysis and optimization system
 """
 
+import os
+import signal
+import subprocess
 import threading
 import time
 from collections import defaultdict
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from typing import Any, Dict, List, Optional
 
 import psutil
 
+from isaac.monitoring.system_sampler import get_system_sampler, sample_metrics
+
+try:
+    from isaac.isaac_core import ShellAdapter as NativeShellAdapter
+
+    NATIVE_COUNTERS_AVAILABLE = True
+except ImportError:
+    NativeShellAdapter = None
+    NATIVE_COUNTERS_AVAILABLE = False
+
+_RUSAGE_FIELDS = (
+    "wall_seconds",
+    "user_seconds",
+    "system_seconds",
+    "max_rss_bytes",
+    "major_faults",
+    "voluntary_switches",
+    "involuntary_switches",
+)
+_PERF_FIELDS = ("task_clock_ns", "context_switches", "cpu_migrations", "page_faults")
+_HARDWARE_FIELDS = ("cycles", "instructions")
+
+
+def run_counted(command: str, timeout: int = 30) -> Dict[str, Any]:
+    """Run a shell command and return exact counts of what it used.
+
+    With isaac_core, ShellAdapter.execute_profiled attaches perf_event_open
+    counters to the child (_PERF_FIELDS, plus _HARDWARE_FIELDS where the
+    PMU is available); otherwise, or when perf is not permitted, only the
+    wait4 figures in _RUSAGE_FIELDS are filled. Empty on platforms
+    without wait4.
+    """
+    if NATIVE_COUNTERS_AVAILABLE:
+        result = NativeShellAdapter().execute_profiled(command, timeout)
+        native = result.counters
+        fields = _RUSAGE_FIELDS
+        if native.available:
+            fields += _PERF_FIELDS
+        if native.hardware:
+            fields += _HARDWARE_FIELDS
+        counters = {name: getattr(native, name) for name in fields}
+        counters.update(exit_code=result.exit_code, timed_out=native.timed_out)
+        return counters
+
+    if not hasattr(os, "wait4"):
+        return {}
+
+    start = time.perf_counter()
+    process = subprocess.Popen(
+        command, shell=True, stdout=subprocess.DEVNULL, start_new_session=True
+    )
+    timed_out = threading.Event()
+
+    def kill_group():
+        timed_out.set()
+        try:
+            os.killpg(process.pid, signal.SIGKILL)
+        except ProcessLookupError:
+            pass
+
+    timer = threading.Timer(timeout, kill_group)
+    timer.start()
+    try:
+        _, status, usage = os.wait4(process.pid, 0)
+    finally:
+        timer.cancel()
+    wall = time.perf_counter() - start
+
+    if timed_out.is_set():
+        exit_code = 124
+    elif os.WIFEXITED(status):
+        exit_code = os.WEXITSTATUS(status)
+    else:
+        exit_code = 128 + os.WTERMSIG(status)
+    process.returncode = exit_code  # reaped here, not by Popen
+
+    # ru_maxrss is KiB on Linux, bytes on macOS
+    rss_unit = 1 if os.uname().sysname == "Darwin" else 1024
+    return {
+        "wall_seconds": wall,
+        "user_seconds": usage.ru_utime,
+        "system_seconds": usage.ru_stime,
+        "max_rss_bytes": usage.ru_maxrss * rss_unit,
+        "major_faults": usage.ru_majflt,
+        "voluntary_switches": usage.ru_nvcsw,
+        "involuntary_switches": usage.ru_nivcsw,
+        "exit_code": exit_code,
+        "timed_out": timed_out.is_set(),
+    }
+
 
 @dataclass
 class PerformanceMetric:
@@ -38,6 +131,7 @@ class PerformanceProfile:
     system_load: Dict[str, float]
     bottlenecks: List[str]
     recommendations: List[str]
+    counters: Dict[str, Any] = field(default_factory=dict)  # run_counted(); empty if not run by the profiler
 
 
 @dataclass
@@ -81,10 +175,19 @@ class PerformanceProfiler:
             "command": command,
             "start_time": time.time(),
             "context": context or {},
-            "initial_metrics": self._capture_system_metrics(),
+            "initial_metrics": None,
             "samples": [],
         }
 
+        sampler = get_system_sampler()
+        if sampler is not None:
+            # Samples come from the native sampler's ring when profiling stops
+            initial = sampler.sample()
+            self.current_profile["start_sequence"] = initial.sequence
+            self.current_profile["initial_metrics"] = sample_metrics(initial)
+        else:
+            self.current_profile["initial_metrics"] = self._capture_system_metrics()
+
         self.monitoring_active = True
 
         # Start background monitoring
@@ -92,8 +195,24 @@ class PerformanceProfiler:
 
         return profile_id
 
-    def stop_profiling(self) -> Optional[PerformanceProfile]:
-        """Stop profiling and return the performance profile."""
+    def profile_command(
+        self, command: str, timeout: int = 30, context: Dict[str, Any] = None
+    ) -> PerformanceProfile:
+        """Run a command and profile it from its own counters.
+
+        CPU usage, memory usage and duration then describe the command
+        rather than the whole system, and the bottlenecks include what
+        only the counters show (context switches, page faults, IPC).
+        """
+        self.start_profiling(command, context)
+        return self.stop_profiling(run_counted(command, timeout))
+
+    def stop_profiling(self, counters: Optional[Dict[str, Any]] = None) -> Optional[PerformanceProfile]:
+        """Stop profiling and return the performance profile.
+
+        Args:
+            counters: Exact counts for the profiled command, as returned by run_counted()
+        """
         if not self.current_profile:
             return None
 
@@ -102,7 +221,16 @@ class PerformanceProfiler:
         end_time = time.time()
         final_metrics = self._capture_system_metrics()
 
-        profile = self._analyze_performance(self.current_profile, end_time, final_metrics)
+        sampler = get_system_sampler()
+        if sampler is not None and "start_sequence" in self.current_profile:
+            self.current_profile["samples"] = [
+                {"timestamp": sample.timestamp, "metrics": sample_metrics(sample)}
+                for sample in sampler.since(self.current_profile["start_sequence"])
+            ]
+
+        profile = self._analyze_performance(
+            self.current_profile, end_time, final_metrics, counters
+        )
 
         # Store in history
         self.performance_history[self.current_profile["command"]].append(profile)
@@ -112,7 +240,9 @@ class PerformanceProfiler:
         return profile
 
     def _start_background_monitoring(self):
-        """Start background monitoring thread."""
+        """Start background monitoring thread (psutil fallback only)."""
+        if get_system_sampler() is not None:
+            return
 
         def monitor():
             while self.monitoring_active:
@@ -128,6 +258,10 @@ class PerformanceProfiler:
 
     def _capture_system_metrics(self) -> Dict[str, Any]:
         """Capture current system performance metrics."""
+        sampler = get_system_sampler()
+        if sampler is not None:
+            return sample_metrics(sampler.sample())
+
         try:
             return {
                 "cpu_percent": psutil.cpu_percent(interval=None),
@@ -161,7 +295,11 @@ class PerformanceProfiler:
             return {"error": str(e)}
 
     def _analyze_performance(
-        self, profile_data: Dict[str, Any], end_time: float, final_metrics: Dict[str, Any]
+        self,
+        profile_data: Dict[str, Any],
+        end_time: float,
+        final_metrics: Dict[str, Any],
+        counters: Optional[Dict[str, Any]] = None,
     ) -> PerformanceProfile:
         """Analyze collected performance data."""
         start_time = profile_data["start_time"]
@@ -177,9 +315,18 @@ class PerformanceProfiler:
         network_io = self._calculate_network_io(initial_metrics, final_metrics)
         system_load = self._calculate_system_load(samples)
 
+        # The command's own figures replace the system-wide ones
+        counters = counters or {}
+        if counters:
+            duration = counters["wall_seconds"]
+            cpu_usage = 100.0 * self._cpu_seconds(counters) / duration if duration > 0 else 0.0
+            memory_total = initial_metrics.get("memory", {}).get("total", 0)
+            if memory_total:
+                memory_usage = 100.0 * counters["max_rss_bytes"] / memory_total
+
         # Identify bottlenecks
         bottlenecks = self._identify_bottlenecks(
-            cpu_usage, memory_usage, disk_io, network_io, system_load, duration
+            cpu_usage, memory_usage, disk_io, network_io, system_load, duration, counters
         )
 
         # Generate recommendations
@@ -199,8 +346,16 @@ class PerformanceProfiler:
             system_load=system_load,
             bottlenecks=bottlenecks,
             recommendations=recommendations,
+            counters=counters,
         )
 
+    @staticmethod
+    def _cpu_seconds(counters: Dict[str, Any]) -> float:
+        """CPU time of a counted command on all CPUs"""
+        if "task_clock_ns" in counters:
+            return counters["task_clock_ns"] / 1e9
+        return counters["user_seconds"] + counters["system_seconds"]
+
     def _calculate_average_cpu(self, samples: List[Dict], initial_metrics: Dict) -> float:
         """Calculate average CPU usage during profiling."""
         if not samples:
@@ -258,8 +413,14 @@ class PerformanceProfiler:
         network_io: Dict[str, int],
         system_load: Dict[str, float],
         duration: float,
+        counters: Optional[Dict[str, Any]] = None,
     ) -> List[str]:
-        """Identify performance bottlenecks."""
+        """Identify performance bottlenecks.
+
+        With counters, cpu_usage is the command's CPU time against its wall
+        time (100% = one CPU busy throughout) and memory_usage its peak RSS
+        against total memory.
+        """
         bottlenecks = []
 
         # CPU bottlenecks
@@ -292,6 +453,41 @@ class PerformanceProfiler:
         if duration > 30:  # Commands taking longer than 30 seconds
             bottlenecks.append("Long execution time (>30s)")
 
+        if counters:
+            bottlenecks.extend(self._counter_bottlenecks(counters))
+
+        return bottlenecks
+
+    def _counter_bottlenecks(self, counters: Dict[str, Any]) -> List[str]:
+        """Bottlenecks only a counted command's figures show"""
+        bottlenecks = []
+        wall = counters["wall_seconds"]
+        cpu_seconds = self._cpu_seconds(counters)
+
+        if counters.get("timed_out"):
+            bottlenecks.append(f"Timed out after {wall:.0f}s")
+
+        # Rates need a run long enough to mean something
+        if wall >= 0.5:
+            if cpu_seconds < 0.2 * wall:
+                bottlenecks.append("Waiting on I/O or locks (CPU busy <20% of wall time)")
+            switches = counters.get(
+                "context_switches",
+                counters["voluntary_switches"] + counters["involuntary_switches"],
+            )
+            if switches / wall > 5000:
+                bottlenecks.append("Frequent context switches (>5000/s)")
+
+        if counters["major_faults"] > 100:
+            bottlenecks.append("Major page faults (memory read back from disk)")
+        if counters.get("page_faults", 0) > 10000 and cpu_seconds > 0:
+            if counters["page_faults"] / cpu_seconds > 50000:
+                bottlenecks.append("Heavy page faulting (>50k faults per CPU second)")
+
+        cycles = counters.get("cycles", 0)
+        if cycles > 100_000_000 and counters["instructions"] / cycles < 0.7:
+            bottlenecks.append("Low instructions per cycle (<0.7, stalled on memory or branches)")
+
         return bottlenecks
 
     def _generate_recommendations(
@@ -349,6 +545,41 @@ class PerformanceProfiler:
                     ]
                 )
 
+            if "Waiting on I/O" in bottleneck:
+                recommendations.extend(
+                    [
+                        "Check what the command blocks on (strace -c, iostat)",
+                        "Batch small reads and writes",
+                    ]
+                )
+
+            if "context switches" in bottleneck:
+                recommendations.extend(
+                    [
+                        "Reduce thread or process count to the number of CPUs",
+                        "Use larger buffers between pipeline stages",
+                    ]
+                )
+
+            if "page fault" in bottleneck:
+                recommendations.extend(
+                    [
+                        "Reuse buffers instead of allocating fresh memory",
+                        "Reduce the working set or add memory if pages come back from disk",
+                    ]
+                )
+
+            if "instructions per cycle" in bottleneck:
+                recommendations.extend(
+                    [
+                        "Improve data locality (sequential access, smaller structures)",
+                        "Profile cache misses with perf stat -e cache-misses",
+                    ]
+                )
+
+            if "Timed out" in bottleneck:
+                recommendations.append("Raise the timeout or run the command in the background")
+
             if "execution time" in bottleneck:
                 recommendations.extend(
                     [
@@ -529,7 +760,7 @@ Resource Usage:
 - Network Sent: {profile.network_io.get('bytes_sent', 0) / 1024 / 1024:.1f} MB
 - Network Received: {profile.network_io.get('bytes_recv', 0) / 1024 / 1024:.1f} MB
 
-System Load:
+{self._format_counters(profile.counters)}System Load:
 - 1 minute: {profile.system_load.get('1min', 0):.2f}
 - 5 minutes: {profile.system_load.get('5min', 0):.2f}
 - 15 minutes: {profile.system_load.get('15min', 0):.2f}
@@ -542,3 +773,25 @@ Recommendations:
 """
 
         return report.strip()
+
+    def _format_counters(self, counters: Dict[str, Any]) -> str:
+        """Report section for a counted command; empty without counters"""
+        if not counters:
+            return ""
+        lines = [
+            "Command Counters:",
+            f"- CPU Time: {self._cpu_seconds(counters):.3f} s",
+            f"- Peak RSS: {counters['max_rss_bytes'] / 1024 / 1024:.1f} MB",
+        ]
+        if "task_clock_ns" in counters:
+            lines.append(f"- Context Switches: {counters['context_switches']}")
+            lines.append(f"- CPU Migrations: {counters['cpu_migrations']}")
+            lines.append(f"- Page Faults: {counters['page_faults']} ({counters['major_faults']} major)")
+        else:
+            switches = counters["voluntary_switches"] + counters["involuntary_switches"]
+            lines.append(f"- Context Switches: {switches}")
+            lines.append(f"- Major Page Faults: {counters['major_faults']}")
+        if counters.get("cycles"):
+            ipc = counters["instructions"] / counters["cycles"]
+            lines.append(f"- Cycles: {counters['cycles']} ({ipc:.2f} instructions/cycle)")
+        return "\n".join(lines) + "\n\n"
@@ -5,12 +5,75 @@ This module provides structured logging to JSONL files organized by collection.
 Isaac uses this to track its learning, patterns, and evolution over time.
 """
 
+import atexit
 import json
 import threading
 from dataclasses import asdict, dataclass
-from datetime import datetime
+from datetime import datetime, timedelta
 from pathlib import Path
-from typing import Any, Dict, List, Optional
+from typing import Any, Dict, List, Optional, Sequence
+
+# Optional native event log (C++ core)
+try:
+    from isaac.isaac_core import EventLog
+
+    NATIVE_EVENT_LOG_AVAILABLE = True
+except ImportError:
+    EventLog = None
+    NATIVE_EVENT_LOG_AVAILABLE = False
+
+# One native log per directory: its writer owns the files
+_native_logs: Dict[str, Any] = {}
+_native_logs_lock = threading.Lock()
+
+
+def _open_native_log(base_dir: Path):
+    """Open (or reuse) the native event log for a directory, importing JSONL files once."""
+    key = str(base_dir.resolve())
+    with _native_logs_lock:
+        log = _native_logs.get(key)
+        if log is None:
+            try:
+                log = EventLog(key)
+            except (RuntimeError, ValueError):
+                return None
+            _migrate_jsonl(log, base_dir)
+            _native_logs[key] = log
+        return log
+
+
+def _migrate_jsonl(log, base_dir: Path) -> None:
+    """Copy events from monthly JSONL files into the native log, then set the files aside."""
+    for log_file in sorted(base_dir.glob("*/*.jsonl")):
+        collection = log_file.parent.name
+        try:
+            with open(log_file, "r") as f:
+                for line in f:
+                    try:
+                        event = json.loads(line)
+                        log.log(
+                            collection,
+                            event["event_type"],
+                            json.dumps(event.get("data") or {}, default=str),
+                            json.dumps(event.get("metadata") or {}, default=str),
+                            datetime.fromisoformat(event["timestamp"]).timestamp(),
+                        )
+                    except (ValueError, KeyError, TypeError):
+                        continue  # malformed line
+            log.flush()
+            log_file.rename(log_file.with_name(log_file.name + ".migrated"))
+        except OSError as e:
+            print(f"[StructuredLogger] Failed to import {log_file}: {e}")
+
+
+@atexit.register
+def _flush_native_logs() -> None:
+    """Write out events still buffered in native logs at interpreter exit."""
+    for log in list(_native_logs.values()):
+        try:
+            log.flush()
+        except Exception:
+            pass
 
 
 @dataclass
@@ -35,6 +98,13 @@ class StructuredLogger:
     Logs are organized by collection and stored in monthly files:
     ~/.isaac/logs/[collection-name]/YYYY-MM.jsonl
 
+    When the C++ core is built, events go to a native EventLog instead:
+    log_event only encodes the event into a per-thread buffer, and a
+    background writer appends batches to binary YYYY-MM.evlog files
+    (export_jsonl turns a collection back into JSON Lines). Queries then
+    return the newest events first, and summarize_collection counts and
+    averages fields from indexed blocks without building LogEvent objects.
+
     Example usage:
         logger = StructuredLogger()
         logger.log_pattern_learned(
@@ -44,16 +114,21 @@ class StructuredLogger:
         )
     """
 
-    def __init__(self, base_dir: Optional[Path] = None):
+    def __init__(self, base_dir: Optional[Path] = None, use_native: bool = True):
         """
         Initialize structured logger.
 
         Args:
             base_dir: Base directory for logs (defaults to ~/.isaac/logs)
+            use_native: Use the native event log when the C++ core is available
         """
         self.base_dir = base_dir or (Path.home() / ".isaac" / "logs")
         self.base_dir.mkdir(parents=True, exist_ok=True)
 
+        self._native = None
+        if use_native and NATIVE_EVENT_LOG_AVAILABLE:
+            self._native = _open_native_log(self.base_dir)
+
         # Thread safety for concurrent logging
         self._lock = threading.Lock()
 
@@ -92,6 +167,18 @@ class StructuredLogger:
             data: Event-specific data
             metadata: Optional metadata
         """
+        if self._native is not None:
+            try:
+                self._native.log(
+                    collection,
+                    event_type,
+                    json.dumps(data, default=str),
+                    json.dumps(metadata or {}, default=str),
+                )
+            except Exception as e:
+                print(f"[StructuredLogger] Failed to log event: {e}")
+            return
+
         event = LogEvent(
             timestamp=datetime.now().isoformat(),
             event_type=event_type,
@@ -110,6 +197,35 @@ class StructuredLogger:
             # Fallback to print if logging fails (avoid infinite loops)
             print(f"[StructuredLogger] Failed to log event: {e}")
 
+    def flush(self) -> None:
+        """Block until buffered events are on disk (a no-op for JSONL files)."""
+        if self._native is not None:
+            self._native.flush()
+
+    def export_jsonl(self, collection: str, path: Path) -> int:
+        """
+        Write a collection as JSON Lines, oldest first.
+
+        Args:
+            collection: Collection name
+            path: Output file
+
+        Returns:
+            Number of events written
+        """
+        if self._native is not None:
+            return self._native.export_jsonl(collection, str(path))
+
+        count = 0
+        with open(path, "w") as out:
+            for log_file in sorted((self.base_dir / collection).glob("*.jsonl")):
+                with open(log_file, "r") as f:
+                    for line in f:
+                        if line.strip():
+                            out.write(line if line.endswith("\n") else line + "\n")
+                            count += 1
+        return count
+
     # ===== Learning & Pattern Events =====
 
     def log_pattern_learned(
@@ -330,6 +446,23 @@ class StructuredLogger:
         Returns:
             List of LogEvent objects
         """
+        if self._native is not None:
+            return [
+                LogEvent(
+                    timestamp=datetime.fromtimestamp(record.timestamp).isoformat(),
+                    event_type=record.event_type,
+                    collection=collection,
+                    data=json.loads(record.data) if record.data else {},
+                    metadata=json.loads(record.metadata) if record.metadata else {},
+                )
+                for record in self._native.query(
+                    collection,
+                    event_type or "",
+                    since.timestamp() if since else float("-inf"),
+                    limit or 0,
+                )
+            ]
+
         events = []
         collection_dir = self.base_dir / collection
 
@@ -398,6 +531,66 @@ class StructuredLogger:
             limit=limit
         )
 
+    def summarize_collection(
+        self,
+        collection: str,
+        event_type: Optional[str] = None,
+        group_by: Sequence[str] = (),
+        values: Sequence[str] = (),
+        since: Optional[datetime] = None
+    ) -> Dict[str, Any]:
+        """
+        Count events and summarize fields of a collection.
+
+        Fields are dotted paths such as 'event_type' or 'data.confidence'.
+        Group counts skip empty values and count lists and dicts under their
+        JSON text; value stats cover numeric values.
+
+        Args:
+            collection: Collection name
+            event_type: Filter by event type
+            group_by: Fields to count events by
+            values: Numeric fields to summarize
+            since: Only include events after this timestamp
+
+        Returns:
+            {"events": n, "groups": {field: {value: count}},
+             "values": {field: {"count", "sum", "min", "max", "avg"}}}
+        """
+        if self._native is not None:
+            kwargs = {"since": since.timestamp()} if since else {}
+            result = self._native.aggregate(
+                collection, event_type or "", list(group_by), list(values), **kwargs
+            )
+            return {
+                "events": result.events,
+                "groups": dict(zip(group_by, result.groups)),
+                "values": {
+                    field: self._value_summary(stats.count, stats.sum, stats.min, stats.max)
+                    for field, stats in zip(values, result.values)
+                },
+            }
+
+        events = self.query_collection(collection, event_type=event_type, since=since)
+        summary_values = {}
+        for field in values:
+            numbers = [
+                float(value)
+                for value in (self._get_nested_field(event, field) for event in events)
+                if isinstance(value, (int, float))
+            ]
+            summary_values[field] = self._value_summary(
+                len(numbers),
+                sum(numbers),
+                min(numbers, default=None),
+                max(numbers, default=None),
+            )
+        return {
+            "events": len(events),
+            "groups": {field: self._count_by_field(events, field) for field in group_by},
+            "values": summary_values,
+        }
+
     def get_learning_summary(self, days: int = 7) -> Dict[str, Any]:
         """
         Get a summary of learning activity.
@@ -408,22 +601,25 @@ class StructuredLogger:
         Returns:
             Dictionary with learning statistics
         """
-        since = datetime.now().replace(hour=0, minute=0, second=0, microsecond=0)
-        since = since.replace(day=since.day - days)
+        since = datetime.now().replace(hour=0, minute=0, second=0, microsecond=0) - timedelta(days=days)
 
-        patterns = self.query_collection(
+        patterns = self.summarize_collection(
             collection="log-learning",
             event_type="pattern_learned",
+            group_by=["data.pattern_type"],
+            values=["data.confidence"],
             since=since
         )
 
-        suggestions = self.query_collection(
+        suggestions = self.summarize_collection(
             collection="log-suggestions",
             event_type="suggestion_generated",
+            group_by=["data.suggestion_type"],
+            values=["data.confidence"],
             since=since
         )
 
-        mistakes = self.query_collection(
+        mistakes = self.summarize_collection(
             collection="log-learning",
             event_type="mistake_recorded",
             since=since
@@ -431,13 +627,13 @@ class StructuredLogger:
 
         return {
             "period_days": days,
-            "patterns_learned": len(patterns),
-            "suggestions_generated": len(suggestions),
-            "mistakes_recorded": len(mistakes),
-            "pattern_types": self._count_by_field(patterns, "data.pattern_type"),
-            "suggestion_types": self._count_by_field(suggestions, "data.suggestion_type"),
-            "avg_pattern_confidence": self._avg_field(patterns, "data.confidence"),
-            "avg_suggestion_confidence": self._avg_field(suggestions, "data.confidence"),
+            "patterns_learned": patterns["events"],
+            "suggestions_generated": suggestions["events"],
+            "mistakes_recorded": mistakes["events"],
+            "pattern_types": patterns["groups"]["data.pattern_type"],
+            "suggestion_types": suggestions["groups"]["data.suggestion_type"],
+            "avg_pattern_confidence": patterns["values"]["data.confidence"]["avg"],
+            "avg_suggestion_confidence": suggestions["values"]["data.confidence"]["avg"],
         }
 
     def _count_by_field(self, events: List[LogEvent], field_path: str) -> Dict[str, int]:
@@ -446,18 +642,21 @@ class StructuredLogger:
         for event in events:
             value = self._get_nested_field(event, field_path)
             if value:
-                counts[str(value)] = counts.get(str(value), 0) + 1
+                # Lists and dicts by their JSON text, the key the native log uses
+                key = json.dumps(value, default=str) if isinstance(value, (list, dict)) else str(value)
+                counts[key] = counts.get(key, 0) + 1
         return counts
 
-    def _avg_field(self, events: List[LogEvent], field_path: str) -> Optional[float]:
-        """Calculate average of a numeric field."""
-        values = []
-        for event in events:
-            value = self._get_nested_field(event, field_path)
-            if value is not None and isinstance(value, (int, float)):
-                values.append(float(value))
-
-        return sum(values) / len(values) if values else None
+    @staticmethod
+    def _value_summary(count: int, total: float, low: Any, high: Any) -> Dict[str, Any]:
+        """Stats of a numeric field; min/max/avg are None without values."""
+        return {
+            "count": count,
+            "sum": total,
+            "min": low if count else None,
+            "max": high if count else None,
+            "avg": total / count if count else None,
+        }
 
     def _get_nested_field(self, event: LogEvent, field_path: str) -> Any:
         """Get a nested field from an event (e.g., 'data.pattern_type')."""
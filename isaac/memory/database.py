@@ -5,12 +5,48 @@ Manages conversation contexts, memory storage, and retrieval across sessions.
 
 import hashlib
 import json
+import os
 import sqlite3
+import threading
 import time
 from dataclasses import asdict, dataclass
 from pathlib import Path
 from typing import Any, Dict, List, Optional
 
+try:
+    from isaac.isaac_core import MemoryIndex
+
+    NATIVE_MEMORY_INDEX_AVAILABLE = True
+except ImportError:
+    MemoryIndex = None
+    NATIVE_MEMORY_INDEX_AVAILABLE = False
+
+
+# One index per database file, shared by every MemoryDatabase in the process
+_memory_indexes: Dict[str, Any] = {}
+_memory_indexes_lock = threading.Lock()
+
+
+def _open_memory_index(db_path: Path):
+    """The native index for db_path, or None without isaac_core"""
+    if not NATIVE_MEMORY_INDEX_AVAILABLE:
+        return None
+    path = os.path.realpath(db_path)
+    with _memory_indexes_lock:
+        index = _memory_indexes.get(path)
+        if index is None:
+            index = _memory_indexes[path] = MemoryIndex()
+        return index
+
+
+def _memory_text(value: Any) -> str:
+    """The searchable text of a memory's content: its values, flattened"""
+    if isinstance(value, dict):
+        return " ".join(_memory_text(item) for item in value.values())
+    if isinstance(value, (list, tuple)):
+        return " ".join(_memory_text(item) for item in value)
+    return "" if value is None else str(value)
+
 
 @dataclass
 class MemoryEntry:
@@ -106,12 +142,19 @@ class ConversationContext:
 
 
 class MemoryDatabase:
-    """SQLite database for persistent memory storage"""
+    """SQLite database for persistent memory storage.
+
+    With isaac_core, search_memories ranks through a native BM25 index over
+    memory content and tags. The index is kept in step by store_memory and
+    prune_old_memories, and catches up on rows other processes added before
+    each search.
+    """
 
     def __init__(self, db_path: Path):
         self.db_path = db_path
         self.db_path.parent.mkdir(parents=True, exist_ok=True)
         self._init_db()
+        self._index = _open_memory_index(db_path)
 
     def _init_db(self):
         """Initialize database tables"""
@@ -161,6 +204,12 @@ class MemoryDatabase:
     def store_memory(self, entry: MemoryEntry) -> Optional[int]:
         """Store a memory entry"""
         with sqlite3.connect(self.db_path) as conn:
+            # The same content replaces its earlier row under a new id
+            replaced = None
+            if self._index is not None:
+                replaced = conn.execute(
+                    "SELECT id FROM memories WHERE checksum = ?", (entry.checksum,)
+                ).fetchone()
             cursor = conn.execute(
                 """
                 INSERT OR REPLACE INTO memories
@@ -178,7 +227,49 @@ class MemoryDatabase:
                     entry.checksum,
                 ),
             )
-            return cursor.lastrowid
+            memory_id = cursor.lastrowid
+
+        # Indexed once committed, so a search never sees an uncommitted id
+        if self._index is not None:
+            if replaced and replaced[0] != memory_id:
+                self._index.remove(replaced[0])
+            self._sync_index(conn)
+        return memory_id
+
+    def _sync_index(self, conn: sqlite3.Connection):
+        """Index rows added since the index last saw the table (all of them on first use)"""
+        conn.row_factory = sqlite3.Row
+        rows = conn.execute(
+            """
+            SELECT id, session_id, timestamp, memory_type, content, importance, tags
+            FROM memories WHERE id > ? ORDER BY id
+        """,
+            (self._index.max_id(),),
+        )
+        for row in rows:
+            self._index.add(
+                row["id"],
+                row["session_id"],
+                row["memory_type"],
+                row["timestamp"],
+                row["importance"],
+                _memory_text(json.loads(row["content"])),
+                [str(tag) for tag in json.loads(row["tags"])],
+            )
+
+    @staticmethod
+    def _row_to_entry(row: sqlite3.Row) -> MemoryEntry:
+        return MemoryEntry(
+            id=row["id"],
+            session_id=row["session_id"],
+            timestamp=row["timestamp"],
+            memory_type=row["memory_type"],
+            content=json.loads(row["content"]),
+            metadata=json.loads(row["metadata"]),
+            importance=row["importance"],
+            tags=json.loads(row["tags"]),
+            checksum=row["checksum"],
+        )
 
     def get_memories(
         self,
@@ -205,37 +296,44 @@ class MemoryDatabase:
         with sqlite3.connect(self.db_path) as conn:
             conn.row_factory = sqlite3.Row
             cursor = conn.execute(query, params)
-
-            memories = []
-            for row in cursor:
-                entry = MemoryEntry(
-                    id=row["id"],
-                    session_id=row["session_id"],
-                    timestamp=row["timestamp"],
-                    memory_type=row["memory_type"],
-                    content=json.loads(row["content"]),
-                    metadata=json.loads(row["metadata"]),
-                    importance=row["importance"],
-                    tags=json.loads(row["tags"]),
-                    checksum=row["checksum"],
-                )
-                memories.append(entry)
-
-            return memories
+            return [self._row_to_entry(row) for row in cursor]
 
     def search_memories(
-        self, query: str, session_id: Optional[str] = None, limit: int = 50
+        self,
+        query: str,
+        session_id: Optional[str] = None,
+        limit: int = 50,
+        memory_type: Optional[str] = None,
+        tags: Optional[List[str]] = None,
+        min_importance: float = 0.0,
     ) -> List[MemoryEntry]:
-        """Search memories by content"""
+        """Search memories by content, best match first.
+
+        The native index ranks by BM25 over content and tags, blended with
+        importance and recency, and matches whole words. Without it, this
+        falls back to a substring scan of content and metadata ordered by
+        importance. Every given tag must be present.
+        """
+        if self._index is not None:
+            return self._search_index(query, session_id, limit, memory_type, tags, min_importance)
+
         search_query = """
-            SELECT * FROM memories WHERE 1=1
+            SELECT * FROM memories WHERE importance >= ?
         """
-        params = []
+        params: List[Any] = [min_importance]
 
         if session_id:
             search_query += " AND session_id = ?"
             params.append(session_id)
 
+        if memory_type:
+            search_query += " AND memory_type = ?"
+            params.append(memory_type)
+
+        for tag in tags or []:
+            search_query += " AND tags LIKE ?"
+            params.append(f"%{json.dumps(tag)}%")
+
         # Simple text search in content and metadata
         search_query += """
             AND (content LIKE ? OR metadata LIKE ?)
@@ -248,23 +346,45 @@ class MemoryDatabase:
         with sqlite3.connect(self.db_path) as conn:
             conn.row_factory = sqlite3.Row
             cursor = conn.execute(search_query, params)
+            return [self._row_to_entry(row) for row in cursor]
 
-            memories = []
-            for row in cursor:
-                entry = MemoryEntry(
-                    id=row["id"],
-                    session_id=row["session_id"],
-                    timestamp=row["timestamp"],
-                    memory_type=row["memory_type"],
-                    content=json.loads(row["content"]),
-                    metadata=json.loads(row["metadata"]),
-                    importance=row["importance"],
-                    tags=json.loads(row["tags"]),
-                    checksum=row["checksum"],
-                )
-                memories.append(entry)
+    def _search_index(
+        self,
+        query: str,
+        session_id: Optional[str],
+        limit: int,
+        memory_type: Optional[str],
+        tags: Optional[List[str]],
+        min_importance: float,
+    ) -> List[MemoryEntry]:
+        with sqlite3.connect(self.db_path) as conn:
+            self._sync_index(conn)
+            hits = self._index.search(
+                query,
+                limit,
+                time.time(),
+                session_id or "",
+                memory_type or "",
+                [str(tag) for tag in tags or []],
+                min_importance,
+            )
+            if not hits:
+                return []
+
+            # Only the ranked rows are fetched and decoded
+            ids = [hit.id for hit in hits]
+            placeholders = ",".join("?" * len(ids))
+            rows = {
+                row["id"]: row
+                for row in conn.execute(f"SELECT * FROM memories WHERE id IN ({placeholders})", ids)
+            }
+
+        # Rows another process deleted since they were indexed
+        for memory_id in ids:
+            if memory_id not in rows:
+                self._index.remove(memory_id)
 
-            return memories
+        return [self._row_to_entry(rows[memory_id]) for memory_id in ids if memory_id in rows]
 
     def store_context(self, context: ConversationContext) -> Optional[int]:
         """Store a conversation context"""
@@ -353,8 +473,11 @@ class MemoryDatabase:
             """,
                 (cutoff_time, min_importance),
             )
+            removed = cursor.rowcount
 
-            return cursor.rowcount
+        if self._index is not None:
+            self._index.prune(cutoff_time, min_importance)
+        return removed
 
     def get_stats(self) -> Dict[str, Any]:
         """Get memory database statistics"""
@@ -128,8 +128,8 @@ class OptimizedMemoryManager:
                 # Auto-flush if buffer is large
                 if len(self._write_buffer) > 100:
                     self._flush_buffer()
-           
-   return 1  # Return placeholder ID
+
+            return 1  # Return placeholder ID
         return None
 
     def add_to_context(self, role: str, content: str, metadata: Optional[Dict[str, Any]] = None):
@@ -195,24 +195,24 @@ class OptimizedMemoryManager:
     ) -> Optional[int]:
         """Store conversation memory with optimized format"""
         return self.store_memory(
-        memory_type="conversation",
-        content={
-            "user_input": user_input,
-            "ai_response": ai_response,
-            "turn_id": str(uuid.uuid4())
-        },
-          metadata=metadata,
-          importance=0.8,  # Conversations are moderately important
-          tags=["conversation", "turn"]
+            memory_type="conversation",
+            content={
+                "user_input": user_input,
+                "ai_response": ai_response,
+                "turn_id": str(uuid.uuid4())
+            },
+            metadata=metadata,
+            importance=0.8,  # Conversations are moderately important
+            tags=["conversation", "turn"]
         )
 
     @performance_timer
     def search_memories(
-      self,
+        self,
         query: str,
         memory_type: Optional[str] = None,
         tags: Optional[List[str]] = None,
-     limit: int = 10,
+        limit: int = 10,
         min_importance: float = 0.0
     ) -> List[MemoryEntry]:
         """Search memories with caching for common queries"""
@@ -227,23 +227,23 @@ class OptimizedMemoryManager:
         results = self.db.search_memories(
             session_id=self.current_session_id,
             query=query,
-   memory_type=memory_type,
-    tags=tags,
-          limit=limit,
-        min_importance=min_importance
+            memory_type=memory_type,
+            tags=tags,
+            limit=limit,
+            min_importance=min_importance
         )
         
-      # Cache search results (they're relatively stable)
+        # Cache search results (they're relatively stable)
         self._memory_cache[cache_key] = results
-      self._cleanup_cache_if_needed()
+        self._cleanup_cache_if_needed()
         
-   return results
+        return results
 
     def flush_writes(self):
         """Manually flush write buffer to database"""
         with self._buffer_lock:
-         if self._write_buffer:
-             self._flush_buffer()
+            if self._write_buffer:
+                self._flush_buffer()
 
     def _flush_buffer(self):
         """Internal method to flush write buffer"""
@@ -251,74 +251,74 @@ class OptimizedMemoryManager:
             return
             
         try:
-         # Batch write to database
+            # Batch write to database
             for item_type, item_data in self._write_buffer:
-       if item_type == 'context':
- self.db.store_context(item_data)
-    elif item_type == 'memory':
-            self.db.store_memory(item_data)
-      
-   self._write_buffer.clear()
+                if item_type == 'context':
+                    self.db.store_context(item_data)
+                elif item_type == 'memory':
+                    self.db.store_memory(item_data)
+
+            self._write_buffer.clear()
             self._last_flush = time.time()
             
         except Exception as e:
             # Log error but don't crash
-          print(f"Memory flush error: {e}")
+            print(f"Memory flush error: {e}")
 
     def _cleanup_cache_if_needed(self):
-  """Clean up cache if it's getting too large"""
+        """Clean up cache if it's getting too large"""
         import sys
         
         # Rough estimate of cache size
         cache_size_bytes = sum(sys.getsizeof(v) for v in self._memory_cache.values())
         max_size_bytes = self.cache_size_mb * 1024 * 1024
-      
+
         if cache_size_bytes > max_size_bytes:
-           # Remove oldest 25% of cache entries
+            # Remove oldest 25% of cache entries
             cache_items = list(self._memory_cache.items())
             remove_count = len(cache_items) // 4
-      
-         for key, _ in cache_items[:remove_count]:
-             del self._memory_cache[key]
-      
-    # Also run memory optimization
-      memory_optimizer.optimize_memory()
+
+            for key, _ in cache_items[:remove_count]:
+                del self._memory_cache[key]
+
+            # Also run memory optimization
+            memory_optimizer.optimize_memory()
 
     def get_performance_stats(self) -> Dict[str, Any]:
-    """Get memory manager performance statistics"""
-    return {
+        """Get memory manager performance statistics"""
+        return {
             'cache_size': len(self._memory_cache),
-  'cache_hits': self._cache_stats['hits'],
+            'cache_hits': self._cache_stats['hits'],
             'cache_misses': self._cache_stats['misses'], 
             'cache_hit_rate': self._cache_stats['hits'] / max(1, self._cache_stats['hits'] + self._cache_stats['misses']),
-       'write_buffer_size': len(self._write_buffer),
+            'write_buffer_size': len(self._write_buffer),
             'last_flush': self._last_flush,
-  'session_id': self.current_session_id
-      }
+            'session_id': self.current_session_id
+        }
 
     def optimize_memory(self):
         """Run memory optimization"""
         # Clear old cache entries
-   current_time = time.time()
+        current_time = time.time()
         old_keys = [
- key for key, value in self._memory_cache.items()
+            key for key, value in self._memory_cache.items()
             if hasattr(value, 'timestamp') and current_time - getattr(value, 'timestamp', 0) > 3600
         ]
         
-   for key in old_keys:
-       del self._memory_cache[key]
-    
+        for key in old_keys:
+            del self._memory_cache[key]
+
         # Flush any pending writes
         self.flush_writes()
         
-      # Run global memory optimization
-    return memory_optimizer.optimize_memory()
+        # Run global memory optimization
+        return memory_optimizer.optimize_memory()
 
     def close(self):
         """Clean shutdown of memory manager"""
         self.flush_writes()
         if hasattr(self.db, 'close'):
-    self.db.close()
+            self.db.close()
 
 
 # For backward compatibility
@@ -16,6 +16,7 @@ import psutil
 
 from isaac.core.message_queue import MessagePriority, MessageType
 from isaac.monitoring.base_monitor import BaseMonitor
+from isaac.monitoring.system_sampler import cgroup_memory_percent, latest_sample
 
 logger = logging.getLogger(__name__)
 
@@ -52,29 +53,29 @@ class SystemMonitor(BaseMonitor):
         """Check disk space usage."""
         try:
             # Get disk usage for system drive
-            if platform.system() == "Windows":
-                disk = psutil.disk_usage("C:\\")
+            sample = latest_sample()
+            if sample is not None:
+                usage_percent, free_bytes = sample.disk_percent, sample.disk_free
             else:
-                disk = psutil.disk_usage("/")
-
-            usage_percent = disk.percent
+                disk = psutil.disk_usage("C:\\" if platform.system() == "Windows" else "/")
+                usage_percent, free_bytes = disk.percent, disk.free
 
             if usage_percent > 90:
                 self._send_message(
                     MessageType.SYSTEM,
                     "Critical: Low Disk Space",
-                    f"System disk is {usage_percent:.1f}% full ({disk.free / (1024**3):.1f} GB free). "
+                    f"System disk is {usage_percent:.1f}% full ({free_bytes / (1024**3):.1f} GB free). "
                     "Consider cleaning up files or expanding storage.",
                     MessagePriority.URGENT,
-                    {"disk_percent": usage_percent, "free_gb": disk.free / (1024**3)},
+                    {"disk_percent": usage_percent, "free_gb": free_bytes / (1024**3)},
                 )
             elif usage_percent > 80:
                 self._send_message(
                     MessageType.SYSTEM,
                     "Warning: Low Disk Space",
-                    f"System disk is {usage_percent:.1f}% full ({disk.free / (1024**3):.1f} GB free).",
+                    f"System disk is {usage_percent:.1f}% full ({free_bytes / (1024**3):.1f} GB free).",
                     MessagePriority.HIGH,
-                    {"disk_percent": usage_percent, "free_gb": disk.free / (1024**3)},
+                    {"disk_percent": usage_percent, "free_gb": free_bytes / (1024**3)},
                 )
 
         except Exception as e:
@@ -83,8 +84,12 @@ class SystemMonitor(BaseMonitor):
     def _check_memory_usage(self):
         """Check system memory usage."""
         try:
-            memory = psutil.virtual_memory()
-            usage_percent = memory.percent
+            sample = latest_sample()
+            if sample is not None:
+                # In a container the cgroup limit is usually the one that bites
+                usage_percent = max(sample.memory_percent, cgroup_memory_percent(sample) or 0.0)
+            else:
+                usage_percent = psutil.virtual_memory().percent
 
             if usage_percent > 95:
                 self._send_message(
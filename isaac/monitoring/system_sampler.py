@@ -0,0 +1,89 @@
+# isaac/monitoring/system_sampler.py
+
+"""
+System Sampler - Shared low-overhead source of system figures
+
+One native SystemSampler per process reads /proc and cgroup files from a
+C++ thread into a ring of samples; monitors and the profiler read the ring
+when they need figures instead of polling psutil from their own threads.
+Without isaac_core, or off Linux, get_system_sampler() returns None and
+callers keep using psutil.
+"""
+
+import threading
+import time
+from typing import Any, Dict, Optional
+
+try:
+    from isaac.isaac_core import SystemSampler
+
+    NATIVE_SAMPLER_AVAILABLE = True
+except ImportError:
+    SystemSampler = None
+    NATIVE_SAMPLER_AVAILABLE = False
+
+SAMPLE_INTERVAL_MS = 1000
+
+_sampler = None
+_sampler_lock = threading.Lock()
+
+
+def get_system_sampler():
+    """The process's running sampler, or None where it is unavailable"""
+    global _sampler
+    if not NATIVE_SAMPLER_AVAILABLE or not SystemSampler.supported():
+        return None
+    with _sampler_lock:
+        if _sampler is None:
+            _sampler = SystemSampler(interval_ms=SAMPLE_INTERVAL_MS)
+            _sampler.start()
+        return _sampler
+
+
+def latest_sample(max_age: float = 2 * SAMPLE_INTERVAL_MS / 1000):
+    """The newest ring sample, or a fresh one if it is older than max_age seconds"""
+    sampler = get_system_sampler()
+    if sampler is None:
+        return None
+    sample = sampler.latest()
+    if sample.sequence == 0 or time.time() - sample.timestamp > max_age:
+        sample = sampler.sample()
+    return sample
+
+
+def sample_metrics(sample) -> Dict[str, Any]:
+    """A sample in the psutil-shaped dict the profiler records"""
+    metrics = {
+        "cpu_percent": sample.cpu_percent,
+        "cpu_count": sample.cpu_count,
+        "memory": {
+            "total": sample.memory_total,
+            "available": sample.memory_available,
+            "percent": sample.memory_percent,
+            "used": sample.memory_used,
+        },
+        "disk": {
+            "read_bytes": sample.disk_read_bytes,
+            "write_bytes": sample.disk_write_bytes,
+        },
+        "network": {
+            "bytes_sent": sample.net_bytes_sent,
+            "bytes_recv": sample.net_bytes_recv,
+        },
+        "load_average": list(sample.load_average),
+        "process_count": sample.tasks,
+    }
+    if sample.cgroup:
+        metrics["cgroup"] = {
+            "cpu_percent": sample.cgroup_cpu_percent,
+            "memory_current": sample.cgroup_memory_current,
+            "memory_max": sample.cgroup_memory_max,
+        }
+    return metrics
+
+
+def cgroup_memory_percent(sample) -> Optional[float]:
+    """Memory use against the cgroup limit, when the cgroup has one"""
+    if sample.cgroup and sample.cgroup_memory_max:
+        return 100.0 * sample.cgroup_memory_current / sample.cgroup_memory_max
+    return None
@@ -4,17 +4,22 @@ Command Pipelines for Isaac
 Enables chaining commands together in pipelines for complex workflows.
 """
 
-from isaac.pipelines.executor import PipelineExecutor
-from isaac.pipelines.models import Pipeline, PipelineStage
-from isaac.pipelines.parser import PipelineParser
-from isaac.pipelines.repository import PipelineRepository
-from isaac.pipelines.validator import PipelineValidator
+from isaac.pipelines.executor import StepExecutor
+from isaac.pipelines.models import (
+    Pipeline,
+    PipelineExecution,
+    PipelineStatus,
+    PipelineStep,
+    StepType,
+)
+from isaac.pipelines.runner import PipelineRunner
 
 __all__ = [
     'Pipeline',
-    'PipelineStage',
-    'PipelineExecutor',
-    'PipelineParser',
-    'PipelineRepository',
-    'PipelineValidator',
+    'PipelineExecution',
+    'PipelineRunner',
+    'PipelineStatus',
+    'PipelineStep',
+    'StepExecutor',
+    'StepType',
 ]
@@ -3,27 +3,49 @@ Pipeline Execution Engine - Execute pipeline workflows
 Isaac's pipeline runner with parallel execution and error handling
 """
 
+import re
 import subprocess
 import time
+import uuid
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
-from typing import Any, Dict, Optional
+from typing import Any, Dict, List, Optional
 
 from isaac.pipelines.models import PipelineStep, StepType
 
+# Optional native pipeline engine (C++ core)
+try:
+    from isaac.isaac_core import PipelineEngine, PipelineStepSpec, StepCache
+    from isaac.isaac_core import substitute_variables as native_substitute_variables
+
+    NATIVE_PIPELINES_AVAILABLE = True
+except ImportError:
+    PipelineEngine = PipelineStepSpec = StepCache = native_substitute_variables = None
+    NATIVE_PIPELINES_AVAILABLE = False
+
+# ${name} with any name, or $name with the longest identifier
+_VARIABLE_PATTERN = re.compile(r"\$\{([^}$]*)\}|\$([A-Za-z_][A-Za-z0-9_]*)")
+
 
 class StepExecutor:
     """Executes individual pipeline steps."""
 
-    def __init__(self, working_dir: Optional[Path] = None):
+    def __init__(self, working_dir: Optional[Path] = None, engine: Optional[Any] = None):
         """Initialize step executor.
 
         Args:
             working_dir: Working directory for command execution
+            engine: Native PipelineEngine for parallel steps (optional)
         """
         self.working_dir = working_dir or Path.cwd()
+        self.engine = engine
 
     def execute_step(
-        self, step: PipelineStep, variables: Dict[str, Any], timeout_seconds: Optional[int] = None
+        self,
+        step: PipelineStep,
+        variables: Dict[str, Any],
+        timeout_seconds: Optional[int] = None,
+        stdin: Optional[str] = None,
     ) -> Dict[str, Any]:
         """Execute a single pipeline step.
 
@@ -31,6 +53,7 @@ class StepExecutor:
             step: Step to execute
             variables: Pipeline variables
             timeout_seconds: Override timeout
+            stdin: Input for command and script steps
 
         Returns:
             Execution result
@@ -40,11 +63,11 @@ class StepExecutor:
         try:
             if step.type == StepType.COMMAND:
                 result = self._execute_command(
-                    step, variables, timeout_seconds or step.timeout_seconds
+                    step, variables, timeout_seconds or step.timeout_seconds, stdin
                 )
             elif step.type == StepType.SCRIPT:
                 result = self._execute_script(
-                    step, variables, timeout_seconds or step.timeout_seconds
+                    step, variables, timeout_seconds or step.timeout_seconds, stdin
                 )
             elif step.type == StepType.CONDITION:
                 result = self._execute_condition(step, variables)
@@ -66,14 +89,19 @@ class StepExecutor:
         except Exception as e:
             result = {"success": False, "output": f"Step execution error: {e}", "exit_code": 1}
 
-        result["duration"] = time.time() - start_time
+        result["end_time"] = time.time()
+        result["duration"] = result["end_time"] - start_time
         result["step_id"] = step.id
         result["step_name"] = step.name
 
         return result
 
     def _execute_command(
-        self, step: PipelineStep, variables: Dict[str, Any], timeout: Optional[int]
+        self,
+        step: PipelineStep,
+        variables: Dict[str, Any],
+        timeout: Optional[int],
+        stdin: Optional[str] = None,
     ) -> Dict[str, Any]:
         """Execute a command step."""
         command = step.config.get("command", "")
@@ -89,6 +117,7 @@ class StepExecutor:
                 command,
                 shell=True,
                 cwd=self.working_dir,
+                input=stdin,
                 capture_output=True,
                 text=True,
                 timeout=timeout,
@@ -97,6 +126,7 @@ class StepExecutor:
             return {
                 "success": result.returncode == 0,
                 "output": result.stdout + result.stderr,
+                "stdout": result.stdout,
                 "exit_code": result.returncode,
             }
 
@@ -108,7 +138,11 @@ class StepExecutor:
             }
 
     def _execute_script(
-        self, step: PipelineStep, variables: Dict[str, Any], timeout: Optional[int]
+        self,
+        step: PipelineStep,
+        variables: Dict[str, Any],
+        timeout: Optional[int],
+        stdin: Optional[str] = None,
     ) -> Dict[str, Any]:
         """Execute a script step."""
         script_path = step.config.get("script_path", "")
@@ -126,6 +160,7 @@ class StepExecutor:
             result = subprocess.run(
                 [str(script_path)],
                 cwd=self.working_dir,
+                input=stdin,
                 capture_output=True,
                 text=True,
                 timeout=timeout,
@@ -134,6 +169,7 @@ class StepExecutor:
             return {
                 "success": result.returncode == 0,
                 "output": result.stdout + result.stderr,
+                "stdout": result.stdout,
                 "exit_code": result.returncode,
             }
 
@@ -196,16 +232,101 @@ class StepExecutor:
         return {"success": True, "output": f"Notification sent: {message}", "exit_code": 0}
 
     def _execute_parallel(self, step: PipelineStep, variables: Dict[str, Any]) -> Dict[str, Any]:
-        """Execute parallel steps (placeholder for now)."""
-        return {"success": True, "output": "Parallel execution not yet implemented", "exit_code": 0}
+        """Run config["commands"] concurrently; succeeds if all of them do."""
+        commands = step.config.get("commands", [])
+        if not commands:
+            return {"success": False, "output": "No commands specified", "exit_code": 1}
+
+        max_parallel = step.config.get("max_parallel", len(commands))
+        results = self._run_commands(commands, variables, max_parallel, step.timeout_seconds)
+
+        output = "\n".join(f"[{i}] {result['output']}" for i, result in enumerate(results))
+        failed = [result for result in results if not result["success"]]
+        return {
+            "success": not failed,
+            "output": output,
+            "exit_code": failed[0]["exit_code"] if failed else 0,
+        }
 
     def _execute_loop(self, step: PipelineStep, variables: Dict[str, Any]) -> Dict[str, Any]:
-        """Execute loop steps (placeholder for now)."""
-        return {"success": True, "output": "Loop execution not yet implemented", "exit_code": 0}
+        """Run config["command"] once per item, with the item as ${item}."""
+        command = step.config.get("command", "")
+        if not command:
+            return {"success": False, "output": "No command specified", "exit_code": 1}
+
+        items = step.config.get("items", [])
+        if isinstance(items, str):
+            items = self._substitute_variables(items, variables).split()
+        continue_on_error = step.config.get("continue_on_error", False)
+
+        outputs = []
+        exit_code = 0
+        for item in items:
+            loop_step = PipelineStep(
+                id=step.id, name=step.name, type=StepType.COMMAND, config={"command": command}
+            )
+            result = self._execute_command(
+                loop_step, {**variables, "item": item}, step.timeout_seconds
+            )
+            outputs.append(f"[{item}] {result['output']}")
+            if not result["success"]:
+                exit_code = exit_code or result["exit_code"] or 1
+                if not continue_on_error:
+                    break
+
+        return {"success": exit_code == 0, "output": "\n".join(outputs), "exit_code": exit_code}
+
+    def _run_commands(
+        self,
+        commands: List[str],
+        variables: Dict[str, Any],
+        max_parallel: int,
+        timeout: Optional[int],
+    ) -> List[Dict[str, Any]]:
+        """Run independent shell commands at most max_parallel at a time."""
+        if self.engine is not None:
+            specs = []
+            for i, command in enumerate(commands):
+                spec = PipelineStepSpec()
+                spec.id = str(i)
+                spec.command = command
+                spec.timeout_ms = int(timeout * 1000) if timeout else 0
+                spec.continue_on_failure = True
+                specs.append(spec)
+            run = self.engine.run(
+                str(uuid.uuid4()),
+                specs,
+                {key: str(value) for key, value in variables.items()},
+                max_parallel=max_parallel,
+                working_dir=str(self.working_dir),
+            )
+            return [
+                {
+                    "success": result.status == "success",
+                    "output": result.stdout + result.stderr,
+                    "exit_code": result.exit_code,
+                }
+                for result in run.steps
+            ]
+
+        def run_one(command: str) -> Dict[str, Any]:
+            command_step = PipelineStep(
+                id="parallel", name="parallel", type=StepType.COMMAND, config={"command": command}
+            )
+            return self._execute_command(command_step, variables, timeout)
+
+        with ThreadPoolExecutor(max_workers=max(1, max_parallel)) as pool:
+            return list(pool.map(run_one, commands))
 
     def _substitute_variables(self, text: str, variables: Dict[str, Any]) -> str:
-        """Substitute variables in text."""
-        for key, value in variables.items():
-            text = text.replace(f"${{{key}}}", str(value))
-            text = text.replace(f"${key}", str(value))
-        return text
+        """Substitute ${name} and $name; unknown names are left as written."""
+        if NATIVE_PIPELINES_AVAILABLE:
+            return native_substitute_variables(
+                text, {key: str(value) for key, value in variables.items()}
+            )
+
+        def replace(match: "re.Match") -> str:
+            name = match.group(1) if match.group(1) is not None else match.group(2)
+            return str(variables[name]) if name in variables else match.group(0)
+
+        return _VARIABLE_PATTERN.sub(replace, text)
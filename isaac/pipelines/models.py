@@ -45,6 +45,10 @@ class PipelineStep:
     retry_count: int = 0
     retry_delay_seconds: int = 5
     on_failure: str = "stop"  # stop, continue, retry
+    stdin_from: Optional[str] = None  # step whose stdout feeds this step's stdin
+    cache: bool = False  # replay the last successful result when nothing it depends on changed
+    inputs: List[str] = field(default_factory=list)  # files/directories the step reads
+    env: List[str] = field(default_factory=list)  # environment variables the step reads
     metadata: Dict[str, Any] = field(default_factory=dict)
 
     def __post_init__(self):
@@ -54,6 +58,12 @@ class PipelineStep:
         if not self.name:
             raise ValueError("Step name cannot be empty")
 
+    def dependencies(self) -> List[str]:
+        """Steps that must succeed first; reading stdin from a step implies one."""
+        if self.stdin_from and self.stdin_from not in self.depends_on:
+            return self.depends_on + [self.stdin_from]
+        return list(self.depends_on)
+
 
 @dataclass
 class PipelineExecution:
@@ -116,6 +126,9 @@ class Pipeline:
             for dep in step.depends_on:
                 if dep not in step_ids:
                     raise ValueError(f"Step {step.id} depends on unknown step {dep}")
+            if step.stdin_from and step.stdin_from not in step_ids:
+                raise ValueError(f"Step {step.id} reads stdin from unknown step {step.stdin_from}")
+        self.topological_order()
 
     def get_step(self, step_id: str) -> Optional[PipelineStep]:
         """Get a step by ID."""
@@ -126,7 +139,31 @@ class Pipeline:
 
     def get_roots(self) -> List[PipelineStep]:
         """Get steps with no dependencies."""
-        return [step for step in self.steps if not step.depends_on]
+        return [step for step in self.steps if not step.dependencies()]
+
+    def topological_order(self) -> List[PipelineStep]:
+        """Steps ordered so each comes after its dependencies.
+
+        Raises:
+            ValueError: If the dependencies form a cycle
+        """
+        remaining = {step.id: len(step.dependencies()) for step in self.steps}
+        dependents: Dict[str, List[PipelineStep]] = {step.id: [] for step in self.steps}
+        for step in self.steps:
+            for dep in step.dependencies():
+                dependents[dep].append(step)
+
+        order = [step for step in self.steps if remaining[step.id] == 0]
+        for step in order:
+            for dependent in dependents[step.id]:
+                remaining[dependent.id] -= 1
+                if remaining[dependent.id] == 0:
+                    order.append(dependent)
+
+        if len(order) != len(self.steps):
+            cyclic = sorted(step_id for step_id, count in remaining.items() if count > 0)
+            raise ValueError(f"Pipeline steps form a dependency cycle: {', '.join(cyclic)}")
+        return order
 
     def to_dict(self) -> Dict[str, Any]:
         """Convert to dictionary for serialization."""
@@ -177,6 +214,10 @@ class Pipeline:
             "retry_count": step.retry_count,
             "retry_delay_seconds": step.retry_delay_seconds,
             "on_failure": step.on_failure,
+            "stdin_from": step.stdin_from,
+            "cache": step.cache,
+            "inputs": step.inputs,
+            "env": step.env,
             "metadata": step.metadata,
         }
 
@@ -193,5 +234,9 @@ class Pipeline:
             retry_count=data.get("retry_count", 0),
             retry_delay_seconds=data.get("retry_delay_seconds", 5),
             on_failure=data.get("on_failure", "stop"),
+            stdin_from=data.get("stdin_from"),
+            cache=data.get("cache", False),
+            inputs=data.get("inputs", []),
+            env=data.get("env", []),
             metadata=data.get("metadata", {}),
         )
@@ -3,33 +3,74 @@ Pipeline Runner - Orchestrate pipeline execution with dependencies
 Isaac's pipeline execution orchestrator
 """
 
+import shlex
 import threading
 import time
 import uuid
 from collections import defaultdict, deque
-from concurrent.futures import Future, ThreadPoolExecutor
-from typing import Any, Dict, List, Optional, Set
-
-from isaac.pipelines.executor import StepExecutor
+from concurrent.futures import FIRST_COMPLETED, Future, ThreadPoolExecutor, wait
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Set
+
+from isaac.pipelines.executor import (
+    NATIVE_PIPELINES_AVAILABLE,
+    PipelineEngine,
+    PipelineStepSpec,
+    StepCache,
+    StepExecutor,
+)
 from isaac.pipelines.models import (
     Pipeline,
     PipelineExecution,
     PipelineStatus,
     PipelineStep,
+    StepType,
 )
 
 
-class PipelineRunner:
-    """Orchestrates pipeline execution with dependency management."""
+DEFAULT_CACHE_MAX_BYTES = 256 * 1024 * 1024
+
 
-    def __init__(self, max_workers: int = 4):
+class PipelineRunner:
+    """Orchestrates pipeline execution with dependency management.
+
+    With the native core, the whole DAG runs in the C++ pipeline engine:
+    independent steps start concurrently, command output can stream into a
+    downstream step's stdin, and the critical path is recorded in the
+    execution metadata. Command steps marked ``cache`` are fingerprinted
+    from their command, input files and environment and replayed from a
+    content-addressed store when unchanged. Otherwise steps run on a thread
+    pool, without caching.
+    """
+
+    def __init__(
+        self,
+        max_workers: int = 4,
+        use_native: bool = True,
+        cache_dir: Optional[Path] = None,
+        cache_max_bytes: int = DEFAULT_CACHE_MAX_BYTES,
+    ):
         """Initialize pipeline runner.
 
         Args:
             max_workers: Maximum number of concurrent step executions
+            use_native: Use the native pipeline engine when available
+            cache_dir: Step cache location (default ~/.isaac/pipeline_cache)
+            cache_max_bytes: Least recently used cache entries are evicted
+                beyond this size at the start of each run
         """
         self.max_workers = max_workers
+        self.cache_max_bytes = cache_max_bytes
         self.executor = ThreadPoolExecutor(max_workers=max_workers, thread_name_prefix="pipeline")
+        self.step_cache = None
+        self.engine = None
+        if use_native and NATIVE_PIPELINES_AVAILABLE:
+            try:
+                cache_dir = cache_dir or Path.home() / ".isaac" / "pipeline_cache"
+                self.step_cache = StepCache(str(cache_dir))
+            except RuntimeError:
+                pass  # run uncached rather than not at all
+            self.engine = PipelineEngine(workers=max_workers, cache=self.step_cache)
         self.active_executions: Dict[str, PipelineExecution] = {}
         self.execution_lock = threading.Lock()
 
@@ -121,6 +162,8 @@ class PipelineRunner:
             if execution and execution.status == PipelineStatus.RUNNING:
                 execution.status = PipelineStatus.CANCELLED
                 execution.end_time = time.time()
+                if self.engine is not None:
+                    self.engine.cancel(execution_id)
                 return True
         return False
 
@@ -137,85 +180,10 @@ class PipelineRunner:
     ) -> None:
         """Execute pipeline with dependency management."""
         try:
-            # Build dependency graph
-            self._build_dependency_graph(pipeline.steps)
-            reverse_deps = self._build_reverse_dependencies(pipeline.steps)
-
-            # Track completed steps
-            completed_steps: Set[str] = set()
-            pending_futures: Dict[str, Future] = {}
-            step_executor = StepExecutor()
-
-            # Start with root steps (no dependencies)
-            ready_queue = deque(pipeline.get_roots())
-
-            while ready_queue or pending_futures:
-                # Submit ready steps
-                while ready_queue:
-                    step = ready_queue.popleft()
-                    if step.id in completed_steps:
-                        continue
-
-                    future = self.executor.submit(
-                        self._execute_step_with_retries,
-                        step_executor,
-                        step,
-                        execution.variables,
-                        step.timeout_seconds,
-                    )
-                    pending_futures[step.id] = future
-
-                # Wait for completed steps
-                if pending_futures:
-                    for step_id, future in list(pending_futures.items()):
-                        if future.done():
-                            del pending_futures[step_id]
-
-                            try:
-                                result = future.result()
-                                execution.steps_results[step_id] = result
-
-                                if result["success"]:
-                                    completed_steps.add(step_id)
-
-                                    # Check if this unlocks new steps
-                                    for dependent_id in reverse_deps.get(step_id, []):
-                                        dependent_step = pipeline.get_step(dependent_id)
-                                        if dependent_step and self._dependencies_satisfied(
-                                            dependent_step, completed_steps
-                                        ):
-                                            ready_queue.append(dependent_step)
-                                else:
-                                    # Step failed - handle based on on_failure policy
-                                    step = pipeline.get_step(step_id)
-                                    if step and step.on_failure == "stop":
-                                        execution.status = PipelineStatus.FAILED
-                                        execution.error_message = (
-                                            f"Step {step_id} failed: {result.get('output', '')}"
-                                        )
-                                        break
-
-                            except Exception as e:
-                                execution.steps_results[step_id] = {
-                                    "success": False,
-                                    "output": f"Execution error: {e}",
-                                    "exit_code": 1,
-                                    "duration": 0,
-                                }
-
-                # Small delay to prevent busy waiting
-                time.sleep(0.1)
-
-                # Check for timeout
-                if (
-                    pipeline.timeout_seconds
-                    and (time.time() - execution.start_time) > pipeline.timeout_seconds
-                ):
-                    execution.status = PipelineStatus.FAILED
-                    execution.error_message = (
-                        f"Pipeline timed out after {pipeline.timeout_seconds} seconds"
-                    )
-                    break
+            if self.engine is not None:
+                self._execute_native(pipeline, execution)
+            else:
+                self._execute_threaded(pipeline, execution)
 
             # Set final status
             if execution.status == PipelineStatus.RUNNING:
@@ -227,6 +195,12 @@ class PipelineRunner:
 
         finally:
             execution.end_time = time.time()
+            if "critical_path" not in execution.metadata:
+                path = self._critical_path(pipeline, execution)
+                execution.metadata["critical_path"] = path
+                execution.metadata["critical_path_seconds"] = sum(
+                    execution.steps_results[step_id].get("duration", 0) for step_id in path
+                )
 
             # Call callback if provided
             if callback:
@@ -235,12 +209,197 @@ class PipelineRunner:
                 except Exception:
                     pass  # Ignore callback errors
 
+    def _execute_native(self, pipeline: Pipeline, execution: PipelineExecution) -> None:
+        """Run the whole DAG in the native engine; other step types call back here."""
+        if self.step_cache is not None:
+            # Results are stored after a run returns, so a cap checked at
+            # the start covers everything earlier runs left behind
+            try:
+                self.step_cache.prune(self.cache_max_bytes)
+            except (OSError, RuntimeError):
+                pass  # an oversized cache must not fail the pipeline
+        step_executor = StepExecutor(engine=self.engine)
+        steps_by_id = {step.id: step for step in pipeline.steps}
+
+        def run_step(step_id: str, stdin: str):
+            result = step_executor.execute_step(
+                steps_by_id[step_id], execution.variables, stdin=stdin or None
+            )
+            exit_code = 0 if result["success"] else (result.get("exit_code") or 1)
+            return exit_code, result.get("output", "")
+
+        run = self.engine.run(
+            execution.execution_id,
+            [self._to_spec(step, step_executor, execution.variables) for step in pipeline.steps],
+            {key: str(value) for key, value in execution.variables.items()},
+            max_parallel=pipeline.max_parallel_steps,
+            timeout_ms=int(pipeline.timeout_seconds * 1000) if pipeline.timeout_seconds else 0,
+            working_dir=str(step_executor.working_dir),
+            callback=run_step,
+        )
+
+        for result in run.steps:
+            if result.attempts == 0:
+                continue
+            step = steps_by_id[result.id]
+            output = result.stdout + result.stderr
+            if result.status == "timeout":
+                output += f"Command timed out after {step.timeout_seconds} seconds"
+            execution.steps_results[result.id] = {
+                "success": result.status == "success",
+                "output": output,
+                "stdout": result.stdout,
+                "exit_code": result.exit_code,
+                "duration": result.duration,
+                "end_time": result.end_time,
+                "step_id": result.id,
+                "step_name": step.name,
+                "status": result.status,
+                "attempts": result.attempts,
+                "streamed": result.streamed,
+                "cached": result.cached,
+            }
+
+        execution.metadata["critical_path"] = list(run.critical_path)
+        execution.metadata["critical_path_seconds"] = run.critical_path_seconds
+        if not run.success:
+            cancelled = execution.status == PipelineStatus.CANCELLED
+            execution.status = PipelineStatus.CANCELLED if cancelled else PipelineStatus.FAILED
+            execution.error_message = run.error
+
+    def _to_spec(
+        self, step: PipelineStep, step_executor: StepExecutor, variables: Dict[str, Any]
+    ) -> "PipelineStepSpec":
+        """Native spec for a step; types the engine cannot run become callbacks."""
+        spec = PipelineStepSpec()
+        spec.id = step.id
+        spec.kind = "callback"
+        spec.depends_on = list(step.depends_on)
+        spec.stdin_from = step.stdin_from or ""
+        spec.timeout_ms = int(step.timeout_seconds * 1000) if step.timeout_seconds else 0
+        spec.retry_count = step.retry_count
+        spec.retry_delay_ms = int(step.retry_delay_seconds * 1000)
+        spec.continue_on_failure = step.on_failure != "stop"
+        spec.cache = step.cache
+        spec.inputs = [step_executor._substitute_variables(path, variables) for path in step.inputs]
+        spec.env = list(step.env)
+
+        if step.type == StepType.COMMAND and step.config.get("command"):
+            spec.kind = "command"
+            spec.command = step.config["command"]
+        elif step.type == StepType.SCRIPT and step.config.get("script_path"):
+            script_path = Path(step.config["script_path"])
+            if script_path.exists():
+                script_path.chmod(0o755)
+                spec.kind = "command"
+                spec.command = shlex.quote(str(script_path.resolve()))
+        elif step.type == StepType.WAIT:
+            seconds = step_executor._substitute_variables(
+                str(step.config.get("seconds", 0)), variables
+            )
+            try:
+                spec.wait_ms = int(float(seconds) * 1000)
+                spec.kind = "wait"
+            except ValueError:
+                pass  # the callback reports the invalid wait time
+        return spec
+
+    def _execute_threaded(self, pipeline: Pipeline, execution: PipelineExecution) -> None:
+        """Run steps on the thread pool as their dependencies complete."""
+        reverse_deps = self._build_reverse_dependencies(pipeline.steps)
+
+        # Track completed steps
+        completed_steps: Set[str] = set()
+        pending_futures: Dict[str, Future] = {}
+        step_executor = StepExecutor()
+
+        # Start with root steps (no dependencies)
+        ready_queue = deque(pipeline.get_roots())
+
+        while (ready_queue or pending_futures) and execution.status == PipelineStatus.RUNNING:
+            # Submit ready steps
+            while ready_queue:
+                step = ready_queue.popleft()
+                if step.id in completed_steps:
+                    continue
+
+                stdin = None
+                if step.stdin_from:
+                    upstream = execution.steps_results[step.stdin_from]
+                    stdin = upstream.get("stdout", upstream.get("output", ""))
+
+                future = self.executor.submit(
+                    self._execute_step_with_retries,
+                    step_executor,
+                    step,
+                    execution.variables,
+                    step.timeout_seconds,
+                    stdin,
+                )
+                pending_futures[step.id] = future
+
+            # Wait for a step to finish, or the pipeline deadline
+            timeout = None
+            if pipeline.timeout_seconds:
+                timeout = max(
+                    0.0, execution.start_time + pipeline.timeout_seconds - time.time()
+                )
+            wait(list(pending_futures.values()), timeout=timeout, return_when=FIRST_COMPLETED)
+
+            for step_id, future in list(pending_futures.items()):
+                if not future.done():
+                    continue
+                del pending_futures[step_id]
+
+                try:
+                    result = future.result()
+                except Exception as e:
+                    result = {
+                        "success": False,
+                        "output": f"Execution error: {e}",
+                        "exit_code": 1,
+                        "duration": 0,
+                    }
+                execution.steps_results[step_id] = result
+
+                if result["success"]:
+                    completed_steps.add(step_id)
+
+                    # Check if this unlocks new steps
+                    for dependent_id in reverse_deps.get(step_id, []):
+                        dependent_step = pipeline.get_step(dependent_id)
+                        if dependent_step and self._dependencies_satisfied(
+                            dependent_step, completed_steps
+                        ):
+                            ready_queue.append(dependent_step)
+                else:
+                    # Step failed - handle based on on_failure policy
+                    step = pipeline.get_step(step_id)
+                    if step and step.on_failure == "stop":
+                        execution.status = PipelineStatus.FAILED
+                        execution.error_message = (
+                            f"Step {step_id} failed: {result.get('output', '')}"
+                        )
+                        break
+
+            # Check for timeout
+            if (
+                execution.status == PipelineStatus.RUNNING
+                and pipeline.timeout_seconds
+                and (time.time() - execution.start_time) > pipeline.timeout_seconds
+            ):
+                execution.status = PipelineStatus.FAILED
+                execution.error_message = (
+                    f"Pipeline timed out after {pipeline.timeout_seconds} seconds"
+                )
+
     def _execute_step_with_retries(
         self,
         executor: StepExecutor,
         step: PipelineStep,
         variables: Dict[str, Any],
         timeout: Optional[int],
+        stdin: Optional[str] = None,
     ) -> Dict[str, Any]:
         """Execute a step with retry logic."""
         last_result = None
@@ -249,7 +408,7 @@ class PipelineRunner:
             if attempt > 0:
                 time.sleep(step.retry_delay_seconds)
 
-            result = executor.execute_step(step, variables, timeout)
+            result = executor.execute_step(step, variables, timeout, stdin)
             last_result = result
 
             if result["success"]:
@@ -261,20 +420,36 @@ class PipelineRunner:
         """Build dependency graph (step -> dependencies)."""
         graph = {}
         for step in steps:
-            graph[step.id] = step.depends_on.copy()
+            graph[step.id] = step.dependencies()
         return graph
 
     def _build_reverse_dependencies(self, steps: List[PipelineStep]) -> Dict[str, List[str]]:
         """Build reverse dependency graph (step -> dependents)."""
         reverse_deps = defaultdict(list)
         for step in steps:
-            for dep in step.depends_on:
+            for dep in step.dependencies():
                 reverse_deps[dep].append(step.id)
         return dict(reverse_deps)
 
     def _dependencies_satisfied(self, step: PipelineStep, completed_steps: Set[str]) -> bool:
         """Check if all dependencies of a step are satisfied."""
-        return all(dep in completed_steps for dep in step.depends_on)
+        return all(dep in completed_steps for dep in step.dependencies())
+
+    def _critical_path(self, pipeline: Pipeline, execution: PipelineExecution) -> List[str]:
+        """Chain of gating dependencies ending at the last step to finish."""
+        finished = {
+            step_id: result["end_time"]
+            for step_id, result in execution.steps_results.items()
+            if "end_time" in result
+        }
+        path = []
+        current = max(finished, key=finished.get, default=None)
+        while current is not None:
+            path.append(current)
+            step = pipeline.get_step(current)
+            gates = [dep for dep in (step.dependencies() if step else []) if dep in finished]
+            current = max(gates, key=finished.get, default=None)
+        return list(reversed(path))
 
     def cleanup_completed_executions(self, max_age_seconds: int = 3600) -> int:
         """Clean up old completed executions.
@@ -1,16 +1,14 @@
 """
-Message Queue for Isaac
+Command Queue for Isaac
 
-Provides async message queue for background tasks, notifications,
-and inter-component communication.
+Provides durable offline command persistence and the background worker
+that syncs queued commands once the cloud is reachable.
 """
 
-from isaac.queue.message_queue import MessageQueue, MessageType, MessagePriority
-from isaac.queue.queue_worker import QueueWorker
+from isaac.queue.command_queue import CommandQueue
+from isaac.queue.sync_worker import SyncWorker
 
 __all__ = [
-    'MessageQueue',
-    'MessageType',
-    'MessagePriority',
-    'QueueWorker',
+    'CommandQueue',
+    'SyncWorker',
 ]
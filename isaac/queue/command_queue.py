@@ -1,36 +1,115 @@
 # isaac/queue/command_queue.py
 
 """
-Command Queue - SQLite-based command persistence for offline resilience.
+Command Queue - Durable command persistence for offline resilience.
 
 Provides atomic queue operations with retry tracking and automatic cleanup.
+Uses the native group-committed log when the C++ core is built, SQLite otherwise.
 """
 
 import json
 import logging
 import sqlite3
+import threading
 from datetime import datetime, timedelta
 from pathlib import Path
 from typing import Dict, List, Optional
 
 logger = logging.getLogger(__name__)
 
+# Optional native queue (C++ core)
+try:
+    from isaac.isaac_core import CommandQueue as NativeCommandQueue
+
+    NATIVE_QUEUE_AVAILABLE = True
+except ImportError:
+    NativeCommandQueue = None
+    NATIVE_QUEUE_AVAILABLE = False
+
 
 class CommandQueue:
-    """Local command queue with SQLite persistence."""
+    """Local command queue with native log or SQLite persistence."""
 
-    def __init__(self, db_path: Path):
+    def __init__(self, db_path: Path, use_native: bool = True):
         """
         Initialize queue manager.
 
         Args:
-            db_path: Path to SQLite database file
+            db_path: Path to SQLite database file; the native log lives beside it
+            use_native: Use the native queue when available
         """
         self.db_path = db_path
         self.db_path.parent.mkdir(parents=True, exist_ok=True)
-        self._init_db()
+        self._wakeup = threading.Event()
+        self._native = None
+
+        if use_native and NATIVE_QUEUE_AVAILABLE:
+            self._native = NativeCommandQueue(str(db_path.with_name(f"{db_path.stem}_log")))
+            if self.db_path.exists():
+                self._migrate_sqlite()
+        else:
+            self._init_db()
         logger.info(f"Command queue initialized at {db_path}")
 
+    def _migrate_sqlite(self):
+        """Move unsynced commands from an existing SQLite queue into the native log."""
+        conn = sqlite3.connect(str(self.db_path))
+        conn.row_factory = sqlite3.Row
+        try:
+            rows = conn.execute(
+                "SELECT * FROM command_queue WHERE status IN ('pending', 'syncing') ORDER BY id"
+            ).fetchall()
+        except sqlite3.DatabaseError:
+            rows = []
+        conn.close()
+
+        for row in rows:
+            self._native.enqueue(
+                row["command_text"], row["command_type"], row["target_device"], row["metadata"] or "{}"
+            )
+        self.db_path.rename(self.db_path.with_name(self.db_path.name + ".migrated"))
+        logger.info(f"Migrated {len(rows)} queued commands to the native queue")
+
+    @staticmethod
+    def _to_row(command) -> Dict:
+        """Native QueuedCommand -> dict in the SQLite row shape"""
+        return {
+            "id": command.id,
+            "queued_at": command.queued_at,
+            "command_type": command.command_type,
+            "command_text": command.command_text,
+            "target_device": command.target_device,
+            "retry_count": command.retry_count,
+            "last_retry_at": command.last_retry_at,
+            "status": command.status,
+            "error_message": command.error_message,
+            "metadata": command.metadata,
+        }
+
+    def wait(self, timeout: float) -> bool:
+        """
+        Block until the next enqueue or notify() call.
+
+        Args:
+            timeout: Maximum seconds to wait
+
+        Returns:
+            True if woken, False on timeout
+        """
+        if self._native is not None:
+            return self._native.wait(int(timeout * 1000))
+
+        woken = self._wakeup.wait(timeout)
+        self._wakeup.clear()
+        return woken
+
+    def notify(self):
+        """Wake a consumer blocked in wait() (e.g. connectivity returned)."""
+        if self._native is not None:
+            self._native.notify()
+        else:
+            self._wakeup.set()
+
     def _init_db(self):
         """Create queue table and indexes if not exists."""
         conn = sqlite3.connect(str(self.db_path))
@@ -74,6 +153,13 @@ class CommandQueue:
         Returns:
             Queue ID for tracking
         """
+        if self._native is not None:
+            queue_id = self._native.enqueue(
+                command, command_type, target_device, json.dumps(metadata or {})
+            )
+            logger.info(f"Queued command #{queue_id}: {command_type} - {command[:50]}...")
+            return queue_id
+
         conn = sqlite3.connect(str(self.db_path))
         cursor = conn.execute(
             """
@@ -94,6 +180,7 @@ class CommandQueue:
             raise RuntimeError("Failed to get queue ID after insert")
         conn.commit()
         conn.close()
+        self._wakeup.set()
 
         logger.info(f"Queued command #{queue_id}: {command_type} - {command[:50]}...")
         return queue_id
@@ -102,12 +189,36 @@ class CommandQueue:
         """
         Get pending commands in FIFO order.
 
+        The native queue claims what it returns (status 'syncing'), so
+        concurrent consumers never receive the same command, whether they
+        share this object or open the same log from another process.
+
+        Args:
+            limit: Maximum commands to retrieve
+
+        Returns:
+            List of command dicts with all fields
+        """
+        if self._native is not None:
+            return [self._to_row(command) for command in self._native.dequeue_pending(limit)]
+        return self.list_pending(limit)
+
+    def list_pending(self, limit: int = 10) -> List[Dict]:
+        """
+        Get pending commands in FIFO order without claiming them.
+
+        For display (/queue, /sync --dry-run); consumers that deliver
+        commands use dequeue_pending().
+
         Args:
             limit: Maximum commands to retrieve
 
         Returns:
             List of command dicts with all fields
         """
+        if self._native is not None:
+            return [self._to_row(command) for command in self._native.list_pending(limit)]
+
         conn = sqlite3.connect(str(self.db_path))
         conn.row_factory = sqlite3.Row
         cursor = conn.execute(
@@ -125,6 +236,10 @@ class CommandQueue:
 
     def mark_syncing(self, queue_id: int):
         """Mark command as currently being synced."""
+        if self._native is not None:
+            self._native.mark_syncing(queue_id)
+            return
+
         conn = sqlite3.connect(str(self.db_path))
         conn.execute(
             """
@@ -139,6 +254,11 @@ class CommandQueue:
 
     def mark_done(self, queue_id: int):
         """Mark command as successfully synced."""
+        if self._native is not None:
+            self._native.mark_done(queue_id)
+            logger.info(f"Command #{queue_id} synced successfully")
+            return
+
         conn = sqlite3.connect(str(self.db_path))
         conn.execute(
             """
@@ -160,6 +280,11 @@ class CommandQueue:
             queue_id: Command to mark
             error: Error message for logging
         """
+        if self._native is not None:
+            self._native.mark_failed(queue_id, error)
+            logger.warning(f"Command #{queue_id} failed: {error}")
+            return
+
         conn = sqlite3.connect(str(self.db_path))
         conn.execute(
             """
@@ -184,6 +309,12 @@ class CommandQueue:
         Args:
             timeout_minutes: How long before considering stuck
         """
+        if self._native is not None:
+            updated = self._native.reset_stale_syncing(timeout_minutes)
+            if updated > 0:
+                logger.warning(f"Reset {updated} stale 'syncing' commands to 'pending'")
+            return
+
         cutoff = (datetime.utcnow() - timedelta(minutes=timeout_minutes)).isoformat()
         conn = sqlite3.connect(str(self.db_path))
         cursor = conn.execute(
@@ -209,6 +340,15 @@ class CommandQueue:
         Returns:
             {pending: int, failed: int, done: int, last_sync: str}
         """
+        if self._native is not None:
+            status = self._native.status()
+            return {
+                "pending": status.pending,
+                "failed": status.failed,
+                "done": status.done,
+                "last_sync": status.last_sync,
+            }
+
         conn = sqlite3.connect(str(self.db_path))
         cursor = conn.execute(
             """
@@ -242,6 +382,12 @@ class CommandQueue:
         Args:
             days: Retention period for 'done' commands
         """
+        if self._native is not None:
+            deleted = self._native.clear_old_entries(days)
+            if deleted > 0:
+                logger.info(f"Cleaned up {deleted} old queue entries")
+            return
+
         cutoff = (datetime.utcnow() - timedelta(days=days)).isoformat()
         conn = sqlite3.connect(str(self.db_path))
         cursor = conn.execute(
@@ -17,6 +17,8 @@ logger = logging.getLogger(__name__)
 class SyncWorker:
     """Background thread that syncs queued commands when cloud is available."""
 
+    BATCH_SIZE = 10
+
     def __init__(self, queue, cloud_client, check_interval: int = 30):
         """
         Initialize sync worker.
@@ -51,10 +53,28 @@ class SyncWorker:
             return
 
         self.running = False
+        self._notify_queue()
         if self._thread:
             self._thread.join(timeout=5)
         logger.info("Sync worker stopped")
 
+    def notify_online(self):
+        """Wake the loop early after a successful cloud call instead of waiting out the backoff."""
+        self._notify_queue()
+
+    def _notify_queue(self):
+        notify = getattr(self.queue, "notify", None)
+        if notify:
+            notify()
+
+    def _wait(self, seconds: float):
+        """Sleep until the timeout, a new enqueue or notify_online() (commands already queued don't count)."""
+        wait = getattr(self.queue, "wait", None)
+        if wait:
+            wait(seconds)
+        else:
+            time.sleep(seconds)
+
     def force_sync(self) -> int:
         """
         Force immediate sync attempt (for /sync command).
@@ -76,11 +96,11 @@ class SyncWorker:
 
                 # Check cloud availability
                 if not self._is_cloud_available():
-                    time.sleep(self.interval)
+                    self._wait(self.interval)
                     continue
 
                 # Attempt batch sync
-                synced_count = self._sync_batch()
+                synced_count = self._sync_batch(self.BATCH_SIZE)
 
                 if synced_count > 0:
                     consecutive_failures = 0  # Reset backoff
@@ -90,13 +110,17 @@ class SyncWorker:
                     if self.on_sync_complete:
                         self.on_sync_complete(synced_count)
 
+                    # A full batch may have more behind it: drain without waiting
+                    if synced_count == self.BATCH_SIZE:
+                        continue
+
             except Exception as e:
                 consecutive_failures += 1
                 logger.error(f"Sync loop error: {e}")
 
             # Exponential backoff on failures (max 5 minutes)
             wait_time = min(self.interval * (2**consecutive_failures), 300)
-            time.sleep(wait_time)
+            self._wait(wait_time)
 
     def _is_cloud_available(self) -> bool:
         """Check if cloud API is reachable."""
@@ -106,7 +130,7 @@ class SyncWorker:
             logger.debug(f"Cloud availability check failed: {e}")
             return False
 
-    def _sync_batch(self, batch_size: int = 10) -> int:
+    def _sync_batch(self, batch_size: int = BATCH_SIZE) -> int:
         """
         Sync up to N pending commands.
 
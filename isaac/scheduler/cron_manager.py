@@ -3,45 +3,153 @@ Background task scheduler for periodic jobs.
 """
 
 import logging
+import random
 import threading
-import time
 from datetime import datetime, timedelta
-from typing import Callable, Dict
+from typing import Any, Callable, Dict, Optional
+
+# Optional native timer-wheel scheduler (C++ core)
+try:
+    from isaac.isaac_core import CronScheduler
+
+    NATIVE_CRON_AVAILABLE = True
+except ImportError:
+    CronScheduler = None
+    NATIVE_CRON_AVAILABLE = False
 
 logger = logging.getLogger(__name__)
 
+CATCH_UP_POLICIES = ("once", "skip", "all")
+MAX_CATCH_UP_RUNS = 100
+
 
 class CronManager:
-    """Simple cron-like scheduler for background tasks."""
+    """Cron-like scheduler for background tasks.
 
-    def __init__(self):
+    With the native core, tasks run on a C++ timer wheel that sleeps until
+    the next deadline, supports cron expressions and fires with millisecond
+    precision. Without it, a Python thread sleeps until the earliest
+    next_run instead of polling, and only interval schedules are available.
+    """
+
+    def __init__(self, use_native: bool = True):
         self.tasks: Dict[str, Dict] = {}
         self.running = False
         self._thread = None
+        self._use_native = use_native and NATIVE_CRON_AVAILABLE
+        self._native = None
+        self._lock = threading.Lock()
+        self._wake = threading.Event()
 
     def register_task(
-        self, name: str, func: Callable, interval_minutes: int, run_immediately: bool = False
+        self,
+        name: str,
+        func: Callable,
+        interval_minutes: Optional[float] = None,
+        run_immediately: bool = False,
+        interval_seconds: Optional[float] = None,
+        cron: Optional[str] = None,
+        jitter_seconds: float = 0.0,
+        catch_up: str = "once",
     ):
         """
         Register periodic task.
 
         Args:
-            name: Unique task name
+            name: Unique task name (re-registering replaces the task)
             func: Callable to execute
             interval_minutes: Run every N minutes
             run_immediately: Run on registration
+            interval_seconds: Run every N seconds (sub-second allowed)
+            cron: Cron expression instead of an interval (native core only)
+            jitter_seconds: Random delay in [0, jitter] added to each run
+            catch_up: Runs missed while late: "once", "skip" or "all"
         """
-        self.tasks[name] = {
+        schedules = [s for s in (interval_minutes, interval_seconds, cron) if s is not None]
+        if len(schedules) != 1:
+            raise ValueError("Give exactly one of interval_minutes, interval_seconds or cron")
+        if catch_up not in CATCH_UP_POLICIES:
+            raise ValueError(f"catch_up must be one of {CATCH_UP_POLICIES}")
+        if jitter_seconds < 0:
+            raise ValueError("jitter_seconds must not be negative")
+        if cron is not None and not self._use_native:
+            raise ValueError("Cron expressions need the native scheduler")
+
+        interval = None
+        if cron is None:
+            seconds = interval_seconds if interval_seconds is not None else interval_minutes * 60
+            if seconds <= 0:
+                raise ValueError("Interval must be positive")
+            interval = timedelta(seconds=seconds)
+
+        now = datetime.now()
+        task = {
             "func": func,
-            "interval": timedelta(minutes=interval_minutes),
-            "last_run": datetime.now() if run_immediately else None,
-            "next_run": (
-                datetime.now()
-                if run_immediately
-                else datetime.now() + timedelta(minutes=interval_minutes)
-            ),
+            "interval": interval,
+            "cron": cron,
+            "jitter": jitter_seconds,
+            "catch_up": catch_up,
+            "run_immediately": run_immediately,
+            "last_run": None,
+            "next_run": now if run_immediately or interval is None else now + interval,
+            "nominal_run": None,
+            "runs": 0,
+            "failures": 0,
+            "missed": 0,
+        }
+
+        with self._lock:
+            if self._native is not None:
+                self._add_native(name, task)
+            self.tasks[name] = task
+        self._wake.set()
+
+        schedule = cron if cron is not None else f"every {interval.total_seconds():g}s"
+        logger.info(f"Registered task: {name} ({schedule})")
+
+    def unregister_task(self, name: str) -> bool:
+        """Remove a task; returns False if it was not registered."""
+        with self._lock:
+            if self.tasks.pop(name, None) is None:
+                return False
+            if self._native is not None:
+                self._native.remove(name)
+        self._wake.set()
+        return True
+
+    def get_task_info(self, name: str) -> Optional[Dict[str, Any]]:
+        """Run counters and timing for a task, or None if unknown."""
+        with self._lock:
+            task = self.tasks.get(name)
+            if task is None:
+                return None
+            native = self._native.info(name) if self._native is not None else None
+
+        if native is not None:
+            return {
+                "name": name,
+                "schedule": native.schedule,
+                "runs": native.runs,
+                "failures": native.failures,
+                "missed": native.missed,
+                "skipped": native.skipped,
+                "running": native.running,
+                "last_run": datetime.fromtimestamp(native.last_run) if native.last_run else None,
+                "next_run": datetime.fromtimestamp(native.next_run) if native.next_run else None,
+                "last_error": native.last_error or None,
+            }
+        return {
+            "name": name,
+            "schedule": task["cron"] or f"every {task['interval'].total_seconds():g}s",
+            "runs": task["runs"],
+            "failures": task["failures"],
+            "missed": task["missed"],
+            "skipped": 0,
+            "running": False,
+            "last_run": task["last_run"],
+            "next_run": task["next_run"],
+            "last_error": task.get("last_error"),
         }
-        logger.info(f"Registered task: {name} (every {interval_minutes}m)")
 
     def start(self):
         """Start scheduler thread."""
@@ -49,6 +157,18 @@ class CronManager:
             return
 
         self.running = True
+        if self._use_native:
+            with self._lock:
+                self._native = CronScheduler()
+                for name, task in self.tasks.items():
+                    try:
+                        self._add_native(name, task)
+                    except ValueError as e:
+                        logger.error(f"Task {name} not scheduled: {e}")
+            logger.info("Cron manager started (native)")
+            return
+
+        self._wake.clear()
         self._thread = threading.Thread(target=self._run_loop, daemon=True)
         self._thread.start()
         logger.info("Cron manager started")
@@ -56,24 +176,84 @@ class CronManager:
     def stop(self):
         """Stop scheduler gracefully."""
         self.running = False
+        if self._native is not None:
+            self._native.stop()
+            with self._lock:
+                self._native = None
+        self._wake.set()
         if self._thread:
             self._thread.join(timeout=5)
+            self._thread = None
         logger.info("Cron manager stopped")
 
+    def _add_native(self, name: str, task: Dict):
+        """Hand a task to the native scheduler (lock held)."""
+        func = task["func"]
+
+        def job():
+            try:
+                func()
+            except Exception as e:
+                logger.error(f"Task {name} failed: {e}")
+                raise
+
+        options = {
+            "jitter_ms": int(task["jitter"] * 1000),
+            "catch_up": task["catch_up"],
+            "run_immediately": task["run_immediately"],
+        }
+        if task["cron"] is not None:
+            self._native.add_cron(name, task["cron"], job, **options)
+        else:
+            interval_ms = max(1, int(task["interval"].total_seconds() * 1000))
+            self._native.add_interval(name, interval_ms, job, **options)
+
     def _run_loop(self):
-        """Main scheduler loop."""
+        """Fallback scheduler loop: run due tasks, then sleep until the next one."""
         while self.running:
             now = datetime.now()
+            with self._lock:
+                due = [
+                    (name, task, self._advance(task, now))
+                    for name, task in self.tasks.items()
+                    if now >= task["next_run"]
+                ]
 
-            for task_name, task in self.tasks.items():
-                if now >= task["next_run"]:
-                    try:
-                        logger.debug(f"Running task: {task_name}")
-                        task["func"]()
-                        task["last_run"] = now
-                        task["next_run"] = now + task["interval"]
-                    except Exception as e:
-                        logger.error(f"Task {task_name} failed: {e}")
-
-            # Check every 60 seconds
-            time.sleep(60)
+            for name, task, runs in due:
+                for _ in range(runs):
+                    self._run_task(name, task, now)
+
+            with self._lock:
+                next_run = min((task["next_run"] for task in self.tasks.values()), default=None)
+            timeout = None if next_run is None else max(0.0, (next_run - datetime.now()).total_seconds())
+            self._wake.wait(timeout)
+            self._wake.clear()
+
+    def _advance(self, task: Dict, now: datetime) -> int:
+        """Move next_run past now on the task's grid; returns the runs owed."""
+        interval = task["interval"]
+        nominal = task["nominal_run"] or task["next_run"]
+        missed = max(0, int((now - nominal) / interval))
+        task["missed"] += missed
+        task["nominal_run"] = nominal + interval * (missed + 1)
+        task["next_run"] = task["nominal_run"]
+        if task["jitter"]:
+            # Jitter delays single runs without shifting the grid
+            task["next_run"] += timedelta(seconds=random.uniform(0, task["jitter"]))
+
+        if missed and task["catch_up"] == "skip":
+            return 0
+        if missed and task["catch_up"] == "all":
+            return min(missed + 1, MAX_CATCH_UP_RUNS)
+        return 1
+
+    def _run_task(self, name: str, task: Dict, now: datetime):
+        try:
+            logger.debug(f"Running task: {name}")
+            task["func"]()
+            task["runs"] += 1
+        except Exception as e:
+            task["failures"] += 1
+            task["last_error"] = str(e)
+            logger.error(f"Task {name} failed: {e}")
+        task["last_run"] = now
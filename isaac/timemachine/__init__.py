@@ -5,10 +5,8 @@ Provides time-travel debugging and workspace state snapshots for
 rolling back changes and exploring history.
 """
 
-from isaac.timemachine.snapshot_manager import SnapshotManager
 from isaac.timemachine.time_machine import TimeMachine
 
 __all__ = [
     'TimeMachine',
-    'SnapshotManager',
 ]
@@ -4,15 +4,29 @@ Isaac's temporal workspace management system
 """
 
 import json
+import os
+import re
 import threading
 import time
 from dataclasses import dataclass, field
-from datetime import datetime
+from datetime import datetime, timedelta
 from pathlib import Path
-from typing import Any, Dict, List, Optional
+from typing import Any, Dict, List, Optional, Union
 
 from isaac.bubbles.manager import BubbleManager, WorkspaceState
 
+# Optional native timeline index (C++ core)
+try:
+    from isaac.isaac_core import TimelineIndex, TimelineRecord
+
+    NATIVE_TIMELINE_AVAILABLE = True
+except ImportError:
+    TimelineIndex = None
+    TimelineRecord = None
+    NATIVE_TIMELINE_AVAILABLE = False
+
+_AGO_UNITS = {"s": 1, "m": 60, "h": 3600, "d": 86400, "w": 604800}
+
 
 @dataclass
 class TimelineEntry:
@@ -35,7 +49,17 @@ class TimelineSnapshot:
 
 
 class TimeMachine:
-    """Manages automatic snapshots and timeline navigation."""
+    """Manages automatic snapshots and timeline navigation.
+
+    The timeline is an append-only JSON Lines file: each new entry is one
+    line, and trimming old snapshots appends a {"drop": n} marker instead of
+    rewriting the file. The file is rewritten only once it holds twice as
+    many lines as the timeline keeps.
+
+    When the C++ core is built, a TimelineIndex mirrors the entries so
+    point-in-time lookups, branch queries and text search never scan the
+    timeline or load bubbles until results are chosen.
+    """
 
     def __init__(self, bubble_manager: BubbleManager, storage_path: Optional[Path] = None):
         """Initialize time machine.
@@ -54,14 +78,20 @@ class TimeMachine:
         self.storage_path = storage_path
         self.storage_path.mkdir(exist_ok=True)
 
-        # Timeline data
-        self.timeline_file = self.storage_path / "timeline.json"
-        self.timeline = self._load_timeline()
-
         # Auto-snapshot settings
         self.auto_snapshot_enabled = True
         self.snapshot_interval_minutes = 30  # Every 30 minutes
         self.max_snapshots = 100  # Keep last 100 snapshots
+
+        # Timeline data
+        self.timeline_file = self.storage_path / "timeline.jsonl"
+        self._timeline_lock = threading.Lock()
+        self._timeline_lines = 0
+        self._index = TimelineIndex() if NATIVE_TIMELINE_AVAILABLE else None
+        self.timeline = self._load_timeline()
+        if self._index is not None:
+            for entry in self.timeline.entries:
+                self._index.append(self._index_record(entry))
         self.min_snapshot_interval_seconds = 300  # Minimum 5 minutes between snapshots
 
         # Background thread for auto-snapshots
@@ -76,40 +106,85 @@ class TimeMachine:
             self._start_auto_snapshot()
 
     def _load_timeline(self) -> TimelineSnapshot:
-        """Load timeline from disk."""
+        """Load timeline from disk, converting a timeline.json from older versions."""
+        entries: List[TimelineEntry] = []
         if self.timeline_file.exists():
             try:
                 with open(self.timeline_file, "r") as f:
-                    data = json.load(f)
-
-                entries = []
-                for entry_data in data.get("entries", []):
-                    entry = TimelineEntry(**entry_data)
-                    entries.append(entry)
-
-                return TimelineSnapshot(
-                    entries=entries,
-                    current_index=data.get("current_index", -1),
-                    total_entries=len(entries),
-                )
+                    for line in f:
+                        self._timeline_lines += 1
+                        try:
+                            record = json.loads(line)
+                            if "drop" in record:
+                                del entries[: record["drop"]]
+                            else:
+                                entries.append(TimelineEntry(**record))
+                        except (ValueError, TypeError):
+                            continue  # torn last line
             except Exception:
-                pass
+                entries = []
+        else:
+            legacy_file = self.storage_path / "timeline.json"
+            if legacy_file.exists():
+                try:
+                    with open(legacy_file, "r") as f:
+                        data = json.load(f)
+                    entries = [TimelineEntry(**entry) for entry in data.get("entries", [])]
+                    self._rewrite_timeline(entries)
+                    legacy_file.rename(legacy_file.with_name(legacy_file.name + ".migrated"))
+                except Exception:
+                    entries = []
+
+        # Every change appends and points at the newest entry
+        return TimelineSnapshot(
+            entries=entries, current_index=len(entries) - 1, total_entries=len(entries)
+        )
 
-        return TimelineSnapshot()
+    @staticmethod
+    def _index_record(entry: TimelineEntry):
+        """Build the native index record for a timeline entry."""
+        metadata = entry.metadata or {}
+        return TimelineRecord(
+            timestamp=entry.timestamp,
+            bubble_id=entry.bubble_id,
+            change_type=entry.change_type,
+            description=f"{entry.description} {metadata.get('bubble_name', '')}",
+            branch=metadata.get("git_branch") or "",
+            path=metadata.get("workspace_path") or "",
+            tags=list(metadata.get("tags", [])),
+        )
 
-    def _save_timeline(self) -> None:
-        """Save timeline to disk."""
-        data = {
-            "entries": [entry.__dict__ for entry in self.timeline.entries],
-            "current_index": self.timeline.current_index,
-            "total_entries": self.timeline.total_entries,
-        }
+    def _add_entry(self, entry: TimelineEntry) -> None:
+        """Append an entry to the timeline, its index and its file."""
+        self.timeline.entries.append(entry)
+        self.timeline.total_entries += 1
+        self.timeline.current_index = len(self.timeline.entries) - 1
+        if self._index is not None:
+            self._index.append(self._index_record(entry))
+        self._append_timeline(entry.__dict__)
 
-        try:
-            with open(self.timeline_file, "w") as f:
-                json.dump(data, f, indent=2)
-        except Exception:
-            pass
+    def _append_timeline(self, record: Dict[str, Any]) -> None:
+        """Append one entry or drop marker to the timeline file."""
+        with self._timeline_lock:
+            try:
+                if self._timeline_lines >= 2 * self.max_snapshots:
+                    # The in-memory timeline already includes the record
+                    self._rewrite_timeline(self.timeline.entries)
+                    return
+                with open(self.timeline_file, "a") as f:
+                    f.write(json.dumps(record) + "\n")
+                self._timeline_lines += 1
+            except Exception:
+                pass
+
+    def _rewrite_timeline(self, entries: List[TimelineEntry]) -> None:
+        """Replace the timeline file with just the live entries."""
+        temp_file = self.timeline_file.with_name(self.timeline_file.name + ".tmp")
+        with open(temp_file, "w") as f:
+            for entry in entries:
+                f.write(json.dumps(entry.__dict__) + "\n")
+        os.replace(temp_file, self.timeline_file)
+        self._timeline_lines = len(entries)
 
     def create_snapshot(
         self, description: str = "", change_type: str = "manual", force: bool = False
@@ -156,16 +231,11 @@ class TimeMachine:
             },
         )
 
-        self.timeline.entries.append(entry)
-        self.timeline.total_entries += 1
-        self.timeline.current_index = len(self.timeline.entries) - 1
+        self._add_entry(entry)
 
         # Clean up old snapshots if we exceed max
         self._cleanup_old_snapshots()
 
-        # Save timeline
-        self._save_timeline()
-
         # Update last snapshot time
         self.last_snapshot_time = current_time
 
@@ -187,6 +257,8 @@ class TimeMachine:
         # Remove from timeline
         self.timeline.entries = self.timeline.entries[entries_to_remove:]
         self.timeline.total_entries = len(self.timeline.entries)
+        if self._index is not None:
+            self._index.drop_front(entries_to_remove)
 
         # Adjust current index
         if self.timeline.current_index >= entries_to_remove:
@@ -194,6 +266,8 @@ class TimeMachine:
         else:
             self.timeline.current_index = -1
 
+        self._append_timeline({"drop": entries_to_remove})
+
     def get_timeline(self, limit: int = 50) -> List[TimelineEntry]:
         """Get timeline entries.
 
@@ -205,22 +279,16 @@ class TimeMachine:
         """
         return list(reversed(self.timeline.entries[-limit:]))
 
-    def restore_to_timestamp(self, target_timestamp: float) -> bool:
+    def restore_to_timestamp(self, target_timestamp: Union[float, datetime, str]) -> bool:
         """Restore workspace to a specific timestamp.
 
         Args:
-            target_timestamp: Unix timestamp to restore to
+            target_timestamp: Unix timestamp to restore to, or any time parse_time accepts
 
         Returns:
             True if restoration successful
         """
-        # Find the closest snapshot before or at the target timestamp
-        closest_entry = None
-        for entry in reversed(self.timeline.entries):
-            if entry.timestamp <= target_timestamp:
-                closest_entry = entry
-                break
-
+        closest_entry = self.state_at(target_timestamp)
         if not closest_entry:
             return False
 
@@ -237,13 +305,104 @@ class TimeMachine:
                 metadata={"restored_from": closest_entry.timestamp},
             )
 
-            self.timeline.entries.append(restore_entry)
-            self.timeline.total_entries += 1
-            self.timeline.current_index = len(self.timeline.entries) - 1
-            self._save_timeline()
+            self._add_entry(restore_entry)
 
         return success
 
+    def state_at(self, when: Union[float, datetime, str]) -> Optional[TimelineEntry]:
+        """Find the snapshot the workspace was in at a point in time.
+
+        Args:
+            when: Unix timestamp, datetime, or a string parse_time accepts
+                (e.g. "14:32 yesterday", "2h ago", "2024-01-01 12:00")
+
+        Returns:
+            Closest entry at or before that time, or None
+        """
+        target = self.parse_time(when)
+        if self._index is not None:
+            position = self._index.at_or_before(target)
+            return self.timeline.entries[position] if position is not None else None
+
+        for entry in reversed(self.timeline.entries):
+            if entry.timestamp <= target:
+                return entry
+        return None
+
+    def last_snapshot_on_branch(
+        self, branch: str, before: Optional[Union[float, datetime, str]] = None
+    ) -> Optional[TimelineEntry]:
+        """Find the newest entry taken on a git branch.
+
+        Args:
+            branch: Branch name
+            before: Only consider entries at or before this time
+
+        Returns:
+            Matching entry or None
+        """
+        limit = self.parse_time(before) if before is not None else float("inf")
+        if self._index is not None:
+            position = self._index.last_with("branch", branch, limit)
+            return self.timeline.entries[position] if position is not None else None
+
+        for entry in reversed(self.timeline.entries):
+            if entry.metadata.get("git_branch") == branch and entry.timestamp <= limit:
+                return entry
+        return None
+
+    @staticmethod
+    def parse_time(when: Union[float, datetime, str], now: Optional[datetime] = None) -> float:
+        """Turn a time specification into a Unix timestamp.
+
+        Accepts timestamps, datetimes, ISO dates ("2024-01-01 12:00:00"),
+        clock times with an optional day ("14:32", "14:32 yesterday",
+        "yesterday 9:05"), "now", and relative times ("90m ago", "2 days ago").
+
+        Raises:
+            ValueError: If the specification is not understood
+        """
+        if isinstance(when, datetime):
+            return when.timestamp()
+        if isinstance(when, (int, float)):
+            return float(when)
+
+        spec = when.strip().lower()
+        now = now or datetime.now()
+        try:
+            return float(spec)
+        except ValueError:
+            pass
+        try:
+            return datetime.fromisoformat(spec).timestamp()
+        except ValueError:
+            pass
+        if spec == "now":
+            return now.timestamp()
+
+        match = re.fullmatch(r"(\d+(?:\.\d+)?)\s*([smhdw])[a-z]*\s+ago", spec)
+        if match:
+            return now.timestamp() - float(match.group(1)) * _AGO_UNITS[match.group(2)]
+
+        day = now
+        words = spec.split()
+        for word, offset in (("today", 0), ("yesterday", 1)):
+            if word in words:
+                words.remove(word)
+                day = now - timedelta(days=offset)
+        if len(words) > 1:
+            raise ValueError(f"Unrecognized time: {when}")
+        clock = words[0] if words else "00:00"
+        for layout in ("%H:%M:%S", "%H:%M"):
+            try:
+                parsed = datetime.strptime(clock, layout)
+            except ValueError:
+                continue
+            return day.replace(
+                hour=parsed.hour, minute=parsed.minute, second=parsed.second, microsecond=0
+            ).timestamp()
+        raise ValueError(f"Unrecognized time: {when}")
+
     def restore_to_entry(self, entry_index: int) -> bool:
         """Restore to a specific timeline entry.
 
@@ -271,10 +430,7 @@ class TimeMachine:
                 metadata={"restored_entry_index": entry_index},
             )
 
-            self.timeline.entries.append(restore_entry)
-            self.timeline.total_entries += 1
-            self.timeline.current_index = len(self.timeline.entries) - 1
-            self._save_timeline()
+            self._add_entry(restore_entry)
 
         return success
 
@@ -307,30 +463,54 @@ class TimeMachine:
             ),
         }
 
-    def search_timeline(self, query: str, limit: int = 20) -> List[Dict[str, Any]]:
+    def search_timeline(
+        self,
+        query: str,
+        limit: int = 20,
+        since: Optional[Union[float, datetime, str]] = None,
+        until: Optional[Union[float, datetime, str]] = None,
+    ) -> List[Dict[str, Any]]:
         """Search timeline for entries matching query.
 
+        With the native index every query word must start a word of the
+        description, change type, bubble name, branch or path; otherwise the
+        query is a substring of the description, change type and bubble name.
+
         Args:
             query: Search query (case-insensitive)
             limit: Maximum results to return
+            since: Only entries at or after this time
+            until: Only entries at or before this time
 
         Returns:
-            List of matching timeline entries with bubble info
+            List of matching timeline entries with bubble info (newest first)
         """
-        results = []
-        query_lower = query.lower()
-
-        for entry in reversed(self.timeline.entries):
-            # Search in description, change_type, and bubble name
-            searchable_text = f"{entry.description} {entry.change_type} {entry.metadata.get('bubble_name', '')}".lower()
+        start = self.parse_time(since) if since is not None else float("-inf")
+        end = self.parse_time(until) if until is not None else float("inf")
 
-            if query_lower in searchable_text:
-                bubble_info = self.get_snapshot_info(entry.bubble_id)
-                if bubble_info:
-                    results.append({"entry": entry, "bubble_info": bubble_info})
+        if self._index is not None:
+            candidates = (
+                self.timeline.entries[position]
+                for position in self._index.search(query, 0, start, end)
+            )
+        else:
+            query_lower = query.lower()
+            candidates = (
+                entry
+                for entry in reversed(self.timeline.entries)
+                if start <= entry.timestamp <= end
+                and query_lower
+                in f"{entry.description} {entry.change_type} {entry.metadata.get('bubble_name', '')}".lower()
+            )
 
-                    if len(results) >= limit:
-                        break
+        results = []
+        for entry in candidates:
+            # Bubbles are only loaded for the entries returned
+            bubble_info = self.get_snapshot_info(entry.bubble_id)
+            if bubble_info:
+                results.append({"entry": entry, "bubble_info": bubble_info})
+                if len(results) >= limit:
+                    break
 
         return results
 
@@ -348,7 +528,7 @@ class TimeMachine:
         for entry in self.timeline.entries:
             change_types[entry.change_type] = change_types.get(entry.change_type, 0) + 1
 
-        return {
+        stats = {
             "total_snapshots": len(self.timeline.entries),
             "oldest": datetime.fromtimestamp(oldest).isoformat(),
             "newest": datetime.fromtimestamp(newest).isoformat(),
@@ -357,6 +537,10 @@ class TimeMachine:
             "auto_snapshots": change_types.get("auto", 0),
             "manual_snapshots": change_types.get("manual", 0),
         }
+        storage = self.bubble_manager.storage_stats()
+        if storage:
+            stats["storage"] = storage
+        return stats
 
     def _start_auto_snapshot(self) -> None:
         """Start automatic snapshot background thread."""
@@ -4,7 +4,7 @@ Isaac Tools - File operation tools for AI-driven coding
 
 from .base import BaseTool
 from .code_search import GlobTool, GrepTool
-from .file_ops import EditTool, ReadTool, WriteTool
+from .file_ops import EditTool, ReadTool, WriteTool, flush_edits
 from .shell_exec import ShellTool
 
 __all__ = [
@@ -15,4 +15,5 @@ __all__ = [
     "GrepTool",
     "GlobTool",
     "ShellTool",
+    "flush_edits",
 ]
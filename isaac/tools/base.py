@@ -10,6 +10,10 @@ from typing import Any, Dict
 class BaseTool(ABC):
     """Base class for all Isaac tools"""
 
+    # True for tools that read and edit files through the shared native edit
+    # buffers (file_ops); dispatchers flush pending edits before any other tool
+    shares_edit_buffers = False
+
     @property
     @abstractmethod
     def name(self) -> str:
@@ -3,16 +3,79 @@ File Operation Tools - Read, Write, Edit
 Cross-platform file tools using pathlib with intelligent features
 """
 
+import atexit
 import re
 from pathlib import Path
 from typing import Any, Dict
 
 from .base import BaseTool
 
+# Optional native edit buffers (C++ core), shared by the tools below
+try:
+    from isaac.isaac_core import EditBufferCache
+
+    _BUFFER_CACHE = EditBufferCache()
+except ImportError:
+    _BUFFER_CACHE = None
+
+
+def flush_edits() -> None:
+    """
+    Write edits held in the native buffers back to disk.
+
+    Edit and search_replace change the buffers only, so a turn's edits to a
+    file cost one write. Call this at the end of a turn and before anything
+    that reads files from disk rather than through the buffers (tools with
+    shares_edit_buffers = False, subprocesses). Raises RuntimeError naming
+    the files that could not be written; their edits are dropped.
+    """
+    if _BUFFER_CACHE is not None:
+        _BUFFER_CACHE.flush_all()
+
+
+# Commands that run a single tool and exit still save their edits
+atexit.register(flush_edits)
+
+
+def _open_buffer(path: Path):
+    """Cached native buffer for path, or None when the plain Python path should handle it"""
+    if _BUFFER_CACHE is None:
+        return None
+    try:
+        buffer = _BUFFER_CACHE.open(str(path))
+    except RuntimeError:
+        return None
+    # Text-mode reads translate \r\n and reject invalid UTF-8; keep those files on that path
+    if not buffer.valid_utf8() or buffer.has_carriage_returns():
+        if buffer.dirty():
+            _flush_buffer(buffer)  # an edit added \r; the Python path reads the file
+        return None
+    return buffer
+
+
+def _flush_buffer(buffer) -> None:
+    """Write a buffer back, dropping it from the cache if the write fails"""
+    try:
+        buffer.flush()
+    except RuntimeError:
+        _BUFFER_CACHE.evict(buffer.path())
+        raise
+
+
+def _split_lines(text: str) -> list:
+    """Split on \n only, keeping line endings (like readlines)"""
+    lines = [line + "\n" for line in text.split("\n")]
+    lines[-1] = lines[-1][:-1]
+    if not lines[-1]:
+        lines.pop()
+    return lines
+
 
 class ReadTool(BaseTool):
     """Read files with intelligent features - cross-platform"""
 
+    shares_edit_buffers = True
+
     @property
     def name(self) -> str:
         return "read"
@@ -120,10 +183,21 @@ class ReadTool(BaseTool):
 
         # Read file (handles line endings automatically)
         try:
-            with open(path, "r", encoding="utf-8", errors="replace") as f:
-                all_lines = f.readlines()
+            buffer = _open_buffer(path)
+            if buffer is not None:
+                # Only the requested line ranges leave the cached buffer
+                total_lines = buffer.line_count()
 
-            total_lines = len(all_lines)
+                def read_lines(start, end):
+                    return _split_lines(buffer.lines(start - 1, end))
+
+            else:
+                with open(path, "r", encoding="utf-8", errors="replace") as f:
+                    all_lines = f.readlines()
+                total_lines = len(all_lines)
+
+                def read_lines(start, end):
+                    return all_lines[start - 1 : end]  # Convert to 0-indexed
 
             # Determine which lines to read
             if focus_lines:
@@ -156,7 +230,7 @@ class ReadTool(BaseTool):
             # Extract lines from ranges
             selected_lines = []
             for start, end in line_ranges:
-                selected_lines.extend(all_lines[start - 1 : end])  # Convert to 0-indexed
+                selected_lines.extend(read_lines(start, end))
 
             # Apply max_lines limit
             if max_lines > 0 and len(selected_lines) > max_lines:
@@ -258,6 +332,8 @@ class ReadTool(BaseTool):
 class SearchReplaceTool(BaseTool):
     """Advanced search and replace with regex support - cross-platform"""
 
+    shares_edit_buffers = True
+
     @property
     def name(self) -> str:
         return "search_replace"
@@ -357,10 +433,6 @@ class SearchReplaceTool(BaseTool):
             return {"success": False, "error": f"Not a file: {file_path}"}
 
         try:
-            # Read file
-            with open(path, "r", encoding="utf-8") as f:
-                content = f.read()
-
             # Compile search pattern
             flags = 0 if case_sensitive else re.IGNORECASE
             if regex:
@@ -373,13 +445,49 @@ class SearchReplaceTool(BaseTool):
                 escaped_pattern = re.escape(pattern)
                 search_pattern = re.compile(escaped_pattern, flags)
 
+            # Read file; a plain one-line literal is found inside the buffer instead
+            buffer = _open_buffer(path)
+            in_place = (
+                buffer is not None
+                and not regex
+                and case_sensitive
+                and pattern.splitlines() == [pattern]
+            )
+            if in_place:
+                lines = []
+            elif buffer is not None:
+                lines = buffer.text().splitlines(keepends=True)
+            else:
+                with open(path, "r", encoding="utf-8") as f:
+                    lines = f.read().splitlines(keepends=True)
+
             # Find all matches with context
-            lines = content.splitlines(keepends=True)
             matches = []
+            # (offset, length, replacement text) per match, in bytes for the native
+            # buffer and in characters otherwise
+            edits = []
+            line_offset = 0
+
+            if in_place:
+                matches, edits = self._find_in_buffer(
+                    buffer, search_pattern, pattern, replacement, context_lines
+                )
 
             for i, line in enumerate(lines):
                 line_matches = list(search_pattern.finditer(line))
                 for match in line_matches:
+                    if buffer is not None:
+                        edits.append(
+                            (
+                                line_offset + len(line[: match.start()].encode("utf-8")),
+                                len(match.group().encode("utf-8")),
+                                match.expand(replacement),
+                            )
+                        )
+                    else:
+                        edits.append(
+                            (line_offset + match.start(), len(match.group()), match.expand(replacement))
+                        )
                     match_info = {
                         "line_number": i + 1,
                         "start_col": match.start(),
@@ -390,6 +498,7 @@ class SearchReplaceTool(BaseTool):
                         "context_after": lines[i + 1 : i + 1 + context_lines],
                     }
                     matches.append(match_info)
+                line_offset += len(line.encode("utf-8")) if buffer is not None else len(line)
 
             if not matches:
                 return {
@@ -416,19 +525,29 @@ class SearchReplaceTool(BaseTool):
 
             preview_text = "\n".join(preview_lines)
 
-            # Apply replacements if not preview mode
+            # Apply replacements if not preview mode: exactly the previewed
+            # per-line matches on either path
             replacements = 0
             if not preview:
-                if replace_all:
-                    new_content = search_pattern.sub(replacement, content)
-                    replacements = len(matches)
+                applied = edits if replace_all else edits[:1]
+                if buffer is not None:
+                    # Back to front so offsets stay valid
+                    for offset, length, text in reversed(applied):
+                        buffer.replace(offset, length, text)
                 else:
-                    new_content = search_pattern.sub(replacement, content, count=1)
-                    replacements = 1
-
-                # Write back
-                with open(path, "w", encoding="utf-8") as f:
-                    f.write(new_content)
+                    content = "".join(lines)
+                    parts = []
+                    pos = 0
+                    for offset, length, text in applied:
+                        parts.append(content[pos:offset])
+                        parts.append(text)
+                        pos = offset + length
+                    parts.append(content[pos:])
+
+                    # Write back
+                    with open(path, "w", encoding="utf-8") as f:
+                        f.write("".join(parts))
+                replacements = len(applied)
 
             return {
                 "success": True,
@@ -448,6 +567,33 @@ class SearchReplaceTool(BaseTool):
         except Exception as e:
             return {"success": False, "error": f"Error in search/replace: {e}"}
 
+    @staticmethod
+    def _find_in_buffer(buffer, search_pattern, pattern: str, replacement: str, context_lines: int):
+        """Matches and byte-offset edits of a one-line literal, without reading the whole buffer"""
+        matches = []
+        edits = []
+        length = len(pattern.encode("utf-8"))
+        expanded = None
+        for offset in buffer.find_all(pattern):
+            if expanded is None:
+                expanded = search_pattern.match(pattern).expand(replacement)
+            i = buffer.line_of(offset)
+            line_start = buffer.line_offset(i)
+            start_col = len(buffer.substr(line_start, offset - line_start))
+            edits.append((offset, length, expanded))
+            matches.append(
+                {
+                    "line_number": i + 1,
+                    "start_col": start_col,
+                    "end_col": start_col + len(pattern),
+                    "matched_text": pattern,
+                    "line_content": buffer.lines(i, i + 1).rstrip("\n\r"),
+                    "context_before": _split_lines(buffer.lines(max(0, i - context_lines), i)),
+                    "context_after": _split_lines(buffer.lines(i + 1, i + 1 + context_lines)),
+                }
+            )
+        return matches, edits
+
 
 class WriteTool(BaseTool):
     """Write new files - cross-platform"""
@@ -532,6 +678,8 @@ class WriteTool(BaseTool):
 class EditTool(BaseTool):
     """Edit files with exact string replacement - cross-platform"""
 
+    shares_edit_buffers = True
+
     @property
     def name(self) -> str:
         return "edit"
@@ -604,12 +752,16 @@ class EditTool(BaseTool):
             return {"success": False, "error": f"Not a file: {file_path}"}
 
         try:
-            # Read entire file
-            with open(path, "r", encoding="utf-8") as f:
-                original_content = f.read()
+            buffer = _open_buffer(path) if old_string else None
+            if buffer is not None:
+                occurrences = len(buffer.find_all(old_string))
+            else:
+                # Read entire file
+                with open(path, "r", encoding="utf-8") as f:
+                    original_content = f.read()
 
-            # Count occurrences
-            occurrences = original_content.count(old_string)
+                # Count occurrences
+                occurrences = original_content.count(old_string)
 
             if occurrences == 0:
                 return {
@@ -625,16 +777,19 @@ class EditTool(BaseTool):
                 }
 
             # Perform replacement
-            if replace_all:
-                new_content = original_content.replace(old_string, new_string)
-                replacements = occurrences
+            if buffer is not None:
+                replacements = buffer.replace_all(old_string, new_string, 0 if replace_all else 1)
             else:
-                new_content = original_content.replace(old_string, new_string, 1)
-                replacements = 1
+                if replace_all:
+                    new_content = original_content.replace(old_string, new_string)
+                    replacements = occurrences
+                else:
+                    new_content = original_content.replace(old_string, new_string, 1)
+                    replacements = 1
 
-            # Write back (preserve original line endings)
-            with open(path, "w", encoding="utf-8") as f:
-                f.write(new_content)
+                # Write back (preserve original line endings)
+                with open(path, "w", encoding="utf-8") as f:
+                    f.write(new_content)
 
             return {
                 "success": True,
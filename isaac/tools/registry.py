@@ -10,6 +10,7 @@ from pathlib import Path
 from typing import Any, Dict, List, Optional, Type
 
 from .base import BaseTool
+from .file_ops import flush_edits
 
 
 class ToolRegistry:
@@ -160,6 +161,8 @@ class ToolRegistry:
 
         tool = self.tool_instances[tool_name]
         try:
+            if not tool.shares_edit_buffers:
+                flush_edits()
             result = tool.execute(**args)
             # Validate result format
             if not tool.validate_result(result):
@@ -16,6 +16,7 @@ from isaac.adapters.bash_adapter import BashAdapter
 from isaac.adapters.powershell_adapter import PowerShellAdapter
 from isaac.core.command_router import CommandRouter
 from isaac.core.message_queue import MessageQueue
+from isaac.core.performance_manager import start_metrics_export
 from isaac.core.session_manager import SessionManager
 from isaac.monitoring.monitor_manager import MonitorManager
 from isaac.ui.inline_suggestions import (
@@ -34,6 +35,8 @@ class PermanentShell:
         self.session = SessionManager()
         self.shell = self._detect_shell()
         self.router = CommandRouter(self.session, self.shell)
+        # Router and core latencies, exported for /status metrics
+        start_metrics_export()
         self.message_queue = MessageQueue()
         self.monitor_manager = MonitorManager()
 
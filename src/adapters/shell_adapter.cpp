@@ -1,6 +1,10 @@
 #include "shell_adapter.hpp"
 #include <array>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -17,13 +21,82 @@
 #define pclose _pclose
 #else
 #include <unistd.h>
+#include <poll.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
 #include <signal.h>
 #endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#ifndef _WIN32
+extern char** environ;
+#endif
 
 namespace isaac {
 
-ShellAdapter::ShellAdapter() {
+#ifndef _WIN32
+namespace {
+
+bool make_pipe(int fds[2]) {
+#ifdef __linux__
+    return ::pipe2(fds, O_CLOEXEC) == 0;
+#else
+    if (::pipe(fds) != 0) return false;
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+
+double seconds_of(const timeval& tv) {
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+#ifdef __linux__
+// Counter on pid and, through inherit, everything it forks after exec.
+// Disabled until the exec so the fork/handshake is not counted.
+int perf_open(uint32_t type, uint64_t config, pid_t pid) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.enable_on_exec = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+        // perf_event_paranoid >= 2 only allows user-space counts
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+    return fd;
+}
+
+// Reads a counter, scaled up for any time it was multiplexed off the PMU;
+// false if it never ran
+bool perf_read(int fd, uint64_t& value) {
+    uint64_t data[3];   // value, time enabled, time running
+    if (fd < 0 || ::read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+        return false;
+    }
+    value = data[2] < data[1] ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]) : data[0];
+    return true;
+}
+#endif
+
+} // namespace
+#endif
+
+ShellAdapter::ShellAdapter()
+    : latency_(MetricsRegistry::global().histogram("shell.execute")),
+      failures_(MetricsRegistry::global().counter("shell.failures")) {
 #ifdef _WIN32
     // Windows-specific initialization
     detect_shell_type();
@@ -40,11 +113,29 @@ CommandResult ShellAdapter::execute(const std::string& command) {
 }
 
 CommandResult ShellAdapter::execute_with_timeout(const std::string& command, int timeout_seconds) {
+    ScopedLatency timer(latency_);
 #ifdef _WIN32
-    return execute_windows(command, timeout_seconds);
+    CommandResult result = execute_windows(command, timeout_seconds);
 #else
-    return execute_unix(command, timeout_seconds);
+    CommandResult result = execute_unix(command, timeout_seconds);
 #endif
+    if (!result.success) {
+        failures_.add();
+    }
+    return result;
+}
+
+CommandResult ShellAdapter::execute_profiled(const std::string& command, int timeout_seconds) {
+    ScopedLatency timer(latency_);
+#ifdef _WIN32
+    CommandResult result = execute_windows(command, timeout_seconds);
+#else
+    CommandResult result = execute_counted(command, timeout_seconds);
+#endif
+    if (!result.success) {
+        failures_.add();
+    }
+    return result;
 }
 
 CommandResult ShellAdapter::execute_windows(const std::string& command, int timeout_seconds) {
@@ -83,6 +174,143 @@ CommandResult ShellAdapter::execute_unix(const std::string& command, int timeout
     int exit_code = WEXITSTATUS(pclose(pipe.release()));
     return CommandResult{exit_code == 0, result, exit_code};
 }
+
+CommandResult ShellAdapter::execute_counted(const std::string& command, int timeout_seconds) {
+    // The child waits on `go` until the counters are attached, so they see
+    // the shell from its first instruction
+    int out[2], go[2];
+    if (!make_pipe(out)) {
+        return CommandResult{false, "Isaac > Failed to execute command", -1};
+    }
+    if (!make_pipe(go)) {
+        ::close(out[0]);
+        ::close(out[1]);
+        return CommandResult{false, "Isaac > Failed to execute command", -1};
+    }
+
+    // Everything the child touches is prepared before fork: between fork
+    // and exec it may only make async-signal-safe calls
+    const char* argv[] = {"sh", "-c", command.c_str(), nullptr};
+    sigset_t empty;
+    sigemptyset(&empty);
+
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        ::setpgid(0, 0);
+        ::signal(SIGPIPE, SIG_DFL);
+        ::sigprocmask(SIG_SETMASK, &empty, nullptr);
+        ::dup2(out[1], 1);
+        ::close(go[1]);
+        char ready;
+        while (::read(go[0], &ready, 1) < 0 && errno == EINTR) {}
+        ::execve("/bin/sh", const_cast<char* const*>(argv), environ);
+        ::_exit(127);
+    }
+    ::close(out[1]);
+    ::close(go[0]);
+    if (pid < 0) {
+        ::close(out[0]);
+        ::close(go[1]);
+        return CommandResult{false, "Isaac > Failed to execute command", -1};
+    }
+    ::setpgid(pid, pid);    // also here, so a timeout kill cannot race the child
+
+    CommandCounters counters;
+#ifdef __linux__
+    int task_clock = perf_open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, pid);
+    int switches = perf_open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, pid);
+    int migrations = perf_open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, pid);
+    int faults = perf_open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, pid);
+    // Missing in VMs and containers without PMU access
+    int cycles = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, pid);
+    int instructions = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, pid);
+#endif
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(timeout_seconds);
+    ::close(go[1]);
+
+    std::string output;
+    char buffer[4096];
+    for (;;) {
+        int wait_ms = -1;
+        if (timeout_seconds > 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) {
+                counters.timed_out = true;
+                break;
+            }
+            wait_ms = static_cast<int>(std::min<long long>(left, INT_MAX));
+        }
+        pollfd pfd{out[0], POLLIN, 0};
+        int ready = ::poll(&pfd, 1, wait_ms);
+        if (ready < 0 && errno != EINTR) break;
+        if (ready <= 0) continue;
+        ssize_t n = ::read(out[0], buffer, sizeof(buffer));
+        if (n > 0) {
+            output.append(buffer, static_cast<size_t>(n));
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    ::close(out[0]);
+
+    // The shell may close stdout and keep running, so the deadline still
+    // holds until it exits
+    int status = 0;
+    rusage usage{};
+    while (!counters.timed_out) {
+        pid_t reaped = ::wait4(pid, &status, timeout_seconds > 0 ? WNOHANG : 0, &usage);
+        if (reaped == pid) break;
+        if (reaped < 0 && errno != EINTR) break;
+        if (reaped == 0) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                counters.timed_out = true;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+    }
+    if (counters.timed_out) {
+        ::kill(-pid, SIGKILL);
+        while (::wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {}
+    }
+    counters.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    counters.user_seconds = seconds_of(usage.ru_utime);
+    counters.system_seconds = seconds_of(usage.ru_stime);
+#ifdef __APPLE__
+    counters.max_rss_bytes = static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    counters.max_rss_bytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+    counters.major_faults = static_cast<uint64_t>(usage.ru_majflt);
+    counters.voluntary_switches = static_cast<uint64_t>(usage.ru_nvcsw);
+    counters.involuntary_switches = static_cast<uint64_t>(usage.ru_nivcsw);
+
+#ifdef __linux__
+    counters.available = perf_read(task_clock, counters.task_clock_ns) &&
+                         perf_read(switches, counters.context_switches) &&
+                         perf_read(migrations, counters.cpu_migrations) &&
+                         perf_read(faults, counters.page_faults);
+    counters.hardware = perf_read(cycles, counters.cycles) &&
+                        perf_read(instructions, counters.instructions);
+    for (int fd : {task_clock, switches, migrations, faults, cycles, instructions}) {
+        if (fd >= 0) ::close(fd);
+    }
+#endif
+
+    int exit_code;
+    if (counters.timed_out) {
+        exit_code = 124;
+    } else if (WIFEXITED(status)) {
+        exit_code = WEXITSTATUS(status);
+    } else {
+        exit_code = 128 + WTERMSIG(status);
+    }
+    return CommandResult{exit_code == 0, std::move(output), exit_code, counters};
+}
 #endif
 
 void ShellAdapter::read_pipe(HANDLE pipe, std::string& output) {
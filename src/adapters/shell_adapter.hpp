@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../core/metrics.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -9,10 +11,33 @@
 
 namespace isaac {
 
+// Resource use of one profiled command, its shell and everything they started
+struct CommandCounters {
+    bool available = false;             // perf_event_open counters below are valid
+    bool hardware = false;              // cycles and instructions are valid
+    uint64_t task_clock_ns = 0;         // CPU time on all CPUs
+    uint64_t context_switches = 0;
+    uint64_t cpu_migrations = 0;
+    uint64_t page_faults = 0;
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+
+    // From wait4, filled whether or not perf counters could be attached
+    double wall_seconds = 0;
+    double user_seconds = 0;
+    double system_seconds = 0;
+    uint64_t max_rss_bytes = 0;         // largest single process
+    uint64_t major_faults = 0;
+    uint64_t voluntary_switches = 0;    // blocked on I/O or locks
+    uint64_t involuntary_switches = 0;  // preempted
+    bool timed_out = false;
+};
+
 struct CommandResult {
     bool success;
     std::string output;
     int exit_code;
+    CommandCounters counters{};         // only set by execute_profiled
 };
 
 enum class ShellType {
@@ -36,6 +61,14 @@ public:
     // Execute command with custom timeout
     CommandResult execute_with_timeout(const std::string& command, int timeout_seconds);
 
+    // Execute command as a child of this process and count what it used.
+    // On Linux, perf_event_open software counters (task-clock, context
+    // switches, migrations, page faults) and, where the PMU allows it,
+    // cycles and instructions are attached before the shell execs and
+    // inherited by everything it starts. The timeout is enforced: the
+    // command is killed and exit_code is 124.
+    CommandResult execute_profiled(const std::string& command, int timeout_seconds = 30);
+
     // Get shell information
     std::string get_shell_name() const;
     bool is_available() const;
@@ -43,10 +76,14 @@ public:
 private:
     CommandResult execute_windows(const std::string& command, int timeout_seconds);
     CommandResult execute_unix(const std::string& command, int timeout_seconds);
+    CommandResult execute_counted(const std::string& command, int timeout_seconds);
     void read_pipe(HANDLE pipe, std::string& output);
     void detect_shell_type();
 
     ShellType shell_type_;
+
+    LatencyHistogram& latency_;         // "shell.execute"
+    Counter& failures_;                 // "shell.failures": non-zero exits
 };
 
 } // namespace isaac
\ No newline at end of file
@@ -0,0 +1,836 @@
+#include "dependency_graph.hpp"
+#include "core/mapped_file.hpp"
+#include "core/varint.hpp"
+#include "fileops/file_walker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kGraphMagic[8] = {'I', 'S', 'A', 'A', 'C', 'D', 'G', '1'};
+
+const char* const kSourceGlobs[] = {
+    "**/*.py", "**/*.pyi", "**/*.js", "**/*.jsx", "**/*.ts", "**/*.tsx", "**/*.mjs", "**/*.cjs",
+    "**/*.c", "**/*.cc", "**/*.cpp", "**/*.cxx", "**/*.h", "**/*.hh", "**/*.hpp", "**/*.hxx",
+};
+
+const char* const kScriptExtensions[] = {".ts", ".tsx", ".js", ".jsx", ".mjs", ".cjs", ".d.ts"};
+
+bool is_ident(const Token& token, std::string_view text) {
+    return token.kind == TokenKind::Identifier && token.text == text;
+}
+
+bool is_punct(const Token& token, char c) {
+    return token.kind == TokenKind::Punct && token.text[0] == c;
+}
+
+// ----------------------------------------------------------------------------
+// Import scanners
+// ----------------------------------------------------------------------------
+
+// Dotted name starting at tokens[i]; advances i past it
+std::string read_dotted(const std::vector<Token>& tokens, size_t& i, bool allow_leading_dots) {
+    std::string name;
+    if (allow_leading_dots) {
+        while (i < tokens.size() && is_punct(tokens[i], '.')) {
+            name += '.';
+            ++i;
+        }
+    }
+    while (i < tokens.size() && tokens[i].kind == TokenKind::Identifier) {
+        if (tokens[i].text == "import") break;
+        name += tokens[i].text;
+        ++i;
+        if (i + 1 < tokens.size() && is_punct(tokens[i], '.') && tokens[i + 1].kind == TokenKind::Identifier) {
+            name += '.';
+            ++i;
+        } else {
+            break;
+        }
+    }
+    return name;
+}
+
+void scan_python(const std::vector<Token>& tokens, std::vector<ImportRef>& out) {
+    bool statement_start = true;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token& token = tokens[i];
+        if (token.kind == TokenKind::Newline || is_punct(token, ';') || is_punct(token, ':')) {
+            statement_start = true;
+            continue;
+        }
+        if (!statement_start) continue;
+        statement_start = false;
+
+        if (is_ident(token, "import")) {
+            size_t j = i + 1;
+            while (j < tokens.size()) {
+                std::string module = read_dotted(tokens, j, false);
+                if (module.empty()) break;
+                out.push_back(ImportRef{module, {}, token.line, "import"});
+                if (j < tokens.size() && is_ident(tokens[j], "as")) j += 2;
+                if (j < tokens.size() && is_punct(tokens[j], ',')) {
+                    ++j;
+                } else {
+                    break;
+                }
+            }
+            i = j - 1;
+        } else if (is_ident(token, "from")) {
+            size_t j = i + 1;
+            std::string module = read_dotted(tokens, j, true);
+            if (module.empty() || j >= tokens.size() || !is_ident(tokens[j], "import")) continue;
+
+            ImportRef ref{module, {}, token.line, "from"};
+            for (++j; j < tokens.size() && tokens[j].kind != TokenKind::Newline && !is_punct(tokens[j], ';'); ++j) {
+                if (tokens[j].kind == TokenKind::Identifier) {
+                    ref.names.emplace_back(tokens[j].text);
+                    if (j + 1 < tokens.size() && is_ident(tokens[j + 1], "as")) j += 2;
+                } else if (is_punct(tokens[j], '*')) {
+                    ref.names.emplace_back("*");
+                }
+            }
+            out.push_back(std::move(ref));
+            i = j - 1;
+        }
+    }
+}
+
+// Index of the string after a "from" that closes the import/export statement at tokens[i], or 0
+size_t find_from_clause(const std::vector<Token>& tokens, size_t i) {
+    int depth = 0;
+    for (size_t j = i + 1; j < tokens.size() && j < i + 512; ++j) {
+        const Token& token = tokens[j];
+        if (is_punct(token, '{')) ++depth;
+        if (is_punct(token, '}')) --depth;
+        if (depth < 0 || (depth == 0 && is_punct(token, ';'))) return 0;
+        if (depth == 0 && token.kind == TokenKind::Newline && j > i + 1) {
+            const Token& previous = tokens[j - 1];
+            // Statements continue across lines only after a closing brace or a keyword
+            if (!is_punct(previous, '}') && !is_punct(previous, ',') && !is_ident(previous, "import") &&
+                !is_ident(previous, "export") && !is_ident(previous, "type") && previous.kind != TokenKind::Newline) {
+                return 0;
+            }
+        }
+        if ((is_ident(token, "import") || is_ident(token, "export")) && depth == 0) return 0;
+        if (is_ident(token, "from") && j + 1 < tokens.size() && tokens[j + 1].kind == TokenKind::String) {
+            return j + 1;
+        }
+    }
+    return 0;
+}
+
+void scan_script(const std::vector<Token>& tokens, std::vector<ImportRef>& out) {
+    static const std::string_view declarations[] = {"const", "let", "var", "function", "class", "default",
+                                                     "async", "interface", "enum", "abstract", "declare",
+                                                     "namespace", "type"};
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token& token = tokens[i];
+        if (token.kind != TokenKind::Identifier) continue;
+        if (i > 0 && is_punct(tokens[i - 1], '.')) continue;  // member access, e.g. obj.require()
+        const Token* next = i + 1 < tokens.size() ? &tokens[i + 1] : nullptr;
+        if (!next) break;
+
+        if (token.text == "import") {
+            if (next->kind == TokenKind::String) {
+                out.push_back(ImportRef{std::string(next->text), {}, token.line, "import"});
+            } else if (is_punct(*next, '(') && i + 2 < tokens.size() && tokens[i + 2].kind == TokenKind::String) {
+                out.push_back(ImportRef{std::string(tokens[i + 2].text), {}, token.line, "import"});
+            } else if (!is_punct(*next, '.')) {
+                if (size_t spec = find_from_clause(tokens, i)) {
+                    out.push_back(ImportRef{std::string(tokens[spec].text), {}, token.line, "import"});
+                }
+            }
+        } else if (token.text == "export") {
+            bool declaration = next->kind == TokenKind::Identifier &&
+                               std::find(std::begin(declarations), std::end(declarations), next->text) !=
+                                   std::end(declarations) &&
+                               !(next->text == "type" && i + 2 < tokens.size() && is_punct(tokens[i + 2], '{'));
+            if (!declaration) {
+                if (size_t spec = find_from_clause(tokens, i)) {
+                    out.push_back(ImportRef{std::string(tokens[spec].text), {}, token.line, "import"});
+                }
+            }
+        } else if (token.text == "require" && is_punct(*next, '(') && i + 2 < tokens.size() &&
+                   tokens[i + 2].kind == TokenKind::String) {
+            out.push_back(ImportRef{std::string(tokens[i + 2].text), {}, token.line, "require"});
+        }
+    }
+}
+
+void scan_cpp(const std::vector<Token>& tokens, std::vector<ImportRef>& out) {
+    for (size_t i = 0; i + 2 < tokens.size(); ++i) {
+        if (!is_punct(tokens[i], '#') || (i > 0 && tokens[i - 1].kind != TokenKind::Newline)) continue;
+        const Token& directive = tokens[i + 1];
+        const Token& operand = tokens[i + 2];
+        if (directive.kind != TokenKind::Identifier ||
+            (directive.text != "include" && directive.text != "include_next" && directive.text != "import")) {
+            continue;
+        }
+        if (operand.kind == TokenKind::String || operand.kind == TokenKind::AngleString) {
+            ImportRef ref{std::string(operand.text), {}, tokens[i].line, "include"};
+            ref.system = operand.kind == TokenKind::AngleString;
+            out.push_back(std::move(ref));
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Path helpers
+// ----------------------------------------------------------------------------
+
+std::string dirname(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? "" : path.substr(0, slash);
+}
+
+std::string basename(std::string_view path) {
+    size_t slash = path.rfind('/');
+    return std::string(slash == std::string_view::npos ? path : path.substr(slash + 1));
+}
+
+// Collapse "." and ".." components; returns "" if the path escapes the root
+std::string normalize(const std::string& path) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) end = path.size();
+        std::string part = path.substr(start, end - start);
+        if (part == "..") {
+            if (parts.empty()) return "";
+            parts.pop_back();
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(std::move(part));
+        }
+        start = end + 1;
+    }
+    std::string out;
+    for (const auto& part : parts) {
+        if (!out.empty()) out += '/';
+        out += part;
+    }
+    return out;
+}
+
+bool ends_with(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+}
+
+std::string python_module_name(const std::string& rel_path) {
+    std::string name;
+    if (ends_with(rel_path, ".py")) {
+        name = rel_path.substr(0, rel_path.size() - 3);
+    } else if (ends_with(rel_path, ".pyi")) {
+        name = rel_path.substr(0, rel_path.size() - 4);
+    } else {
+        return "";
+    }
+    if (name == "__init__") return "";
+    if (ends_with(name, "/__init__")) name.resize(name.size() - 9);
+    std::replace(name.begin(), name.end(), '/', '.');
+    return name;
+}
+
+int64_t file_mtime_ns(const fs::path& path, std::error_code& ec) {
+    auto time = fs::last_write_time(path, ec);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+std::vector<ImportRef> scan_file(const fs::path& path) {
+    MappedFile file;
+    if (!file.open(path.string())) return {};
+    return scan_imports(file.view(), language_for_path(path.generic_string()));
+}
+
+void write_string(std::vector<uint8_t>& out, std::string_view text) {
+    varint_encode(out, text.size());
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+bool read_string(const uint8_t* data, size_t size, size_t& pos, std::string& text) {
+    uint64_t length;
+    if (!varint_decode(data, size, pos, length) || length > size - pos) return false;
+    text.assign(reinterpret_cast<const char*>(data + pos), length);
+    pos += length;
+    return true;
+}
+
+} // namespace
+
+std::vector<ImportRef> scan_imports(std::string_view source, SourceLanguage language) {
+    std::vector<ImportRef> imports;
+    if (language == SourceLanguage::Unknown) return imports;
+
+    const auto tokens = tokenize_source(source, language);
+    switch (language) {
+        case SourceLanguage::Python: scan_python(tokens, imports); break;
+        case SourceLanguage::JavaScript: scan_script(tokens, imports); break;
+        case SourceLanguage::Cpp: scan_cpp(tokens, imports); break;
+        case SourceLanguage::Unknown: break;
+    }
+    return imports;
+}
+
+// ============================================================================
+// DependencyGraph
+// ============================================================================
+
+DependencyGraph::DependencyGraph(std::string root) : root_(std::move(root)) {}
+
+size_t DependencyGraph::build(const std::vector<std::string>& include_globs, unsigned threads) {
+    struct Cached {
+        uint64_t size;
+        int64_t mtime_ns;
+    };
+    std::unordered_map<std::string, Cached> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Node& node : nodes_) {
+            if (node.is_file) cached.emplace(node.name, Cached{node.size, node.mtime_ns});
+        }
+    }
+
+    struct Scanned {
+        std::string rel_path;
+        uint64_t size;
+        int64_t mtime_ns;
+        bool rescanned;
+        std::vector<ImportRef> imports;
+    };
+    std::vector<Scanned> scanned;
+    std::mutex scanned_mutex;
+
+    WalkOptions options;
+    options.include_globs = include_globs;
+    if (options.include_globs.empty()) {
+        options.include_globs.assign(std::begin(kSourceGlobs), std::end(kSourceGlobs));
+    }
+    options.threads = threads;
+
+    FileWalker(root_, options).walk([&](const std::string& rel_path, const fs::path& path) {
+        std::error_code ec;
+        Scanned entry{rel_path, fs::file_size(path, ec), 0, false, {}};
+        entry.mtime_ns = file_mtime_ns(path, ec);
+        if (ec) return;
+
+        auto it = cached.find(rel_path);
+        if (it == cached.end() || it->second.size != entry.size || it->second.mtime_ns != entry.mtime_ns) {
+            entry.imports = scan_file(path);
+            entry.rescanned = true;
+        }
+        std::lock_guard<std::mutex> lock(scanned_mutex);
+        scanned.push_back(std::move(entry));
+    });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_set<std::string> seen;
+    size_t rescanned = 0;
+    for (auto& entry : scanned) {
+        seen.insert(entry.rel_path);
+        if (entry.rescanned) {
+            set_file(entry.rel_path, entry.size, entry.mtime_ns, std::move(entry.imports));
+            ++rescanned;
+        }
+    }
+    for (uint32_t id = 0; id < nodes_.size(); ++id) {
+        if (nodes_[id].is_file && !seen.count(nodes_[id].name)) drop_file(id);
+    }
+    resolve_all();
+    return rescanned;
+}
+
+void DependencyGraph::update_file(const std::string& rel_path) {
+    const fs::path path = fs::path(root_) / fs::u8path(rel_path);
+    std::error_code ec;
+    const bool exists = fs::is_regular_file(path, ec);
+    uint64_t size = exists ? fs::file_size(path, ec) : 0;
+    int64_t mtime_ns = exists ? file_mtime_ns(path, ec) : 0;
+    if (!exists || ec || language_for_path(rel_path) == SourceLanguage::Unknown) {
+        remove_file(rel_path);
+        return;
+    }
+
+    auto imports = scan_file(path);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_file(rel_path, size, mtime_ns, std::move(imports));
+    if (resolver_dirty_) {
+        resolve_all();
+    } else {
+        resolve(ids_.at(rel_path));
+    }
+}
+
+void DependencyGraph::remove_file(const std::string& rel_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(rel_path);
+    if (it == ids_.end() || !nodes_[it->second].is_file) return;
+    drop_file(it->second);
+    resolve_all();
+}
+
+bool DependencyGraph::save(const std::string& path) const {
+    std::vector<uint8_t> out(std::begin(kGraphMagic), std::end(kGraphMagic));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t files = 0;
+        for (const Node& node : nodes_) files += node.is_file;
+        varint_encode(out, files);
+        for (const Node& node : nodes_) {
+            if (!node.is_file) continue;
+            write_string(out, node.name);
+            varint_encode(out, node.size);
+            varint_encode(out, zigzag_encode(node.mtime_ns));
+            varint_encode(out, node.imports.size());
+            for (const ImportRef& ref : node.imports) {
+                write_string(out, ref.spec);
+                varint_encode(out, static_cast<uint64_t>(ref.line));
+                write_string(out, ref.kind);
+                out.push_back(ref.system ? 1 : 0);
+                varint_encode(out, ref.names.size());
+                for (const auto& name : ref.names) write_string(out, name);
+            }
+        }
+    }
+
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+        if (!file) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    return !ec;
+}
+
+bool DependencyGraph::load(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(kGraphMagic) ||
+        std::memcmp(file.data(), kGraphMagic, sizeof(kGraphMagic)) != 0) {
+        return false;
+    }
+
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+    size_t pos = sizeof(kGraphMagic);
+
+    struct Entry {
+        std::string name;
+        uint64_t size;
+        int64_t mtime_ns;
+        std::vector<ImportRef> imports;
+    };
+    std::vector<Entry> entries;
+    uint64_t count;
+    if (!varint_decode(data, size, pos, count)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        Entry entry;
+        uint64_t value, import_count;
+        if (!read_string(data, size, pos, entry.name) || !varint_decode(data, size, pos, entry.size) ||
+            !varint_decode(data, size, pos, value) || !varint_decode(data, size, pos, import_count)) {
+            return false;
+        }
+        entry.mtime_ns = zigzag_decode(value);
+        for (uint64_t j = 0; j < import_count; ++j) {
+            ImportRef ref;
+            uint64_t line, name_count;
+            if (!read_string(data, size, pos, ref.spec) || !varint_decode(data, size, pos, line) ||
+                !read_string(data, size, pos, ref.kind) || pos >= size) {
+                return false;
+            }
+            ref.line = static_cast<int>(line);
+            ref.system = data[pos++] != 0;
+            if (!varint_decode(data, size, pos, name_count)) return false;
+            for (uint64_t k = 0; k < name_count; ++k) {
+                std::string name;
+                if (!read_string(data, size, pos, name)) return false;
+                ref.names.push_back(std::move(name));
+            }
+            entry.imports.push_back(std::move(ref));
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    nodes_.clear();
+    ids_.clear();
+    for (auto& entry : entries) {
+        set_file(entry.name, entry.size, entry.mtime_ns, std::move(entry.imports));
+    }
+    resolve_all();
+    return true;
+}
+
+bool DependencyGraph::contains(const std::string& rel_path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return find_file(rel_path) >= 0;
+}
+
+std::vector<ImportRef> DependencyGraph::imports(const std::string& rel_path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t id = find_file(rel_path);
+    return id < 0 ? std::vector<ImportRef>{} : nodes_[id].imports;
+}
+
+std::vector<std::string> DependencyGraph::dependencies(const std::string& rel_path, bool include_external) const {
+    return closure(rel_path, 1, include_external);
+}
+
+std::vector<std::string> DependencyGraph::dependents(const std::string& name) const {
+    return impacted({name}, 1);
+}
+
+std::vector<std::string> DependencyGraph::impacted(const std::vector<std::string>& names, size_t max_depth) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint32_t> starts;
+    for (const auto& name : names) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) starts.push_back(it->second);
+    }
+    return traverse(starts, true, max_depth, false, false);
+}
+
+std::vector<std::string> DependencyGraph::closure(const std::string& rel_path, size_t max_depth,
+                                                  bool include_external) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t id = find_file(rel_path);
+    if (id < 0) return {};
+    return traverse({static_cast<uint32_t>(id)}, false, max_depth, include_external, false);
+}
+
+size_t DependencyGraph::file_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const Node& node : nodes_) count += node.is_file;
+    return count;
+}
+
+size_t DependencyGraph::edge_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const Node& node : nodes_) count += node.edges.size();
+    return count;
+}
+
+uint32_t DependencyGraph::node_id(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
+    uint32_t id = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(Node{});
+    nodes_.back().name = name;
+    ids_.emplace(name, id);
+    return id;
+}
+
+void DependencyGraph::set_file(const std::string& rel_path, uint64_t size, int64_t mtime_ns,
+                               std::vector<ImportRef> imports) {
+    Node& node = nodes_[node_id(rel_path)];
+    if (!node.is_file) resolver_dirty_ = true;
+    node.is_file = true;
+    node.size = size;
+    node.mtime_ns = mtime_ns;
+    node.imports = std::move(imports);
+    csr_dirty_ = true;
+}
+
+void DependencyGraph::drop_file(uint32_t id) {
+    Node& node = nodes_[id];
+    node.is_file = false;
+    node.imports.clear();
+    node.edges.clear();
+    resolver_dirty_ = true;
+    csr_dirty_ = true;
+}
+
+void DependencyGraph::rebuild_resolver() {
+    python_modules_.clear();
+    by_basename_.clear();
+
+    // Full dotted names first, then names relative to source roots without __init__.py ("src/")
+    std::vector<std::pair<std::string, uint32_t>> stripped;
+    for (uint32_t id = 0; id < nodes_.size(); ++id) {
+        const Node& node = nodes_[id];
+        if (!node.is_file) continue;
+        by_basename_[basename(node.name)].push_back(id);
+
+        std::string module = python_module_name(node.name);
+        if (module.empty()) continue;
+        python_modules_.emplace(module, id);
+        size_t slash = node.name.find('/');
+        if (slash != std::string::npos && find_file(node.name.substr(0, slash) + "/__init__.py") < 0) {
+            stripped.emplace_back(module.substr(slash + 1), id);
+        }
+    }
+    for (auto& [module, id] : stripped) {
+        python_modules_.emplace(module, id);
+    }
+    for (auto& [name, ids] : by_basename_) {
+        std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) { return nodes_[a].name < nodes_[b].name; });
+    }
+    resolver_dirty_ = false;
+}
+
+void DependencyGraph::resolve(uint32_t id) {
+    // Copy: external_node() may grow nodes_ and invalidate references
+    const std::string importer = nodes_[id].name;
+    const std::vector<ImportRef> imports = nodes_[id].imports;
+    const SourceLanguage language = language_for_path(importer);
+
+    std::vector<uint32_t> edges;
+    for (const ImportRef& ref : imports) {
+        int64_t target = -1;
+        std::string external;
+        if (language == SourceLanguage::Python) {
+            if (ref.kind == "from" && !ref.names.empty()) {
+                for (const auto& name : ref.names) {
+                    int64_t resolved = resolve_python(importer, ref, name);
+                    if (resolved >= 0) edges.push_back(static_cast<uint32_t>(resolved));
+                    target = std::max(target, resolved);
+                }
+            } else {
+                target = resolve_python(importer, ref, "");
+                if (target >= 0) edges.push_back(static_cast<uint32_t>(target));
+            }
+            if (target < 0 && ref.spec[0] != '.') external = ref.spec.substr(0, ref.spec.find('.'));
+        } else if (language == SourceLanguage::JavaScript) {
+            target = resolve_script(importer, ref.spec);
+            if (target >= 0) {
+                edges.push_back(static_cast<uint32_t>(target));
+            } else if (ref.spec[0] != '.' && ref.spec[0] != '/') {
+                // Package name: "@scope/pkg/sub" -> "@scope/pkg", "pkg/sub" -> "pkg"
+                size_t slash = ref.spec.find('/');
+                if (ref.spec[0] == '@' && slash != std::string::npos) slash = ref.spec.find('/', slash + 1);
+                external = ref.spec.substr(0, slash);
+            }
+        } else if (language == SourceLanguage::Cpp) {
+            target = resolve_include(importer, ref);
+            if (target >= 0) {
+                edges.push_back(static_cast<uint32_t>(target));
+            } else {
+                external = ref.spec;
+            }
+        }
+        if (!external.empty()) {
+            edges.push_back(external_node(external));
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    edges.erase(std::remove(edges.begin(), edges.end(), id), edges.end());
+    nodes_[id].edges = std::move(edges);
+    csr_dirty_ = true;
+}
+
+void DependencyGraph::resolve_all() {
+    if (resolver_dirty_) rebuild_resolver();
+    for (uint32_t id = 0; id < nodes_.size(); ++id) {
+        if (nodes_[id].is_file) resolve(id);
+    }
+    prune_nodes();
+    csr_dirty_ = true;
+}
+
+void DependencyGraph::prune_nodes() {
+    // Dropped files and externals nothing imports any more are renumbered
+    // away; the order is kept, so sorted edge lists stay sorted
+    std::vector<bool> keep(nodes_.size(), false);
+    for (uint32_t id = 0; id < nodes_.size(); ++id) {
+        if (!nodes_[id].is_file) continue;
+        keep[id] = true;
+        for (uint32_t target : nodes_[id].edges) keep[target] = true;
+    }
+    if (std::find(keep.begin(), keep.end(), false) == keep.end()) return;
+
+    constexpr uint32_t kDead = UINT32_MAX;
+    std::vector<uint32_t> remap(nodes_.size(), kDead);
+    std::vector<Node> live;
+    for (uint32_t id = 0; id < nodes_.size(); ++id) {
+        if (!keep[id]) continue;
+        remap[id] = static_cast<uint32_t>(live.size());
+        live.push_back(std::move(nodes_[id]));
+    }
+    ids_.clear();
+    for (uint32_t id = 0; id < live.size(); ++id) {
+        for (uint32_t& target : live[id].edges) target = remap[target];
+        ids_.emplace(live[id].name, id);
+    }
+    live.shrink_to_fit();
+    nodes_ = std::move(live);
+    rebuild_resolver();
+    csr_dirty_ = true;
+}
+
+int64_t DependencyGraph::find_file(const std::string& rel_path) const {
+    auto it = ids_.find(rel_path);
+    return it != ids_.end() && nodes_[it->second].is_file ? static_cast<int64_t>(it->second) : -1;
+}
+
+int64_t DependencyGraph::resolve_python(const std::string& importer, const ImportRef& ref,
+                                        std::string_view name) const {
+    std::string module = ref.spec;
+    if (!module.empty() && module[0] == '.') {
+        size_t dots = module.find_first_not_of('.');
+        if (dots == std::string::npos) dots = module.size();
+        std::string rest = module.substr(dots);
+
+        std::vector<std::string> package;
+        std::string dir = dirname(importer);
+        for (size_t start = 0; !dir.empty() && start <= dir.size();) {
+            size_t end = dir.find('/', start);
+            if (end == std::string::npos) end = dir.size();
+            package.push_back(dir.substr(start, end - start));
+            start = end + 1;
+        }
+        if (dots - 1 > package.size()) return -1;
+        package.resize(package.size() - (dots - 1));
+
+        module.clear();
+        for (const auto& part : package) {
+            if (!module.empty()) module += '.';
+            module += part;
+        }
+        if (!rest.empty()) module += (module.empty() ? "" : ".") + rest;
+    }
+
+    if (!name.empty() && name != "*") {
+        auto it = python_modules_.find(module.empty() ? std::string(name) : module + "." + std::string(name));
+        if (it != python_modules_.end()) return it->second;
+    }
+    auto it = python_modules_.find(module);
+    return it == python_modules_.end() ? -1 : static_cast<int64_t>(it->second);
+}
+
+int64_t DependencyGraph::resolve_script(const std::string& importer, const std::string& spec) const {
+    std::string base;
+    if (spec[0] == '.') {
+        base = normalize(dirname(importer) + "/" + spec);
+    } else if (spec[0] == '/') {
+        base = normalize(spec.substr(1));
+    } else {
+        return -1;
+    }
+    if (base.empty()) return -1;
+
+    if (int64_t id = find_file(base); id >= 0) return id;
+    for (const char* ext : kScriptExtensions) {
+        if (int64_t id = find_file(base + ext); id >= 0) return id;
+    }
+    for (const char* ext : kScriptExtensions) {
+        if (int64_t id = find_file(base + "/index" + ext); id >= 0) return id;
+    }
+    // ESM TypeScript imports name the compiled file: "./util.js" -> util.ts
+    for (const char* compiled : {".js", ".jsx", ".mjs"}) {
+        if (ends_with(base, compiled)) {
+            std::string stem = base.substr(0, base.size() - std::strlen(compiled));
+            for (const char* source : {".ts", ".tsx", ".mts"}) {
+                if (int64_t id = find_file(stem + source); id >= 0) return id;
+            }
+        }
+    }
+    return -1;
+}
+
+int64_t DependencyGraph::resolve_include(const std::string& importer, const ImportRef& ref) const {
+    if (!ref.system) {
+        std::string local = normalize(dirname(importer) + "/" + ref.spec);
+        if (int64_t id = find_file(local); id >= 0) return id;
+    }
+    if (int64_t id = find_file(normalize(ref.spec)); id >= 0) return id;
+
+    // Include directories are unknown: accept any file whose path ends with the spec
+    auto it = by_basename_.find(basename(ref.spec));
+    if (it != by_basename_.end()) {
+        const std::string suffix = "/" + normalize(ref.spec);
+        for (uint32_t id : it->second) {
+            if (ends_with(nodes_[id].name, suffix)) return id;
+        }
+    }
+    return -1;
+}
+
+uint32_t DependencyGraph::external_node(const std::string& name) {
+    return node_id(name);
+}
+
+void DependencyGraph::ensure_csr() const {
+    if (!csr_dirty_) return;
+    const size_t n = nodes_.size();
+
+    forward_offsets_.assign(n + 1, 0);
+    reverse_offsets_.assign(n + 1, 0);
+    for (uint32_t id = 0; id < n; ++id) {
+        forward_offsets_[id + 1] = forward_offsets_[id] + static_cast<uint32_t>(nodes_[id].edges.size());
+        for (uint32_t target : nodes_[id].edges) ++reverse_offsets_[target + 1];
+    }
+    for (size_t id = 0; id < n; ++id) reverse_offsets_[id + 1] += reverse_offsets_[id];
+
+    forward_targets_.resize(forward_offsets_[n]);
+    reverse_targets_.resize(reverse_offsets_[n]);
+    std::vector<uint32_t> fill(reverse_offsets_.begin(), reverse_offsets_.end() - 1);
+    for (uint32_t id = 0; id < n; ++id) {
+        std::copy(nodes_[id].edges.begin(), nodes_[id].edges.end(), forward_targets_.begin() + forward_offsets_[id]);
+        for (uint32_t target : nodes_[id].edges) reverse_targets_[fill[target]++] = id;
+    }
+
+    visit_epoch_.assign(n, 0);
+    epoch_ = 0;
+    csr_dirty_ = false;
+}
+
+std::vector<std::string> DependencyGraph::traverse(const std::vector<uint32_t>& starts, bool reverse,
+                                                   size_t max_depth, bool include_external,
+                                                   bool include_starts) const {
+    ensure_csr();
+    if (++epoch_ == 0) {
+        std::fill(visit_epoch_.begin(), visit_epoch_.end(), 0);
+        epoch_ = 1;
+    }
+    const auto& offsets = reverse ? reverse_offsets_ : forward_offsets_;
+    const auto& targets = reverse ? reverse_targets_ : forward_targets_;
+
+    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> visited;
+    for (uint32_t id : starts) {
+        if (visit_epoch_[id] != epoch_) {
+            visit_epoch_[id] = epoch_;
+            frontier.push_back(id);
+            if (include_starts) visited.push_back(id);
+        }
+    }
+
+    std::vector<uint32_t> next;
+    for (size_t depth = 0; !frontier.empty() && (max_depth == 0 || depth < max_depth); ++depth) {
+        next.clear();
+        for (uint32_t id : frontier) {
+            for (uint32_t k = offsets[id]; k < offsets[id + 1]; ++k) {
+                uint32_t target = targets[k];
+                if (visit_epoch_[target] == epoch_) continue;
+                visit_epoch_[target] = epoch_;
+                next.push_back(target);
+                visited.push_back(target);
+            }
+        }
+        frontier.swap(next);
+    }
+
+    std::vector<std::string> names;
+    names.reserve(visited.size());
+    for (uint32_t id : visited) {
+        if (include_external || nodes_[id].is_file) names.push_back(nodes_[id].name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+} // namespace isaac
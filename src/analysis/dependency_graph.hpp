@@ -0,0 +1,112 @@
+#pragma once
+
+#include "source_lexer.hpp"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+struct ImportRef {
+    std::string spec;                   // module, path or header as written ("..pkg", "./util", "vector")
+    std::vector<std::string> names;     // imported names for Python "from" imports
+    int line = 0;
+    std::string kind;                   // "import", "from", "require" or "include"
+    bool system = false;                // #include <...>
+};
+
+// Import statements of one source file (Python, JS/TS, C/C++)
+std::vector<ImportRef> scan_imports(std::string_view source, SourceLanguage language);
+
+/**
+ * Project-wide import graph.
+ *
+ * Nodes are project files (relative paths) plus external modules that no
+ * file resolves to ("os", "react", "vector"). Scans are cached per file and
+ * reused while size and mtime match, including across sessions via
+ * save()/load(). Queries run on CSR adjacency arrays in both directions,
+ * rebuilt lazily after updates.
+ */
+class DependencyGraph {
+public:
+    explicit DependencyGraph(std::string root);
+
+    // Walk the tree and rescan changed files; returns the number of files scanned
+    size_t build(const std::vector<std::string>& include_globs = {}, unsigned threads = 0);
+
+    // Rescan one file (drops it if it no longer exists)
+    void update_file(const std::string& rel_path);
+    void remove_file(const std::string& rel_path);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    bool contains(const std::string& rel_path) const;
+    std::vector<ImportRef> imports(const std::string& rel_path) const;
+
+    // Direct edges; dependents() also accepts an external module name
+    std::vector<std::string> dependencies(const std::string& rel_path, bool include_external = false) const;
+    std::vector<std::string> dependents(const std::string& name) const;
+
+    // Everything that transitively imports any of names (excluding names); max_depth 0 = unbounded
+    std::vector<std::string> impacted(const std::vector<std::string>& names, size_t max_depth = 0) const;
+    // Everything rel_path transitively imports
+    std::vector<std::string> closure(const std::string& rel_path, size_t max_depth = 0,
+                                     bool include_external = false) const;
+
+    size_t file_count() const;
+    size_t edge_count() const;
+
+private:
+    struct Node {
+        std::string name;
+        bool is_file = false;
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+        std::vector<ImportRef> imports;
+        std::vector<uint32_t> edges;    // resolved targets
+    };
+
+    uint32_t node_id(const std::string& name);
+    void set_file(const std::string& rel_path, uint64_t size, int64_t mtime_ns, std::vector<ImportRef> imports);
+    void drop_file(uint32_t id);
+
+    void rebuild_resolver();
+    void resolve(uint32_t id);
+    void resolve_all();
+    void prune_nodes();
+    int64_t find_file(const std::string& rel_path) const;
+    int64_t resolve_python(const std::string& importer, const ImportRef& ref, std::string_view name) const;
+    int64_t resolve_script(const std::string& importer, const std::string& spec) const;
+    int64_t resolve_include(const std::string& importer, const ImportRef& ref) const;
+    uint32_t external_node(const std::string& name);
+
+    void ensure_csr() const;
+    std::vector<std::string> traverse(const std::vector<uint32_t>& starts, bool reverse, size_t max_depth,
+                                      bool include_external, bool include_starts) const;
+
+    std::string root_;
+    std::vector<Node> nodes_;
+    std::unordered_map<std::string, uint32_t> ids_;
+
+    // Resolver indexes, rebuilt when the set of files changes
+    std::unordered_map<std::string, uint32_t> python_modules_;
+    std::unordered_map<std::string, std::vector<uint32_t>> by_basename_;
+    bool resolver_dirty_ = true;
+
+    // CSR adjacency: forward (imports) and reverse (imported by)
+    mutable std::vector<uint32_t> forward_offsets_;
+    mutable std::vector<uint32_t> forward_targets_;
+    mutable std::vector<uint32_t> reverse_offsets_;
+    mutable std::vector<uint32_t> reverse_targets_;
+    mutable std::vector<uint32_t> visit_epoch_;
+    mutable uint32_t epoch_ = 0;
+    mutable bool csr_dirty_ = true;
+
+    mutable std::mutex mutex_;
+};
+
+} // namespace isaac
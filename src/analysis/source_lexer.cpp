@@ -0,0 +1,318 @@
+#include "source_lexer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+
+namespace isaac {
+
+namespace {
+
+bool ends_with(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+}
+
+bool is_ident_start(unsigned char c, SourceLanguage language) {
+    return std::isalpha(c) || c == '_' || c >= 0x80 || (c == '$' && language == SourceLanguage::JavaScript);
+}
+
+bool is_ident_char(unsigned char c, SourceLanguage language) {
+    return is_ident_start(c, language) || std::isdigit(c);
+}
+
+bool is_python_string_prefix(std::string_view ident) {
+    if (ident.size() > 2) return false;
+    for (char c : ident) {
+        if (!std::strchr("rRbBuUfF", c)) return false;
+    }
+    return true;
+}
+
+// Keywords after which a JavaScript '/' starts a regex literal rather than a division
+bool js_regex_allowed_after(const Token* previous) {
+    if (!previous || previous->kind == TokenKind::Newline) return true;
+    if (previous->kind == TokenKind::Punct) {
+        return std::strchr("(,=:[!&|?{};+-*%<>~^", previous->text[0]) != nullptr;
+    }
+    if (previous->kind == TokenKind::Identifier) {
+        static const std::string_view keywords[] = {"return", "typeof", "case", "do", "else", "in",
+                                                    "of", "new", "delete", "void", "throw", "yield", "await"};
+        for (auto keyword : keywords) {
+            if (previous->text == keyword) return true;
+        }
+    }
+    return false;
+}
+
+class Lexer {
+public:
+    Lexer(std::string_view source, SourceLanguage language) : s_(source), language_(language) {}
+
+    std::vector<Token> run() {
+        while (i_ < s_.size()) {
+            const char c = s_[i_];
+            if (c == '\n') {
+                if (language_ != SourceLanguage::Python || depth_ == 0) emit_newline();
+                advance_line();
+                continue;
+            }
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+                ++i_;
+                continue;
+            }
+            if (c == '\\' && peek(1) == '\n') {
+                ++i_;
+                advance_line();
+                continue;
+            }
+            if (c == '\\' && peek(1) == '\r' && peek(2) == '\n') {
+                i_ += 2;
+                advance_line();
+                continue;
+            }
+            if (skip_comment()) continue;
+            if (lex_string_start()) continue;
+
+            const auto uc = static_cast<unsigned char>(c);
+            if (is_ident_start(uc, language_)) {
+                lex_identifier();
+            } else if (std::isdigit(uc) || (c == '.' && std::isdigit(static_cast<unsigned char>(peek(1))))) {
+                lex_number();
+            } else if (c == '/' && language_ == SourceLanguage::JavaScript &&
+                       js_regex_allowed_after(tokens_.empty() ? nullptr : &tokens_.back())) {
+                skip_regex_literal();
+            } else if (c == '<' && at_include_operand()) {
+                lex_quoted('>', TokenKind::AngleString);
+            } else {
+                if (c == '(' || c == '[' || c == '{') ++depth_;
+                if ((c == ')' || c == ']' || c == '}') && depth_ > 0) --depth_;
+                push(TokenKind::Punct, i_, 1);
+                ++i_;
+            }
+        }
+        emit_newline();
+        return std::move(tokens_);
+    }
+
+private:
+    char peek(size_t ahead) const {
+        return i_ + ahead < s_.size() ? s_[i_ + ahead] : '\0';
+    }
+
+    void push(TokenKind kind, size_t start, size_t length) {
+        tokens_.push_back(Token{kind, s_.substr(start, length), line_, static_cast<int>(start - line_start_)});
+    }
+
+    void emit_newline() {
+        if (!tokens_.empty() && tokens_.back().kind != TokenKind::Newline) {
+            tokens_.push_back(Token{TokenKind::Newline, {}, line_, static_cast<int>(i_ - line_start_)});
+        }
+    }
+
+    void advance_line() {
+        ++i_;
+        ++line_;
+        line_start_ = i_;
+    }
+
+    // Move past s_[i_], keeping line bookkeeping
+    void step() {
+        if (s_[i_] == '\n') {
+            advance_line();
+        } else {
+            ++i_;
+        }
+    }
+
+    bool skip_comment() {
+        const char c = s_[i_];
+        const bool c_like = language_ == SourceLanguage::JavaScript || language_ == SourceLanguage::Cpp;
+        if ((c == '#' && language_ == SourceLanguage::Python) || (c_like && c == '/' && peek(1) == '/')) {
+            while (i_ < s_.size() && s_[i_] != '\n') ++i_;
+            return true;
+        }
+        if (c_like && c == '/' && peek(1) == '*') {
+            i_ += 2;
+            while (i_ < s_.size() && !(s_[i_] == '*' && peek(1) == '/')) step();
+            i_ = std::min(s_.size(), i_ + 2);
+            return true;
+        }
+        return false;
+    }
+
+    bool lex_string_start() {
+        const char c = s_[i_];
+        if (c == '"' || c == '\'') {
+            if (language_ == SourceLanguage::Python && peek(1) == c && peek(2) == c) {
+                lex_triple_quoted(c);
+            } else {
+                lex_quoted(c, TokenKind::String);
+            }
+            return true;
+        }
+        if (c == '`' && language_ == SourceLanguage::JavaScript) {
+            lex_template();
+            return true;
+        }
+        return false;
+    }
+
+    void lex_quoted(char close, TokenKind kind) {
+        const size_t start = ++i_;
+        while (i_ < s_.size() && s_[i_] != close) {
+            if (s_[i_] == '\\' && i_ + 1 < s_.size()) {
+                ++i_;
+            } else if (s_[i_] == '\n') {
+                break;  // unterminated: stop at end of line
+            }
+            step();
+        }
+        push(kind, start, i_ - start);
+        if (i_ < s_.size() && s_[i_] == close) ++i_;
+    }
+
+    void lex_triple_quoted(char quote) {
+        i_ += 3;
+        const size_t start = i_;
+        const int line = line_;
+        const int column = static_cast<int>(start - line_start_);
+        while (i_ < s_.size() && !(s_[i_] == quote && peek(1) == quote && peek(2) == quote)) {
+            if (s_[i_] == '\\' && i_ + 1 < s_.size()) ++i_;
+            step();
+        }
+        tokens_.push_back(Token{TokenKind::String, s_.substr(start, i_ - start), line, column});
+        i_ = std::min(s_.size(), i_ + 3);
+    }
+
+    void lex_template() {
+        const size_t start = ++i_;
+        const int line = line_;
+        const int column = static_cast<int>(start - line_start_);
+        int braces = 0;
+        while (i_ < s_.size() && (braces > 0 || s_[i_] != '`')) {
+            if (s_[i_] == '\\' && i_ + 1 < s_.size()) {
+                ++i_;
+            } else if (s_[i_] == '$' && peek(1) == '{') {
+                ++braces;
+                ++i_;
+            } else if (s_[i_] == '}' && braces > 0) {
+                --braces;
+            }
+            step();
+        }
+        tokens_.push_back(Token{TokenKind::String, s_.substr(start, i_ - start), line, column});
+        if (i_ < s_.size()) ++i_;
+    }
+
+    void lex_raw_cpp_string() {
+        // R"delim( ... )delim"
+        size_t open = s_.find('(', i_);
+        if (open == std::string_view::npos) {
+            lex_quoted('"', TokenKind::String);
+            return;
+        }
+        std::string terminator = ")" + std::string(s_.substr(i_ + 1, open - i_ - 1)) + "\"";
+        const int line = line_;
+        const int column = static_cast<int>(i_ - line_start_);
+        size_t end = s_.find(terminator, open + 1);
+        if (end == std::string_view::npos) end = s_.size();
+        while (i_ < open + 1) step();
+        const size_t start = i_;
+        while (i_ < end) step();
+        tokens_.push_back(Token{TokenKind::String, s_.substr(start, end - start), line, column});
+        i_ = std::min(s_.size(), end + terminator.size());
+    }
+
+    void lex_identifier() {
+        const size_t start = i_;
+        while (i_ < s_.size() && is_ident_char(static_cast<unsigned char>(s_[i_]), language_)) ++i_;
+        std::string_view ident = s_.substr(start, i_ - start);
+
+        const char next = i_ < s_.size() ? s_[i_] : '\0';
+        if (language_ == SourceLanguage::Python && (next == '"' || next == '\'') && is_python_string_prefix(ident)) {
+            return;  // string prefix: the quote is lexed next
+        }
+        if (language_ == SourceLanguage::Cpp && next == '"') {
+            if (ends_with(ident, "R") && ident.size() <= 3) {
+                lex_raw_cpp_string();
+                return;
+            }
+            if (ident == "L" || ident == "u" || ident == "U" || ident == "u8") return;
+        }
+        push(TokenKind::Identifier, start, i_ - start);
+    }
+
+    void lex_number() {
+        const size_t start = i_;
+        while (i_ < s_.size()) {
+            const auto c = static_cast<unsigned char>(s_[i_]);
+            if (std::isalnum(c) || c == '_' || c == '.' || c == '\'') {
+                ++i_;
+            } else {
+                break;
+            }
+        }
+        push(TokenKind::Number, start, i_ - start);
+    }
+
+    void skip_regex_literal() {
+        ++i_;
+        bool in_class = false;
+        while (i_ < s_.size() && s_[i_] != '\n') {
+            const char c = s_[i_];
+            if (c == '\\') {
+                if (peek(1) == '\n') break;  // unterminated; the newline is lexed as usual
+                i_ = std::min(s_.size(), i_ + 2);
+                continue;
+            }
+            if (c == '[') in_class = true;
+            if (c == ']') in_class = false;
+            ++i_;
+            if (c == '/' && !in_class) break;
+        }
+        while (i_ < s_.size() && std::isalpha(static_cast<unsigned char>(s_[i_]))) ++i_;  // flags
+    }
+
+    bool at_include_operand() const {
+        if (language_ != SourceLanguage::Cpp || tokens_.size() < 2) return false;
+        const Token& directive = tokens_[tokens_.size() - 1];
+        const Token& hash = tokens_[tokens_.size() - 2];
+        return hash.kind == TokenKind::Punct && hash.text == "#" && directive.line == line_ &&
+               (directive.text == "include" || directive.text == "include_next" || directive.text == "import");
+    }
+
+    std::string_view s_;
+    SourceLanguage language_;
+    std::vector<Token> tokens_;
+    size_t i_ = 0;
+    size_t line_start_ = 0;
+    int line_ = 1;
+    int depth_ = 0;
+};
+
+} // namespace
+
+SourceLanguage language_for_path(std::string_view path) {
+    size_t dot = path.rfind('.');
+    size_t slash = path.rfind('/');
+    if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) {
+        return SourceLanguage::Unknown;
+    }
+    std::string_view ext = path.substr(dot + 1);
+    if (ext == "py" || ext == "pyi") return SourceLanguage::Python;
+    if (ext == "js" || ext == "jsx" || ext == "ts" || ext == "tsx" || ext == "mjs" || ext == "cjs" ||
+        ext == "mts" || ext == "cts") {
+        return SourceLanguage::JavaScript;
+    }
+    if (ext == "c" || ext == "cc" || ext == "cpp" || ext == "cxx" || ext == "h" || ext == "hh" ||
+        ext == "hpp" || ext == "hxx" || ext == "ipp" || ext == "inl") {
+        return SourceLanguage::Cpp;
+    }
+    return SourceLanguage::Unknown;
+}
+
+std::vector<Token> tokenize_source(std::string_view source, SourceLanguage language) {
+    return Lexer(source, language).run();
+}
+
+} // namespace isaac
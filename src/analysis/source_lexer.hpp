@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace isaac {
+
+enum class SourceLanguage {
+    Unknown,
+    Python,
+    JavaScript,     // also TypeScript, JSX and TSX
+    Cpp,            // C and C++
+};
+
+// Language from the file extension (case-sensitive, like the tools' extension maps)
+SourceLanguage language_for_path(std::string_view path);
+
+enum class TokenKind {
+    Identifier,
+    Number,
+    String,         // text is the contents between the quotes, escapes left as-is
+    AngleString,    // <...> operand of #include
+    Punct,          // single character
+    Newline,        // end of a logical line
+};
+
+struct Token {
+    TokenKind kind;
+    std::string_view text;  // view into the scanned source
+    int line;               // 1-based
+    int column;             // 0-based byte column
+};
+
+/**
+ * Tolerant tokenizer for import and symbol scanning. It never fails: unknown
+ * bytes become punctuation and unterminated strings or comments run to the
+ * end of the input. Comments are dropped; Python emits Newline only at the
+ * end of logical lines (outside brackets and continuations).
+ */
+std::vector<Token> tokenize_source(std::string_view source, SourceLanguage language);
+
+} // namespace isaac
@@ -0,0 +1,753 @@
+#include "symbol_index.hpp"
+#include "core/mapped_file.hpp"
+#include "core/utf8.hpp"
+#include "core/varint.hpp"
+#include "fileops/file_walker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'I', 'S', 'A', 'A', 'C', 'S', 'Y', '1'};
+constexpr size_t kMaxSignature = 160;
+constexpr size_t kMinCompaction = 4096;     // overlay + stale symbols tolerated before re-sorting
+
+const char* const kSourceGlobs[] = {
+    "**/*.py", "**/*.pyi", "**/*.js", "**/*.jsx", "**/*.ts", "**/*.tsx", "**/*.mjs", "**/*.cjs",
+    "**/*.c", "**/*.cc", "**/*.cpp", "**/*.cxx", "**/*.h", "**/*.hh", "**/*.hpp", "**/*.hxx",
+};
+
+const char* const kKinds[] = {"function", "method", "class", "struct", "enum", "interface",
+                              "type", "namespace", "variable", "macro"};
+
+enum Kind : uint8_t { Function, Method, Class, Struct, Enum, Interface, Type, Namespace, Variable, Macro };
+
+bool is_ident(const Token& token, std::string_view text) {
+    return token.kind == TokenKind::Identifier && token.text == text;
+}
+
+bool is_punct(const Token& token, char c) {
+    return token.kind == TokenKind::Punct && token.text[0] == c;
+}
+
+// Index of the token closing the bracket opened at tokens[open], or tokens.size()
+size_t matching_close(const std::vector<Token>& tokens, size_t open) {
+    const char open_char = tokens[open].text[0];
+    const char close_char = open_char == '(' ? ')' : open_char == '[' ? ']' : '}';
+    int depth = 0;
+    for (size_t i = open; i < tokens.size(); ++i) {
+        if (is_punct(tokens[i], open_char)) ++depth;
+        if (is_punct(tokens[i], close_char) && --depth == 0) return i;
+    }
+    return tokens.size();
+}
+
+// Next index at or after i that is not a Newline token
+size_t skip_newlines(const std::vector<Token>& tokens, size_t i) {
+    while (i < tokens.size() && tokens[i].kind == TokenKind::Newline) ++i;
+    return i;
+}
+
+class SymbolScanner {
+public:
+    SymbolScanner(std::string_view source, SourceLanguage language)
+        : source_(source), language_(language), tokens_(tokenize_source(source, language)) {}
+
+    std::vector<SymbolDef> run() {
+        switch (language_) {
+            case SourceLanguage::Python: scan_python(); break;
+            case SourceLanguage::JavaScript: scan_script(); break;
+            case SourceLanguage::Cpp: scan_cpp(); break;
+            case SourceLanguage::Unknown: break;
+        }
+        std::stable_sort(symbols_.begin(), symbols_.end(), [](const SymbolDef& a, const SymbolDef& b) {
+            return a.line != b.line ? a.line < b.line : a.column < b.column;
+        });
+        return std::move(symbols_);
+    }
+
+private:
+    void add(const Token& name, Kind kind) {
+        SymbolDef symbol;
+        symbol.name = std::string(name.text);
+        symbol.line = name.line;
+        symbol.column = name.column;
+        symbol.kind = kKinds[kind];
+        symbol.signature = line_text(name);
+        symbols_.push_back(std::move(symbol));
+    }
+
+    std::string line_text(const Token& token) const {
+        // Token text views into source_, so the line is found around it
+        size_t pos = static_cast<size_t>(token.text.data() - source_.data());
+        size_t start = source_.rfind('\n', pos);
+        start = start == std::string_view::npos ? 0 : start + 1;
+        size_t end = source_.find('\n', pos);
+        if (end == std::string_view::npos) end = source_.size();
+
+        std::string_view line = source_.substr(start, end - start);
+        while (!line.empty() && std::strchr(" \t\r\f\v", line.front())) line.remove_prefix(1);
+        while (!line.empty() && std::strchr(" \t\r\f\v", line.back())) line.remove_suffix(1);
+        if (line.size() > kMaxSignature) line = line.substr(0, utf8_floor(line, kMaxSignature));
+        return to_valid_utf8(line);
+    }
+
+    // ------------------------------------------------------------------------
+    // Python: def/class at any depth, module-level assignments
+    // ------------------------------------------------------------------------
+
+    void scan_python() {
+        struct Scope {
+            int column;
+            bool is_class;
+        };
+        std::vector<Scope> scopes;
+        bool statement_start = true;
+
+        for (size_t i = 0; i < tokens_.size(); ++i) {
+            const Token& token = tokens_[i];
+            if (token.kind == TokenKind::Newline) {
+                statement_start = true;
+                continue;
+            }
+            if (!statement_start) continue;
+            statement_start = false;
+
+            while (!scopes.empty() && scopes.back().column >= token.column) scopes.pop_back();
+
+            size_t j = i;
+            if (is_ident(token, "async") && j + 1 < tokens_.size()) ++j;
+            if (j + 1 >= tokens_.size() || tokens_[j + 1].kind != TokenKind::Identifier) continue;
+
+            if (is_ident(tokens_[j], "def")) {
+                add(tokens_[j + 1], !scopes.empty() && scopes.back().is_class ? Method : Function);
+                scopes.push_back(Scope{token.column, false});
+            } else if (is_ident(tokens_[j], "class")) {
+                add(tokens_[j + 1], Class);
+                scopes.push_back(Scope{token.column, true});
+            }
+        }
+
+        // Module-level NAME = ... (not ==)
+        statement_start = true;
+        for (size_t i = 0; i + 2 < tokens_.size(); ++i) {
+            const Token& token = tokens_[i];
+            if (token.kind == TokenKind::Newline) {
+                statement_start = true;
+                continue;
+            }
+            if (statement_start && token.column == 0 && token.kind == TokenKind::Identifier &&
+                is_punct(tokens_[i + 1], '=') && !is_punct(tokens_[i + 2], '=')) {
+                add(token, Variable);
+            }
+            statement_start = false;
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // JavaScript / TypeScript
+    // ------------------------------------------------------------------------
+
+    // const f = function / async / (...) => / x =>
+    bool is_function_value(size_t i) const {
+        i = skip_newlines(tokens_, i);
+        if (i >= tokens_.size()) return false;
+        if (is_ident(tokens_[i], "function") || is_ident(tokens_[i], "async")) return true;
+        size_t after = tokens_.size();
+        if (is_punct(tokens_[i], '(')) {
+            after = matching_close(tokens_, i) + 1;
+        } else if (tokens_[i].kind == TokenKind::Identifier) {
+            after = i + 1;
+        }
+        return after + 1 < tokens_.size() && is_punct(tokens_[after], '=') && is_punct(tokens_[after + 1], '>');
+    }
+
+    void scan_script() {
+        static const std::string_view method_modifiers[] = {"static", "async", "get", "set", "public",
+                                                            "private", "protected", "readonly", "override"};
+        static const std::string_view not_methods[] = {"if", "for", "while", "switch", "catch", "function",
+                                                       "return", "constructor", "super"};
+        std::vector<int> class_depths;  // brace depth of each open class body
+        int depth = 0;
+        bool pending_class = false;
+
+        for (size_t i = 0; i < tokens_.size(); ++i) {
+            const Token& token = tokens_[i];
+            if (is_punct(token, '{')) {
+                ++depth;
+                if (pending_class) class_depths.push_back(depth);
+                pending_class = false;
+                continue;
+            }
+            if (is_punct(token, '}')) {
+                if (!class_depths.empty() && class_depths.back() == depth) class_depths.pop_back();
+                --depth;
+                continue;
+            }
+            if (token.kind != TokenKind::Identifier || i + 1 >= tokens_.size()) continue;
+            if (i > 0 && is_punct(tokens_[i - 1], '.')) continue;
+
+            const Token& next = tokens_[i + 1];
+            const bool next_ident = next.kind == TokenKind::Identifier;
+            const Token* after = i + 2 < tokens_.size() ? &tokens_[i + 2] : nullptr;
+
+            if (token.text == "function") {
+                size_t name = is_punct(next, '*') ? i + 2 : i + 1;
+                if (name < tokens_.size() && tokens_[name].kind == TokenKind::Identifier) add(tokens_[name], Function);
+            } else if (token.text == "class" && next_ident && next.text != "extends" && next.text != "implements") {
+                add(next, Class);
+                pending_class = true;
+            } else if (token.text == "interface" && next_ident && after &&
+                       (is_punct(*after, '{') || is_punct(*after, '<') || is_ident(*after, "extends"))) {
+                add(next, Interface);
+            } else if (token.text == "type" && next_ident && after && (is_punct(*after, '=') || is_punct(*after, '<'))) {
+                add(next, Type);
+            } else if (token.text == "enum" && next_ident && after && is_punct(*after, '{')) {
+                add(next, Enum);
+            } else if ((token.text == "namespace" || token.text == "module") && next_ident && after &&
+                       is_punct(*after, '{')) {
+                add(next, Namespace);
+            } else if ((token.text == "const" || token.text == "let" || token.text == "var") && next_ident) {
+                size_t value = i + 2;
+                if (value < tokens_.size() && is_punct(tokens_[value], ':')) {
+                    // TypeScript annotation: skip to the initializer
+                    while (value < tokens_.size() && !is_punct(tokens_[value], '=') && !is_punct(tokens_[value], ';') &&
+                           tokens_[value].kind != TokenKind::Newline) {
+                        ++value;
+                    }
+                }
+                const bool assigned = value < tokens_.size() && is_punct(tokens_[value], '=');
+                if (assigned && is_function_value(value + 1)) {
+                    add(next, Function);
+                } else if (depth == 0) {
+                    add(next, Variable);
+                }
+            } else if (!class_depths.empty() && class_depths.back() == depth && is_punct(next, '(') &&
+                       std::find(std::begin(not_methods), std::end(not_methods), token.text) ==
+                           std::end(not_methods)) {
+                const Token* previous = i > 0 ? &tokens_[i - 1] : nullptr;
+                const bool member_start =
+                    !previous || previous->kind == TokenKind::Newline || is_punct(*previous, '{') ||
+                    is_punct(*previous, '}') || is_punct(*previous, ';') || is_punct(*previous, '*') ||
+                    (previous->kind == TokenKind::Identifier &&
+                     std::find(std::begin(method_modifiers), std::end(method_modifiers), previous->text) !=
+                         std::end(method_modifiers));
+                size_t close = matching_close(tokens_, i + 1);
+                size_t body = skip_newlines(tokens_, close + 1);
+                if (member_start && body < tokens_.size() && (is_punct(tokens_[body], '{') || is_punct(tokens_[body], ':'))) {
+                    add(token, Method);
+                }
+            }
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // C / C++
+    // ------------------------------------------------------------------------
+
+    static bool is_cpp_keyword(std::string_view word) {
+        static const std::string_view keywords[] = {
+            "if", "for", "while", "switch", "catch", "return", "sizeof", "alignof", "decltype", "static_assert",
+            "defined", "noexcept", "throw", "new", "delete", "typeid", "alignas", "__attribute__", "__declspec",
+            "requires", "co_await", "co_return", "co_yield", "operator", "template"};
+        return std::find(std::begin(keywords), std::end(keywords), word) != std::end(keywords);
+    }
+
+    // After a parameter list closing at tokens_[close]: index of the body '{', or 0 if not a definition
+    size_t function_body(size_t close) const {
+        for (size_t j = close + 1; j < tokens_.size() && j < close + 128; ++j) {
+            const Token& token = tokens_[j];
+            if (token.kind == TokenKind::Newline) continue;
+            if (is_punct(token, '{')) return j;
+            if (is_punct(token, ';') || is_punct(token, '}')) return 0;
+            if (is_punct(token, '=')) {
+                // "= default" / "= delete" / "= 0" declare; "->" is a trailing return type
+                if (j > 0 && is_punct(tokens_[j - 1], '-')) continue;
+                return 0;
+            }
+            if (is_punct(token, '(')) j = matching_close(tokens_, j);
+        }
+        return 0;
+    }
+
+    void scan_cpp() {
+        enum class Scope { Namespace, Class };
+        std::vector<Scope> scopes;
+        Scope pending = Scope::Namespace;
+        bool has_pending = false;
+
+        for (size_t i = 0; i < tokens_.size(); ++i) {
+            const Token& token = tokens_[i];
+
+            if (is_punct(token, '#') && (i == 0 || tokens_[i - 1].kind == TokenKind::Newline)) {
+                if (i + 2 < tokens_.size() && is_ident(tokens_[i + 1], "define") &&
+                    tokens_[i + 2].kind == TokenKind::Identifier) {
+                    add(tokens_[i + 2], Macro);
+                }
+                while (i < tokens_.size() && tokens_[i].kind != TokenKind::Newline) ++i;
+                continue;
+            }
+            if (is_punct(token, '{')) {
+                if (has_pending) {
+                    scopes.push_back(pending);
+                    has_pending = false;
+                } else {
+                    // Initializer lists, enum bodies and other unnamed braces
+                    i = matching_close(tokens_, i);
+                }
+                continue;
+            }
+            if (is_punct(token, '}')) {
+                if (!scopes.empty()) scopes.pop_back();
+                continue;
+            }
+            if (is_punct(token, ';')) {
+                has_pending = false;
+                continue;
+            }
+            if (token.kind != TokenKind::Identifier || i + 1 >= tokens_.size()) continue;
+            const Token& next = tokens_[i + 1];
+
+            if (token.text == "namespace") {
+                if (next.kind == TokenKind::Identifier) add(next, Namespace);
+                pending = Scope::Namespace;
+                has_pending = true;
+            } else if (token.text == "extern" && next.kind == TokenKind::String) {
+                pending = Scope::Namespace;  // extern "C" { ... }
+                has_pending = true;
+            } else if (token.text == "class" || token.text == "struct" || token.text == "union" ||
+                       token.text == "enum") {
+                size_t name = i + 1;
+                if (token.text == "enum" && name < tokens_.size() &&
+                    (is_ident(tokens_[name], "class") || is_ident(tokens_[name], "struct"))) {
+                    ++name;
+                }
+                if (name + 1 >= tokens_.size() || tokens_[name].kind != TokenKind::Identifier) continue;
+                size_t after = name + 1;
+                if (is_ident(tokens_[after], "final")) ++after;
+                after = skip_newlines(tokens_, after);
+                if (after >= tokens_.size()) continue;
+
+                const bool base_list = is_punct(tokens_[after], ':') &&
+                                       !(after + 1 < tokens_.size() && is_punct(tokens_[after + 1], ':'));
+                if (!is_punct(tokens_[after], '{') && !base_list) continue;
+                if (base_list) {
+                    size_t j = after;
+                    while (j < tokens_.size() && !is_punct(tokens_[j], '{') && !is_punct(tokens_[j], ';')) ++j;
+                    if (j >= tokens_.size() || !is_punct(tokens_[j], '{')) continue;
+                }
+                Kind kind = token.text == "class" ? Class : token.text == "enum" ? Enum : Struct;
+                add(tokens_[name], kind);
+                pending = Scope::Class;
+                has_pending = kind != Enum;  // enum bodies are skipped like initializers
+                i = name;
+            } else if (token.text == "using" && next.kind == TokenKind::Identifier && i + 2 < tokens_.size() &&
+                       is_punct(tokens_[i + 2], '=')) {
+                add(next, Type);
+            } else if (token.text == "typedef") {
+                size_t j = i + 1;
+                while (j < tokens_.size() && !is_punct(tokens_[j], ';') && !is_punct(tokens_[j], '{') &&
+                       !is_punct(tokens_[j], '(')) {
+                    ++j;
+                }
+                if (j < tokens_.size() && is_punct(tokens_[j], ';') && tokens_[j - 1].kind == TokenKind::Identifier) {
+                    add(tokens_[j - 1], Type);
+                }
+            } else if (is_punct(next, '(') && !is_cpp_keyword(token.text)) {
+                const Token* previous = i > 0 ? &tokens_[i - 1] : nullptr;
+                if (previous && (is_punct(*previous, '~') || is_punct(*previous, '.') ||
+                                 (is_punct(*previous, '>') && i > 1 && is_punct(tokens_[i - 2], '-')))) {
+                    continue;
+                }
+                size_t close = matching_close(tokens_, i + 1);
+                size_t body = close < tokens_.size() ? function_body(close) : 0;
+                if (!body) continue;
+
+                const bool qualified = previous && is_punct(*previous, ':') && i > 1 && is_punct(tokens_[i - 2], ':');
+                const bool in_class = !scopes.empty() && scopes.back() == Scope::Class;
+                add(token, qualified || in_class ? Method : Function);
+                // Skip the body: nothing inside a function is indexed
+                i = matching_close(tokens_, body);
+            }
+        }
+    }
+
+    std::string_view source_;
+    SourceLanguage language_;
+    std::vector<Token> tokens_;
+    std::vector<SymbolDef> symbols_;
+};
+
+uint8_t kind_code(const std::string& kind) {
+    for (uint8_t code = 0; code < std::size(kKinds); ++code) {
+        if (kind == kKinds[code]) return code;
+    }
+    return Function;
+}
+
+int64_t file_mtime_ns(const fs::path& path, std::error_code& ec) {
+    auto time = fs::last_write_time(path, ec);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+void write_string(std::vector<uint8_t>& out, std::string_view text) {
+    varint_encode(out, text.size());
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+bool read_string(const uint8_t* data, size_t size, size_t& pos, std::string& text) {
+    uint64_t length;
+    if (!varint_decode(data, size, pos, length) || length > size - pos) return false;
+    text.assign(reinterpret_cast<const char*>(data + pos), length);
+    pos += length;
+    return true;
+}
+
+} // namespace
+
+std::vector<SymbolDef> scan_symbols(std::string_view source, SourceLanguage language) {
+    if (language == SourceLanguage::Unknown) return {};
+    return SymbolScanner(source, language).run();
+}
+
+// ============================================================================
+// SymbolIndex
+// ============================================================================
+
+namespace {
+
+std::vector<SymbolDef> scan_file_symbols(const fs::path& path) {
+    MappedFile file;
+    if (!file.open(path.string())) return {};
+    // Binary files (NUL in the first 8 KiB, as in FileSearcher) have no symbols
+    std::string_view head = file.view().substr(0, 8192);
+    if (head.find('\0') != std::string_view::npos) return {};
+    return scan_symbols(file.view(), language_for_path(path.generic_string()));
+}
+
+} // namespace
+
+SymbolIndex::SymbolIndex(std::string root) : root_(std::move(root)) {}
+
+size_t SymbolIndex::build(const std::vector<std::string>& include_globs, unsigned threads) {
+    struct Cached {
+        uint64_t size;
+        int64_t mtime_ns;
+    };
+    std::unordered_map<std::string, Cached> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const FileEntry& file : files_) {
+            if (file.present) cached.emplace(file.path, Cached{file.size, file.mtime_ns});
+        }
+    }
+
+    struct Scanned {
+        std::string rel_path;
+        uint64_t size;
+        int64_t mtime_ns;
+        bool rescanned;
+        std::vector<SymbolDef> symbols;
+    };
+    std::vector<Scanned> scanned;
+    std::mutex scanned_mutex;
+
+    WalkOptions options;
+    options.include_globs = include_globs;
+    if (options.include_globs.empty()) {
+        options.include_globs.assign(std::begin(kSourceGlobs), std::end(kSourceGlobs));
+    }
+    options.threads = threads;
+
+    FileWalker(root_, options).walk([&](const std::string& rel_path, const fs::path& path) {
+        std::error_code ec;
+        Scanned entry{rel_path, fs::file_size(path, ec), 0, false, {}};
+        entry.mtime_ns = file_mtime_ns(path, ec);
+        if (ec) return;
+
+        auto it = cached.find(rel_path);
+        if (it == cached.end() || it->second.size != entry.size || it->second.mtime_ns != entry.mtime_ns) {
+            entry.symbols = scan_file_symbols(path);
+            entry.rescanned = true;
+        }
+        std::lock_guard<std::mutex> lock(scanned_mutex);
+        scanned.push_back(std::move(entry));
+    });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_set<std::string> seen;
+    size_t rescanned = 0;
+    for (auto& entry : scanned) {
+        seen.insert(entry.rel_path);
+        if (!entry.rescanned) continue;
+        std::vector<Symbol> symbols;
+        symbols.reserve(entry.symbols.size());
+        for (auto& def : entry.symbols) {
+            symbols.push_back(Symbol{std::move(def.name), def.line, def.column, kind_code(def.kind),
+                                     std::move(def.signature)});
+        }
+        set_file(file_id(entry.rel_path), entry.size, entry.mtime_ns, std::move(symbols));
+        ++rescanned;
+    }
+    for (uint32_t id = 0; id < files_.size(); ++id) {
+        if (files_[id].present && !seen.count(files_[id].path)) drop_file(id);
+    }
+    compact();
+    return rescanned;
+}
+
+void SymbolIndex::update_file(const std::string& rel_path) {
+    const fs::path path = fs::path(root_) / fs::u8path(rel_path);
+    std::error_code ec;
+    const bool exists = fs::is_regular_file(path, ec);
+    uint64_t size = exists ? fs::file_size(path, ec) : 0;
+    int64_t mtime_ns = exists ? file_mtime_ns(path, ec) : 0;
+    if (!exists || ec || language_for_path(rel_path) == SourceLanguage::Unknown) {
+        remove_file(rel_path);
+        return;
+    }
+
+    std::vector<Symbol> symbols;
+    for (auto& def : scan_file_symbols(path)) {
+        symbols.push_back(Symbol{std::move(def.name), def.line, def.column, kind_code(def.kind),
+                                 std::move(def.signature)});
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_file(file_id(rel_path), size, mtime_ns, std::move(symbols));
+}
+
+void SymbolIndex::remove_file(const std::string& rel_path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = file_ids_.find(rel_path);
+    if (it != file_ids_.end()) drop_file(it->second);
+}
+
+bool SymbolIndex::save(const std::string& path) const {
+    std::vector<uint8_t> out(std::begin(kIndexMagic), std::end(kIndexMagic));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t present = 0;
+        for (const FileEntry& file : files_) present += file.present;
+        varint_encode(out, present);
+        for (const FileEntry& file : files_) {
+            if (!file.present) continue;
+            write_string(out, file.path);
+            varint_encode(out, file.size);
+            varint_encode(out, zigzag_encode(file.mtime_ns));
+            varint_encode(out, file.symbols.size());
+            for (const Symbol& symbol : file.symbols) {
+                write_string(out, symbol.name);
+                varint_encode(out, static_cast<uint64_t>(symbol.line));
+                varint_encode(out, static_cast<uint64_t>(symbol.column));
+                out.push_back(symbol.kind);
+                write_string(out, symbol.signature);
+            }
+        }
+    }
+
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+        if (!file) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    return !ec;
+}
+
+bool SymbolIndex::load(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(kIndexMagic) ||
+        std::memcmp(file.data(), kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        return false;
+    }
+
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+    size_t pos = sizeof(kIndexMagic);
+
+    std::vector<FileEntry> entries;
+    uint64_t count;
+    if (!varint_decode(data, size, pos, count)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        FileEntry entry;
+        uint64_t mtime, symbol_count;
+        if (!read_string(data, size, pos, entry.path) || !varint_decode(data, size, pos, entry.size) ||
+            !varint_decode(data, size, pos, mtime) || !varint_decode(data, size, pos, symbol_count)) {
+            return false;
+        }
+        entry.mtime_ns = zigzag_decode(mtime);
+        entry.present = true;
+        for (uint64_t j = 0; j < symbol_count; ++j) {
+            Symbol symbol;
+            uint64_t line, column;
+            if (!read_string(data, size, pos, symbol.name) || !varint_decode(data, size, pos, line) ||
+                !varint_decode(data, size, pos, column) || pos >= size) {
+                return false;
+            }
+            symbol.line = static_cast<int>(line);
+            symbol.column = static_cast<int>(column);
+            symbol.kind = std::min<uint8_t>(data[pos++], Macro);
+            if (!read_string(data, size, pos, symbol.signature)) return false;
+            entry.symbols.push_back(std::move(symbol));
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_ = std::move(entries);
+    file_ids_.clear();
+    for (uint32_t id = 0; id < files_.size(); ++id) file_ids_.emplace(files_[id].path, id);
+    overlay_.clear();
+    overlay_symbols_ = 0;
+    table_.clear();
+    compact();
+    return true;
+}
+
+std::vector<SymbolDef> SymbolIndex::find(const std::string& name, size_t limit) const {
+    return lookup(name, false, limit);
+}
+
+std::vector<SymbolDef> SymbolIndex::find_prefix(const std::string& prefix, size_t limit) const {
+    return lookup(prefix, true, limit);
+}
+
+std::vector<SymbolDef> SymbolIndex::symbols_in(const std::string& rel_path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<SymbolDef> out;
+    auto it = file_ids_.find(rel_path);
+    if (it == file_ids_.end()) return out;
+    for (const Symbol& symbol : files_[it->second].symbols) out.push_back(to_def(it->second, symbol));
+    return out;
+}
+
+size_t SymbolIndex::symbol_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const FileEntry& file : files_) count += file.symbols.size();
+    return count;
+}
+
+size_t SymbolIndex::file_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const FileEntry& file : files_) count += file.present;
+    return count;
+}
+
+uint32_t SymbolIndex::file_id(const std::string& rel_path) {
+    auto it = file_ids_.find(rel_path);
+    if (it != file_ids_.end()) return it->second;
+    uint32_t id = static_cast<uint32_t>(files_.size());
+    files_.push_back(FileEntry{});
+    files_.back().path = rel_path;
+    file_ids_.emplace(rel_path, id);
+    return id;
+}
+
+void SymbolIndex::set_file(uint32_t id, uint64_t size, int64_t mtime_ns, std::vector<Symbol> symbols) {
+    drop_file(id);
+    FileEntry& file = files_[id];
+    file.present = true;
+    file.size = size;
+    file.mtime_ns = mtime_ns;
+    file.symbols = std::move(symbols);
+    file.in_overlay = true;
+    overlay_.push_back(id);
+    overlay_symbols_ += file.symbols.size();
+
+    if (overlay_symbols_ + table_symbols_stale_ > std::max(kMinCompaction, table_.size() / 8)) compact();
+}
+
+void SymbolIndex::drop_file(uint32_t id) {
+    FileEntry& file = files_[id];
+    if (file.in_table) {
+        file.in_table = false;
+        table_symbols_stale_ += file.symbols.size();
+    }
+    if (file.in_overlay) {
+        file.in_overlay = false;
+        overlay_.erase(std::find(overlay_.begin(), overlay_.end(), id));
+        overlay_symbols_ -= file.symbols.size();
+    }
+    file.present = false;
+    file.symbols.clear();
+}
+
+void SymbolIndex::compact() {
+    names_.clear();
+    table_.clear();
+    for (uint32_t id = 0; id < files_.size(); ++id) {
+        FileEntry& file = files_[id];
+        file.in_table = file.present;
+        file.in_overlay = false;
+        if (!file.present) continue;
+        for (uint32_t k = 0; k < file.symbols.size(); ++k) {
+            const std::string& name = file.symbols[k].name;
+            table_.push_back(TableEntry{static_cast<uint32_t>(names_.size()), static_cast<uint32_t>(name.size()), id, k});
+            names_ += name;
+        }
+    }
+    std::sort(table_.begin(), table_.end(), [this](const TableEntry& a, const TableEntry& b) {
+        int order = table_name(a).compare(table_name(b));
+        if (order != 0) return order < 0;
+        if (a.file_id != b.file_id) return files_[a.file_id].path < files_[b.file_id].path;
+        return a.symbol < b.symbol;
+    });
+    overlay_.clear();
+    overlay_symbols_ = 0;
+    table_symbols_stale_ = 0;
+}
+
+std::string_view SymbolIndex::table_name(const TableEntry& entry) const {
+    return std::string_view(names_).substr(entry.name_offset, entry.name_length);
+}
+
+SymbolDef SymbolIndex::to_def(uint32_t id, const Symbol& symbol) const {
+    return SymbolDef{symbol.name, files_[id].path, symbol.line, symbol.column, kKinds[symbol.kind], symbol.signature};
+}
+
+std::vector<SymbolDef> SymbolIndex::lookup(const std::string& key, bool prefix, size_t limit) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto matches = [&](std::string_view name) {
+        return prefix ? name.substr(0, key.size()) == key : name == key;
+    };
+
+    std::vector<SymbolDef> out;
+    auto it = std::lower_bound(table_.begin(), table_.end(), key, [this](const TableEntry& entry, const std::string& k) {
+        return table_name(entry) < k;
+    });
+    for (; it != table_.end() && matches(table_name(*it)); ++it) {
+        if (limit && out.size() >= limit) break;
+        if (files_[it->file_id].in_table) out.push_back(to_def(it->file_id, files_[it->file_id].symbols[it->symbol]));
+    }
+
+    const size_t from_table = out.size();
+    for (uint32_t id : overlay_) {
+        for (const Symbol& symbol : files_[id].symbols) {
+            if (matches(symbol.name)) out.push_back(to_def(id, symbol));
+        }
+    }
+    if (out.size() > from_table) {
+        std::sort(out.begin(), out.end(), [](const SymbolDef& a, const SymbolDef& b) {
+            if (a.name != b.name) return a.name < b.name;
+            if (a.path != b.path) return a.path < b.path;
+            return a.line < b.line;
+        });
+    }
+    if (limit && out.size() > limit) out.resize(limit);
+    return out;
+}
+
+} // namespace isaac
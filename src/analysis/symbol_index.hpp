@@ -0,0 +1,108 @@
+#pragma once
+
+#include "source_lexer.hpp"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+struct SymbolDef {
+    std::string name;
+    std::string path;           // project-relative; empty from scan_symbols()
+    int line = 0;               // 1-based
+    int column = 0;             // 0-based byte column of the name
+    std::string kind;           // "function", "method", "class", "struct", "enum", "interface",
+                                // "type", "namespace", "variable" or "macro"
+    std::string signature;      // defining line, trimmed and capped at 160 bytes
+};
+
+// Definitions in one source file (Python, JS/TS, C/C++)
+std::vector<SymbolDef> scan_symbols(std::string_view source, SourceLanguage language);
+
+/**
+ * Project-wide symbol table for go-to-definition.
+ *
+ * Symbols live in a sorted string table (one name blob plus fixed-size
+ * entries ordered by name), so exact and prefix lookups are a binary search.
+ * Updated files go to a small overlay that is scanned linearly and masks
+ * their stale table entries; the table is re-sorted once the overlay grows
+ * past a fraction of it. Scans are cached by size and mtime like
+ * DependencyGraph, including across sessions via save()/load().
+ */
+class SymbolIndex {
+public:
+    explicit SymbolIndex(std::string root);
+
+    // Walk the tree and rescan changed files; returns the number of files scanned
+    size_t build(const std::vector<std::string>& include_globs = {}, unsigned threads = 0);
+
+    // Rescan one file (drops it if it no longer exists)
+    void update_file(const std::string& rel_path);
+    void remove_file(const std::string& rel_path);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Sorted by name, then path and line; limit 0 = unlimited
+    std::vector<SymbolDef> find(const std::string& name, size_t limit = 0) const;
+    std::vector<SymbolDef> find_prefix(const std::string& prefix, size_t limit = 100) const;
+    std::vector<SymbolDef> symbols_in(const std::string& rel_path) const;
+
+    size_t symbol_count() const;
+    size_t file_count() const;
+
+private:
+    struct Symbol {
+        std::string name;
+        int line;
+        int column;
+        uint8_t kind;
+        std::string signature;
+    };
+
+    struct FileEntry {
+        std::string path;
+        bool present = false;
+        bool in_table = false;      // table_ holds this file's current symbols
+        bool in_overlay = false;
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+        std::vector<Symbol> symbols;
+    };
+
+    struct TableEntry {
+        uint32_t name_offset;
+        uint32_t name_length;
+        uint32_t file_id;
+        uint32_t symbol;            // index into FileEntry::symbols
+    };
+
+    uint32_t file_id(const std::string& rel_path);
+    void set_file(uint32_t id, uint64_t size, int64_t mtime_ns, std::vector<Symbol> symbols);
+    void drop_file(uint32_t id);
+    void compact();
+    std::string_view table_name(const TableEntry& entry) const;
+    SymbolDef to_def(uint32_t id, const Symbol& symbol) const;
+    std::vector<SymbolDef> lookup(const std::string& key, bool prefix, size_t limit) const;
+
+    std::string root_;
+    std::vector<FileEntry> files_;
+    std::unordered_map<std::string, uint32_t> file_ids_;
+
+    // Sorted string table over files with in_table set
+    std::string names_;
+    std::vector<TableEntry> table_;
+    size_t table_symbols_stale_ = 0;    // entries masked by overlay or removal
+
+    // Files updated since the last compaction
+    std::vector<uint32_t> overlay_;
+    size_t overlay_symbols_ = 0;
+
+    mutable std::mutex mutex_;
+};
+
+} // namespace isaac
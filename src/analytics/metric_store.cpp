@@ -0,0 +1,774 @@
+#include "metric_store.hpp"
+#include "core/crc32.hpp"
+#include "core/file_io.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t kFrameHeader = 8;     // [u32 length][u32 crc32]
+constexpr int64_t kSecondUs = 1000000;
+constexpr int64_t kHourUs = 3600 * kSecondUs;
+constexpr int64_t kDayUs = 24 * kHourUs;
+constexpr int64_t kPlausibleUs = int64_t(1e17);     // local calendar math stays sane below this
+
+// Timestamp delta-of-delta buckets, selected by a unary prefix of 0-4 one bits
+constexpr int kDodWidths[] = {0, 12, 20, 32, 64};
+
+int count_leading_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+    while (!(value & (uint64_t(1) << 63))) {
+        value <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+int count_trailing_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+bool fits(int64_t value, int bits) {
+    return value >= -(int64_t(1) << (bits - 1)) && value < (int64_t(1) << (bits - 1));
+}
+
+uint64_t bits_of(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double double_of(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Saturates instead of overflowing for open-ended ranges
+int64_t to_us(double seconds) {
+    if (seconds <= -9.2e12) return INT64_MIN;
+    if (seconds >= 9.2e12) return INT64_MAX;
+    return static_cast<int64_t>(std::llround(seconds * 1e6));
+}
+
+double from_us(int64_t us) {
+    return static_cast<double>(us) / 1e6;
+}
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+int64_t floor_div(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return quotient - ((value % divisor != 0) && (value < 0));
+}
+
+bool local_time(time_t seconds, std::tm& out) {
+#ifdef _WIN32
+    return ::localtime_s(&out, &seconds) == 0;
+#else
+    return ::localtime_r(&seconds, &out) != nullptr;
+#endif
+}
+
+uint32_t get_u32(const uint8_t* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+void put_u32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out += static_cast<char>(value >> (8 * i));
+}
+
+#ifdef _WIN32
+int open_append(const std::string& path) {
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, 0644);
+}
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        int written = ::_write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1 << 30)));
+        if (written < 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+bool close_fd(int fd) { return ::_close(fd) == 0; }
+#else
+int open_append(const std::string& path) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+}
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+bool close_fd(int fd) { return ::close(fd) == 0; }
+#endif
+
+// Intact frames from the start of data; returns the end of the last one
+template <typename Visit>
+size_t walk_frames(const uint8_t* data, size_t size, Visit&& visit) {
+    size_t offset = 0;
+    while (size - offset >= kFrameHeader) {
+        uint32_t length = get_u32(data + offset);
+        if (length > size - offset - kFrameHeader) break;
+        const uint8_t* bytes = data + offset + kFrameHeader;
+        if (crc32(bytes, length) != get_u32(data + offset + 4)) break;
+        visit(std::string_view(reinterpret_cast<const char*>(bytes), length));
+        offset += kFrameHeader + length;
+    }
+    return offset;
+}
+
+// The lock file beside path, creating the directory both live in
+fs::path lock_path(const std::string& path) {
+    std::error_code ec;
+    fs::path parent = fs::path(path).parent_path();
+    if (!parent.empty()) fs::create_directories(parent, ec);
+    return fs::path(path + ".lock");
+}
+
+std::string read_range(const std::string& path, uint64_t offset, uint64_t size) {
+    std::ifstream file(path, std::ios::binary);
+    std::string bytes;
+    if (!file || !file.seekg(static_cast<std::streamoff>(offset))) return bytes;
+    bytes.resize(size);
+    file.read(bytes.data(), static_cast<std::streamsize>(size));
+    bytes.resize(static_cast<size_t>(file.gcount()));
+    return bytes;
+}
+
+// ----------------------------------------------------------------------------
+// Chunk codec
+// ----------------------------------------------------------------------------
+
+class BitWriter {
+public:
+    // Low `bits` bits of value, most significant first; bits in 1..64
+    void write(uint64_t value, int bits) {
+        while (bits > 0) {
+            if (free_ == 0) {
+                bytes_.push_back('\0');
+                free_ = 8;
+            }
+            int take = std::min(bits, free_);
+            auto part = static_cast<uint8_t>((value >> (bits - take)) & ((1u << take) - 1));
+            bytes_.back() = static_cast<char>(static_cast<uint8_t>(bytes_.back()) | part << (free_ - take));
+            free_ -= take;
+            bits -= take;
+        }
+    }
+
+    const std::string& bytes() const { return bytes_; }
+    std::string take() {
+        free_ = 0;
+        return std::move(bytes_);
+    }
+
+private:
+    std::string bytes_;
+    int free_ = 0;                      // unused low bits of the last byte
+};
+
+class BitReader {
+public:
+    explicit BitReader(std::string_view data)
+        : data_(reinterpret_cast<const uint8_t*>(data.data())), size_(data.size() * 8) {}
+
+    bool read(int bits, uint64_t& value) {
+        if (static_cast<size_t>(bits) > size_ - pos_) return false;
+        value = 0;
+        while (bits > 0) {
+            int offset = static_cast<int>(pos_ & 7);
+            int take = std::min(bits, 8 - offset);
+            uint8_t part = static_cast<uint8_t>(data_[pos_ >> 3] >> (8 - offset - take)) & ((1u << take) - 1);
+            value = value << take | part;
+            pos_ += static_cast<size_t>(take);
+            bits -= take;
+        }
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+// Open chunk: points encoded as they are appended
+struct ChunkEncoder {
+    BitWriter out;
+    uint32_t count = 0;
+    int64_t min_us = 0;
+    int64_t max_us = 0;
+    uint64_t prev_us = 0;
+    uint64_t prev_delta = 0;
+    uint64_t prev_bits = 0;
+    int leading = -1;                   // current XOR window; -1 until the first one
+    int trailing = 0;
+
+    void append(int64_t us, double value) {
+        uint64_t bits = bits_of(value);
+        if (count++ == 0) {
+            min_us = max_us = us;
+            out.write(static_cast<uint64_t>(us), 64);
+            out.write(bits, 64);
+            prev_us = static_cast<uint64_t>(us);
+            prev_bits = bits;
+            return;
+        }
+        min_us = std::min(min_us, us);
+        max_us = std::max(max_us, us);
+
+        // Unsigned arithmetic wraps, so any pair of timestamps round-trips
+        uint64_t delta = static_cast<uint64_t>(us) - prev_us;
+        auto dod = static_cast<int64_t>(delta - prev_delta);
+        int bucket = 0;
+        if (dod != 0) {
+            bucket = 1;
+            while (bucket < 4 && !fits(dod, kDodWidths[bucket])) ++bucket;
+        }
+        // Prefix: `bucket` one bits then a zero; the widest bucket has no zero
+        out.write(bucket < 4 ? ((uint64_t(1) << bucket) - 1) << 1 : 0b1111, bucket < 4 ? bucket + 1 : 4);
+        if (kDodWidths[bucket]) out.write(static_cast<uint64_t>(dod), kDodWidths[bucket]);
+        prev_delta = delta;
+        prev_us = static_cast<uint64_t>(us);
+
+        uint64_t x = bits ^ prev_bits;
+        prev_bits = bits;
+        if (x == 0) {
+            out.write(0, 1);
+            return;
+        }
+        int lead = std::min(count_leading_zeros(x), 31);
+        int trail = count_trailing_zeros(x);
+        if (leading >= 0 && lead >= leading && trail >= trailing) {
+            out.write(0b10, 2);
+            out.write(x >> trailing, 64 - leading - trailing);
+            return;
+        }
+        int meaningful = 64 - lead - trail;
+        out.write(0b11, 2);
+        out.write(static_cast<uint64_t>(lead), 5);
+        out.write(static_cast<uint64_t>(meaningful & 63), 6);
+        out.write(x >> trail, meaningful);
+        leading = lead;
+        trailing = trail;
+    }
+};
+
+// Returns false (having visited a prefix) if the data is damaged
+template <typename Visit>
+bool decode_chunk(std::string_view data, uint32_t count, Visit&& visit) {
+    if (count == 0) return true;
+    BitReader in(data);
+    uint64_t us, bits;
+    if (!in.read(64, us) || !in.read(64, bits)) return false;
+    visit(static_cast<int64_t>(us), double_of(bits));
+
+    uint64_t delta = 0;
+    int leading = 0, meaningful = 0;
+    for (uint32_t i = 1; i < count; ++i) {
+        int bucket = 0;
+        uint64_t flag;
+        while (bucket < 4) {
+            if (!in.read(1, flag)) return false;
+            if (!flag) break;
+            ++bucket;
+        }
+        uint64_t dod = 0;
+        if (int width = kDodWidths[bucket]) {
+            if (!in.read(width, dod)) return false;
+            if (width < 64 && (dod >> (width - 1)) & 1) dod |= ~uint64_t(0) << width;    // sign-extend
+        }
+        delta += dod;
+        us += delta;
+
+        if (!in.read(1, flag)) return false;
+        if (flag) {
+            if (!in.read(1, flag)) return false;
+            if (flag) {
+                uint64_t lead, length;
+                if (!in.read(5, lead) || !in.read(6, length)) return false;
+                leading = static_cast<int>(lead);
+                meaningful = length ? static_cast<int>(length) : 64;
+                if (leading + meaningful > 64) return false;
+            } else if (meaningful == 0) {
+                return false;           // window reused before one was set
+            }
+            uint64_t x;
+            if (!in.read(meaningful, x)) return false;
+            bits ^= x << (64 - leading - meaningful);
+        }
+        visit(static_cast<int64_t>(us), double_of(bits));
+    }
+    return true;
+}
+
+struct Chunk {
+    int64_t min_us = 0;
+    int64_t max_us = 0;
+    uint32_t count = 0;
+    std::string data;
+};
+
+// Frame payload: writer nonce, series, count, zigzag min, max - min, bit stream
+std::string encode_frame(uint64_t nonce, const std::string& series, const Chunk& chunk) {
+    std::vector<uint8_t> payload;
+    varint_encode(payload, nonce);
+    put_string(payload, series);
+    varint_encode(payload, chunk.count);
+    varint_encode(payload, zigzag_encode(chunk.min_us));
+    varint_encode(payload, static_cast<uint64_t>(chunk.max_us) - static_cast<uint64_t>(chunk.min_us));
+    put_string(payload, chunk.data);
+
+    std::string frame;
+    frame.reserve(kFrameHeader + payload.size());
+    put_u32(frame, static_cast<uint32_t>(payload.size()));
+    put_u32(frame, crc32(payload.data(), payload.size()));
+    frame.append(payload.begin(), payload.end());
+    return frame;
+}
+
+struct Bucket {
+    int64_t end_us = 0;
+    uint64_t count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+
+    void add(double value) {
+        min = count ? std::min(min, value) : value;
+        max = count ? std::max(max, value) : value;
+        sum += value;
+        ++count;
+    }
+};
+
+void merge(MetricBucket& into, const Bucket& bucket) {
+    if (!bucket.count) return;
+    into.min = into.count ? std::min(into.min, bucket.min) : bucket.min;
+    into.max = into.count ? std::max(into.max, bucket.max) : bucket.max;
+    into.sum += bucket.sum;
+    into.count += bucket.count;
+}
+
+// Local calendar day containing a timestamp, cached across calls
+class DayCache {
+public:
+    void find(int64_t us, int64_t& start, int64_t& end) {
+        if (us < start_us_ || us >= end_us_) compute(us);
+        start = start_us_;
+        end = end_us_;
+    }
+
+private:
+    void compute(int64_t us) {
+        std::tm day{};
+        if (us > -kPlausibleUs && us < kPlausibleUs &&
+            local_time(static_cast<time_t>(floor_div(us, kSecondUs)), day)) {
+            day.tm_hour = day.tm_min = day.tm_sec = 0;
+            day.tm_isdst = -1;
+            std::tm next = day;
+            next.tm_mday += 1;
+            start_us_ = static_cast<int64_t>(std::mktime(&day)) * kSecondUs;
+            end_us_ = static_cast<int64_t>(std::mktime(&next)) * kSecondUs;
+            if (us >= start_us_ && us < end_us_) return;
+        }
+        start_us_ = floor_div(us, kDayUs) * kDayUs;     // UTC days outside local time's range
+        end_us_ = start_us_ <= INT64_MAX - kDayUs ? start_us_ + kDayUs : INT64_MAX;
+    }
+
+    int64_t start_us_ = 1;
+    int64_t end_us_ = 0;
+};
+
+} // namespace
+
+struct MetricStore::Series {
+    std::vector<Chunk> sealed;
+    ChunkEncoder open;
+    std::chrono::steady_clock::time_point opened;
+    std::map<int64_t, Bucket> hours;    // by bucket start
+    std::map<int64_t, Bucket> days;
+    DayCache day_cache;
+    uint64_t points = 0;
+
+    void fold(int64_t us, double value) {
+        int64_t hour = floor_div(us, kHourUs) * kHourUs;
+        Bucket& by_hour = hours[hour];
+        by_hour.end_us = hour <= INT64_MAX - kHourUs ? hour + kHourUs : INT64_MAX;
+        by_hour.add(value);
+
+        int64_t day, day_end;
+        day_cache.find(us, day, day_end);
+        Bucket& by_day = days[day];
+        by_day.end_us = day_end;
+        by_day.add(value);
+        ++points;
+    }
+
+    void append(int64_t us, double value) {
+        if (open.count == 0) opened = std::chrono::steady_clock::now();
+        open.append(us, value);
+        fold(us, value);
+    }
+
+    Chunk take_open() {
+        Chunk chunk;
+        chunk.min_us = open.min_us;
+        chunk.max_us = open.max_us;
+        chunk.count = open.count;
+        chunk.data = open.out.take();
+        open = ChunkEncoder{};
+        return chunk;
+    }
+
+    // Points within [lo, hi] of every chunk that may hold some
+    template <typename Visit>
+    void for_each_point(int64_t lo, int64_t hi, Visit&& visit) const {
+        auto scan = [&](std::string_view data, uint32_t count, int64_t min_us, int64_t max_us) {
+            if (!count || max_us < lo || min_us > hi) return;
+            decode_chunk(data, count, [&](int64_t us, double value) {
+                if (us >= lo && us <= hi) visit(us, value);
+            });
+        };
+        for (const Chunk& chunk : sealed) scan(chunk.data, chunk.count, chunk.min_us, chunk.max_us);
+        scan(open.out.bytes(), open.count, open.min_us, open.max_us);
+    }
+};
+
+MetricStore::MetricStore(std::string path, MetricStoreOptions options)
+    : path_(std::move(path)), options_(options), nonce_([] {
+          std::random_device random;
+          return uint64_t(random()) << 32 ^ random();
+      }()),
+      file_lock_(lock_path(path_)) {
+    if (options_.chunk_points == 0) throw std::invalid_argument("chunk_points must be positive");
+    std::lock_guard<FileLock> shared(file_lock_);
+    reload();
+
+    // Cut a torn tail from a crash mid-write so new frames stay reachable;
+    // nobody else can be appending while we hold the lock
+    std::error_code ec;
+    uint64_t size = fs::file_size(path_, ec);
+    if (!ec && size > known_end_) fs::resize_file(path_, known_end_, ec);
+}
+
+MetricStore::~MetricStore() {
+    try {
+        flush();
+    } catch (...) {
+    }
+}
+
+MetricStore::Series& MetricStore::series_for(const std::string& name) {
+    auto found = series_.find(name);
+    if (found == series_.end()) found = series_.emplace(name, std::make_unique<Series>()).first;
+    return *found->second;
+}
+
+void MetricStore::ingest(std::string_view payload, bool skip_own) {
+    VarintReader reader(payload);
+    uint64_t nonce, count, min_zigzag, spread;
+    std::string name;
+    Chunk chunk;
+    if (!reader.number(nonce) || !reader.string(name) || !reader.number(count) || !reader.number(min_zigzag) ||
+        !reader.number(spread) || !reader.string(chunk.data) || count > UINT32_MAX || name.empty()) {
+        return;
+    }
+    if (skip_own && nonce == nonce_) return;
+    chunk.count = static_cast<uint32_t>(count);
+    chunk.min_us = zigzag_decode(min_zigzag);
+    chunk.max_us = static_cast<int64_t>(static_cast<uint64_t>(chunk.min_us) + spread);
+
+    std::vector<std::pair<int64_t, double>> points;
+    points.reserve(chunk.count);
+    if (!decode_chunk(chunk.data, chunk.count, [&](int64_t us, double value) { points.emplace_back(us, value); })) {
+        return;
+    }
+    Series& series = series_for(name);
+    for (const auto& [us, value] : points) series.fold(us, value);
+    series.sealed.push_back(std::move(chunk));
+}
+
+void MetricStore::reload() {
+    // Open chunks are not in the file yet; carry them over
+    std::vector<std::pair<std::string, std::vector<std::pair<int64_t, double>>>> pending;
+    for (auto& [name, series] : series_) {
+        if (!series->open.count) continue;
+        pending.emplace_back(name, std::vector<std::pair<int64_t, double>>());
+        decode_chunk(series->open.out.bytes(), series->open.count,
+                     [&](int64_t us, double value) { pending.back().second.emplace_back(us, value); });
+    }
+    series_.clear();
+
+    std::string bytes;
+    {
+        std::ifstream file(path_, std::ios::binary);
+        if (file) bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    known_end_ = walk_frames(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(),
+                             [&](std::string_view payload) { ingest(payload, false); });
+
+    for (const auto& [name, points] : pending) {
+        Series& series = series_for(name);
+        for (const auto& [us, value] : points) series.append(us, value);
+    }
+}
+
+void MetricStore::refresh() {
+    std::error_code ec;
+    uint64_t size = fs::file_size(path_, ec);
+    if (ec || size == known_end_) return;
+    if (size < known_end_) {
+        reload();   // rewritten by drop_before in another process
+        return;
+    }
+    std::string tail = read_range(path_, known_end_, size - known_end_);
+    known_end_ += walk_frames(reinterpret_cast<const uint8_t*>(tail.data()), tail.size(),
+                              [&](std::string_view payload) { ingest(payload, true); });
+}
+
+void MetricStore::seal(const std::string& name, Series& series) {
+    Chunk chunk = series.take_open();
+    std::string frame = encode_frame(nonce_, name, chunk);
+    bool written;
+    {
+        std::lock_guard<FileLock> shared(file_lock_);
+        int fd = open_append(path_);
+        written = fd >= 0 && write_all(fd, frame.data(), frame.size());
+        if (fd >= 0 && !close_fd(fd)) written = false;
+    }
+    if (!written) ++write_errors_;
+    series.sealed.push_back(std::move(chunk));
+}
+
+void MetricStore::append(const std::string& name, double value, double timestamp) {
+    if (name.empty()) throw std::invalid_argument("metric series name must not be empty");
+    int64_t us = timestamp != 0 ? to_us(timestamp) : now_us();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& series = series_for(name);
+    if (series.open.count && std::chrono::steady_clock::now() - series.opened >=
+                                 std::chrono::milliseconds(options_.max_chunk_age_ms)) {
+        seal(name, series);
+    }
+    series.append(us, value);
+    if (series.open.count >= options_.chunk_points) seal(name, series);
+}
+
+void MetricStore::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [name, series] : series_) {
+        if (series->open.count) seal(name, *series);
+    }
+}
+
+std::vector<MetricPoint> MetricStore::points(const std::string& name, double since, double until) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh();
+    std::vector<MetricPoint> result;
+    auto found = series_.find(name);
+    if (found == series_.end()) return result;
+    found->second->for_each_point(to_us(since), to_us(until), [&](int64_t us, double value) {
+        result.push_back(MetricPoint{from_us(us), value});
+    });
+    std::stable_sort(result.begin(), result.end(),
+                     [](const MetricPoint& a, const MetricPoint& b) { return a.timestamp < b.timestamp; });
+    return result;
+}
+
+std::vector<MetricBucket> MetricStore::rollups(const std::string& name, const std::string& period, double since,
+                                               double until) {
+    if (period != "hour" && period != "day") {
+        throw std::invalid_argument("unknown rollup period '" + period + "', expected 'hour' or 'day'");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh();
+    std::vector<MetricBucket> result;
+    auto found = series_.find(name);
+    const int64_t since_us = to_us(since), until_us = to_us(until);
+    if (found == series_.end() || since_us > until_us) return result;
+    const Series& series = *found->second;
+    const std::map<int64_t, Bucket>& buckets = period == "day" ? series.days : series.hours;
+
+    // Whole buckets come from the rollup; the partial ones at either end are
+    // recounted from raw points
+    struct Picked {
+        int64_t start;
+        Bucket bucket;
+        bool partial;
+    };
+    std::vector<Picked> picked;
+    auto it = buckets.upper_bound(since_us);
+    if (it != buckets.begin()) --it;
+    for (; it != buckets.end() && it->first <= until_us; ++it) {
+        if (it->second.end_us <= since_us) continue;
+        bool partial = it->first < since_us || it->second.end_us - 1 > until_us;
+        Bucket bucket = it->second;
+        if (partial) bucket = Bucket{it->second.end_us};
+        picked.push_back(Picked{it->first, bucket, partial});
+    }
+    for (Picked* edge : {picked.empty() ? nullptr : &picked.front(), picked.size() < 2 ? nullptr : &picked.back()}) {
+        if (!edge || !edge->partial) continue;
+        int64_t lo = std::max(edge->start, since_us);
+        int64_t hi = std::min(edge->bucket.end_us - 1, until_us);
+        series.for_each_point(lo, hi, [&](int64_t, double value) { edge->bucket.add(value); });
+    }
+
+    for (const Picked& entry : picked) {
+        if (!entry.bucket.count) continue;
+        MetricBucket bucket;
+        bucket.start = from_us(entry.start);
+        merge(bucket, entry.bucket);
+        result.push_back(bucket);
+    }
+    return result;
+}
+
+MetricBucket MetricStore::summarize(const std::string& name, double since, double until) {
+    MetricBucket total;
+    total.start = since;
+    for (const MetricBucket& hour : rollups(name, "hour", since, until)) {
+        Bucket bucket;
+        bucket.count = hour.count;
+        bucket.sum = hour.sum;
+        bucket.min = hour.min;
+        bucket.max = hour.max;
+        merge(total, bucket);
+    }
+    return total;
+}
+
+std::vector<std::string> MetricStore::series(const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh();
+    std::vector<std::string> names;
+    for (auto it = series_.lower_bound(prefix);
+         it != series_.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        if (it->second->points) names.push_back(it->first);
+    }
+    return names;
+}
+
+uint64_t MetricStore::drop_before(double timestamp) {
+    const int64_t cutoff = to_us(timestamp);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Held from the last read to the rename, so no other process appends a chunk the rewrite misses
+    std::lock_guard<FileLock> shared(file_lock_);
+    refresh();
+
+    uint64_t dropped = 0;
+    std::vector<std::pair<std::string, std::vector<std::pair<int64_t, double>>>> kept;
+    for (auto& [name, series] : series_) {
+        kept.emplace_back(name, std::vector<std::pair<int64_t, double>>());
+        series->for_each_point(INT64_MIN, INT64_MAX, [&](int64_t us, double value) {
+            if (us < cutoff) {
+                ++dropped;
+            } else {
+                kept.back().second.emplace_back(us, value);
+            }
+        });
+    }
+    if (!dropped) return 0;
+
+    // Rebuild every series in time order and write the file from scratch
+    series_.clear();
+    std::string bytes;
+    for (auto& [name, points] : kept) {
+        if (points.empty()) continue;
+        std::stable_sort(points.begin(), points.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+        Series& series = series_for(name);
+        for (const auto& [us, value] : points) {
+            series.append(us, value);
+            if (series.open.count >= options_.chunk_points) series.sealed.push_back(series.take_open());
+        }
+        if (series.open.count) series.sealed.push_back(series.take_open());
+        for (const Chunk& chunk : series.sealed) bytes += encode_frame(nonce_, name, chunk);
+    }
+
+    std::string temp = path_ + ".tmp." + std::to_string(nonce_);
+    std::error_code ec;
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            file.close();
+            fs::remove(temp, ec);
+            ++write_errors_;
+            return dropped;
+        }
+    }
+    fs::rename(temp, path_, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        ++write_errors_;
+        return dropped;
+    }
+    known_end_ = bytes.size();
+    return dropped;
+}
+
+MetricStoreStats MetricStore::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    MetricStoreStats stats;
+    for (const auto& [name, series] : series_) {
+        if (!series->points) continue;
+        ++stats.series;
+        stats.points += series->points;
+        stats.chunks += series->sealed.size();
+        for (const Chunk& chunk : series->sealed) stats.encoded_bytes += chunk.data.size();
+        stats.encoded_bytes += series->open.out.bytes().size();
+    }
+    stats.write_errors = write_errors_;
+    return stats;
+}
+
+} // namespace isaac
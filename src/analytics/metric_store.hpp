@@ -0,0 +1,117 @@
+#pragma once
+
+#include "core/file_io.hpp"
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace isaac {
+
+struct MetricPoint {
+    double timestamp = 0;               // unix seconds
+    double value = 0;
+};
+
+struct MetricBucket {
+    double start = 0;                   // unix seconds: bucket start, or range start for summaries
+    uint64_t count = 0;
+    double sum = 0;
+    double min = 0;                     // valid when count > 0
+    double max = 0;
+};
+
+struct MetricStoreStats {
+    size_t series = 0;
+    uint64_t points = 0;
+    uint64_t chunks = 0;                // sealed chunks, in memory and on disk
+    uint64_t encoded_bytes = 0;         // compressed point data, sealed and open
+    uint64_t write_errors = 0;          // chunks that could not be appended to the file
+};
+
+struct MetricStoreOptions {
+    size_t chunk_points = 1024;         // a series' open chunk is written when full,
+    int max_chunk_age_ms = 10000;       // or when an append finds it older than this
+};
+
+/**
+ * Append-only time-series store: compressed timestamp/value columns per
+ * series, with hourly and daily rollups kept current on every append.
+ *
+ * Points are encoded into the series' open chunk as they arrive, Gorilla
+ * style: timestamps as delta-of-delta in variable-width bit buckets, values
+ * XOR'd with the previous value inside a leading/trailing-zero window, so a
+ * steady metric costs a few bits a point. Full or aged chunks are appended
+ * to the store file as [u32 length][u32 crc32][payload] frames; flush() and
+ * the destructor write the rest.
+ *
+ * Each append also folds the point into per-hour (UTC) and per-day (local
+ * midnight) buckets of count/sum/min/max. Range queries merge whole buckets
+ * and decode raw points only for the partial buckets at either end. Rollups
+ * are rebuilt from the chunks on open; chunks appended by other processes
+ * sharing the file are picked up at the next query. Appends, the torn-tail
+ * repair on open and drop_before's rewrite hold <path>.lock, so a rewrite
+ * never loses another process's chunk and a repair never cuts one short.
+ */
+class MetricStore {
+public:
+    explicit MetricStore(std::string path, MetricStoreOptions options = {});
+    ~MetricStore();     // flushes
+
+    MetricStore(const MetricStore&) = delete;
+    MetricStore& operator=(const MetricStore&) = delete;
+
+    static constexpr double kNoLimit = std::numeric_limits<double>::max();
+
+    // timestamp 0 = now. Throws std::invalid_argument for an empty series name.
+    void append(const std::string& series, double value, double timestamp = 0);
+
+    // Write every open chunk
+    void flush();
+
+    // Oldest first
+    std::vector<MetricPoint> points(const std::string& series, double since = -kNoLimit, double until = kNoLimit);
+
+    // Non-empty "hour" or "day" buckets overlapping [since, until], oldest
+    // first; edge buckets count only the points inside the range.
+    // Throws std::invalid_argument for any other period.
+    std::vector<MetricBucket> rollups(const std::string& series, const std::string& period,
+                                      double since = -kNoLimit, double until = kNoLimit);
+
+    // All points of a series within [since, until]
+    MetricBucket summarize(const std::string& series, double since = -kNoLimit, double until = kNoLimit);
+
+    // Sorted series names starting with prefix
+    std::vector<std::string> series(const std::string& prefix = "");
+
+    // Drop points older than timestamp and rewrite the file; returns the
+    // number of points dropped
+    uint64_t drop_before(double timestamp);
+
+    MetricStoreStats stats();
+
+    struct Series;
+
+private:
+    Series& series_for(const std::string& name);
+    void ingest(std::string_view payload, bool skip_own);
+    void refresh();
+    void reload();
+    void seal(const std::string& name, Series& series);
+
+    std::string path_;
+    MetricStoreOptions options_;
+    const uint64_t nonce_;              // tags chunks this instance wrote, to skip them when tailing
+    FileLock file_lock_;                // <path>.lock, shared with other processes
+    uint64_t known_end_ = 0;            // file bytes already read
+
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Series>> series_;
+    uint64_t write_errors_ = 0;
+};
+
+} // namespace isaac
@@ -8,6 +8,27 @@
 #include "core/routing/device_routing_strategy.hpp"
 #include "core/routing/task_mode_strategy.hpp"
 #include "core/routing/agentic_mode_strategy.hpp"
+#include "analysis/dependency_graph.hpp"
+#include "analysis/symbol_index.hpp"
+#include "analytics/metric_store.hpp"
+#include "core/metrics.hpp"
+#include "fileops/batch_replace.hpp"
+#include "fileops/edit_buffer.hpp"
+#include "fileops/file_search.hpp"
+#include "logging/event_log.hpp"
+#include "monitoring/system_sampler.hpp"
+#include "pipelines/pipeline_engine.hpp"
+#include "queue/command_queue.hpp"
+#include "queue/message_store.hpp"
+#include "search/bm25_index.hpp"
+#include "search/context_builder.hpp"
+#include "search/memory_index.hpp"
+#include "search/vector_store.hpp"
+#include "snapshots/snapshot_store.hpp"
+#include "snapshots/timeline_index.hpp"
+#include "snapshots/workspace_capture.hpp"
+#include "tasks/cron_scheduler.hpp"
+#include "tasks/task_engine.hpp"
 
 namespace py = pybind11;
 using namespace isaac;
@@ -15,11 +36,31 @@ using namespace isaac;
 PYBIND11_MODULE(isaac_core, m) {
     m.doc() = "Isaac C++ Core Module - High-performance command routing and validation";
 
+    // CommandCounters struct - resource use of a profiled command
+    py::class_<CommandCounters>(m, "CommandCounters")
+        .def_readonly("available", &CommandCounters::available)
+        .def_readonly("hardware", &CommandCounters::hardware)
+        .def_readonly("task_clock_ns", &CommandCounters::task_clock_ns)
+        .def_readonly("context_switches", &CommandCounters::context_switches)
+        .def_readonly("cpu_migrations", &CommandCounters::cpu_migrations)
+        .def_readonly("page_faults", &CommandCounters::page_faults)
+        .def_readonly("cycles", &CommandCounters::cycles)
+        .def_readonly("instructions", &CommandCounters::instructions)
+        .def_readonly("wall_seconds", &CommandCounters::wall_seconds)
+        .def_readonly("user_seconds", &CommandCounters::user_seconds)
+        .def_readonly("system_seconds", &CommandCounters::system_seconds)
+        .def_readonly("max_rss_bytes", &CommandCounters::max_rss_bytes)
+        .def_readonly("major_faults", &CommandCounters::major_faults)
+        .def_readonly("voluntary_switches", &CommandCounters::voluntary_switches)
+        .def_readonly("involuntary_switches", &CommandCounters::involuntary_switches)
+        .def_readonly("timed_out", &CommandCounters::timed_out);
+
     // CommandResult struct
     py::class_<CommandResult>(m, "CommandResult")
         .def_readonly("success", &CommandResult::success)
         .def_readonly("output", &CommandResult::output)
-        .def_readonly("exit_code", &CommandResult::exit_code);
+        .def_readonly("exit_code", &CommandResult::exit_code)
+        .def_readonly("counters", &CommandResult::counters);
 
     // TierValidator class
     py::class_<TierValidator, std::shared_ptr<TierValidator>>(m, "TierValidator")
@@ -34,6 +75,9 @@ PYBIND11_MODULE(isaac_core, m) {
         .def(py::init<>())
         .def("execute", &ShellAdapter::execute)
         .def("execute_with_timeout", &ShellAdapter::execute_with_timeout)
+        .def("execute_profiled", &ShellAdapter::execute_profiled,
+             py::arg("command"), py::arg("timeout_seconds") = 30,
+             py::call_guard<py::gil_scoped_release>())
         .def("get_shell_name", &ShellAdapter::get_shell_name)
         .def("is_available", &ShellAdapter::is_available);
 
@@ -87,4 +131,1020 @@ PYBIND11_MODULE(isaac_core, m) {
         .def_readonly("validator", &StrategyContext::validator)
         .def_readonly("shell", &StrategyContext::shell)
         .def_readonly("session", &StrategyContext::session);
-}
\ No newline at end of file
+
+    // SearchHit struct
+    py::class_<SearchHit>(m, "SearchHit")
+        .def_readonly("chunk_id", &SearchHit::chunk_id)
+        .def_readonly("file", &SearchHit::file)
+        .def_readonly("start_line", &SearchHit::start_line)
+        .def_readonly("end_line", &SearchHit::end_line)
+        .def_readonly("score", &SearchHit::score);
+
+    // Bm25Index class - local lexical search over indexed chunks
+    py::class_<Bm25Index, std::shared_ptr<Bm25Index>>(m, "Bm25Index")
+        .def(py::init<double, double>(), py::arg("k1") = 1.2, py::arg("b") = 0.75)
+        .def("add_chunk", &Bm25Index::add_chunk, py::call_guard<py::gil_scoped_release>())
+        .def("remove_file", &Bm25Index::remove_file)
+        .def("search", &Bm25Index::search, py::arg("query"), py::arg("top_k") = 5,
+             py::call_guard<py::gil_scoped_release>())
+        .def("size", &Bm25Index::size)
+        .def("term_count", &Bm25Index::term_count)
+        .def("memory_usage", &Bm25Index::memory_usage)
+        .def("clear", &Bm25Index::clear)
+        .def_static("tokenize", &Bm25Index::tokenize);
+
+    // VectorHit struct
+    py::class_<VectorHit>(m, "VectorHit")
+        .def_readonly("chunk_id", &VectorHit::chunk_id)
+        .def_readonly("similarity", &VectorHit::similarity);
+
+    // VectorStore class - on-box HNSW store for chunk embeddings
+    py::class_<VectorStore, std::shared_ptr<VectorStore>>(m, "VectorStore")
+        .def(py::init<size_t, size_t, size_t, uint32_t>(), py::arg("dim"), py::arg("m") = 16,
+             py::arg("ef_construction") = 200, py::arg("seed") = 42)
+        .def("insert", &VectorStore::insert, py::call_guard<py::gil_scoped_release>())
+        .def("remove", &VectorStore::remove)
+        .def("contains", &VectorStore::contains)
+        .def("search", &VectorStore::search, py::arg("query"), py::arg("k") = 5, py::arg("ef") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("exact_search", &VectorStore::exact_search, py::arg("query"), py::arg("k") = 5,
+             py::call_guard<py::gil_scoped_release>())
+        .def("compact", &VectorStore::compact, py::call_guard<py::gil_scoped_release>())
+        .def("save", &VectorStore::save, py::call_guard<py::gil_scoped_release>())
+        .def_static("open", &VectorStore::open)
+        .def("set_ef_search", &VectorStore::set_ef_search)
+        .def("dim", &VectorStore::dim)
+        .def("size", &VectorStore::size)
+        .def("deleted_count", &VectorStore::deleted_count)
+        .def("memory_usage", &VectorStore::memory_usage);
+
+    // ContextChunk struct
+    py::class_<ContextChunk>(m, "ContextChunk")
+        .def(py::init([](std::string file, int start_line, int end_line, std::string content, double score) {
+                 return ContextChunk{std::move(file), start_line, end_line, std::move(content), score};
+             }),
+             py::arg("file") = "", py::arg("start_line") = 0, py::arg("end_line") = 0,
+             py::arg("content") = "", py::arg("score") = 0.0)
+        .def_readwrite("file", &ContextChunk::file)
+        .def_readwrite("start_line", &ContextChunk::start_line)
+        .def_readwrite("end_line", &ContextChunk::end_line)
+        .def_readwrite("content", &ContextChunk::content)
+        .def_readwrite("score", &ContextChunk::score);
+
+    // ContextResult struct
+    py::class_<ContextResult>(m, "ContextResult")
+        .def_readonly("context", &ContextResult::context)
+        .def_readonly("tokens", &ContextResult::tokens)
+        .def_readonly("candidate_tokens", &ContextResult::candidate_tokens)
+        .def_readonly("selected", &ContextResult::selected)
+        .def_readonly("overlaps_removed", &ContextResult::overlaps_removed);
+
+    // ContextBuilder class - token-budgeted RAG context packing
+    py::class_<ContextBuilder, std::shared_ptr<ContextBuilder>>(m, "ContextBuilder")
+        .def(py::init<>())
+        .def("build", &ContextBuilder::build, py::arg("chunks"), py::arg("token_budget"),
+             py::arg("include_file_paths") = true, py::call_guard<py::gil_scoped_release>())
+        .def_static("estimate_tokens", &ContextBuilder::estimate_tokens);
+
+    // LineMatch struct
+    py::class_<LineMatch>(m, "LineMatch")
+        .def_readonly("line", &LineMatch::line)
+        .def_readonly("column", &LineMatch::column)
+        .def_readonly("match", &LineMatch::match)
+        .def_readonly("context", &LineMatch::context);
+
+    // FileMatches struct
+    py::class_<FileMatches>(m, "FileMatches")
+        .def_readonly("path", &FileMatches::path)
+        .def_readonly("matches", &FileMatches::matches)
+        .def_readonly("long_lines", &FileMatches::long_lines);
+
+    // SearchStream class - incremental results of a background search
+    py::class_<SearchStream, std::shared_ptr<SearchStream>>(m, "SearchStream")
+        .def("next_batch", &SearchStream::next_batch, py::arg("timeout_ms") = 100,
+             py::call_guard<py::gil_scoped_release>())
+        .def("finished", &SearchStream::finished)
+        .def("cancel", &SearchStream::cancel)
+        .def("files_scanned", &SearchStream::files_scanned)
+        .def("bytes_scanned", &SearchStream::bytes_scanned);
+
+    // FileSearcher class - parallel regex search over a project tree
+    auto make_search_options = [](std::vector<std::string> include_globs, bool ignore_case,
+                                  size_t max_matches_per_file, unsigned threads) {
+        SearchOptions options;
+        options.include_globs = std::move(include_globs);
+        options.ignore_case = ignore_case;
+        options.max_matches_per_file = max_matches_per_file;
+        options.threads = threads;
+        return options;
+    };
+
+    py::class_<FileSearcher, std::shared_ptr<FileSearcher>>(m, "FileSearcher")
+        .def(py::init<std::string>(), py::arg("root"))
+        .def("search",
+             [make_search_options](const FileSearcher& self, const std::string& pattern,
+                                   std::vector<std::string> include_globs, bool ignore_case,
+                                   size_t max_matches_per_file, unsigned threads) {
+                 py::gil_scoped_release release;
+                 return self.search(pattern, make_search_options(std::move(include_globs), ignore_case,
+                                                                  max_matches_per_file, threads));
+             },
+             py::arg("pattern"), py::arg("include_globs") = std::vector<std::string>{},
+             py::arg("ignore_case") = false, py::arg("max_matches_per_file") = 0, py::arg("threads") = 0)
+        .def("search_stream",
+             [make_search_options](const FileSearcher& self, const std::string& pattern,
+                                   std::vector<std::string> include_globs, bool ignore_case,
+                                   size_t max_matches_per_file, unsigned threads) {
+                 return self.search_stream(pattern, make_search_options(std::move(include_globs), ignore_case,
+                                                                        max_matches_per_file, threads));
+             },
+             py::arg("pattern"), py::arg("include_globs") = std::vector<std::string>{},
+             py::arg("ignore_case") = false, py::arg("max_matches_per_file") = 0, py::arg("threads") = 0)
+        .def_static("required_literal", &FileSearcher::required_literal)
+        .def_static("max_regex_subject", &FileSearcher::max_regex_subject);
+
+    // FileEdit struct
+    py::class_<FileEdit>(m, "FileEdit")
+        .def_readonly("path", &FileEdit::path)
+        .def_readonly("replacements", &FileEdit::replacements)
+        .def_readonly("original_size", &FileEdit::original_size)
+        .def_readonly("new_size", &FileEdit::new_size);
+
+    // ReplacePlan class - prepared all-or-nothing multi-file replace
+    py::class_<ReplacePlan, std::shared_ptr<ReplacePlan>>(m, "ReplacePlan")
+        .def("edits", &ReplacePlan::edits)
+        .def("total_replacements", &ReplacePlan::total_replacements)
+        .def("transaction_id", &ReplacePlan::transaction_id)
+        .def("committed", &ReplacePlan::committed)
+        .def("diff", &ReplacePlan::diff, py::arg("path"), py::arg("context_lines") = 3)
+        .def("commit", &ReplacePlan::commit, py::call_guard<py::gil_scoped_release>())
+        .def("discard", &ReplacePlan::discard);
+
+    // BatchReplacer class - parallel regex replace with atomic commit and undo
+    py::class_<BatchReplacer, std::shared_ptr<BatchReplacer>>(m, "BatchReplacer")
+        .def(py::init<std::string>(), py::arg("root"))
+        .def("prepare",
+             [](const BatchReplacer& self, const std::string& pattern, const std::string& replacement,
+                std::vector<std::string> include_globs, unsigned threads, bool dry_run) {
+                 ReplaceOptions options;
+                 options.include_globs = std::move(include_globs);
+                 options.threads = threads;
+                 options.dry_run = dry_run;
+                 py::gil_scoped_release release;
+                 return self.prepare(pattern, replacement, options);
+             },
+             py::arg("pattern"), py::arg("replacement"), py::arg("include_globs") = std::vector<std::string>{},
+             py::arg("threads") = 0, py::arg("dry_run") = false)
+        .def_static("undo", &BatchReplacer::undo, py::arg("root"), py::arg("transaction_id"),
+                    py::arg("force") = false)
+        .def_static("recover", &BatchReplacer::recover, py::arg("root"));
+
+    // EditBuffer class - piece-table buffer behind the file edit tools
+    py::class_<EditBuffer, std::shared_ptr<EditBuffer>>(m, "EditBuffer")
+        .def_static("load", &EditBuffer::load)
+        .def("path", &EditBuffer::path)
+        .def("size", &EditBuffer::size)
+        .def("line_count", &EditBuffer::line_count)
+        .def("piece_count", &EditBuffer::piece_count)
+        .def("valid_utf8", &EditBuffer::valid_utf8)
+        .def("has_carriage_returns", &EditBuffer::has_carriage_returns)
+        .def("dirty", &EditBuffer::dirty)
+        .def("is_stale", &EditBuffer::is_stale)
+        .def("insert", &EditBuffer::insert)
+        .def("erase", &EditBuffer::erase)
+        .def("replace", &EditBuffer::replace)
+        .def("replace_all", &EditBuffer::replace_all, py::arg("needle"), py::arg("replacement"),
+             py::arg("limit") = 0)
+        .def("text", &EditBuffer::text)
+        .def("substr", &EditBuffer::substr)
+        .def("lines", &EditBuffer::lines)
+        .def("line_offset", &EditBuffer::line_offset)
+        .def("line_of", &EditBuffer::line_of)
+        .def("find_all", &EditBuffer::find_all, py::arg("needle"), py::arg("limit") = 0)
+        .def("flush", &EditBuffer::flush, py::call_guard<py::gil_scoped_release>());
+
+    // EditBufferCache class - LRU of open edit buffers
+    py::class_<EditBufferCache, std::shared_ptr<EditBufferCache>>(m, "EditBufferCache")
+        .def(py::init<size_t>(), py::arg("max_buffers") = 64)
+        .def("open", &EditBufferCache::open, py::call_guard<py::gil_scoped_release>())
+        .def("evict", &EditBufferCache::evict)
+        .def("flush_all", &EditBufferCache::flush_all, py::call_guard<py::gil_scoped_release>())
+        .def("clear", &EditBufferCache::clear)
+        .def("size", &EditBufferCache::size);
+
+    // ImportRef struct - one import statement found by scan_imports
+    py::class_<ImportRef>(m, "ImportRef")
+        .def_readonly("spec", &ImportRef::spec)
+        .def_readonly("names", &ImportRef::names)
+        .def_readonly("line", &ImportRef::line)
+        .def_readonly("kind", &ImportRef::kind)
+        .def_readonly("system", &ImportRef::system);
+
+    m.def("scan_imports",
+          [](const std::string& source, const std::string& path) {
+              return scan_imports(source, language_for_path(path));
+          },
+          py::arg("source"), py::arg("path"), "Import statements of a source file; path selects the language");
+
+    // DependencyGraph class - persistent project import graph
+    py::class_<DependencyGraph, std::shared_ptr<DependencyGraph>>(m, "DependencyGraph")
+        .def(py::init<std::string>(), py::arg("root"))
+        .def("build", &DependencyGraph::build, py::arg("include_globs") = std::vector<std::string>{},
+             py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("update_file", &DependencyGraph::update_file, py::call_guard<py::gil_scoped_release>())
+        .def("remove_file", &DependencyGraph::remove_file, py::call_guard<py::gil_scoped_release>())
+        .def("save", &DependencyGraph::save, py::call_guard<py::gil_scoped_release>())
+        .def("load", &DependencyGraph::load, py::call_guard<py::gil_scoped_release>())
+        .def("contains", &DependencyGraph::contains)
+        .def("imports", &DependencyGraph::imports)
+        .def("dependencies", &DependencyGraph::dependencies, py::arg("path"), py::arg("include_external") = false)
+        .def("dependents", &DependencyGraph::dependents)
+        .def("impacted", &DependencyGraph::impacted, py::arg("names"), py::arg("max_depth") = 0)
+        .def("closure", &DependencyGraph::closure, py::arg("path"), py::arg("max_depth") = 0,
+             py::arg("include_external") = false)
+        .def("file_count", &DependencyGraph::file_count)
+        .def("edge_count", &DependencyGraph::edge_count);
+
+    // SymbolDef struct - one definition found by scan_symbols or SymbolIndex
+    py::class_<SymbolDef>(m, "SymbolDef")
+        .def_readonly("name", &SymbolDef::name)
+        .def_readonly("path", &SymbolDef::path)
+        .def_readonly("line", &SymbolDef::line)
+        .def_readonly("column", &SymbolDef::column)
+        .def_readonly("kind", &SymbolDef::kind)
+        .def_readonly("signature", &SymbolDef::signature);
+
+    m.def("scan_symbols",
+          [](const std::string& source, const std::string& path) {
+              return scan_symbols(source, language_for_path(path));
+          },
+          py::arg("source"), py::arg("path"), "Definitions in a source file; path selects the language");
+
+    // SymbolIndex class - sorted project symbol table for go-to-definition
+    py::class_<SymbolIndex, std::shared_ptr<SymbolIndex>>(m, "SymbolIndex")
+        .def(py::init<std::string>(), py::arg("root"))
+        .def("build", &SymbolIndex::build, py::arg("include_globs") = std::vector<std::string>{},
+             py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("update_file", &SymbolIndex::update_file, py::call_guard<py::gil_scoped_release>())
+        .def("remove_file", &SymbolIndex::remove_file, py::call_guard<py::gil_scoped_release>())
+        .def("save", &SymbolIndex::save, py::call_guard<py::gil_scoped_release>())
+        .def("load", &SymbolIndex::load, py::call_guard<py::gil_scoped_release>())
+        .def("find", &SymbolIndex::find, py::arg("name"), py::arg("limit") = 0)
+        .def("find_prefix", &SymbolIndex::find_prefix, py::arg("prefix"), py::arg("limit") = 100)
+        .def("symbols_in", &SymbolIndex::symbols_in)
+        .def("symbol_count", &SymbolIndex::symbol_count)
+        .def("file_count", &SymbolIndex::file_count);
+
+    // QueuedCommand struct - one row of the native command queue
+    py::class_<QueuedCommand>(m, "QueuedCommand")
+        .def_readonly("id", &QueuedCommand::id)
+        .def_readonly("queued_at", &QueuedCommand::queued_at)
+        .def_readonly("command_type", &QueuedCommand::command_type)
+        .def_readonly("command_text", &QueuedCommand::command_text)
+        .def_readonly("target_device", &QueuedCommand::target_device)
+        .def_readonly("retry_count", &QueuedCommand::retry_count)
+        .def_readonly("last_retry_at", &QueuedCommand::last_retry_at)
+        .def_readonly("status", &QueuedCommand::status)
+        .def_readonly("error_message", &QueuedCommand::error_message)
+        .def_readonly("metadata", &QueuedCommand::metadata);
+
+    // CommandQueueStatus struct - per-status counts
+    py::class_<CommandQueueStatus>(m, "CommandQueueStatus")
+        .def_readonly("pending", &CommandQueueStatus::pending)
+        .def_readonly("syncing", &CommandQueueStatus::syncing)
+        .def_readonly("failed", &CommandQueueStatus::failed)
+        .def_readonly("done", &CommandQueueStatus::done)
+        .def_readonly("last_sync", &CommandQueueStatus::last_sync);
+
+    // CommandQueue class - durable offline command queue with group commit
+    py::class_<CommandQueue, std::shared_ptr<CommandQueue>>(m, "CommandQueue")
+        .def(py::init([](const std::string& dir, size_t segment_bytes, bool sync, size_t checkpoint_records) {
+                 CommandQueueOptions options;
+                 options.segment_bytes = segment_bytes;
+                 options.sync = sync;
+                 options.checkpoint_records = checkpoint_records;
+                 return std::make_shared<CommandQueue>(dir, options);
+             }),
+             py::arg("dir"), py::arg("segment_bytes") = CommandQueueOptions{}.segment_bytes, py::arg("sync") = true,
+             py::arg("checkpoint_records") = CommandQueueOptions{}.checkpoint_records)
+        .def("enqueue", &CommandQueue::enqueue, py::arg("command"), py::arg("command_type"),
+             py::arg("target_device") = std::nullopt, py::arg("metadata") = "{}",
+             py::call_guard<py::gil_scoped_release>())
+        .def("dequeue_pending", &CommandQueue::dequeue_pending, py::arg("limit") = 10,
+             py::call_guard<py::gil_scoped_release>())
+        .def("list_pending", &CommandQueue::list_pending, py::arg("limit") = 10,
+             py::call_guard<py::gil_scoped_release>())
+        .def("mark_syncing", &CommandQueue::mark_syncing, py::call_guard<py::gil_scoped_release>())
+        .def("mark_done", &CommandQueue::mark_done, py::call_guard<py::gil_scoped_release>())
+        .def("mark_failed", &CommandQueue::mark_failed, py::call_guard<py::gil_scoped_release>())
+        .def("reset_stale_syncing", &CommandQueue::reset_stale_syncing, py::arg("timeout_minutes") = 5,
+             py::call_guard<py::gil_scoped_release>())
+        .def("clear_old_entries", &CommandQueue::clear_old_entries, py::arg("days") = 7,
+             py::call_guard<py::gil_scoped_release>())
+        .def("get", &CommandQueue::get, py::call_guard<py::gil_scoped_release>())
+        .def("status", &CommandQueue::status, py::call_guard<py::gil_scoped_release>())
+        .def("size", &CommandQueue::size, py::call_guard<py::gil_scoped_release>())
+        .def("wait", &CommandQueue::wait, py::arg("timeout_ms"), py::call_guard<py::gil_scoped_release>())
+        .def("notify", &CommandQueue::notify)
+        .def("wake_fd", &CommandQueue::wake_fd)
+        .def("checkpoint", &CommandQueue::checkpoint, py::call_guard<py::gil_scoped_release>())
+        .def("sync_count", &CommandQueue::sync_count);
+
+    // TaskInfo struct - background task state and captured output
+    py::class_<TaskInfo>(m, "TaskInfo")
+        .def_readonly("id", &TaskInfo::id)
+        .def_readonly("argv", &TaskInfo::argv)
+        .def_readonly("priority", &TaskInfo::priority)
+        .def_readonly("status", &TaskInfo::status)
+        .def_readonly("exit_code", &TaskInfo::exit_code)
+        .def_readonly("stdout", &TaskInfo::stdout_data)
+        .def_readonly("stderr", &TaskInfo::stderr_data)
+        .def_readonly("truncated", &TaskInfo::truncated)
+        .def_readonly("pid", &TaskInfo::pid)
+        .def_readonly("submitted_at", &TaskInfo::submitted_at)
+        .def_readonly("start_time", &TaskInfo::start_time)
+        .def_readonly("end_time", &TaskInfo::end_time);
+
+    // TaskEngineStats struct - admission and pool counters
+    py::class_<TaskEngineStats>(m, "TaskEngineStats")
+        .def_readonly("queued", &TaskEngineStats::queued)
+        .def_readonly("running", &TaskEngineStats::running)
+        .def_readonly("max_running", &TaskEngineStats::max_running)
+        .def_readonly("submitted", &TaskEngineStats::submitted)
+        .def_readonly("finished", &TaskEngineStats::finished)
+        .def_readonly("workers", &TaskEngineStats::workers)
+        .def_readonly("steals", &TaskEngineStats::steals);
+
+    // TaskRecord struct - persisted background task state
+    py::class_<TaskRecord>(m, "TaskRecord")
+        .def(py::init<>())
+        .def_readwrite("id", &TaskRecord::id)
+        .def_readwrite("command", &TaskRecord::command)
+        .def_readwrite("task_type", &TaskRecord::task_type)
+        .def_readwrite("priority", &TaskRecord::priority)
+        .def_readwrite("status", &TaskRecord::status)
+        .def_readwrite("created_at", &TaskRecord::created_at)
+        .def_readwrite("start_time", &TaskRecord::start_time)
+        .def_readwrite("end_time", &TaskRecord::end_time)
+        .def_readwrite("exit_code", &TaskRecord::exit_code)
+        .def_readwrite("stdout", &TaskRecord::stdout_data)
+        .def_readwrite("stderr", &TaskRecord::stderr_data)
+        .def_readwrite("metadata", &TaskRecord::metadata);
+
+    // TaskJournalStats struct - journal write counters
+    py::class_<TaskJournalStats>(m, "TaskJournalStats")
+        .def_readonly("records", &TaskJournalStats::records)
+        .def_readonly("batches", &TaskJournalStats::batches)
+        .def_readonly("tasks", &TaskJournalStats::tasks);
+
+    // TaskJournal class - group-committed task state journal
+    py::class_<TaskJournal, std::shared_ptr<TaskJournal>>(m, "TaskJournal")
+        .def(py::init([](const std::string& dir, bool sync, size_t checkpoint_records) {
+                 TaskJournalOptions options;
+                 options.sync = sync;
+                 options.checkpoint_records = checkpoint_records;
+                 return std::make_shared<TaskJournal>(dir, options);
+             }),
+             py::arg("dir"), py::arg("sync") = true,
+             py::arg("checkpoint_records") = TaskJournalOptions{}.checkpoint_records)
+        .def("record", &TaskJournal::record)
+        .def("transition", &TaskJournal::transition, py::arg("id"), py::arg("status"), py::arg("start_time") = 0.0,
+             py::arg("end_time") = 0.0, py::arg("exit_code") = std::nullopt, py::arg("stdout") = "",
+             py::arg("stderr") = "")
+        .def("remove", &TaskJournal::remove)
+        .def("flush", &TaskJournal::flush, py::call_guard<py::gil_scoped_release>())
+        .def("records", &TaskJournal::records, py::call_guard<py::gil_scoped_release>())
+        .def("stats", &TaskJournal::stats);
+
+    // TaskEngine class - prioritized background process execution
+    py::class_<TaskEngine, std::shared_ptr<TaskEngine>>(m, "TaskEngine")
+        .def(py::init([](size_t max_running, unsigned workers, size_t max_output_bytes, int kill_grace_ms,
+                         std::shared_ptr<TaskJournal> journal) {
+                 TaskEngineOptions options;
+                 options.max_running = max_running;
+                 options.workers = workers;
+                 options.max_output_bytes = max_output_bytes;
+                 options.kill_grace_ms = kill_grace_ms;
+                 return std::make_shared<TaskEngine>(options, std::move(journal));
+             }),
+             py::arg("max_running") = TaskEngineOptions{}.max_running, py::arg("workers") = 0,
+             py::arg("max_output_bytes") = TaskEngineOptions{}.max_output_bytes,
+             py::arg("kill_grace_ms") = TaskEngineOptions{}.kill_grace_ms, py::arg("journal") = nullptr)
+        .def("submit", &TaskEngine::submit, py::arg("id"), py::arg("argv"), py::arg("priority") = "normal")
+        .def("cancel", &TaskEngine::cancel, py::call_guard<py::gil_scoped_release>())
+        .def("get", &TaskEngine::get)
+        .def("wait_finished", &TaskEngine::wait_finished, py::arg("timeout_ms"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("forget", &TaskEngine::forget)
+        .def("set_max_running", &TaskEngine::set_max_running)
+        .def("stats", &TaskEngine::stats);
+
+    // CronJobInfo struct - per-job schedule state
+    py::class_<CronJobInfo>(m, "CronJobInfo")
+        .def_readonly("name", &CronJobInfo::name)
+        .def_readonly("schedule", &CronJobInfo::schedule)
+        .def_readonly("runs", &CronJobInfo::runs)
+        .def_readonly("failures", &CronJobInfo::failures)
+        .def_readonly("missed", &CronJobInfo::missed)
+        .def_readonly("skipped", &CronJobInfo::skipped)
+        .def_readonly("running", &CronJobInfo::running)
+        .def_readonly("last_run", &CronJobInfo::last_run)
+        .def_readonly("next_run", &CronJobInfo::next_run)
+        .def_readonly("last_duration_ms", &CronJobInfo::last_duration_ms)
+        .def_readonly("last_error", &CronJobInfo::last_error);
+
+    // Jobs run on pool threads: take the GIL to call back, and to release the callable
+    auto wrap_job = [](py::function fn) {
+        std::shared_ptr<py::function> callable(new py::function(std::move(fn)), [](py::function* f) {
+            py::gil_scoped_acquire gil;
+            delete f;
+        });
+        return CronScheduler::Job([callable] {
+            py::gil_scoped_acquire gil;
+            try {
+                (*callable)();
+            } catch (py::error_already_set& e) {
+                throw std::runtime_error(e.what());
+            }
+        });
+    };
+    auto make_job_options = [](int jitter_ms, const std::string& catch_up, bool allow_overlap,
+                               bool run_immediately) {
+        CronJobOptions options;
+        options.jitter_ms = jitter_ms;
+        options.catch_up = catch_up;
+        options.allow_overlap = allow_overlap;
+        options.run_immediately = run_immediately;
+        return options;
+    };
+
+    // CronScheduler class - timer-wheel periodic job scheduler
+    py::class_<CronScheduler, std::shared_ptr<CronScheduler>>(m, "CronScheduler")
+        .def(py::init([](unsigned workers) {
+                 // Destruction joins pool threads that may be waiting for the GIL
+                 return std::shared_ptr<CronScheduler>(new CronScheduler(workers), [](CronScheduler* scheduler) {
+                     py::gil_scoped_release release;
+                     delete scheduler;
+                 });
+             }),
+             py::arg("workers") = 2)
+        .def("add_cron",
+             [wrap_job, make_job_options](CronScheduler& self, const std::string& name, const std::string& expression,
+                                          py::function job, int jitter_ms, const std::string& catch_up,
+                                          bool allow_overlap, bool run_immediately) {
+                 self.add_cron(name, expression, wrap_job(std::move(job)),
+                               make_job_options(jitter_ms, catch_up, allow_overlap, run_immediately));
+             },
+             py::arg("name"), py::arg("expression"), py::arg("job"), py::arg("jitter_ms") = 0,
+             py::arg("catch_up") = "once", py::arg("allow_overlap") = false, py::arg("run_immediately") = false)
+        .def("add_interval",
+             [wrap_job, make_job_options](CronScheduler& self, const std::string& name, int64_t interval_ms,
+                                          py::function job, int jitter_ms, const std::string& catch_up,
+                                          bool allow_overlap, bool run_immediately) {
+                 self.add_interval(name, interval_ms, wrap_job(std::move(job)),
+                                   make_job_options(jitter_ms, catch_up, allow_overlap, run_immediately));
+             },
+             py::arg("name"), py::arg("interval_ms"), py::arg("job"), py::arg("jitter_ms") = 0,
+             py::arg("catch_up") = "once", py::arg("allow_overlap") = false, py::arg("run_immediately") = false)
+        .def("remove", &CronScheduler::remove)
+        .def("run_now", &CronScheduler::run_now)
+        .def("info", &CronScheduler::info)
+        .def("jobs", &CronScheduler::jobs)
+        .def("wakeups", &CronScheduler::wakeups)
+        .def("stop", &CronScheduler::stop, py::call_guard<py::gil_scoped_release>());
+
+    // PipelineStepSpec struct - one node of a pipeline DAG
+    py::class_<PipelineStepSpec>(m, "PipelineStepSpec")
+        .def(py::init<>())
+        .def_readwrite("id", &PipelineStepSpec::id)
+        .def_readwrite("kind", &PipelineStepSpec::kind)
+        .def_readwrite("command", &PipelineStepSpec::command)
+        .def_readwrite("wait_ms", &PipelineStepSpec::wait_ms)
+        .def_readwrite("depends_on", &PipelineStepSpec::depends_on)
+        .def_readwrite("stdin_from", &PipelineStepSpec::stdin_from)
+        .def_readwrite("timeout_ms", &PipelineStepSpec::timeout_ms)
+        .def_readwrite("retry_count", &PipelineStepSpec::retry_count)
+        .def_readwrite("retry_delay_ms", &PipelineStepSpec::retry_delay_ms)
+        .def_readwrite("continue_on_failure", &PipelineStepSpec::continue_on_failure)
+        .def_readwrite("cache", &PipelineStepSpec::cache)
+        .def_readwrite("inputs", &PipelineStepSpec::inputs)
+        .def_readwrite("env", &PipelineStepSpec::env);
+
+    // PipelineStepResult struct - outcome of one step
+    py::class_<PipelineStepResult>(m, "PipelineStepResult")
+        .def_readonly("id", &PipelineStepResult::id)
+        .def_readonly("status", &PipelineStepResult::status)
+        .def_readonly("exit_code", &PipelineStepResult::exit_code)
+        .def_readonly("stdout", &PipelineStepResult::stdout_data)
+        .def_readonly("stderr", &PipelineStepResult::stderr_data)
+        .def_readonly("truncated", &PipelineStepResult::truncated)
+        .def_readonly("attempts", &PipelineStepResult::attempts)
+        .def_readonly("streamed", &PipelineStepResult::streamed)
+        .def_readonly("cached", &PipelineStepResult::cached)
+        .def_readonly("start_time", &PipelineStepResult::start_time)
+        .def_readonly("end_time", &PipelineStepResult::end_time)
+        .def_readonly("duration", &PipelineStepResult::duration)
+        .def_readonly("critical", &PipelineStepResult::critical);
+
+    // PipelineRunResult struct - outcome of a pipeline run with its critical path
+    py::class_<PipelineRunResult>(m, "PipelineRunResult")
+        .def_readonly("success", &PipelineRunResult::success)
+        .def_readonly("error", &PipelineRunResult::error)
+        .def_readonly("steps", &PipelineRunResult::steps)
+        .def_readonly("critical_path", &PipelineRunResult::critical_path)
+        .def_readonly("critical_path_seconds", &PipelineRunResult::critical_path_seconds)
+        .def_readonly("duration", &PipelineRunResult::duration);
+
+    m.def("substitute_variables", &substitute_variables, py::arg("text"), py::arg("variables"));
+
+    // StepCacheEntry struct - a cached step result
+    py::class_<StepCacheEntry>(m, "StepCacheEntry")
+        .def_readonly("exit_code", &StepCacheEntry::exit_code)
+        .def_readonly("stdout", &StepCacheEntry::stdout_data)
+        .def_readonly("stderr", &StepCacheEntry::stderr_data)
+        .def_readonly("duration", &StepCacheEntry::duration)
+        .def_readonly("created", &StepCacheEntry::created);
+
+    // StepCacheStats struct - step cache counters and disk usage
+    py::class_<StepCacheStats>(m, "StepCacheStats")
+        .def_readonly("hits", &StepCacheStats::hits)
+        .def_readonly("misses", &StepCacheStats::misses)
+        .def_readonly("stores", &StepCacheStats::stores)
+        .def_readonly("actions", &StepCacheStats::actions)
+        .def_readonly("blobs", &StepCacheStats::blobs)
+        .def_readonly("bytes", &StepCacheStats::bytes);
+
+    // StepCache class - content-addressed action cache for pipeline steps
+    py::class_<StepCache, std::shared_ptr<StepCache>>(m, "StepCache")
+        .def(py::init<const std::string&>(), py::arg("dir"))
+        .def("fingerprint", &StepCache::fingerprint, py::arg("command"), py::arg("working_dir") = "",
+             py::arg("env") = std::vector<std::string>{}, py::arg("stdin") = "",
+             py::arg("inputs") = std::vector<std::string>{}, py::call_guard<py::gil_scoped_release>())
+        .def("lookup", &StepCache::lookup, py::call_guard<py::gil_scoped_release>())
+        .def("store",
+             [](StepCache& self, const std::string& key, int exit_code, const std::string& out,
+                const std::string& err, double duration) {
+                 StepCacheEntry entry;
+                 entry.exit_code = exit_code;
+                 entry.stdout_data = out;
+                 entry.stderr_data = err;
+                 entry.duration = duration;
+                 py::gil_scoped_release release;
+                 return self.store(key, entry);
+             },
+             py::arg("key"), py::arg("exit_code"), py::arg("stdout"), py::arg("stderr") = "",
+             py::arg("duration") = 0.0)
+        .def("prune", &StepCache::prune, py::arg("max_bytes"), py::call_guard<py::gil_scoped_release>())
+        .def("clear", &StepCache::clear, py::call_guard<py::gil_scoped_release>())
+        .def("stats", &StepCache::stats, py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("dir", &StepCache::dir);
+
+    // PipelineEngine class - DAG step scheduler with streamed stdin
+    py::class_<PipelineEngine, std::shared_ptr<PipelineEngine>>(m, "PipelineEngine")
+        .def(py::init<unsigned, size_t, std::shared_ptr<StepCache>>(), py::arg("workers") = 0,
+             py::arg("max_output_bytes") = 16 << 20, py::arg("cache") = nullptr)
+        .def("run",
+             [](PipelineEngine& self, const std::string& run_id, const std::vector<PipelineStepSpec>& steps,
+                const std::unordered_map<std::string, std::string>& variables, size_t max_parallel,
+                int64_t timeout_ms, const std::string& working_dir, py::object callback) {
+                 PipelineRunOptions options;
+                 options.max_parallel = max_parallel;
+                 options.timeout_ms = timeout_ms;
+                 options.working_dir = working_dir;
+
+                 // Callback steps run on pool threads: take the GIL to call back, and to release the callable
+                 PipelineEngine::StepCallback step_callback;
+                 if (!callback.is_none()) {
+                     std::shared_ptr<py::object> callable(new py::object(std::move(callback)), [](py::object* f) {
+                         py::gil_scoped_acquire gil;
+                         delete f;
+                     });
+                     step_callback = [callable](const std::string& id, const std::string& input) {
+                         py::gil_scoped_acquire gil;
+                         try {
+                             return (*callable)(id, input).cast<std::pair<int, std::string>>();
+                         } catch (py::error_already_set& e) {
+                             throw std::runtime_error(e.what());
+                         }
+                     };
+                 }
+
+                 py::gil_scoped_release release;
+                 return self.run(run_id, steps, variables, options, std::move(step_callback));
+             },
+             py::arg("run_id"), py::arg("steps"), py::arg("variables") = std::unordered_map<std::string, std::string>{},
+             py::arg("max_parallel") = PipelineRunOptions{}.max_parallel, py::arg("timeout_ms") = 0,
+             py::arg("working_dir") = "", py::arg("callback") = py::none())
+        .def("cancel", &PipelineEngine::cancel);
+
+    // StoredMessage struct - one notification in the messages row shape
+    py::class_<StoredMessage>(m, "StoredMessage")
+        .def_readonly("id", &StoredMessage::id)
+        .def_readonly("created_at", &StoredMessage::created_at)
+        .def_readonly("message_type", &StoredMessage::message_type)
+        .def_readonly("priority", &StoredMessage::priority)
+        .def_readonly("title", &StoredMessage::title)
+        .def_readonly("content", &StoredMessage::content)
+        .def_readonly("metadata", &StoredMessage::metadata)
+        .def_readonly("acknowledged_at", &StoredMessage::acknowledged_at)
+        .def_readonly("status", &StoredMessage::status);
+
+    // MessageStore class - notification log shared between processes, with pending counters
+    py::class_<MessageStore, std::shared_ptr<MessageStore>>(m, "MessageStore")
+        .def(py::init([](const std::string& dir, size_t segment_bytes, bool sync, size_t compact_records) {
+                 MessageStoreOptions options;
+                 options.segment_bytes = segment_bytes;
+                 options.sync = sync;
+                 options.compact_records = compact_records;
+                 return std::make_shared<MessageStore>(dir, options);
+             }),
+             py::arg("dir"), py::arg("segment_bytes") = MessageStoreOptions{}.segment_bytes, py::arg("sync") = true,
+             py::arg("compact_records") = MessageStoreOptions{}.compact_records)
+        .def("add", &MessageStore::add, py::arg("message_type"), py::arg("priority"), py::arg("title"),
+             py::arg("content") = "", py::arg("metadata") = std::nullopt, py::arg("created_us") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("acknowledge", &MessageStore::acknowledge, py::arg("id"), py::arg("acknowledged_us") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("acknowledge_all", &MessageStore::acknowledge_all, py::arg("message_type") = std::nullopt,
+             py::call_guard<py::gil_scoped_release>())
+        .def("remove", &MessageStore::remove, py::call_guard<py::gil_scoped_release>())
+        .def("clear", &MessageStore::clear, py::arg("message_type") = std::nullopt,
+             py::arg("status") = std::nullopt, py::call_guard<py::gil_scoped_release>())
+        .def("cleanup", &MessageStore::cleanup, py::arg("days") = 30, py::call_guard<py::gil_scoped_release>())
+        .def("list", &MessageStore::list, py::arg("message_type") = std::nullopt, py::arg("status") = "pending",
+             py::arg("limit") = 50, py::call_guard<py::gil_scoped_release>())
+        .def("get", &MessageStore::get, py::call_guard<py::gil_scoped_release>())
+        .def("pending", &MessageStore::pending, py::arg("message_type"), py::arg("priority") = std::nullopt,
+             py::call_guard<py::gil_scoped_release>())
+        .def("pending_total", &MessageStore::pending_total, py::call_guard<py::gil_scoped_release>())
+        .def("compact", &MessageStore::compact, py::call_guard<py::gil_scoped_release>())
+        .def("size", &MessageStore::size, py::call_guard<py::gil_scoped_release>())
+        .def("sync_count", &MessageStore::sync_count);
+
+    // SnapshotInfo struct - one stored snapshot
+    py::class_<SnapshotInfo>(m, "SnapshotInfo")
+        .def_readonly("id", &SnapshotInfo::id)
+        .def_readonly("timestamp", &SnapshotInfo::timestamp)
+        .def_readonly("base", &SnapshotInfo::base)
+        .def_readonly("metadata", &SnapshotInfo::metadata)
+        .def_readonly("size", &SnapshotInfo::size)
+        .def_readonly("chunks", &SnapshotInfo::chunks)
+        .def_readonly("new_chunks", &SnapshotInfo::new_chunks)
+        .def_readonly("new_bytes", &SnapshotInfo::new_bytes);
+
+    // SnapshotStoreStats struct - dedup ratio and garbage
+    py::class_<SnapshotStoreStats>(m, "SnapshotStoreStats")
+        .def_readonly("snapshots", &SnapshotStoreStats::snapshots)
+        .def_readonly("chunks", &SnapshotStoreStats::chunks)
+        .def_readonly("logical_bytes", &SnapshotStoreStats::logical_bytes)
+        .def_readonly("stored_bytes", &SnapshotStoreStats::stored_bytes)
+        .def_readonly("dead_bytes", &SnapshotStoreStats::dead_bytes)
+        .def_readonly("disk_bytes", &SnapshotStoreStats::disk_bytes);
+
+    // SnapshotStore class - chunked, deduplicated workspace snapshots
+    py::class_<SnapshotStore, std::shared_ptr<SnapshotStore>>(m, "SnapshotStore")
+        .def(py::init([](const std::string& dir, size_t segment_bytes, bool sync, size_t min_chunk, size_t avg_chunk,
+                         size_t max_chunk, uint64_t compact_dead_bytes) {
+                 SnapshotStoreOptions options;
+                 options.segment_bytes = segment_bytes;
+                 options.sync = sync;
+                 options.min_chunk = min_chunk;
+                 options.avg_chunk = avg_chunk;
+                 options.max_chunk = max_chunk;
+                 options.compact_dead_bytes = compact_dead_bytes;
+                 return std::make_shared<SnapshotStore>(dir, options);
+             }),
+             py::arg("dir"), py::arg("segment_bytes") = SnapshotStoreOptions{}.segment_bytes, py::arg("sync") = true,
+             py::arg("min_chunk") = SnapshotStoreOptions{}.min_chunk,
+             py::arg("avg_chunk") = SnapshotStoreOptions{}.avg_chunk,
+             py::arg("max_chunk") = SnapshotStoreOptions{}.max_chunk,
+             py::arg("compact_dead_bytes") = SnapshotStoreOptions{}.compact_dead_bytes)
+        .def("put", &SnapshotStore::put, py::arg("id"), py::arg("data"), py::arg("metadata") = "",
+             py::arg("timestamp") = 0.0, py::call_guard<py::gil_scoped_release>())
+        .def("get", &SnapshotStore::get, py::call_guard<py::gil_scoped_release>())
+        .def("info", &SnapshotStore::info)
+        .def("list", &SnapshotStore::list)
+        .def("remove", &SnapshotStore::remove, py::call_guard<py::gil_scoped_release>())
+        .def("contains", &SnapshotStore::contains)
+        .def("compact", &SnapshotStore::compact, py::call_guard<py::gil_scoped_release>())
+        .def("stats", &SnapshotStore::stats)
+        .def("chunk_sizes", &SnapshotStore::chunk_sizes);
+
+    // ProcessInfo struct - one process from /proc
+    py::class_<ProcessInfo>(m, "ProcessInfo")
+        .def_readonly("pid", &ProcessInfo::pid)
+        .def_readonly("ppid", &ProcessInfo::ppid)
+        .def_readonly("name", &ProcessInfo::name)
+        .def_property_readonly("state", [](const ProcessInfo& p) { return std::string(1, p.state); })
+        .def_readonly("cmdline", &ProcessInfo::cmdline)
+        .def_readonly("cwd", &ProcessInfo::cwd)
+        .def_readonly("rss_bytes", &ProcessInfo::rss_bytes)
+        .def_readonly("open_files", &ProcessInfo::open_files);
+
+    // GitState struct - branch and work-tree changes read from .git
+    py::class_<GitState>(m, "GitState")
+        .def_readonly("is_repo", &GitState::is_repo)
+        .def_readonly("root", &GitState::root)
+        .def_readonly("branch", &GitState::branch)
+        .def_readonly("head", &GitState::head)
+        .def_readonly("tracked_files", &GitState::tracked_files)
+        .def_readonly("modified_files", &GitState::modified_files)
+        .def_readonly("deleted_files", &GitState::deleted_files)
+        .def_readonly("untracked_files", &GitState::untracked_files)
+        .def_readonly("truncated", &GitState::truncated);
+
+    // SystemState struct - CPU, memory, load and disk figures
+    py::class_<SystemState>(m, "SystemState")
+        .def_readonly("cpu_percent", &SystemState::cpu_percent)
+        .def_readonly("memory_percent", &SystemState::memory_percent)
+        .def_readonly("memory_used", &SystemState::memory_used)
+        .def_readonly("memory_total", &SystemState::memory_total)
+        .def_property_readonly("load_average",
+                               [](const SystemState& s) {
+                                   return std::vector<double>(s.load_average, s.load_average + 3);
+                               })
+        .def_readonly("disk_percent", &SystemState::disk_percent)
+        .def_readonly("disk_free", &SystemState::disk_free)
+        .def_readonly("network_connections", &SystemState::network_connections);
+
+    // WorkspaceCapture class - bubble state from /proc and .git without subprocesses
+    py::class_<WorkspaceCapture, std::shared_ptr<WorkspaceCapture>>(m, "WorkspaceCapture")
+        .def(py::init<>())
+        .def("processes", &WorkspaceCapture::processes, py::arg("root"), py::arg("limit") = 20,
+             py::arg("open_files") = true, py::call_guard<py::gil_scoped_release>())
+        .def("git", &WorkspaceCapture::git, py::arg("path"), py::arg("max_files") = 200,
+             py::call_guard<py::gil_scoped_release>())
+        .def("recent_files", &WorkspaceCapture::recent_files, py::arg("root"), py::arg("globs"),
+             py::arg("max_age_seconds"), py::arg("limit") = 10, py::call_guard<py::gil_scoped_release>())
+        .def("system", &WorkspaceCapture::system, py::arg("path"), py::call_guard<py::gil_scoped_release>());
+
+    // TimelineRecord struct - what the timeline index keeps per entry
+    py::class_<TimelineRecord>(m, "TimelineRecord")
+        .def(py::init([](double timestamp, std::string bubble_id, std::string change_type, std::string description,
+                         std::string branch, std::string path, std::vector<std::string> tags) {
+                 return TimelineRecord{timestamp, std::move(bubble_id), std::move(change_type), std::move(description),
+                                       std::move(branch), std::move(path), std::move(tags)};
+             }),
+             py::arg("timestamp") = 0.0, py::arg("bubble_id") = "", py::arg("change_type") = "",
+             py::arg("description") = "", py::arg("branch") = "", py::arg("path") = "",
+             py::arg("tags") = std::vector<std::string>{})
+        .def_readwrite("timestamp", &TimelineRecord::timestamp)
+        .def_readwrite("bubble_id", &TimelineRecord::bubble_id)
+        .def_readwrite("change_type", &TimelineRecord::change_type)
+        .def_readwrite("description", &TimelineRecord::description)
+        .def_readwrite("branch", &TimelineRecord::branch)
+        .def_readwrite("path", &TimelineRecord::path)
+        .def_readwrite("tags", &TimelineRecord::tags);
+
+    // TimelineIndex class - time-travel and text queries over the timeline
+    py::class_<TimelineIndex, std::shared_ptr<TimelineIndex>>(m, "TimelineIndex")
+        .def(py::init<>())
+        .def("append", &TimelineIndex::append)
+        .def("drop_front", &TimelineIndex::drop_front)
+        .def("clear", &TimelineIndex::clear)
+        .def("size", &TimelineIndex::size)
+        .def("__len__", &TimelineIndex::size)
+        .def("at_or_before", &TimelineIndex::at_or_before)
+        .def("between", &TimelineIndex::between, py::arg("since"), py::arg("until"))
+        .def("last_with", &TimelineIndex::last_with, py::arg("field"), py::arg("value"),
+             py::arg("before") = TimelineIndex::kNoLimit)
+        .def("search", &TimelineIndex::search, py::arg("query"), py::arg("limit") = 0,
+             py::arg("since") = -TimelineIndex::kNoLimit, py::arg("until") = TimelineIndex::kNoLimit)
+        .def_static("tokenize", &TimelineIndex::tokenize);
+
+    // EventRecord struct - one structured log event
+    py::class_<EventRecord>(m, "EventRecord")
+        .def_readonly("timestamp", &EventRecord::timestamp)
+        .def_readonly("event_type", &EventRecord::event_type)
+        .def_readonly("data", &EventRecord::data)
+        .def_readonly("metadata", &EventRecord::metadata);
+
+    // ValueStats struct - count/sum/min/max of a numeric event field
+    py::class_<ValueStats>(m, "ValueStats")
+        .def_readonly("count", &ValueStats::count)
+        .def_readonly("sum", &ValueStats::sum)
+        .def_readonly("min", &ValueStats::min)
+        .def_readonly("max", &ValueStats::max);
+
+    // EventAggregate struct - group counts and value stats over matching events
+    py::class_<EventAggregate>(m, "EventAggregate")
+        .def_readonly("events", &EventAggregate::events)
+        .def_readonly("groups", &EventAggregate::groups)
+        .def_readonly("values", &EventAggregate::values)
+        .def_readonly("blocks_read", &EventAggregate::blocks_read)
+        .def_readonly("blocks_skipped", &EventAggregate::blocks_skipped);
+
+    // EventLogStats struct - writer throughput and overflow
+    py::class_<EventLogStats>(m, "EventLogStats")
+        .def_readonly("events", &EventLogStats::events)
+        .def_readonly("bytes", &EventLogStats::bytes)
+        .def_readonly("batches", &EventLogStats::batches)
+        .def_readonly("overflowed", &EventLogStats::overflowed)
+        .def_readonly("write_errors", &EventLogStats::write_errors)
+        .def_readonly("threads", &EventLogStats::threads);
+
+    // EventLog class - structured log with per-thread buffers and a background writer
+    py::class_<EventLog, std::shared_ptr<EventLog>>(m, "EventLog")
+        .def(py::init([](const std::string& dir, size_t buffer_bytes, int flush_interval_ms, bool sync) {
+                 EventLogOptions options;
+                 options.buffer_bytes = buffer_bytes;
+                 options.flush_interval_ms = flush_interval_ms;
+                 options.sync = sync;
+                 return std::make_shared<EventLog>(dir, options);
+             }),
+             py::arg("dir"), py::arg("buffer_bytes") = EventLogOptions{}.buffer_bytes,
+             py::arg("flush_interval_ms") = EventLogOptions{}.flush_interval_ms,
+             py::arg("sync") = EventLogOptions{}.sync)
+        .def("log", &EventLog::log, py::arg("collection"), py::arg("event_type"), py::arg("data"),
+             py::arg("metadata") = "", py::arg("timestamp") = 0.0)
+        .def("flush", &EventLog::flush, py::call_guard<py::gil_scoped_release>())
+        .def("query", &EventLog::query, py::arg("collection"), py::arg("event_type") = "",
+             py::arg("since") = -std::numeric_limits<double>::infinity(), py::arg("limit") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("aggregate", &EventLog::aggregate, py::arg("collection"), py::arg("event_type") = "",
+             py::arg("group_by") = std::vector<std::string>{}, py::arg("values") = std::vector<std::string>{},
+             py::arg("since") = -EventQuery::kNoLimit, py::arg("until") = EventQuery::kNoLimit,
+             py::call_guard<py::gil_scoped_release>())
+        .def("collections", &EventLog::collections)
+        .def("export_jsonl", &EventLog::export_jsonl, py::arg("collection"), py::arg("path"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("stats", &EventLog::stats);
+
+    // MetricPoint struct - one stored sample
+    py::class_<MetricPoint>(m, "MetricPoint")
+        .def_readonly("timestamp", &MetricPoint::timestamp)
+        .def_readonly("value", &MetricPoint::value);
+
+    // MetricBucket struct - count/sum/min/max over a rollup bucket or range
+    py::class_<MetricBucket>(m, "MetricBucket")
+        .def_readonly("start", &MetricBucket::start)
+        .def_readonly("count", &MetricBucket::count)
+        .def_readonly("sum", &MetricBucket::sum)
+        .def_readonly("min", &MetricBucket::min)
+        .def_readonly("max", &MetricBucket::max);
+
+    // MetricStoreStats struct - series, points and compressed size
+    py::class_<MetricStoreStats>(m, "MetricStoreStats")
+        .def_readonly("series", &MetricStoreStats::series)
+        .def_readonly("points", &MetricStoreStats::points)
+        .def_readonly("chunks", &MetricStoreStats::chunks)
+        .def_readonly("encoded_bytes", &MetricStoreStats::encoded_bytes)
+        .def_readonly("write_errors", &MetricStoreStats::write_errors);
+
+    // MetricStore class - compressed time series with write-time rollups
+    py::class_<MetricStore, std::shared_ptr<MetricStore>>(m, "MetricStore")
+        .def(py::init([](const std::string& path, size_t chunk_points, int max_chunk_age_ms) {
+                 MetricStoreOptions options;
+                 options.chunk_points = chunk_points;
+                 options.max_chunk_age_ms = max_chunk_age_ms;
+                 return std::make_shared<MetricStore>(path, options);
+             }),
+             py::arg("path"), py::arg("chunk_points") = MetricStoreOptions{}.chunk_points,
+             py::arg("max_chunk_age_ms") = MetricStoreOptions{}.max_chunk_age_ms)
+        .def("append", &MetricStore::append, py::arg("series"), py::arg("value"), py::arg("timestamp") = 0.0)
+        .def("flush", &MetricStore::flush, py::call_guard<py::gil_scoped_release>())
+        .def("points", &MetricStore::points, py::arg("series"), py::arg("since") = -MetricStore::kNoLimit,
+             py::arg("until") = MetricStore::kNoLimit, py::call_guard<py::gil_scoped_release>())
+        .def("rollups", &MetricStore::rollups, py::arg("series"), py::arg("period"),
+             py::arg("since") = -MetricStore::kNoLimit, py::arg("until") = MetricStore::kNoLimit,
+             py::call_guard<py::gil_scoped_release>())
+        .def("summarize", &MetricStore::summarize, py::arg("series"), py::arg("since") = -MetricStore::kNoLimit,
+             py::arg("until") = MetricStore::kNoLimit, py::call_guard<py::gil_scoped_release>())
+        .def("series", &MetricStore::series, py::arg("prefix") = "")
+        .def("drop_before", &MetricStore::drop_before, py::arg("timestamp"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("stats", &MetricStore::stats);
+
+    // LatencySnapshot struct - histogram count, range and quantiles in ms
+    py::class_<LatencyHistogram::Snapshot>(m, "LatencySnapshot")
+        .def_readonly("count", &LatencyHistogram::Snapshot::count)
+        .def_readonly("sum_ms", &LatencyHistogram::Snapshot::sum_ms)
+        .def_readonly("min_ms", &LatencyHistogram::Snapshot::min_ms)
+        .def_readonly("max_ms", &LatencyHistogram::Snapshot::max_ms)
+        .def_readonly("p50_ms", &LatencyHistogram::Snapshot::p50_ms)
+        .def_readonly("p99_ms", &LatencyHistogram::Snapshot::p99_ms)
+        .def_readonly("p999_ms", &LatencyHistogram::Snapshot::p999_ms);
+
+    // MetricSample struct - one registry metric at snapshot time
+    py::class_<MetricSample>(m, "MetricSample")
+        .def_readonly("name", &MetricSample::name)
+        .def_readonly("kind", &MetricSample::kind)
+        .def_readonly("value", &MetricSample::value)
+        .def_readonly("latency", &MetricSample::latency);
+
+    // Process-wide metrics registry shared with the router, shell and validator
+    m.def("metrics_snapshot", [] { return MetricsRegistry::global().snapshot(); });
+    m.def("record_latency",
+          [](const std::string& name, double ms) {
+              MetricsRegistry::global().histogram(name).record(static_cast<uint64_t>(ms > 0 ? ms * 1e6 : 0.0));
+          },
+          py::arg("name"), py::arg("ms"));
+    m.def("add_counter",
+          [](const std::string& name, uint64_t n) { MetricsRegistry::global().counter(name).add(n); },
+          py::arg("name"), py::arg("n") = 1);
+    m.def("set_gauge",
+          [](const std::string& name, double value) { MetricsRegistry::global().gauge(name).set(value); },
+          py::arg("name"), py::arg("value"));
+
+    // SystemSample struct - one /proc and cgroup reading
+    py::class_<SystemSample>(m, "SystemSample")
+        .def_readonly("sequence", &SystemSample::sequence)
+        .def_readonly("timestamp", &SystemSample::timestamp)
+        .def_readonly("cpu_percent", &SystemSample::cpu_percent)
+        .def_readonly("cpu_count", &SystemSample::cpu_count)
+        .def_property_readonly("load_average",
+                               [](const SystemSample& s) {
+                                   return std::vector<double>(s.load_average, s.load_average + 3);
+                               })
+        .def_readonly("tasks", &SystemSample::tasks)
+        .def_readonly("memory_total", &SystemSample::memory_total)
+        .def_readonly("memory_available", &SystemSample::memory_available)
+        .def_readonly("memory_used", &SystemSample::memory_used)
+        .def_readonly("memory_percent", &SystemSample::memory_percent)
+        .def_readonly("disk_read_bytes", &SystemSample::disk_read_bytes)
+        .def_readonly("disk_write_bytes", &SystemSample::disk_write_bytes)
+        .def_readonly("disk_free", &SystemSample::disk_free)
+        .def_readonly("disk_percent", &SystemSample::disk_percent)
+        .def_readonly("net_bytes_recv", &SystemSample::net_bytes_recv)
+        .def_readonly("net_bytes_sent", &SystemSample::net_bytes_sent)
+        .def_readonly("cgroup", &SystemSample::cgroup)
+        .def_readonly("cgroup_cpu_percent", &SystemSample::cgroup_cpu_percent)
+        .def_readonly("cgroup_memory_current", &SystemSample::cgroup_memory_current)
+        .def_readonly("cgroup_memory_max", &SystemSample::cgroup_memory_max);
+
+    // SystemSampler class - background /proc and cgroup sampler with a sample ring
+    py::class_<SystemSampler, std::shared_ptr<SystemSampler>>(m, "SystemSampler")
+        .def(py::init([](int interval_ms, size_t capacity, const std::string& disk_path,
+                         const std::string& cgroup_path) {
+                 SystemSamplerOptions options;
+                 options.interval_ms = interval_ms;
+                 options.capacity = capacity;
+                 options.disk_path = disk_path;
+                 options.cgroup_path = cgroup_path;
+                 return std::make_shared<SystemSampler>(options);
+             }),
+             py::arg("interval_ms") = SystemSamplerOptions{}.interval_ms,
+             py::arg("capacity") = SystemSamplerOptions{}.capacity,
+             py::arg("disk_path") = SystemSamplerOptions{}.disk_path, py::arg("cgroup_path") = "")
+        .def_static("supported", &SystemSampler::supported)
+        .def("start", &SystemSampler::start)
+        .def("stop", &SystemSampler::stop, py::call_guard<py::gil_scoped_release>())
+        .def("running", &SystemSampler::running)
+        .def("sample", &SystemSampler::sample, py::call_guard<py::gil_scoped_release>())
+        .def("latest", &SystemSampler::latest)
+        .def("since", &SystemSampler::since, py::arg("sequence"))
+        .def("has_cgroup", &SystemSampler::has_cgroup);
+
+    // MemoryHit struct
+    py::class_<MemoryHit>(m, "MemoryHit")
+        .def_readonly("id", &MemoryHit::id)
+        .def_readonly("score", &MemoryHit::score)
+        .def_readonly("relevance", &MemoryHit::relevance);
+
+    // MemoryIndex class - ranked full-text index over stored memories
+    py::class_<MemoryIndex, std::shared_ptr<MemoryIndex>>(m, "MemoryIndex")
+        .def(py::init([](double k1, double b, uint32_t tag_weight, double importance_weight,
+                         double recency_weight, double half_life_seconds) {
+                 MemoryIndexOptions options;
+                 options.k1 = k1;
+                 options.b = b;
+                 options.tag_weight = tag_weight;
+                 options.importance_weight = importance_weight;
+                 options.recency_weight = recency_weight;
+                 options.half_life_seconds = half_life_seconds;
+                 return std::make_shared<MemoryIndex>(options);
+             }),
+             py::arg("k1") = MemoryIndexOptions{}.k1, py::arg("b") = MemoryIndexOptions{}.b,
+             py::arg("tag_weight") = MemoryIndexOptions{}.tag_weight,
+             py::arg("importance_weight") = MemoryIndexOptions{}.importance_weight,
+             py::arg("recency_weight") = MemoryIndexOptions{}.recency_weight,
+             py::arg("half_life_seconds") = MemoryIndexOptions{}.half_life_seconds)
+        .def("add", &MemoryIndex::add, py::arg("id"), py::arg("session_id"), py::arg("memory_type"),
+             py::arg("timestamp"), py::arg("importance"), py::arg("content"),
+             py::arg("tags") = std::vector<std::string>{}, py::call_guard<py::gil_scoped_release>())
+        .def("remove", &MemoryIndex::remove, py::arg("id"))
+        .def("prune", &MemoryIndex::prune, py::arg("before"), py::arg("min_importance"))
+        .def("search",
+             [](const MemoryIndex& index, const std::string& text, size_t top_k, double now,
+                const std::string& session_id, const std::string& memory_type,
+                const std::vector<std::string>& tags, double min_importance) {
+                 MemoryQuery query;
+                 query.text = text;
+                 query.top_k = top_k;
+                 query.now = now;
+                 query.session_id = session_id;
+                 query.memory_type = memory_type;
+                 query.tags = tags;
+                 query.min_importance = min_importance;
+                 return index.search(query);
+             },
+             py::arg("query"), py::arg("top_k") = MemoryQuery{}.top_k, py::arg("now") = 0.0,
+             py::arg("session_id") = "", py::arg("memory_type") = "",
+             py::arg("tags") = std::vector<std::string>{}, py::arg("min_importance") = 0.0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("size", &MemoryIndex::size)
+        .def("term_count", &MemoryIndex::term_count)
+        .def("max_id", &MemoryIndex::max_id)
+        .def("memory_usage", &MemoryIndex::memory_usage)
+        .def("clear", &MemoryIndex::clear);
+}
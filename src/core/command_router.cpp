@@ -6,6 +6,8 @@
 #include "routing/agentic_mode_strategy.hpp"
 #include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 #include <string_view>
 
@@ -32,9 +34,10 @@ CommandResult CommandRouter::route_command(std::string_view input_text) {
     };
 
     // Try each strategy in priority order
-    for (auto& strategy : strategies_) {
-        if (strategy->can_handle(input_text)) {
-            return strategy->execute(input_text, context);
+    for (size_t i = 0; i < strategies_.size(); ++i) {
+        if (strategies_[i]->can_handle(input_text)) {
+            ScopedLatency timer(*latency_[i]);
+            return strategies_[i]->execute(input_text, context);
         }
     }
 
@@ -50,33 +53,42 @@ void CommandRouter::ensure_strategies_loaded() {
 }
 
 void CommandRouter::load_strategies() {
-    // Create all strategies with proper priority ordering
-    strategies_ = {
+    // Create all strategies with proper priority ordering, each named for
+    // its latency histogram
+    std::vector<std::pair<std::string, std::shared_ptr<CommandStrategy>>> named = {
         // High priority strategies (10-30)
-        std::make_shared<PipeStrategy>(session_, shell_),
-        std::make_shared<CdStrategy>(session_, shell_),
-        std::make_shared<ForceExecutionStrategy>(session_, shell_),
-        std::make_shared<ExitQuitStrategy>(session_, shell_),
-        std::make_shared<ConfigStrategy>(session_, shell_),
-        std::make_shared<DeviceRoutingStrategy>(session_, shell_),
-        std::make_shared<ExitBlockerStrategy>(session_, shell_),
-        std::make_shared<TaskModeStrategy>(session_, shell_),
-        std::make_shared<AgenticModeStrategy>(session_, shell_),
+        {"pipe", std::make_shared<PipeStrategy>(session_, shell_)},
+        {"cd", std::make_shared<CdStrategy>(session_, shell_)},
+        {"force_execution", std::make_shared<ForceExecutionStrategy>(session_, shell_)},
+        {"exit_quit", std::make_shared<ExitQuitStrategy>(session_, shell_)},
+        {"config", std::make_shared<ConfigStrategy>(session_, shell_)},
+        {"device_routing", std::make_shared<DeviceRoutingStrategy>(session_, shell_)},
+        {"exit_blocker", std::make_shared<ExitBlockerStrategy>(session_, shell_)},
+        {"task_mode", std::make_shared<TaskModeStrategy>(session_, shell_)},
+        {"agentic_mode", std::make_shared<AgenticModeStrategy>(session_, shell_)},
 
         // Medium priority strategies (50-60)
-        std::make_shared<MetaCommandStrategy>(session_, shell_),
-        std::make_shared<NaturalLanguageStrategy>(session_, shell_),
-        std::make_shared<UnixAliasStrategy>(session_, shell_),
+        {"meta_command", std::make_shared<MetaCommandStrategy>(session_, shell_)},
+        {"natural_language", std::make_shared<NaturalLanguageStrategy>(session_, shell_)},
+        {"unix_alias", std::make_shared<UnixAliasStrategy>(session_, shell_)},
 
         // Low priority - default strategy (100)
-        std::make_shared<TierExecutionStrategy>(session_, shell_)
+        {"tier_execution", std::make_shared<TierExecutionStrategy>(session_, shell_)}
     };
 
     // Sort by priority (lower number = higher priority)
-    std::sort(strategies_.begin(), strategies_.end(),
-              [](const auto& a, const auto& b) {
-                  return a->get_priority() < b->get_priority();
-              });
+    std::stable_sort(named.begin(), named.end(),
+                     [](const auto& a, const auto& b) {
+                         return a.second->get_priority() < b.second->get_priority();
+                     });
+
+    auto& metrics = MetricsRegistry::global();
+    strategies_.clear();
+    latency_.clear();
+    for (auto& [name, strategy] : named) {
+        strategies_.push_back(std::move(strategy));
+        latency_.push_back(&metrics.histogram("router." + name));
+    }
 }
 
 std::string CommandRouter::get_help() const {
@@ -3,6 +3,7 @@
 #include "tier_validator.hpp"
 #include "../adapters/shell_adapter.hpp"
 #include "memory_pool.hpp"
+#include "metrics.hpp"
 #include <memory>
 #include <string>
 #include <string_view>
@@ -71,6 +72,7 @@ private:
     std::shared_ptr<ShellAdapter> shell_;
     std::shared_ptr<TierValidator> validator_;
     std::vector<std::shared_ptr<CommandStrategy>> strategies_;
+    std::vector<LatencyHistogram*> latency_;   // "router.<strategy>", parallel to strategies_
     bool strategies_loaded_ = false;
 
     // Memory pool for CommandResult objects
@@ -0,0 +1,173 @@
+#include "file_io.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <random>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace isaac {
+
+#ifdef _WIN32
+bool write_file_synced(const std::filesystem::path& path, std::string_view data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+std::filesystem::path write_temp_file_synced(const std::filesystem::path& prefix, std::string_view data) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::random_device random;
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        std::filesystem::path path = prefix;
+        std::string suffix(8, '0');
+        for (char& c : suffix) c = kDigits[random() & 15];
+        path += suffix;
+        // CREATE_NEW fails if the name is taken, like O_EXCL
+        HANDLE handle = ::CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            if (::GetLastError() == ERROR_FILE_EXISTS) continue;
+            return {};
+        }
+        ::CloseHandle(handle);
+        if (write_file_synced(path, data)) return path;
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return {};
+    }
+    return {};
+}
+
+void sync_directory(const std::filesystem::path&) {}
+
+FileLock::FileLock(const std::filesystem::path& path) {
+    HANDLE handle = ::CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("cannot open lock file: " + path.string());
+    }
+    handle_ = handle;
+}
+
+FileLock::~FileLock() { ::CloseHandle(static_cast<HANDLE>(handle_)); }
+
+void FileLock::lock() {
+    OVERLAPPED overlapped{};
+    if (!::LockFileEx(static_cast<HANDLE>(handle_), LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+        throw std::runtime_error("cannot lock file");
+    }
+}
+
+bool FileLock::try_lock() {
+    OVERLAPPED overlapped{};
+    return ::LockFileEx(static_cast<HANDLE>(handle_), LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0,
+                        MAXDWORD, MAXDWORD, &overlapped) != 0;
+}
+
+void FileLock::lock_shared() {
+    OVERLAPPED overlapped{};
+    if (!::LockFileEx(static_cast<HANDLE>(handle_), 0, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+        throw std::runtime_error("cannot lock file");
+    }
+}
+
+void FileLock::unlock() {
+    OVERLAPPED overlapped{};
+    ::UnlockFileEx(static_cast<HANDLE>(handle_), 0, MAXDWORD, MAXDWORD, &overlapped);
+}
+#else
+namespace {
+
+// Write all of data to fd, fsync and close it
+bool write_and_close(int fd, std::string_view data) {
+    const char* cursor = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, cursor, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            return false;
+        }
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    bool ok = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && ok;
+}
+
+} // namespace
+
+bool write_file_synced(const std::filesystem::path& path, std::string_view data) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    return write_and_close(fd, data);
+}
+
+std::filesystem::path write_temp_file_synced(const std::filesystem::path& prefix, std::string_view data) {
+    std::string name = prefix.string() + "XXXXXX";
+    int fd = ::mkstemp(name.data());
+    if (fd < 0) {
+        return {};
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    if (!write_and_close(fd, data)) {
+        ::unlink(name.c_str());
+        return {};
+    }
+    return name;
+}
+
+void sync_directory(const std::filesystem::path& dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+FileLock::FileLock(const std::filesystem::path& path) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("cannot open lock file: " + path.string());
+    }
+}
+
+FileLock::~FileLock() { ::close(fd_); }
+
+void FileLock::lock() {
+    while (::flock(fd_, LOCK_EX) != 0) {
+        if (errno != EINTR) throw std::runtime_error("cannot lock file");
+    }
+}
+
+bool FileLock::try_lock() {
+    while (::flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+        if (errno == EWOULDBLOCK) return false;
+        if (errno != EINTR) throw std::runtime_error("cannot lock file");
+    }
+    return true;
+}
+
+void FileLock::lock_shared() {
+    while (::flock(fd_, LOCK_SH) != 0) {
+        if (errno != EINTR) throw std::runtime_error("cannot lock file");
+    }
+}
+
+void FileLock::unlock() { ::flock(fd_, LOCK_UN); }
+#endif
+
+} // namespace isaac
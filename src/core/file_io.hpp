@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+namespace isaac {
+
+/**
+ * Write data to path and flush it to stable storage before returning.
+ * The file is created or truncated; returns false on any I/O error.
+ */
+bool write_file_synced(const std::filesystem::path& path, std::string_view data);
+
+/**
+ * Like write_file_synced, but into a new file named prefix plus a unique
+ * suffix (mkstemp), so concurrent writers never share a temp file. Returns
+ * the file's path, or an empty path on any I/O error.
+ */
+std::filesystem::path write_temp_file_synced(const std::filesystem::path& prefix, std::string_view data);
+
+// fsync a directory so renames and creations inside it survive a crash (no-op on Windows)
+void sync_directory(const std::filesystem::path& dir);
+
+/**
+ * Advisory lock on a file, held across processes (flock on POSIX, LockFileEx
+ * on Windows). Threads of one process share the lock, so callers pair it
+ * with their own mutex. lock() and try_lock() are exclusive and satisfy
+ * Lockable for std::lock_guard; lock_shared() admits other shared holders.
+ */
+class FileLock {
+public:
+    // Creates the lock file if needed; throws std::runtime_error if it cannot be opened
+    explicit FileLock(const std::filesystem::path& path);
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    void lock();
+    bool try_lock();            // false if any other holder, shared or exclusive
+    void lock_shared();
+    void unlock();
+
+private:
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace isaac
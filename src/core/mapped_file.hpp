@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace isaac {
+
+/**
+ * Read-only memory mapping of a whole file.
+ * Empty files map successfully with size() == 0 and a null data().
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map the file, returns false (and leaves the object closed) on failure
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return open_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const {
+        return std::string_view(reinterpret_cast<const char*>(data_), size_);
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+} // namespace isaac
@@ -0,0 +1,178 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace isaac {
+
+namespace {
+
+int highest_bit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+void store_min(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void store_max(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+double to_ms(double nanos) {
+    return nanos / 1e6;
+}
+
+} // namespace
+
+void Gauge::add(double delta) {
+    double current = value_.load(std::memory_order_relaxed);
+    while (!value_.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+    }
+}
+
+int LatencyHistogram::bucket_of(uint64_t nanos) {
+    if (nanos < kSubBuckets) {
+        return static_cast<int>(nanos);
+    }
+    int exponent = highest_bit(nanos);
+    int sub = static_cast<int>((nanos >> (exponent - kSubBits)) & (kSubBuckets - 1));
+    return (exponent - kSubBits + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucket_floor(int bucket) {
+    if (bucket < kSubBuckets) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int exponent = bucket / kSubBuckets + kSubBits - 1;
+    uint64_t sub = static_cast<uint64_t>(bucket % kSubBuckets);
+    return (kSubBuckets + sub) << (exponent - kSubBits);
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets_[bucket_of(nanos)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(nanos, std::memory_order_relaxed);
+    store_min(min_, nanos);
+    store_max(max_, nanos);
+}
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration elapsed) {
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    record(static_cast<uint64_t>(std::max<int64_t>(nanos, 0)));
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    // Copy the buckets first; counts racing with the copy land in the next snapshot
+    std::array<uint64_t, kBuckets> counts;
+    uint64_t total = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    Snapshot snap;
+    if (total == 0) {
+        return snap;
+    }
+    uint64_t min = min_.load(std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    if (min > max) {
+        // The first records are still between their bucket increment and the
+        // min/max stores; bound the range by the copied buckets instead
+        int first = 0, last = kBuckets - 1;
+        while (counts[first] == 0) ++first;
+        while (counts[last] == 0) --last;
+        min = bucket_floor(first);
+        max = last + 1 < kBuckets ? bucket_floor(last + 1) - 1 : UINT64_MAX;
+    }
+    snap.count = total;
+    snap.sum_ms = to_ms(static_cast<double>(sum_.load(std::memory_order_relaxed)));
+    snap.min_ms = to_ms(static_cast<double>(min));
+    snap.max_ms = to_ms(static_cast<double>(max));
+
+    // Quantiles report the middle of the bucket holding the ranked value,
+    // clamped to the observed range
+    auto quantile = [&](double q) {
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t floor = bucket_floor(i);
+                uint64_t width = i < kSubBuckets ? 1 : uint64_t(1) << (i / kSubBuckets - 1);
+                double mid = static_cast<double>(floor) + static_cast<double>(width - 1) / 2;
+                return to_ms(std::clamp(mid, static_cast<double>(min), static_cast<double>(max)));
+            }
+        }
+        return snap.max_ms;
+    };
+    snap.p50_ms = quantile(0.50);
+    snap.p99_ms = quantile(0.99);
+    snap.p999_ms = quantile(0.999);
+    return snap;
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = counters_[name];
+    if (!slot) {
+        slot = std::make_unique<Counter>();
+    }
+    return *slot;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = gauges_[name];
+    if (!slot) {
+        slot = std::make_unique<Gauge>();
+    }
+    return *slot;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = histograms_[name];
+    if (!slot) {
+        slot = std::make_unique<LatencyHistogram>();
+    }
+    return *slot;
+}
+
+std::vector<MetricSample> MetricsRegistry::snapshot() const {
+    std::vector<MetricSample> samples;
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples.reserve(counters_.size() + gauges_.size() + histograms_.size());
+    for (const auto& [name, counter] : counters_) {
+        samples.push_back({name, "counter", static_cast<double>(counter->value()), {}});
+    }
+    for (const auto& [name, gauge] : gauges_) {
+        samples.push_back({name, "gauge", gauge->value(), {}});
+    }
+    for (const auto& [name, histogram] : histograms_) {
+        auto latency = histogram->snapshot();
+        samples.push_back({name, "histogram", static_cast<double>(latency.count), latency});
+    }
+    std::sort(samples.begin(), samples.end(),
+              [](const MetricSample& a, const MetricSample& b) { return a.name < b.name; });
+    return samples;
+}
+
+} // namespace isaac
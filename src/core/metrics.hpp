@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace isaac {
+
+class Counter {
+public:
+    void add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+class Gauge {
+public:
+    void set(double value) { value_.store(value, std::memory_order_relaxed); }
+    void add(double delta);
+    double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value_{0};
+};
+
+/**
+ * Log-linear latency histogram over nanoseconds.
+ *
+ * Values below 16 get a bucket each; above that every power of two is
+ * split into 16 linear sub-buckets, so any recorded value is reported
+ * within 1/16 (6.25%) of itself across the whole 64-bit range. Recording
+ * is a handful of relaxed atomic operations and never blocks.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    struct Snapshot {
+        uint64_t count = 0;
+        double sum_ms = 0;
+        double min_ms = 0;              // valid when count > 0
+        double max_ms = 0;
+        double p50_ms = 0;
+        double p99_ms = 0;
+        double p999_ms = 0;
+    };
+
+    void record(uint64_t nanos);
+    void record(std::chrono::steady_clock::duration elapsed);
+
+    Snapshot snapshot() const;
+
+    static int bucket_of(uint64_t nanos);
+    static uint64_t bucket_floor(int bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Records the time from construction to destruction into a histogram
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() { histogram_.record(std::chrono::steady_clock::now() - start_); }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+struct MetricSample {
+    std::string name;
+    std::string kind;                   // "counter", "gauge" or "histogram"
+    double value = 0;                   // counter total or gauge value; histogram count
+    LatencyHistogram::Snapshot latency; // histograms only
+};
+
+/**
+ * Process-wide named metrics.
+ *
+ * Metrics are created on first lookup and live as long as the process, so
+ * callers look a metric up once and keep the reference; only the lookup
+ * takes the registry lock, updates are lock-free.
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& global();
+
+    Counter& counter(const std::string& name);
+    Gauge& gauge(const std::string& name);
+    LatencyHistogram& histogram(const std::string& name);
+
+    // Every metric, sorted by name
+    std::vector<MetricSample> snapshot() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Counter>> counters_;
+    std::map<std::string, std::unique_ptr<Gauge>> gauges_;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms_;
+};
+
+} // namespace isaac
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace isaac {
+
+/**
+ * SHA-1 (FIPS 180-4), fed in pieces with update(). Only for reading formats
+ * that are keyed by it, such as git blob ids; use Sha256 for new ones.
+ */
+class Sha1 {
+public:
+    using Digest = std::array<uint8_t, 20>;
+
+    Sha1();
+
+    void update(const void* data, size_t size);
+    void update(std::string_view text) { update(text.data(), text.size()); }
+
+    // Final digest; the object must not be updated afterwards
+    Digest finish();
+
+private:
+    void compress(const uint8_t* block);
+
+    std::array<uint32_t, 5> state_;
+    std::array<uint8_t, 64> buffer_{};
+    size_t buffered_ = 0;
+    uint64_t length_ = 0;               // bytes hashed so far
+};
+
+} // namespace isaac
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace isaac {
+
+/**
+ * SHA-256 (FIPS 180-4), fed in pieces with update(). Used where content
+ * addresses must not collide, e.g. the pipeline step cache.
+ */
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    void update(const void* data, size_t size);
+    void update(std::string_view text) { update(text.data(), text.size()); }
+
+    // Final digest; the object must not be updated afterwards
+    Digest finish();
+
+    static std::string hex(const Digest& digest);
+
+private:
+    void compress(const uint8_t* block);
+
+    std::array<uint32_t, 8> state_;
+    std::array<uint8_t, 64> buffer_{};
+    size_t buffered_ = 0;
+    uint64_t length_ = 0;               // bytes hashed so far
+};
+
+// Lowercase hex SHA-256 of data
+std::string sha256_hex(std::string_view data);
+
+} // namespace isaac
@@ -6,13 +6,20 @@
 
 namespace isaac {
 
-TierValidator::TierValidator() {
+TierValidator::TierValidator()
+    : latency_(MetricsRegistry::global().histogram("tier.get_tier")),
+      unknown_(MetricsRegistry::global().counter("tier.unknown_commands")) {
     load_tier_defaults();
 }
 
 TierValidator::~TierValidator() = default;
 
 float TierValidator::get_tier(const std::string& command) const {
+    ScopedLatency timer(latency_);
+    return classify(command);
+}
+
+float TierValidator::classify(const std::string& command) const {
     // Handle empty or whitespace-only commands
     if (command.empty() || std::all_of(command.begin(), command.end(), ::isspace)) {
         return 3.0f;
@@ -41,6 +48,7 @@ float TierValidator::get_tier(const std::string& command) const {
     }
 
     // Unknown commands default to Tier 3 (validation required)
+    unknown_.add();
     return 3.0f;
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "metrics.hpp"
 #include <map>
 #include <string>
 #include <vector>
@@ -21,12 +22,16 @@ public:
     bool requires_validation(const std::string& command) const;
 
 private:
+    float classify(const std::string& command) const;
     void load_tier_defaults();
     bool load_from_file();
     void load_hardcoded_defaults();
     void parse_json(const std::string& json_content);
 
     std::map<std::string, std::vector<std::string>> tier_defaults_;
+
+    LatencyHistogram& latency_;         // "tier.get_tier"
+    Counter& unknown_;                  // commands not in any tier list
 };
 
 } // namespace isaac
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace isaac {
+
+// Length of the valid UTF-8 sequence at text[pos], or 0 if it is malformed
+inline size_t utf8_sequence_length(std::string_view text, size_t pos) {
+    const auto lead = static_cast<uint8_t>(text[pos]);
+    size_t len = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xe ? 3 : (lead >> 3) == 0x1e ? 4 : 0;
+    if (len == 0 || pos + len > text.size()) {
+        return 0;
+    }
+    for (size_t i = 1; i < len; ++i) {
+        if ((static_cast<uint8_t>(text[pos + i]) & 0xc0) != 0x80) return 0;
+    }
+    return len;
+}
+
+/**
+ * Copy text replacing malformed UTF-8 with U+FFFD, so byte slices of
+ * arbitrary files can be handed to Python as str without decode errors.
+ */
+inline std::string to_valid_utf8(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t len = utf8_sequence_length(text, pos);
+        if (len == 0) {
+            out += "\xef\xbf\xbd";
+            ++pos;
+        } else {
+            out.append(text.data() + pos, len);
+            pos += len;
+        }
+    }
+    return out;
+}
+
+// Move a byte offset back to the start of the UTF-8 character containing it
+inline size_t utf8_floor(std::string_view text, size_t pos) {
+    while (pos > 0 && pos < text.size() && (static_cast<uint8_t>(text[pos]) & 0xc0) == 0x80) --pos;
+    return pos;
+}
+
+} // namespace isaac
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace isaac {
+
+/**
+ * LEB128-style variable-length integer helpers used by the compact
+ * on-disk and in-memory encodings (posting lists, logs, journals).
+ */
+inline void varint_encode(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Decode one value starting at pos, advancing pos. Returns false on truncation.
+inline bool varint_decode(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    int shift = 0;
+    while (pos < size && shift < 64) {
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+// ZigZag mapping so small negative deltas stay small
+inline uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Length-prefixed string and presence-flagged optional string, for log records
+inline void put_string(std::vector<uint8_t>& out, std::string_view text) {
+    varint_encode(out, text.size());
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+inline void put_optional(std::vector<uint8_t>& out, const std::optional<std::string>& text) {
+    out.push_back(text ? 1 : 0);
+    if (text) put_string(out, *text);
+}
+
+// Bounds-checked reader for records built with the helpers above
+class VarintReader {
+public:
+    explicit VarintReader(std::string_view data)
+        : data_(reinterpret_cast<const uint8_t*>(data.data())), size_(data.size()) {}
+
+    bool byte(uint8_t& value) {
+        if (pos_ >= size_) return false;
+        value = data_[pos_++];
+        return true;
+    }
+    bool number(uint64_t& value) { return varint_decode(data_, size_, pos_, value); }
+    bool signed_number(int64_t& value) {
+        uint64_t raw;
+        if (!number(raw)) return false;
+        value = zigzag_decode(raw);
+        return true;
+    }
+    bool string(std::string& text) {
+        uint64_t length;
+        if (!number(length) || length > size_ - pos_) return false;
+        text.assign(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return true;
+    }
+    bool optional(std::optional<std::string>& text) {
+        uint8_t present;
+        if (!byte(present)) return false;
+        if (!present) {
+            text.reset();
+            return true;
+        }
+        text.emplace();
+        return string(*text);
+    }
+    size_t position() const { return pos_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+} // namespace isaac
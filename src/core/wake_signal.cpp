@@ -0,0 +1,87 @@
+#include "wake_signal.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <chrono>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+namespace isaac {
+
+#ifdef _WIN32
+WakeSignal::WakeSignal() = default;
+WakeSignal::~WakeSignal() = default;
+
+void WakeSignal::notify() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        signaled_ = true;
+    }
+    cv_.notify_all();
+}
+
+bool WakeSignal::wait(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto ready = [this] { return signaled_; };
+    if (timeout_ms < 0) {
+        cv_.wait(lock, ready);
+    } else if (!cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready)) {
+        return false;
+    }
+    signaled_ = false;
+    return true;
+}
+#else
+WakeSignal::WakeSignal() {
+#ifdef __linux__
+    read_fd_ = write_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+    int fds[2];
+    if (::pipe(fds) == 0) {
+        for (int fd : fds) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        read_fd_ = fds[0];
+        write_fd_ = fds[1];
+    }
+#endif
+}
+
+WakeSignal::~WakeSignal() {
+    if (read_fd_ >= 0) ::close(read_fd_);
+    if (write_fd_ >= 0 && write_fd_ != read_fd_) ::close(write_fd_);
+}
+
+void WakeSignal::notify() {
+#ifdef __linux__
+    uint64_t one = 1;
+    while (::write(write_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {}
+#else
+    char byte = 1;
+    while (::write(write_fd_, &byte, 1) < 0 && errno == EINTR) {}  // EAGAIN: already signaled
+#endif
+}
+
+bool WakeSignal::wait(int timeout_ms) {
+    pollfd pfd{read_fd_, POLLIN, 0};
+    int ready;
+    do {
+        ready = ::poll(&pfd, 1, timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    if (ready <= 0) return false;
+
+    // Drain so notifications coalesce
+    char buffer[64];
+    while (::read(read_fd_, buffer, sizeof(buffer)) > 0) {}
+    return true;
+}
+#endif
+
+} // namespace isaac
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+namespace isaac {
+
+/**
+ * Cross-thread wakeup with a pollable descriptor.
+ *
+ * Linux uses an eventfd, other POSIX systems a non-blocking pipe, so the
+ * descriptor can be handed to select/poll loops; Windows falls back to a
+ * condition variable and fd() returns -1. Notifications coalesce: any
+ * number of notify() calls wake one wait().
+ */
+class WakeSignal {
+public:
+    WakeSignal();
+    ~WakeSignal();
+
+    WakeSignal(const WakeSignal&) = delete;
+    WakeSignal& operator=(const WakeSignal&) = delete;
+
+    void notify();
+
+    // Block until notified or timeout (negative = forever); consumes the notification
+    bool wait(int timeout_ms);
+
+    // Readable while a notification is pending; -1 where unsupported
+    int fd() const { return read_fd_; }
+
+private:
+    int read_fd_ = -1;
+    int write_fd_ = -1;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool signaled_ = false;
+};
+
+} // namespace isaac
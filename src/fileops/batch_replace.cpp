@@ -0,0 +1,538 @@
+#include "batch_replace.hpp"
+#include "file_search.hpp"
+#include "core/file_io.hpp"
+#include "core/mapped_file.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t kBinaryProbeBytes = 8192;
+constexpr size_t kMaxJournals = 20;
+const char* const kJournalDir = ".isaac/undo";
+
+std::string make_transaction_id() {
+    std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%S", std::gmtime(&now));
+
+    std::random_device rd;
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "%08x", static_cast<unsigned>(rd()));
+    return std::string(stamp) + "-" + suffix;
+}
+
+int64_t mtime_ns(const fs::path& path, std::error_code& ec) {
+    auto time = fs::last_write_time(path, ec);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+std::string read_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    return out.str();
+}
+
+// Journal manifest: one "<rel path>\t<temp file name>\t<size>\t<mtime ns>" line per
+// file, index = line number; size and mtime are those of the committed contents
+struct JournalEntry {
+    std::string rel_path;
+    std::string temp_name;
+    bool stamped = false;       // journals written before the stamp was added lack it
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+};
+
+std::vector<JournalEntry> read_manifest(const fs::path& journal) {
+    std::vector<JournalEntry> entries;
+    std::ifstream in(journal / "manifest");
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        JournalEntry entry;
+        if (!std::getline(fields, entry.rel_path, '\t') || !std::getline(fields, entry.temp_name, '\t')) {
+            continue;
+        }
+        entry.stamped = static_cast<bool>(fields >> entry.size >> entry.mtime_ns);
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+std::string read_state(const fs::path& journal) {
+    std::ifstream in(journal / "state");
+    std::string state;
+    std::getline(in, state);
+    return state;
+}
+
+// Held by a commit from writing its journal until it is marked committed, and
+// by undo() and recover(), so no process rolls back another's commit in flight
+fs::path journal_lock_path(const fs::path& journals) {
+    return journals / "lock";
+}
+
+fs::path backup_path(const fs::path& journal, size_t index) {
+    return journal / (std::to_string(index) + ".orig");
+}
+
+// Put every journaled original back and drop leftover temp files
+size_t restore_journal(const fs::path& root, const fs::path& journal) {
+    size_t restored = 0;
+    auto entries = read_manifest(journal);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        fs::path target = root / fs::u8path(entries[i].rel_path);
+        std::error_code ec;
+        fs::remove(target.parent_path() / entries[i].temp_name, ec);
+        if (fs::exists(backup_path(journal, i), ec)) {
+            fs::rename(backup_path(journal, i), target, ec);
+            if (!ec) ++restored;
+        }
+    }
+    std::set<fs::path> dirs;
+    for (const auto& entry : entries) {
+        dirs.insert((root / fs::u8path(entry.rel_path)).parent_path());
+    }
+    for (const auto& dir : dirs) {
+        sync_directory(dir);
+    }
+    return restored;
+}
+
+void prune_journals(const fs::path& journals) {
+    std::vector<fs::path> committed;
+    std::error_code ec;
+    for (fs::directory_iterator it(journals, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->is_directory() && read_state(it->path()) == "committed") {
+            committed.push_back(it->path());
+        }
+    }
+    if (committed.size() <= kMaxJournals) {
+        return;
+    }
+    // Ids start with a UTC timestamp, so name order is age order
+    std::sort(committed.begin(), committed.end());
+    for (size_t i = 0; i + kMaxJournals < committed.size(); ++i) {
+        fs::remove_all(committed[i], ec);
+    }
+}
+
+std::vector<size_t> line_starts(std::string_view text) {
+    std::vector<size_t> starts;
+    if (text.empty()) return starts;
+    starts.push_back(0);
+    for (size_t i = 0; i + 1 < text.size(); ++i) {
+        if (text[i] == '\n') starts.push_back(i + 1);
+    }
+    return starts;
+}
+
+size_t line_of(const std::vector<size_t>& starts, size_t offset) {
+    auto it = std::upper_bound(starts.begin(), starts.end(), offset);
+    return it == starts.begin() ? 0 : static_cast<size_t>(it - starts.begin() - 1);
+}
+
+std::string_view line_at(std::string_view text, const std::vector<size_t>& starts, size_t line) {
+    size_t end = line + 1 < starts.size() ? starts[line + 1] : text.size();
+    return text.substr(starts[line], end - starts[line]);
+}
+
+void append_line(std::string& out, char marker, std::string_view line) {
+    out += marker;
+    out.append(line.data(), line.size());
+    if (line.empty() || line.back() != '\n') {
+        out += "\n\\ No newline at end of file\n";
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// ReplacePlan
+// ============================================================================
+
+ReplacePlan::ReplacePlan(fs::path root, std::string transaction_id, bool dry_run)
+    : root_(std::move(root)), transaction_id_(std::move(transaction_id)), dry_run_(dry_run) {}
+
+ReplacePlan::~ReplacePlan() {
+    discard();
+}
+
+size_t ReplacePlan::total_replacements() const {
+    size_t total = 0;
+    for (const auto& edit : edits_) total += edit.replacements;
+    return total;
+}
+
+bool ReplacePlan::committed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return committed_;
+}
+
+std::string ReplacePlan::diff(const std::string& path, int context_lines) const {
+    auto it = std::find_if(edits_.begin(), edits_.end(), [&](const FileEdit& e) { return e.path == path; });
+    if (it == edits_.end()) {
+        return "";
+    }
+    const PendingFile& file = files_[static_cast<size_t>(it - edits_.begin())];
+
+    std::string old_text;
+    std::string new_text;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (discarded_ && !committed_) return "";
+        old_text = read_file(committed_ ? file.backup : file.target);
+        if (!dry_run_) new_text = read_file(committed_ ? file.target : file.temp);
+    }
+    if (dry_run_) {
+        // Rebuild the new contents from the original and the inserted text
+        if (old_text.size() != file.size) return "";
+        size_t cursor = 0;
+        size_t inserted = 0;
+        for (const Span& span : file.spans) {
+            new_text.append(old_text, cursor, span.old_start - cursor);
+            new_text.append(file.inserted, inserted, span.new_len);
+            inserted += span.new_len;
+            cursor = span.old_start + span.old_len;
+        }
+        new_text.append(old_text, cursor, std::string::npos);
+    }
+    const auto old_starts = line_starts(old_text);
+    const auto new_starts = line_starts(new_text);
+
+    // Line ranges touched by each replacement; text outside them is identical
+    struct Range { size_t ol0, ol1, nl0, nl1; };
+    std::vector<Range> ranges;
+    for (const Span& span : file.spans) {
+        Range r{line_of(old_starts, span.old_start), 0, line_of(new_starts, span.new_start), 0};
+        r.ol1 = std::min(line_of(old_starts, span.old_start + span.old_len) + 1, old_starts.size());
+        r.nl1 = std::min(line_of(new_starts, span.new_start + span.new_len) + 1, new_starts.size());
+        if (!ranges.empty() && r.ol0 <= ranges.back().ol1) {
+            ranges.back().ol1 = std::max(ranges.back().ol1, r.ol1);
+            ranges.back().nl1 = std::max(ranges.back().nl1, r.nl1);
+        } else {
+            ranges.push_back(r);
+        }
+    }
+
+    const size_t ctx = static_cast<size_t>(std::max(0, context_lines));
+    std::string out = "--- a/" + path + "\n+++ b/" + path + "\n";
+
+    for (size_t first = 0; first < ranges.size();) {
+        size_t last = first;
+        while (last + 1 < ranges.size() && ranges[last + 1].ol0 - ranges[last].ol1 <= 2 * ctx) ++last;
+
+        size_t old_begin = ranges[first].ol0 - std::min(ctx, ranges[first].ol0);
+        size_t new_begin = ranges[first].nl0 - (ranges[first].ol0 - old_begin);
+        size_t old_end = std::min(old_starts.size(), ranges[last].ol1 + ctx);
+        size_t new_end = ranges[last].nl1 + (old_end - ranges[last].ol1);
+
+        size_t old_count = old_end - old_begin;
+        size_t new_count = new_end - new_begin;
+        out += "@@ -" + std::to_string(old_count ? old_begin + 1 : old_begin) + "," + std::to_string(old_count) +
+               " +" + std::to_string(new_count ? new_begin + 1 : new_begin) + "," + std::to_string(new_count) +
+               " @@\n";
+
+        size_t pos = old_begin;
+        for (size_t i = first; i <= last; ++i) {
+            const Range& r = ranges[i];
+            for (; pos < r.ol0; ++pos) append_line(out, ' ', line_at(old_text, old_starts, pos));
+            for (size_t l = r.ol0; l < r.ol1; ++l) append_line(out, '-', line_at(old_text, old_starts, l));
+            for (size_t l = r.nl0; l < r.nl1; ++l) append_line(out, '+', line_at(new_text, new_starts, l));
+            pos = r.ol1;
+        }
+        for (; pos < old_end; ++pos) append_line(out, ' ', line_at(old_text, old_starts, pos));
+
+        first = last + 1;
+    }
+    return out;
+}
+
+void ReplacePlan::commit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (committed_ || discarded_) {
+        throw std::runtime_error("Replace plan " + transaction_id_ + " is no longer pending");
+    }
+    if (dry_run_) {
+        throw std::runtime_error("Replace plan " + transaction_id_ + " is a dry run");
+    }
+
+    for (size_t i = 0; i < files_.size(); ++i) {
+        std::error_code ec;
+        auto size = fs::file_size(files_[i].target, ec);
+        if (ec || size != files_[i].size || mtime_ns(files_[i].target, ec) != files_[i].mtime_ns) {
+            throw std::runtime_error(edits_[i].path + " changed since the replace was prepared");
+        }
+    }
+    if (files_.empty()) {
+        committed_ = true;
+        return;
+    }
+
+    // Phase 1: journal the originals (hard links, so no data is copied)
+    const fs::path journal = root_ / kJournalDir / transaction_id_;
+    std::error_code ec;
+    fs::create_directories(journal, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot create undo journal " + journal.string() + ": " + ec.message());
+    }
+    FileLock journal_lock(journal_lock_path(journal.parent_path()));
+    std::lock_guard<FileLock> journal_held(journal_lock);
+
+    std::string manifest;
+    for (size_t i = 0; i < files_.size(); ++i) {
+        PendingFile& file = files_[i];
+        file.backup = backup_path(journal, i);
+        fs::create_hard_link(file.target, file.backup, ec);
+        if (ec) {
+            ec.clear();
+            fs::copy_file(file.target, file.backup, fs::copy_options::overwrite_existing, ec);
+        }
+        if (ec) {
+            fs::remove_all(journal, ec);
+            throw std::runtime_error("Cannot journal " + edits_[i].path);
+        }
+        // rename keeps the inode, so the temp's stamp is the committed file's
+        auto size = fs::file_size(file.temp, ec);
+        int64_t stamp = ec ? 0 : mtime_ns(file.temp, ec);
+        if (ec) {
+            fs::remove_all(journal, ec);
+            throw std::runtime_error("Cannot stat the staged " + edits_[i].path);
+        }
+        manifest += edits_[i].path + "\t" + file.temp.filename().u8string() + "\t" + std::to_string(size) +
+                    "\t" + std::to_string(stamp) + "\n";
+    }
+    if (!write_file_synced(journal / "manifest", manifest) || !write_file_synced(journal / "state", "pending\n")) {
+        fs::remove_all(journal, ec);
+        throw std::runtime_error("Cannot write undo journal " + journal.string());
+    }
+    sync_directory(journal);
+
+    // Phase 2: swap every file in; any failure rolls the whole set back
+    for (size_t i = 0; i < files_.size(); ++i) {
+        fs::rename(files_[i].temp, files_[i].target, ec);
+        if (ec) {
+            std::string message = "Cannot replace " + edits_[i].path + ": " + ec.message();
+            restore_journal(root_, journal);
+            fs::remove_all(journal, ec);
+            discarded_ = true;
+            throw std::runtime_error(message);
+        }
+    }
+
+    std::set<fs::path> dirs;
+    for (const auto& file : files_) dirs.insert(file.target.parent_path());
+    for (const auto& dir : dirs) sync_directory(dir);
+
+    write_file_synced(journal / "state", "committed\n");
+    committed_ = true;
+    prune_journals(root_ / kJournalDir);
+}
+
+void ReplacePlan::discard() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (committed_ || discarded_) {
+        return;
+    }
+    for (const auto& file : files_) {
+        if (file.temp.empty()) continue;
+        std::error_code ec;
+        fs::remove(file.temp, ec);
+    }
+    discarded_ = true;
+}
+
+// ============================================================================
+// BatchReplacer
+// ============================================================================
+
+BatchReplacer::BatchReplacer(std::string root) : root_(std::move(root)) {}
+
+std::shared_ptr<ReplacePlan> BatchReplacer::prepare(const std::string& pattern, const std::string& replacement,
+                                                    const ReplaceOptions& options) const {
+    std::regex regex;
+    try {
+        regex = std::regex(pattern, std::regex::ECMAScript | std::regex::optimize);
+    } catch (const std::regex_error& e) {
+        throw std::invalid_argument("Unsupported replace pattern '" + pattern + "': " + e.what());
+    }
+    const std::string literal = FileSearcher::required_literal(pattern);
+    const size_t max_subject = FileSearcher::max_regex_subject(pattern);
+
+    std::shared_ptr<ReplacePlan> plan(new ReplacePlan(root_, make_transaction_id(), options.dry_run));
+    const std::string temp_suffix = ".isaac-" + plan->transaction_id() + ".tmp";
+
+    struct Result {
+        FileEdit edit;
+        ReplacePlan::PendingFile file;
+    };
+    std::vector<Result> results;
+    std::vector<std::string> errors;
+    std::string too_long;
+    std::mutex results_mutex;
+
+    WalkOptions walk_options;
+    walk_options.include_globs = options.include_globs;
+    walk_options.use_ignore_files = options.use_ignore_files;
+    walk_options.threads = options.threads;
+    FileWalker walker(root_, walk_options);
+
+    walker.walk([&](const std::string& rel_path, const fs::path& path) {
+        std::error_code ec;
+        Result result;
+        result.file.target = path;
+        result.file.mtime_ns = mtime_ns(path, ec);
+
+        MappedFile mapped;
+        if (ec || !mapped.open(path.string())) return;
+        const std::string_view text = mapped.view();
+        result.file.size = text.size();
+
+        if (std::memchr(text.data(), '\0', std::min(text.size(), kBinaryProbeBytes)) != nullptr) return;
+        if (!literal.empty() && text.find(literal) == std::string_view::npos) return;
+        if (text.size() > max_subject) {
+            // std::regex would recurse once per character across the whole file
+            std::lock_guard<std::mutex> lock(results_mutex);
+            too_long = rel_path;
+            return;
+        }
+
+        // A dry run only collects the inserted text; the rest is the original
+        std::string out;
+        std::string& sink = options.dry_run ? result.file.inserted : out;
+        size_t new_size = 0;
+        try {
+            const char* cursor = text.data();
+            std::cregex_iterator it(text.data(), text.data() + text.size(), regex);
+            for (; it != std::cregex_iterator(); ++it) {
+                const std::cmatch& m = *it;
+                if (!options.dry_run) out.append(cursor, m[0].first);
+                new_size += static_cast<size_t>(m[0].first - cursor);
+                ReplacePlan::Span span{static_cast<size_t>(m[0].first - text.data()),
+                                       static_cast<size_t>(m[0].length()), new_size, 0};
+                const size_t before = sink.size();
+                sink += m.format(replacement);
+                span.new_len = sink.size() - before;
+                new_size += span.new_len;
+                result.file.spans.push_back(span);
+                cursor = m[0].second;
+            }
+            if (!options.dry_run) out.append(cursor, text.data() + text.size());
+            new_size += static_cast<size_t>(text.data() + text.size() - cursor);
+        } catch (const std::regex_error& e) {
+            std::lock_guard<std::mutex> lock(results_mutex);
+            errors.push_back(rel_path + ": " + e.what());
+            return;
+        }
+        if (result.file.spans.empty()) return;
+
+        if (options.dry_run) {
+            result.edit = FileEdit{rel_path, result.file.spans.size(), text.size(), new_size};
+            std::lock_guard<std::mutex> lock(results_mutex);
+            results.push_back(std::move(result));
+            return;
+        }
+
+        result.file.temp = path.parent_path() / ("." + path.filename().u8string() + temp_suffix);
+        if (!write_file_synced(result.file.temp, out)) {
+            fs::remove(result.file.temp, ec);
+            std::lock_guard<std::mutex> lock(results_mutex);
+            errors.push_back(rel_path + ": cannot write temp file");
+            return;
+        }
+        fs::permissions(result.file.temp, fs::status(path, ec).permissions(), ec);
+
+        result.edit = FileEdit{rel_path, result.file.spans.size(), text.size(), out.size()};
+        std::lock_guard<std::mutex> lock(results_mutex);
+        results.push_back(std::move(result));
+    });
+
+    std::sort(results.begin(), results.end(),
+              [](const Result& a, const Result& b) { return a.edit.path < b.edit.path; });
+    for (auto& result : results) {
+        plan->edits_.push_back(std::move(result.edit));
+        plan->files_.push_back(std::move(result.file));
+    }
+
+    if (!too_long.empty()) {
+        plan->discard();
+        throw std::invalid_argument("Replace pattern '" + pattern + "' repeats over " + too_long +
+                                    ", which is too long to match natively");
+    }
+    if (!errors.empty()) {
+        plan->discard();
+        throw std::runtime_error("Replace failed, no files changed: " + errors.front());
+    }
+    return plan;
+}
+
+size_t BatchReplacer::undo(const std::string& root, const std::string& transaction_id, bool force) {
+    const fs::path journal = fs::path(root) / kJournalDir / transaction_id;
+    if (!fs::is_directory(journal)) {
+        throw std::invalid_argument("No committed replace transaction '" + transaction_id + "'");
+    }
+    FileLock journal_lock(journal_lock_path(journal.parent_path()));
+    std::lock_guard<FileLock> journal_held(journal_lock);
+    const std::string state = read_state(journal);
+    if (state != "committed") {
+        throw std::invalid_argument("No committed replace transaction '" + transaction_id + "'");
+    }
+
+    // Restoring over later edits would silently lose them
+    if (!force) {
+        for (const auto& entry : read_manifest(journal)) {
+            if (!entry.stamped) continue;
+            fs::path target = fs::path(root) / fs::u8path(entry.rel_path);
+            std::error_code ec;
+            auto size = fs::file_size(target, ec);
+            if (ec || size != entry.size || mtime_ns(target, ec) != entry.mtime_ns) {
+                throw std::runtime_error(entry.rel_path + " changed since the replace was committed");
+            }
+        }
+    }
+
+    size_t restored = restore_journal(root, journal);
+    std::error_code ec;
+    fs::remove_all(journal, ec);
+    return restored;
+}
+
+std::vector<std::string> BatchReplacer::recover(const std::string& root) {
+    std::vector<std::string> recovered;
+    std::vector<fs::path> interrupted;
+    const fs::path journals = fs::path(root) / kJournalDir;
+    std::error_code ec;
+    if (!fs::is_directory(journals, ec)) {
+        return recovered;
+    }
+    // Waits out any commit in progress, which then reads as committed
+    FileLock journal_lock(journal_lock_path(journals));
+    std::lock_guard<FileLock> journal_held(journal_lock);
+    for (fs::directory_iterator it(journals, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        // Pending (or never finished writing its state): the commit was interrupted
+        if (it->is_directory() && read_state(it->path()) != "committed") {
+            interrupted.push_back(it->path());
+        }
+    }
+    for (const auto& journal : interrupted) {
+        restore_journal(root, journal);
+        fs::remove_all(journal, ec);
+        recovered.push_back(journal.filename().u8string());
+    }
+    return recovered;
+}
+
+} // namespace isaac
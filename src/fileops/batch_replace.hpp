@@ -0,0 +1,118 @@
+#pragma once
+
+#include "file_walker.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace isaac {
+
+struct ReplaceOptions {
+    std::vector<std::string> include_globs;
+    bool use_ignore_files = true;
+    unsigned threads = 0;
+    bool dry_run = false;       // write no temp files; the plan can diff but not commit
+};
+
+struct FileEdit {
+    std::string path;           // relative to the root, '/'-separated
+    size_t replacements = 0;
+    size_t original_size = 0;
+    size_t new_size = 0;
+};
+
+/**
+ * A prepared multi-file replacement. Every rewritten file already sits in a
+ * synced temp file next to its target; commit() journals the originals under
+ * .isaac/undo/<transaction_id>/ and then renames all temps into place, so the
+ * tree moves from fully old to fully new. Uncommitted temps are removed when
+ * the plan is discarded or destroyed. A dry-run plan keeps only the inserted
+ * text in memory and never touches the tree.
+ */
+class ReplacePlan {
+public:
+    ~ReplacePlan();
+
+    ReplacePlan(const ReplacePlan&) = delete;
+    ReplacePlan& operator=(const ReplacePlan&) = delete;
+
+    const std::vector<FileEdit>& edits() const { return edits_; }
+    size_t total_replacements() const;
+    const std::string& transaction_id() const { return transaction_id_; }
+    bool committed() const;
+
+    // Unified diff of one file ("" if the file is not part of the plan)
+    std::string diff(const std::string& path, int context_lines = 3) const;
+
+    // Throws std::runtime_error if a target changed since prepare(), a rename fails
+    // or the plan is a dry run; in every case the tree is left as it was before the call
+    void commit();
+    void discard();
+
+private:
+    friend class BatchReplacer;
+
+    // Byte ranges of one replacement in the old and new contents
+    struct Span {
+        size_t old_start;
+        size_t old_len;
+        size_t new_start;
+        size_t new_len;
+    };
+
+    struct PendingFile {
+        std::filesystem::path target;
+        std::filesystem::path temp;
+        std::filesystem::path backup;   // original once committed
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+        std::vector<Span> spans;
+        std::string inserted;           // dry run: every span's new text, in order
+    };
+
+    ReplacePlan(std::filesystem::path root, std::string transaction_id, bool dry_run);
+
+    std::filesystem::path root_;
+    std::string transaction_id_;
+    std::vector<FileEdit> edits_;        // sorted by path, parallel to files_
+    std::vector<PendingFile> files_;
+    mutable std::mutex mutex_;
+    bool dry_run_ = false;
+    bool committed_ = false;
+    bool discarded_ = false;
+};
+
+/**
+ * Parallel regex replace across a project tree with all-or-nothing commit.
+ *
+ * Patterns use ECMAScript syntax and are applied to whole files; replacement
+ * strings use ECMAScript format syntax ($1, $&, $$). A pattern that repeats
+ * is refused for files longer than FileSearcher::max_regex_subject(), since
+ * std::regex recurses per character.
+ */
+class BatchReplacer {
+public:
+    explicit BatchReplacer(std::string root);
+
+    // Compute every edit into temp files; throws std::invalid_argument on a bad
+    // pattern or one that cannot safely run over some file
+    std::shared_ptr<ReplacePlan> prepare(const std::string& pattern, const std::string& replacement,
+                                         const ReplaceOptions& options = {}) const;
+
+    // Restore the originals of a committed transaction; returns files restored.
+    // Throws std::runtime_error, restoring nothing, if a file changed after the
+    // commit unless force is set
+    static size_t undo(const std::string& root, const std::string& transaction_id, bool force = false);
+
+    // Roll back transactions interrupted mid-commit; returns their ids. Commits
+    // still running in other processes hold the journal lock and are waited out
+    static std::vector<std::string> recover(const std::string& root);
+
+private:
+    std::string root_;
+};
+
+} // namespace isaac
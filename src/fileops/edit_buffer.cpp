@@ -0,0 +1,559 @@
+#include "edit_buffer.hpp"
+#include "core/file_io.hpp"
+#include "core/utf8.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::vector<size_t> newline_positions(std::string_view text, size_t base = 0) {
+    std::vector<size_t> positions;
+    for (size_t pos = text.find('\n'); pos != std::string_view::npos; pos = text.find('\n', pos + 1)) {
+        positions.push_back(base + pos);
+    }
+    return positions;
+}
+
+bool is_valid_utf8(std::string_view text) {
+    for (size_t pos = 0; pos < text.size();) {
+        size_t len = utf8_sequence_length(text, pos);
+        if (len == 0) return false;
+        pos += len;
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// EditBuffer
+// ============================================================================
+
+EditBuffer::EditBuffer(std::string path) : path_(std::move(path)) {}
+
+std::shared_ptr<EditBuffer> EditBuffer::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    std::ostringstream contents;
+    contents << in.rdbuf();
+
+    std::shared_ptr<EditBuffer> buffer(new EditBuffer(path));
+    buffer->reset(contents.str());
+    buffer->record_disk_state();
+    return buffer;
+}
+
+void EditBuffer::reset(std::string contents) {
+    original_ = std::move(contents);
+    added_.clear();
+    original_newlines_ = newline_positions(original_);
+    added_newlines_.clear();
+    nodes_.clear();
+    free_nodes_.clear();
+    valid_utf8_ = is_valid_utf8(original_);
+    has_carriage_returns_ = original_.find('\r') != std::string::npos;
+    dirty_ = false;
+
+    root_ = -1;
+    if (!original_.empty()) {
+        root_ = new_node(0, 0, original_.size(), 0);
+    }
+}
+
+void EditBuffer::record_disk_state() {
+    std::error_code ec;
+    disk_size_ = fs::file_size(path_, ec);
+    auto mtime = fs::last_write_time(path_, ec);
+    disk_mtime_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count();
+}
+
+size_t EditBuffer::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return root_ < 0 ? 0 : nodes_[root_].subtree_length;
+}
+
+size_t EditBuffer::line_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (root_ < 0) return 0;
+    const Node& root = nodes_[root_];
+    // A final line without a trailing newline still counts, like readlines()
+    size_t lines = root.subtree_newlines;
+    if (root.subtree_length > 0 && (lines == 0 || nth_newline_end(lines) < root.subtree_length)) ++lines;
+    return lines;
+}
+
+size_t EditBuffer::piece_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_pieces(root_);
+}
+
+bool EditBuffer::dirty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dirty_;
+}
+
+bool EditBuffer::is_stale() const {
+    std::error_code ec;
+    auto size = fs::file_size(path_, ec);
+    if (ec) return true;
+    auto mtime = fs::last_write_time(path_, ec);
+    if (ec) return true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size != disk_size_ ||
+           std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count() != disk_mtime_ns_;
+}
+
+void EditBuffer::insert(size_t offset, std::string_view text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert_locked(offset, text);
+}
+
+void EditBuffer::erase(size_t offset, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase_locked(offset, length);
+}
+
+void EditBuffer::replace(size_t offset, size_t length, std::string_view text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase_locked(offset, length);
+    insert_locked(offset, text);
+}
+
+size_t EditBuffer::replace_all(std::string_view needle, std::string_view replacement, size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto positions = find_all_locked(needle, limit);
+    // Back to front so earlier offsets stay valid
+    for (auto it = positions.rbegin(); it != positions.rend(); ++it) {
+        erase_locked(*it, needle.size());
+        insert_locked(*it, replacement);
+    }
+    return positions.size();
+}
+
+std::string EditBuffer::text() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return text_locked();
+}
+
+std::string EditBuffer::substr(size_t offset, size_t length) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    if (root_ >= 0) {
+        size_t end = std::min(nodes_[root_].subtree_length, offset + std::min(length, SIZE_MAX - offset));
+        if (offset < end) {
+            out.reserve(end - offset);
+            collect(root_, 0, offset, end, out);
+        }
+    }
+    return out;
+}
+
+std::string EditBuffer::lines(size_t first_line, size_t last_line) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    if (root_ < 0 || first_line >= last_line) return out;
+
+    const size_t total = nodes_[root_].subtree_length;
+    const size_t newlines = nodes_[root_].subtree_newlines;
+    size_t begin = first_line == 0 ? 0 : first_line <= newlines ? nth_newline_end(first_line) : total;
+    size_t end = last_line <= newlines ? nth_newline_end(last_line) : total;
+    if (begin < end) {
+        out.reserve(end - begin);
+        collect(root_, 0, begin, end, out);
+    }
+    return out;
+}
+
+size_t EditBuffer::line_offset(size_t line) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (root_ < 0 || line == 0) return 0;
+    if (line > nodes_[root_].subtree_newlines) return nodes_[root_].subtree_length;
+    return nth_newline_end(line);
+}
+
+size_t EditBuffer::line_of(size_t offset) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t line = 0;
+    size_t base = 0;
+    int node = root_;
+    while (node >= 0) {
+        const Node& n = nodes_[node];
+        size_t left_length = n.left >= 0 ? nodes_[n.left].subtree_length : 0;
+        size_t left_newlines = n.left >= 0 ? nodes_[n.left].subtree_newlines : 0;
+        if (offset < base + left_length) {
+            node = n.left;
+        } else if (offset < base + left_length + n.length) {
+            size_t within = offset - base - left_length;
+            return line + left_newlines + count_newlines(n.source, n.start, within);
+        } else {
+            line += left_newlines + n.newlines;
+            base += left_length + n.length;
+            node = n.right;
+        }
+    }
+    return line;
+}
+
+std::vector<size_t> EditBuffer::find_all(std::string_view needle, size_t limit) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return find_all_locked(needle, limit);
+}
+
+void EditBuffer::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!dirty_) return;
+
+    std::string contents = text_locked();
+    fs::path target(path_);
+
+    std::error_code ec;
+    auto permissions = fs::status(target, ec).permissions();
+    // A unique name per flush, so processes editing the same file never share a temp file
+    fs::path temp = write_temp_file_synced(target.parent_path() / ("." + target.filename().u8string() + ".isaac-edit."),
+                                           contents);
+    if (temp.empty()) {
+        throw std::runtime_error("Cannot write a temporary file next to " + path_);
+    }
+    if (!ec) fs::permissions(temp, permissions, ec);
+
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        throw std::runtime_error("Cannot replace " + path_ + ": " + ec.message());
+    }
+    sync_directory(target.parent_path());
+
+    // Start the next round of edits from one piece over the flushed text
+    reset(std::move(contents));
+    record_disk_state();
+}
+
+int EditBuffer::new_node(uint8_t source, size_t start, size_t length, uint32_t priority) {
+    if (priority == 0) {
+        // xorshift32: treap priorities only need to be well spread
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 17;
+        rng_state_ ^= rng_state_ << 5;
+        priority = rng_state_ | 1;
+    }
+
+    int index;
+    if (!free_nodes_.empty()) {
+        index = free_nodes_.back();
+        free_nodes_.pop_back();
+    } else {
+        index = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& node = nodes_[index];
+    node = Node{};
+    node.source = source;
+    node.start = start;
+    node.length = length;
+    node.newlines = count_newlines(source, start, length);
+    node.priority = priority;
+    update(index);
+    return index;
+}
+
+void EditBuffer::free_subtree(int node) {
+    if (node < 0) return;
+    free_subtree(nodes_[node].left);
+    free_subtree(nodes_[node].right);
+    free_nodes_.push_back(node);
+}
+
+void EditBuffer::update(int node) {
+    Node& n = nodes_[node];
+    n.subtree_length = n.length;
+    n.subtree_newlines = n.newlines;
+    if (n.left >= 0) {
+        n.subtree_length += nodes_[n.left].subtree_length;
+        n.subtree_newlines += nodes_[n.left].subtree_newlines;
+    }
+    if (n.right >= 0) {
+        n.subtree_length += nodes_[n.right].subtree_length;
+        n.subtree_newlines += nodes_[n.right].subtree_newlines;
+    }
+}
+
+size_t EditBuffer::count_newlines(uint8_t source, size_t start, size_t length) const {
+    const auto& positions = source == 0 ? original_newlines_ : added_newlines_;
+    auto first = std::lower_bound(positions.begin(), positions.end(), start);
+    auto last = std::lower_bound(first, positions.end(), start + length);
+    return static_cast<size_t>(last - first);
+}
+
+std::pair<int, int> EditBuffer::split(int node, size_t offset) {
+    if (node < 0) return {-1, -1};
+
+    size_t left_length = nodes_[node].left >= 0 ? nodes_[nodes_[node].left].subtree_length : 0;
+    if (offset <= left_length) {
+        auto [a, b] = split(nodes_[node].left, offset);
+        nodes_[node].left = b;
+        update(node);
+        return {a, node};
+    }
+    if (offset >= left_length + nodes_[node].length) {
+        auto [a, b] = split(nodes_[node].right, offset - left_length - nodes_[node].length);
+        nodes_[node].right = a;
+        update(node);
+        return {node, b};
+    }
+
+    // Offset falls inside this piece: cut it in two, the tail inherits the right subtree
+    size_t cut = offset - left_length;
+    const Node piece = nodes_[node];
+    int tail = new_node(piece.source, piece.start + cut, piece.length - cut, piece.priority);
+    nodes_[tail].right = piece.right;
+    update(tail);
+
+    Node& head = nodes_[node];
+    head.length = cut;
+    head.newlines = count_newlines(head.source, head.start, cut);
+    head.right = -1;
+    update(node);
+    return {node, tail};
+}
+
+int EditBuffer::merge(int left, int right) {
+    if (left < 0) return right;
+    if (right < 0) return left;
+    if (nodes_[left].priority > nodes_[right].priority) {
+        nodes_[left].right = merge(nodes_[left].right, right);
+        update(left);
+        return left;
+    }
+    nodes_[right].left = merge(left, nodes_[right].left);
+    update(right);
+    return right;
+}
+
+void EditBuffer::collect(int node, size_t base, size_t begin, size_t end, std::string& out) const {
+    if (node < 0 || begin >= end) return;
+    const Node& n = nodes_[node];
+    if (base >= end || base + n.subtree_length <= begin) return;
+
+    size_t left_length = n.left >= 0 ? nodes_[n.left].subtree_length : 0;
+    collect(n.left, base, begin, end, out);
+
+    size_t piece_begin = base + left_length;
+    size_t from = std::max(begin, piece_begin);
+    size_t to = std::min(end, piece_begin + n.length);
+    if (from < to) {
+        const std::string& source = n.source == 0 ? original_ : added_;
+        out.append(source, n.start + (from - piece_begin), to - from);
+    }
+
+    collect(n.right, piece_begin + n.length, begin, end, out);
+}
+
+// Offset just past the n-th (1-based) newline; caller guarantees it exists
+size_t EditBuffer::nth_newline_end(size_t n) const {
+    size_t base = 0;
+    int node = root_;
+    while (node >= 0) {
+        const Node& current = nodes_[node];
+        size_t left_length = current.left >= 0 ? nodes_[current.left].subtree_length : 0;
+        size_t left_newlines = current.left >= 0 ? nodes_[current.left].subtree_newlines : 0;
+        if (n <= left_newlines) {
+            node = current.left;
+        } else if (n <= left_newlines + current.newlines) {
+            const auto& positions = current.source == 0 ? original_newlines_ : added_newlines_;
+            auto first = std::lower_bound(positions.begin(), positions.end(), current.start);
+            size_t position = *(first + static_cast<long>(n - left_newlines - 1));
+            return base + left_length + (position - current.start) + 1;
+        } else {
+            n -= left_newlines + current.newlines;
+            base += left_length + current.length;
+            node = current.right;
+        }
+    }
+    return base;
+}
+
+size_t EditBuffer::count_pieces(int node) const {
+    if (node < 0) return 0;
+    return 1 + count_pieces(nodes_[node].left) + count_pieces(nodes_[node].right);
+}
+
+void EditBuffer::insert_locked(size_t offset, std::string_view text) {
+    if (text.empty()) return;
+    size_t total = root_ < 0 ? 0 : nodes_[root_].subtree_length;
+    offset = std::min(offset, total);
+
+    size_t start = added_.size();
+    added_.append(text.data(), text.size());
+    for (size_t pos = text.find('\n'); pos != std::string_view::npos; pos = text.find('\n', pos + 1)) {
+        added_newlines_.push_back(start + pos);
+    }
+    if (text.find('\r') != std::string_view::npos) has_carriage_returns_ = true;
+
+    int piece = new_node(1, start, text.size(), 0);
+    auto [left, right] = split(root_, offset);
+    root_ = merge(merge(left, piece), right);
+    dirty_ = true;
+}
+
+void EditBuffer::erase_locked(size_t offset, size_t length) {
+    size_t total = root_ < 0 ? 0 : nodes_[root_].subtree_length;
+    if (length == 0 || offset >= total) return;
+    length = std::min(length, total - offset);
+
+    auto [left, rest] = split(root_, offset);
+    auto [removed, right] = split(rest, length);
+    free_subtree(removed);
+    root_ = merge(left, right);
+    dirty_ = true;
+}
+
+std::string EditBuffer::text_locked() const {
+    std::string out;
+    if (root_ >= 0) {
+        out.reserve(nodes_[root_].subtree_length);
+        collect(root_, 0, 0, nodes_[root_].subtree_length, out);
+    }
+    return out;
+}
+
+std::vector<size_t> EditBuffer::find_all_locked(std::string_view needle, size_t limit) const {
+    std::vector<size_t> positions;
+    if (needle.empty()) return positions;
+
+    std::vector<std::string_view> pieces;
+    collect_pieces(root_, pieces);
+
+    // Search each piece where it lives; a match may also straddle pieces, so
+    // the last needle.size() - 1 bytes before a piece are kept as a seam and
+    // searched together with the piece's head
+    const size_t keep = needle.size() - 1;
+    std::string seam;
+    std::string window;
+    size_t offset = 0;  // of the current piece
+    size_t next = 0;    // earliest start of the next match (non-overlapping)
+    for (std::string_view piece : pieces) {
+        if (!seam.empty()) {
+            const size_t window_base = offset - seam.size();
+            window.assign(seam);
+            window.append(piece.substr(0, keep));
+            for (size_t pos = window.find(needle, std::max(next, window_base) - window_base);
+                 pos != std::string::npos && pos < seam.size(); pos = window.find(needle, pos + needle.size())) {
+                positions.push_back(window_base + pos);
+                next = window_base + pos + needle.size();
+                if (limit && positions.size() >= limit) return positions;
+            }
+        }
+        for (size_t pos = piece.find(needle, next > offset ? next - offset : 0); pos != std::string_view::npos;
+             pos = piece.find(needle, pos + needle.size())) {
+            positions.push_back(offset + pos);
+            next = offset + pos + needle.size();
+            if (limit && positions.size() >= limit) return positions;
+        }
+
+        if (piece.size() >= keep) {
+            seam.assign(piece.substr(piece.size() - keep));
+        } else {
+            seam.append(piece);
+            if (seam.size() > keep) seam.erase(0, seam.size() - keep);
+        }
+        offset += piece.size();
+    }
+    return positions;
+}
+
+void EditBuffer::collect_pieces(int node, std::vector<std::string_view>& out) const {
+    if (node < 0) return;
+    const Node& n = nodes_[node];
+    collect_pieces(n.left, out);
+    if (n.length) out.emplace_back((n.source == 0 ? original_ : added_).data() + n.start, n.length);
+    collect_pieces(n.right, out);
+}
+
+// ============================================================================
+// EditBufferCache
+// ============================================================================
+
+EditBufferCache::EditBufferCache(size_t max_buffers) : max_buffers_(std::max<size_t>(1, max_buffers)) {}
+
+std::shared_ptr<EditBuffer> EditBufferCache::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(path);
+    if (it != index_.end()) {
+        auto entry = it->second;
+        // Unflushed edits win over an external change; a clean stale buffer is reloaded
+        if (entry->second->dirty() || !entry->second->is_stale()) {
+            lru_.splice(lru_.begin(), lru_, entry);
+            return entry->second;
+        }
+        lru_.erase(entry);
+        index_.erase(it);
+    }
+
+    auto buffer = EditBuffer::load(path);
+    lru_.emplace_front(path, buffer);
+    index_[path] = lru_.begin();
+
+    while (lru_.size() > max_buffers_) {
+        auto& oldest = lru_.back();
+        if (oldest.second->dirty()) oldest.second->flush();
+        index_.erase(oldest.first);
+        lru_.pop_back();
+    }
+    return buffer;
+}
+
+void EditBufferCache::evict(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(path);
+    if (it != index_.end()) {
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+}
+
+void EditBufferCache::flush_all() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // One failed file must not hold back the others; it is dropped, like a
+    // failed flush on eviction, and reported once all were tried
+    std::string errors;
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        try {
+            it->second->flush();
+            ++it;
+        } catch (const std::runtime_error& e) {
+            if (!errors.empty()) errors += "; ";
+            errors += e.what();
+            index_.erase(it->first);
+            it = lru_.erase(it);
+        }
+    }
+    if (!errors.empty()) {
+        throw std::runtime_error(errors);
+    }
+}
+
+void EditBufferCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+}
+
+size_t EditBufferCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+} // namespace isaac
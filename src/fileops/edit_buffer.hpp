@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+/**
+ * In-memory edit buffer for one file: a piece table whose pieces live in a
+ * treap keyed by byte offset. Each node caches the byte length and newline
+ * count of its subtree, so insert/erase and line <-> offset lookups are
+ * O(log pieces), and newline counts inside a piece come from per-buffer
+ * newline indexes rather than rescanning text.
+ *
+ * Offsets are byte offsets into the UTF-8 contents; lines are 0-based.
+ */
+class EditBuffer {
+public:
+    // Throws std::runtime_error if the file cannot be read
+    static std::shared_ptr<EditBuffer> load(const std::string& path);
+
+    EditBuffer(const EditBuffer&) = delete;
+    EditBuffer& operator=(const EditBuffer&) = delete;
+
+    const std::string& path() const { return path_; }
+    size_t size() const;
+    size_t line_count() const;
+    size_t piece_count() const;
+    bool valid_utf8() const { return valid_utf8_; }
+    bool has_carriage_returns() const { return has_carriage_returns_; }
+    bool dirty() const;
+
+    // True if the file on disk changed since it was loaded or last flushed
+    bool is_stale() const;
+
+    void insert(size_t offset, std::string_view text);
+    void erase(size_t offset, size_t length);
+    void replace(size_t offset, size_t length, std::string_view text);
+
+    // Replace non-overlapping occurrences (all when limit == 0); returns the count
+    size_t replace_all(std::string_view needle, std::string_view replacement, size_t limit = 0);
+
+    std::string text() const;
+    std::string substr(size_t offset, size_t length) const;
+    // Text of lines [first_line, last_line), including their newlines
+    std::string lines(size_t first_line, size_t last_line) const;
+    size_t line_offset(size_t line) const;
+    size_t line_of(size_t offset) const;
+
+    // Offsets of non-overlapping occurrences (all when limit == 0), searched
+    // piece by piece without assembling the text
+    std::vector<size_t> find_all(std::string_view needle, size_t limit = 0) const;
+
+    // Atomically write the contents back (unique temp file + rename); throws std::runtime_error
+    void flush();
+
+private:
+    struct Node {
+        uint8_t source = 0;     // 0 = original, 1 = add buffer
+        size_t start = 0;
+        size_t length = 0;
+        size_t newlines = 0;
+        uint32_t priority = 0;
+        int left = -1;
+        int right = -1;
+        size_t subtree_length = 0;
+        size_t subtree_newlines = 0;
+    };
+
+    explicit EditBuffer(std::string path);
+
+    void reset(std::string contents);
+    void record_disk_state();
+
+    int new_node(uint8_t source, size_t start, size_t length, uint32_t priority);
+    void free_subtree(int node);
+    void update(int node);
+    size_t count_newlines(uint8_t source, size_t start, size_t length) const;
+    std::pair<int, int> split(int node, size_t offset);
+    int merge(int left, int right);
+    void collect(int node, size_t base, size_t begin, size_t end, std::string& out) const;
+    void collect_pieces(int node, std::vector<std::string_view>& out) const;
+    size_t nth_newline_end(size_t n) const;
+    size_t count_pieces(int node) const;
+
+    void insert_locked(size_t offset, std::string_view text);
+    void erase_locked(size_t offset, size_t length);
+    std::string text_locked() const;
+    std::vector<size_t> find_all_locked(std::string_view needle, size_t limit) const;
+
+    std::string path_;
+    std::string original_;
+    std::string added_;
+    std::vector<size_t> original_newlines_;
+    std::vector<size_t> added_newlines_;
+
+    std::vector<Node> nodes_;
+    std::vector<int> free_nodes_;
+    int root_ = -1;
+    uint32_t rng_state_ = 0x9e3779b9u;
+
+    bool valid_utf8_ = true;
+    bool has_carriage_returns_ = false;
+    bool dirty_ = false;
+    uint64_t disk_size_ = 0;
+    int64_t disk_mtime_ns_ = 0;
+    mutable std::mutex mutex_;
+};
+
+/**
+ * LRU cache of edit buffers shared by the file tools, so repeated reads and
+ * edits of the same file reuse its piece table. Stale clean buffers are
+ * reloaded transparently. Edits stay in memory until flush_all() (the tools
+ * call it at the end of a turn) or until their buffer is evicted.
+ */
+class EditBufferCache {
+public:
+    explicit EditBufferCache(size_t max_buffers = 64);
+
+    std::shared_ptr<EditBuffer> open(const std::string& path);
+    void evict(const std::string& path);
+    // Flushes every buffer; failed ones are dropped and reported together (std::runtime_error)
+    void flush_all();
+    void clear();
+    size_t size() const;
+
+private:
+    using LruList = std::list<std::pair<std::string, std::shared_ptr<EditBuffer>>>;
+
+    size_t max_buffers_;
+    LruList lru_;
+    std::unordered_map<std::string, LruList::iterator> index_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace isaac
@@ -0,0 +1,419 @@
+#include "file_search.hpp"
+#include "core/mapped_file.hpp"
+#include "core/utf8.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace {
+
+constexpr size_t kBinaryProbeBytes = 8192;
+constexpr size_t kContextBytes = 50;
+
+// std::regex matches by recursion, one frame chain per character a repeat
+// consumes, so the stack spent per character grows with the repeated atom.
+// Measured at under 128 bytes per atom byte (plus ~4 bytes of fixed cost)
+// with libstdc++; the budget is half the smallest default thread stack
+// (512 KiB on macOS)
+constexpr size_t kRegexStackBudget = 256 * 1024;
+constexpr size_t kRegexFrameBytes = 128;
+
+// Bytes ordered from most to least common in source code; unlisted bytes are rarest
+constexpr std::string_view kByteFrequency =
+    " etaoinsrlcdhmpu_f.gy()b,=w\"'v:kxTESARINOCL;-/>0D1P#F<M2[]{}q*jz$\nU\t";
+
+int byte_rank(uint8_t c) {
+    size_t pos = kByteFrequency.find(static_cast<char>(c));
+    return pos == std::string_view::npos ? 256 : static_cast<int>(pos);
+}
+
+// Index just past the character class starting at pattern[i] == '['
+size_t skip_class(const std::string& pattern, size_t i) {
+    ++i;
+    if (i < pattern.size() && pattern[i] == '^') ++i;
+    if (i < pattern.size() && pattern[i] == ']') ++i;  // leading ']' is literal
+    for (; i < pattern.size(); ++i) {
+        if (pattern[i] == '\\') ++i;
+        else if (pattern[i] == ']') return i + 1;
+    }
+    return pattern.size();
+}
+
+// Index just past the group starting at pattern[i] == '('
+size_t skip_group(const std::string& pattern, size_t i) {
+    int depth = 0;
+    while (i < pattern.size()) {
+        char c = pattern[i];
+        if (c == '\\') {
+            i += 2;
+        } else if (c == '[') {
+            i = skip_class(pattern, i);
+        } else {
+            if (c == '(') ++depth;
+            if (c == ')' && --depth == 0) return i + 1;
+            ++i;
+        }
+    }
+    return pattern.size();
+}
+
+// End of the argument of an escape whose letter is at pos - 1
+size_t skip_escape_argument(const std::string& pattern, size_t pos, char letter) {
+    auto skip = [&](size_t max, auto accept) {
+        for (size_t n = 0; n < max && pos < pattern.size() &&
+                           accept(static_cast<unsigned char>(pattern[pos]));
+             ++n) {
+            ++pos;
+        }
+        return pos;
+    };
+    auto hex = [](unsigned char c) { return std::isxdigit(c) != 0; };
+    auto digit = [](unsigned char c) { return std::isdigit(c) != 0; };
+
+    switch (letter) {
+        case 'x': return skip(2, hex);
+        case 'u': return skip(4, hex);
+        case 'U': return skip(8, hex);
+        case 'c': return pos < pattern.size() ? pos + 1 : pos;
+        case 'N':
+            if (pos < pattern.size() && pattern[pos] == '{') {
+                size_t close = pattern.find('}', pos);
+                return close == std::string::npos ? pattern.size() : close + 1;
+            }
+            return pos;
+        default:
+            // Octal escapes and backreferences: \0, \12, \101
+            if (std::isdigit(static_cast<unsigned char>(letter))) return skip(2, digit);
+            return pos;
+    }
+}
+
+} // namespace
+
+struct FileSearcher::Matcher {
+    std::regex regex;
+    std::string literal;
+    uint8_t rare_byte = 0;
+    size_t rare_offset = 0;
+    size_t max_line = SIZE_MAX;
+};
+
+// ============================================================================
+// SearchStream
+// ============================================================================
+
+SearchStream::~SearchStream() {
+    cancel();
+    if (producer_.joinable()) {
+        producer_.join();
+    }
+}
+
+std::vector<FileMatches> SearchStream::next_batch(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, std::chrono::milliseconds(std::max(0, timeout_ms)),
+                 [this] { return !ready_.empty() || done_; });
+
+    std::vector<FileMatches> batch(std::make_move_iterator(ready_.begin()),
+                                   std::make_move_iterator(ready_.end()));
+    ready_.clear();
+    return batch;
+}
+
+bool SearchStream::finished() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_ && ready_.empty();
+}
+
+void SearchStream::cancel() {
+    cancelled_.store(true);
+}
+
+void SearchStream::push(FileMatches matches) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(std::move(matches));
+    }
+    cv_.notify_one();
+}
+
+void SearchStream::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    cv_.notify_all();
+}
+
+// ============================================================================
+// FileSearcher
+// ============================================================================
+
+FileSearcher::FileSearcher(std::string root) : root_(std::move(root)) {}
+
+std::string FileSearcher::required_literal(const std::string& pattern) {
+    std::string best;
+    std::string current;
+    auto flush = [&] {
+        if (current.size() > best.size()) best = current;
+        current.clear();
+    };
+
+    for (size_t i = 0; i < pattern.size();) {
+        char c = pattern[i];
+        switch (c) {
+            case '\\': {
+                if (i + 1 >= pattern.size()) return "";
+                char next = pattern[i + 1];
+                i += 2;
+                if (!std::isalnum(static_cast<unsigned char>(next))) {
+                    current += next;
+                    break;
+                }
+                // \w, \d, \b, \n ... are classes, assertions or encoded
+                // characters, not literals; skip their arguments too so
+                // "\x41BC" does not leave "41BC" as required text
+                flush();
+                i = skip_escape_argument(pattern, i, next);
+                break;
+            }
+            case '[':
+                flush();
+                i = skip_class(pattern, i);
+                break;
+            case '(':
+                flush();
+                i = skip_group(pattern, i);
+                break;
+            case '|':
+                return ""; // top-level alternation: no single required literal
+            case '*':
+            case '?':
+            case '{':
+                // Previous atom is optional
+                if (!current.empty()) current.pop_back();
+                flush();
+                if (c == '{') {
+                    size_t close = pattern.find('}', i);
+                    i = close == std::string::npos ? pattern.size() : close + 1;
+                } else {
+                    ++i;
+                }
+                break;
+            case '+':
+            case '.':
+            case '^':
+            case '$':
+                flush();
+                ++i;
+                break;
+            default:
+                current += c;
+                ++i;
+                break;
+        }
+    }
+    flush();
+    return best;
+}
+
+size_t FileSearcher::max_regex_subject(const std::string& pattern) {
+    size_t widest = 0;              // longest atom under a repeat
+    bool repeats = false;
+    std::vector<size_t> groups;     // open '(' positions
+    size_t atom = 0;                // start of the last atom
+    for (size_t i = 0; i < pattern.size();) {
+        char c = pattern[i];
+        if (c == '\\') {
+            atom = i;
+            i += 2;
+        } else if (c == '[') {
+            atom = i;
+            i = skip_class(pattern, i);
+        } else if (c == '(') {
+            groups.push_back(i++);
+        } else if (c == ')') {
+            atom = groups.empty() ? i : groups.back();
+            if (!groups.empty()) groups.pop_back();
+            ++i;
+        } else if (c == '*' || c == '+' || c == '{') {
+            // Bounded {n,m} counts too: m can be as large as any line
+            repeats = true;
+            widest = std::max(widest, i - std::min(atom, i));
+            ++i;
+        } else {
+            atom = i++;
+        }
+    }
+    if (!repeats) {
+        return SIZE_MAX;            // recursion is bounded by the pattern itself
+    }
+    return kRegexStackBudget / (kRegexFrameBytes * (widest + 4));
+}
+
+std::shared_ptr<const FileSearcher::Matcher> FileSearcher::compile(const std::string& pattern,
+                                                                   const SearchOptions& options) {
+    auto matcher = std::make_shared<Matcher>();
+    try {
+        auto flags = std::regex::ECMAScript | std::regex::optimize;
+        if (options.ignore_case) flags |= std::regex::icase;
+        matcher->regex = std::regex(pattern, flags);
+    } catch (const std::regex_error& e) {
+        throw std::invalid_argument("Unsupported search pattern '" + pattern + "': " + e.what());
+    }
+    matcher->max_line = max_regex_subject(pattern);
+
+    if (!options.ignore_case) {
+        matcher->literal = required_literal(pattern);
+        int rarest = -1;
+        for (size_t i = 0; i < matcher->literal.size(); ++i) {
+            int rank = byte_rank(static_cast<uint8_t>(matcher->literal[i]));
+            if (rank > rarest) {
+                rarest = rank;
+                matcher->rare_byte = static_cast<uint8_t>(matcher->literal[i]);
+                matcher->rare_offset = i;
+            }
+        }
+    }
+    return matcher;
+}
+
+void FileSearcher::run(const Matcher& matcher, const SearchOptions& options,
+                       SearchStream& stream) const {
+    WalkOptions walk_options;
+    walk_options.include_globs = options.include_globs;
+    walk_options.use_ignore_files = options.use_ignore_files;
+    walk_options.threads = options.threads;
+    FileWalker walker(root_, walk_options);
+
+    walker.walk([&](const std::string& rel_path, const std::filesystem::path& path) {
+        MappedFile file;
+        if (!file.open(path.string()) || file.size() == 0) return;
+
+        const std::string_view text = file.view();
+        stream.files_scanned_.fetch_add(1, std::memory_order_relaxed);
+        stream.bytes_scanned_.fetch_add(text.size(), std::memory_order_relaxed);
+
+        if (std::memchr(text.data(), '\0', std::min(text.size(), kBinaryProbeBytes)) != nullptr) {
+            return; // binary
+        }
+
+        FileMatches result;
+        result.path = rel_path;
+
+        size_t counted_to = 0;
+        int line_number = 1;
+        const char* base = text.data();
+        const std::string& literal = matcher.literal;
+
+        auto scan_line = [&](size_t line_start, size_t line_end) {
+            line_number += static_cast<int>(std::count(base + counted_to, base + line_start, '\n'));
+            counted_to = line_start;
+
+            if (line_end - line_start > matcher.max_line) {
+                result.long_lines = true;
+                return false;
+            }
+
+            std::cmatch m;
+            const char* begin = base + line_start;
+            const char* end = base + line_end;
+            const char* cursor = begin;
+            auto flags = std::regex_constants::match_default;
+            while (cursor <= end && std::regex_search(cursor, end, m, matcher.regex, flags)) {
+                size_t match_start = static_cast<size_t>(m[0].first - base);
+                size_t match_end = static_cast<size_t>(m[0].second - base);
+                size_t ctx_start = utf8_floor(text, match_start > kContextBytes ? match_start - kContextBytes : 0);
+                size_t ctx_end = utf8_floor(text, std::min(text.size(), match_end + kContextBytes));
+
+                result.matches.push_back(LineMatch{
+                    line_number, static_cast<int>(match_start - line_start),
+                    to_valid_utf8(text.substr(match_start, match_end - match_start)),
+                    to_valid_utf8(text.substr(ctx_start, ctx_end - ctx_start))});
+                if (options.max_matches_per_file && result.matches.size() >= options.max_matches_per_file) {
+                    return false;
+                }
+
+                // Empty matches must still advance
+                cursor = m[0].second == m[0].first ? m[0].second + 1 : m[0].second;
+                flags = std::regex_constants::match_prev_avail;
+            }
+            return true;
+        };
+
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t line_start = pos;
+            if (!literal.empty()) {
+                // Prefilter: memchr the rarest literal byte, confirm the whole literal
+                const char* hit = nullptr;
+                size_t probe = pos + matcher.rare_offset;
+                while (probe < text.size()) {
+                    const void* found = std::memchr(base + probe, matcher.rare_byte, text.size() - probe);
+                    if (!found) break;
+                    size_t at = static_cast<const char*>(found) - base;
+                    size_t lit_start = at - matcher.rare_offset;
+                    if (lit_start + literal.size() <= text.size() &&
+                        std::memcmp(base + lit_start, literal.data(), literal.size()) == 0) {
+                        hit = base + lit_start;
+                        break;
+                    }
+                    probe = at + 1;
+                }
+                if (!hit) break;
+
+                size_t hit_pos = static_cast<size_t>(hit - base);
+                size_t newline = text.rfind('\n', hit_pos);
+                line_start = newline == std::string_view::npos || newline < pos ? pos : newline + 1;
+            }
+
+            size_t line_end = text.find('\n', line_start);
+            if (line_end == std::string_view::npos) line_end = text.size();
+
+            if (!scan_line(line_start, line_end)) break;
+            pos = line_end + 1;
+        }
+
+        if (result.long_lines) {
+            result.matches.clear();     // the caller rescans the whole file
+        }
+        if (!result.matches.empty() || result.long_lines) {
+            stream.push(std::move(result));
+        }
+    }, &stream.cancelled_);
+}
+
+std::vector<FileMatches> FileSearcher::search(const std::string& pattern,
+                                              const SearchOptions& options) const {
+    auto matcher = compile(pattern, options);
+
+    SearchStream stream;
+    run(*matcher, options, stream);
+
+    std::vector<FileMatches> results(std::make_move_iterator(stream.ready_.begin()),
+                                     std::make_move_iterator(stream.ready_.end()));
+    std::sort(results.begin(), results.end(),
+              [](const FileMatches& a, const FileMatches& b) { return a.path < b.path; });
+    return results;
+}
+
+std::shared_ptr<SearchStream> FileSearcher::search_stream(const std::string& pattern,
+                                                          const SearchOptions& options) const {
+    // Compile up front so pattern errors surface to the caller, not the worker
+    auto matcher = compile(pattern, options);
+
+    auto stream = std::make_shared<SearchStream>();
+    SearchStream* raw = stream.get();
+    // The stream owns its producer thread and joins it on destruction
+    stream->producer_ = std::thread([this_copy = *this, matcher, options, raw] {
+        this_copy.run(*matcher, options, *raw);
+        raw->finish();
+    });
+    return stream;
+}
+
+} // namespace isaac
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "file_walker.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace isaac {
+
+struct LineMatch {
+    int line = 0;           // 1-based
+    int column = 0;         // 0-based byte offset within the line
+    std::string match;
+    std::string context;    // up to 50 bytes either side, like batch_search
+};
+
+struct FileMatches {
+    std::string path;       // relative to the search root, '/'-separated
+    std::vector<LineMatch> matches;
+    bool long_lines = false;  // a candidate line was too long to match natively; matches is empty
+};
+
+struct SearchOptions {
+    std::vector<std::string> include_globs;
+    bool ignore_case = false;
+    bool use_ignore_files = true;
+    size_t max_matches_per_file = 0;  // 0 = unlimited
+    unsigned threads = 0;
+};
+
+/**
+ * Incremental results of a running search. Workers push per-file results as
+ * they finish; next_batch() hands over whatever has arrived so far.
+ */
+class SearchStream {
+public:
+    ~SearchStream();
+
+    // Wait up to timeout_ms for results; an empty batch with finished() means done
+    std::vector<FileMatches> next_batch(int timeout_ms = 100);
+    bool finished() const;
+    void cancel();
+
+    size_t files_scanned() const { return files_scanned_.load(); }
+    size_t bytes_scanned() const { return bytes_scanned_.load(); }
+
+private:
+    friend class FileSearcher;
+
+    void push(FileMatches matches);
+    void finish();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<FileMatches> ready_;
+    bool done_ = false;
+    std::atomic<bool> cancelled_{false};
+    std::atomic<size_t> files_scanned_{0};
+    std::atomic<size_t> bytes_scanned_{0};
+    std::thread producer_;
+};
+
+/**
+ * Parallel regex search over a project tree.
+ *
+ * Files are mmap'd, binary files (NUL in the first 8 KiB) are skipped, and a
+ * literal every match must contain is located with memchr on its rarest byte
+ * before the regex runs on the surrounding line. Matching is line-oriented
+ * (like grep): a match never spans a newline. std::regex recurses per
+ * character, so a file with a candidate line longer than
+ * max_regex_subject() is reported with long_lines set and no matches.
+ */
+class FileSearcher {
+public:
+    explicit FileSearcher(std::string root);
+
+    // Blocking search, results sorted by path
+    std::vector<FileMatches> search(const std::string& pattern, const SearchOptions& options) const;
+
+    // Background search streaming results as files complete
+    std::shared_ptr<SearchStream> search_stream(const std::string& pattern,
+                                                const SearchOptions& options) const;
+
+    // Longest literal substring every match of the regex must contain ("" if none)
+    static std::string required_literal(const std::string& pattern);
+
+    // Longest text std::regex can run the pattern over without risking a stack
+    // overflow (SIZE_MAX when nothing in it repeats)
+    static size_t max_regex_subject(const std::string& pattern);
+
+private:
+    struct Matcher;
+
+    static std::shared_ptr<const Matcher> compile(const std::string& pattern, const SearchOptions& options);
+    void run(const Matcher& matcher, const SearchOptions& options, SearchStream& stream) const;
+
+    std::string root_;
+};
+
+} // namespace isaac
@@ -0,0 +1,274 @@
+#include "file_walker.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Same defaults as IsaacIgnore in isaac/ai/collections_core.py
+const char* const kDefaultIgnores[] = {
+    ".git/", "__pycache__/", "*.pyc", ".pytest_cache/", "node_modules/", "venv/", ".venv/",
+    "env/", ".env/", ".tox/", ".mypy_cache/", ".ruff_cache/", "*.egg-info/", "dist/", "build/",
+    ".DS_Store", "Thumbs.db", ".isaac/", "*.log", "*.tmp",
+};
+
+bool match_class(std::string_view& pattern, char c) {
+    // pattern starts just after '['
+    size_t i = 0;
+    bool negate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+    if (negate) ++i;
+    bool matched = false;
+    bool first = true;
+    while (i < pattern.size() && (first || pattern[i] != ']')) {
+        first = false;
+        char lo = pattern[i];
+        if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+            char hi = pattern[i + 2];
+            if (c >= lo && c <= hi) matched = true;
+            i += 3;
+        } else {
+            if (c == lo) matched = true;
+            ++i;
+        }
+    }
+    pattern.remove_prefix(i < pattern.size() ? i + 1 : i);
+    return matched != negate;
+}
+
+std::string_view base_name(std::string_view path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+} // namespace
+
+bool glob_match(std::string_view pattern, std::string_view path) {
+    while (!pattern.empty()) {
+        if (pattern.substr(0, 2) == "**") {
+            std::string_view rest = pattern.substr(2);
+            if (!rest.empty() && rest[0] == '/') {
+                // "**/" matches zero or more whole directories
+                rest.remove_prefix(1);
+                for (size_t i = 0; i <= path.size(); ++i) {
+                    if ((i == 0 || path[i - 1] == '/') && glob_match(rest, path.substr(i))) return true;
+                }
+                return false;
+            }
+            for (size_t i = 0; i <= path.size(); ++i) {
+                if (glob_match(rest, path.substr(i))) return true;
+            }
+            return false;
+        }
+
+        char p = pattern[0];
+        if (p == '*') {
+            std::string_view rest = pattern.substr(1);
+            for (size_t i = 0; i <= path.size(); ++i) {
+                if (glob_match(rest, path.substr(i))) return true;
+                if (i < path.size() && path[i] == '/') break;
+            }
+            return false;
+        }
+
+        if (path.empty()) return false;
+
+        if (p == '?') {
+            if (path[0] == '/') return false;
+            pattern.remove_prefix(1);
+        } else if (p == '[') {
+            pattern.remove_prefix(1);
+            if (path[0] == '/' || !match_class(pattern, path[0])) return false;
+        } else {
+            if (p == '\\' && pattern.size() > 1) {
+                pattern.remove_prefix(1);
+                p = pattern[0];
+            }
+            if (p != path[0]) return false;
+            pattern.remove_prefix(1);
+        }
+        path.remove_prefix(1);
+    }
+    return path.empty();
+}
+
+IgnoreRules::IgnoreRules() {
+    for (const char* pattern : kDefaultIgnores) {
+        add_pattern(pattern);
+    }
+}
+
+void IgnoreRules::add_pattern(std::string_view pattern) {
+    while (!pattern.empty() && (pattern.back() == ' ' || pattern.back() == '\r' || pattern.back() == '\t')) {
+        pattern.remove_suffix(1);
+    }
+    if (pattern.empty() || pattern[0] == '#') {
+        return;
+    }
+
+    Rule rule;
+    if (pattern[0] == '!') {
+        rule.negate = true;
+        pattern.remove_prefix(1);
+    }
+    if (!pattern.empty() && pattern.back() == '/') {
+        rule.dir_only = true;
+        pattern.remove_suffix(1);
+    }
+    if (!pattern.empty() && pattern[0] == '/') {
+        rule.anchored = true;
+        pattern.remove_prefix(1);
+    }
+    if (pattern.find('/') != std::string_view::npos) {
+        rule.anchored = true;
+    }
+    if (pattern.empty()) {
+        return;
+    }
+
+    rule.glob = std::string(pattern);
+    rules_.push_back(std::move(rule));
+}
+
+bool IgnoreRules::load_file(const fs::path& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        add_pattern(line);
+    }
+    return true;
+}
+
+bool IgnoreRules::is_ignored(std::string_view rel_path, bool is_dir) const {
+    bool ignored = false;
+    std::string_view name = base_name(rel_path);
+    for (const Rule& rule : rules_) {
+        if (rule.dir_only && !is_dir) continue;
+        // Unanchored rules match the entry name; parents were already checked by the walk
+        if (glob_match(rule.glob, rule.anchored ? rel_path : name)) {
+            ignored = !rule.negate;
+        }
+    }
+    return ignored;
+}
+
+FileWalker::FileWalker(fs::path root, WalkOptions options)
+    : root_(std::move(root)), options_(std::move(options)) {
+    if (options_.use_ignore_files) {
+        ignore_.load_file(root_ / ".gitignore");
+        ignore_.load_file(root_ / ".isaacignore");
+    }
+}
+
+bool FileWalker::is_included(std::string_view rel_path) const {
+    if (options_.include_globs.empty()) {
+        return true;
+    }
+    for (const auto& glob : options_.include_globs) {
+        if (glob_match(glob, rel_path)) return true;
+    }
+    return false;
+}
+
+void FileWalker::walk(const Visitor& visit, const std::atomic<bool>* cancel) const {
+    // Directories and files share one queue so a single huge directory
+    // still fans out across every worker
+    struct Item {
+        std::string rel;
+        bool is_dir;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Item> pending{Item{"", true}};
+    size_t active = 0;
+
+    auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+
+    auto list_directory = [&](const std::string& dir, std::vector<Item>& out) {
+        std::error_code ec;
+        fs::directory_iterator it(dir.empty() ? root_ : root_ / fs::u8path(dir),
+                                  fs::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != fs::directory_iterator(); it.increment(ec)) {
+            const fs::directory_entry& entry = *it;
+            std::string name = entry.path().filename().u8string();
+            if (!options_.include_hidden && !name.empty() && name[0] == '.') continue;
+
+            std::string rel = dir.empty() ? name : dir + "/" + name;
+            // Never follow directory symlinks: avoids cycles and escaping the root
+            std::error_code status_ec;
+            fs::file_status status = entry.symlink_status(status_ec);
+            if (status_ec) continue;
+
+            if (fs::is_directory(status)) {
+                if (!ignore_.is_ignored(rel, true)) out.push_back(Item{std::move(rel), true});
+            } else if (fs::is_regular_file(status)) {
+                if (ignore_.is_ignored(rel, false) || !is_included(rel)) continue;
+                auto size = entry.file_size(status_ec);
+                if (status_ec || size > options_.max_file_size) continue;
+                out.push_back(Item{std::move(rel), false});
+            }
+        }
+    };
+
+    auto worker = [&] {
+        std::vector<Item> discovered;
+        for (;;) {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return !pending.empty() || active == 0 || cancelled(); });
+                if (pending.empty() || cancelled()) {
+                    cv.notify_all();
+                    return;
+                }
+                item = std::move(pending.front());
+                pending.pop_front();
+                ++active;
+            }
+
+            discovered.clear();
+            if (item.is_dir) {
+                list_directory(item.rel, discovered);
+            } else {
+                visit(item.rel, root_ / fs::u8path(item.rel));
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto& found : discovered) {
+                    // Directories go to the front: keeps the frontier small (depth-first)
+                    if (found.is_dir) pending.push_front(std::move(found));
+                    else pending.push_back(std::move(found));
+                }
+                --active;
+                if (discovered.empty() && active > 0) continue;
+            }
+            cv.notify_all();
+        }
+    };
+
+    unsigned thread_count = options_.threads ? options_.threads : std::thread::hardware_concurrency();
+    thread_count = std::max(1u, thread_count);
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (unsigned i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace isaac
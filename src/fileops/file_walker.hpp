@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace isaac {
+
+// Glob match against a '/'-separated relative path ('*', '?', '[...]', '**/')
+bool glob_match(std::string_view pattern, std::string_view path);
+
+/**
+ * .gitignore-style rules: last matching pattern wins, '!' negates,
+ * trailing '/' restricts to directories, a leading or inner '/' anchors
+ * the pattern to the root, otherwise it matches at any depth.
+ */
+class IgnoreRules {
+public:
+    IgnoreRules();
+
+    void add_pattern(std::string_view pattern);
+    bool load_file(const std::filesystem::path& path);
+    bool is_ignored(std::string_view rel_path, bool is_dir) const;
+
+private:
+    struct Rule {
+        std::string glob;
+        bool negate = false;
+        bool dir_only = false;
+        bool anchored = false;
+    };
+
+    std::vector<Rule> rules_;
+};
+
+struct WalkOptions {
+    std::vector<std::string> include_globs;   // empty = every file
+    bool use_ignore_files = true;             // .gitignore and .isaacignore at the root
+    bool include_hidden = false;
+    size_t max_file_size = 64 * 1024 * 1024;
+    unsigned threads = 0;                     // 0 = hardware concurrency
+};
+
+/**
+ * Parallel directory walk. Worker threads share a queue of directories and
+ * invoke the visitor for each included file, so the visitor must be thread-safe.
+ */
+class FileWalker {
+public:
+    using Visitor = std::function<void(const std::string& rel_path, const std::filesystem::path& path)>;
+
+    FileWalker(std::filesystem::path root, WalkOptions options = {});
+
+    void walk(const Visitor& visit, const std::atomic<bool>* cancel = nullptr) const;
+
+    const std::filesystem::path& root() const { return root_; }
+    bool is_included(std::string_view rel_path) const;
+
+private:
+    std::filesystem::path root_;
+    WalkOptions options_;
+    IgnoreRules ignore_;
+};
+
+} // namespace isaac
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "event_log.hpp"
+#include "core/crc32.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace isaac {
+
+// On-disk layout of EventLog files, shared by the writer and EventQuery
+namespace event_format {
+
+constexpr size_t kFrameHeader = 8;      // [u32 length][u32 crc32]
+
+inline bool local_time(time_t seconds, std::tm& out) {
+#ifdef _WIN32
+    return ::localtime_s(&out, &seconds) == 0;
+#else
+    return ::localtime_r(&seconds, &out) != nullptr;
+#endif
+}
+
+// Saturates instead of overflowing for open-ended ranges
+inline int64_t to_us(double seconds) {
+    if (seconds <= -9.2e12) return INT64_MIN;
+    if (seconds >= 9.2e12) return INT64_MAX;
+    return static_cast<int64_t>(std::llround(seconds * 1e6));
+}
+
+inline double from_us(int64_t us) {
+    return static_cast<double>(us) / 1e6;
+}
+
+inline time_t floor_seconds(int64_t us) {
+    return static_cast<time_t>(us >= 0 ? us / 1000000 : -((-(us + 1)) / 1000000) - 1);
+}
+
+inline uint32_t get_u32(const uint8_t* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+// Length of the intact (checksummed) frame at offset, or false
+inline bool frame_at(const uint8_t* data, size_t size, size_t offset, uint32_t& length) {
+    if (offset > size || size - offset < kFrameHeader) return false;
+    length = get_u32(data + offset);
+    if (length > size - offset - kFrameHeader) return false;
+    return crc32(data + offset + kFrameHeader, length) == get_u32(data + offset + 4);
+}
+
+// Walk intact frames from offset; returns the end of the last one. Damaged
+// bytes (a torn write from a crashed process, possibly followed by other
+// processes' appends) are skipped up to the next intact non-empty frame, so
+// files never need truncating under a concurrent writer.
+template <typename Visit>
+size_t walk_frames(const uint8_t* data, size_t size, size_t offset, Visit&& visit) {
+    size_t end = offset;
+    uint32_t length;
+    while (offset <= size && size - offset >= kFrameHeader) {
+        if (!frame_at(data, size, offset, length)) {
+            size_t next = offset + 1;
+            while (next <= size - kFrameHeader && !(frame_at(data, size, next, length) && length > 0)) ++next;
+            if (next > size - kFrameHeader) break;
+            offset = next;
+        }
+        visit(offset, std::string_view(reinterpret_cast<const char*>(data + offset + kFrameHeader), length));
+        offset += kFrameHeader + length;
+        end = offset;
+    }
+    return end;
+}
+
+// Timestamp and type of a frame payload, without copying
+inline bool decode_head(std::string_view payload, int64_t& us, std::string_view& event_type, size_t& rest) {
+    VarintReader reader(payload);
+    uint64_t length;
+    if (!reader.signed_number(us) || !reader.number(length) || length > payload.size() - reader.position()) {
+        return false;
+    }
+    event_type = payload.substr(reader.position(), length);
+    rest = reader.position() + length;
+    return true;
+}
+
+inline bool decode_event(std::string_view payload, EventRecord& event) {
+    VarintReader reader(payload);
+    int64_t us;
+    if (!reader.signed_number(us) || !reader.string(event.event_type) || !reader.string(event.data) ||
+        !reader.string(event.metadata)) {
+        return false;
+    }
+    event.timestamp = from_us(us);
+    return true;
+}
+
+inline bool valid_collection(std::string_view name) {
+    if (name.empty() || name.front() == '.') return false;
+    for (char c : name) {
+        if (c == '/' || c == '\\' || c == '\0') return false;
+    }
+    return true;
+}
+
+// "YYYY-MM" of the local month containing us, cached across calls
+class MonthCache {
+public:
+    const std::string& name(int64_t us) {
+        if (us >= start_us_ && us < end_us_) return name_;
+        std::tm local{};
+        if (!local_time(floor_seconds(us), local)) {
+            name_ = "unknown";
+            start_us_ = end_us_ = 0;
+            return name_;
+        }
+        char text[32];      // room for any int year, so the name is never cut short
+        std::snprintf(text, sizeof(text), "%04d-%02d", local.tm_year + 1900, local.tm_mon + 1);
+        name_ = text;
+
+        std::tm first{};
+        first.tm_year = local.tm_year;
+        first.tm_mon = local.tm_mon;
+        first.tm_mday = 1;
+        first.tm_isdst = -1;
+        std::tm next = first;
+        next.tm_mon += 1;
+        start_us_ = static_cast<int64_t>(std::mktime(&first)) * 1000000;
+        end_us_ = static_cast<int64_t>(std::mktime(&next)) * 1000000;
+        return name_;
+    }
+
+private:
+    std::string name_;
+    int64_t start_us_ = 1;
+    int64_t end_us_ = 0;
+};
+
+// A collection's log files, oldest month first
+inline std::vector<std::filesystem::path> log_files(const std::filesystem::path& dir) {
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == EventLog::kExtension) files.push_back(it->path());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace event_format
+
+} // namespace isaac
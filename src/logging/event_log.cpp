@@ -0,0 +1,518 @@
+#include "event_log.hpp"
+#include "event_format.hpp"
+#include "core/crc32.hpp"
+#include "core/mapped_file.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+using namespace event_format;
+
+/**
+ * Single-producer single-consumer byte ring. Records are [u32 size][bytes]
+ * padded to 8 bytes; a record that would straddle the end leaves a wrap
+ * marker and starts over at offset 0. Positions only grow, so used space is
+ * tail - head.
+ */
+class EventLog::ThreadBuffer {
+public:
+    explicit ThreadBuffer(size_t capacity) : mask_(capacity - 1), data_(new char[capacity]) {}
+
+    // Producer: room for a record of size bytes, or nullptr when full
+    char* reserve(size_t size) {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t need = padded(size);
+        const size_t index = static_cast<size_t>(tail & mask_);
+        const size_t skip = need > capacity() - index ? capacity() - index : 0;
+        if (need + skip > capacity() - (tail - cached_head_)) {
+            // Only touch the consumer's cache line when the cached view looks full
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (need + skip > capacity() - (tail - cached_head_)) return nullptr;
+        }
+        if (skip) put_size(index, kWrap);
+        const size_t start = static_cast<size_t>((tail + skip) & mask_);
+        put_size(start, static_cast<uint32_t>(size));
+        reserved_tail_ = tail + skip + need;
+        return data_.get() + start + 4;
+    }
+
+    // Producer: publish the reserved record
+    void commit() { tail_.store(reserved_tail_, std::memory_order_release); }
+
+    // Producer: bytes not yet released by the consumer (reloads its position)
+    size_t used() {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        return static_cast<size_t>(reserved_tail_ - cached_head_);
+    }
+    // Producer: an upper bound on used(), without touching the consumer's cache line
+    size_t used_bound() const { return static_cast<size_t>(reserved_tail_ - cached_head_); }
+
+    // Consumer: views of every published record; valid until release(returned position)
+    uint64_t peek(std::vector<std::string_view>& records) const {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        while (head < tail) {
+            const size_t index = static_cast<size_t>(head & mask_);
+            uint32_t size;
+            std::memcpy(&size, data_.get() + index, 4);
+            if (size == kWrap) {
+                head += capacity() - index;
+                continue;
+            }
+            records.emplace_back(data_.get() + index + 4, size);
+            head += padded(size);
+        }
+        return tail;
+    }
+
+    void release(uint64_t position) { head_.store(position, std::memory_order_release); }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    std::atomic<bool> thread_exited{false};
+    std::atomic<bool> log_closed{false};
+
+private:
+    static constexpr uint32_t kWrap = 0xFFFFFFFFu;
+
+    static size_t padded(size_t size) { return (size + 4 + 7) & ~size_t{7}; }
+
+    void put_size(size_t index, uint32_t size) { std::memcpy(data_.get() + index, &size, 4); }
+
+    const size_t mask_;
+    std::unique_ptr<char[]> data_;
+    uint64_t reserved_tail_ = 0;        // producer only
+    uint64_t cached_head_ = 0;          // producer only
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+namespace {
+
+constexpr size_t kMaxOpenFiles = 32;
+
+std::atomic<uint64_t> next_log_id{1};
+
+// Each thread's buffers, one per log it has written to
+struct ThreadSlots {
+    struct Slot {
+        uint64_t log_id;
+        std::shared_ptr<EventLog::ThreadBuffer> buffer;
+    };
+    std::vector<Slot> slots;
+
+    ~ThreadSlots() {
+        for (Slot& slot : slots) slot.buffer->thread_exited.store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadSlots t_slots;
+
+#ifdef _WIN32
+int open_append(const std::string& path) {
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, 0644);
+}
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        int written = ::_write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1 << 30)));
+        if (written < 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+bool sync_fd(int fd) { return ::_commit(fd) == 0; }
+void close_fd(int fd) { ::_close(fd); }
+#else
+int open_append(const std::string& path) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+}
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+bool sync_fd(int fd) {
+#ifdef __linux__
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+void close_fd(int fd) { ::close(fd); }
+#endif
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+char* put_varint(char* out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+char* put_bytes(char* out, std::string_view text) {
+    out = put_varint(out, text.size());
+    if (!text.empty()) std::memcpy(out, text.data(), text.size());
+    return out + text.size();
+}
+
+void put_u32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+std::string iso_time(double timestamp) {
+    int64_t us = to_us(timestamp);
+    time_t seconds = floor_seconds(us);
+    std::tm local{};
+    if (!local_time(seconds, local)) return std::string();
+    char text[40];
+    size_t length = std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &local);
+    int64_t micros = us - static_cast<int64_t>(seconds) * 1000000;
+    if (micros) length += std::snprintf(text + length, sizeof(text) - length, ".%06lld", static_cast<long long>(micros));
+    return std::string(text, length);
+}
+
+void put_json_string(std::string& out, std::string_view text) {
+    out.push_back('"');
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out += escaped;
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+EventLog::EventLog(std::string dir, EventLogOptions options)
+    : dir_(std::move(dir)), options_(options), id_(next_log_id.fetch_add(1)), reader_(dir_) {
+    if (options_.buffer_bytes < 64 || (options_.buffer_bytes & (options_.buffer_bytes - 1)) != 0) {
+        throw std::invalid_argument("buffer_bytes must be a power of two >= 64");
+    }
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (!fs::is_directory(dir_)) {
+        throw std::runtime_error("cannot create log directory: " + dir_);
+    }
+    writer_ = std::thread([this] { run(); });
+}
+
+EventLog::~EventLog() {
+    stopping_.store(true);
+    wake_.notify();
+    writer_.join();
+    for (auto& [path, fd] : files_) close_fd(fd);
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (auto& buffer : buffers_) buffer->log_closed.store(true, std::memory_order_release);
+}
+
+EventLog::ThreadBuffer& EventLog::buffer() {
+    for (auto& slot : t_slots.slots) {
+        if (slot.log_id == id_) return *slot.buffer;
+    }
+    auto& slots = t_slots.slots;
+    slots.erase(std::remove_if(slots.begin(), slots.end(),
+                               [](const auto& slot) { return slot.buffer->log_closed.load(); }),
+                slots.end());
+    auto created = std::make_shared<ThreadBuffer>(options_.buffer_bytes);
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.push_back(created);
+    }
+    slots.push_back({id_, created});
+    return *created;
+}
+
+void EventLog::log(std::string_view collection, std::string_view event_type, std::string_view data,
+                   std::string_view metadata, double timestamp) {
+    if (!valid_collection(collection)) {
+        throw std::invalid_argument("invalid log collection name '" + std::string(collection) + "'");
+    }
+    const uint64_t stamp = zigzag_encode(timestamp == 0 ? now_us() : to_us(timestamp));
+    const size_t size = varint_size(collection.size()) + collection.size() + varint_size(stamp) +
+                        varint_size(event_type.size()) + event_type.size() + varint_size(data.size()) +
+                        data.size() + varint_size(metadata.size()) + metadata.size();
+    auto encode = [&](char* out) {
+        out = put_bytes(out, collection);
+        out = put_varint(out, stamp);
+        out = put_bytes(out, event_type);
+        out = put_bytes(out, data);
+        put_bytes(out, metadata);
+    };
+
+    ThreadBuffer& ring = buffer();
+    if (char* out = ring.reserve(size)) {
+        encode(out);
+        ring.commit();
+        if (ring.used_bound() * 2 <= ring.capacity() || ring.used() * 2 <= ring.capacity() ||
+            wake_pending_.load(std::memory_order_relaxed)) {
+            return;
+        }
+    } else {
+        std::string bytes(size, '\0');
+        encode(bytes.data());
+        {
+            std::lock_guard<std::mutex> lock(overflow_mutex_);
+            overflow_.push_back(std::move(bytes));
+        }
+        overflowed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!wake_pending_.exchange(true)) wake_.notify();
+}
+
+void EventLog::flush() {
+    const uint64_t ticket = flush_requests_.fetch_add(1) + 1;
+    wake_pending_.store(true);
+    wake_.notify();
+    std::unique_lock<std::mutex> lock(flushed_mutex_);
+    flushed_cv_.wait(lock, [&] { return flushed_ >= ticket; });
+}
+
+void EventLog::run() {
+    while (true) {
+        wake_.wait(options_.flush_interval_ms);
+        wake_pending_.store(false);
+        const bool stopping = stopping_.load();
+        const uint64_t requested = flush_requests_.load();
+        write_batch();
+        {
+            std::lock_guard<std::mutex> lock(flushed_mutex_);
+            flushed_ = requested;
+        }
+        flushed_cv_.notify_all();
+        if (stopping) break;
+    }
+}
+
+// Writer thread: drain every buffer, order by time and append per file
+void EventLog::write_batch() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                      [](const auto& buffer) {
+                                          return buffer->thread_exited.load(std::memory_order_acquire) &&
+                                                 buffer->empty();
+                                      }),
+                       buffers_.end());
+        buffers = buffers_;
+    }
+    std::vector<std::string> overflow;
+    {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        overflow.swap(overflow_);
+    }
+
+    std::vector<std::string_view> records;
+    std::vector<uint64_t> drained(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) drained[i] = buffers[i]->peek(records);
+    for (const std::string& bytes : overflow) records.emplace_back(bytes);
+    if (records.empty()) return;
+
+    struct Pending {
+        int64_t us;
+        std::string_view collection;
+        std::string_view payload;      // timestamp onwards
+    };
+    std::vector<Pending> batch;
+    batch.reserve(records.size());
+    for (std::string_view record : records) {
+        VarintReader reader(record);
+        uint64_t length;
+        if (!reader.number(length) || length > record.size() - reader.position()) continue;
+        Pending pending;
+        pending.collection = record.substr(reader.position(), length);
+        pending.payload = record.substr(reader.position() + length);
+        VarintReader stamp(pending.payload);
+        int64_t us;
+        if (!stamp.signed_number(us)) continue;
+        pending.us = us;
+        batch.push_back(pending);
+    }
+    std::stable_sort(batch.begin(), batch.end(), [](const Pending& a, const Pending& b) { return a.us < b.us; });
+
+    struct Group {
+        std::string bytes;
+        uint64_t events = 0;
+    };
+    std::map<std::pair<std::string_view, std::string>, Group> groups;     // by (collection, month)
+    MonthCache month;
+    Group* group = nullptr;
+    std::string_view group_collection;
+    const std::string* group_month = nullptr;
+    for (const Pending& pending : batch) {
+        const std::string& name = month.name(pending.us);
+        if (!group || pending.collection != group_collection || &name != group_month || name != *group_month) {
+            group = &groups[{pending.collection, name}];
+            group_collection = pending.collection;
+            group_month = &name;
+        }
+        put_u32(group->bytes, static_cast<uint32_t>(pending.payload.size()));
+        put_u32(group->bytes, crc32(pending.payload.data(), pending.payload.size()));
+        group->bytes.append(pending.payload);
+        ++group->events;
+    }
+
+    for (auto& [key, group] : groups) {
+        const std::string path = (fs::path(dir_) / std::string(key.first) / (key.second + kExtension)).string();
+        auto it = files_.find(path);
+        if (it == files_.end()) {
+            if (files_.size() >= kMaxOpenFiles) {
+                for (auto& [open_path, fd] : files_) close_fd(fd);
+                files_.clear();
+            }
+            // A torn tail from a crash stays put: readers skip to the next intact
+            // frame, and truncating here could cut another process's append short
+            std::error_code ec;
+            fs::create_directories(fs::path(path).parent_path(), ec);
+            int fd = open_append(path);
+            if (fd < 0) {
+                write_errors_.fetch_add(group.events, std::memory_order_relaxed);
+                continue;
+            }
+            it = files_.emplace(path, fd).first;
+        }
+        if (!write_all(it->second, group.bytes.data(), group.bytes.size()) ||
+            (options_.sync && !sync_fd(it->second))) {
+            write_errors_.fetch_add(group.events, std::memory_order_relaxed);
+            close_fd(it->second);
+            files_.erase(it);
+            continue;
+        }
+        events_.fetch_add(group.events, std::memory_order_relaxed);
+        bytes_.fetch_add(group.bytes.size(), std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < buffers.size(); ++i) buffers[i]->release(drained[i]);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<EventRecord> EventLog::query(const std::string& collection, const std::string& event_type,
+                                         double since, size_t limit) {
+    flush();
+    return reader_.events(collection, event_type, since, EventQuery::kNoLimit, limit);
+}
+
+EventAggregate EventLog::aggregate(const std::string& collection, const std::string& event_type,
+                                   const std::vector<std::string>& group_by, const std::vector<std::string>& values,
+                                   double since, double until) {
+    flush();
+    return reader_.aggregate(collection, event_type, group_by, values, since, until);
+}
+
+std::vector<std::string> EventLog::collections() const {
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_directory() && !log_files(it->path()).empty()) names.push_back(it->path().filename().string());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+size_t EventLog::export_jsonl(const std::string& collection, const std::string& path) {
+    if (!valid_collection(collection)) {
+        throw std::invalid_argument("invalid log collection name '" + collection + "'");
+    }
+    flush();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("cannot write " + path);
+
+    size_t count = 0;
+    std::string line;
+    for (const fs::path& file : log_files(fs::path(dir_) / collection)) {
+        MappedFile mapped;
+        if (!mapped.open(file.string())) continue;
+        walk_frames(mapped.data(), mapped.size(), 0, [&](size_t, std::string_view payload) {
+            EventRecord event;
+            if (!decode_event(payload, event)) return;
+            line = "{\"timestamp\": ";
+            put_json_string(line, iso_time(event.timestamp));
+            line += ", \"event_type\": ";
+            put_json_string(line, event.event_type);
+            line += ", \"collection\": ";
+            put_json_string(line, collection);
+            line += ", \"data\": ";
+            line += event.data.empty() ? "{}" : event.data;
+            line += ", \"metadata\": ";
+            line += event.metadata.empty() ? "{}" : event.metadata;
+            line += "}\n";
+            out.write(line.data(), static_cast<std::streamsize>(line.size()));
+            ++count;
+        });
+    }
+    if (!out.flush()) throw std::runtime_error("cannot write " + path);
+    return count;
+}
+
+EventLogStats EventLog::stats() const {
+    EventLogStats stats;
+    stats.events = events_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.overflowed = overflowed_.load(std::memory_order_relaxed);
+    stats.write_errors = write_errors_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    stats.threads = buffers_.size();
+    return stats;
+}
+
+} // namespace isaac
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "event_query.hpp"
+#include "core/wake_signal.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace isaac {
+
+struct EventLogStats {
+    uint64_t events = 0;                // written since open
+    uint64_t bytes = 0;                 // framed bytes written
+    uint64_t batches = 0;               // writer rounds that wrote anything
+    uint64_t overflowed = 0;            // events that did not fit their thread buffer
+    uint64_t write_errors = 0;          // events lost to failed writes
+    size_t threads = 0;                 // live thread buffers
+};
+
+struct EventLogOptions {
+    size_t buffer_bytes = 256 << 10;    // per thread; power of two
+    int flush_interval_ms = 50;         // writer wakes at least this often
+    bool sync = false;                  // fdatasync each batch
+};
+
+/**
+ * Structured event log with per-thread buffers and a background writer.
+ *
+ * log() encodes the event straight into a single-producer ring owned by
+ * the calling thread, publishes it with one release store and returns; it
+ * takes no lock and makes no system call unless the ring passes half full,
+ * when it wakes the writer early. Events that do not fit go to a locked
+ * overflow list instead of being dropped.
+ *
+ * The writer wakes every flush_interval_ms, drains every ring, orders the
+ * batch by timestamp and appends it to <dir>/<collection>/<YYYY-MM>.evlog
+ * (local month of each event) with one write per file. Files are sequences
+ * of [u32 length][u32 crc32][payload] frames, payload = zigzag varint
+ * microseconds, then length-prefixed event type, data and metadata. They
+ * are opened O_APPEND, so several processes can share a directory; nothing
+ * is ever truncated, and readers skip a torn frame left by a crash to the
+ * next intact one. Reads go through an EventQuery over the same directory.
+ */
+class EventLog {
+public:
+    explicit EventLog(std::string dir, EventLogOptions options = {});
+    ~EventLog();    // flushes
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // timestamp 0 = now. Throws std::invalid_argument for a collection name
+    // that is empty, hidden or contains a path separator.
+    void log(std::string_view collection, std::string_view event_type, std::string_view data,
+             std::string_view metadata = {}, double timestamp = 0);
+
+    // Block until everything this thread logged before the call is written
+    void flush();
+
+    // Newest first; empty event_type = any; limit 0 = all. Queries flush first.
+    std::vector<EventRecord> query(const std::string& collection, const std::string& event_type = "",
+                                   double since = -EventQuery::kNoLimit, size_t limit = 0);
+    EventAggregate aggregate(const std::string& collection, const std::string& event_type,
+                             const std::vector<std::string>& group_by, const std::vector<std::string>& values,
+                             double since = -EventQuery::kNoLimit, double until = EventQuery::kNoLimit);
+    std::vector<std::string> collections() const;
+    // Oldest first as JSON Lines in the shape of the old log files; returns the event count
+    size_t export_jsonl(const std::string& collection, const std::string& path);
+
+    EventLogStats stats() const;
+
+    static constexpr const char* kExtension = ".evlog";
+
+    class ThreadBuffer;
+
+private:
+    ThreadBuffer& buffer();
+    void run();
+    void write_batch();
+
+    std::string dir_;
+    EventLogOptions options_;
+    const uint64_t id_;                 // tells this log's buffers apart in thread caches
+    EventQuery reader_;
+
+    mutable std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+    std::mutex overflow_mutex_;
+    std::vector<std::string> overflow_;
+
+    // Writer thread only
+    std::map<std::string, int> files_;  // open descriptors by path
+
+    WakeSignal wake_;
+    std::atomic<bool> wake_pending_{false};
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> flush_requests_{0};
+    std::mutex flushed_mutex_;
+    std::condition_variable flushed_cv_;
+    uint64_t flushed_ = 0;              // flush requests covered by a finished round
+
+    std::atomic<uint64_t> events_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> overflowed_{0};
+    std::atomic<uint64_t> write_errors_{0};
+
+    std::thread writer_;
+};
+
+} // namespace isaac
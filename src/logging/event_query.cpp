@@ -0,0 +1,646 @@
+#include "event_query.hpp"
+#include "event_format.hpp"
+#include "core/mapped_file.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+using namespace event_format;
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'I', 'S', 'A', 'A', 'C', 'E', 'I', '2'};
+constexpr const char* kIndexExtension = ".evidx";
+constexpr int64_t kPlausibleUs = int64_t(1e17);     // below year ~5000: month names are meaningful
+constexpr uint64_t kAnyType = ~uint64_t(0);
+
+uint64_t type_bit(size_t id) {
+    return uint64_t(1) << std::min<size_t>(id, 63);
+}
+
+size_t type_id(std::vector<std::string>& types, std::string_view type, size_t& hint) {
+    if (hint < types.size() && types[hint] == type) return hint;
+    for (size_t i = 0; i < types.size(); ++i) {
+        if (types[i] == type) return hint = i;
+    }
+    types.emplace_back(type);
+    return hint = types.size() - 1;
+}
+
+// Only the last block can be partial
+template <typename Blocks>
+size_t full_blocks(const Blocks& blocks) {
+    return !blocks.empty() && blocks.back().count < EventQuery::kBlockEvents ? blocks.size() - 1 : blocks.size();
+}
+
+// Length-prefixed field of a payload, as a view
+bool take(std::string_view& in, std::string_view& out) {
+    size_t pos = 0;
+    uint64_t length;
+    if (!varint_decode(reinterpret_cast<const uint8_t*>(in.data()), in.size(), pos, length) ||
+        length > in.size() - pos) {
+        return false;
+    }
+    out = in.substr(pos, length);
+    in.remove_prefix(pos + length);
+    return true;
+}
+
+// Frames of an indexed block; already checksummed when the block was built,
+// unless it spans damaged bytes that have to be skipped again
+template <typename Fn>
+void for_each_frame(const uint8_t* data, uint64_t offset, uint64_t end, bool damaged, Fn&& fn) {
+    if (damaged) {
+        walk_frames(data, end, offset, [&fn](size_t, std::string_view payload) { fn(payload); });
+        return;
+    }
+    while (offset <= end && end - offset >= kFrameHeader) {
+        uint32_t length = get_u32(data + offset);
+        if (length > end - offset - kFrameHeader) break;
+        fn(std::string_view(reinterpret_cast<const char*>(data + offset + kFrameHeader), length));
+        offset += kFrameHeader + length;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// JSON field extraction straight from the stored text
+// ----------------------------------------------------------------------------
+
+const char* skip_ws(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    return p;
+}
+
+// p is on the opening quote; returns past the closing one, or nullptr
+const char* skip_string(const char* p, const char* end) {
+    for (++p; p < end; ++p) {
+        if (*p == '\\') {
+            if (++p == end) break;
+        } else if (*p == '"') {
+            return p + 1;
+        }
+    }
+    return nullptr;
+}
+
+const char* skip_value(const char* p, const char* end) {
+    if (p >= end) return nullptr;
+    if (*p == '"') return skip_string(p, end);
+    if (*p == '{' || *p == '[') {
+        int depth = 0;
+        while (p < end) {
+            if (*p == '"') {
+                if (!(p = skip_string(p, end))) return nullptr;
+                continue;
+            }
+            if (*p == '{' || *p == '[') {
+                ++depth;
+            } else if ((*p == '}' || *p == ']') && --depth == 0) {
+                return p + 1;
+            }
+            ++p;
+        }
+        return nullptr;
+    }
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\t' && *p != '\r') {
+        ++p;
+    }
+    return p;
+}
+
+int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool read_hex4(const char* p, const char* end, uint32_t& value) {
+    if (end - p < 4) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        int digit = hex_digit(p[i]);
+        if (digit < 0) return false;
+        value = value << 4 | static_cast<uint32_t>(digit);
+    }
+    return true;
+}
+
+void put_utf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | code >> 6);
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | code >> 12);
+        out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | code >> 18);
+        out += static_cast<char>(0x80 | (code >> 12 & 0x3F));
+        out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+// Unescape the body of a JSON string (between the quotes)
+bool unescape(std::string_view text, std::string& out) {
+    out.clear();
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        if (*p != '\\') {
+            out += *p++;
+            continue;
+        }
+        if (++p == end) return false;
+        char c = *p++;
+        switch (c) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (!read_hex4(p, end, code)) return false;
+                p += 4;
+                uint32_t low;
+                if (code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                    read_hex4(p + 2, end, low) && low >= 0xDC00 && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    p += 6;
+                }
+                put_utf8(out, code);
+                break;
+            }
+            default: out += c; break;     // \" \\ \/
+        }
+    }
+    return true;
+}
+
+// Value of member `key` in the object starting at p (after whitespace), or nullptr
+const char* find_member(const char* p, const char* end, std::string_view key, std::string& scratch) {
+    if (p >= end || *p != '{') return nullptr;
+    ++p;
+    while (true) {
+        p = skip_ws(p, end);
+        if (p >= end || *p != '"') return nullptr;
+        const char* key_end = skip_string(p, end);
+        if (!key_end) return nullptr;
+        std::string_view raw(p + 1, static_cast<size_t>(key_end - p - 2));
+        bool match = raw.find('\\') == std::string_view::npos ? raw == key : unescape(raw, scratch) && scratch == key;
+        p = skip_ws(key_end, end);
+        if (p >= end || *p != ':') return nullptr;
+        p = skip_ws(p + 1, end);
+        if (match) return p;
+        if (!(p = skip_value(p, end))) return nullptr;
+        p = skip_ws(p, end);
+        if (p < end && *p == ',') ++p;
+    }
+}
+
+enum class Source { EventType, Data, Metadata };
+
+struct FieldPath {
+    Source source = Source::EventType;
+    std::vector<std::string> keys;
+};
+
+FieldPath parse_field(const std::string& field) {
+    FieldPath path;
+    size_t dot = field.find('.');
+    std::string head = field.substr(0, dot);
+    if (head == "event_type" && dot == std::string::npos) return path;
+    if (head == "data") {
+        path.source = Source::Data;
+    } else if (head == "metadata") {
+        path.source = Source::Metadata;
+    } else {
+        dot = std::string::npos;
+    }
+    while (dot != std::string::npos) {
+        size_t next = field.find('.', dot + 1);
+        path.keys.push_back(field.substr(dot + 1, next == std::string::npos ? std::string::npos : next - dot - 1));
+        if (path.keys.back().empty()) break;
+        dot = next;
+    }
+    if (path.keys.empty() || path.keys.back().empty()) {
+        throw std::invalid_argument("invalid event field '" + field +
+                                    "', expected event_type, data.<key>... or metadata.<key>...");
+    }
+    return path;
+}
+
+std::vector<FieldPath> parse_fields(const std::vector<std::string>& fields) {
+    std::vector<FieldPath> paths;
+    paths.reserve(fields.size());
+    for (const std::string& field : fields) paths.push_back(parse_field(field));
+    return paths;
+}
+
+// A located field: what Python's `if value:` and isinstance(value, (int, float)) would see
+struct Scalar {
+    enum Kind { None, Text, Number, Bool, Composite } kind = None;
+    std::string_view text;              // raw: string body (still escaped), number or non-empty list/object as written
+    double number = 0;                  // Number and Bool
+};
+
+Scalar classify(const char* p, const char* end) {
+    Scalar value;
+    if (p >= end) return value;
+    if (*p == '"') {
+        const char* close = skip_string(p, end);
+        if (!close) return value;
+        value.kind = Scalar::Text;
+        value.text = std::string_view(p + 1, static_cast<size_t>(close - p - 2));
+    } else if (*p == '-' || (*p >= '0' && *p <= '9')) {
+        const char* stop = skip_value(p, end);
+        char buffer[64];
+        size_t length = static_cast<size_t>(stop - p);
+        if (length >= sizeof(buffer)) return value;
+        std::copy(p, stop, buffer);
+        buffer[length] = '\0';
+        char* parsed;
+        value.number = std::strtod(buffer, &parsed);
+        if (parsed != buffer + length) return value;
+        value.kind = Scalar::Number;
+        value.text = std::string_view(p, length);
+    } else if (*p == '[' || *p == '{') {
+        // Empty containers are falsy, like in Python
+        const char* close = skip_value(p, end);
+        if (!close || skip_ws(p + 1, end) == close - 1) return value;
+        value.kind = Scalar::Composite;
+        value.text = std::string_view(p, static_cast<size_t>(close - p));
+    } else if (end - p >= 4 && std::string_view(p, 4) == "true") {
+        value.kind = Scalar::Bool;
+        value.number = 1;
+    } else if (end - p >= 5 && std::string_view(p, 5) == "false") {
+        value.kind = Scalar::Bool;
+    }
+    return value;
+}
+
+Scalar locate(const FieldPath& path, std::string_view json, std::string& scratch) {
+    const char* end = json.data() + json.size();
+    const char* p = skip_ws(json.data(), end);
+    for (const std::string& key : path.keys) {
+        if (!(p = find_member(p, end, key, scratch))) return {};
+    }
+    return classify(p, end);
+}
+
+// Sum/min/max of a block's column; four independent lanes let the compiler vectorize
+void reduce(const std::vector<double>& column, ValueStats& stats) {
+    size_t n = column.size();
+    if (n == 0) return;
+    const double* v = column.data();
+    double sum[4] = {0, 0, 0, 0};
+    double low[4] = {v[0], v[0], v[0], v[0]};
+    double high[4] = {v[0], v[0], v[0], v[0]};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            double x = v[i + lane];
+            sum[lane] += x;
+            low[lane] = x < low[lane] ? x : low[lane];
+            high[lane] = x > high[lane] ? x : high[lane];
+        }
+    }
+    for (; i < n; ++i) {
+        sum[0] += v[i];
+        low[0] = std::min(low[0], v[i]);
+        high[0] = std::max(high[0], v[i]);
+    }
+    double block_low = std::min(std::min(low[0], low[1]), std::min(low[2], low[3]));
+    double block_high = std::max(std::max(high[0], high[1]), std::max(high[2], high[3]));
+    stats.min = stats.count ? std::min(stats.min, block_low) : block_low;
+    stats.max = stats.count ? std::max(stats.max, block_high) : block_high;
+    stats.sum += (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    stats.count += n;
+}
+
+std::string sidecar_path(const std::string& path) {
+    return fs::path(path).replace_extension(kIndexExtension).string();
+}
+
+} // namespace
+
+EventQuery::EventQuery(std::string dir) : dir_(std::move(dir)), temp_nonce_(std::random_device{}()) {}
+
+bool EventQuery::refresh(std::string_view data, FileIndex& index) const {
+    if (index.indexed_end > data.size()) index = FileIndex{};     // replaced file
+    uint64_t offset = index.indexed_end;
+    if (!index.blocks.empty() && index.blocks.back().count < kBlockEvents) {
+        offset = index.blocks.back().offset;
+        index.blocks.pop_back();
+    }
+    const size_t full_before = index.blocks.size();
+
+    Block block;
+    size_t hint = 0;
+    uint64_t expected = offset;     // blocks stay contiguous; skipped bytes mark theirs damaged
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    index.indexed_end = walk_frames(bytes, data.size(), offset, [&](size_t at, std::string_view payload) {
+        if (block.count == 0) {
+            block = Block{};
+            block.offset = expected;
+            block.min_us = INT64_MAX;
+            block.max_us = INT64_MIN;
+        }
+        if (at != expected) block.damaged = true;
+        int64_t us;
+        std::string_view type;
+        size_t rest;
+        if (decode_head(payload, us, type, rest)) {
+            block.min_us = std::min(block.min_us, us);
+            block.max_us = std::max(block.max_us, us);
+            block.types |= type_bit(type_id(index.types, type, hint));
+        }
+        block.end = expected = at + kFrameHeader + payload.size();
+        if (++block.count == kBlockEvents) {
+            index.blocks.push_back(block);
+            block.count = 0;
+        }
+    });
+    if (block.count > 0) index.blocks.push_back(block);
+    return full_blocks(index.blocks) > full_before;
+}
+
+// Sidecar: magic, varint end of the last full block, type dictionary, then
+// per full block its byte length (shifted left, low bit = damaged), zigzag
+// min delta from the previous block, max - min and type bitmap. Only full
+// blocks are stored.
+void EventQuery::save_index(const std::string& path, const FileIndex& index) const {
+    size_t count = full_blocks(index.blocks);
+    std::vector<uint8_t> out(std::begin(kIndexMagic), std::end(kIndexMagic));
+    varint_encode(out, count ? index.blocks[count - 1].end : 0);
+    varint_encode(out, index.types.size());
+    for (const std::string& type : index.types) put_string(out, type);
+    varint_encode(out, count);
+    int64_t previous_min = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Block& block = index.blocks[i];
+        varint_encode(out, (block.end - block.offset) << 1 | (block.damaged ? 1 : 0));
+        varint_encode(out, zigzag_encode(block.min_us - previous_min));
+        varint_encode(out, static_cast<uint64_t>(block.max_us) - static_cast<uint64_t>(block.min_us));
+        varint_encode(out, block.types);
+        previous_min = block.min_us;
+    }
+
+    std::string sidecar = sidecar_path(path);
+    std::string temp = sidecar + ".tmp." + std::to_string(temp_nonce_);
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+        if (!file) {
+            file.close();
+            std::error_code ignored;
+            fs::remove(temp, ignored);
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temp, sidecar, ec);
+    if (ec) fs::remove(temp, ec);
+}
+
+bool EventQuery::load_index(const std::string& path, std::string_view data, FileIndex& index) const {
+    std::ifstream file(sidecar_path(path), std::ios::binary);
+    if (!file) return false;
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < sizeof(kIndexMagic) || !std::equal(std::begin(kIndexMagic), std::end(kIndexMagic), bytes.begin())) {
+        return false;
+    }
+
+    FileIndex loaded;
+    VarintReader reader(std::string_view(bytes).substr(sizeof(kIndexMagic)));
+    uint64_t types, count;
+    if (!reader.number(loaded.indexed_end) || !reader.number(types) || types > bytes.size()) return false;
+    loaded.types.resize(types);
+    for (std::string& type : loaded.types) {
+        if (!reader.string(type)) return false;
+    }
+    if (!reader.number(count) || count > bytes.size()) return false;
+    loaded.blocks.resize(count);
+    uint64_t offset = 0;
+    int64_t previous_min = 0;
+    for (Block& block : loaded.blocks) {
+        uint64_t length, min_delta, spread;
+        if (!reader.number(length) || !reader.number(min_delta) || !reader.number(spread) ||
+            !reader.number(block.types)) {
+            return false;
+        }
+        block.damaged = length & 1;
+        block.offset = offset;
+        block.end = offset += length >> 1;
+        block.count = kBlockEvents;
+        block.min_us = previous_min = previous_min + zigzag_decode(min_delta);
+        block.max_us = static_cast<int64_t>(static_cast<uint64_t>(block.min_us) + spread);
+    }
+
+    // Must describe a prefix of this file: check the ends line up and the
+    // last block still starts with an intact frame
+    if (offset != loaded.indexed_end || loaded.indexed_end > data.size()) return false;
+    if (count > 0) {
+        const Block& last = loaded.blocks.back();
+        const uint8_t* bytes_at = reinterpret_cast<const uint8_t*>(data.data());
+        if (walk_frames(bytes_at, last.end, last.offset, [](size_t, std::string_view) {}) != last.end) {
+            return false;
+        }
+    }
+    index = std::move(loaded);
+    return true;
+}
+
+template <typename Visit>
+void EventQuery::scan(const std::string& collection, const std::string& event_type, ScanRange& range,
+                      bool newest_first, Visit&& visit) {
+    if (!valid_collection(collection)) return;
+
+    // Events live in the file of their local month, so whole files fall out by name
+    std::string first_month, last_month;
+    MonthCache months;
+    if (range.since_us > 0 && range.since_us < kPlausibleUs) first_month = months.name(range.since_us);
+    if (range.until_us > 0 && range.until_us < kPlausibleUs) last_month = months.name(range.until_us);
+
+    std::vector<fs::path> files = log_files(fs::path(dir_) / collection);
+    if (newest_first) std::reverse(files.begin(), files.end());
+    for (const fs::path& file : files) {
+        std::string month = file.stem().string();
+        if (month.size() == 7 && month[4] == '-') {
+            if (!first_month.empty() && month < first_month) continue;
+            if (!last_month.empty() && month > last_month) continue;
+        }
+        MappedFile mapped;
+        std::string path = file.string();
+        if (!mapped.open(path)) continue;
+
+        auto found = files_.find(path);
+        if (found == files_.end()) {
+            found = files_.emplace(path, FileIndex{}).first;
+            load_index(path, mapped.view(), found->second);
+        }
+        FileIndex& index = found->second;
+        if (refresh(mapped.view(), index)) save_index(path, index);
+
+        uint64_t mask = kAnyType;
+        if (!event_type.empty()) {
+            auto type = std::find(index.types.begin(), index.types.end(), event_type);
+            mask = type == index.types.end() ? 0 : type_bit(static_cast<size_t>(type - index.types.begin()));
+        }
+        auto consider = [&](const Block& block) {
+            if (!(block.types & mask) || block.max_us < range.since_us || block.min_us > range.until_us) {
+                ++range.blocks_skipped;
+                return;
+            }
+            ++range.blocks_read;
+            visit(mapped.data(), block);
+        };
+        if (newest_first) {
+            for (auto block = index.blocks.rbegin(); block != index.blocks.rend(); ++block) consider(*block);
+        } else {
+            for (const Block& block : index.blocks) consider(block);
+        }
+    }
+}
+
+std::vector<EventRecord> EventQuery::events(const std::string& collection, const std::string& event_type,
+                                            double since, double until, size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ScanRange range{to_us(since), to_us(until)};
+    std::vector<std::pair<int64_t, EventRecord>> matches;
+
+    // Keep the newest `limit` so far; older blocks then fall below since_us
+    auto trim = [&] {
+        auto newer = [](const auto& a, const auto& b) { return a.first > b.first; };
+        std::nth_element(matches.begin(), matches.begin() + static_cast<ptrdiff_t>(limit - 1), matches.end(), newer);
+        range.since_us = std::max(range.since_us, matches[limit - 1].first);
+        matches.erase(std::remove_if(matches.begin(), matches.end(),
+                                     [&](const auto& match) { return match.first < range.since_us; }),
+                      matches.end());
+    };
+
+    scan(collection, event_type, range, true, [&](const uint8_t* data, const Block& block) {
+        for_each_frame(data, block.offset, block.end, block.damaged, [&](std::string_view payload) {
+            int64_t us;
+            std::string_view type;
+            size_t rest;
+            if (!decode_head(payload, us, type, rest) || us < range.since_us || us > range.until_us ||
+                (!event_type.empty() && type != event_type)) {
+                return;
+            }
+            EventRecord event;
+            if (decode_event(payload, event)) matches.emplace_back(us, std::move(event));
+        });
+        if (limit && matches.size() >= 2 * limit) trim();
+    });
+
+    // Batches from several processes can interleave slightly
+    std::stable_sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    if (limit && matches.size() > limit) matches.resize(limit);
+    std::vector<EventRecord> result;
+    result.reserve(matches.size());
+    for (auto& match : matches) result.push_back(std::move(match.second));
+    return result;
+}
+
+EventAggregate EventQuery::aggregate(const std::string& collection, const std::string& event_type,
+                                     const std::vector<std::string>& group_by,
+                                     const std::vector<std::string>& values, double since, double until) {
+    const std::vector<FieldPath> group_paths = parse_fields(group_by);
+    const std::vector<FieldPath> value_paths = parse_fields(values);
+    bool needs_body = false;
+    for (const auto* paths : {&group_paths, &value_paths}) {
+        for (const FieldPath& path : *paths) needs_body |= path.source != Source::EventType;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    EventAggregate result;
+    result.values.resize(values.size());
+    std::vector<std::map<std::string, uint64_t, std::less<>>> groups(group_by.size());
+    std::vector<std::vector<double>> columns(values.size());
+    std::string scratch, key;
+    ScanRange range{to_us(since), to_us(until)};
+
+    scan(collection, event_type, range, false, [&](const uint8_t* data, const Block& block) {
+        for (auto& column : columns) column.clear();
+        for_each_frame(data, block.offset, block.end, block.damaged, [&](std::string_view payload) {
+            int64_t us;
+            std::string_view type;
+            size_t rest;
+            if (!decode_head(payload, us, type, rest) || us < range.since_us || us > range.until_us ||
+                (!event_type.empty() && type != event_type)) {
+                return;
+            }
+            ++result.events;
+
+            std::string_view body[2];   // data, metadata
+            if (needs_body) {
+                std::string_view tail = payload.substr(rest);
+                if (!take(tail, body[0]) || !take(tail, body[1])) return;
+            }
+            auto field = [&](const FieldPath& path) {
+                if (path.source == Source::EventType) {
+                    Scalar value;
+                    value.kind = Scalar::Text;
+                    value.text = type;
+                    return value;
+                }
+                return locate(path, body[path.source == Source::Data ? 0 : 1], scratch);
+            };
+
+            for (size_t i = 0; i < group_paths.size(); ++i) {
+                Scalar value = field(group_paths[i]);
+                std::string_view text;
+                switch (value.kind) {
+                    case Scalar::Text:
+                        if (value.text.find('\\') == std::string_view::npos) {
+                            text = value.text;
+                        } else if (unescape(value.text, key)) {
+                            text = key;
+                        }
+                        break;
+                    case Scalar::Number:
+                        if (value.number != 0) text = value.text;
+                        break;
+                    case Scalar::Bool:
+                        if (value.number != 0) text = "True";
+                        break;
+                    case Scalar::Composite:
+                        text = value.text;      // JSON text, as the Python fallback renders it
+                        break;
+                    case Scalar::None:
+                        break;
+                }
+                if (text.empty()) continue;
+                auto group = groups[i].find(text);
+                if (group == groups[i].end()) group = groups[i].emplace(std::string(text), 0).first;
+                ++group->second;
+            }
+            for (size_t i = 0; i < value_paths.size(); ++i) {
+                Scalar value = field(value_paths[i]);
+                if (value.kind == Scalar::Number || value.kind == Scalar::Bool) columns[i].push_back(value.number);
+            }
+        });
+        for (size_t i = 0; i < columns.size(); ++i) reduce(columns[i], result.values[i]);
+    });
+
+    result.groups.reserve(groups.size());
+    for (auto& group : groups) result.groups.emplace_back(group.begin(), group.end());
+    result.blocks_read = range.blocks_read;
+    result.blocks_skipped = range.blocks_skipped;
+    return result;
+}
+
+} // namespace isaac
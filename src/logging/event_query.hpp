@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace isaac {
+
+struct EventRecord {
+    double timestamp = 0;               // unix seconds
+    std::string event_type;
+    std::string data;                   // JSON text
+    std::string metadata;               // JSON text
+};
+
+struct ValueStats {
+    uint64_t count = 0;                 // events where the field is a number
+    double sum = 0;
+    double min = 0;                     // valid when count > 0
+    double max = 0;
+};
+
+struct EventAggregate {
+    uint64_t events = 0;                // events matching type and time range
+    std::vector<std::map<std::string, uint64_t>> groups;   // per group field: value text -> events
+    std::vector<ValueStats> values;     // per value field
+    uint64_t blocks_read = 0;
+    uint64_t blocks_skipped = 0;
+};
+
+/**
+ * Read side of EventLog files: block summaries for skipping, and field
+ * aggregation that never builds event objects.
+ *
+ * Each <month>.evlog file is cut into blocks of up to kBlockEvents frames;
+ * a block records its byte range, event count, min/max timestamp and a
+ * bitmap of the event types it holds (ids from a per-file dictionary). A
+ * query skips whole files by month name and whole blocks by time range and
+ * type before touching a frame. Summaries are built once per file, extended
+ * as the file grows, and saved beside it as <month>.evidx so a new process
+ * starts warm; files only grow, so a saved index stays valid for its prefix.
+ *
+ * Fields are dotted paths: "event_type", "data.<key>..." or
+ * "metadata.<key>...". Values are read straight from the stored JSON text;
+ * a block's numeric values are gathered into a column and reduced in one
+ * vectorizable pass. Group keys follow Python's str(): strings as is,
+ * numbers as written, true/false as "True"/"False"; null, "", 0 and false
+ * are not counted, like the Python summaries.
+ */
+class EventQuery {
+public:
+    explicit EventQuery(std::string dir);
+
+    static constexpr size_t kBlockEvents = 1024;
+    static constexpr double kNoLimit = std::numeric_limits<double>::max();
+
+    // Newest first; empty event_type = any; limit 0 = all
+    std::vector<EventRecord> events(const std::string& collection, const std::string& event_type = "",
+                                    double since = -kNoLimit, double until = kNoLimit, size_t limit = 0);
+
+    EventAggregate aggregate(const std::string& collection, const std::string& event_type,
+                             const std::vector<std::string>& group_by, const std::vector<std::string>& values,
+                             double since = -kNoLimit, double until = kNoLimit);
+
+private:
+    struct Block {
+        uint64_t offset = 0;
+        uint64_t end = 0;
+        uint32_t count = 0;
+        int64_t min_us = 0;
+        int64_t max_us = 0;
+        uint64_t types = 0;             // bit per type id; ids past 63 share bit 63
+        bool damaged = false;           // holds skipped bytes; frames are checksummed when read
+    };
+
+    struct FileIndex {
+        uint64_t indexed_end = 0;
+        std::vector<std::string> types;
+        std::vector<Block> blocks;
+    };
+
+    struct ScanRange {
+        int64_t since_us;               // visitors may raise it to prune later blocks
+        int64_t until_us;
+        uint64_t blocks_read = 0;
+        uint64_t blocks_skipped = 0;
+    };
+
+    // Visit (file data, block) for each block that may hold matches
+    template <typename Visit>
+    void scan(const std::string& collection, const std::string& event_type, ScanRange& range, bool newest_first,
+              Visit&& visit);
+
+    // Extend the index over frames appended since the last call; true if a block was completed
+    bool refresh(std::string_view data, FileIndex& index) const;
+    bool load_index(const std::string& path, std::string_view data, FileIndex& index) const;
+    void save_index(const std::string& path, const FileIndex& index) const;
+
+    std::string dir_;
+    uint64_t temp_nonce_;               // keeps sidecar temp names unique across processes
+    std::mutex mutex_;                  // one query at a time per log
+    std::map<std::string, FileIndex> files_;
+};
+
+} // namespace isaac
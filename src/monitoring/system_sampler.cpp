@@ -0,0 +1,379 @@
+#include "system_sampler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#endif
+
+namespace isaac {
+
+namespace {
+
+constexpr size_t kInitialBuffer = 4096;
+constexpr size_t kMaxBuffer = 4 << 20;
+
+// Forward-only tokenizer over a read buffer; never allocates
+class Scanner {
+public:
+    Scanner(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool done() const { return p_ >= end_; }
+
+    void skip_blanks() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t')) ++p_;
+    }
+
+    // Next run of characters up to whitespace or the stop character
+    std::string_view word(char stop = '\0') {
+        skip_blanks();
+        const char* start = p_;
+        while (p_ < end_ && *p_ != ' ' && *p_ != '\t' && *p_ != '\n' && *p_ != stop) ++p_;
+        return std::string_view(start, static_cast<size_t>(p_ - start));
+    }
+
+    uint64_t number() {
+        skip_blanks();
+        uint64_t value = 0;
+        while (p_ < end_ && *p_ >= '0' && *p_ <= '9') value = value * 10 + static_cast<uint64_t>(*p_++ - '0');
+        return value;
+    }
+
+    double decimal() {
+        double value = static_cast<double>(number());
+        if (p_ < end_ && *p_ == '.') {
+            ++p_;
+            double scale = 0.1;
+            for (; p_ < end_ && *p_ >= '0' && *p_ <= '9'; ++p_, scale /= 10) value += (*p_ - '0') * scale;
+        }
+        return value;
+    }
+
+    bool skip(char c) {
+        if (p_ < end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    void next_line() {
+        while (p_ < end_ && *p_ != '\n') ++p_;
+        if (p_ < end_) ++p_;
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+};
+
+bool starts_with(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+double seconds_since_epoch() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// "cpu  user nice system idle iowait irq softirq steal ..." then one line per CPU
+void parse_stat(Scanner scan, uint64_t& busy, uint64_t& total, size_t& cpus) {
+    busy = total = 0;
+    cpus = 0;
+    while (!scan.done()) {
+        std::string_view label = scan.word();
+        if (label == "cpu") {
+            // Guest time is already included in user
+            uint64_t idle = 0;
+            for (int i = 0; i < 8; ++i) {
+                uint64_t value = scan.number();
+                total += value;
+                if (i == 3 || i == 4) idle += value;
+            }
+            busy = total - idle;
+        } else if (starts_with(label, "cpu")) {
+            ++cpus;
+        } else if (!label.empty()) {
+            break;                      // per-CPU lines come first
+        }
+        scan.next_line();
+    }
+}
+
+void parse_meminfo(Scanner scan, SystemSample& sample) {
+    int found = 0;
+    while (!scan.done() && found < 2) {
+        std::string_view key = scan.word();
+        if (key == "MemTotal:") {
+            sample.memory_total = scan.number() * 1024;
+            ++found;
+        } else if (key == "MemAvailable:") {
+            sample.memory_available = scan.number() * 1024;
+            ++found;
+        }
+        scan.next_line();
+    }
+    if (sample.memory_total) {
+        sample.memory_used = sample.memory_total - std::min(sample.memory_available, sample.memory_total);
+        sample.memory_percent = 100.0 * static_cast<double>(sample.memory_used) / static_cast<double>(sample.memory_total);
+    }
+}
+
+// "0.52 0.58 0.59 2/1234 5678"
+void parse_loadavg(Scanner scan, SystemSample& sample) {
+    for (double& load : sample.load_average) load = scan.decimal();
+    scan.number();
+    if (scan.skip('/')) sample.tasks = scan.number();
+}
+
+// "major minor name reads merged sectors_read ms writes merged sectors_written ..."
+void parse_diskstats(Scanner scan, const std::vector<std::string>& disks, SystemSample& sample) {
+    while (!scan.done()) {
+        scan.number();
+        scan.number();
+        std::string_view name = scan.word();
+        if (std::find(disks.begin(), disks.end(), name) != disks.end()) {
+            uint64_t fields[7];
+            for (uint64_t& field : fields) field = scan.number();
+            sample.disk_read_bytes += fields[2] * 512;
+            sample.disk_write_bytes += fields[6] * 512;
+        }
+        scan.next_line();
+    }
+}
+
+// Two header lines, then "iface: rx_bytes packets errs drop fifo frame compressed multicast tx_bytes ..."
+void parse_netdev(Scanner scan, SystemSample& sample) {
+    scan.next_line();
+    scan.next_line();
+    while (!scan.done()) {
+        scan.word(':');
+        if (scan.skip(':')) {
+            uint64_t fields[9];
+            for (uint64_t& field : fields) field = scan.number();
+            sample.net_bytes_recv += fields[0];
+            sample.net_bytes_sent += fields[8];
+        }
+        scan.next_line();
+    }
+}
+
+uint64_t parse_cgroup_usage(Scanner scan) {
+    while (!scan.done()) {
+        if (scan.word() == "usage_usec") return scan.number();
+        scan.next_line();
+    }
+    return 0;
+}
+
+#ifdef __linux__
+int open_read(const std::string& path) {
+    return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+// This process's cgroup v2 directory, from the "0::<path>" line
+std::string own_cgroup() {
+    std::ifstream file("/proc/self/cgroup");
+    for (std::string line; std::getline(file, line);) {
+        if (starts_with(line, "0::")) return "/sys/fs/cgroup" + (line.size() > 4 ? line.substr(3) : std::string());
+    }
+    return "";
+}
+#endif
+
+} // namespace
+
+SystemSampler::SystemSampler(SystemSamplerOptions options) : options_(std::move(options)) {
+    if (options_.capacity == 0) {
+        throw std::invalid_argument("SystemSampler: capacity must be positive");
+    }
+    if (options_.interval_ms <= 0) {
+        throw std::invalid_argument("SystemSampler: interval_ms must be positive");
+    }
+    ring_.resize(options_.capacity);
+    open_sources();
+}
+
+SystemSampler::~SystemSampler() {
+    stop();
+#ifndef _WIN32
+    for (Source* source : {&stat_, &meminfo_, &loadavg_, &diskstats_, &netdev_,
+                           &cgroup_cpu_, &cgroup_memory_, &cgroup_memory_max_}) {
+        if (source->fd >= 0) ::close(source->fd);
+    }
+#endif
+}
+
+bool SystemSampler::supported() {
+#ifdef __linux__
+    return ::access("/proc/stat", R_OK) == 0;
+#else
+    return false;
+#endif
+}
+
+void SystemSampler::open_sources() {
+#ifdef __linux__
+    stat_.fd = open_read("/proc/stat");
+    meminfo_.fd = open_read("/proc/meminfo");
+    loadavg_.fd = open_read("/proc/loadavg");
+    diskstats_.fd = open_read("/proc/diskstats");
+    netdev_.fd = open_read("/proc/net/dev");
+
+    // /proc/diskstats also lists partitions; only whole disks appear in /sys/block
+    if (DIR* block = ::opendir("/sys/block")) {
+        while (dirent* entry = ::readdir(block)) {
+            if (entry->d_name[0] != '.') disks_.emplace_back(entry->d_name);
+        }
+        ::closedir(block);
+    }
+
+    std::string cgroup = options_.cgroup_path.empty() ? own_cgroup() : options_.cgroup_path;
+    if (!cgroup.empty()) {
+        cgroup_cpu_.fd = open_read(cgroup + "/cpu.stat");
+        cgroup_memory_.fd = open_read(cgroup + "/memory.current");
+        cgroup_memory_max_.fd = open_read(cgroup + "/memory.max");
+    }
+#endif
+    for (Source* source : {&stat_, &meminfo_, &loadavg_, &diskstats_, &netdev_,
+                           &cgroup_cpu_, &cgroup_memory_, &cgroup_memory_max_}) {
+        if (source->fd >= 0) source->buffer.resize(kInitialBuffer);
+    }
+}
+
+bool SystemSampler::read(Source& source, bool whole) {
+    source.size = 0;
+    if (source.fd < 0) return false;
+#ifndef _WIN32
+    for (;;) {
+        ssize_t n = ::pread(source.fd, source.buffer.data(), source.buffer.size(), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // A full buffer may have cut the file short: grow once and re-read
+        if (static_cast<size_t>(n) < source.buffer.size() || !whole || source.buffer.size() >= kMaxBuffer) {
+            source.size = static_cast<size_t>(n);
+            return true;
+        }
+        source.buffer.resize(source.buffer.size() * 2);
+    }
+#else
+    (void)whole;
+    return false;
+#endif
+}
+
+SystemSample SystemSampler::sample() {
+    SystemSample sample;
+    sample.timestamp = seconds_since_epoch();
+
+    std::lock_guard<std::mutex> lock(sample_mutex_);
+    auto scanner = [](const Source& source) { return Scanner(source.buffer.data(), source.size); };
+
+    if (read(stat_)) {
+        uint64_t busy = 0, total = 0;
+        parse_stat(scanner(stat_), busy, total, sample.cpu_count);
+        if (total > last_total_) {
+            sample.cpu_percent = 100.0 * static_cast<double>(busy - std::min(busy, last_busy_)) /
+                                 static_cast<double>(total - last_total_);
+        }
+        last_busy_ = busy;
+        last_total_ = total;
+    }
+    if (read(meminfo_)) parse_meminfo(scanner(meminfo_), sample);
+    if (read(loadavg_)) parse_loadavg(scanner(loadavg_), sample);
+    if (read(diskstats_)) parse_diskstats(scanner(diskstats_), disks_, sample);
+    if (read(netdev_)) parse_netdev(scanner(netdev_), sample);
+
+    if (read(cgroup_cpu_)) {
+        sample.cgroup = true;
+        const uint64_t usage = parse_cgroup_usage(scanner(cgroup_cpu_));
+        const auto now = std::chrono::steady_clock::now();
+        if (last_cgroup_usec_ && usage >= last_cgroup_usec_) {
+            const double wall_usec = std::chrono::duration<double, std::micro>(now - last_cgroup_time_).count();
+            if (wall_usec > 0) {
+                sample.cgroup_cpu_percent = 100.0 * static_cast<double>(usage - last_cgroup_usec_) / wall_usec;
+            }
+        }
+        last_cgroup_usec_ = usage;
+        last_cgroup_time_ = now;
+    }
+    if (read(cgroup_memory_)) sample.cgroup_memory_current = scanner(cgroup_memory_).number();
+    if (read(cgroup_memory_max_)) sample.cgroup_memory_max = scanner(cgroup_memory_max_).number();  // "max" reads as 0
+
+#ifndef _WIN32
+    struct statvfs fs_stat;
+    if (::statvfs(options_.disk_path.c_str(), &fs_stat) == 0) {
+        // Same as df: used / (used + available to unprivileged users)
+        const uint64_t used = static_cast<uint64_t>(fs_stat.f_blocks - fs_stat.f_bfree) * fs_stat.f_frsize;
+        const uint64_t available = static_cast<uint64_t>(fs_stat.f_bavail) * fs_stat.f_frsize;
+        sample.disk_free = available;
+        if (used + available) sample.disk_percent = 100.0 * static_cast<double>(used) / static_cast<double>(used + available);
+    }
+#endif
+
+    // Publish while still holding sample_mutex_ so sequences follow sampling order
+    std::lock_guard<std::mutex> ring_lock(ring_mutex_);
+    sample.sequence = ++sequence_;
+    ring_[(sample.sequence - 1) % ring_.size()] = sample;
+    return sample;
+}
+
+SystemSample SystemSampler::latest() const {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    return sequence_ ? ring_[(sequence_ - 1) % ring_.size()] : SystemSample{};
+}
+
+std::vector<SystemSample> SystemSampler::since(uint64_t sequence) const {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    const uint64_t oldest = sequence_ > ring_.size() ? sequence_ - ring_.size() + 1 : 1;
+    std::vector<SystemSample> samples;
+    for (uint64_t seq = std::max(sequence + 1, oldest); seq <= sequence_; ++seq) {
+        samples.push_back(ring_[(seq - 1) % ring_.size()]);
+    }
+    return samples;
+}
+
+void SystemSampler::start() {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (thread_.joinable()) return;
+    stopping_ = false;
+    thread_ = std::thread(&SystemSampler::run, this);
+}
+
+void SystemSampler::stop() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        if (!thread_.joinable()) return;
+        stopping_ = true;
+        thread = std::move(thread_);
+    }
+    stop_cv_.notify_all();
+    thread.join();
+}
+
+bool SystemSampler::running() const {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    return thread_.joinable();
+}
+
+void SystemSampler::run() {
+    const auto interval = std::chrono::milliseconds(options_.interval_ms);
+    std::unique_lock<std::mutex> lock(thread_mutex_);
+    while (!stopping_) {
+        lock.unlock();
+        sample();
+        lock.lock();
+        stop_cv_.wait_for(lock, interval, [this] { return stopping_; });
+    }
+}
+
+} // namespace isaac
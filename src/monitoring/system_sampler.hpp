@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace isaac {
+
+struct SystemSample {
+    uint64_t sequence = 0;              // 1-based; 0 = no sample yet
+    double timestamp = 0;               // unix seconds
+
+    double cpu_percent = 0;             // all CPUs, since the previous sample
+    size_t cpu_count = 0;
+    double load_average[3] = {0, 0, 0};
+    size_t tasks = 0;                   // scheduling entities, from /proc/loadavg
+
+    uint64_t memory_total = 0;
+    uint64_t memory_available = 0;
+    uint64_t memory_used = 0;           // total - available
+    double memory_percent = 0;
+
+    uint64_t disk_read_bytes = 0;       // whole disks since boot
+    uint64_t disk_write_bytes = 0;
+    uint64_t disk_free = 0;             // statvfs of the sampler's disk path
+    double disk_percent = 0;
+
+    uint64_t net_bytes_recv = 0;        // all interfaces since boot
+    uint64_t net_bytes_sent = 0;
+
+    bool cgroup = false;                // cgroup v2 figures below are valid
+    double cgroup_cpu_percent = 0;      // of one CPU, since the previous sample
+    uint64_t cgroup_memory_current = 0;
+    uint64_t cgroup_memory_max = 0;     // 0 = no limit
+};
+
+struct SystemSamplerOptions {
+    int interval_ms = 1000;             // background sampling period
+    size_t capacity = 600;              // samples kept in the ring
+    std::string disk_path = "/";
+    std::string cgroup_path;            // cgroup v2 directory; empty = this process's own
+};
+
+/**
+ * Background system sampler over /proc and cgroup v2 files.
+ *
+ * The kernel files (/proc/stat, meminfo, loadavg, diskstats, net/dev and
+ * the cgroup's cpu.stat, memory.current and memory.max) are opened once
+ * and re-read with pread into buffers sized on the first read, then
+ * parsed in place, so a steady-state sample makes no allocations and no
+ * open/close calls. Samples go into a fixed ring that readers copy from
+ * whenever they need figures: latest() for the current state, since() for
+ * everything after a sequence number they saw before.
+ *
+ * sample() takes one on demand whether or not the thread is running.
+ * Outside Linux only the disk figures are filled.
+ */
+class SystemSampler {
+public:
+    explicit SystemSampler(SystemSamplerOptions options = {});
+    ~SystemSampler();   // stops
+
+    SystemSampler(const SystemSampler&) = delete;
+    SystemSampler& operator=(const SystemSampler&) = delete;
+
+    // True where the kernel files exist (Linux)
+    static bool supported();
+
+    void start();
+    void stop();
+    bool running() const;
+
+    // Take a sample now, publish it and return it
+    SystemSample sample();
+
+    // Most recent sample; sequence 0 when none has been taken
+    SystemSample latest() const;
+
+    // Samples with a sequence above the given one still in the ring, oldest first
+    std::vector<SystemSample> since(uint64_t sequence) const;
+
+    bool has_cgroup() const { return cgroup_cpu_.fd >= 0; }
+
+private:
+    struct Source {
+        int fd = -1;
+        std::vector<char> buffer;
+        size_t size = 0;                // bytes in buffer from the last read
+    };
+
+    void open_sources();
+    bool read(Source& source, bool whole = true);
+    void run();
+
+    SystemSamplerOptions options_;
+
+    // Sampling state, under sample_mutex_
+    std::mutex sample_mutex_;
+    Source stat_, meminfo_, loadavg_, diskstats_, netdev_;
+    Source cgroup_cpu_, cgroup_memory_, cgroup_memory_max_;
+    std::vector<std::string> disks_;    // whole-disk names from /sys/block
+    uint64_t last_busy_ = 0;
+    uint64_t last_total_ = 0;
+    uint64_t last_cgroup_usec_ = 0;
+    std::chrono::steady_clock::time_point last_cgroup_time_;
+
+    // Published samples, under ring_mutex_
+    mutable std::mutex ring_mutex_;
+    std::vector<SystemSample> ring_;
+    uint64_t sequence_ = 0;
+
+    mutable std::mutex thread_mutex_;
+    std::condition_variable stop_cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace isaac
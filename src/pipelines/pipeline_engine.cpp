@@ -0,0 +1,588 @@
+#include "pipeline_engine.hpp"
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace isaac {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kErrorOutputChars = 1000;
+
+double wall_seconds() {
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(system_clock::now().time_since_epoch()).count();
+}
+
+double seconds_between(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+std::string format_seconds(int64_t ms) {
+    std::ostringstream text;
+    text << static_cast<double>(ms) / 1000.0;
+    return text.str();
+}
+
+bool is_name_start(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool is_name_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::string shell_quote(const std::string& text) {
+    std::string quoted = "'";
+    for (char c : text) {
+        if (c == '\'') quoted += "'\\''";
+        else quoted += c;
+    }
+    return quoted + "'";
+}
+
+} // namespace
+
+std::string substitute_variables(const std::string& text,
+                                 const std::unordered_map<std::string, std::string>& variables) {
+    std::string result;
+    result.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        if (text[i] != '$' || i + 1 == text.size()) {
+            result += text[i++];
+            continue;
+        }
+        if (text[i + 1] == '{') {
+            size_t close = text.find('}', i + 2);
+            if (close != std::string::npos) {
+                auto it = variables.find(text.substr(i + 2, close - i - 2));
+                if (it != variables.end()) {
+                    result += it->second;
+                    i = close + 1;
+                    continue;
+                }
+            }
+            result += text[i++];
+            continue;
+        }
+        if (is_name_start(text[i + 1])) {
+            size_t end = i + 1;
+            while (end < text.size() && is_name_char(text[end])) ++end;
+            auto it = variables.find(text.substr(i + 1, end - i - 1));
+            if (it != variables.end()) {
+                result += it->second;
+            } else {
+                result.append(text, i, end - i);
+            }
+            i = end;
+            continue;
+        }
+        result += text[i++];
+    }
+    return result;
+}
+
+struct PipelineEngine::Run {
+    enum class Phase { Waiting, Ready, Running, Delayed, Done };
+
+    struct Step {
+        Phase phase = Phase::Waiting;
+        std::vector<size_t> dependencies;
+        std::vector<size_t> dependents;
+        size_t remaining = 0;           // dependencies that have not succeeded yet
+        int stdin_source = -1;
+        int pid = -1;
+        std::string cache_key;          // set while a cacheable attempt runs
+        bool has_deadline = false;
+        bool timed_out = false;
+        bool killed = false;            // terminated because the run halted
+        bool held = false;              // streamed consumer done before its source succeeded
+        bool upstream_failed = false;   // streamed consumer whose source failed
+        Clock::time_point started{};
+        Clock::time_point finished{};
+        Clock::time_point deadline{};
+        Clock::time_point retry_at{};
+        PipelineStepResult result;
+    };
+
+    std::vector<PipelineStepSpec> specs;
+    std::unordered_map<std::string, std::string> variables;
+    PipelineRunOptions options;
+    StepCallback callback;
+
+    std::vector<Step> steps;
+    std::deque<size_t> ready;
+    size_t running = 0;
+    bool halted = false;                // no new steps start
+    bool cancelled = false;
+    std::string error;
+    Clock::time_point started{};
+    std::condition_variable changed;
+};
+
+PipelineEngine::PipelineEngine(unsigned workers, size_t max_output_bytes, std::shared_ptr<StepCache> cache)
+    : cache_(std::move(cache)) {
+    executor_ = std::make_unique<ProcessExecutor>(
+        [this](int pid, ProcessOutcome outcome) { on_process_exit(pid, std::move(outcome)); }, max_output_bytes);
+    pool_ = std::make_unique<WorkStealingPool>(workers);
+}
+
+PipelineEngine::~PipelineEngine() {
+    pool_->shutdown();
+    executor_.reset();
+}
+
+PipelineRunResult PipelineEngine::run(const std::string& run_id, const std::vector<PipelineStepSpec>& steps,
+                                      const std::unordered_map<std::string, std::string>& variables,
+                                      const PipelineRunOptions& options, StepCallback callback) {
+    auto state = std::make_unique<Run>();
+    Run& run = *state;
+    run.specs = steps;
+    run.variables = variables;
+    run.options = options;
+    run.options.max_parallel = std::max<size_t>(1, options.max_parallel);
+    run.callback = std::move(callback);
+    run.steps.resize(steps.size());
+
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const PipelineStepSpec& spec = steps[i];
+        if (spec.id.empty()) throw std::invalid_argument("Step ID cannot be empty");
+        if (!index.emplace(spec.id, i).second) throw std::invalid_argument("Duplicate step " + spec.id);
+        if (spec.kind != "command" && spec.kind != "wait" && spec.kind != "callback") {
+            throw std::invalid_argument("Unknown step kind '" + spec.kind + "' for step " + spec.id);
+        }
+        if (spec.kind == "callback" && !run.callback) {
+            throw std::invalid_argument("Step " + spec.id + " needs a callback");
+        }
+        run.steps[i].result.id = spec.id;
+    }
+
+    for (size_t i = 0; i < steps.size(); ++i) {
+        Run::Step& step = run.steps[i];
+        std::vector<std::string> names = steps[i].depends_on;
+        if (!steps[i].stdin_from.empty()) names.push_back(steps[i].stdin_from);  // reading stdin implies waiting
+        for (const auto& name : names) {
+            auto it = index.find(name);
+            if (it == index.end()) {
+                throw std::invalid_argument("Step " + steps[i].id + " depends on unknown step " + name);
+            }
+            if (std::find(step.dependencies.begin(), step.dependencies.end(), it->second) !=
+                step.dependencies.end()) {
+                continue;
+            }
+            step.dependencies.push_back(it->second);
+            run.steps[it->second].dependents.push_back(i);
+        }
+        if (!steps[i].stdin_from.empty()) step.stdin_source = static_cast<int>(index[steps[i].stdin_from]);
+        step.remaining = step.dependencies.size();
+    }
+
+    // Kahn's algorithm: every step must be reachable from a root
+    {
+        std::vector<size_t> pending(steps.size());
+        std::vector<size_t> queue;
+        for (size_t i = 0; i < steps.size(); ++i) {
+            pending[i] = run.steps[i].remaining;
+            if (pending[i] == 0) queue.push_back(i);
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            for (size_t dependent : run.steps[queue[head]].dependents) {
+                if (--pending[dependent] == 0) queue.push_back(dependent);
+            }
+        }
+        if (queue.size() != steps.size()) throw std::invalid_argument("Pipeline steps form a dependency cycle");
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!runs_.emplace(run_id, &run).second) throw std::invalid_argument("Run " + run_id + " is already active");
+
+    run.started = Clock::now();
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (run.steps[i].remaining == 0) {
+            run.steps[i].phase = Run::Phase::Ready;
+            run.ready.push_back(i);
+        }
+    }
+
+    Clock::time_point run_deadline = run.started + std::chrono::milliseconds(options.timeout_ms);
+    while (true) {
+        Clock::time_point now = Clock::now();
+        if (options.timeout_ms > 0 && !run.halted && now >= run_deadline) {
+            halt(run, "Pipeline timed out after " + format_seconds(options.timeout_ms) + " seconds");
+        }
+
+        bool delayed = false;
+        for (size_t i = 0; i < run.steps.size(); ++i) {
+            Run::Step& step = run.steps[i];
+            if (step.phase == Run::Phase::Running && step.has_deadline && now >= step.deadline) {
+                if (run.specs[i].kind == "wait") {
+                    complete(run, i, 0, "Waited " + format_seconds(run.specs[i].wait_ms) + " seconds", "", false);
+                } else {
+                    // Callback steps and cache lookups cannot be interrupted; they finish as timed out
+                    step.timed_out = true;
+                    step.has_deadline = false;
+                    if (step.pid >= 0) executor_->terminate(step.pid, options.kill_grace_ms);
+                }
+            } else if (step.phase == Run::Phase::Delayed) {
+                if (run.halted) {
+                    step.phase = Run::Phase::Done;
+                } else if (now >= step.retry_at) {
+                    // A streamed consumer that failed early waits for its source again
+                    step.phase = step.remaining == 0 ? Run::Phase::Ready : Run::Phase::Waiting;
+                    if (step.remaining == 0) run.ready.push_back(i);
+                } else {
+                    delayed = true;
+                }
+            }
+        }
+
+        while (!run.halted && !run.ready.empty() && run.running < run.options.max_parallel) {
+            size_t next = run.ready.front();
+            run.ready.pop_front();
+            if (run.steps[next].phase == Run::Phase::Ready) launch(run, next);
+        }
+
+        if (run.running == 0 && !delayed && (run.halted || run.ready.empty())) break;
+
+        std::optional<Clock::time_point> wake;
+        auto consider = [&](Clock::time_point at) {
+            if (!wake || at < *wake) wake = at;
+        };
+        if (options.timeout_ms > 0 && !run.halted) consider(run_deadline);
+        for (const Run::Step& step : run.steps) {
+            if (step.phase == Run::Phase::Running && step.has_deadline) consider(step.deadline);
+            if (step.phase == Run::Phase::Delayed) consider(step.retry_at);
+        }
+        if (wake) {
+            run.changed.wait_until(lock, *wake);
+        } else {
+            run.changed.wait(lock);
+        }
+    }
+
+    runs_.erase(run_id);
+    return collect(run);
+}
+
+bool PipelineEngine::cancel(const std::string& run_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = runs_.find(run_id);
+    if (it == runs_.end()) return false;
+    Run& run = *it->second;
+    run.cancelled = true;
+    halt(run, "Pipeline cancelled");
+    run.changed.notify_all();
+    return true;
+}
+
+void PipelineEngine::on_process_exit(int pid, ProcessOutcome outcome) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pids_.find(pid);
+    if (it == pids_.end()) return;
+    auto [run, index] = it->second;
+    pids_.erase(it);
+    complete(*run, index, outcome.exit_code, std::move(outcome.stdout_data), std::move(outcome.stderr_data),
+             outcome.truncated);
+}
+
+void PipelineEngine::launch(Run& run, size_t index) {
+    auto begin = [&run](size_t i) {
+        Run::Step& step = run.steps[i];
+        const PipelineStepSpec& spec = run.specs[i];
+        step.phase = Run::Phase::Running;
+        ++run.running;
+        ++step.result.attempts;
+        step.started = Clock::now();
+        if (step.result.start_time == 0) step.result.start_time = wall_seconds();
+        step.timed_out = false;
+        step.killed = false;
+        step.cache_key.clear();
+        int64_t limit = spec.kind == "wait" ? spec.wait_ms : spec.timeout_ms;
+        step.has_deadline = spec.kind == "wait" || limit > 0;
+        step.deadline = step.started + std::chrono::milliseconds(limit);
+    };
+
+    begin(index);
+    Run::Step& step = run.steps[index];
+    const PipelineStepSpec& spec = run.specs[index];
+    if (spec.kind == "wait") return;
+
+    std::string input;
+    if (step.stdin_source >= 0) input = run.steps[step.stdin_source].result.stdout_data;
+
+    if (spec.kind == "callback") {
+        pool_->post([this, &run, index, input = std::move(input)] {
+            int exit_code;
+            std::string output;
+            try {
+                std::tie(exit_code, output) = run.callback(run.specs[index].id, input);
+            } catch (const std::exception& e) {
+                exit_code = 1;
+                output = std::string("Step execution error: ") + e.what();
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            complete(run, index, exit_code, std::move(output), "", false);
+        });
+        return;
+    }
+
+    if (cache_ && spec.cache) {
+        launch_cached(run, index, std::move(input));
+        return;
+    }
+
+    // Consumers start first so the source's first bytes have somewhere to go.
+    // A retried source would feed them twice, so those are buffered instead.
+    std::vector<int> consumers;
+    if (spec.retry_count == 0) {
+        for (size_t dependent : step.dependents) {
+            Run::Step& consumer = run.steps[dependent];
+            if (consumer.phase != Run::Phase::Waiting || consumer.stdin_source != static_cast<int>(index) ||
+                consumer.remaining != 1 || run.specs[dependent].kind != "command" ||
+                (cache_ && run.specs[dependent].cache)) {
+                continue;
+            }
+            begin(dependent);
+            consumer.result.streamed = true;
+            SpawnOptions consumer_options;
+            consumer_options.pipe_stdin = true;
+            consumer_options.keep_stdin_open = true;
+            int pid = spawn_step(run, dependent, consumer_options);
+            if (pid >= 0) consumers.push_back(pid);
+        }
+    }
+
+    SpawnOptions options;
+    options.pipe_stdin = step.stdin_source >= 0;
+    options.stdin_data = std::move(input);
+    options.stdout_to = consumers;
+    spawn_step(run, index, options);
+    for (int pid : consumers) executor_->close_stdin(pid);
+}
+
+// Hashing input files can take a while, so the lookup runs on the pool
+void PipelineEngine::launch_cached(Run& run, size_t index, std::string input) {
+    std::string command = substitute_variables(run.specs[index].command, run.variables);
+    pool_->post([this, &run, index, command = std::move(command), input = std::move(input)]() mutable {
+        const PipelineStepSpec& spec = run.specs[index];
+        std::string key;
+        std::optional<StepCacheEntry> hit;
+        try {
+            key = cache_->fingerprint(command, run.options.working_dir, spec.env, input, spec.inputs);
+            hit = cache_->lookup(key);
+        } catch (const std::exception&) {
+            key.clear();  // an unusable cache never fails the step
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Run::Step& step = run.steps[index];
+        if (run.halted || step.timed_out) {
+            step.killed = !step.timed_out;
+            complete(run, index, -1, "", "", false);
+            return;
+        }
+        if (hit) {
+            step.result.cached = true;
+            complete(run, index, hit->exit_code, std::move(hit->stdout_data), std::move(hit->stderr_data), false);
+            return;
+        }
+        step.cache_key = std::move(key);
+        SpawnOptions options;
+        options.pipe_stdin = step.stdin_source >= 0;
+        options.stdin_data = std::move(input);
+        spawn_step(run, index, options);
+    });
+}
+
+int PipelineEngine::spawn_step(Run& run, size_t index, const SpawnOptions& options) {
+    std::string command = substitute_variables(run.specs[index].command, run.variables);
+    if (!run.options.working_dir.empty()) {
+        command = "cd -- " + shell_quote(run.options.working_dir) + " || exit 127\n" + command;
+    }
+
+    int pid;
+    try {
+        pid = executor_->spawn({"/bin/sh", "-c", command}, options);
+    } catch (const std::exception& e) {
+        complete(run, index, 127, "", e.what(), false);
+        return -1;
+    }
+    run.steps[index].pid = pid;
+    pids_[pid] = {&run, index};
+    return pid;
+}
+
+void PipelineEngine::complete(Run& run, size_t index, int exit_code, std::string out, std::string err,
+                              bool truncated) {
+    Run::Step& step = run.steps[index];
+    const PipelineStepSpec& spec = run.specs[index];
+    step.pid = -1;
+    step.has_deadline = false;
+    step.finished = Clock::now();
+    --run.running;
+
+    PipelineStepResult& result = step.result;
+    result.exit_code = exit_code;
+    result.stdout_data = std::move(out);
+    result.stderr_data = std::move(err);
+    result.truncated = truncated;
+    result.end_time = wall_seconds();
+    result.duration = seconds_between(step.started, step.finished);
+
+    bool success = exit_code == 0 && !step.timed_out && !step.killed;
+    if (step.upstream_failed) {
+        // Whatever it made of partial input doesn't count, like an unstarted dependent
+        step.phase = Run::Phase::Done;
+        result.status = "skipped";
+        run.changed.notify_all();
+        return;
+    }
+    if (success && !truncated && !result.cached && !step.cache_key.empty()) {
+        StepCacheEntry entry{exit_code, result.stdout_data, result.stderr_data, result.duration, result.end_time};
+        pool_->post([cache = cache_, key = std::move(step.cache_key), entry = std::move(entry)] {
+            try {
+                cache->store(key, entry);
+            } catch (const std::exception&) {
+                // Best effort: the next run simply misses
+            }
+        });
+    }
+    step.cache_key.clear();
+    if (!success && !run.halted && result.attempts <= spec.retry_count) {
+        step.phase = Run::Phase::Delayed;
+        step.retry_at = step.finished + std::chrono::milliseconds(spec.retry_delay_ms);
+        result.status = step.timed_out ? "timeout" : "failed";
+        run.changed.notify_all();
+        return;
+    }
+
+    step.phase = Run::Phase::Done;
+    if (success) {
+        result.status = "success";
+        // A streamed consumer's result only stands once its source succeeded
+        if (result.streamed && run.steps[step.stdin_source].result.status != "success") {
+            step.held = true;
+        } else {
+            release(run, index);
+        }
+        for (size_t dependent : step.dependents) {
+            Run::Step& consumer = run.steps[dependent];
+            if (consumer.held && consumer.stdin_source == static_cast<int>(index)) {
+                consumer.held = false;
+                release(run, dependent);
+            }
+        }
+    } else if (step.killed) {
+        result.status = "cancelled";
+    } else {
+        result.status = step.timed_out ? "timeout" : "failed";
+        if (!spec.continue_on_failure) {
+            std::string detail;
+            if (step.timed_out) {
+                detail = "timed out after " + format_seconds(spec.timeout_ms) + " seconds";
+            } else {
+                std::string output = result.stdout_data + result.stderr_data;
+                if (output.size() > kErrorOutputChars) output = output.substr(output.size() - kErrorOutputChars);
+                detail = "failed: " + output;
+            }
+            halt(run, "Step " + spec.id + " " + detail);
+        }
+    }
+    if (!success) skip_streamed(run, index);
+    run.changed.notify_all();
+}
+
+// Streamed consumers of a failed source saw partial input: skip them like the other dependents
+void PipelineEngine::skip_streamed(Run& run, size_t index) {
+    const Run::Step& source = run.steps[index];
+    for (size_t dependent : source.dependents) {
+        Run::Step& consumer = run.steps[dependent];
+        if (!consumer.result.streamed || consumer.stdin_source != static_cast<int>(index)) continue;
+        if (consumer.phase == Run::Phase::Running) {
+            if (source.killed) continue;  // the halt stops it too
+            consumer.upstream_failed = true;
+            if (consumer.pid >= 0) executor_->terminate(consumer.pid, run.options.kill_grace_ms);
+        } else if (consumer.held || consumer.phase != Run::Phase::Done) {
+            consumer.held = false;
+            consumer.phase = Run::Phase::Done;
+            consumer.result.status = source.killed ? "cancelled" : "skipped";
+        }
+    }
+}
+
+void PipelineEngine::release(Run& run, size_t index) {
+    for (size_t dependent : run.steps[index].dependents) {
+        Run::Step& next = run.steps[dependent];
+        if (--next.remaining == 0 && next.phase == Run::Phase::Waiting) {
+            next.phase = Run::Phase::Ready;
+            run.ready.push_back(dependent);
+        }
+    }
+}
+
+void PipelineEngine::halt(Run& run, const std::string& error) {
+    if (run.halted) return;
+    run.halted = true;
+    run.error = error;
+    for (size_t i = 0; i < run.steps.size(); ++i) {
+        Run::Step& step = run.steps[i];
+        if (step.phase != Run::Phase::Running) continue;
+        if (step.pid >= 0) {
+            step.killed = true;
+            executor_->terminate(step.pid, run.options.kill_grace_ms);
+        } else if (run.specs[i].kind == "wait") {
+            step.killed = true;
+            complete(run, i, -1, "", "", false);
+        }
+        // Callback steps cannot be interrupted; the run waits for them
+    }
+}
+
+PipelineRunResult PipelineEngine::collect(Run& run) {
+    PipelineRunResult result;
+    result.duration = seconds_between(run.started, Clock::now());
+    result.success = run.error.empty();
+    result.error = run.error;
+
+    // Walk back from the last step to finish through whichever dependency finished last
+    std::optional<size_t> cursor;
+    for (size_t i = 0; i < run.steps.size(); ++i) {
+        const Run::Step& step = run.steps[i];
+        if (step.result.attempts == 0) continue;
+        if (!cursor || step.finished > run.steps[*cursor].finished) cursor = i;
+    }
+    std::vector<size_t> path;
+    while (cursor) {
+        path.push_back(*cursor);
+        std::optional<size_t> gate;
+        for (size_t dependency : run.steps[*cursor].dependencies) {
+            const Run::Step& step = run.steps[dependency];
+            if (step.result.attempts == 0) continue;
+            if (!gate || step.finished > run.steps[*gate].finished) gate = dependency;
+        }
+        cursor = gate;
+    }
+    std::reverse(path.begin(), path.end());
+    for (size_t i : path) {
+        run.steps[i].result.critical = true;
+        result.critical_path.push_back(run.specs[i].id);
+        result.critical_path_seconds += run.steps[i].result.duration;
+    }
+
+    result.steps.reserve(run.steps.size());
+    for (Run::Step& step : run.steps) {
+        if (step.result.attempts == 0) step.result.status = run.cancelled ? "cancelled" : "skipped";
+        result.steps.push_back(std::move(step.result));
+    }
+    return result;
+}
+
+} // namespace isaac
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "pipelines/step_cache.hpp"
+#include "tasks/process_executor.hpp"
+#include "tasks/work_stealing_pool.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace isaac {
+
+struct PipelineStepSpec {
+    std::string id;
+    std::string kind = "command";       // "command", "wait" or "callback"
+    std::string command;                // shell command; variables are substituted at launch
+    int64_t wait_ms = 0;                // "wait" steps
+    std::vector<std::string> depends_on;
+    std::string stdin_from;             // step whose stdout becomes this step's stdin
+    int64_t timeout_ms = 0;             // 0 = none
+    int retry_count = 0;
+    int64_t retry_delay_ms = 0;
+    bool continue_on_failure = false;   // a failure skips the dependents, not the pipeline
+    bool cache = false;                 // replay a successful result when nothing it depends on changed
+    std::vector<std::string> inputs;    // files and directories the command reads (cache key)
+    std::vector<std::string> env;       // environment variables the command reads (cache key)
+};
+
+struct PipelineStepResult {
+    std::string id;
+    std::string status = "skipped";     // success, failed, timeout, cancelled or skipped
+    int exit_code = -1;
+    std::string stdout_data;
+    std::string stderr_data;
+    bool truncated = false;
+    int attempts = 0;
+    bool streamed = false;              // stdin was piped live from stdin_from
+    bool cached = false;                // replayed from the step cache
+    double start_time = 0;              // unix seconds
+    double end_time = 0;
+    double duration = 0;                // seconds, last attempt
+    bool critical = false;              // on the critical path
+};
+
+struct PipelineRunResult {
+    bool success = false;
+    std::string error;
+    std::vector<PipelineStepResult> steps;      // in spec order
+    std::vector<std::string> critical_path;     // root to last finisher
+    double critical_path_seconds = 0;
+    double duration = 0;
+};
+
+struct PipelineRunOptions {
+    size_t max_parallel = 3;
+    int64_t timeout_ms = 0;             // whole pipeline; 0 = none
+    std::string working_dir;
+    int kill_grace_ms = 2000;
+};
+
+// Replace ${name} and $name (longest identifier) from `variables`; unknown names stay as written
+std::string substitute_variables(const std::string& text,
+                                 const std::unordered_map<std::string, std::string>& variables);
+
+/**
+ * Runs pipeline steps as a dependency DAG.
+ *
+ * Steps start as soon as their dependencies succeed, up to max_parallel at
+ * a time. Command steps run through /bin/sh on a shared ProcessExecutor,
+ * wait steps are timers, and callback steps (anything the host language
+ * implements) run on a WorkStealingPool, so no thread waits on a child.
+ *
+ * A step with stdin_from reads that step's stdout. When its only remaining
+ * dependency is the source, it is started together with the source and fed
+ * live, like `a | b`; otherwise it gets the source's captured output once
+ * the source has finished. A streamed step's success only releases its
+ * dependents once the source succeeds; if the source fails, the streamed
+ * step is stopped and reported skipped like any other dependent. Failed
+ * steps are retried after retry_delay_ms; a final failure skips the step's
+ * dependents and, unless continue_on_failure, stops new steps from
+ * starting. When the run ends the result names the critical path: the
+ * chain of gating dependencies that ends at the last step to finish.
+ *
+ * With a StepCache, command steps marked cache are fingerprinted before
+ * they launch; a hit completes the step from the stored output without
+ * spawning anything, and a successful run is stored for next time. Cached
+ * steps always receive buffered stdin, since a hit has nothing to stream.
+ */
+class PipelineEngine {
+public:
+    // Returns (exit_code, output) for a callback step, given its id and stdin
+    using StepCallback = std::function<std::pair<int, std::string>(const std::string& id, const std::string& input)>;
+
+    explicit PipelineEngine(unsigned workers = 0, size_t max_output_bytes = 16 << 20,
+                            std::shared_ptr<StepCache> cache = nullptr);
+    ~PipelineEngine();
+
+    PipelineEngine(const PipelineEngine&) = delete;
+    PipelineEngine& operator=(const PipelineEngine&) = delete;
+
+    // Blocks until the run ends; throws std::invalid_argument for an unknown
+    // dependency, a cycle, a duplicate step or run id
+    PipelineRunResult run(const std::string& run_id, const std::vector<PipelineStepSpec>& steps,
+                          const std::unordered_map<std::string, std::string>& variables,
+                          const PipelineRunOptions& options = {}, StepCallback callback = nullptr);
+
+    // Stop starting steps and terminate the running ones
+    bool cancel(const std::string& run_id);
+
+private:
+    struct Run;
+
+    void on_process_exit(int pid, ProcessOutcome outcome);
+    void launch(Run& run, size_t index);
+    void launch_cached(Run& run, size_t index, std::string input);
+    int spawn_step(Run& run, size_t index, const SpawnOptions& options);
+    void complete(Run& run, size_t index, int exit_code, std::string out, std::string err, bool truncated);
+    void release(Run& run, size_t index);
+    void skip_streamed(Run& run, size_t index);
+    void halt(Run& run, const std::string& error);
+    static PipelineRunResult collect(Run& run);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Run*> runs_;
+    std::unordered_map<int, std::pair<Run*, size_t>> pids_;
+    std::unique_ptr<ProcessExecutor> executor_;
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::shared_ptr<StepCache> cache_;
+};
+
+} // namespace isaac
@@ -0,0 +1,399 @@
+#include "step_cache.hpp"
+#include "core/crc32.hpp"
+#include "core/mapped_file.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace isaac {
+
+namespace {
+
+constexpr char kActionMagic[8] = {'I', 'S', 'A', 'A', 'C', 'A', 'C', '1'};
+constexpr const char* kFingerprintVersion = "isaac-step-cache-1";
+constexpr auto kRacyWindow = std::chrono::seconds(2);   // mtime may not have ticked yet
+constexpr auto kBlobGrace = std::chrono::seconds(60);   // a store may still be writing its action
+
+struct ActionRecord {
+    int64_t exit_code = 0;
+    std::string stdout_digest;
+    std::string stderr_digest;
+    uint64_t duration_us = 0;
+    uint64_t created_ms = 0;
+};
+
+std::string encode_action(const ActionRecord& record) {
+    std::vector<uint8_t> out(std::begin(kActionMagic), std::end(kActionMagic));
+    varint_encode(out, zigzag_encode(record.exit_code));
+    put_string(out, record.stdout_digest);
+    put_string(out, record.stderr_digest);
+    varint_encode(out, record.duration_us);
+    varint_encode(out, record.created_ms);
+    uint32_t crc = crc32(out.data(), out.size());
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(crc >> (i * 8)));
+    return std::string(out.begin(), out.end());
+}
+
+std::optional<ActionRecord> decode_action(std::string_view data) {
+    if (data.size() < sizeof(kActionMagic) + 4 || std::memcmp(data.data(), kActionMagic, sizeof(kActionMagic)) != 0) {
+        return std::nullopt;
+    }
+    std::string_view body = data.substr(0, data.size() - 4);
+    uint32_t stored = 0;
+    for (int i = 0; i < 4; ++i) stored |= static_cast<uint32_t>(static_cast<uint8_t>(data[body.size() + i])) << (i * 8);
+    if (crc32(body.data(), body.size()) != stored) return std::nullopt;
+
+    ActionRecord record;
+    VarintReader reader(body.substr(sizeof(kActionMagic)));
+    if (!reader.signed_number(record.exit_code) || !reader.string(record.stdout_digest) ||
+        !reader.string(record.stderr_digest) || !reader.number(record.duration_us) ||
+        !reader.number(record.created_ms)) {
+        return std::nullopt;
+    }
+    return record;
+}
+
+bool is_digest(const std::string& text) {
+    return text.size() == 64 && std::all_of(text.begin(), text.end(), [](char c) {
+               return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+           });
+}
+
+bool is_temp(const fs::path& path) {
+    return path.filename().string().find(".tmp.") != std::string::npos;
+}
+
+// Length-prefixed, so adjacent fields cannot run into each other
+void add_field(Sha256& hash, std::string_view value) {
+    uint8_t length[8];
+    for (int i = 0; i < 8; ++i) length[i] = static_cast<uint8_t>(static_cast<uint64_t>(value.size()) >> (i * 8));
+    hash.update(length, sizeof(length));
+    hash.update(value);
+}
+
+int64_t mtime_ns(fs::file_time_type time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// Regular files below dir (two levels: <2hex>/<name>), skipping in-flight temps
+template <typename Visit>
+void for_each_entry(const fs::path& dir, Visit visit) {
+    std::error_code ec;
+    for (fs::directory_iterator shard(dir, ec); !ec && shard != fs::directory_iterator(); shard.increment(ec)) {
+        if (!shard->is_directory(ec)) continue;
+        std::error_code inner;
+        for (fs::directory_iterator it(shard->path(), inner); !inner && it != fs::directory_iterator();
+             it.increment(inner)) {
+            if (it->is_regular_file(inner) && !is_temp(it->path())) visit(*it);
+        }
+    }
+}
+
+} // namespace
+
+StepCache::StepCache(const std::string& dir) : dir_(dir), temp_nonce_(std::random_device{}()) {
+    if (dir.empty()) throw std::invalid_argument("Cache directory cannot be empty");
+    std::error_code ec;
+    fs::create_directories(fs::path(dir) / "ac", ec);
+    fs::create_directories(fs::path(dir) / "cas", ec);
+    if (ec) throw std::runtime_error("Cannot create cache directory " + dir + ": " + ec.message());
+}
+
+std::string StepCache::fingerprint(const std::string& command, const std::string& working_dir,
+                                   const std::vector<std::string>& env, const std::string& stdin_data,
+                                   const std::vector<std::string>& inputs) {
+    Sha256 hash;
+    add_field(hash, kFingerprintVersion);
+    add_field(hash, command);
+    add_field(hash, working_dir);
+
+    std::vector<std::string> names = env;
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    add_field(hash, std::to_string(names.size()));
+    for (const auto& name : names) {
+        const char* value = std::getenv(name.c_str());
+        add_field(hash, name);
+        add_field(hash, value ? std::string("=") + value : std::string("unset"));
+    }
+
+    add_field(hash, sha256_hex(stdin_data));
+
+    fs::path base = working_dir.empty() ? fs::current_path() : fs::path(working_dir);
+    add_field(hash, std::to_string(inputs.size()));
+    for (const auto& input : inputs) {
+        fs::path path(input);
+        hash_input(hash, path.is_absolute() ? path : base / path, input);
+    }
+    return Sha256::hex(hash.finish());
+}
+
+void StepCache::hash_input(Sha256& hash, const fs::path& path, const std::string& label) {
+    add_field(hash, label);
+    std::error_code ec;
+    fs::file_status status = fs::status(path, ec);
+    if (ec || !fs::exists(status)) {
+        add_field(hash, "missing");
+        return;
+    }
+
+    if (fs::is_regular_file(status)) {
+        add_field(hash, "file");
+        uint64_t size = fs::file_size(path, ec);
+        int64_t mtime = mtime_ns(fs::last_write_time(path, ec));
+        add_field(hash, file_digest(path, size, mtime));
+        return;
+    }
+    if (!fs::is_directory(status)) {
+        add_field(hash, "special");
+        return;
+    }
+
+    // Sorted relative paths, so the walk order of the filesystem does not matter
+    add_field(hash, "dir");
+    std::vector<std::pair<std::string, fs::path>> files;
+    for (fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        std::error_code inner;
+        if (it->is_regular_file(inner)) {
+            files.emplace_back(it->path().lexically_relative(path).generic_string(), it->path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    add_field(hash, std::to_string(files.size()));
+    for (const auto& [relative, file] : files) {
+        std::error_code inner;
+        uint64_t size = fs::file_size(file, inner);
+        int64_t mtime = mtime_ns(fs::last_write_time(file, inner));
+        add_field(hash, relative);
+        add_field(hash, file_digest(file, size, mtime));
+    }
+}
+
+std::string StepCache::file_digest(const fs::path& path, uint64_t size, int64_t mtime) {
+    const std::string key = path.string();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = file_hashes_.find(key);
+        if (it != file_hashes_.end() && it->second.size == size && it->second.mtime_ns == mtime) {
+            return it->second.digest;
+        }
+    }
+
+    MappedFile file;
+    if (!file.open(key)) return "unreadable";
+    std::string digest = sha256_hex(file.view());
+
+    int64_t racy = mtime_ns(fs::file_time_type::clock::now() - kRacyWindow);
+    if (mtime < racy) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_hashes_[key] = FileHash{size, mtime, digest};
+    }
+    return digest;
+}
+
+std::optional<StepCacheEntry> StepCache::lookup(const std::string& key) {
+    fs::path path = action_path(key);
+    std::optional<ActionRecord> record;
+    {
+        MappedFile file;
+        if (file.open(path.string())) record = decode_action(file.view());
+    }
+
+    std::optional<std::string> out, err;
+    if (record) out = read_blob(record->stdout_digest);
+    if (out) err = read_blob(record->stderr_digest);
+    std::error_code ec;
+    if (!err) {
+        if (record) fs::remove(path, ec);  // damaged or its blobs were pruned
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+
+    StepCacheEntry entry;
+    entry.exit_code = static_cast<int>(record->exit_code);
+    entry.stdout_data = std::move(*out);
+    entry.stderr_data = std::move(*err);
+    entry.duration = static_cast<double>(record->duration_us) / 1e6;
+    entry.created = static_cast<double>(record->created_ms) / 1e3;
+    return entry;
+}
+
+bool StepCache::store(const std::string& key, const StepCacheEntry& entry) {
+    fs::path path = action_path(key);
+    ActionRecord record;
+    record.exit_code = entry.exit_code;
+    record.stdout_digest = write_blob(entry.stdout_data);
+    record.stderr_digest = write_blob(entry.stderr_data);
+    if (record.stdout_digest.empty() || record.stderr_digest.empty()) return false;
+    record.duration_us = static_cast<uint64_t>(std::max(0.0, entry.duration) * 1e6);
+    double created = entry.created > 0 ? entry.created
+                                       : std::chrono::duration<double>(
+                                             std::chrono::system_clock::now().time_since_epoch())
+                                             .count();
+    record.created_ms = static_cast<uint64_t>(created * 1e3);
+
+    if (!write_atomic(path, encode_action(record))) return false;
+    stores_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+size_t StepCache::prune(uint64_t max_bytes) {
+    struct Action {
+        fs::path path;
+        fs::file_time_type used;
+        uint64_t size;
+        std::string blobs[2];
+    };
+
+    std::vector<Action> actions;
+    for_each_entry(fs::path(dir_) / "ac", [&](const fs::directory_entry& entry) {
+        std::error_code ec;
+        std::optional<ActionRecord> record;
+        {
+            MappedFile file;
+            if (file.open(entry.path().string())) record = decode_action(file.view());
+        }
+        if (!record) {
+            fs::remove(entry.path(), ec);
+            return;
+        }
+        actions.push_back({entry.path(), entry.last_write_time(ec), entry.file_size(ec),
+                           {record->stdout_digest, record->stderr_digest}});
+    });
+
+    struct Blob {
+        fs::path path;
+        fs::file_time_type written;
+        uint64_t size;
+        size_t refs = 0;
+    };
+    std::unordered_map<std::string, Blob> blobs;
+    for_each_entry(fs::path(dir_) / "cas", [&](const fs::directory_entry& entry) {
+        std::error_code ec;
+        blobs[entry.path().filename().string()] = Blob{entry.path(), entry.last_write_time(ec), entry.file_size(ec)};
+    });
+
+    uint64_t total = 0;
+    for (const Action& action : actions) {
+        total += action.size;
+        for (const auto& digest : action.blobs) {
+            auto it = blobs.find(digest);
+            if (it != blobs.end() && it->second.refs++ == 0) total += it->second.size;
+        }
+    }
+
+    std::sort(actions.begin(), actions.end(), [](const Action& a, const Action& b) { return a.used < b.used; });
+    size_t evicted = 0;
+    for (const Action& action : actions) {
+        if (total <= max_bytes) break;
+        std::error_code ec;
+        fs::remove(action.path, ec);
+        total -= action.size;
+        for (const auto& digest : action.blobs) {
+            auto it = blobs.find(digest);
+            if (it != blobs.end() && --it->second.refs == 0) total -= it->second.size;
+        }
+        ++evicted;
+    }
+
+    auto grace = fs::file_time_type::clock::now() - kBlobGrace;
+    for (const auto& [digest, blob] : blobs) {
+        std::error_code ec;
+        if (blob.refs == 0 && blob.written < grace) fs::remove(blob.path, ec);
+    }
+    return evicted;
+}
+
+void StepCache::clear() {
+    std::error_code ec;
+    for (const char* sub : {"ac", "cas"}) {
+        fs::remove_all(fs::path(dir_) / sub, ec);
+        fs::create_directories(fs::path(dir_) / sub, ec);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_hashes_.clear();
+}
+
+StepCacheStats StepCache::stats() const {
+    StepCacheStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.stores = stores_.load(std::memory_order_relaxed);
+    for_each_entry(fs::path(dir_) / "ac", [&](const fs::directory_entry& entry) {
+        std::error_code ec;
+        ++stats.actions;
+        stats.bytes += entry.file_size(ec);
+    });
+    for_each_entry(fs::path(dir_) / "cas", [&](const fs::directory_entry& entry) {
+        std::error_code ec;
+        ++stats.blobs;
+        stats.bytes += entry.file_size(ec);
+    });
+    return stats;
+}
+
+fs::path StepCache::action_path(const std::string& key) const {
+    if (!is_digest(key)) throw std::invalid_argument("Cache key must be a SHA-256 hex digest");
+    return fs::path(dir_) / "ac" / key.substr(0, 2) / key;
+}
+
+fs::path StepCache::blob_path(const std::string& digest) const {
+    return fs::path(dir_) / "cas" / digest.substr(0, 2) / digest;
+}
+
+std::optional<std::string> StepCache::read_blob(const std::string& digest) const {
+    if (!is_digest(digest)) return std::nullopt;
+    MappedFile file;
+    if (!file.open(blob_path(digest).string())) return std::nullopt;
+    std::string data(file.view());
+    if (sha256_hex(data) != digest) return std::nullopt;
+    return data;
+}
+
+std::string StepCache::write_blob(const std::string& data) {
+    std::string digest = sha256_hex(data);
+    fs::path path = blob_path(digest);
+    std::error_code ec;
+    if (fs::exists(path, ec)) {
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);  // keep it out of the prune grace check
+        return digest;
+    }
+    return write_atomic(path, data) ? digest : std::string();
+}
+
+bool StepCache::write_atomic(const fs::path& path, const std::string& data) {
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    fs::path temp = path;
+    temp += ".tmp." + std::to_string(temp_nonce_) + "." +
+            std::to_string(temp_counter_.fetch_add(1, std::memory_order_relaxed));
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            file.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+    fs::rename(temp, path, ec);
+    if (ec) {
+        std::error_code ignored;
+        fs::remove(temp, ignored);
+        return false;
+    }
+    return true;
+}
+
+} // namespace isaac
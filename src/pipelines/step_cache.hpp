@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/sha256.hpp"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+struct StepCacheEntry {
+    int exit_code = 0;
+    std::string stdout_data;
+    std::string stderr_data;
+    double duration = 0;                // seconds the original execution took
+    double created = 0;                 // unix seconds
+};
+
+struct StepCacheStats {
+    uint64_t hits = 0;                  // this process
+    uint64_t misses = 0;
+    uint64_t stores = 0;
+    uint64_t actions = 0;               // on disk
+    uint64_t blobs = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * Content-addressed cache of pipeline step results, like a build system's
+ * action cache.
+ *
+ * fingerprint() hashes everything a command step's result may depend on:
+ * the substituted command text, working directory, the values of declared
+ * environment variables, stdin and the content of declared input files
+ * (directories are walked recursively). Outputs are stored as SHA-256
+ * addressed blobs under <dir>/cas and the action record mapping a
+ * fingerprint to exit code and blob hashes under <dir>/ac, so identical
+ * outputs of different steps are stored once. Blobs are verified on read;
+ * a damaged entry is a miss. Writes go through a temp file and rename, so
+ * several processes can share a directory.
+ *
+ * File hashes are remembered by path, size and mtime, so unchanged inputs
+ * are not re-read; files modified within the last two seconds are always
+ * re-read because their mtime may not have ticked yet.
+ */
+class StepCache {
+public:
+    explicit StepCache(const std::string& dir);
+
+    StepCache(const StepCache&) = delete;
+    StepCache& operator=(const StepCache&) = delete;
+
+    // Relative input paths resolve against working_dir (or the current directory)
+    std::string fingerprint(const std::string& command, const std::string& working_dir,
+                            const std::vector<std::string>& env, const std::string& stdin_data,
+                            const std::vector<std::string>& inputs);
+
+    // Marks the entry as recently used
+    std::optional<StepCacheEntry> lookup(const std::string& key);
+    bool store(const std::string& key, const StepCacheEntry& entry);
+
+    // Evict least recently used actions until the store fits max_bytes, then
+    // drop unreferenced blobs; returns the number of actions evicted
+    size_t prune(uint64_t max_bytes);
+    void clear();
+
+    StepCacheStats stats() const;
+    const std::string& dir() const { return dir_; }
+
+private:
+    struct FileHash {
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+        std::string digest;
+    };
+
+    void hash_input(Sha256& hash, const std::filesystem::path& path, const std::string& label);
+    std::string file_digest(const std::filesystem::path& path, uint64_t size, int64_t mtime_ns);
+    std::filesystem::path action_path(const std::string& key) const;
+    std::filesystem::path blob_path(const std::string& digest) const;
+    std::optional<std::string> read_blob(const std::string& digest) const;
+    std::string write_blob(const std::string& data);
+    bool write_atomic(const std::filesystem::path& path, const std::string& data);
+
+    std::string dir_;
+    uint64_t temp_nonce_;               // keeps temp names unique across processes sharing dir_
+    mutable std::mutex mutex_;          // guards file_hashes_
+    std::unordered_map<std::string, FileHash> file_hashes_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> stores_{0};
+    std::atomic<uint64_t> temp_counter_{0};
+};
+
+} // namespace isaac
@@ -0,0 +1,462 @@
+#include "command_queue.hpp"
+#include "core/file_io.hpp"
+#include "core/mapped_file.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kCheckpointMagic[8] = {'I', 'S', 'A', 'A', 'C', 'C', 'Q', '1'};
+
+enum RecordType : uint8_t { EnqueueRecord = 1, StateRecord = 2, RemoveRecord = 3 };
+
+const char* const kStatusNames[] = {"pending", "syncing", "done", "failed"};
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Same shape as Python's datetime.utcnow().isoformat(), always with microseconds
+std::string format_iso(int64_t us) {
+    std::time_t seconds = static_cast<std::time_t>(us / 1000000);
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &seconds);
+#else
+    gmtime_r(&seconds, &tm);
+#endif
+    char buffer[40];
+    size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm);
+    std::snprintf(buffer + n, sizeof(buffer) - n, ".%06lld", static_cast<long long>(us % 1000000));
+    return buffer;
+}
+
+std::string as_string(const std::vector<uint8_t>& bytes) {
+    return std::string(bytes.begin(), bytes.end());
+}
+
+} // namespace
+
+// Holds the in-process state mutex and the directory lock, with every record
+// other processes appended applied
+class CommandQueue::Locked {
+public:
+    explicit Locked(CommandQueue& queue) : local_(queue.state_mutex_), shared_(queue.file_lock_) { queue.catch_up(); }
+
+private:
+    std::lock_guard<std::mutex> local_;
+    std::lock_guard<FileLock> shared_;
+};
+
+CommandQueue::CommandQueue(std::string dir, CommandQueueOptions options)
+    : dir_(std::move(dir)),
+      options_(options),
+      log_((fs::path(dir_) / "log").string(), SegmentLogOptions{options.segment_bytes, options.sync, true}),
+      file_lock_(fs::path(dir_) / "lock"),
+      open_lock_(fs::path(dir_) / "open"),
+      ready_(options.ring_capacity) {
+    std::lock_guard<FileLock> shared(file_lock_);
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    log_.refresh();
+    // Every opener checks under file_lock_, so two cannot both find themselves alone
+    const bool alone = open_lock_.try_lock();
+    if (alone) open_lock_.unlock();
+    open_lock_.lock_shared();
+    recover(alone);
+    if (ready_.size() > 0) wake_.notify();
+}
+
+uint64_t CommandQueue::enqueue(const std::string& command, const std::string& command_type,
+                               const std::optional<std::string>& target_device, const std::string& metadata) {
+    uint64_t id;
+    {
+        Locked lock(*this);
+        id = next_id_++;
+        Entry entry;
+        entry.id = id;
+        entry.queued_us = now_us();
+        entry.command_type = command_type;
+        entry.command_text = command;
+        entry.target_device = target_device;
+        entry.metadata = metadata;
+
+        std::vector<uint8_t> record{EnqueueRecord};
+        varint_encode(record, id);
+        varint_encode(record, zigzag_encode(entry.queued_us));
+        put_string(record, command_type);
+        put_string(record, command);
+        put_optional(record, target_device);
+        put_string(record, metadata);
+        const uint64_t lsn = log_.write(as_string(record));
+        ++records_since_checkpoint_;
+        entries_.emplace(id, std::move(entry));
+        // Published under the lock so the ring stays in id (FIFO) order
+        push_ready(id);
+        commit(lsn);
+    }
+    wake_.notify();
+    return id;
+}
+
+std::vector<QueuedCommand> CommandQueue::dequeue_pending(size_t limit) {
+    std::vector<QueuedCommand> claimed;
+    {
+        uint64_t id, lsn = 0;
+        Locked lock(*this);
+        const int64_t now = now_us();
+        while (claimed.size() < limit && pop_ready(id)) {
+            auto it = entries_.find(id);
+            if (it == entries_.end() || it->second.status != Pending) continue;  // cleared or already claimed
+            it->second.status = Syncing;
+            it->second.last_retry_us = now;
+            lsn = log_state(it->second);
+            claimed.push_back(to_command(it->second));
+        }
+        if (lsn) commit(lsn);
+    }
+    std::sort(claimed.begin(), claimed.end(),
+              [](const QueuedCommand& a, const QueuedCommand& b) { return a.id < b.id; });
+    return claimed;
+}
+
+std::vector<QueuedCommand> CommandQueue::list_pending(size_t limit) {
+    std::vector<QueuedCommand> pending;
+    Locked lock(*this);
+    for (auto it = entries_.begin(); it != entries_.end() && pending.size() < limit; ++it) {
+        if (it->second.status == Pending) pending.push_back(to_command(it->second));
+    }
+    return pending;
+}
+
+void CommandQueue::mark_syncing(uint64_t id) {
+    update(id, Syncing, nullptr);
+}
+
+void CommandQueue::mark_done(uint64_t id) {
+    update(id, Done, nullptr);
+}
+
+void CommandQueue::mark_failed(uint64_t id, const std::string& error) {
+    update(id, Failed, &error);
+}
+
+size_t CommandQueue::reset_stale_syncing(int timeout_minutes) {
+    size_t reset = 0;
+    {
+        uint64_t lsn = 0;
+        Locked lock(*this);
+        const int64_t cutoff = now_us() - int64_t(timeout_minutes) * 60 * 1000000;
+        for (auto& [id, entry] : entries_) {
+            if (entry.status == Syncing && entry.last_retry_us < cutoff) {
+                entry.status = Pending;
+                lsn = log_state(entry);
+                push_ready(id);
+                ++reset;
+            }
+        }
+        if (lsn) commit(lsn);
+    }
+    if (reset) wake_.notify();
+    return reset;
+}
+
+size_t CommandQueue::clear_old_entries(int days) {
+    size_t removed = 0;
+    uint64_t lsn = 0;
+    Locked lock(*this);
+    const int64_t cutoff = now_us() - int64_t(days) * 86400 * 1000000;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.status == Done && it->second.queued_us < cutoff) {
+            std::vector<uint8_t> record{RemoveRecord};
+            varint_encode(record, it->first);
+            lsn = log_.write(as_string(record));
+            ++records_since_checkpoint_;
+            it = entries_.erase(it);
+            ++removed;
+        } else {
+            ++it;
+        }
+    }
+    if (lsn) commit(lsn);
+    return removed;
+}
+
+std::optional<QueuedCommand> CommandQueue::get(uint64_t id) {
+    Locked lock(*this);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return std::nullopt;
+    return to_command(it->second);
+}
+
+CommandQueueStatus CommandQueue::status() {
+    Locked lock(*this);
+    CommandQueueStatus status;
+    int64_t last_sync = 0;
+    for (const auto& [id, entry] : entries_) {
+        switch (entry.status) {
+            case Pending: ++status.pending; break;
+            case Syncing: ++status.syncing; break;
+            case Failed: ++status.failed; break;
+            case Done:
+                ++status.done;
+                last_sync = std::max(last_sync, entry.queued_us);
+                break;
+        }
+    }
+    if (status.done) status.last_sync = format_iso(last_sync);
+    return status;
+}
+
+size_t CommandQueue::size() {
+    Locked lock(*this);
+    return entries_.size();
+}
+
+bool CommandQueue::wait(int timeout_ms) {
+    // Only new signals count: commands already pending must not turn the
+    // consumer's idle wait into a busy loop while it cannot deliver them
+    return wake_.wait(timeout_ms);
+}
+
+void CommandQueue::notify() {
+    wake_.notify();
+}
+
+void CommandQueue::checkpoint() {
+    Locked lock(*this);
+    write_checkpoint();
+}
+
+void CommandQueue::write_checkpoint() {
+    // The log is synced up to applied_ and no process can append until we let go
+    std::vector<uint8_t> snapshot(std::begin(kCheckpointMagic), std::end(kCheckpointMagic));
+    const LogPosition position = applied_;
+    varint_encode(snapshot, position.segment);
+    varint_encode(snapshot, position.offset);
+    varint_encode(snapshot, next_id_);
+    varint_encode(snapshot, entries_.size());
+    for (const auto& [id, entry] : entries_) {
+        varint_encode(snapshot, id);
+        varint_encode(snapshot, zigzag_encode(entry.queued_us));
+        put_string(snapshot, entry.command_type);
+        put_string(snapshot, entry.command_text);
+        put_optional(snapshot, entry.target_device);
+        put_string(snapshot, entry.metadata);
+        snapshot.push_back(entry.status);
+        varint_encode(snapshot, static_cast<uint64_t>(entry.retry_count));
+        varint_encode(snapshot, zigzag_encode(entry.last_retry_us));
+        put_optional(snapshot, entry.error_message);
+    }
+    records_since_checkpoint_ = 0;
+
+    const std::string path = checkpoint_path();
+    if (!write_file_synced(path + ".tmp", as_string(snapshot))) {
+        throw std::runtime_error("cannot write queue checkpoint: " + path);
+    }
+    std::error_code ec;
+    fs::rename(path + ".tmp", path, ec);
+    if (ec) {
+        throw std::runtime_error("cannot write queue checkpoint: " + path);
+    }
+    sync_directory(dir_);
+    log_.drop_before(position.segment);
+}
+
+// Load the checkpoint and replay the log after it; caller holds state_mutex_ and file_lock_
+void CommandQueue::recover(bool release_claims) {
+    entries_.clear();
+    next_id_ = 1;
+    uint64_t id;
+    while (pop_ready(id)) {
+    }
+
+    LogPosition from{0, 0};
+    MappedFile file;
+    if (file.open(checkpoint_path()) && file.size() >= sizeof(kCheckpointMagic) &&
+        std::memcmp(file.data(), kCheckpointMagic, sizeof(kCheckpointMagic)) == 0) {
+        VarintReader reader(file.view().substr(sizeof(kCheckpointMagic)));
+        uint64_t count = 0;
+        bool ok = reader.number(from.segment) && reader.number(from.offset) && reader.number(next_id_) &&
+                  reader.number(count);
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            Entry entry;
+            uint8_t status = Pending;
+            uint64_t retry = 0;
+            ok = reader.number(entry.id) && reader.signed_number(entry.queued_us) &&
+                 reader.string(entry.command_type) && reader.string(entry.command_text) &&
+                 reader.optional(entry.target_device) && reader.string(entry.metadata) && reader.byte(status) &&
+                 reader.number(retry) && reader.signed_number(entry.last_retry_us) &&
+                 reader.optional(entry.error_message);
+            if (!ok) break;
+            entry.status = std::min<uint8_t>(status, Failed);
+            entry.retry_count = static_cast<int>(retry);
+            entries_.emplace(entry.id, std::move(entry));
+        }
+        if (!ok) {
+            throw std::runtime_error("corrupt queue checkpoint: " + checkpoint_path());
+        }
+    }
+
+    log_.replay(from, [this, &id](std::string_view record) { apply_record(record, id); });
+    applied_ = log_.end();
+
+    // Claims die with the process that made them; while another process has
+    // the queue open they may still be its own, and wait for reset_stale_syncing()
+    uint64_t lsn = 0;
+    for (auto& [entry_id, entry] : entries_) {
+        if (release_claims && entry.status == Syncing) {
+            entry.status = Pending;
+            lsn = log_state(entry);
+        }
+        next_id_ = std::max(next_id_, entry_id + 1);
+    }
+    if (lsn) commit(lsn);
+    for (const auto& [entry_id, entry] : entries_) {
+        if (entry.status == Pending) push_ready(entry_id);
+    }
+}
+
+// Apply what other processes appended since our last call; caller holds state_mutex_ and file_lock_
+void CommandQueue::catch_up() {
+    log_.refresh();
+    const LogPosition end = log_.end();
+    const std::vector<uint64_t> segments = log_.segments();
+    if (!segments.empty() && applied_.segment < segments.front()) {
+        // Someone checkpointed past us and dropped segments we never read
+        recover(false);
+        return;
+    }
+    if (end.segment == applied_.segment && end.offset == applied_.offset) return;
+    log_.replay(applied_, [this](std::string_view record) {
+        // New commands and released claims become ready here too; ids that
+        // are claimed or removed by the time they are popped get skipped
+        uint64_t id;
+        if (!apply_record(record, id)) return;
+        auto it = entries_.find(id);
+        if (it != entries_.end() && it->second.status == Pending) push_ready(id);
+    });
+    applied_ = end;
+}
+
+bool CommandQueue::apply_record(std::string_view record, uint64_t& id) {
+    VarintReader reader(record);
+    uint8_t type;
+    if (!reader.byte(type) || !reader.number(id)) return false;
+
+    if (type == EnqueueRecord) {
+        Entry entry;
+        entry.id = id;
+        if (!reader.signed_number(entry.queued_us) || !reader.string(entry.command_type) ||
+            !reader.string(entry.command_text) || !reader.optional(entry.target_device) ||
+            !reader.string(entry.metadata)) {
+            return false;
+        }
+        entries_[id] = std::move(entry);
+        next_id_ = std::max(next_id_, id + 1);
+    } else if (type == StateRecord) {
+        uint8_t status;
+        uint64_t retry;
+        int64_t last_retry_us;
+        std::optional<std::string> error;
+        if (!reader.byte(status) || !reader.number(retry) || !reader.signed_number(last_retry_us) ||
+            !reader.optional(error)) {
+            return false;
+        }
+        auto it = entries_.find(id);
+        if (it == entries_.end()) return false;
+        it->second.status = std::min<uint8_t>(status, Failed);
+        it->second.retry_count = static_cast<int>(retry);
+        it->second.last_retry_us = last_retry_us;
+        it->second.error_message = std::move(error);
+    } else if (type == RemoveRecord) {
+        entries_.erase(id);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+uint64_t CommandQueue::log_state(const Entry& entry) {
+    std::vector<uint8_t> record{StateRecord};
+    varint_encode(record, entry.id);
+    record.push_back(entry.status);
+    varint_encode(record, static_cast<uint64_t>(entry.retry_count));
+    varint_encode(record, zigzag_encode(entry.last_retry_us));
+    put_optional(record, entry.error_message);
+    ++records_since_checkpoint_;
+    return log_.write(as_string(record));
+}
+
+void CommandQueue::update(uint64_t id, uint8_t status, const std::string* error) {
+    Locked lock(*this);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return;
+    Entry& entry = it->second;
+    entry.status = status;
+    if (status == Syncing || status == Failed) entry.last_retry_us = now_us();
+    if (error) {
+        entry.error_message = *error;
+        ++entry.retry_count;
+    }
+    commit(log_state(entry));
+}
+
+// Records must be durable before the directory lock is released, or another
+// process could append ahead of them and miss them in its catch-up
+void CommandQueue::commit(uint64_t lsn) {
+    log_.sync(lsn);
+    applied_ = log_.end();
+    if (records_since_checkpoint_ >= options_.checkpoint_records) write_checkpoint();
+}
+
+void CommandQueue::push_ready(uint64_t id) {
+    // Once anything overflowed, keep appending there so consumers see FIFO order
+    if (has_overflow_.load(std::memory_order_acquire) || !ready_.try_push(id)) {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        overflow_.push_back(id);
+        has_overflow_.store(true, std::memory_order_release);
+    }
+}
+
+bool CommandQueue::pop_ready(uint64_t& id) {
+    if (ready_.try_pop(id)) return true;
+    if (!has_overflow_.load(std::memory_order_acquire)) return false;
+
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    while (!overflow_.empty() && ready_.try_push(overflow_.front())) overflow_.pop_front();
+    has_overflow_.store(!overflow_.empty(), std::memory_order_release);
+    return ready_.try_pop(id);
+}
+
+QueuedCommand CommandQueue::to_command(const Entry& entry) const {
+    QueuedCommand command;
+    command.id = entry.id;
+    command.queued_at = format_iso(entry.queued_us);
+    command.command_type = entry.command_type;
+    command.command_text = entry.command_text;
+    command.target_device = entry.target_device;
+    command.retry_count = entry.retry_count;
+    if (entry.last_retry_us) command.last_retry_at = format_iso(entry.last_retry_us);
+    command.status = kStatusNames[entry.status];
+    command.error_message = entry.error_message;
+    command.metadata = entry.metadata;
+    return command;
+}
+
+std::string CommandQueue::checkpoint_path() const {
+    return (fs::path(dir_) / "checkpoint").string();
+}
+
+} // namespace isaac
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "core/file_io.hpp"
+#include "core/wake_signal.hpp"
+#include "mpmc_ring.hpp"
+#include "segment_log.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace isaac {
+
+// One queued command, in the row shape of the SQLite command_queue table
+struct QueuedCommand {
+    uint64_t id = 0;
+    std::string queued_at;                      // ISO 8601 UTC
+    std::string command_type;                   // "meta", "shell" or "device_route"
+    std::string command_text;
+    std::optional<std::string> target_device;
+    int retry_count = 0;
+    std::optional<std::string> last_retry_at;
+    std::string status;                         // "pending", "syncing", "done" or "failed"
+    std::optional<std::string> error_message;
+    std::string metadata;                       // JSON text
+};
+
+struct CommandQueueStatus {
+    size_t pending = 0;
+    size_t syncing = 0;
+    size_t failed = 0;
+    size_t done = 0;
+    std::optional<std::string> last_sync;       // newest queued_at among done commands
+};
+
+struct CommandQueueOptions {
+    size_t segment_bytes = 1 << 20;
+    bool sync = true;
+    size_t ring_capacity = 4096;                // power of two
+    size_t checkpoint_records = 4096;           // log records between automatic checkpoints
+};
+
+/**
+ * Durable offline command queue.
+ *
+ * Every mutation is applied in memory and appended to a SegmentLog; callers
+ * return once their record is group-committed, so concurrent producers share
+ * fsyncs. Ready command ids flow to consumers through a lock-free MPMC ring
+ * (with a locked overflow list when it is full), and a WakeSignal (eventfd
+ * on Linux) wakes waiting consumers on enqueue or an explicit notify(), e.g.
+ * when connectivity returns.
+ *
+ * A checkpoint stores the full queue state plus the log position it covers;
+ * recovery loads it and replays the log from there, and segments before the
+ * checkpoint are deleted. dequeue_pending() claims what it returns (status
+ * "syncing").
+ *
+ * Several processes open the same directory (the shell and every command
+ * subprocess with a SessionManager). As in MessageStore, every call takes an
+ * flock on <dir>/lock, applies what the others appended since its last call
+ * (reloading the checkpoint when one of them cut the log past it) and syncs
+ * its own records before letting go, so ids, claims and state changes agree
+ * across processes. Group commit then batches the records of one call;
+ * wakeups stay within the process. Each open queue also holds <dir>/open
+ * shared: claims left by a crashed process go back to pending on open only
+ * when no other process has the queue open, and otherwise through
+ * reset_stale_syncing().
+ */
+class CommandQueue {
+public:
+    explicit CommandQueue(std::string dir, CommandQueueOptions options = {});
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    uint64_t enqueue(const std::string& command, const std::string& command_type,
+                     const std::optional<std::string>& target_device, const std::string& metadata);
+
+    // Claim up to limit pending commands in FIFO order
+    std::vector<QueuedCommand> dequeue_pending(size_t limit = 10);
+    // The same commands without claiming them, for display
+    std::vector<QueuedCommand> list_pending(size_t limit = 10);
+
+    // Unknown ids are ignored, like an UPDATE matching no rows
+    void mark_syncing(uint64_t id);
+    void mark_done(uint64_t id);
+    void mark_failed(uint64_t id, const std::string& error);
+    size_t reset_stale_syncing(int timeout_minutes = 5);
+    size_t clear_old_entries(int days = 7);
+
+    std::optional<QueuedCommand> get(uint64_t id);
+    CommandQueueStatus status();
+    size_t size();
+
+    // Block until the next enqueue or notify(); false on timeout
+    bool wait(int timeout_ms);
+    void notify();
+    int wake_fd() const { return wake_.fd(); }
+
+    // Snapshot state and drop covered log segments
+    void checkpoint();
+    uint64_t sync_count() const { return log_.sync_count(); }
+
+private:
+    enum Status : uint8_t { Pending, Syncing, Done, Failed };
+
+    struct Entry {
+        uint64_t id = 0;
+        int64_t queued_us = 0;
+        std::string command_type;
+        std::string command_text;
+        std::optional<std::string> target_device;
+        int retry_count = 0;
+        int64_t last_retry_us = 0;              // 0 = never
+        uint8_t status = Pending;
+        std::optional<std::string> error_message;
+        std::string metadata;
+    };
+
+    class Locked;                               // state_mutex_ + file_lock_, caught up
+
+    void recover(bool release_claims);
+    void catch_up();
+    bool apply_record(std::string_view record, uint64_t& id);
+    uint64_t log_state(const Entry& entry);     // caller holds Locked
+    void update(uint64_t id, uint8_t status, const std::string* error);
+    void commit(uint64_t lsn);                  // caller holds Locked
+    void write_checkpoint();                    // caller holds Locked
+    void push_ready(uint64_t id);               // caller holds state_mutex_ (keeps id order)
+    bool pop_ready(uint64_t& id);
+    QueuedCommand to_command(const Entry& entry) const;
+    std::string checkpoint_path() const;
+
+    std::string dir_;
+    CommandQueueOptions options_;
+    SegmentLog log_;
+    FileLock file_lock_;                        // <dir>/lock, shared with other processes
+    FileLock open_lock_;                        // <dir>/open, held shared while open
+
+    std::mutex state_mutex_;
+    std::map<uint64_t, Entry> entries_;         // ordered by id = FIFO order
+    uint64_t next_id_ = 1;
+    LogPosition applied_;                       // log end this map reflects
+    size_t records_since_checkpoint_ = 0;
+
+    MpmcRing<uint64_t> ready_;
+    std::mutex overflow_mutex_;
+    std::deque<uint64_t> overflow_;
+    std::atomic<bool> has_overflow_{false};
+    WakeSignal wake_;
+};
+
+} // namespace isaac
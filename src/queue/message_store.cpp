@@ -0,0 +1,424 @@
+#include "message_store.hpp"
+#include "core/file_io.hpp"
+#include "core/mapped_file.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'I', 'S', 'A', 'A', 'C', 'M', 'Q', '1'};
+
+enum RecordType : uint8_t { AddRecord = 1, AcknowledgeRecord = 2, RemoveRecord = 3 };
+
+const char* const kTypeNames[] = {"system", "code"};
+const char* const kPriorityNames[] = {"low", "normal", "high", "urgent"};
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Same shape as Python's datetime.now().isoformat(), always with microseconds
+std::string format_local_iso(int64_t us) {
+    std::time_t seconds = static_cast<std::time_t>(us / 1000000);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &seconds);
+#else
+    localtime_r(&seconds, &tm);
+#endif
+    char buffer[40];
+    size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm);
+    std::snprintf(buffer + n, sizeof(buffer) - n, ".%06lld", static_cast<long long>(us % 1000000));
+    return buffer;
+}
+
+template <size_t N>
+uint8_t code_of(const char* const (&names)[N], const std::string& name, const char* what) {
+    for (size_t i = 0; i < N; ++i) {
+        if (name == names[i]) return static_cast<uint8_t>(i);
+    }
+    throw std::invalid_argument(std::string("Unknown message ") + what + " '" + name + "'");
+}
+
+std::string as_string(const std::vector<uint8_t>& bytes) {
+    return std::string(bytes.begin(), bytes.end());
+}
+
+} // namespace
+
+class MessageStore::Locked {
+public:
+    explicit Locked(MessageStore& store) : local_(store.mutex_), shared_(store.file_lock_) { store.catch_up(); }
+
+private:
+    std::lock_guard<std::mutex> local_;
+    std::lock_guard<FileLock> shared_;
+};
+
+MessageStore::MessageStore(std::string dir, MessageStoreOptions options)
+    : dir_(std::move(dir)),
+      options_(options),
+      log_((fs::path(dir_) / "log").string(), SegmentLogOptions{options.segment_bytes, options.sync, true}),
+      file_lock_(fs::path(dir_) / "lock") {
+    std::lock_guard<FileLock> shared(file_lock_);
+    log_.refresh();
+    recover();
+}
+
+uint64_t MessageStore::add(const std::string& message_type, const std::string& priority, const std::string& title,
+                           const std::string& content, const std::optional<std::string>& metadata,
+                           int64_t created_us) {
+    Entry entry;
+    entry.type = code_of(kTypeNames, message_type, "type");
+    entry.priority = code_of(kPriorityNames, priority, "priority");
+    entry.created_us = created_us ? created_us : now_us();
+    entry.title = title;
+    entry.content = content;
+    entry.metadata = metadata;
+
+    Locked lock(*this);
+    const uint64_t id = next_id_++;
+    std::vector<uint8_t> record{AddRecord};
+    varint_encode(record, id);
+    varint_encode(record, zigzag_encode(entry.created_us));
+    record.push_back(entry.type);
+    record.push_back(entry.priority);
+    put_string(record, entry.title);
+    put_string(record, entry.content);
+    put_optional(record, entry.metadata);
+    const uint64_t lsn = log_.write(as_string(record));
+    ++records_since_compaction_;
+    count(entry, +1);
+    entries_.emplace(id, std::move(entry));
+    commit(lsn);
+    return id;
+}
+
+bool MessageStore::acknowledge(uint64_t id, int64_t acknowledged_us) {
+    Locked lock(*this);
+    auto it = entries_.find(id);
+    if (it == entries_.end() || it->second.acknowledged_us != 0) return false;
+    commit(log_acknowledge(id, acknowledged_us ? acknowledged_us : now_us()));
+    return true;
+}
+
+size_t MessageStore::acknowledge_all(const std::optional<std::string>& message_type) {
+    std::optional<uint8_t> type;
+    if (message_type) type = code_of(kTypeNames, *message_type, "type");
+
+    size_t acknowledged = 0;
+    uint64_t lsn = 0;
+    Locked lock(*this);
+    const int64_t now = now_us();
+    for (auto& [id, entry] : entries_) {
+        if (entry.acknowledged_us != 0 || (type && entry.type != *type)) continue;
+        lsn = log_acknowledge(id, now);
+        ++acknowledged;
+    }
+    if (lsn) commit(lsn);
+    return acknowledged;
+}
+
+bool MessageStore::remove(uint64_t id) {
+    Locked lock(*this);
+    if (entries_.find(id) == entries_.end()) return false;
+    commit(log_remove(id));
+    return true;
+}
+
+size_t MessageStore::clear(const std::optional<std::string>& message_type, const std::optional<std::string>& status) {
+    std::optional<uint8_t> type;
+    if (message_type) type = code_of(kTypeNames, *message_type, "type");
+    if (status && *status != "pending" && *status != "acknowledged") return 0;  // matches no rows
+
+    std::vector<uint64_t> doomed;
+    uint64_t lsn = 0;
+    Locked lock(*this);
+    for (const auto& [id, entry] : entries_) {
+        if (type && entry.type != *type) continue;
+        if (status && (*status == "pending") != (entry.acknowledged_us == 0)) continue;
+        doomed.push_back(id);
+    }
+    for (uint64_t id : doomed) lsn = log_remove(id);
+    if (lsn) commit(lsn);
+    return doomed.size();
+}
+
+size_t MessageStore::cleanup(int days) {
+    std::vector<uint64_t> doomed;
+    uint64_t lsn = 0;
+    Locked lock(*this);
+    const int64_t cutoff = now_us() - int64_t(days) * 86400 * 1000000;
+    for (const auto& [id, entry] : entries_) {
+        if (entry.acknowledged_us != 0 && entry.acknowledged_us < cutoff) doomed.push_back(id);
+    }
+    for (uint64_t id : doomed) lsn = log_remove(id);
+    if (lsn) commit(lsn);
+    return doomed.size();
+}
+
+std::vector<StoredMessage> MessageStore::list(const std::optional<std::string>& message_type,
+                                              const std::string& status, size_t limit) {
+    std::optional<uint8_t> type;
+    if (message_type) type = code_of(kTypeNames, *message_type, "type");
+    if (status != "all" && status != "pending" && status != "acknowledged") return {};
+
+    Locked lock(*this);
+    std::vector<const std::pair<const uint64_t, Entry>*> matches;
+    for (const auto& item : entries_) {
+        const Entry& entry = item.second;
+        if (type && entry.type != *type) continue;
+        if (status != "all" && (status == "pending") != (entry.acknowledged_us == 0)) continue;
+        matches.push_back(&item);
+    }
+
+    auto newer = [](auto* a, auto* b) {
+        if (a->second.created_us != b->second.created_us) return a->second.created_us > b->second.created_us;
+        return a->first > b->first;
+    };
+    size_t keep = std::min(limit, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + keep, matches.end(), newer);
+
+    std::vector<StoredMessage> result;
+    result.reserve(keep);
+    for (size_t i = 0; i < keep; ++i) result.push_back(to_message(matches[i]->first, matches[i]->second));
+    return result;
+}
+
+std::optional<StoredMessage> MessageStore::get(uint64_t id) {
+    Locked lock(*this);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return std::nullopt;
+    return to_message(id, it->second);
+}
+
+uint64_t MessageStore::pending(const std::string& message_type, const std::optional<std::string>& priority) {
+    uint8_t type = code_of(kTypeNames, message_type, "type");
+    std::optional<uint8_t> level;
+    if (priority) level = code_of(kPriorityNames, *priority, "priority");
+
+    Locked lock(*this);
+    if (level) {
+        return pending_[type][*level].load(std::memory_order_relaxed);
+    }
+    uint64_t total = 0;
+    for (const auto& counter : pending_[type]) total += counter.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t MessageStore::pending_total() {
+    Locked lock(*this);
+    return pending_total_.load(std::memory_order_relaxed);
+}
+
+size_t MessageStore::size() {
+    Locked lock(*this);
+    return entries_.size();
+}
+
+void MessageStore::compact() {
+    Locked lock(*this);
+    write_snapshot();
+}
+
+void MessageStore::write_snapshot() {
+    // The log is synced up to applied_ and no process can append until we let go
+    std::vector<uint8_t> snapshot(std::begin(kSnapshotMagic), std::end(kSnapshotMagic));
+    const LogPosition position = applied_;
+    varint_encode(snapshot, position.segment);
+    varint_encode(snapshot, position.offset);
+    varint_encode(snapshot, next_id_);
+    varint_encode(snapshot, entries_.size());
+    for (const auto& [id, entry] : entries_) {
+        varint_encode(snapshot, id);
+        varint_encode(snapshot, zigzag_encode(entry.created_us));
+        snapshot.push_back(entry.type);
+        snapshot.push_back(entry.priority);
+        put_string(snapshot, entry.title);
+        put_string(snapshot, entry.content);
+        put_optional(snapshot, entry.metadata);
+        varint_encode(snapshot, zigzag_encode(entry.acknowledged_us));
+    }
+    records_since_compaction_ = 0;
+
+    const std::string path = snapshot_path();
+    if (!write_file_synced(path + ".tmp", as_string(snapshot))) {
+        throw std::runtime_error("cannot write message snapshot: " + path);
+    }
+    std::error_code ec;
+    fs::rename(path + ".tmp", path, ec);
+    if (ec) {
+        throw std::runtime_error("cannot write message snapshot: " + path);
+    }
+    sync_directory(dir_);
+    log_.drop_before(position.segment);
+}
+
+// Load the snapshot and replay the log after it; caller holds file_lock_
+void MessageStore::recover() {
+    entries_.clear();
+    next_id_ = 1;
+    for (auto& row : pending_) {
+        for (auto& counter : row) counter.store(0, std::memory_order_relaxed);
+    }
+    pending_total_.store(0, std::memory_order_relaxed);
+
+    LogPosition from{0, 0};
+    MappedFile file;
+    if (file.open(snapshot_path()) && file.size() >= sizeof(kSnapshotMagic) &&
+        std::memcmp(file.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) == 0) {
+        VarintReader reader(file.view().substr(sizeof(kSnapshotMagic)));
+        uint64_t total;
+        bool ok = reader.number(from.segment) && reader.number(from.offset) && reader.number(next_id_) &&
+                  reader.number(total);
+        for (uint64_t i = 0; ok && i < total; ++i) {
+            uint64_t id;
+            Entry entry;
+            ok = reader.number(id) && reader.signed_number(entry.created_us) && reader.byte(entry.type) &&
+                 reader.byte(entry.priority) && reader.string(entry.title) && reader.string(entry.content) &&
+                 reader.optional(entry.metadata) && reader.signed_number(entry.acknowledged_us) &&
+                 entry.type < kTypes && entry.priority < kPriorities;
+            if (ok) {
+                count(entry, +1);
+                entries_.emplace(id, std::move(entry));
+            }
+        }
+        if (!ok) {
+            throw std::runtime_error("corrupt message snapshot: " + snapshot_path());
+        }
+    }
+
+    log_.replay(from, [this](std::string_view record) { apply_record(record); });
+
+    for (const auto& item : entries_) next_id_ = std::max(next_id_, item.first + 1);
+    applied_ = log_.end();
+}
+
+// Apply what other processes appended since our last call; caller holds mutex_ and file_lock_
+void MessageStore::catch_up() {
+    log_.refresh();
+    const LogPosition end = log_.end();
+    const std::vector<uint64_t> segments = log_.segments();
+    if (!segments.empty() && applied_.segment < segments.front()) {
+        // Someone compacted past us and dropped segments we never read
+        recover();
+        return;
+    }
+    if (end.segment == applied_.segment && end.offset == applied_.offset) return;
+    log_.replay(applied_, [this](std::string_view record) { apply_record(record); });
+    applied_ = end;
+}
+
+bool MessageStore::apply_record(std::string_view record) {
+    VarintReader reader(record);
+    uint8_t type;
+    uint64_t id;
+    if (!reader.byte(type) || !reader.number(id)) return false;
+
+    if (type == AddRecord) {
+        Entry entry;
+        if (!reader.signed_number(entry.created_us) || !reader.byte(entry.type) || !reader.byte(entry.priority) ||
+            !reader.string(entry.title) || !reader.string(entry.content) || !reader.optional(entry.metadata) ||
+            entry.type >= kTypes || entry.priority >= kPriorities) {
+            return false;
+        }
+        auto it = entries_.find(id);
+        if (it != entries_.end()) {
+            count(it->second, -1);
+            entries_.erase(it);
+        }
+        count(entry, +1);
+        entries_.emplace(id, std::move(entry));
+        next_id_ = std::max(next_id_, id + 1);
+    } else if (type == AcknowledgeRecord) {
+        int64_t at_us;
+        if (!reader.signed_number(at_us)) return false;
+        auto it = entries_.find(id);
+        if (it == entries_.end()) return false;
+        count(it->second, -1);
+        it->second.acknowledged_us = at_us;
+        count(it->second, +1);
+    } else if (type == RemoveRecord) {
+        auto it = entries_.find(id);
+        if (it == entries_.end()) return false;
+        count(it->second, -1);
+        entries_.erase(it);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+uint64_t MessageStore::log_acknowledge(uint64_t id, int64_t at_us) {
+    Entry& entry = entries_.at(id);
+    count(entry, -1);
+    entry.acknowledged_us = at_us;
+
+    std::vector<uint8_t> record{AcknowledgeRecord};
+    varint_encode(record, id);
+    varint_encode(record, zigzag_encode(at_us));
+    ++records_since_compaction_;
+    return log_.write(as_string(record));
+}
+
+uint64_t MessageStore::log_remove(uint64_t id) {
+    auto it = entries_.find(id);
+    count(it->second, -1);
+    entries_.erase(it);
+
+    std::vector<uint8_t> record{RemoveRecord};
+    varint_encode(record, id);
+    ++records_since_compaction_;
+    return log_.write(as_string(record));
+}
+
+void MessageStore::count(const Entry& entry, int delta) {
+    if (entry.acknowledged_us != 0) return;
+    if (delta > 0) {
+        pending_[entry.type][entry.priority].fetch_add(1, std::memory_order_relaxed);
+        pending_total_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        pending_[entry.type][entry.priority].fetch_sub(1, std::memory_order_relaxed);
+        pending_total_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+// Records must be durable before the directory lock is released, or another
+// process could append ahead of them and miss them in its catch-up
+void MessageStore::commit(uint64_t lsn) {
+    log_.sync(lsn);
+    applied_ = log_.end();
+    if (records_since_compaction_ >= options_.compact_records) write_snapshot();
+}
+
+StoredMessage MessageStore::to_message(uint64_t id, const Entry& entry) const {
+    StoredMessage message;
+    message.id = id;
+    message.created_at = format_local_iso(entry.created_us);
+    message.message_type = kTypeNames[entry.type];
+    message.priority = kPriorityNames[entry.priority];
+    message.title = entry.title;
+    message.content = entry.content;
+    message.metadata = entry.metadata;
+    if (entry.acknowledged_us) message.acknowledged_at = format_local_iso(entry.acknowledged_us);
+    message.status = entry.acknowledged_us ? "acknowledged" : "pending";
+    return message;
+}
+
+std::string MessageStore::snapshot_path() const {
+    return (fs::path(dir_) / "snapshot").string();
+}
+
+} // namespace isaac
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "segment_log.hpp"
+#include "core/file_io.hpp"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace isaac {
+
+// One notification, in the row shape of the SQLite messages table
+struct StoredMessage {
+    uint64_t id = 0;
+    std::string created_at;                     // ISO 8601 local time
+    std::string message_type;                   // "system" or "code"
+    std::string priority;                       // "low", "normal", "high" or "urgent"
+    std::string title;
+    std::string content;
+    std::optional<std::string> metadata;        // JSON text
+    std::optional<std::string> acknowledged_at;
+    std::string status;                         // "pending" or "acknowledged"
+};
+
+struct MessageStoreOptions {
+    size_t segment_bytes = 1 << 20;
+    bool sync = true;
+    size_t compact_records = 4096;              // log records between automatic compactions
+};
+
+/**
+ * Durable notification store behind the prompt's message indicator.
+ *
+ * Messages live in memory and every mutation is appended to a SegmentLog
+ * (group-committed, replayed through mmap on open). Compaction snapshots the
+ * live messages and drops the segments the snapshot covers, so acknowledged
+ * and deleted messages stop costing replay time.
+ *
+ * Several processes open the same directory (the shell, the monitors and
+ * dispatched subprocesses each hold a store). Every call takes an flock on
+ * <dir>/lock, applies what the others appended since its last call (or
+ * reloads the snapshot when one of them compacted past it) and syncs its
+ * own records before letting go, so ids, acknowledgements and compaction
+ * agree across processes.
+ *
+ * Pending counts per type and priority are counters kept next to the map,
+ * so when no other process wrote, pending() and pending_total() cost the
+ * lock and a stat of the log tail - no parsing - which is what the prompt
+ * renders on every line.
+ */
+class MessageStore {
+public:
+    explicit MessageStore(std::string dir, MessageStoreOptions options = {});
+
+    MessageStore(const MessageStore&) = delete;
+    MessageStore& operator=(const MessageStore&) = delete;
+
+    // Throws std::invalid_argument for an unknown type or priority.
+    // created_us = 0 means now (other values are for migrating old messages).
+    uint64_t add(const std::string& message_type, const std::string& priority, const std::string& title,
+                 const std::string& content, const std::optional<std::string>& metadata, int64_t created_us = 0);
+
+    // acknowledged_us = 0 means now; false if the message is unknown or not pending
+    bool acknowledge(uint64_t id, int64_t acknowledged_us = 0);
+    size_t acknowledge_all(const std::optional<std::string>& message_type = std::nullopt);
+
+    bool remove(uint64_t id);
+    // Delete by type and/or status; nullopt matches everything
+    size_t clear(const std::optional<std::string>& message_type = std::nullopt,
+                 const std::optional<std::string>& status = std::nullopt);
+    // Delete acknowledged messages acknowledged more than `days` ago
+    size_t cleanup(int days = 30);
+
+    // Newest first; status "pending", "acknowledged" or "all"
+    std::vector<StoredMessage> list(const std::optional<std::string>& message_type = std::nullopt,
+                                    const std::string& status = "pending", size_t limit = 50);
+    std::optional<StoredMessage> get(uint64_t id);
+
+    // Priority nullopt sums all priorities
+    uint64_t pending(const std::string& message_type, const std::optional<std::string>& priority = std::nullopt);
+    uint64_t pending_total();
+
+    // Snapshot live messages and drop covered log segments
+    void compact();
+    size_t size();
+    uint64_t sync_count() const { return log_.sync_count(); }
+
+private:
+    static constexpr int kTypes = 2;
+    static constexpr int kPriorities = 4;
+
+    struct Entry {
+        int64_t created_us = 0;
+        uint8_t type = 0;
+        uint8_t priority = 0;
+        std::string title;
+        std::string content;
+        std::optional<std::string> metadata;
+        int64_t acknowledged_us = 0;            // 0 = pending
+    };
+
+    class Locked;                                           // mutex_ + file_lock_, caught up
+
+    void recover();
+    void catch_up();
+    bool apply_record(std::string_view record);
+    uint64_t log_acknowledge(uint64_t id, int64_t at_us);   // caller holds Locked
+    uint64_t log_remove(uint64_t id);                       // caller holds Locked
+    void count(const Entry& entry, int delta);
+    void commit(uint64_t lsn);                              // caller holds Locked
+    void write_snapshot();                                  // caller holds Locked
+    StoredMessage to_message(uint64_t id, const Entry& entry) const;
+    std::string snapshot_path() const;
+
+    std::string dir_;
+    MessageStoreOptions options_;
+    SegmentLog log_;
+    FileLock file_lock_;                        // <dir>/lock, shared with other processes
+
+    std::mutex mutex_;
+    std::map<uint64_t, Entry> entries_;         // ordered by id
+    uint64_t next_id_ = 1;
+    LogPosition applied_;                       // log end this map reflects
+    size_t records_since_compaction_ = 0;
+
+    std::atomic<uint64_t> pending_[kTypes][kPriorities] = {};
+    std::atomic<uint64_t> pending_total_{0};
+};
+
+} // namespace isaac
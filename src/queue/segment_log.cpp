@@ -0,0 +1,359 @@
+#include "segment_log.hpp"
+#include "core/crc32.hpp"
+#include "core/file_io.hpp"
+#include "core/mapped_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t kFrameHeader = 8;
+
+#ifdef _WIN32
+int open_append(const std::string& path) {
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, 0644);
+}
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        int written = ::_write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1 << 30)));
+        if (written < 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+bool sync_fd(int fd) { return ::_commit(fd) == 0; }
+void close_fd(int fd) { ::_close(fd); }
+#else
+int open_append(const std::string& path) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+}
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+bool sync_fd(int fd) {
+#ifdef __linux__
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+void close_fd(int fd) { ::close(fd); }
+#endif
+
+void put_u32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+uint32_t get_u32(const uint8_t* p) {
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+// The intact frame at offset, if any
+bool frame_at(const uint8_t* data, uint64_t size, uint64_t offset, std::string_view& payload) {
+    if (offset > size || size - offset < kFrameHeader) return false;
+    uint32_t length = get_u32(data + offset);
+    uint32_t checksum = get_u32(data + offset + 4);
+    if (length > size - offset - kFrameHeader) return false;
+    const uint8_t* bytes = data + offset + kFrameHeader;
+    if (crc32(bytes, length) != checksum) return false;
+    payload = std::string_view(reinterpret_cast<const char*>(bytes), length);
+    return true;
+}
+
+// Walk intact frames of one segment from offset; returns the end of the last intact frame
+uint64_t scan_frames(const uint8_t* data, uint64_t size, uint64_t offset,
+                     const std::function<void(uint64_t, std::string_view)>* visit) {
+    std::string_view payload;
+    while (frame_at(data, size, offset, payload)) {
+        if (visit) (*visit)(offset, payload);
+        offset += kFrameHeader + payload.size();
+    }
+    return offset;
+}
+
+bool parse_segment_name(const fs::path& path, uint64_t& segment) {
+    const std::string name = path.filename().string();
+    if (name.size() != 20 || name.compare(16, 4, ".log") != 0) return false;
+    segment = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        if (name[i] < '0' || name[i] > '9') return false;
+        segment = segment * 10 + static_cast<uint64_t>(name[i] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+SegmentLog::SegmentLog(std::string dir, SegmentLogOptions options)
+    : dir_(std::move(dir)), options_(options) {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (!fs::is_directory(dir_)) {
+        throw std::runtime_error("cannot create log directory: " + dir_);
+    }
+
+    auto existing = segments();
+    if (existing.empty()) {
+        segment_ = 1;
+        return;
+    }
+    if (options_.shared) {
+        // Another process may be mid-write; refresh() repairs the tail under the owner's lock
+        segment_ = existing.back();
+        return;
+    }
+
+    // Recover the tail: drop a torn or corrupt last record from a crash mid-write
+    segment_ = existing.back();
+    const std::string path = segment_path(segment_);
+    uint64_t valid = 0;
+    uint64_t file_size = fs::file_size(path, ec);
+    {
+        MappedFile file;
+        if (file.open(path)) valid = scan_frames(file.data(), file.size(), 0, nullptr);
+    }
+    if (valid != file_size) {
+        fs::resize_file(path, valid, ec);
+    }
+    segment_size_ = valid;
+}
+
+SegmentLog::~SegmentLog() {
+    try {
+        sync(last_lsn());
+    } catch (const std::exception&) {
+        // Already failed; nothing more to flush
+    }
+    if (fd_ >= 0) close_fd(fd_);
+}
+
+uint64_t SegmentLog::write(std::string_view record, LogPosition* at) {
+    if (record.size() > UINT32_MAX - kFrameHeader) {
+        throw std::invalid_argument("log record too large");
+    }
+    const uint64_t frame_size = kFrameHeader + record.size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (failed_) {
+        throw std::runtime_error("write-ahead log failed: " + dir_);
+    }
+    if (segment_size_ > 0 && segment_size_ + frame_size > options_.segment_bytes) {
+        ++segment_;
+        segment_size_ = 0;
+    }
+    if (pending_.empty() || pending_.back().segment != segment_) {
+        pending_.push_back(Chunk{segment_, {}});
+    }
+    if (at) *at = LogPosition{segment_, segment_size_};
+    std::string& bytes = pending_.back().bytes;
+    put_u32(bytes, static_cast<uint32_t>(record.size()));
+    put_u32(bytes, crc32(record.data(), record.size()));
+    bytes.append(record.data(), record.size());
+    segment_size_ += frame_size;
+    return ++written_lsn_;
+}
+
+void SegmentLog::sync(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (durable_lsn_ < lsn) {
+        if (failed_) {
+            throw std::runtime_error("write-ahead log failed: " + dir_);
+        }
+        if (flushing_) {
+            flushed_.wait(lock);
+            continue;
+        }
+
+        // Leader: take the whole batch, including records queued by other threads
+        flushing_ = true;
+        std::vector<Chunk> chunks;
+        chunks.swap(pending_);
+        const uint64_t target = written_lsn_;
+        lock.unlock();
+
+        bool ok = true;
+        try {
+            flush_chunks(chunks);
+        } catch (const std::exception&) {
+            ok = false;
+        }
+
+        lock.lock();
+        flushing_ = false;
+        if (ok) {
+            durable_lsn_ = target;
+            ++sync_count_;
+        } else {
+            failed_ = true;
+        }
+        flushed_.notify_all();
+    }
+}
+
+LogPosition SegmentLog::end() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return LogPosition{segment_, segment_size_};
+}
+
+uint64_t SegmentLog::last_lsn() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_lsn_;
+}
+
+void SegmentLog::replay(LogPosition from, const std::function<void(std::string_view)>& visit) const {
+    replay(from, [&visit](LogPosition, std::string_view record) { visit(record); });
+}
+
+void SegmentLog::replay(LogPosition from, const std::function<void(LogPosition, std::string_view)>& visit) const {
+    for (uint64_t segment : segments()) {
+        if (segment < from.segment) continue;
+        MappedFile file;
+        if (!file.open(segment_path(segment))) continue;
+        uint64_t offset = segment == from.segment ? from.offset : 0;
+        const std::function<void(uint64_t, std::string_view)> at_offset =
+            [&visit, segment](uint64_t frame, std::string_view record) { visit(LogPosition{segment, frame}, record); };
+        if (offset < file.size()) scan_frames(file.data(), file.size(), offset, &at_offset);
+    }
+}
+
+bool SegmentLog::read(LogPosition at, std::string& record) const {
+    MappedFile file;
+    std::string_view payload;
+    if (!file.open(segment_path(at.segment)) || !frame_at(file.data(), file.size(), at.offset, payload)) {
+        return false;
+    }
+    record.assign(payload);
+    return true;
+}
+
+void SegmentLog::roll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (segment_size_ > 0) {
+        ++segment_;
+        segment_size_ = 0;
+    }
+}
+
+void SegmentLog::refresh() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_.empty()) {
+        throw std::logic_error("refresh() with buffered records");
+    }
+    auto existing = segments();
+    if (existing.empty()) return;
+
+    // Frames before our own end are already known intact; only scan what others added
+    uint64_t from = existing.back() == segment_ ? segment_size_ : 0;
+    segment_ = existing.back();
+    const std::string path = segment_path(segment_);
+    std::error_code ec;
+    uint64_t file_size = fs::file_size(path, ec);
+    if (ec) {
+        segment_size_ = 0;
+        return;
+    }
+    if (from > file_size) from = 0;
+
+    uint64_t valid = from;
+    if (from < file_size) {
+        MappedFile file;
+        if (file.open(path)) valid = scan_frames(file.data(), file.size(), from, nullptr);
+    }
+    if (valid != file_size) {
+        fs::resize_file(path, valid, ec);
+    }
+    segment_size_ = valid;
+}
+
+void SegmentLog::drop_before(uint64_t segment) {
+    for (uint64_t existing : segments()) {
+        if (existing >= segment) break;
+        std::error_code ec;
+        fs::remove(segment_path(existing), ec);
+    }
+}
+
+std::vector<uint64_t> SegmentLog::segments() const {
+    std::vector<uint64_t> found;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir_, ec)) {
+        uint64_t segment;
+        if (entry.is_regular_file(ec) && parse_segment_name(entry.path(), segment)) found.push_back(segment);
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+uint64_t SegmentLog::size_bytes() const {
+    uint64_t total = 0;
+    for (uint64_t segment : segments()) {
+        std::error_code ec;
+        uint64_t size = fs::file_size(segment_path(segment), ec);
+        if (!ec) total += size;
+    }
+    return total;
+}
+
+uint64_t SegmentLog::sync_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sync_count_;
+}
+
+std::string SegmentLog::segment_path(uint64_t segment) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llu.log", static_cast<unsigned long long>(segment));
+    return (fs::path(dir_) / name).string();
+}
+
+bool SegmentLog::open_segment(uint64_t segment) {
+    const std::string path = segment_path(segment);
+    const bool created = !fs::exists(path);
+    fd_ = open_append(path);
+    fd_segment_ = segment;
+    if (fd_ >= 0 && created && options_.sync) sync_directory(dir_);
+    return fd_ >= 0;
+}
+
+void SegmentLog::flush_chunks(std::vector<Chunk>& chunks) {
+    for (const Chunk& chunk : chunks) {
+        if (fd_ < 0 || fd_segment_ != chunk.segment) {
+            if (fd_ >= 0) {
+                // A finished segment is synced before the next one starts
+                if (options_.sync && !sync_fd(fd_)) throw std::runtime_error("sync failed");
+                close_fd(fd_);
+                fd_ = -1;
+            }
+            if (!open_segment(chunk.segment)) throw std::runtime_error("cannot open log segment");
+        }
+        if (!write_all(fd_, chunk.bytes.data(), chunk.bytes.size())) throw std::runtime_error("write failed");
+    }
+    if (options_.sync && fd_ >= 0 && !sync_fd(fd_)) throw std::runtime_error("sync failed");
+}
+
+} // namespace isaac
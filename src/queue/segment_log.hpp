@@ -0,0 +1,110 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace isaac {
+
+struct LogPosition {
+    uint64_t segment = 0;
+    uint64_t offset = 0;
+};
+
+struct SegmentLogOptions {
+    size_t segment_bytes = 4 << 20;     // roll to a new segment past this size
+    bool sync = true;                   // fdatasync on commit (false: OS buffered)
+    bool shared = false;                // other processes append too; see refresh()
+};
+
+/**
+ * Append-only write-ahead log split into numbered segment files
+ * (<dir>/<segment>.log), with group commit.
+ *
+ * write() only frames the record into an in-memory batch and returns its
+ * sequence number; sync(lsn) makes everything up to it durable. The first
+ * thread to need a flush becomes the leader and writes + syncs the whole
+ * batch while later writers queue behind it, so N concurrent commits cost
+ * one fdatasync. Records are framed as [u32 length][u32 crc32][payload];
+ * opening the log truncates a torn or corrupt tail left by a crash.
+ *
+ * A shared log may be appended to by several processes. Its owner must
+ * serialize them with its own inter-process lock, call refresh() after
+ * taking it and sync everything it wrote before releasing it; the tail is
+ * then only repaired by refresh(), never by a process that does not hold
+ * the lock.
+ */
+class SegmentLog {
+public:
+    SegmentLog(std::string dir, SegmentLogOptions options = {});
+    ~SegmentLog();
+
+    SegmentLog(const SegmentLog&) = delete;
+    SegmentLog& operator=(const SegmentLog&) = delete;
+
+    // Buffer a record; returns its sequence number for sync(). at receives
+    // the record's position, readable with read() once it is synced.
+    uint64_t write(std::string_view record, LogPosition* at = nullptr);
+    // Block until records up to lsn are written (and synced if options.sync)
+    void sync(uint64_t lsn);
+    void append(std::string_view record) { sync(write(record)); }
+
+    // Position just past the last buffered record (where the next one goes)
+    LogPosition end() const;
+    uint64_t last_lsn() const;
+
+    // Visit every intact record at or after from, in order
+    void replay(LogPosition from, const std::function<void(std::string_view)>& visit) const;
+    void replay(LogPosition from, const std::function<void(LogPosition, std::string_view)>& visit) const;
+
+    // Read one synced record; false if it is missing or corrupt
+    bool read(LogPosition at, std::string& record) const;
+
+    // Start a new segment with the next write, so older ones can be dropped whole
+    void roll();
+
+    // Shared logs: adopt what other processes appended (newest segment, its
+    // size) and truncate a torn tail there. Nothing may be buffered.
+    void refresh();
+
+    // Delete segments older than segment (after a checkpoint covers them)
+    void drop_before(uint64_t segment);
+
+    std::vector<uint64_t> segments() const;
+    uint64_t size_bytes() const;
+    uint64_t sync_count() const;
+
+private:
+    struct Chunk {
+        uint64_t segment;
+        std::string bytes;
+    };
+
+    std::string segment_path(uint64_t segment) const;
+    bool open_segment(uint64_t segment);
+    void flush_chunks(std::vector<Chunk>& chunks);
+
+    std::string dir_;
+    SegmentLogOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable flushed_;
+    std::vector<Chunk> pending_;
+    uint64_t segment_ = 0;              // segment receiving new records
+    uint64_t segment_size_ = 0;         // its logical size including pending bytes
+    uint64_t written_lsn_ = 0;          // last buffered record
+    uint64_t durable_lsn_ = 0;          // last flushed record
+    bool flushing_ = false;
+    bool failed_ = false;
+    uint64_t sync_count_ = 0;
+
+    // Owned by the flush leader
+    int fd_ = -1;
+    uint64_t fd_segment_ = 0;
+};
+
+} // namespace isaac
@@ -0,0 +1,286 @@
+#include "bm25_index.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <mutex>
+#include <unordered_set>
+
+namespace isaac {
+
+namespace {
+
+bool is_ident_char(unsigned char c) {
+    return std::isalnum(c) || c == '_';
+}
+
+void emit_token(std::vector<std::string>& tokens, std::string_view part) {
+    if (part.size() < 2) {
+        return; // Single characters carry no signal for ranking
+    }
+    std::string token(part);
+    for (char& c : token) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    tokens.push_back(std::move(token));
+}
+
+// Split one identifier on '_' and camelCase / ACRONYMWord boundaries
+void split_identifier(std::vector<std::string>& tokens, std::string_view word) {
+    size_t parts = 0;
+    size_t start = 0;
+    auto flush = [&](size_t end) {
+        if (end > start) {
+            emit_token(tokens, word.substr(start, end - start));
+            ++parts;
+        }
+    };
+
+    for (size_t i = 0; i < word.size(); ++i) {
+        unsigned char c = word[i];
+        if (c == '_') {
+            flush(i);
+            start = i + 1;
+            continue;
+        }
+        if (i > start && std::isupper(c)) {
+            unsigned char prev = word[i - 1];
+            bool next_lower = i + 1 < word.size() && std::islower(static_cast<unsigned char>(word[i + 1]));
+            if (std::islower(prev) || std::isdigit(prev) || (std::isupper(prev) && next_lower)) {
+                flush(i);
+                start = i;
+            }
+        }
+    }
+    flush(word.size());
+
+    // Also index the whole identifier (underscores stripped) for exact lookups
+    if (parts > 1) {
+        std::string whole;
+        whole.reserve(word.size());
+        for (char c : word) {
+            if (c != '_') whole.push_back(c);
+        }
+        emit_token(tokens, whole);
+    }
+}
+
+} // namespace
+
+Bm25Index::Bm25Index(double k1, double b) : k1_(k1), b_(b) {}
+
+Bm25Index::~Bm25Index() = default;
+
+std::vector<std::string> Bm25Index::tokenize(std::string_view text) {
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !is_ident_char(text[i])) ++i;
+        size_t start = i;
+        while (i < text.size() && is_ident_char(text[i])) ++i;
+        if (i > start) {
+            split_identifier(tokens, text.substr(start, i - start));
+        }
+    }
+    return tokens;
+}
+
+uint32_t Bm25Index::add_chunk(const std::string& file, int start_line, int end_line,
+                              const std::string& content) {
+    std::vector<std::string> tokens = tokenize(content);
+
+    std::unordered_map<std::string, uint32_t> term_freqs;
+    for (auto& token : tokens) {
+        ++term_freqs[token];
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    uint32_t chunk_id = next_chunk_id_++;
+    uint32_t doc_id = static_cast<uint32_t>(docs_.size());
+    docs_.push_back(DocInfo{chunk_id, file, start_line, end_line, static_cast<uint32_t>(tokens.size()), true});
+    file_docs_[file].push_back(doc_id);
+    total_length_ += tokens.size();
+    ++live_docs_;
+
+    for (auto& [term, tf] : term_freqs) {
+        PostingList& list = postings_[term];
+        // Doc IDs only grow, so deltas are always non-negative
+        varint_encode(list.data, list.doc_freq == 0 ? doc_id : doc_id - list.last_doc);
+        varint_encode(list.data, tf);
+        list.last_doc = doc_id;
+        ++list.doc_freq;
+    }
+
+    return chunk_id;
+}
+
+size_t Bm25Index::remove_file(const std::string& file) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = file_docs_.find(file);
+    if (it == file_docs_.end()) {
+        return 0;
+    }
+
+    size_t removed = 0;
+    for (uint32_t doc_id : it->second) {
+        DocInfo& doc = docs_[doc_id];
+        if (!doc.live) continue;
+        doc.live = false;
+        total_length_ -= doc.length;
+        doc.file.clear();
+        doc.file.shrink_to_fit();
+        --live_docs_;
+        ++dead_docs_;
+        ++removed;
+    }
+    file_docs_.erase(it);
+
+    // Tombstoned docs are skipped at query time; rewrite postings once they dominate
+    if (dead_docs_ > 1024 && dead_docs_ > live_docs_) {
+        compact();
+    }
+
+    return removed;
+}
+
+void Bm25Index::compact() {
+    // Live docs move down to dense slots in their old order, so posting
+    // deltas stay non-negative after remapping
+    constexpr uint32_t kDead = UINT32_MAX;
+    std::vector<uint32_t> remap(docs_.size(), kDead);
+    std::vector<DocInfo> live;
+    live.reserve(live_docs_);
+    for (uint32_t slot = 0; slot < docs_.size(); ++slot) {
+        if (!docs_[slot].live) continue;
+        remap[slot] = static_cast<uint32_t>(live.size());
+        live.push_back(std::move(docs_[slot]));
+    }
+
+    for (auto it = postings_.begin(); it != postings_.end();) {
+        PostingList& list = it->second;
+        PostingList rebuilt;
+        size_t pos = 0;
+        uint64_t doc = 0;
+        for (uint32_t n = 0; n < list.doc_freq; ++n) {
+            uint64_t delta = 0, tf = 0;
+            if (!varint_decode(list.data.data(), list.data.size(), pos, delta) ||
+                !varint_decode(list.data.data(), list.data.size(), pos, tf)) {
+                break;
+            }
+            doc = n == 0 ? delta : doc + delta;
+            uint32_t slot = remap[doc];
+            if (slot == kDead) continue;
+            varint_encode(rebuilt.data, rebuilt.doc_freq == 0 ? slot : slot - rebuilt.last_doc);
+            varint_encode(rebuilt.data, tf);
+            rebuilt.last_doc = slot;
+            ++rebuilt.doc_freq;
+        }
+
+        if (rebuilt.doc_freq == 0) {
+            it = postings_.erase(it);
+        } else {
+            rebuilt.data.shrink_to_fit();
+            list = std::move(rebuilt);
+            ++it;
+        }
+    }
+
+    for (auto& [file, slots] : file_docs_) {
+        for (uint32_t& slot : slots) slot = remap[slot];
+    }
+    live.shrink_to_fit();
+    docs_ = std::move(live);
+    dead_docs_ = 0;
+}
+
+std::vector<SearchHit> Bm25Index::search(const std::string& query, size_t top_k) const {
+    std::vector<std::string> terms = tokenize(query);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    std::vector<SearchHit> hits;
+    if (terms.empty() || live_docs_ == 0 || top_k == 0) {
+        return hits;
+    }
+
+    const double n_docs = static_cast<double>(live_docs_);
+    const double avg_len = std::max(1.0, static_cast<double>(total_length_) / n_docs);
+
+    std::vector<double> scores(docs_.size(), 0.0);
+    std::vector<uint32_t> touched;
+
+    for (const auto& term : terms) {
+        auto it = postings_.find(term);
+        if (it == postings_.end()) continue;
+
+        const PostingList& list = it->second;
+        // doc_freq may still count tombstones until the next compaction
+        double df = std::min<double>(list.doc_freq, n_docs);
+        double idf = std::log(1.0 + (n_docs - df + 0.5) / (df + 0.5));
+
+        size_t pos = 0;
+        uint64_t doc = 0;
+        for (uint32_t n = 0; n < list.doc_freq; ++n) {
+            uint64_t delta = 0, tf = 0;
+            if (!varint_decode(list.data.data(), list.data.size(), pos, delta) ||
+                !varint_decode(list.data.data(), list.data.size(), pos, tf)) {
+                break;
+            }
+            doc = n == 0 ? delta : doc + delta;
+            const DocInfo& info = docs_[doc];
+            if (!info.live) continue;
+
+            double norm = k1_ * (1.0 - b_ + b_ * info.length / avg_len);
+            double tf_d = static_cast<double>(tf);
+            if (scores[doc] == 0.0) touched.push_back(static_cast<uint32_t>(doc));
+            scores[doc] += idf * (tf_d * (k1_ + 1.0)) / (tf_d + norm);
+        }
+    }
+
+    size_t k = std::min(top_k, touched.size());
+    std::partial_sort(touched.begin(), touched.begin() + k, touched.end(),
+                      [&](uint32_t a, uint32_t b) {
+                          return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+                      });
+
+    hits.reserve(k);
+    for (size_t i = 0; i < k; ++i) {
+        const DocInfo& info = docs_[touched[i]];
+        hits.push_back(SearchHit{info.chunk_id, info.file, info.start_line, info.end_line, scores[touched[i]]});
+    }
+    return hits;
+}
+
+size_t Bm25Index::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return live_docs_;
+}
+
+size_t Bm25Index::term_count() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return postings_.size();
+}
+
+size_t Bm25Index::memory_usage() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    size_t bytes = docs_.capacity() * sizeof(DocInfo);
+    for (const auto& [term, list] : postings_) {
+        bytes += term.capacity() + list.data.capacity() + sizeof(PostingList);
+    }
+    return bytes;
+}
+
+void Bm25Index::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    postings_.clear();
+    file_docs_.clear();
+    docs_.clear();
+    total_length_ = 0;
+    live_docs_ = 0;
+    dead_docs_ = 0;
+    next_chunk_id_ = 0;
+}
+
+} // namespace isaac
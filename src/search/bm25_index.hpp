@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+// A single ranked chunk returned from a lexical search
+struct SearchHit {
+    uint32_t chunk_id = 0;
+    std::string file;
+    int start_line = 0;
+    int end_line = 0;
+    double score = 0.0;
+};
+
+/**
+ * Local BM25 inverted index over code chunks produced by FileChunker.
+ *
+ * Tokenization is identifier-aware: "parseHttpRequest" and "parse_http_request"
+ * both index as {parse, http, request} plus the whole identifier. Posting lists
+ * are stored as varint-encoded (doc delta, term frequency) pairs over internal
+ * doc slots; once removed chunks outnumber live ones the slots are renumbered,
+ * so memory and per-query work follow the live set. Chunk IDs stay stable.
+ */
+class Bm25Index {
+public:
+    explicit Bm25Index(double k1 = 1.2, double b = 0.75);
+    ~Bm25Index();
+
+    // Add a chunk and return its chunk ID (IDs are not reused until clear())
+    uint32_t add_chunk(const std::string& file, int start_line, int end_line,
+                       const std::string& content);
+
+    // Drop every chunk belonging to a file, returns number of chunks removed
+    size_t remove_file(const std::string& file);
+
+    // Rank live chunks against a free-text query
+    std::vector<SearchHit> search(const std::string& query, size_t top_k) const;
+
+    size_t size() const;
+    size_t term_count() const;
+    size_t memory_usage() const;
+    void clear();
+
+    static std::vector<std::string> tokenize(std::string_view text);
+
+private:
+    struct PostingList {
+        std::vector<uint8_t> data;
+        uint32_t last_doc = 0;
+        uint32_t doc_freq = 0;
+    };
+
+    struct DocInfo {
+        uint32_t chunk_id = 0;
+        std::string file;
+        int start_line = 0;
+        int end_line = 0;
+        uint32_t length = 0;
+        bool live = false;
+    };
+
+    void compact();
+
+    double k1_;
+    double b_;
+    std::unordered_map<std::string, PostingList> postings_;
+    std::unordered_map<std::string, std::vector<uint32_t>> file_docs_;    // file -> doc slots
+    std::vector<DocInfo> docs_;                                          // by slot
+    uint32_t next_chunk_id_ = 0;
+    uint64_t total_length_ = 0;
+    size_t live_docs_ = 0;
+    size_t dead_docs_ = 0;
+    mutable std::shared_mutex mutex_;
+};
+
+} // namespace isaac
@@ -0,0 +1,279 @@
+#include "context_builder.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace isaac {
+
+namespace {
+
+constexpr std::string_view kSeparator = "\n\n---\n\n";
+constexpr std::string_view kEllipsis = "...";
+
+enum ByteClass : uint8_t { kAlpha, kDigit, kSpace, kNewline, kPunct, kHighByte };
+
+struct TokenTables {
+    std::array<uint8_t, 256> byte_class{};
+    std::array<bool, 65536> merges{}; // punctuation pairs BPE vocabularies encode as one token
+
+    TokenTables() {
+        for (int c = 0; c < 256; ++c) {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) byte_class[c] = kAlpha;
+            else if (c >= '0' && c <= '9') byte_class[c] = kDigit;
+            else if (c == ' ' || c == '\t') byte_class[c] = kSpace;
+            else if (c == '\n' || c == '\r') byte_class[c] = kNewline;
+            else if (c >= 0x80) byte_class[c] = kHighByte;
+            else byte_class[c] = kPunct;
+        }
+
+        static const char* const pairs[] = {
+            "==", "!=", "<=", ">=", "->", "=>", "::", "//", "/*", "*/", "()", "[]", "{}",
+            "++", "--", "+=", "-=", "*=", "/=", "&&", "||", "**", "<<", ">>", "\"\"", "''",
+            "):", "),", ");", "];", "},", "};", "(\"", "\")", "('", "')", "__", "\"\"\"", "#!",
+        };
+        for (const char* pair : pairs) {
+            auto a = static_cast<uint8_t>(pair[0]);
+            auto b = static_cast<uint8_t>(pair[1]);
+            merges[(a << 8) | b] = true;
+        }
+    }
+};
+
+const TokenTables& tables() {
+    static const TokenTables instance;
+    return instance;
+}
+
+int line_count(std::string_view text) {
+    if (text.empty()) return 0;
+    int lines = static_cast<int>(std::count(text.begin(), text.end(), '\n'));
+    return text.back() == '\n' ? lines : lines + 1;
+}
+
+// Byte offset where line `n` (0-based) starts
+size_t line_offset(std::string_view text, int n) {
+    size_t pos = 0;
+    for (int i = 0; i < n && pos != std::string_view::npos; ++i) {
+        pos = text.find('\n', pos);
+        if (pos != std::string_view::npos) ++pos;
+    }
+    return pos == std::string_view::npos ? text.size() : pos;
+}
+
+struct Candidate {
+    size_t index;
+    int start_line;
+    int end_line;
+    std::string_view content;
+    std::string block;
+    size_t tokens;
+    double value;
+};
+
+std::string make_block(const std::string& file, int start_line, int end_line,
+                       std::string_view content, bool include_file_paths) {
+    std::string block;
+    if (include_file_paths && !file.empty()) {
+        block.reserve(file.size() + content.size() + 32);
+        block += '[';
+        block += file;
+        block += ':';
+        block += std::to_string(start_line);
+        block += '-';
+        block += std::to_string(end_line);
+        block += "]\n";
+    }
+    block.append(content.data(), content.size());
+    return block;
+}
+
+} // namespace
+
+ContextBuilder::ContextBuilder() = default;
+
+ContextBuilder::~ContextBuilder() = default;
+
+size_t ContextBuilder::estimate_tokens(std::string_view text) {
+    const TokenTables& t = tables();
+    const size_t n = text.size();
+    size_t tokens = 0;
+    size_t i = 0;
+
+    while (i < n) {
+        const auto byte = static_cast<uint8_t>(text[i]);
+        const uint8_t cls = t.byte_class[byte];
+        size_t run = i + 1;
+        while (run < n && t.byte_class[static_cast<uint8_t>(text[run])] == cls && cls != kPunct) ++run;
+        const size_t len = run - i;
+
+        switch (cls) {
+            case kAlpha:
+                tokens += (len + 3) / 4;
+                break;
+            case kDigit:
+                tokens += (len + 2) / 3;
+                break;
+            case kSpace:
+                // A single space before a word is absorbed into that word's token
+                if (!(len == 1 && run < n && t.byte_class[static_cast<uint8_t>(text[run])] <= kDigit)) {
+                    tokens += 1 + len / 16;
+                }
+                break;
+            case kNewline:
+                tokens += 1;
+                break;
+            case kHighByte:
+                tokens += (len + 1) / 2;
+                break;
+            default: // kPunct
+                tokens += 1;
+                if (run < n && t.merges[(byte << 8) | static_cast<uint8_t>(text[run])]) ++run;
+                break;
+        }
+        i = run;
+    }
+    return tokens;
+}
+
+ContextResult ContextBuilder::build(const std::vector<ContextChunk>& chunks, size_t token_budget,
+                                    bool include_file_paths) const {
+    ContextResult result;
+    const size_t separator_tokens = estimate_tokens(kSeparator);
+
+    // 1. De-duplicate line ranges: higher-ranked chunks claim their lines first
+    std::unordered_map<std::string, std::vector<std::pair<int, int>>> claimed;
+    std::vector<Candidate> candidates;
+    candidates.reserve(chunks.size());
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const ContextChunk& chunk = chunks[i];
+        int start = chunk.start_line;
+        int end = chunk.end_line;
+        std::string_view content = chunk.content;
+
+        if (start > 0 && end >= start) {
+            auto& ranges = claimed[chunk.file];
+            bool contained = false;
+            // Content can only be trimmed when it maps 1:1 onto the line range
+            const bool exact_lines = line_count(content) == end - start + 1;
+
+            for (const auto& [claimed_start, claimed_end] : ranges) {
+                if (start >= claimed_start && end <= claimed_end) {
+                    contained = true;
+                    break;
+                }
+                if (!exact_lines || end < claimed_start || start > claimed_end) continue;
+
+                if (start >= claimed_start) {
+                    // Head overlaps an earlier chunk: drop the shared lines
+                    int skip = claimed_end - start + 1;
+                    content.remove_prefix(line_offset(content, skip));
+                    start += skip;
+                } else if (end <= claimed_end) {
+                    // Tail overlaps: keep lines before the claimed range
+                    int keep = claimed_start - start;
+                    size_t cut = line_offset(content, keep);
+                    content = content.substr(0, cut > 0 && content[cut - 1] == '\n' ? cut - 1 : cut);
+                    end = claimed_start - 1;
+                }
+            }
+
+            if (contained || content.empty()) {
+                ++result.overlaps_removed;
+                continue;
+            }
+            ranges.emplace_back(start, end);
+        }
+
+        Candidate candidate{i, start, end, content, {}, 0, 0.0};
+        candidate.block = make_block(chunk.file, start, end, content, include_file_paths);
+        candidate.tokens = estimate_tokens(candidate.block) + separator_tokens;
+        // Small rank bonus keeps input order as the tie-breaker for equal scores
+        candidate.value = std::max(chunk.score, 0.0) + 1e-6 * static_cast<double>(chunks.size() - i);
+        result.candidate_tokens += candidate.tokens;
+        candidates.push_back(std::move(candidate));
+    }
+
+    if (candidates.empty() || token_budget == 0) {
+        return result;
+    }
+
+    // 2. 0/1 knapsack over token weights, bucketed so the table stays small
+    const size_t unit = std::max<size_t>(1, (token_budget + kMaxBuckets - 1) / kMaxBuckets);
+    const size_t capacity = token_budget / unit;
+    const size_t n = candidates.size();
+
+    std::vector<double> best(capacity + 1, 0.0);
+    std::vector<uint8_t> take(n * (capacity + 1), 0);
+    for (size_t i = 0; i < n; ++i) {
+        const size_t weight = (candidates[i].tokens + unit - 1) / unit;
+        if (weight > capacity) continue;
+        for (size_t c = capacity; c >= weight; --c) {
+            double with = best[c - weight] + candidates[i].value;
+            if (with > best[c]) {
+                best[c] = with;
+                take[i * (capacity + 1) + c] = 1;
+            }
+            if (c == weight) break;
+        }
+    }
+
+    std::vector<size_t> chosen;
+    for (size_t i = n, c = capacity; i-- > 0;) {
+        if (take[i * (capacity + 1) + c]) {
+            chosen.push_back(i);
+            c -= (candidates[i].tokens + unit - 1) / unit;
+        }
+    }
+    std::reverse(chosen.begin(), chosen.end());
+
+    // Nothing fits whole: fall back to the top chunk cut at a line boundary,
+    // with room for the ellipsis marking the cut
+    if (chosen.empty()) {
+        Candidate& top = candidates.front();
+        std::string_view block = top.block;
+        std::string cut;
+        auto cut_tokens = [&](std::string_view prefix) {
+            cut.assign(prefix.data(), prefix.size());
+            cut += kEllipsis;
+            return estimate_tokens(cut);
+        };
+        size_t lines = static_cast<size_t>(line_count(block));
+        while (lines > 1 && cut_tokens(block) > token_budget) {
+            lines = lines * 3 / 4;
+            block = block.substr(0, line_offset(block, static_cast<int>(lines)));
+        }
+        if (cut_tokens(block) > token_budget) {
+            return result;
+        }
+        top.block = std::move(cut);
+        top.tokens = estimate_tokens(top.block) + separator_tokens;
+        chosen.push_back(0);
+    }
+
+    // 3. Assemble into a single preallocated buffer, in rank order
+    size_t total_bytes = 0;
+    for (size_t idx : chosen) {
+        total_bytes += candidates[idx].block.size() + kSeparator.size();
+    }
+    result.context.reserve(total_bytes);
+
+    for (size_t k = 0; k < chosen.size(); ++k) {
+        const Candidate& candidate = candidates[chosen[k]];
+        if (k > 0) {
+            result.context.append(kSeparator.data(), kSeparator.size());
+        }
+        result.context += candidate.block;
+        result.tokens += candidate.tokens;
+        result.selected.push_back(candidate.index);
+    }
+    if (!chosen.empty()) {
+        result.tokens -= std::min(result.tokens, separator_tokens);
+    }
+
+    return result;
+}
+
+} // namespace isaac
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace isaac {
+
+// A ranked search result offered to the context builder
+struct ContextChunk {
+    std::string file;
+    int start_line = 0;
+    int end_line = 0;
+    std::string content;
+    double score = 0.0;
+};
+
+struct ContextResult {
+    std::string context;
+    size_t tokens = 0;
+    size_t candidate_tokens = 0;   // tokens of every candidate before packing
+    std::vector<size_t> selected;  // indices into the input, in rank order
+    size_t overlaps_removed = 0;
+};
+
+/**
+ * Packs ranked chunks into a prompt context under a token budget.
+ *
+ * Token counts come from a byte-class heuristic that mimics BPE merges
+ * (words ~4 bytes per token, common operator pairs merge, indentation
+ * collapses). Overlapping line ranges from the same file are trimmed or
+ * dropped, then a 0/1 knapsack maximizes total score within the budget.
+ */
+class ContextBuilder {
+public:
+    ContextBuilder();
+    ~ContextBuilder();
+
+    ContextResult build(const std::vector<ContextChunk>& chunks, size_t token_budget,
+                        bool include_file_paths = true) const;
+
+    static size_t estimate_tokens(std::string_view text);
+
+private:
+    static constexpr size_t kMaxBuckets = 2048;
+};
+
+} // namespace isaac
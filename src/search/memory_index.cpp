@@ -0,0 +1,318 @@
+#include "memory_index.hpp"
+#include "bm25_index.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace isaac {
+
+MemoryIndex::MemoryIndex(MemoryIndexOptions options) : options_(options) {
+    if (options_.half_life_seconds <= 0) {
+        throw std::invalid_argument("half_life_seconds must be positive");
+    }
+}
+
+MemoryIndex::~MemoryIndex() = default;
+
+uint32_t MemoryIndex::intern(const std::string& value) {
+    auto it = strings_.emplace(value, static_cast<uint32_t>(strings_.size())).first;
+    return it->second;
+}
+
+bool MemoryIndex::lookup(const std::string& value, uint32_t& out) const {
+    auto it = strings_.find(value);
+    if (it == strings_.end()) return false;
+    out = it->second;
+    return true;
+}
+
+void MemoryIndex::add(int64_t id, const std::string& session_id, const std::string& memory_type,
+                      double timestamp, double importance, const std::string& content,
+                      const std::vector<std::string>& tags) {
+    std::unordered_map<std::string, uint32_t> term_freqs;
+    uint32_t length = 0;
+    for (auto& token : Bm25Index::tokenize(content)) {
+        ++term_freqs[token];
+        ++length;
+    }
+    for (const auto& tag : tags) {
+        for (auto& token : Bm25Index::tokenize(tag)) {
+            term_freqs[token] += options_.tag_weight;
+            length += options_.tag_weight;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    auto existing = slots_.find(id);
+    if (existing != slots_.end()) {
+        kill(existing->second);
+        if (dead_docs_ > 1024 && dead_docs_ > slots_.size()) {
+            compact();
+        }
+    }
+
+    uint32_t slot = static_cast<uint32_t>(docs_.size());
+    Doc doc;
+    doc.id = id;
+    doc.timestamp = timestamp;
+    doc.importance = importance;
+    doc.session = intern(session_id);
+    doc.type = intern(memory_type);
+    doc.length = length;
+    doc.live = true;
+    for (const auto& tag : tags) doc.tags.push_back(intern(tag));
+    std::sort(doc.tags.begin(), doc.tags.end());
+    doc.tags.erase(std::unique(doc.tags.begin(), doc.tags.end()), doc.tags.end());
+    docs_.push_back(std::move(doc));
+
+    slots_[id] = slot;
+    total_length_ += length;
+    max_id_ = std::max(max_id_, id);
+
+    for (auto& [term, tf] : term_freqs) {
+        PostingList& list = postings_[term];
+        // Slots only grow, so deltas are always non-negative
+        varint_encode(list.data, list.doc_freq == 0 ? slot : slot - list.last_doc);
+        varint_encode(list.data, tf);
+        list.last_doc = slot;
+        ++list.doc_freq;
+    }
+}
+
+void MemoryIndex::kill(uint32_t slot) {
+    Doc& doc = docs_[slot];
+    doc.live = false;
+    total_length_ -= doc.length;
+    doc.tags.clear();
+    doc.tags.shrink_to_fit();
+    slots_.erase(doc.id);
+    ++dead_docs_;
+}
+
+bool MemoryIndex::remove(int64_t id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = slots_.find(id);
+    if (it == slots_.end()) {
+        return false;
+    }
+    kill(it->second);
+    if (dead_docs_ > 1024 && dead_docs_ > slots_.size()) {
+        compact();
+    }
+    return true;
+}
+
+size_t MemoryIndex::prune(double before, double min_importance) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    size_t removed = 0;
+    for (uint32_t slot = 0; slot < docs_.size(); ++slot) {
+        const Doc& doc = docs_[slot];
+        if (doc.live && doc.timestamp < before && doc.importance < min_importance) {
+            kill(slot);
+            ++removed;
+        }
+    }
+    if (dead_docs_ > 1024 && dead_docs_ > slots_.size()) {
+        compact();
+    }
+    return removed;
+}
+
+void MemoryIndex::compact() {
+    // Live docs move down to dense slots in their old order, so posting
+    // deltas stay non-negative after remapping
+    constexpr uint32_t kDead = UINT32_MAX;
+    std::vector<uint32_t> remap(docs_.size(), kDead);
+    std::vector<Doc> live;
+    live.reserve(slots_.size());
+    for (uint32_t slot = 0; slot < docs_.size(); ++slot) {
+        if (!docs_[slot].live) continue;
+        remap[slot] = static_cast<uint32_t>(live.size());
+        live.push_back(std::move(docs_[slot]));
+    }
+
+    for (auto it = postings_.begin(); it != postings_.end();) {
+        PostingList& list = it->second;
+        PostingList rebuilt;
+        size_t pos = 0;
+        uint64_t doc = 0;
+        for (uint32_t n = 0; n < list.doc_freq; ++n) {
+            uint64_t delta = 0, tf = 0;
+            if (!varint_decode(list.data.data(), list.data.size(), pos, delta) ||
+                !varint_decode(list.data.data(), list.data.size(), pos, tf)) {
+                break;
+            }
+            doc = n == 0 ? delta : doc + delta;
+            uint32_t slot = remap[doc];
+            if (slot == kDead) continue;
+            varint_encode(rebuilt.data, rebuilt.doc_freq == 0 ? slot : slot - rebuilt.last_doc);
+            varint_encode(rebuilt.data, tf);
+            rebuilt.last_doc = slot;
+            ++rebuilt.doc_freq;
+        }
+
+        if (rebuilt.doc_freq == 0) {
+            it = postings_.erase(it);
+        } else {
+            rebuilt.data.shrink_to_fit();
+            list = std::move(rebuilt);
+            ++it;
+        }
+    }
+
+    for (auto& [id, slot] : slots_) slot = remap[slot];
+    live.shrink_to_fit();
+    docs_ = std::move(live);
+    dead_docs_ = 0;
+}
+
+std::vector<MemoryHit> MemoryIndex::search(const MemoryQuery& query) const {
+    std::vector<std::string> terms = Bm25Index::tokenize(query.text);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    std::vector<MemoryHit> hits;
+    if (slots_.empty() || query.top_k == 0) {
+        return hits;
+    }
+
+    // Filters resolve to interned ids; a value never stored matches nothing
+    uint32_t session = 0, type = 0;
+    if (!query.session_id.empty() && !lookup(query.session_id, session)) return hits;
+    if (!query.memory_type.empty() && !lookup(query.memory_type, type)) return hits;
+    std::vector<uint32_t> tags;
+    for (const auto& tag : query.tags) {
+        uint32_t interned = 0;
+        if (!lookup(tag, interned)) return hits;
+        tags.push_back(interned);
+    }
+    std::sort(tags.begin(), tags.end());
+
+    auto passes = [&](const Doc& doc) {
+        return doc.live && doc.importance >= query.min_importance &&
+               (query.session_id.empty() || doc.session == session) &&
+               (query.memory_type.empty() || doc.type == type) &&
+               std::includes(doc.tags.begin(), doc.tags.end(), tags.begin(), tags.end());
+    };
+
+    std::vector<double> relevance(docs_.size(), 0.0);
+    std::vector<uint32_t> touched;
+
+    if (terms.empty()) {
+        for (uint32_t slot = 0; slot < docs_.size(); ++slot) {
+            if (passes(docs_[slot])) {
+                relevance[slot] = 1.0;
+                touched.push_back(slot);
+            }
+        }
+    } else {
+        const double n_docs = static_cast<double>(slots_.size());
+        const double avg_len = std::max(1.0, static_cast<double>(total_length_) / n_docs);
+        const double k1 = options_.k1;
+        const double b = options_.b;
+
+        for (const auto& term : terms) {
+            auto it = postings_.find(term);
+            if (it == postings_.end()) continue;
+
+            const PostingList& list = it->second;
+            // doc_freq may still count tombstones until the next compaction
+            double df = std::min<double>(list.doc_freq, n_docs);
+            double idf = std::log(1.0 + (n_docs - df + 0.5) / (df + 0.5));
+
+            size_t pos = 0;
+            uint64_t slot = 0;
+            for (uint32_t n = 0; n < list.doc_freq; ++n) {
+                uint64_t delta = 0, tf = 0;
+                if (!varint_decode(list.data.data(), list.data.size(), pos, delta) ||
+                    !varint_decode(list.data.data(), list.data.size(), pos, tf)) {
+                    break;
+                }
+                slot = n == 0 ? delta : slot + delta;
+                const Doc& doc = docs_[slot];
+                if (!passes(doc)) continue;
+
+                double norm = k1 * (1.0 - b + b * doc.length / avg_len);
+                double tf_d = static_cast<double>(tf);
+                if (relevance[slot] == 0.0) touched.push_back(static_cast<uint32_t>(slot));
+                relevance[slot] += idf * (tf_d * (k1 + 1.0)) / (tf_d + norm);
+            }
+        }
+    }
+
+    const double iw = options_.importance_weight;
+    const double rw = query.now > 0 ? options_.recency_weight : 0.0;
+    std::vector<double> scores(docs_.size(), 0.0);
+    for (uint32_t slot : touched) {
+        const Doc& doc = docs_[slot];
+        double age = std::max(0.0, query.now - doc.timestamp);
+        double recency = rw > 0 ? std::exp2(-age / options_.half_life_seconds) : 0.0;
+        double importance = std::clamp(doc.importance, 0.0, 1.0);
+        scores[slot] = relevance[slot] * (1.0 - iw + iw * importance) * (1.0 - rw + rw * recency);
+    }
+
+    size_t k = std::min(query.top_k, touched.size());
+    std::partial_sort(touched.begin(), touched.begin() + k, touched.end(),
+                      [&](uint32_t a, uint32_t b) {
+                          if (scores[a] != scores[b]) return scores[a] > scores[b];
+                          if (docs_[a].timestamp != docs_[b].timestamp) {
+                              return docs_[a].timestamp > docs_[b].timestamp;
+                          }
+                          return a > b;
+                      });
+
+    hits.reserve(k);
+    for (size_t i = 0; i < k; ++i) {
+        uint32_t slot = touched[i];
+        hits.push_back(MemoryHit{docs_[slot].id, scores[slot], relevance[slot]});
+    }
+    return hits;
+}
+
+size_t MemoryIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return slots_.size();
+}
+
+size_t MemoryIndex::term_count() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return postings_.size();
+}
+
+int64_t MemoryIndex::max_id() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return max_id_;
+}
+
+size_t MemoryIndex::memory_usage() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    size_t bytes = docs_.capacity() * sizeof(Doc);
+    for (const auto& doc : docs_) {
+        bytes += doc.tags.capacity() * sizeof(uint32_t);
+    }
+    for (const auto& [term, list] : postings_) {
+        bytes += term.capacity() + list.data.capacity() + sizeof(PostingList);
+    }
+    for (const auto& [value, id] : strings_) {
+        bytes += value.capacity() + sizeof(id);
+    }
+    return bytes + slots_.size() * (sizeof(int64_t) + sizeof(uint32_t));
+}
+
+void MemoryIndex::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    postings_.clear();
+    docs_.clear();
+    slots_.clear();
+    strings_.clear();
+    total_length_ = 0;
+    dead_docs_ = 0;
+    max_id_ = 0;
+}
+
+} // namespace isaac
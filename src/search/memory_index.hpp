@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+// A memory ranked by MemoryIndex::search
+struct MemoryHit {
+    int64_t id = 0;                     // memories.id
+    double score = 0.0;                 // relevance blended with importance and recency
+    double relevance = 0.0;             // BM25 alone
+};
+
+struct MemoryIndexOptions {
+    double k1 = 1.2;
+    double b = 0.75;
+    uint32_t tag_weight = 2;            // occurrences each tag token counts for
+    double importance_weight = 0.5;     // share of the score scaled by importance
+    double recency_weight = 0.3;        // share of the score scaled by recency
+    double half_life_seconds = 7 * 24 * 3600.0;
+};
+
+struct MemoryQuery {
+    std::string text;                   // no terms = every memory passing the filters
+    size_t top_k = 10;
+    double now = 0;                     // unix seconds; 0 = no recency factor
+    std::string session_id;             // empty = any
+    std::string memory_type;            // empty = any
+    std::vector<std::string> tags;      // all must be present
+    double min_importance = 0;
+};
+
+/**
+ * BM25 inverted index over stored memories' content and tags.
+ *
+ * Terms come from Bm25Index::tokenize; posting lists are varint (doc
+ * delta, term frequency) pairs over internal doc slots. The BM25 score is
+ * multiplied by an importance factor (1 - w + w * importance) and a
+ * recency factor (1 - w + w * 2^(-age / half_life)), so relevance stays
+ * the main signal. Session, type, tag and importance filters are checked
+ * on the doc before it is scored.
+ *
+ * Updates are incremental: add() replaces a memory with the same id,
+ * remove() and prune() tombstone, and once tombstones outnumber live
+ * memories the live docs are renumbered into dense slots and the postings
+ * rewritten, so per-query buffers stay proportional to what is stored.
+ */
+class MemoryIndex {
+public:
+    explicit MemoryIndex(MemoryIndexOptions options = {});
+    ~MemoryIndex();
+
+    void add(int64_t id, const std::string& session_id, const std::string& memory_type,
+             double timestamp, double importance, const std::string& content,
+             const std::vector<std::string>& tags);
+
+    bool remove(int64_t id);
+
+    // Drop memories older than before with importance below min_importance
+    // (the prune_old_memories predicate); returns the number removed
+    size_t prune(double before, double min_importance);
+
+    std::vector<MemoryHit> search(const MemoryQuery& query) const;
+
+    size_t size() const;
+    size_t term_count() const;
+    int64_t max_id() const;             // highest id ever added; 0 when none
+    size_t memory_usage() const;
+    void clear();
+
+private:
+    struct PostingList {
+        std::vector<uint8_t> data;
+        uint32_t last_doc = 0;
+        uint32_t doc_freq = 0;
+    };
+
+    struct Doc {
+        int64_t id = 0;
+        double timestamp = 0;
+        double importance = 0;
+        uint32_t session = 0;           // interned
+        uint32_t type = 0;              // interned
+        uint32_t length = 0;
+        bool live = false;
+        std::vector<uint32_t> tags;     // interned, sorted
+    };
+
+    uint32_t intern(const std::string& value);
+    bool lookup(const std::string& value, uint32_t& out) const;
+    void kill(uint32_t slot);
+    void compact();
+
+    MemoryIndexOptions options_;
+    std::unordered_map<std::string, PostingList> postings_;
+    std::vector<Doc> docs_;
+    std::unordered_map<int64_t, uint32_t> slots_;     // memory id -> live doc slot
+    std::unordered_map<std::string, uint32_t> strings_;
+    uint64_t total_length_ = 0;
+    size_t dead_docs_ = 0;
+    int64_t max_id_ = 0;
+    mutable std::shared_mutex mutex_;
+};
+
+} // namespace isaac
@@ -0,0 +1,546 @@
+#include "vector_store.hpp"
+#include "simd_distance.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace {
+
+constexpr char kSegmentMagic[8] = {'I', 'S', 'A', 'A', 'C', 'V', 'S', '1'};
+constexpr uint32_t kSegmentVersion = 1;
+constexpr size_t kHeaderSize = 64;
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t dim;
+    uint32_t m;
+    uint32_t ef_construction;
+    uint32_t count;
+    uint32_t entry_point;
+    int32_t max_level;
+    uint32_t reserved;
+    uint64_t metadata_offset;
+};
+static_assert(sizeof(SegmentHeader) <= kHeaderSize, "segment header must fit in 64 bytes");
+
+// Epoch-tagged visited set, reused per thread to avoid clearing between queries
+struct VisitedList {
+    std::vector<uint32_t> tags;
+    uint32_t epoch = 0;
+
+    void reset(size_t n) {
+        if (tags.size() < n) tags.resize(n, 0);
+        if (++epoch == 0) {
+            std::fill(tags.begin(), tags.end(), 0);
+            epoch = 1;
+        }
+    }
+    bool visit(uint32_t node) {
+        if (tags[node] == epoch) return false;
+        tags[node] = epoch;
+        return true;
+    }
+};
+
+thread_local VisitedList visited_list;
+
+template <typename T>
+void write_pod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_pod(const uint8_t* data, size_t size, size_t& pos, T& value) {
+    if (pos + sizeof(T) > size) return false;
+    std::memcpy(&value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+} // namespace
+
+VectorStore::VectorStore(size_t dim, size_t m, size_t ef_construction, uint32_t seed)
+    : dim_(dim), m_(std::max<size_t>(m, 2)), m0_(2 * std::max<size_t>(m, 2)),
+      ef_construction_(std::max(ef_construction, m)),
+      level_mult_(1.0 / std::log(static_cast<double>(std::max<size_t>(m, 2)))), rng_(seed) {
+    if (dim_ == 0) {
+        throw std::invalid_argument("VectorStore dimension must be positive");
+    }
+}
+
+VectorStore::~VectorStore() = default;
+
+void VectorStore::quantize(const std::vector<float>& input, std::vector<int8_t>& out,
+                           float& scale) const {
+    if (input.size() != dim_) {
+        throw std::invalid_argument("Vector dimension mismatch: expected " +
+                                    std::to_string(dim_) + ", got " + std::to_string(input.size()));
+    }
+
+    double norm = 0.0;
+    float max_abs = 0.0f;
+    for (float x : input) {
+        norm += static_cast<double>(x) * x;
+        max_abs = std::max(max_abs, std::fabs(x));
+    }
+
+    out.assign(dim_, 0);
+    scale = 0.0f;
+    if (norm == 0.0 || max_abs == 0.0f) {
+        return;
+    }
+
+    // Normalize for cosine, then map [-max, max] onto [-127, 127]
+    float inv_norm = static_cast<float>(1.0 / std::sqrt(norm));
+    scale = max_abs * inv_norm / 127.0f;
+    float inv = 127.0f / max_abs;
+    for (size_t i = 0; i < dim_; ++i) {
+        out[i] = static_cast<int8_t>(std::lround(input[i] * inv));
+    }
+}
+
+const int8_t* VectorStore::vector_at(uint32_t node) const {
+    if (node < mapped_count_) {
+        return mapped_vectors_ + static_cast<size_t>(node) * dim_;
+    }
+    return tail_vectors_.data() + static_cast<size_t>(node - mapped_count_) * dim_;
+}
+
+float VectorStore::distance(const int8_t* q, float q_scale, uint32_t node) const {
+    return 1.0f - q_scale * nodes_[node].scale * static_cast<float>(dot_int8(q, vector_at(node), dim_));
+}
+
+float VectorStore::distance(uint32_t a, uint32_t b) const {
+    return distance(vector_at(a), nodes_[a].scale, b);
+}
+
+int VectorStore::random_level() {
+    std::uniform_real_distribution<double> uniform(std::numeric_limits<double>::min(), 1.0);
+    // Cap well below the uint8 level count stored in segments
+    return std::min(static_cast<int>(-std::log(uniform(rng_)) * level_mult_), 31);
+}
+
+uint32_t VectorStore::greedy_descend(const int8_t* q, float q_scale, int top_level,
+                                     int bottom_level) const {
+    uint32_t current = entry_point_;
+    float current_dist = distance(q, q_scale, current);
+
+    for (int level = top_level; level > bottom_level; --level) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (uint32_t neighbor : nodes_[current].links[level]) {
+                float d = distance(q, q_scale, neighbor);
+                if (d < current_dist) {
+                    current_dist = d;
+                    current = neighbor;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+std::vector<VectorStore::Candidate> VectorStore::search_layer(const int8_t* q, float q_scale,
+                                                              uint32_t entry, size_t ef, int level,
+                                                              bool skip_deleted) const {
+    // candidates: closest first; results: furthest first (bounded to ef)
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    std::priority_queue<Candidate> results;
+
+    VisitedList& visited = visited_list;
+    visited.reset(nodes_.size());
+
+    float d = distance(q, q_scale, entry);
+    visited.visit(entry);
+    candidates.emplace(d, entry);
+    if (!(skip_deleted && nodes_[entry].deleted)) {
+        results.emplace(d, entry);
+    }
+
+    while (!candidates.empty()) {
+        Candidate current = candidates.top();
+        if (results.size() >= ef && current.first > results.top().first) {
+            break;
+        }
+        candidates.pop();
+
+        for (uint32_t neighbor : nodes_[current.second].links[level]) {
+            if (!visited.visit(neighbor)) continue;
+
+            float nd = distance(q, q_scale, neighbor);
+            if (results.size() < ef || nd < results.top().first) {
+                // Tombstoned nodes still route the search, they just never become results
+                candidates.emplace(nd, neighbor);
+                if (!(skip_deleted && nodes_[neighbor].deleted)) {
+                    results.emplace(nd, neighbor);
+                    if (results.size() > ef) results.pop();
+                }
+            }
+        }
+    }
+
+    std::vector<Candidate> sorted;
+    sorted.reserve(results.size());
+    while (!results.empty()) {
+        sorted.push_back(results.top());
+        results.pop();
+    }
+    std::reverse(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+std::vector<uint32_t> VectorStore::select_neighbors(std::vector<Candidate> candidates,
+                                                    size_t m) const {
+    std::sort(candidates.begin(), candidates.end());
+
+    // HNSW heuristic: keep a candidate only if it is closer to the base than to
+    // any neighbour already kept, which preserves links across clusters
+    std::vector<uint32_t> selected;
+    selected.reserve(m);
+    for (const auto& [dist, node] : candidates) {
+        if (selected.size() >= m) break;
+        bool keep = true;
+        for (uint32_t chosen : selected) {
+            if (distance(node, chosen) < dist) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) selected.push_back(node);
+    }
+    return selected;
+}
+
+void VectorStore::insert_node(uint64_t chunk_id, std::vector<int8_t> quantized, float scale) {
+    uint32_t id = static_cast<uint32_t>(nodes_.size());
+    int level = random_level();
+
+    tail_vectors_.insert(tail_vectors_.end(), quantized.begin(), quantized.end());
+    Node node;
+    node.chunk_id = chunk_id;
+    node.scale = scale;
+    node.links.resize(level + 1);
+    nodes_.push_back(std::move(node));
+    id_to_node_[chunk_id] = id;
+
+    if (max_level_ < 0) {
+        entry_point_ = id;
+        max_level_ = level;
+        return;
+    }
+
+    const int8_t* q = vector_at(id);
+    uint32_t current = greedy_descend(q, scale, max_level_, level);
+
+    for (int l = std::min(level, max_level_); l >= 0; --l) {
+        std::vector<Candidate> found = search_layer(q, scale, current, ef_construction_, l, false);
+        std::vector<uint32_t> neighbors = select_neighbors(found, m_);
+        nodes_[id].links[l] = neighbors;
+
+        size_t max_links = l == 0 ? m0_ : m_;
+        for (uint32_t neighbor : neighbors) {
+            auto& links = nodes_[neighbor].links[l];
+            links.push_back(id);
+            if (links.size() > max_links) {
+                std::vector<Candidate> pool;
+                pool.reserve(links.size());
+                for (uint32_t other : links) {
+                    pool.emplace_back(distance(neighbor, other), other);
+                }
+                links = select_neighbors(std::move(pool), max_links);
+            }
+        }
+
+        if (!found.empty()) {
+            current = found.front().second;
+        }
+    }
+
+    if (level > max_level_) {
+        entry_point_ = id;
+        max_level_ = level;
+    }
+}
+
+void VectorStore::insert(uint64_t chunk_id, const std::vector<float>& vector) {
+    std::vector<int8_t> quantized;
+    float scale = 0.0f;
+    quantize(vector, quantized, scale);
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = id_to_node_.find(chunk_id);
+    if (it != id_to_node_.end()) {
+        nodes_[it->second].deleted = true;
+        ++deleted_;
+    }
+    insert_node(chunk_id, std::move(quantized), scale);
+}
+
+bool VectorStore::remove(uint64_t chunk_id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = id_to_node_.find(chunk_id);
+    if (it == id_to_node_.end()) {
+        return false;
+    }
+    nodes_[it->second].deleted = true;
+    ++deleted_;
+    id_to_node_.erase(it);
+    return true;
+}
+
+bool VectorStore::contains(uint64_t chunk_id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return id_to_node_.count(chunk_id) > 0;
+}
+
+std::vector<VectorHit> VectorStore::search(const std::vector<float>& query, size_t k,
+                                           size_t ef) const {
+    std::vector<int8_t> q;
+    float q_scale = 0.0f;
+    quantize(query, q, q_scale);
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    std::vector<VectorHit> hits;
+    if (max_level_ < 0 || k == 0) {
+        return hits;
+    }
+
+    uint32_t entry = greedy_descend(q.data(), q_scale, max_level_, 0);
+    std::vector<Candidate> found =
+        search_layer(q.data(), q_scale, entry, std::max(ef ? ef : ef_search_.load(std::memory_order_relaxed), k), 0, true);
+
+    size_t n = std::min(k, found.size());
+    hits.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        hits.push_back(VectorHit{nodes_[found[i].second].chunk_id, 1.0f - found[i].first});
+    }
+    return hits;
+}
+
+std::vector<VectorHit> VectorStore::exact_search(const std::vector<float>& query, size_t k) const {
+    std::vector<int8_t> q;
+    float q_scale = 0.0f;
+    quantize(query, q, q_scale);
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    std::vector<Candidate> all;
+    all.reserve(nodes_.size() - deleted_);
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+        if (!nodes_[i].deleted) {
+            all.emplace_back(distance(q.data(), q_scale, i), i);
+        }
+    }
+
+    size_t n = std::min(k, all.size());
+    std::partial_sort(all.begin(), all.begin() + n, all.end());
+
+    std::vector<VectorHit> hits;
+    hits.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        hits.push_back(VectorHit{nodes_[all[i].second].chunk_id, 1.0f - all[i].first});
+    }
+    return hits;
+}
+
+void VectorStore::compact() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    struct Live {
+        uint64_t chunk_id;
+        float scale;
+        std::vector<int8_t> vector;
+    };
+    std::vector<Live> live;
+    live.reserve(nodes_.size() - deleted_);
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i].deleted) continue;
+        const int8_t* v = vector_at(i);
+        live.push_back(Live{nodes_[i].chunk_id, nodes_[i].scale, std::vector<int8_t>(v, v + dim_)});
+    }
+
+    nodes_.clear();
+    id_to_node_.clear();
+    tail_vectors_.clear();
+    segment_.close();
+    mapped_vectors_ = nullptr;
+    mapped_count_ = 0;
+    entry_point_ = 0;
+    max_level_ = -1;
+    deleted_ = 0;
+
+    tail_vectors_.reserve(live.size() * dim_);
+    for (auto& item : live) {
+        insert_node(item.chunk_id, std::move(item.vector), item.scale);
+    }
+}
+
+bool VectorStore::save(const std::string& path) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+
+        const uint32_t count = static_cast<uint32_t>(nodes_.size());
+        SegmentHeader header{};
+        std::memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+        header.version = kSegmentVersion;
+        header.dim = static_cast<uint32_t>(dim_);
+        header.m = static_cast<uint32_t>(m_);
+        header.ef_construction = static_cast<uint32_t>(ef_construction_);
+        header.count = count;
+        header.entry_point = entry_point_;
+        header.max_level = max_level_;
+        header.metadata_offset = kHeaderSize + static_cast<uint64_t>(count) * dim_;
+
+        char header_block[kHeaderSize] = {};
+        std::memcpy(header_block, &header, sizeof(header));
+        out.write(header_block, kHeaderSize);
+
+        // Vector block first so open() can map it in place
+        for (uint32_t i = 0; i < count; ++i) {
+            out.write(reinterpret_cast<const char*>(vector_at(i)), dim_);
+        }
+
+        for (const Node& node : nodes_) {
+            write_pod(out, node.chunk_id);
+            write_pod(out, node.scale);
+            write_pod(out, static_cast<uint8_t>(node.deleted));
+            write_pod(out, static_cast<uint8_t>(node.links.size()));
+            for (const auto& links : node.links) {
+                write_pod(out, static_cast<uint16_t>(links.size()));
+                out.write(reinterpret_cast<const char*>(links.data()),
+                          links.size() * sizeof(uint32_t));
+            }
+        }
+
+        out.flush();
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        return false;
+    }
+
+    // Swap heap vectors for the freshly written mapping
+    MappedFile mapped;
+    if (mapped.open(path)) {
+        segment_ = std::move(mapped);
+        mapped_vectors_ = reinterpret_cast<const int8_t*>(segment_.data() + kHeaderSize);
+        mapped_count_ = nodes_.size();
+        tail_vectors_.clear();
+        tail_vectors_.shrink_to_fit();
+    }
+    return true;
+}
+
+std::shared_ptr<VectorStore> VectorStore::open(const std::string& path) {
+    MappedFile mapped;
+    if (!mapped.open(path) || mapped.size() < kHeaderSize) {
+        return nullptr;
+    }
+
+    SegmentHeader header;
+    std::memcpy(&header, mapped.data(), sizeof(header));
+    if (std::memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+        header.version != kSegmentVersion || header.dim == 0 ||
+        header.metadata_offset != kHeaderSize + static_cast<uint64_t>(header.count) * header.dim ||
+        header.metadata_offset > mapped.size()) {
+        return nullptr;
+    }
+
+    auto store = std::make_shared<VectorStore>(header.dim, header.m, header.ef_construction);
+    const uint8_t* data = mapped.data();
+    const size_t size = mapped.size();
+    size_t pos = header.metadata_offset;
+
+    store->nodes_.resize(header.count);
+    for (uint32_t i = 0; i < header.count; ++i) {
+        Node& node = store->nodes_[i];
+        uint8_t deleted = 0, levels = 0;
+        if (!read_pod(data, size, pos, node.chunk_id) || !read_pod(data, size, pos, node.scale) ||
+            !read_pod(data, size, pos, deleted) || !read_pod(data, size, pos, levels)) {
+            return nullptr;
+        }
+        node.deleted = deleted != 0;
+        node.links.resize(levels);
+        for (auto& links : node.links) {
+            uint16_t n = 0;
+            if (!read_pod(data, size, pos, n) || pos + n * sizeof(uint32_t) > size) {
+                return nullptr;
+            }
+            links.resize(n);
+            std::memcpy(links.data(), data + pos, n * sizeof(uint32_t));
+            pos += n * sizeof(uint32_t);
+            for (uint32_t target : links) {
+                if (target >= header.count) return nullptr;
+            }
+        }
+
+        if (node.deleted) {
+            ++store->deleted_;
+        } else {
+            store->id_to_node_[node.chunk_id] = i;
+        }
+    }
+
+    if (header.count > 0 && (header.entry_point >= header.count || header.max_level < 0 ||
+                             store->nodes_[header.entry_point].links.size() !=
+                                 static_cast<size_t>(header.max_level) + 1)) {
+        return nullptr;
+    }
+
+    store->entry_point_ = header.entry_point;
+    store->max_level_ = header.count > 0 ? header.max_level : -1;
+    store->segment_ = std::move(mapped);
+    store->mapped_vectors_ = reinterpret_cast<const int8_t*>(store->segment_.data() + kHeaderSize);
+    store->mapped_count_ = header.count;
+    return store;
+}
+
+size_t VectorStore::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return id_to_node_.size();
+}
+
+size_t VectorStore::deleted_count() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return deleted_;
+}
+
+size_t VectorStore::memory_usage() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    // Heap only: mapped segment pages belong to the page cache
+    size_t bytes = tail_vectors_.capacity() + nodes_.capacity() * sizeof(Node);
+    for (const Node& node : nodes_) {
+        for (const auto& links : node.links) {
+            bytes += links.capacity() * sizeof(uint32_t);
+        }
+    }
+    bytes += id_to_node_.size() * (sizeof(uint64_t) + sizeof(uint32_t) + sizeof(void*));
+    return bytes;
+}
+
+} // namespace isaac
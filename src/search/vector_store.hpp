@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/mapped_file.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace isaac {
+
+// A single nearest-neighbour result (higher similarity = closer)
+struct VectorHit {
+    uint64_t chunk_id = 0;
+    float similarity = 0.0f;
+};
+
+/**
+ * Embedded approximate-nearest-neighbour store for chunk embeddings.
+ *
+ * Vectors are L2-normalized and quantized to int8 with a per-vector scale, so
+ * similarity is cosine. The index is an HNSW graph keyed by chunk ID; deletes
+ * are tombstones that are skipped in results and dropped by compact().
+ *
+ * save() writes a single segment file; open() maps that segment read-only and
+ * keeps the quantized vectors in the page cache instead of the heap. Vectors
+ * inserted after open() live in an in-memory tail until the next save().
+ */
+class VectorStore {
+public:
+    explicit VectorStore(size_t dim, size_t m = 16, size_t ef_construction = 200,
+                         uint32_t seed = 42);
+    ~VectorStore();
+
+    // Insert or replace the vector for a chunk ID
+    void insert(uint64_t chunk_id, const std::vector<float>& vector);
+
+    // Tombstone a chunk ID, returns false if it was not present
+    bool remove(uint64_t chunk_id);
+    bool contains(uint64_t chunk_id) const;
+
+    // Approximate k nearest neighbours (ef = 0 uses the configured ef_search)
+    std::vector<VectorHit> search(const std::vector<float>& query, size_t k, size_t ef = 0) const;
+
+    // Exhaustive scan over the same quantized vectors, used for recall measurement
+    std::vector<VectorHit> exact_search(const std::vector<float>& query, size_t k) const;
+
+    // Rebuild the graph from live vectors only
+    void compact();
+
+    bool save(const std::string& path);
+    static std::shared_ptr<VectorStore> open(const std::string& path);
+
+    // Safe while searches run: they read it once each
+    void set_ef_search(size_t ef) { ef_search_.store(ef, std::memory_order_relaxed); }
+    size_t dim() const { return dim_; }
+    size_t size() const;
+    size_t deleted_count() const;
+    size_t memory_usage() const;
+
+private:
+    using Candidate = std::pair<float, uint32_t>; // (distance, node)
+
+    struct Node {
+        uint64_t chunk_id = 0;
+        float scale = 0.0f;
+        bool deleted = false;
+        std::vector<std::vector<uint32_t>> links; // links[level]
+    };
+
+    void quantize(const std::vector<float>& input, std::vector<int8_t>& out, float& scale) const;
+    const int8_t* vector_at(uint32_t node) const;
+    float distance(const int8_t* q, float q_scale, uint32_t node) const;
+    float distance(uint32_t a, uint32_t b) const;
+    int random_level();
+
+    uint32_t greedy_descend(const int8_t* q, float q_scale, int top_level, int bottom_level) const;
+    std::vector<Candidate> search_layer(const int8_t* q, float q_scale, uint32_t entry,
+                                        size_t ef, int level, bool skip_deleted) const;
+    std::vector<uint32_t> select_neighbors(std::vector<Candidate> candidates, size_t m) const;
+    void insert_node(uint64_t chunk_id, std::vector<int8_t> quantized, float scale);
+
+    size_t dim_;
+    size_t m_;
+    size_t m0_;
+    size_t ef_construction_;
+    std::atomic<size_t> ef_search_{64};
+    double level_mult_;
+    std::mt19937 rng_;
+
+    std::vector<Node> nodes_;
+    std::unordered_map<uint64_t, uint32_t> id_to_node_;
+    uint32_t entry_point_ = 0;
+    int max_level_ = -1;
+    size_t deleted_ = 0;
+
+    // Quantized vectors: [0, mapped_count_) from the segment, the rest on the heap
+    MappedFile segment_;
+    const int8_t* mapped_vectors_ = nullptr;
+    size_t mapped_count_ = 0;
+    std::vector<int8_t> tail_vectors_;
+
+    mutable std::shared_mutex mutex_;
+};
+
+} // namespace isaac
@@ -0,0 +1,481 @@
+#include "snapshot_store.hpp"
+#include "core/varint.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace {
+
+enum RecordType : uint8_t { ChunkRecord = 1, SnapshotRecord = 2, RemoveRecord = 3 };
+enum DeltaOp : uint8_t { CopyOp = 0, LiteralOp = 1 };
+
+constexpr size_t kMaxChunk = 16 << 20;
+
+// Random per-byte values for the gear hash; fixed so chunk boundaries are stable across runs
+const std::array<uint64_t, 256>& gear_table() {
+    static const std::array<uint64_t, 256> table = [] {
+        std::array<uint64_t, 256> values{};
+        uint64_t state = 0x49534141435f4344ULL;
+        for (auto& value : values) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            value = z ^ (z >> 31);
+        }
+        return values;
+    }();
+    return table;
+}
+
+double now_seconds() {
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(system_clock::now().time_since_epoch()).count();
+}
+
+std::string as_string(const std::vector<uint8_t>& bytes) {
+    return std::string(bytes.begin(), bytes.end());
+}
+
+std::string_view digest_view(const Sha256::Digest& digest) {
+    return std::string_view(reinterpret_cast<const char*>(digest.data()), digest.size());
+}
+
+bool read_digest(VarintReader& reader, Sha256::Digest& digest) {
+    std::string raw;
+    if (!reader.string(raw) || raw.size() != digest.size()) return false;
+    std::memcpy(digest.data(), raw.data(), digest.size());
+    return true;
+}
+
+} // namespace
+
+SnapshotStore::SnapshotStore(std::string dir, SnapshotStoreOptions options)
+    : dir_(std::move(dir)),
+      options_(options),
+      log_(dir_, SegmentLogOptions{options.segment_bytes, options.sync}) {
+    const size_t avg = options_.avg_chunk;
+    if (options_.min_chunk == 0 || options_.min_chunk > avg || avg > options_.max_chunk ||
+        options_.max_chunk > kMaxChunk || (avg & (avg - 1)) != 0) {
+        throw std::invalid_argument("chunk sizes must satisfy 0 < min <= avg <= max <= 16 MiB, avg a power of two");
+    }
+    while ((size_t(1) << chunk_bits_) < avg) ++chunk_bits_;
+
+    log_.replay(LogPosition{0, 0}, [this](LogPosition at, std::string_view record) { apply_record(at, record); });
+}
+
+std::vector<size_t> SnapshotStore::chunk_sizes(const std::string& data) const {
+    const auto& gear = gear_table();
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    std::vector<size_t> sizes;
+    size_t offset = 0;
+    while (offset < data.size()) {
+        size_t remaining = data.size() - offset;
+        size_t length = std::min(remaining, options_.max_chunk);
+        if (remaining > options_.min_chunk) {
+            // A boundary is wherever the top chunk_bits_ of the hash are zero; the hash
+            // covers the last 64 bytes, so an edit moves at most the boundaries near it
+            uint64_t hash = 0;
+            for (size_t i = options_.min_chunk; i < length; ++i) {
+                hash = (hash << 1) + gear[bytes[offset + i]];
+                if ((hash >> (64 - chunk_bits_)) == 0) {
+                    length = i + 1;
+                    break;
+                }
+            }
+        }
+        sizes.push_back(length);
+        offset += length;
+    }
+    return sizes;
+}
+
+SnapshotInfo SnapshotStore::put(const std::string& id, const std::string& data, const std::string& metadata,
+                                double timestamp) {
+    if (id.empty()) {
+        throw std::invalid_argument("snapshot id must not be empty");
+    }
+
+    // Chunk and hash outside the lock
+    std::vector<size_t> sizes = chunk_sizes(data);
+    std::vector<Digest> digests;
+    digests.reserve(sizes.size());
+    size_t offset = 0;
+    for (size_t size : sizes) {
+        Sha256 hash;
+        hash.update(data.data() + offset, size);
+        digests.push_back(hash.finish());
+        offset += size;
+    }
+
+    Snapshot snapshot;
+    snapshot.info.id = id;
+    // Microsecond precision, as the manifest stores it
+    snapshot.info.timestamp = std::round((timestamp > 0 ? timestamp : now_seconds()) * 1e6) / 1e6;
+    snapshot.info.metadata = metadata;
+    snapshot.info.size = data.size();
+    snapshot.info.chunks = digests.size();
+
+    uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        offset = 0;
+        for (size_t i = 0; i < digests.size(); ++i) {
+            if (chunks_.find(digests[i]) == chunks_.end()) {
+                std::vector<uint8_t> record{ChunkRecord};
+                put_string(record, digest_view(digests[i]));
+                record.insert(record.end(), data.begin() + offset, data.begin() + offset + sizes[i]);
+                Chunk chunk;
+                chunk.size = static_cast<uint32_t>(sizes[i]);
+                log_.write(as_string(record), &chunk.at);
+                chunks_.emplace(digests[i], chunk);
+                dead_bytes_ += chunk.size;
+                ++snapshot.info.new_chunks;
+                snapshot.info.new_bytes += chunk.size;
+            }
+            offset += sizes[i];
+        }
+
+        snapshot.info.base = base_for(id);
+        snapshot.chunks = std::move(digests);
+        for (const Digest& digest : snapshot.chunks) reference(digest);
+        lsn = write_manifest(snapshot);
+
+        auto existing = snapshots_.find(id);
+        if (existing != snapshots_.end()) {
+            retire(existing->second);
+            existing->second = snapshot;
+        } else {
+            snapshots_.emplace(id, snapshot);
+            order_.push_back(id);
+        }
+        logical_bytes_ += snapshot.info.size;
+    }
+    log_.sync(lsn);
+    maybe_compact();
+    return snapshot.info;
+}
+
+std::optional<std::string> SnapshotStore::get(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = snapshots_.find(id);
+    if (it == snapshots_.end()) return std::nullopt;
+
+    // A put on another thread may still be committing the chunks
+    log_.sync(log_.last_lsn());
+    std::string data;
+    data.reserve(it->second.info.size);
+    std::string record;
+    for (const Digest& digest : it->second.chunks) {
+        const Chunk& chunk = chunks_.at(digest);
+        if (!log_.read(chunk.at, record) || record.size() < chunk.size) {
+            throw std::runtime_error("unreadable snapshot chunk in " + dir_);
+        }
+        data.append(record, record.size() - chunk.size, chunk.size);
+    }
+    return data;
+}
+
+std::optional<SnapshotInfo> SnapshotStore::info(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = snapshots_.find(id);
+    if (it == snapshots_.end()) return std::nullopt;
+    return it->second.info;
+}
+
+std::vector<SnapshotInfo> SnapshotStore::list() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<SnapshotInfo> result;
+    result.reserve(order_.size());
+    for (const std::string& id : order_) result.push_back(snapshots_.at(id).info);
+    return result;
+}
+
+bool SnapshotStore::contains(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshots_.count(id) > 0;
+}
+
+bool SnapshotStore::remove(const std::string& id) {
+    uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = snapshots_.find(id);
+        if (it == snapshots_.end()) return false;
+        std::vector<uint8_t> record{RemoveRecord};
+        put_string(record, id);
+        lsn = log_.write(as_string(record));
+        dead_bytes_ += record.size();
+        retire(it->second);
+        snapshots_.erase(it);
+        order_.erase(std::find(order_.begin(), order_.end(), id));
+    }
+    log_.sync(lsn);
+    maybe_compact();
+    return true;
+}
+
+uint64_t SnapshotStore::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log_.sync(log_.last_lsn());
+    if (dead_bytes_ == 0) return 0;
+    const uint64_t before = log_.size_bytes();
+
+    // Rewrite into fresh segments: each snapshot's new chunks, then its manifest
+    log_.roll();
+    const LogPosition start = log_.end();
+    std::unordered_map<Digest, LogPosition, DigestHash> moved;
+    std::vector<std::pair<std::string, uint64_t>> manifests;   // (base, record bytes) per snapshot
+    std::string record;
+    std::string base;
+    uint64_t lsn = 0;
+    uint64_t unsynced = 0;
+    for (const std::string& id : order_) {
+        Snapshot& snapshot = snapshots_.at(id);
+        for (const Digest& digest : snapshot.chunks) {
+            if (moved.count(digest)) continue;
+            if (!log_.read(chunks_.at(digest).at, record)) {
+                throw std::runtime_error("unreadable snapshot chunk in " + dir_);
+            }
+            LogPosition at;
+            lsn = log_.write(record, &at);
+            moved.emplace(digest, at);
+            unsynced += record.size();
+        }
+        SnapshotInfo info = snapshot.info;
+        info.base = base;
+        std::string manifest = encode_manifest(info, snapshot.chunks);
+        lsn = log_.write(manifest);
+        manifests.emplace_back(base, manifest.size());
+        unsynced += manifest.size();
+        base = id;
+        if (unsynced >= options_.segment_bytes) {
+            log_.sync(lsn);     // bound the memory the rewrite buffers
+            unsynced = 0;
+        }
+    }
+    if (lsn) log_.sync(lsn);
+
+    // The new copies are durable; switch over and forget the garbage
+    for (auto it = chunks_.begin(); it != chunks_.end();) {
+        auto target = moved.find(it->first);
+        if (target == moved.end()) {
+            it = chunks_.erase(it);
+        } else {
+            it->second.at = target->second;
+            ++it;
+        }
+    }
+    for (size_t i = 0; i < order_.size(); ++i) {
+        Snapshot& snapshot = snapshots_.at(order_[i]);
+        snapshot.info.base = manifests[i].first;
+        snapshot.record_bytes = manifests[i].second;
+    }
+    dead_bytes_ = 0;
+    log_.drop_before(start.segment);
+
+    const uint64_t after = log_.size_bytes();
+    return before > after ? before - after : 0;
+}
+
+SnapshotStoreStats SnapshotStore::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SnapshotStoreStats stats;
+    stats.snapshots = snapshots_.size();
+    for (const auto& [digest, chunk] : chunks_) {
+        if (chunk.refs > 0) ++stats.chunks;
+    }
+    stats.logical_bytes = logical_bytes_;
+    stats.stored_bytes = stored_bytes_;
+    stats.dead_bytes = dead_bytes_;
+    stats.disk_bytes = log_.size_bytes();
+    return stats;
+}
+
+// Chunk list as copy runs from the base's list plus literal digests
+std::string SnapshotStore::encode_manifest(const SnapshotInfo& info, const std::vector<Digest>& chunks) const {
+    std::vector<uint8_t> record{SnapshotRecord};
+    put_string(record, info.id);
+    varint_encode(record, zigzag_encode(static_cast<int64_t>(std::llround(info.timestamp * 1e6))));
+    put_string(record, info.base);
+    put_string(record, info.metadata);
+    varint_encode(record, info.size);
+    varint_encode(record, info.new_chunks);
+    varint_encode(record, info.new_bytes);
+
+    static const std::vector<Digest> kNone;
+    auto base = info.base.empty() ? snapshots_.end() : snapshots_.find(info.base);
+    const std::vector<Digest>& previous = base == snapshots_.end() ? kNone : base->second.chunks;
+    std::unordered_map<Digest, size_t, DigestHash> first;
+    for (size_t i = previous.size(); i-- > 0;) first[previous[i]] = i;
+
+    std::vector<uint8_t> ops;
+    size_t op_count = 0;
+    size_t i = 0;
+    while (i < chunks.size()) {
+        auto match = first.find(chunks[i]);
+        if (match != first.end()) {
+            size_t from = match->second;
+            size_t length = 1;
+            while (i + length < chunks.size() && from + length < previous.size() &&
+                   chunks[i + length] == previous[from + length]) {
+                ++length;
+            }
+            ops.push_back(CopyOp);
+            varint_encode(ops, from);
+            varint_encode(ops, length);
+            i += length;
+        } else {
+            size_t end = i + 1;
+            while (end < chunks.size() && first.find(chunks[end]) == first.end()) ++end;
+            ops.push_back(LiteralOp);
+            varint_encode(ops, end - i);
+            for (; i < end; ++i) put_string(ops, digest_view(chunks[i]));
+        }
+        ++op_count;
+    }
+    varint_encode(record, op_count);
+    record.insert(record.end(), ops.begin(), ops.end());
+    return as_string(record);
+}
+
+uint64_t SnapshotStore::write_manifest(Snapshot& snapshot) {
+    std::string record = encode_manifest(snapshot.info, snapshot.chunks);
+    snapshot.record_bytes = record.size();
+    return log_.write(record);
+}
+
+bool SnapshotStore::apply_record(LogPosition at, std::string_view record) {
+    VarintReader reader(record);
+    uint8_t type;
+    if (!reader.byte(type)) return false;
+
+    if (type == ChunkRecord) {
+        Digest digest;
+        if (!read_digest(reader, digest)) return false;
+        Chunk chunk;
+        chunk.at = at;
+        chunk.size = static_cast<uint32_t>(record.size() - reader.position());
+        auto [it, inserted] = chunks_.emplace(digest, chunk);
+        if (inserted) {
+            dead_bytes_ += chunk.size;
+        } else {
+            it->second.at = at;     // rewritten by an interrupted compaction
+        }
+        return true;
+    }
+
+    std::string id;
+    if (!reader.string(id)) return false;
+
+    if (type == RemoveRecord) {
+        auto it = snapshots_.find(id);
+        if (it == snapshots_.end()) return false;
+        dead_bytes_ += record.size();
+        retire(it->second);
+        snapshots_.erase(it);
+        order_.erase(std::find(order_.begin(), order_.end(), id));
+        return true;
+    }
+    if (type != SnapshotRecord) return false;
+
+    Snapshot snapshot;
+    snapshot.info.id = id;
+    int64_t timestamp_us;
+    uint64_t size, new_chunks, new_bytes, op_count;
+    if (!reader.signed_number(timestamp_us) || !reader.string(snapshot.info.base) ||
+        !reader.string(snapshot.info.metadata) || !reader.number(size) || !reader.number(new_chunks) ||
+        !reader.number(new_bytes) || !reader.number(op_count)) {
+        return false;
+    }
+    snapshot.info.timestamp = static_cast<double>(timestamp_us) / 1e6;
+    snapshot.info.size = size;
+    snapshot.info.new_chunks = new_chunks;
+    snapshot.info.new_bytes = new_bytes;
+
+    // The base was live when the manifest was written, so replay has it too
+    const std::vector<Digest>* previous = nullptr;
+    if (!snapshot.info.base.empty()) {
+        auto base = snapshots_.find(snapshot.info.base);
+        if (base == snapshots_.end()) return false;
+        previous = &base->second.chunks;
+    }
+    for (uint64_t n = 0; n < op_count; ++n) {
+        uint8_t op;
+        uint64_t a, b;
+        if (!reader.byte(op) || !reader.number(a)) return false;
+        if (op == CopyOp) {
+            if (!reader.number(b) || !previous || a > previous->size() || b > previous->size() - a) return false;
+            snapshot.chunks.insert(snapshot.chunks.end(), previous->begin() + a, previous->begin() + a + b);
+        } else if (op == LiteralOp) {
+            for (uint64_t k = 0; k < a; ++k) {
+                Digest digest;
+                if (!read_digest(reader, digest)) return false;
+                snapshot.chunks.push_back(digest);
+            }
+        } else {
+            return false;
+        }
+    }
+    for (const Digest& digest : snapshot.chunks) {
+        if (chunks_.find(digest) == chunks_.end()) return false;
+    }
+    snapshot.info.chunks = snapshot.chunks.size();
+    snapshot.record_bytes = record.size();
+
+    for (const Digest& digest : snapshot.chunks) reference(digest);
+    auto existing = snapshots_.find(id);
+    if (existing != snapshots_.end()) {
+        retire(existing->second);
+        existing->second = std::move(snapshot);
+        logical_bytes_ += existing->second.info.size;
+    } else {
+        logical_bytes_ += snapshot.info.size;
+        snapshots_.emplace(id, std::move(snapshot));
+        order_.push_back(id);
+    }
+    return true;
+}
+
+void SnapshotStore::reference(const Digest& digest) {
+    Chunk& chunk = chunks_.at(digest);
+    if (chunk.refs++ == 0) {
+        stored_bytes_ += chunk.size;
+        dead_bytes_ -= chunk.size;
+    }
+}
+
+void SnapshotStore::release(const Digest& digest) {
+    Chunk& chunk = chunks_.at(digest);
+    if (--chunk.refs == 0) {
+        stored_bytes_ -= chunk.size;
+        dead_bytes_ += chunk.size;
+    }
+}
+
+// Drop a superseded or removed snapshot's references (the map entry stays with the caller)
+void SnapshotStore::retire(Snapshot& snapshot) {
+    for (const Digest& digest : snapshot.chunks) release(digest);
+    dead_bytes_ += snapshot.record_bytes;
+    logical_bytes_ -= snapshot.info.size;
+}
+
+// Delta base for id: its predecessor in order_, or the newest snapshot for a new id
+std::string SnapshotStore::base_for(const std::string& id) const {
+    auto it = std::find(order_.begin(), order_.end(), id);
+    if (it == order_.begin()) return "";
+    return *std::prev(it);
+}
+
+void SnapshotStore::maybe_compact() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (dead_bytes_ < options_.compact_dead_bytes || dead_bytes_ <= stored_bytes_) return;
+    }
+    compact();
+}
+
+} // namespace isaac
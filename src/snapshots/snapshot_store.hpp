@@ -0,0 +1,130 @@
+#pragma once
+
+#include "core/sha256.hpp"
+#include "queue/segment_log.hpp"
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+struct SnapshotInfo {
+    std::string id;
+    double timestamp = 0;               // unix seconds
+    std::string base;                   // snapshot the manifest is delta-encoded against ("" = none)
+    std::string metadata;
+    uint64_t size = 0;                  // bytes of the stored document
+    size_t chunks = 0;
+    size_t new_chunks = 0;              // chunks this snapshot added to the store
+    uint64_t new_bytes = 0;
+};
+
+struct SnapshotStoreStats {
+    size_t snapshots = 0;
+    size_t chunks = 0;                  // distinct live chunks
+    uint64_t logical_bytes = 0;         // sum of snapshot sizes
+    uint64_t stored_bytes = 0;          // live chunk bytes
+    uint64_t dead_bytes = 0;            // unreferenced chunks and superseded manifests
+    uint64_t disk_bytes = 0;            // log segments on disk
+};
+
+struct SnapshotStoreOptions {
+    size_t segment_bytes = 4 << 20;
+    bool sync = true;
+    size_t min_chunk = 256;
+    size_t avg_chunk = 1024;            // power of two
+    size_t max_chunk = 8192;
+    uint64_t compact_dead_bytes = 8 << 20;  // compact on its own past this much garbage
+};
+
+/**
+ * Content-addressed store for workspace snapshots.
+ *
+ * Documents are split with content-defined chunking (a gear rolling hash),
+ * so an edit only changes the chunks around it, and chunks are keyed by
+ * SHA-256 and stored once however many snapshots share them. A snapshot is
+ * a manifest: its chunk list, delta-encoded as copy runs from the previous
+ * snapshot plus the digests that are new. Chunks and manifests go to one
+ * append-only SegmentLog, chunks first, so a manifest never becomes durable
+ * without its data and a crash only loses whole trailing snapshots.
+ *
+ * Removing a snapshot drops references; compact() rewrites the live chunks
+ * and manifests into fresh segments and deletes the old ones. A crash during
+ * compaction leaves both copies, which replay resolves to the same state.
+ */
+class SnapshotStore {
+public:
+    explicit SnapshotStore(std::string dir, SnapshotStoreOptions options = {});
+
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    // Store data under id, replacing an existing snapshot in place.
+    // timestamp = 0 means now; throws std::invalid_argument for an empty id.
+    SnapshotInfo put(const std::string& id, const std::string& data, const std::string& metadata = "",
+                     double timestamp = 0);
+    // Reassembled document; throws std::runtime_error if a chunk is unreadable
+    std::optional<std::string> get(const std::string& id) const;
+    std::optional<SnapshotInfo> info(const std::string& id) const;
+    std::vector<SnapshotInfo> list() const;         // in the order first stored
+    bool remove(const std::string& id);
+    bool contains(const std::string& id) const;
+
+    // Rewrite live data and drop the old segments; returns the bytes reclaimed
+    uint64_t compact();
+    SnapshotStoreStats stats() const;
+
+    // Content-defined chunk lengths for data under these options
+    std::vector<size_t> chunk_sizes(const std::string& data) const;
+
+private:
+    using Digest = Sha256::Digest;
+
+    struct DigestHash {
+        size_t operator()(const Digest& digest) const {
+            size_t value;
+            std::memcpy(&value, digest.data(), sizeof(value));
+            return value;
+        }
+    };
+
+    struct Chunk {
+        LogPosition at;
+        uint32_t size = 0;
+        uint32_t refs = 0;
+    };
+
+    struct Snapshot {
+        SnapshotInfo info;
+        std::vector<Digest> chunks;
+        uint64_t record_bytes = 0;      // manifest size in the log
+    };
+
+    std::string encode_manifest(const SnapshotInfo& info, const std::vector<Digest>& chunks) const;
+    uint64_t write_manifest(Snapshot& snapshot);                        // caller holds mutex_
+    bool apply_record(LogPosition at, std::string_view record);         // replay
+    void reference(const Digest& digest);
+    void release(const Digest& digest);
+    void retire(Snapshot& snapshot);
+    std::string base_for(const std::string& id) const;
+    void maybe_compact();
+
+    std::string dir_;
+    SnapshotStoreOptions options_;
+    int chunk_bits_ = 0;
+    mutable SegmentLog log_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Digest, Chunk, DigestHash> chunks_;
+    std::unordered_map<std::string, Snapshot> snapshots_;
+    std::vector<std::string> order_;
+    uint64_t logical_bytes_ = 0;
+    uint64_t stored_bytes_ = 0;
+    uint64_t dead_bytes_ = 0;
+};
+
+} // namespace isaac
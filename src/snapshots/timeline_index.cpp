@@ -0,0 +1,205 @@
+#include "timeline_index.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace {
+
+const char* const kFields[] = {"branch", "path", "change_type", "bubble_id", "tag"};
+
+void add_posting(std::vector<uint64_t>& postings, uint64_t seq) {
+    if (postings.empty() || postings.back() != seq) postings.push_back(seq);
+}
+
+} // namespace
+
+std::vector<std::string> TimelineIndex::tokenize(std::string_view text) {
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if ((byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'z') || byte >= 0x80) {
+            word.push_back(c);
+        } else if (byte >= 'A' && byte <= 'Z') {
+            word.push_back(static_cast<char>(byte - 'A' + 'a'));
+        } else if (!word.empty()) {
+            words.push_back(std::move(word));
+            word.clear();
+        }
+    }
+    if (!word.empty()) words.push_back(std::move(word));
+    return words;
+}
+
+std::string TimelineIndex::field_key(std::string_view field, std::string_view value) {
+    std::string key(field);
+    key.push_back('\0');
+    key.append(value);
+    return key;
+}
+
+size_t TimelineIndex::append(const TimelineRecord& record) {
+    const uint64_t seq = next_seq_++;
+    records_.push_back(Entry{seq, record.timestamp});
+
+    auto at = std::make_pair(record.timestamp, seq);
+    if (by_time_.empty() || by_time_.back() < at) {
+        by_time_.push_back(at);
+    } else {
+        by_time_.insert(std::upper_bound(by_time_.begin(), by_time_.end(), at), at);
+    }
+
+    std::vector<std::string> words;
+    for (const std::string* text :
+         {&record.description, &record.change_type, &record.branch, &record.path}) {
+        for (std::string& word : tokenize(*text)) words.push_back(std::move(word));
+    }
+    for (const std::string& tag : record.tags) {
+        for (std::string& word : tokenize(tag)) words.push_back(std::move(word));
+    }
+    for (const std::string& word : words) add_posting(words_[word], seq);
+
+    if (!record.branch.empty()) add_posting(fields_[field_key("branch", record.branch)], seq);
+    if (!record.path.empty()) add_posting(fields_[field_key("path", record.path)], seq);
+    add_posting(fields_[field_key("change_type", record.change_type)], seq);
+    add_posting(fields_[field_key("bubble_id", record.bubble_id)], seq);
+    for (const std::string& tag : record.tags) add_posting(fields_[field_key("tag", tag)], seq);
+    return records_.size() - 1;
+}
+
+void TimelineIndex::drop_front(size_t n) {
+    n = std::min(n, records_.size());
+    if (n == 0) return;
+    records_.erase(records_.begin(), records_.begin() + static_cast<std::ptrdiff_t>(n));
+    first_seq_ += n;
+    by_time_.erase(std::remove_if(by_time_.begin(), by_time_.end(),
+                                  [this](const auto& item) { return item.second < first_seq_; }),
+                   by_time_.end());
+    dropped_ += n;
+    if (dropped_ > records_.size()) purge();
+}
+
+void TimelineIndex::clear() {
+    records_.clear();
+    by_time_.clear();
+    words_.clear();
+    fields_.clear();
+    first_seq_ = next_seq_;
+    dropped_ = 0;
+}
+
+// Cut the dropped prefix off every posting list
+void TimelineIndex::purge() {
+    auto trim = [this](Postings& postings) {
+        postings.erase(postings.begin(), std::lower_bound(postings.begin(), postings.end(), first_seq_));
+        return postings.empty();
+    };
+    for (auto it = words_.begin(); it != words_.end();) {
+        it = trim(it->second) ? words_.erase(it) : std::next(it);
+    }
+    for (auto it = fields_.begin(); it != fields_.end();) {
+        it = trim(it->second) ? fields_.erase(it) : std::next(it);
+    }
+    dropped_ = 0;
+}
+
+bool TimelineIndex::in_range(uint64_t seq, double since, double until) const {
+    if (seq < first_seq_) return false;
+    double timestamp = records_[seq - first_seq_].timestamp;
+    return timestamp >= since && timestamp <= until;
+}
+
+std::optional<size_t> TimelineIndex::at_or_before(double timestamp) const {
+    auto it = std::upper_bound(by_time_.begin(), by_time_.end(), std::make_pair(timestamp, UINT64_MAX));
+    if (it == by_time_.begin()) return std::nullopt;
+    return static_cast<size_t>(std::prev(it)->second - first_seq_);
+}
+
+std::vector<size_t> TimelineIndex::between(double since, double until) const {
+    auto first = std::lower_bound(by_time_.begin(), by_time_.end(), std::make_pair(since, uint64_t{0}));
+    auto last = std::upper_bound(by_time_.begin(), by_time_.end(), std::make_pair(until, UINT64_MAX));
+    std::vector<size_t> result;
+    for (auto it = first; it < last; ++it) result.push_back(static_cast<size_t>(it->second - first_seq_));
+    return result;
+}
+
+std::optional<size_t> TimelineIndex::last_with(const std::string& field, const std::string& value,
+                                               double before) const {
+    if (std::find(std::begin(kFields), std::end(kFields), field) == std::end(kFields)) {
+        throw std::invalid_argument("Unknown timeline field '" + field + "'");
+    }
+    auto it = fields_.find(field_key(field, value));
+    if (it == fields_.end()) return std::nullopt;
+    for (auto seq = it->second.rbegin(); seq != it->second.rend() && *seq >= first_seq_; ++seq) {
+        if (in_range(*seq, -kNoLimit, before)) return static_cast<size_t>(*seq - first_seq_);
+    }
+    return std::nullopt;
+}
+
+std::vector<size_t> TimelineIndex::search(const std::string& query, size_t limit, double since,
+                                          double until) const {
+    std::vector<std::string> terms = tokenize(query);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    std::vector<size_t> result;
+    auto collect = [&](uint64_t seq) {
+        if (!in_range(seq, since, until)) return true;
+        result.push_back(static_cast<size_t>(seq - first_seq_));
+        return limit == 0 || result.size() < limit;
+    };
+
+    if (terms.empty()) {
+        for (uint64_t seq = next_seq_; seq-- > first_seq_;) {
+            if (!collect(seq)) break;
+        }
+        return result;
+    }
+
+    // Each term matches every indexed word it prefixes; entries must match all
+    // terms. Walk the cheapest term's matches newest first and probe the rest,
+    // so a limited search stops early instead of intersecting whole lists.
+    std::vector<std::vector<const Postings*>> matches;
+    for (const std::string& term : terms) {
+        std::vector<const Postings*> lists;
+        for (auto it = words_.lower_bound(term); it != words_.end() && it->first.compare(0, term.size(), term) == 0;
+             ++it) {
+            lists.push_back(&it->second);
+        }
+        if (lists.empty()) return result;
+        matches.push_back(std::move(lists));
+    }
+    auto cost = [](const std::vector<const Postings*>& lists) {
+        size_t total = 0;
+        for (const Postings* postings : lists) total += postings->size();
+        return total;
+    };
+    std::sort(matches.begin(), matches.end(),
+              [&](const auto& a, const auto& b) { return cost(a) < cost(b); });
+
+    Postings merged;
+    const Postings* driver = matches[0][0];
+    if (matches[0].size() > 1) {
+        for (const Postings* postings : matches[0]) {
+            merged.insert(merged.end(), std::lower_bound(postings->begin(), postings->end(), first_seq_),
+                          postings->end());
+        }
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        driver = &merged;
+    }
+
+    for (auto seq = driver->rbegin(); seq != driver->rend() && *seq >= first_seq_; ++seq) {
+        bool all = true;
+        for (size_t i = 1; i < matches.size() && all; ++i) {
+            all = std::any_of(matches[i].begin(), matches[i].end(), [&](const Postings* postings) {
+                return std::binary_search(postings->begin(), postings->end(), *seq);
+            });
+        }
+        if (all && !collect(*seq)) break;
+    }
+    return result;
+}
+
+} // namespace isaac
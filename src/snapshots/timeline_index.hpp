@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace isaac {
+
+struct TimelineRecord {
+    double timestamp = 0;               // unix seconds
+    std::string bubble_id;
+    std::string change_type;            // auto, manual, restore, ...
+    std::string description;
+    std::string branch;
+    std::string path;
+    std::vector<std::string> tags;
+};
+
+/**
+ * In-memory index over the time machine's timeline, so history queries
+ * never load snapshot payloads.
+ *
+ * Entries are addressed by their position in the timeline (0 = oldest
+ * live entry); appends go to the end and trimming drops from the front.
+ * A (timestamp, position) array kept sorted answers point-in-time and range
+ * queries by binary search, per-field posting lists answer "last entry on
+ * branch X", and an inverted index over the words of the description,
+ * change type, tags, branch and path answers text search: every query word
+ * must be a prefix of some indexed word. Posting lists are ascending, so the
+ * newest matches are read from the back. Dropped entries are skipped lazily
+ * and purged once they outnumber the live ones.
+ */
+class TimelineIndex {
+public:
+    static constexpr double kNoLimit = std::numeric_limits<double>::infinity();
+
+    // Returns the new entry's position
+    size_t append(const TimelineRecord& record);
+    // Forget the n oldest entries; positions shift down by n
+    void drop_front(size_t n);
+    void clear();
+    size_t size() const { return records_.size(); }
+
+    // Entry stamped closest at or before timestamp (the later one on ties)
+    std::optional<size_t> at_or_before(double timestamp) const;
+    // Entries stamped in [since, until], oldest first
+    std::vector<size_t> between(double since, double until) const;
+    // Newest entry stamped at or before `before` whose field equals value: "branch", "path", "change_type", "bubble_id" or "tag";
+    // throws std::invalid_argument for another field
+    std::optional<size_t> last_with(const std::string& field, const std::string& value,
+                                    double before = kNoLimit) const;
+    // Newest first; limit 0 = all
+    std::vector<size_t> search(const std::string& query, size_t limit = 0, double since = -kNoLimit,
+                               double until = kNoLimit) const;
+
+    // Lowercased words as the index sees them
+    static std::vector<std::string> tokenize(std::string_view text);
+
+private:
+    using Postings = std::vector<uint64_t>;     // sequence numbers, ascending
+
+    struct Entry {
+        uint64_t seq;
+        double timestamp;
+    };
+
+    static std::string field_key(std::string_view field, std::string_view value);
+    void purge();
+    bool in_range(uint64_t seq, double since, double until) const;
+
+    std::deque<Entry> records_;                         // timeline order
+    std::vector<std::pair<double, uint64_t>> by_time_;  // sorted (timestamp, seq)
+    std::map<std::string, Postings> words_;             // ordered for prefix lookups
+    std::unordered_map<std::string, Postings> fields_;
+    uint64_t first_seq_ = 0;                            // seq of records_[0]
+    uint64_t next_seq_ = 0;
+    size_t dropped_ = 0;                                // stale postings since the last purge
+};
+
+} // namespace isaac
@@ -0,0 +1,493 @@
+#include "workspace_capture.hpp"
+#include "core/mapped_file.hpp"
+#include "core/sha1.hpp"
+#include "core/sha256.hpp"
+#include "fileops/file_walker.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+#include <utility>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#endif
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int64_t kMaxHashedFile = 64 << 20;
+
+std::string canonical_or_self(const std::string& path) {
+    std::error_code ec;
+    fs::path resolved = fs::weakly_canonical(fs::u8path(path), ec);
+    return ec ? path : resolved.u8string();
+}
+
+bool is_within(const std::string& path, const std::string& root) {
+    if (root == "/") return !path.empty() && path[0] == '/';
+    return path.size() >= root.size() && path.compare(0, root.size(), root) == 0 &&
+           (path.size() == root.size() || path[root.size()] == '/');
+}
+
+std::string read_text(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+std::string trim(std::string text) {
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r' || text.back() == ' ')) text.pop_back();
+    return text;
+}
+
+#ifdef __linux__
+// Whole small file relative to an open directory (procfs reports size 0, so read to EOF)
+bool read_at(int dir_fd, const char* name, std::string& out) {
+    int fd = ::openat(dir_fd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    out.clear();
+    char buffer[4096];
+    for (;;) {
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        out.append(buffer, static_cast<size_t>(n));
+        if (out.size() > (1 << 20)) break;
+    }
+    ::close(fd);
+    return true;
+}
+
+bool readlink_at(int dir_fd, const char* name, std::string& out) {
+    char buffer[4096];
+    ssize_t n = ::readlinkat(dir_fd, name, buffer, sizeof(buffer));
+    if (n < 0 || static_cast<size_t>(n) >= sizeof(buffer)) return false;
+    out.assign(buffer, static_cast<size_t>(n));
+    return true;
+}
+
+// "pid (comm) S ppid ..." -- comm may itself contain spaces and parentheses
+bool parse_stat(const std::string& stat, ProcessInfo& info) {
+    size_t open = stat.find('(');
+    size_t close = stat.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open) return false;
+    info.name = stat.substr(open + 1, close - open - 1);
+
+    std::istringstream fields(stat.substr(close + 1));
+    std::string field;
+    std::vector<std::string> values;     // values[0] is field 3 (state)
+    while (values.size() < 22 && fields >> field) values.push_back(field);
+    if (values.size() < 22) return false;
+    info.state = values[0].empty() ? '?' : values[0][0];
+    info.ppid = std::atoi(values[1].c_str());
+    info.rss_bytes = std::strtoull(values[21].c_str(), nullptr, 10) * static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    return true;
+}
+
+void read_open_files(int pid_fd, const std::string& root, std::vector<std::string>& files) {
+    int fd_dir = ::openat(pid_fd, "fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd_dir < 0) return;
+    DIR* dir = ::fdopendir(fd_dir);
+    if (!dir) {
+        ::close(fd_dir);
+        return;
+    }
+    std::string target;
+    while (dirent* entry = ::readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        if (!readlink_at(fd_dir, entry->d_name, target) || !is_within(target, root) || target == root) continue;
+        if (std::find(files.begin(), files.end(), target) == files.end()) files.push_back(target);
+        if (files.size() >= 32) break;
+    }
+    ::closedir(dir);
+}
+#endif
+
+// Index entries as (path, stat fields, blob id); v2-v4, see git's Documentation/gitformat-index.txt
+struct IndexEntry {
+    std::string path;
+    std::string id;                     // raw blob id (20 bytes, 32 in sha256 repositories)
+    uint32_t mtime_sec = 0;
+    uint32_t mtime_nsec = 0;
+    uint32_t mode = 0;
+    uint32_t size = 0;
+    bool skip = false;                  // unmerged or skip-worktree
+};
+
+uint32_t be32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+uint16_t be16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+bool parse_index(const MappedFile& file, size_t id_size, std::vector<IndexEntry>& entries) {
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+    if (size < 12 || std::memcmp(data, "DIRC", 4) != 0) return false;
+    const uint32_t version = be32(data + 4);
+    if (version < 2 || version > 4) return false;
+    const uint32_t count = be32(data + 8);
+    const size_t fixed = 40 + id_size + 2;     // stat fields, blob id, flags
+    if (count > size / fixed) return false;
+    entries.reserve(count);
+
+    size_t pos = 12;
+    std::string previous;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos + fixed > size) return false;
+        const uint8_t* entry = data + pos;
+        IndexEntry parsed;
+        parsed.mtime_sec = be32(entry + 8);
+        parsed.mtime_nsec = be32(entry + 12);
+        parsed.mode = be32(entry + 24);
+        parsed.size = be32(entry + 36);
+        parsed.id.assign(reinterpret_cast<const char*>(entry + 40), id_size);
+        const uint16_t flags = be16(entry + 40 + id_size);
+        size_t header = fixed;
+        if (flags & 0x4000) {           // extended flags (v3+)
+            if (pos + fixed + 2 > size) return false;
+            if (be16(entry + fixed) & 0x4000) parsed.skip = true;  // skip-worktree
+            header = fixed + 2;
+        }
+        if (flags & 0x3000) parsed.skip = true;                 // merge stage != 0
+
+        size_t name_start = pos + header;
+        if (version == 4) {
+            // Prefix compression: strip N bytes from the previous path, append a NUL-terminated suffix
+            uint64_t strip = 0;
+            size_t p = name_start;
+            if (p >= size) return false;
+            uint8_t byte = data[p++];
+            strip = byte & 0x7f;
+            while (byte & 0x80) {
+                if (p >= size) return false;
+                byte = data[p++];
+                strip = ((strip + 1) << 7) | (byte & 0x7f);
+            }
+            const void* nul = std::memchr(data + p, 0, size - p);
+            if (!nul || strip > previous.size()) return false;
+            size_t end = static_cast<const uint8_t*>(nul) - data;
+            parsed.path = previous.substr(0, previous.size() - strip);
+            parsed.path.append(reinterpret_cast<const char*>(data + p), end - p);
+            pos = end + 1;
+        } else {
+            const void* nul = std::memchr(data + name_start, 0, size - name_start);
+            if (!nul) return false;
+            size_t end = static_cast<const uint8_t*>(nul) - data;
+            parsed.path.assign(reinterpret_cast<const char*>(data + name_start), end - name_start);
+            // Entries are NUL-padded to a multiple of 8 bytes
+            size_t length = header + parsed.path.size();
+            pos += (length + 8) & ~size_t(7);
+        }
+        previous = parsed.path;
+        entries.push_back(std::move(parsed));
+    }
+    return true;
+}
+
+// Commit id for a ref: loose file first, then packed-refs
+std::string resolve_ref(const fs::path& common_dir, const std::string& ref) {
+    std::string loose = trim(read_text(common_dir / fs::u8path(ref)));
+    if (!loose.empty()) return loose;
+    std::ifstream packed(common_dir / "packed-refs");
+    std::string line;
+    while (std::getline(packed, line)) {
+        if (line.empty() || line[0] == '#' || line[0] == '^') continue;
+        size_t space = line.find(' ');
+        if (space != std::string::npos && line.compare(space + 1, std::string::npos, ref) == 0) {
+            return line.substr(0, space);
+        }
+    }
+    return "";
+}
+
+// Does the work-tree file still hash to the blob id in the index?
+bool same_blob(const fs::path& path, const IndexEntry& entry) {
+    std::string content;
+    if ((entry.mode & 0170000) == 0120000) {
+        std::error_code ec;
+        content = fs::read_symlink(path, ec).u8string();
+        if (ec) return false;
+    } else {
+        MappedFile file;
+        if (!file.open(path.u8string())) return false;
+        content.assign(file.view());
+    }
+    const std::string header = "blob " + std::to_string(content.size()) + '\0';
+    if (entry.id.size() == 32) {
+        Sha256 hash;
+        hash.update(header);
+        hash.update(content);
+        auto digest = hash.finish();
+        return entry.id.compare(0, std::string::npos, reinterpret_cast<const char*>(digest.data()), digest.size()) == 0;
+    }
+    Sha1 hash;
+    hash.update(header);
+    hash.update(content);
+    auto digest = hash.finish();
+    return entry.id.compare(0, std::string::npos, reinterpret_cast<const char*>(digest.data()), digest.size()) == 0;
+}
+
+void add_capped(std::vector<std::string>& list, std::string item, size_t cap, bool& truncated) {
+    if (list.size() < cap) {
+        list.push_back(std::move(item));
+    } else {
+        truncated = true;
+    }
+}
+
+} // namespace
+
+std::vector<ProcessInfo> WorkspaceCapture::processes(const std::string& root, size_t limit, bool open_files) const {
+    std::vector<ProcessInfo> result;
+#ifdef __linux__
+    const std::string base = canonical_or_self(root);
+    DIR* proc = ::opendir("/proc");
+    if (!proc) return result;
+    const int proc_fd = ::dirfd(proc);
+
+    std::string cwd, text;
+    while (dirent* entry = ::readdir(proc)) {
+        char* end;
+        long pid = std::strtol(entry->d_name, &end, 10);
+        if (*end != '\0' || pid <= 0) continue;
+
+        int pid_fd = ::openat(proc_fd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (pid_fd < 0) continue;
+        // cwd first: it filters out almost everything, and is unreadable for other users' processes
+        ProcessInfo info;
+        if (readlink_at(pid_fd, "cwd", cwd) && is_within(cwd, base) && read_at(pid_fd, "stat", text) &&
+            parse_stat(text, info)) {
+            info.pid = static_cast<int>(pid);
+            info.cwd = cwd;
+            if (read_at(pid_fd, "cmdline", text)) {
+                size_t start = 0;
+                while (start < text.size()) {
+                    size_t nul = text.find('\0', start);
+                    if (nul == std::string::npos) nul = text.size();
+                    info.cmdline.push_back(text.substr(start, nul - start));
+                    start = nul + 1;
+                }
+            }
+            if (open_files) read_open_files(pid_fd, base, info.open_files);
+            result.push_back(std::move(info));
+        }
+        ::close(pid_fd);
+    }
+    ::closedir(proc);
+
+    std::sort(result.begin(), result.end(), [](const ProcessInfo& a, const ProcessInfo& b) { return a.pid < b.pid; });
+    if (result.size() > limit) result.resize(limit);
+#else
+    (void)root;
+    (void)limit;
+    (void)open_files;
+#endif
+    return result;
+}
+
+GitState WorkspaceCapture::git(const std::string& path, size_t max_files) const {
+    GitState state;
+    std::error_code ec;
+    fs::path work_tree = fs::u8path(canonical_or_self(path));
+    while (!fs::exists(work_tree / ".git", ec)) {
+        if (!work_tree.has_parent_path() || work_tree.parent_path() == work_tree) return state;
+        work_tree = work_tree.parent_path();
+    }
+
+    // .git is a directory, or a file pointing at one (worktrees, submodules)
+    fs::path git_dir = work_tree / ".git";
+    if (fs::is_regular_file(git_dir, ec)) {
+        std::string pointer = trim(read_text(git_dir));
+        if (pointer.compare(0, 8, "gitdir: ") != 0) return state;
+        git_dir = fs::u8path(pointer.substr(8));
+        if (git_dir.is_relative()) git_dir = work_tree / git_dir;
+    }
+    fs::path common_dir = git_dir;
+    std::string common = trim(read_text(git_dir / "commondir"));
+    if (!common.empty()) {
+        common_dir = fs::u8path(common);
+        if (common_dir.is_relative()) common_dir = git_dir / common_dir;
+    }
+
+    std::string head = trim(read_text(git_dir / "HEAD"));
+    if (head.empty()) return state;
+    state.is_repo = true;
+    state.root = work_tree.u8string();
+    if (head.compare(0, 5, "ref: ") == 0) {
+        std::string ref = head.substr(5);
+        if (ref.compare(0, 11, "refs/heads/") == 0) state.branch = ref.substr(11);
+        state.head = resolve_ref(common_dir, ref);
+    } else {
+        state.head = head;
+    }
+
+    // Repositories created with --object-format=sha256 use 32-byte ids in the index
+    size_t id_size = 20;
+    std::istringstream config(read_text(common_dir / "config"));
+    for (std::string line; std::getline(config, line);) {
+        std::transform(line.begin(), line.end(), line.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (line.find("objectformat") != std::string::npos && line.find("sha256") != std::string::npos) id_size = 32;
+    }
+
+    std::vector<IndexEntry> entries;
+    MappedFile index;
+    if (index.open((git_dir / "index").u8string())) parse_index(index, id_size, entries);
+    state.tracked_files = entries.size();
+
+    std::unordered_set<std::string> tracked;
+    tracked.reserve(entries.size());
+    for (const IndexEntry& entry : entries) {
+        tracked.insert(entry.path);
+        if (entry.skip || (entry.mode & 0170000) == 0160000) continue;     // gitlinks are directories
+#ifndef _WIN32
+        const fs::path file = work_tree / fs::u8path(entry.path);
+        struct stat st;
+        if (::lstat(file.c_str(), &st) != 0) {
+            if (errno == ENOENT || errno == ENOTDIR) {
+                add_capped(state.deleted_files, entry.path, max_files, state.truncated);
+            }
+            continue;
+        }
+        if (static_cast<uint32_t>(st.st_size) == entry.size &&
+            static_cast<uint32_t>(st.st_mtim.tv_sec) == entry.mtime_sec &&
+            (entry.mtime_nsec == 0 || static_cast<uint32_t>(st.st_mtim.tv_nsec) == entry.mtime_nsec)) {
+            continue;   // stat matches the index: unchanged
+        }
+        // Same size but touched: hash it like git would before calling it modified
+        if (static_cast<uint32_t>(st.st_size) == entry.size && static_cast<int64_t>(st.st_size) <= kMaxHashedFile && same_blob(file, entry)) {
+            continue;
+        }
+        add_capped(state.modified_files, entry.path, max_files, state.truncated);
+#endif
+    }
+
+    WalkOptions options;
+    options.max_file_size = SIZE_MAX;
+    FileWalker walker(work_tree, options);
+    std::mutex mutex;
+    std::vector<std::string> untracked;
+    walker.walk([&](const std::string& rel, const fs::path&) {
+        if (tracked.count(rel)) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        untracked.push_back(rel);
+    });
+    std::sort(untracked.begin(), untracked.end());
+    for (std::string& rel : untracked) add_capped(state.untracked_files, std::move(rel), max_files, state.truncated);
+    return state;
+}
+
+std::vector<std::string> WorkspaceCapture::recent_files(const std::string& root, const std::vector<std::string>& globs,
+                                                        double max_age_seconds, size_t limit) const {
+    WalkOptions options;
+    options.include_globs = globs;
+    options.use_ignore_files = false;
+    FileWalker walker(fs::u8path(root), options);
+
+    const double cutoff = static_cast<double>(std::time(nullptr)) - max_age_seconds;
+    std::mutex mutex;
+    std::vector<std::pair<double, std::string>> found;
+    walker.walk([&](const std::string& rel, const fs::path& path) {
+#ifndef _WIN32
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0) return;
+        double mtime = static_cast<double>(st.st_mtim.tv_sec) + st.st_mtim.tv_nsec / 1e9;
+#else
+        std::error_code ec;
+        double mtime = std::chrono::duration<double>(fs::last_write_time(path, ec).time_since_epoch()).count();
+        if (ec) return;
+#endif
+        if (mtime <= cutoff) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        found.emplace_back(mtime, rel);
+    });
+
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<std::string> result;
+    for (size_t i = 0; i < found.size() && i < limit; ++i) result.push_back(std::move(found[i].second));
+    return result;
+}
+
+SystemState WorkspaceCapture::system(const std::string& path) {
+    SystemState state;
+#ifdef __linux__
+    std::ifstream stat("/proc/stat");
+    std::string label;
+    if (stat >> label && label == "cpu") {
+        // user nice system idle iowait irq softirq steal; guest time is already in user
+        uint64_t value, total = 0, idle = 0;
+        for (int i = 0; i < 8 && stat >> value; ++i) {
+            total += value;
+            if (i == 3 || i == 4) idle += value;
+        }
+        const uint64_t busy = total - idle;
+        std::lock_guard<std::mutex> lock(cpu_mutex_);
+        if (total > last_total_) {
+            state.cpu_percent = 100.0 * static_cast<double>(busy - std::min(busy, last_busy_)) /
+                                static_cast<double>(total - last_total_);
+        }
+        last_busy_ = busy;
+        last_total_ = total;
+    }
+
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    uint64_t kb, total_kb = 0, available_kb = 0;
+    std::string unit;
+    while (meminfo >> key >> kb) {
+        std::getline(meminfo, unit);
+        if (key == "MemTotal:") total_kb = kb;
+        else if (key == "MemAvailable:") available_kb = kb;
+    }
+    if (total_kb) {
+        state.memory_total = total_kb * 1024;
+        state.memory_used = (total_kb - std::min(available_kb, total_kb)) * 1024;
+        state.memory_percent = 100.0 * static_cast<double>(state.memory_used) / static_cast<double>(state.memory_total);
+    }
+
+    std::ifstream loadavg("/proc/loadavg");
+    loadavg >> state.load_average[0] >> state.load_average[1] >> state.load_average[2];
+
+    // One line per socket after a header line
+    for (const char* table : {"/proc/net/tcp", "/proc/net/tcp6", "/proc/net/udp", "/proc/net/udp6"}) {
+        std::ifstream sockets(table);
+        size_t lines = 0;
+        for (std::string line; std::getline(sockets, line);) ++lines;
+        if (lines > 0) state.network_connections += lines - 1;
+    }
+#endif
+#ifndef _WIN32
+    struct statvfs fs_stat;
+    if (::statvfs(path.c_str(), &fs_stat) == 0) {
+        // Same as df: used / (used + available to unprivileged users)
+        const uint64_t used = static_cast<uint64_t>(fs_stat.f_blocks - fs_stat.f_bfree) * fs_stat.f_frsize;
+        const uint64_t available = static_cast<uint64_t>(fs_stat.f_bavail) * fs_stat.f_frsize;
+        state.disk_free = available;
+        if (used + available) state.disk_percent = 100.0 * static_cast<double>(used) / static_cast<double>(used + available);
+    }
+#else
+    (void)path;
+#endif
+    return state;
+}
+
+} // namespace isaac
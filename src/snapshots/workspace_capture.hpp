@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace isaac {
+
+struct ProcessInfo {
+    int pid = 0;
+    int ppid = 0;
+    std::string name;                   // comm
+    char state = '?';                   // R, S, D, Z, ...
+    std::vector<std::string> cmdline;
+    std::string cwd;
+    uint64_t rss_bytes = 0;
+    std::vector<std::string> open_files;    // regular files under the root held open
+};
+
+struct GitState {
+    bool is_repo = false;
+    std::string root;                   // work tree
+    std::string branch;                 // empty when detached
+    std::string head;                   // commit id, when resolvable
+    size_t tracked_files = 0;
+    std::vector<std::string> modified_files;    // stat differs from the index
+    std::vector<std::string> deleted_files;
+    std::vector<std::string> untracked_files;   // not in the index and not ignored
+    bool truncated = false;             // a list hit max_files
+};
+
+struct SystemState {
+    double cpu_percent = 0;             // since the previous call (since boot for the first)
+    double memory_percent = 0;
+    uint64_t memory_used = 0;
+    uint64_t memory_total = 0;
+    double load_average[3] = {0, 0, 0};
+    double disk_percent = 0;
+    uint64_t disk_free = 0;
+    size_t network_connections = 0;     // TCP and UDP sockets, IPv4 and IPv6
+};
+
+/**
+ * Cheap workspace state for bubbles, read straight from the kernel and the
+ * repository instead of psutil and git subprocesses.
+ *
+ * processes() makes one pass over /proc, opening each <pid> directory once
+ * and reading stat, cmdline, cwd and fd links relative to it (openat /
+ * readlinkat), and keeps the processes whose cwd is inside the root. git()
+ * reads .git/HEAD and the index directly: a tracked file whose stat no
+ * longer matches its index entry is modified if its size changed or its
+ * blob id (hashed here, as git does) differs, and a walk honouring
+ * .gitignore finds untracked files. Like git's stat check without its racy
+ * re-check, a same-size rewrite within the index's mtime can be missed.
+ * Files staged against HEAD are not reported, since that needs the object
+ * database.
+ *
+ * On systems without /proc, processes() is empty and system() only fills
+ * the disk figures.
+ */
+class WorkspaceCapture {
+public:
+    std::vector<ProcessInfo> processes(const std::string& root, size_t limit = 20, bool open_files = true) const;
+    GitState git(const std::string& path, size_t max_files = 200) const;
+    // Files under root modified within max_age_seconds, newest first
+    std::vector<std::string> recent_files(const std::string& root, const std::vector<std::string>& globs,
+                                          double max_age_seconds, size_t limit = 10) const;
+    SystemState system(const std::string& path);
+
+private:
+    std::mutex cpu_mutex_;
+    uint64_t last_busy_ = 0;
+    uint64_t last_total_ = 0;
+};
+
+} // namespace isaac
@@ -0,0 +1,166 @@
+#include "cron_expression.hpp"
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace isaac {
+
+namespace {
+
+const char* const kMonthNames[] = {"jan", "feb", "mar", "apr", "may", "jun",
+                                   "jul", "aug", "sep", "oct", "nov", "dec"};
+const char* const kWeekdayNames[] = {"sun", "mon", "tue", "wed", "thu", "fri", "sat"};
+
+constexpr std::time_t kSearchLimit = 5 * 366 * 24 * 3600;
+
+std::string lower(std::string text) {
+    for (char& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+int parse_value(const std::string& text, int base, const char* const* names, int name_count,
+                const std::string& field) {
+    if (names) {
+        std::string key = lower(text);
+        for (int i = 0; i < name_count; ++i) {
+            if (key == names[i]) return base + i;
+        }
+    }
+    if (text.empty() || text.size() > 4) {
+        throw std::invalid_argument("Invalid cron field '" + field + "'");
+    }
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            throw std::invalid_argument("Invalid cron field '" + field + "'");
+        }
+    }
+    return std::stoi(text);
+}
+
+// Bit per allowed value in [min, max]
+uint64_t parse_field(const std::string& field, int min, int max, const char* const* names = nullptr,
+                     int name_count = 0, int name_base = 0) {
+    uint64_t mask = 0;
+    std::stringstream parts(field);
+    std::string part;
+    while (std::getline(parts, part, ',')) {
+        int step = 1;
+        size_t slash = part.find('/');
+        if (slash != std::string::npos) {
+            step = parse_value(part.substr(slash + 1), 0, nullptr, 0, field);
+            part = part.substr(0, slash);
+            if (step <= 0) throw std::invalid_argument("Invalid cron step in '" + field + "'");
+        }
+
+        int low, high;
+        if (part == "*" || part == "?") {
+            low = min;
+            high = max;
+        } else {
+            size_t dash = part.find('-');
+            if (dash != std::string::npos) {
+                low = parse_value(part.substr(0, dash), name_base, names, name_count, field);
+                high = parse_value(part.substr(dash + 1), name_base, names, name_count, field);
+            } else {
+                low = parse_value(part, name_base, names, name_count, field);
+                high = slash != std::string::npos ? max : low;  // "a/n" runs to the end
+            }
+        }
+        if (low < min || high > max || low > high) {
+            throw std::invalid_argument("Cron field '" + field + "' out of range");
+        }
+        for (int value = low; value <= high; value += step) mask |= uint64_t{1} << value;
+    }
+    if (mask == 0) throw std::invalid_argument("Empty cron field '" + field + "'");
+    return mask;
+}
+
+} // namespace
+
+CronExpression::CronExpression(const std::string& expression) : expression_(expression) {
+    std::string text = expression;
+    std::string macro = lower(text);
+    if (macro == "@yearly" || macro == "@annually") text = "0 0 1 1 *";
+    else if (macro == "@monthly") text = "0 0 1 * *";
+    else if (macro == "@weekly") text = "0 0 * * 0";
+    else if (macro == "@daily" || macro == "@midnight") text = "0 0 * * *";
+    else if (macro == "@hourly") text = "0 * * * *";
+    else if (!macro.empty() && macro[0] == '@') {
+        throw std::invalid_argument("Unknown cron macro '" + expression + "'");
+    }
+
+    std::vector<std::string> fields;
+    std::istringstream stream(text);
+    for (std::string field; stream >> field;) fields.push_back(field);
+    if (fields.size() != 5 && fields.size() != 6) {
+        throw std::invalid_argument("Cron expression needs 5 or 6 fields: '" + expression + "'");
+    }
+
+    size_t i = 0;
+    has_seconds_ = fields.size() == 6;
+    seconds_ = has_seconds_ ? parse_field(fields[i++], 0, 59) : 1;
+    minutes_ = parse_field(fields[i++], 0, 59);
+    hours_ = static_cast<uint32_t>(parse_field(fields[i++], 0, 23));
+    any_day_ = fields[i] == "*" || fields[i] == "?";
+    days_ = static_cast<uint32_t>(parse_field(fields[i++], 1, 31));
+    months_ = static_cast<uint16_t>(parse_field(fields[i++], 1, 12, kMonthNames, 12, 1));
+    any_weekday_ = fields[i] == "*" || fields[i] == "?";
+    uint64_t weekdays = parse_field(fields[i++], 0, 7, kWeekdayNames, 7, 0);
+    if (weekdays & (uint64_t{1} << 7)) weekdays |= 1;  // 7 = Sunday
+    weekdays_ = static_cast<uint8_t>(weekdays & 0x7f);
+}
+
+bool CronExpression::day_matches(const std::tm& tm) const {
+    bool day = days_ & (uint32_t{1} << tm.tm_mday);
+    bool weekday = weekdays_ & (1u << tm.tm_wday);
+    if (any_day_ && any_weekday_) return true;
+    if (any_day_) return weekday;
+    if (any_weekday_) return day;
+    return day || weekday;
+}
+
+std::optional<std::time_t> CronExpression::next_after(std::time_t after) const {
+    std::time_t start = after + 1;
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &start);
+#else
+    localtime_r(&start, &tm);
+#endif
+    if (!has_seconds_ && tm.tm_sec != 0) {
+        tm.tm_min += 1;
+        tm.tm_sec = 0;
+    }
+
+    // Carry to the next candidate of the first field that fails; mktime normalizes
+    while (true) {
+        tm.tm_isdst = -1;
+        std::time_t t = std::mktime(&tm);
+        if (t == static_cast<std::time_t>(-1) || t - after > kSearchLimit) return std::nullopt;
+
+        if (!(months_ & (1u << (tm.tm_mon + 1)))) {
+            tm.tm_mon += 1;
+            tm.tm_mday = 1;
+            tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+        } else if (!day_matches(tm)) {
+            tm.tm_mday += 1;
+            tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+        } else if (!(hours_ & (1u << tm.tm_hour))) {
+            tm.tm_hour += 1;
+            tm.tm_min = tm.tm_sec = 0;
+        } else if (!(minutes_ & (uint64_t{1} << tm.tm_min))) {
+            tm.tm_min += 1;
+            tm.tm_sec = 0;
+        } else if (!(seconds_ & (uint64_t{1} << tm.tm_sec))) {
+            tm.tm_sec += 1;
+        } else if (t <= after) {
+            // A DST fold mapped the candidate back in time
+            tm.tm_sec += 1;
+        } else {
+            return t;
+        }
+    }
+}
+
+} // namespace isaac
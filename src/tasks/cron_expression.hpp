@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <string>
+
+namespace isaac {
+
+/**
+ * Parsed cron schedule, evaluated in local time.
+ *
+ * Accepts the classic five fields (minute hour day-of-month month
+ * day-of-week), an optional leading seconds field, and the @yearly,
+ * @monthly, @weekly, @daily/@midnight and @hourly macros. Fields take *,
+ * numbers, a-b ranges, /step and comma lists; months and weekdays also take
+ * three-letter names, and weekday 7 is Sunday. As in Vixie cron, when both
+ * day fields are restricted a day matching either one qualifies.
+ */
+class CronExpression {
+public:
+    // Throws std::invalid_argument with the offending field on a bad expression
+    explicit CronExpression(const std::string& expression);
+
+    // First matching second strictly after `after`; nullopt if none within five years
+    std::optional<std::time_t> next_after(std::time_t after) const;
+
+    bool has_seconds() const { return has_seconds_; }
+    const std::string& expression() const { return expression_; }
+
+private:
+    bool day_matches(const std::tm& tm) const;
+
+    std::string expression_;
+    bool has_seconds_ = false;
+    uint64_t seconds_ = 0;      // bit per allowed value
+    uint64_t minutes_ = 0;
+    uint32_t hours_ = 0;
+    uint32_t days_ = 0;         // 1-31
+    uint16_t months_ = 0;       // 1-12
+    uint8_t weekdays_ = 0;      // 0-6, Sunday = 0
+    bool any_day_ = true;       // day-of-month was *
+    bool any_weekday_ = true;
+};
+
+} // namespace isaac
@@ -0,0 +1,341 @@
+#include "cron_scheduler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
+
+namespace isaac {
+
+namespace {
+
+constexpr uint64_t kMaxCatchUpRuns = 100;
+constexpr uint64_t kMaxMissedCount = 1000;
+
+double wall_seconds() {
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(system_clock::now().time_since_epoch()).count();
+}
+
+void validate(const CronJobOptions& options) {
+    if (options.catch_up != "once" && options.catch_up != "skip" && options.catch_up != "all") {
+        throw std::invalid_argument("catch_up must be 'once', 'skip' or 'all'");
+    }
+    if (options.jitter_ms < 0) {
+        throw std::invalid_argument("jitter_ms must not be negative");
+    }
+}
+
+} // namespace
+
+CronScheduler::CronScheduler(unsigned workers) {
+#ifdef __linux__
+    clock_id_ = CLOCK_BOOTTIME;
+    timer_fd_ = ::timerfd_create(CLOCK_BOOTTIME, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (timer_fd_ < 0) {
+        clock_id_ = CLOCK_MONOTONIC;
+        timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    }
+#elif !defined(_WIN32)
+    clock_id_ = CLOCK_MONOTONIC;
+#endif
+    base_ns_ = 0;
+    base_ns_ = static_cast<int64_t>(now_tick()) * 1000000;  // tick 0 = construction, rounded to 1 ms
+
+    pool_ = std::make_unique<WorkStealingPool>(workers);
+    wheel_ = TimerWheel(0);
+    thread_ = std::thread([this] { run(); });
+}
+
+CronScheduler::~CronScheduler() {
+    stop();
+#ifndef _WIN32
+    if (timer_fd_ >= 0) ::close(timer_fd_);
+#endif
+}
+
+void CronScheduler::add_cron(const std::string& name, const std::string& expression, Job job,
+                             CronJobOptions options) {
+    validate(options);
+    Entry entry;
+    entry.cron.emplace(expression);
+    if (!entry.cron->next_after(std::time(nullptr))) {
+        throw std::invalid_argument("Cron expression never fires: '" + expression + "'");
+    }
+    entry.job = std::make_shared<Job>(std::move(job));
+    entry.options = std::move(options);
+    entry.info.schedule = expression;
+    add(name, std::move(entry));
+}
+
+void CronScheduler::add_interval(const std::string& name, int64_t interval_ms, Job job, CronJobOptions options) {
+    validate(options);
+    if (interval_ms <= 0) {
+        throw std::invalid_argument("interval_ms must be positive");
+    }
+    Entry entry;
+    entry.interval_ms = interval_ms;
+    entry.job = std::make_shared<Job>(std::move(job));
+    entry.options = std::move(options);
+    entry.info.schedule = "every " + std::to_string(interval_ms) + "ms";
+    add(name, std::move(entry));
+}
+
+void CronScheduler::add(const std::string& name, Entry entry) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto existing = names_.find(name);
+        if (existing != names_.end()) {
+            wheel_.cancel(existing->second);
+            entries_.erase(existing->second);
+        }
+
+        uint64_t id = next_id_++;
+        entry.id = id;
+        entry.info.name = name;
+
+        uint64_t now = now_tick();
+        std::time_t wall_now = std::time(nullptr);
+        uint64_t nominal = now;
+        entry.nominal_wall = wall_now;
+        if (!entry.options.run_immediately) {
+            if (entry.cron) {
+                entry.nominal_wall = *entry.cron->next_after(wall_now);
+                double delay = (static_cast<double>(entry.nominal_wall) - wall_seconds()) * 1000.0;
+                nominal = now + static_cast<uint64_t>(std::max(0.0, std::ceil(delay)));
+            } else {
+                nominal = now + static_cast<uint64_t>(entry.interval_ms);
+            }
+        }
+
+        Entry& stored = entries_.emplace(id, std::move(entry)).first->second;
+        names_[name] = id;
+        arm(stored, nominal);
+    }
+    wake_.notify();
+}
+
+bool CronScheduler::remove(const std::string& name) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = names_.find(name);
+        if (it == names_.end()) return false;
+        wheel_.cancel(it->second);
+        entries_.erase(it->second);
+        names_.erase(it);
+    }
+    wake_.notify();
+    return true;
+}
+
+bool CronScheduler::run_now(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = names_.find(name);
+    if (it == names_.end() || stopping_) return false;
+    start_run(entries_.at(it->second));
+    return true;
+}
+
+std::optional<CronJobInfo> CronScheduler::info(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = names_.find(name);
+    if (it == names_.end()) return std::nullopt;
+    return entries_.at(it->second).info;
+}
+
+std::vector<CronJobInfo> CronScheduler::jobs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<CronJobInfo> result;
+    for (const auto& [id, entry] : entries_) result.push_back(entry.info);
+    std::sort(result.begin(), result.end(),
+              [](const CronJobInfo& a, const CronJobInfo& b) { return a.name < b.name; });
+    return result;
+}
+
+void CronScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;
+        stopping_ = true;
+    }
+    wake_.notify();
+    thread_.join();
+    pool_->shutdown();
+}
+
+void CronScheduler::run() {
+    std::vector<uint64_t> due;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        uint64_t now = now_tick();
+        wheel_.advance(now, due);
+        for (uint64_t id : due) {
+            auto it = entries_.find(id);
+            if (it != entries_.end()) fire(it->second, now);
+        }
+        due.clear();
+
+        std::optional<uint64_t> next = wheel_.next_expiry();
+        lock.unlock();
+        sleep_until(next);
+        wakeups_.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+}
+
+// Work out what the late or on-time occurrence owes, then arm the next one
+void CronScheduler::fire(Entry& entry, uint64_t now) {
+    uint64_t missed = 0;
+    uint64_t next_nominal;
+
+    if (entry.cron) {
+        double wall_now = wall_seconds();
+        std::time_t floor_now = static_cast<std::time_t>(wall_now);
+        // Never re-fire the occurrence just reached, even if the clocks disagree slightly
+        std::optional<std::time_t> next = entry.cron->next_after(std::max(entry.nominal_wall, floor_now));
+        std::optional<std::time_t> walk = entry.cron->next_after(entry.nominal_wall);
+        while (walk && *walk <= floor_now && missed < kMaxMissedCount) {
+            ++missed;
+            walk = entry.cron->next_after(*walk);
+        }
+        if (!next) {
+            // Nothing left within the search horizon; retry in a day
+            entry.nominal_wall = floor_now + 86400;
+            next_nominal = now + 86400000;
+        } else {
+            entry.nominal_wall = *next;
+            double delay = (static_cast<double>(*next) - wall_now) * 1000.0;
+            next_nominal = now + static_cast<uint64_t>(std::max(0.0, std::ceil(delay)));
+        }
+    } else {
+        uint64_t interval = static_cast<uint64_t>(entry.interval_ms);
+        missed = now > entry.nominal_tick ? (now - entry.nominal_tick) / interval : 0;
+        next_nominal = entry.nominal_tick + (missed + 1) * interval;
+    }
+
+    uint64_t runs = 1;
+    if (missed > 0 && entry.options.catch_up == "skip") {
+        runs = 0;
+    } else if (missed > 0 && entry.options.catch_up == "all") {
+        runs = std::min(missed + 1, kMaxCatchUpRuns);
+    }
+    entry.info.missed += missed;
+
+    arm(entry, next_nominal);
+    if (runs > 0) start_run(entry, runs);
+}
+
+void CronScheduler::arm(Entry& entry, uint64_t nominal) {
+    entry.nominal_tick = nominal;
+    uint64_t at = nominal;
+    if (entry.options.jitter_ms > 0) {
+        at += std::uniform_int_distribution<uint64_t>(0, static_cast<uint64_t>(entry.options.jitter_ms))(rng_);
+    }
+    wheel_.schedule(entry.id, at);
+    entry.info.next_run = tick_to_wall(at);
+}
+
+void CronScheduler::start_run(Entry& entry, uint64_t count) {
+    if (entry.running > 0 && !entry.options.allow_overlap) {
+        ++entry.info.skipped;
+        return;
+    }
+    ++entry.running;
+    entry.info.running = true;
+    entry.info.last_run = wall_seconds();
+
+    pool_->post([this, id = entry.id, job = entry.job, count] {
+        for (uint64_t i = 0; i < count; ++i) {
+            auto started = std::chrono::steady_clock::now();
+            std::string error;
+            bool failed = false;
+            try {
+                (*job)();
+            } catch (const std::exception& e) {
+                failed = true;
+                error = e.what();
+            } catch (...) {
+                failed = true;
+                error = "unknown error";
+            }
+            double elapsed_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(id);
+            if (it == entries_.end()) return;  // removed or replaced meanwhile
+            CronJobInfo& info = it->second.info;
+            ++info.runs;
+            info.last_duration_ms = elapsed_ms;
+            if (failed) {
+                ++info.failures;
+                info.last_error = error;
+            }
+            if (i + 1 == count) {
+                info.running = --it->second.running > 0;
+            }
+        }
+    });
+}
+
+uint64_t CronScheduler::now_tick() const {
+#ifdef _WIN32
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count();
+#else
+    timespec ts{};
+    ::clock_gettime(clock_id_, &ts);
+    int64_t ns = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+    return static_cast<uint64_t>((ns - base_ns_) / 1000000);
+}
+
+double CronScheduler::tick_to_wall(uint64_t tick) const {
+    return wall_seconds() + (static_cast<double>(tick) - static_cast<double>(now_tick())) / 1000.0;
+}
+
+void CronScheduler::sleep_until(std::optional<uint64_t> tick) {
+#ifdef __linux__
+    if (timer_fd_ >= 0) {
+        itimerspec spec{};
+        if (tick) {
+            int64_t ns = base_ns_ + static_cast<int64_t>(*tick) * 1000000;
+            spec.it_value.tv_sec = ns / 1000000000;
+            spec.it_value.tv_nsec = ns % 1000000000;
+        }
+        // Absolute deadline, so a late wakeup does not stretch the next one
+        ::timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+        pollfd fds[2] = {{timer_fd_, POLLIN, 0}, {wake_.fd(), POLLIN, 0}};
+        int ready;
+        do {
+            ready = ::poll(fds, 2, -1);
+        } while (ready < 0 && errno == EINTR);
+        if (fds[0].revents & POLLIN) {
+            uint64_t expirations;
+            while (::read(timer_fd_, &expirations, sizeof(expirations)) < 0 && errno == EINTR) {}
+        }
+        if (fds[1].revents & POLLIN) wake_.wait(0);
+        return;
+    }
+#endif
+    int timeout = -1;
+    if (tick) {
+        uint64_t now = now_tick();
+        timeout = *tick > now ? static_cast<int>(std::min<uint64_t>(*tick - now, INT32_MAX)) : 0;
+    }
+    wake_.wait(timeout);
+}
+
+} // namespace isaac
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "core/wake_signal.hpp"
+#include "cron_expression.hpp"
+#include "timer_wheel.hpp"
+#include "work_stealing_pool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+struct CronJobOptions {
+    int jitter_ms = 0;                  // random delay in [0, jitter_ms] added to each run
+    std::string catch_up = "once";      // missed runs: "once" (coalesce), "skip" or "all"
+    bool allow_overlap = false;         // start a run while the previous one is still going
+    bool run_immediately = false;
+};
+
+struct CronJobInfo {
+    std::string name;
+    std::string schedule;               // cron expression, or "every <n>ms"
+    uint64_t runs = 0;
+    uint64_t failures = 0;
+    uint64_t missed = 0;                // occurrences that passed while late
+    uint64_t skipped = 0;               // runs dropped because the previous one was still going
+    bool running = false;
+    double last_run = 0;                // unix seconds; 0 = never
+    double next_run = 0;
+    double last_duration_ms = 0;
+    std::string last_error;
+};
+
+/**
+ * Periodic job scheduler on a hierarchical timer wheel.
+ *
+ * One thread sleeps until the wheel's next expiry, on a timerfd (Linux,
+ * CLOCK_BOOTTIME so time spent suspended counts) or a poll timeout
+ * elsewhere, together with a WakeSignal for schedule changes. It never
+ * wakes while nothing is due. Due jobs run on a WorkStealingPool, so a
+ * slow job delays neither the clock nor other jobs.
+ *
+ * Interval jobs have millisecond periods; cron jobs follow a
+ * CronExpression in local time. A job that fires late (the machine slept,
+ * or the clock jumped) applies its catch_up policy to the occurrences it
+ * missed: run once, skip to the next future occurrence, or run each one
+ * (capped at 100).
+ */
+class CronScheduler {
+public:
+    using Job = std::function<void()>;
+
+    explicit CronScheduler(unsigned workers = 2);
+    ~CronScheduler();
+
+    CronScheduler(const CronScheduler&) = delete;
+    CronScheduler& operator=(const CronScheduler&) = delete;
+
+    // Add or replace a job; throws std::invalid_argument on a bad schedule or policy
+    void add_cron(const std::string& name, const std::string& expression, Job job, CronJobOptions options = {});
+    void add_interval(const std::string& name, int64_t interval_ms, Job job, CronJobOptions options = {});
+    bool remove(const std::string& name);
+
+    // Start a run now without moving the schedule
+    bool run_now(const std::string& name);
+
+    std::optional<CronJobInfo> info(const std::string& name) const;
+    std::vector<CronJobInfo> jobs() const;
+
+    // Scheduler thread wakeups so far (idle schedulers do not wake)
+    uint64_t wakeups() const { return wakeups_.load(std::memory_order_relaxed); }
+
+    // Stop the clock and wait for running jobs
+    void stop();
+
+private:
+    struct Entry {
+        uint64_t id = 0;
+        std::optional<CronExpression> cron;
+        int64_t interval_ms = 0;
+        std::shared_ptr<Job> job;
+        CronJobOptions options;
+        CronJobInfo info;
+        int running = 0;
+        uint64_t nominal_tick = 0;      // occurrence being waited for, before jitter
+        std::time_t nominal_wall = 0;   // same, for cron jobs
+    };
+
+    void add(const std::string& name, Entry entry);
+    void run();
+    void fire(Entry& entry, uint64_t now);
+    void arm(Entry& entry, uint64_t nominal);
+    void start_run(Entry& entry, uint64_t count = 1);
+    uint64_t now_tick() const;
+    double tick_to_wall(uint64_t tick) const;
+    void sleep_until(std::optional<uint64_t> tick);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, uint64_t> names_;
+    std::unordered_map<uint64_t, Entry> entries_;
+    uint64_t next_id_ = 1;
+    TimerWheel wheel_;
+    std::mt19937_64 rng_{std::random_device{}()};
+
+    int64_t base_ns_ = 0;               // clock reading at tick 0
+    int clock_id_ = 0;
+    int timer_fd_ = -1;
+    WakeSignal wake_;
+    bool stopping_ = false;
+    std::atomic<uint64_t> wakeups_{0};
+
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::thread thread_;
+};
+
+} // namespace isaac
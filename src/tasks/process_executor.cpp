@@ -0,0 +1,434 @@
+#include "process_executor.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#ifndef _WIN32
+extern char** environ;
+#endif
+
+namespace isaac {
+
+#ifdef _WIN32
+ProcessExecutor::ProcessExecutor(ExitHandler on_exit, size_t max_output_bytes)
+    : on_exit_(std::move(on_exit)), max_output_bytes_(max_output_bytes) {}
+
+ProcessExecutor::~ProcessExecutor() = default;
+
+int ProcessExecutor::spawn(const std::vector<std::string>&, const SpawnOptions&) {
+    throw std::runtime_error("Background processes are not supported on Windows");
+}
+
+bool ProcessExecutor::close_stdin(int) {
+    return false;
+}
+
+bool ProcessExecutor::terminate(int, int) {
+    return false;
+}
+
+size_t ProcessExecutor::active() const {
+    return 0;
+}
+#else
+namespace {
+
+constexpr int kSweepIntervalMs = 50;     // waitpid sweep when there is no pidfd
+constexpr size_t kMaxStdinBacklog = 1 << 20;
+
+bool make_pipe(int fds[2]) {
+#ifdef __linux__
+    return ::pipe2(fds, O_CLOEXEC) == 0;
+#else
+    if (::pipe(fds) != 0) return false;
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+
+void close_fd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// Writes to a closed stdin raise SIGPIPE on the reactor thread, which blocks it
+void consume_sigpipe() {
+    sigset_t pending;
+    sigpending(&pending);
+    if (sigismember(&pending, SIGPIPE)) {
+        sigset_t pipe_set;
+        sigemptyset(&pipe_set);
+        sigaddset(&pipe_set, SIGPIPE);
+        int signal_number;
+        sigwait(&pipe_set, &signal_number);
+    }
+}
+
+int open_pidfd(int pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+} // namespace
+
+ProcessExecutor::ProcessExecutor(ExitHandler on_exit, size_t max_output_bytes)
+    : on_exit_(std::move(on_exit)), max_output_bytes_(max_output_bytes) {
+    reactor_ = std::thread([this] { run(); });
+}
+
+ProcessExecutor::~ProcessExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify();
+    reactor_.join();
+}
+
+int ProcessExecutor::spawn(const std::vector<std::string>& argv, const SpawnOptions& options) {
+    if (argv.empty()) {
+        throw std::invalid_argument("Empty command");
+    }
+
+    int out[2], err[2] = {-1, -1}, in[2] = {-1, -1};
+    if (!make_pipe(out)) {
+        throw std::runtime_error(std::string("pipe: ") + std::strerror(errno));
+    }
+    if (!make_pipe(err) || (options.pipe_stdin && !make_pipe(in))) {
+        int saved = errno;
+        for (int fd : {out[0], out[1], err[0], err[1]}) {
+            if (fd >= 0) ::close(fd);
+        }
+        throw std::runtime_error(std::string("pipe: ") + std::strerror(saved));
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (options.pipe_stdin) {
+        posix_spawn_file_actions_adddup2(&actions, in[0], 0);
+    } else {
+        posix_spawn_file_actions_addopen(&actions, 0, "/dev/null", O_RDONLY, 0);
+    }
+    posix_spawn_file_actions_adddup2(&actions, out[1], 1);
+    posix_spawn_file_actions_adddup2(&actions, err[1], 2);
+
+    // Own process group so cancellation reaches the whole pipeline;
+    // SIGPIPE back to default in case the host ignores it (Python does)
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+    posix_spawnattr_setpgroup(&attr, 0);
+    sigset_t defaults, mask;
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGPIPE);
+    sigemptyset(&mask);
+    posix_spawnattr_setsigdefault(&attr, &defaults);
+    posix_spawnattr_setsigmask(&attr, &mask);
+
+    std::vector<char*> args;
+    args.reserve(argv.size() + 1);
+    for (const auto& arg : argv) args.push_back(const_cast<char*>(arg.c_str()));
+    args.push_back(nullptr);
+
+    pid_t pid = -1;
+    int rc = ::posix_spawnp(&pid, args[0], &actions, &attr, args.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    ::close(out[1]);
+    ::close(err[1]);
+    if (in[0] >= 0) ::close(in[0]);
+
+    if (rc != 0) {
+        ::close(out[0]);
+        ::close(err[0]);
+        if (in[1] >= 0) ::close(in[1]);
+        throw std::runtime_error(argv[0] + ": " + std::strerror(rc));
+    }
+
+    Child child;
+    child.pid = pid;
+    child.out_fd = out[0];
+    child.err_fd = err[0];
+    child.in_fd = in[1];
+    child.exit_fd = open_pidfd(pid);
+    for (int fd : {child.out_fd, child.err_fd, child.in_fd}) {
+        if (fd >= 0) ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    if (options.pipe_stdin) {
+        child.in_buffer = options.stdin_data;
+        child.in_holds = options.keep_stdin_open ? 1 : 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int target : options.stdout_to) {
+            auto it = children_.find(target);
+            if (it == children_.end() || it->second.in_fd < 0) continue;
+            ++it->second.in_holds;
+            child.stdout_to.push_back(target);
+        }
+        children_.emplace(pid, std::move(child));
+    }
+    wake_.notify();
+    return pid;
+}
+
+bool ProcessExecutor::terminate(int pid, int grace_ms) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = children_.find(pid);
+        if (it == children_.end() || it->second.exited) return false;
+
+        ::kill(-pid, SIGTERM);
+        it->second.kill_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(0, grace_ms));
+        it->second.kill_pending = true;
+    }
+    wake_.notify();
+    return true;
+}
+
+bool ProcessExecutor::close_stdin(int pid) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = children_.find(pid);
+        if (it == children_.end()) return false;
+        if (it->second.in_holds > 0) --it->second.in_holds;
+    }
+    wake_.notify();
+    return true;
+}
+
+size_t ProcessExecutor::active() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return children_.size();
+}
+
+// Read until EAGAIN, or until a stdin target falls too far behind; returns false (and closes fd) at EOF
+bool ProcessExecutor::drain(Child& child, bool is_stdout) {
+    int& fd = is_stdout ? child.out_fd : child.err_fd;
+    std::string& sink = is_stdout ? child.outcome.stdout_data : child.outcome.stderr_data;
+    char buffer[16384];
+    while (fd >= 0) {
+        if (is_stdout && !child.exited && backlogged(child)) return true;
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            size_t room = sink.size() < max_output_bytes_ ? max_output_bytes_ - sink.size() : 0;
+            size_t take = std::min(room, static_cast<size_t>(n));
+            sink.append(buffer, take);
+            if (take < static_cast<size_t>(n)) child.outcome.truncated = true;
+            if (is_stdout) forward(child, buffer, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        close_fd(fd);
+    }
+    return false;
+}
+
+void ProcessExecutor::forward(Child& child, const char* data, size_t size) {
+    for (int target : child.stdout_to) {
+        auto it = children_.find(target);
+        if (it != children_.end() && it->second.in_fd >= 0) it->second.in_buffer.append(data, size);
+    }
+}
+
+bool ProcessExecutor::backlogged(const Child& child) const {
+    for (int target : child.stdout_to) {
+        auto it = children_.find(target);
+        if (it != children_.end() && it->second.in_buffer.size() > kMaxStdinBacklog) return true;
+    }
+    return false;
+}
+
+// Write what the pipe takes; close stdin once nothing is pending or held
+void ProcessExecutor::flush_stdin(Child& child) {
+    while (child.in_fd >= 0 && !child.in_buffer.empty()) {
+        ssize_t n = ::write(child.in_fd, child.in_buffer.data(), child.in_buffer.size());
+        if (n > 0) {
+            child.in_buffer.erase(0, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        // The child closed its stdin
+        consume_sigpipe();
+        child.in_buffer.clear();
+        close_fd(child.in_fd);
+    }
+    if (child.in_fd >= 0 && child.in_holds <= 0) close_fd(child.in_fd);
+}
+
+void ProcessExecutor::reap(Child& child, bool block) {
+    if (child.exited) return;
+    int status = 0;
+    pid_t rc;
+    do {
+        rc = ::waitpid(child.pid, &status, block ? 0 : WNOHANG);
+    } while (rc < 0 && errno == EINTR);
+
+    if (rc == child.pid) {
+        child.exited = true;
+        child.status = status;
+    } else if (rc < 0) {
+        // Reaped elsewhere (e.g. a SIGCHLD handler); the status is lost
+        child.exited = true;
+        child.status = -1;
+    }
+}
+
+void ProcessExecutor::finish(Child& child) {
+    drain(child, true);
+    drain(child, false);
+    close_fd(child.out_fd);
+    close_fd(child.err_fd);
+    close_fd(child.in_fd);
+    close_fd(child.exit_fd);
+
+    // Feeding stops here: release the hold on each target's stdin
+    for (int target : child.stdout_to) {
+        auto it = children_.find(target);
+        if (it == children_.end()) continue;
+        --it->second.in_holds;
+        flush_stdin(it->second);
+    }
+
+    if (child.status >= 0 && WIFEXITED(child.status)) {
+        child.outcome.exit_code = WEXITSTATUS(child.status);
+    } else if (child.status >= 0 && WIFSIGNALED(child.status)) {
+        child.outcome.exit_code = -WTERMSIG(child.status);
+    } else {
+        child.outcome.exit_code = -1;
+    }
+}
+
+void ProcessExecutor::run() {
+    sigset_t pipe_set;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, nullptr);
+
+    enum Slot { kOut, kErr, kIn, kExit };
+    std::vector<pollfd> fds;
+    std::vector<std::pair<int, Slot>> owners;
+    std::vector<std::pair<int, ProcessOutcome>> finished;
+
+    while (true) {
+        int timeout = -1;
+        fds.clear();
+        owners.clear();
+        fds.push_back({wake_.fd(), POLLIN, 0});
+        owners.push_back({-1, kOut});
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) break;
+
+            auto now = std::chrono::steady_clock::now();
+            for (auto& [pid, child] : children_) {
+                if (child.out_fd >= 0 && !backlogged(child)) {
+                    fds.push_back({child.out_fd, POLLIN, 0});
+                    owners.push_back({pid, kOut});
+                }
+                if (child.err_fd >= 0) {
+                    fds.push_back({child.err_fd, POLLIN, 0});
+                    owners.push_back({pid, kErr});
+                }
+                if (child.in_fd >= 0 && !child.in_buffer.empty()) {
+                    fds.push_back({child.in_fd, POLLOUT, 0});
+                    owners.push_back({pid, kIn});
+                }
+                if (child.exit_fd >= 0) {
+                    fds.push_back({child.exit_fd, POLLIN, 0});
+                    owners.push_back({pid, kExit});
+                } else if (timeout < 0 || timeout > kSweepIntervalMs) {
+                    timeout = kSweepIntervalMs;
+                }
+                if (child.kill_pending) {
+                    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(child.kill_at - now).count();
+                    int wait_ms = static_cast<int>(std::max<int64_t>(0, ms));
+                    if (timeout < 0 || wait_ms < timeout) timeout = wait_ms;
+                }
+            }
+        }
+
+        int ready;
+        do {
+            ready = ::poll(fds.data(), fds.size(), timeout);
+        } while (ready < 0 && errno == EINTR);
+        if (fds[0].revents & POLLIN) wake_.wait(0);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 1; i < fds.size(); ++i) {
+                if (fds[i].revents == 0) continue;
+                auto it = children_.find(owners[i].first);
+                if (it == children_.end()) continue;
+                Child& child = it->second;
+                switch (owners[i].second) {
+                    case kOut: drain(child, true); break;
+                    case kErr: drain(child, false); break;
+                    case kIn: break;
+                    case kExit: reap(child, false); break;
+                }
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            for (auto& [pid, child] : children_) flush_stdin(child);
+            for (auto it = children_.begin(); it != children_.end();) {
+                Child& child = it->second;
+                if (child.exit_fd < 0) reap(child, false);
+                if (child.kill_pending && !child.exited && now >= child.kill_at) {
+                    ::kill(-child.pid, SIGKILL);
+                    child.kill_pending = false;
+                }
+                if (child.exited) {
+                    finish(child);
+                    finished.emplace_back(child.pid, std::move(child.outcome));
+                    it = children_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        for (auto& [pid, outcome] : finished) {
+            on_exit_(pid, std::move(outcome));
+        }
+        finished.clear();
+    }
+
+    // Shutting down: nobody is left to collect results
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [pid, child] : children_) {
+        ::kill(-pid, SIGKILL);
+        reap(child, true);
+        close_fd(child.out_fd);
+        close_fd(child.err_fd);
+        close_fd(child.in_fd);
+        close_fd(child.exit_fd);
+    }
+    children_.clear();
+}
+#endif
+
+} // namespace isaac
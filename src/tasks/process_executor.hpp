@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/wake_signal.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+struct ProcessOutcome {
+    int exit_code = -1;                 // -signal when killed by a signal
+    std::string stdout_data;
+    std::string stderr_data;
+    bool truncated = false;             // output beyond max_output_bytes was dropped
+};
+
+struct SpawnOptions {
+    bool pipe_stdin = false;            // writable stdin pipe instead of /dev/null
+    std::string stdin_data;             // written to the pipe first
+    bool keep_stdin_open = false;       // hold stdin open until close_stdin()
+    std::vector<int> stdout_to;         // also feed stdout to these children's stdin
+};
+
+/**
+ * Runs child processes without a thread per child.
+ *
+ * Each child is spawned (posix_spawnp, no shell) as the leader of its own
+ * process group with stdin on /dev/null, or on a pipe the reactor writes
+ * from a buffer. A child's stdout can be forwarded into the stdin of other
+ * running children as it arrives, like a shell pipe that is also captured;
+ * their stdin closes once every feeding child has finished, and the source
+ * is not read while a target is more than 1 MiB behind. One reactor thread
+ * polls every child's pipes plus, on Linux, a pidfd for its exit;
+ * elsewhere exits are picked up by a short waitpid(WNOHANG) sweep. A child
+ * is finished once it has exited and its pipes are drained; a grandchild
+ * that keeps the pipes open does not hold the result back.
+ *
+ * on_exit runs on the reactor thread and must not block.
+ */
+class ProcessExecutor {
+public:
+    using ExitHandler = std::function<void(int pid, ProcessOutcome outcome)>;
+
+    explicit ProcessExecutor(ExitHandler on_exit, size_t max_output_bytes = 16 << 20);
+    ~ProcessExecutor();     // kills every remaining process group
+
+    ProcessExecutor(const ProcessExecutor&) = delete;
+    ProcessExecutor& operator=(const ProcessExecutor&) = delete;
+
+    // Returns the child pid; throws std::runtime_error if the spawn fails
+    int spawn(const std::vector<std::string>& argv, const SpawnOptions& options = {});
+
+    // Release the hold taken by keep_stdin_open
+    bool close_stdin(int pid);
+
+    // SIGTERM the child's process group, then SIGKILL it after grace_ms
+    bool terminate(int pid, int grace_ms = 5000);
+
+    size_t active() const;
+
+private:
+    struct Child {
+        int pid = -1;
+        int out_fd = -1;
+        int err_fd = -1;
+        int in_fd = -1;
+        int exit_fd = -1;               // pidfd, -1 if unavailable
+        std::string in_buffer;          // pending stdin bytes
+        int in_holds = 0;               // keep_stdin_open plus feeding children still running
+        std::vector<int> stdout_to;
+        bool exited = false;
+        int status = 0;
+        ProcessOutcome outcome;
+        std::chrono::steady_clock::time_point kill_at{};
+        bool kill_pending = false;
+    };
+
+    void run();
+    bool drain(Child& child, bool is_stdout);
+    void forward(Child& child, const char* data, size_t size);
+    void flush_stdin(Child& child);
+    bool backlogged(const Child& child) const;
+    void reap(Child& child, bool block);
+    void finish(Child& child);
+
+    ExitHandler on_exit_;
+    size_t max_output_bytes_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<int, Child> children_;
+    WakeSignal wake_;
+    bool stopping_ = false;
+    std::thread reactor_;
+};
+
+} // namespace isaac
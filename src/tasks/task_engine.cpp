@@ -0,0 +1,284 @@
+#include "task_engine.hpp"
+#include "core/utf8.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace {
+
+const char* const kPriorities[] = {"urgent", "high", "normal", "low"};
+
+int priority_level(const std::string& priority) {
+    for (int level = 0; level < 4; ++level) {
+        if (priority == kPriorities[level]) return level;
+    }
+    throw std::invalid_argument("Unknown task priority: " + priority);
+}
+
+double now_seconds() {
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TaskEngine::TaskEngine(TaskEngineOptions options, std::shared_ptr<TaskJournal> journal)
+    : options_(options), journal_(std::move(journal)) {
+    pool_ = std::make_unique<WorkStealingPool>(options_.workers);
+    executor_ = std::make_unique<ProcessExecutor>(
+        [this](int pid, ProcessOutcome outcome) {
+            // Reactor thread: hand bookkeeping to the pool and keep polling
+            pool_->post([this, pid, outcome = std::move(outcome)]() mutable {
+                complete(pid, std::move(outcome));
+            });
+        },
+        options_.max_output_bytes);
+}
+
+TaskEngine::~TaskEngine() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    // Pending launches see stopping_ and bail; the executor then kills what still runs
+    pool_->shutdown();
+    executor_.reset();
+    pool_.reset();
+}
+
+void TaskEngine::submit(const std::string& id, const std::vector<std::string>& argv,
+                        const std::string& priority) {
+    if (argv.empty()) {
+        throw std::invalid_argument("Empty command");
+    }
+    int level = priority_level(priority);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.count(id)) {
+        throw std::invalid_argument("Duplicate task id: " + id);
+    }
+
+    Entry entry;
+    entry.info.id = id;
+    entry.info.argv = argv;
+    entry.info.priority = kPriorities[level];
+    entry.info.status = "pending";
+    entry.info.submitted_at = now_seconds();
+    entry.level = level;
+    entry.queued_at = std::chrono::steady_clock::now();
+    tasks_.emplace(id, std::move(entry));
+    admission_[level].push_back(id);
+    ++submitted_;
+
+    admit_locked();
+}
+
+bool TaskEngine::cancel(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) return false;
+    Entry& entry = it->second;
+
+    if (entry.info.status == "pending") {
+        auto& queue = admission_[entry.level];
+        queue.erase(std::find(queue.begin(), queue.end(), id));
+        entry.info.status = "cancelled";
+        entry.info.end_time = now_seconds();
+        finish_locked(entry);
+        return true;
+    }
+    if (entry.info.status != "running") return false;
+
+    // Not spawned yet: launch() notices the flag
+    entry.cancel_requested = true;
+    if (entry.info.pid > 0) {
+        executor_->terminate(entry.info.pid, options_.kill_grace_ms);
+    }
+    return true;
+}
+
+std::optional<TaskInfo> TaskEngine::get(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) return std::nullopt;
+    return it->second.info;
+}
+
+std::vector<TaskInfo> TaskEngine::wait_finished(int timeout_ms) {
+    std::vector<TaskInfo> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.swap(finished_);
+    }
+    if (!result.empty()) return result;
+
+    finished_signal_.wait(timeout_ms);
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.swap(finished_);
+    return result;
+}
+
+bool TaskEngine::forget(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) return false;
+    const std::string& status = it->second.info.status;
+    if (status == "pending" || status == "running") return false;
+    tasks_.erase(it);
+    return true;
+}
+
+void TaskEngine::set_max_running(size_t max_running) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_.max_running = max_running;
+    admit_locked();
+}
+
+TaskEngineStats TaskEngine::stats() const {
+    TaskEngineStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& queue : admission_) stats.queued += queue.size();
+        stats.running = running_;
+        stats.max_running = options_.max_running;
+        stats.submitted = submitted_;
+        stats.finished = finished_count_;
+    }
+    stats.workers = static_cast<unsigned>(pool_->thread_count());
+    stats.steals = pool_->stolen();
+    return stats;
+}
+
+void TaskEngine::admit_locked() {
+    auto now = std::chrono::steady_clock::now();
+    auto starved = now - std::chrono::milliseconds(options_.starvation_ms);
+
+    while (!stopping_ && running_ < options_.max_running) {
+        int pick = -1;
+        for (int level = 0; level < 4; ++level) {
+            if (!admission_[level].empty()) {
+                pick = level;
+                break;
+            }
+        }
+        if (pick < 0) break;
+
+        // The longest-starved lower class goes first
+        auto oldest = starved;
+        for (int level = pick + 1; level < 4; ++level) {
+            if (admission_[level].empty()) continue;
+            auto queued_at = tasks_.at(admission_[level].front()).queued_at;
+            if (queued_at < oldest) {
+                oldest = queued_at;
+                pick = level;
+            }
+        }
+
+        std::string id = std::move(admission_[pick].front());
+        admission_[pick].pop_front();
+        tasks_.at(id).info.status = "running";
+        ++running_;
+        pool_->post([this, id] { launch(id); });
+    }
+}
+
+void TaskEngine::launch(const std::string& id) {
+    std::vector<std::string> argv;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = tasks_.at(id);
+        if (stopping_ || entry.cancel_requested) {
+            entry.info.status = "cancelled";
+            entry.info.end_time = now_seconds();
+            --running_;
+            finish_locked(entry);
+            admit_locked();
+            return;
+        }
+        entry.info.start_time = now_seconds();
+        argv = entry.info.argv;
+    }
+
+    int pid = -1;
+    std::string error;
+    try {
+        pid = executor_->spawn(argv);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = tasks_.at(id);
+    if (pid < 0) {
+        entry.info.status = "failed";
+        entry.info.exit_code = -1;
+        entry.info.stderr_data = "Task execution error: " + error;
+        entry.info.end_time = now_seconds();
+        --running_;
+        finish_locked(entry);
+        admit_locked();
+        return;
+    }
+
+    entry.info.pid = pid;
+    by_pid_[pid] = id;
+    if (journal_) {
+        journal_->transition(id, "running", entry.info.start_time, 0, std::nullopt, "", "");
+    }
+
+    // The child may already be gone, or cancelled while spawning
+    auto early = early_exits_.find(pid);
+    if (early != early_exits_.end()) {
+        ProcessOutcome outcome = std::move(early->second);
+        early_exits_.erase(early);
+        apply_locked(pid, std::move(outcome));
+    } else if (entry.cancel_requested) {
+        executor_->terminate(pid, options_.kill_grace_ms);
+    }
+}
+
+void TaskEngine::complete(int pid, ProcessOutcome outcome) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!by_pid_.count(pid)) {
+        // Exited before launch() recorded the pid
+        early_exits_.emplace(pid, std::move(outcome));
+        return;
+    }
+    apply_locked(pid, std::move(outcome));
+}
+
+void TaskEngine::apply_locked(int pid, ProcessOutcome outcome) {
+    auto it = by_pid_.find(pid);
+    Entry& entry = tasks_.at(it->second);
+    by_pid_.erase(it);
+
+    entry.info.exit_code = outcome.exit_code;
+    entry.info.stdout_data = to_valid_utf8(outcome.stdout_data);
+    entry.info.stderr_data = to_valid_utf8(outcome.stderr_data);
+    entry.info.truncated = outcome.truncated;
+    entry.info.end_time = now_seconds();
+    if (entry.cancel_requested) {
+        entry.info.status = "cancelled";
+    } else {
+        entry.info.status = outcome.exit_code == 0 ? "completed" : "failed";
+    }
+
+    --running_;
+    finish_locked(entry);
+    admit_locked();
+}
+
+void TaskEngine::finish_locked(Entry& entry) {
+    if (journal_) {
+        const TaskInfo& info = entry.info;
+        journal_->transition(info.id, info.status, info.start_time, info.end_time, info.exit_code,
+                             info.stdout_data, info.stderr_data);
+    }
+    ++finished_count_;
+    finished_.push_back(entry.info);
+    finished_signal_.notify();
+}
+
+} // namespace isaac
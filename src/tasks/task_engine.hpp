@@ -0,0 +1,128 @@
+#pragma once
+
+#include "core/wake_signal.hpp"
+#include "process_executor.hpp"
+#include "task_journal.hpp"
+#include "work_stealing_pool.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+struct TaskInfo {
+    std::string id;
+    std::vector<std::string> argv;
+    std::string priority;               // "urgent", "high", "normal" or "low"
+    std::string status;                 // "pending", "running", "completed", "failed" or "cancelled"
+    std::optional<int> exit_code;
+    std::string stdout_data;
+    std::string stderr_data;
+    bool truncated = false;
+    int pid = -1;
+    double submitted_at = 0;            // unix seconds; 0 = not reached yet
+    double start_time = 0;
+    double end_time = 0;
+};
+
+struct TaskEngineStats {
+    size_t queued = 0;
+    size_t running = 0;
+    size_t max_running = 0;
+    uint64_t submitted = 0;
+    uint64_t finished = 0;
+    unsigned workers = 0;
+    uint64_t steals = 0;
+};
+
+struct TaskEngineOptions {
+    unsigned workers = 0;               // 0 = hardware concurrency
+    size_t max_running = 10;
+    size_t max_output_bytes = 16 << 20;
+    int kill_grace_ms = 5000;           // SIGTERM -> SIGKILL on cancel
+    int starvation_ms = 30000;          // a queued task this old is admitted ahead of higher classes
+};
+
+/**
+ * Background command engine behind TaskManager.
+ *
+ * Submissions beyond max_running wait in per-priority admission queues
+ * instead of being rejected; a slot is handed to the highest class first,
+ * unless a lower class has waited past starvation_ms. Spawning and result
+ * bookkeeping run on a WorkStealingPool, while a ProcessExecutor watches
+ * every child from one reactor thread. Cancelling a queued task drops it;
+ * cancelling a running one signals its whole process group.
+ *
+ * Finished tasks are delivered through wait_finished(), so callers can run
+ * their completion handlers on a thread of their choosing. With a journal
+ * attached, the running and final transitions are recorded there without
+ * blocking on disk; the caller records the task itself at submission.
+ */
+class TaskEngine {
+public:
+    explicit TaskEngine(TaskEngineOptions options = {}, std::shared_ptr<TaskJournal> journal = nullptr);
+    ~TaskEngine();
+
+    TaskEngine(const TaskEngine&) = delete;
+    TaskEngine& operator=(const TaskEngine&) = delete;
+
+    // Throws std::invalid_argument on an empty argv, unknown priority or duplicate id
+    void submit(const std::string& id, const std::vector<std::string>& argv,
+                const std::string& priority = "normal");
+
+    // False if the task is unknown or already finished
+    bool cancel(const std::string& id);
+
+    std::optional<TaskInfo> get(const std::string& id) const;
+
+    // Tasks finished since the last call, in completion order; blocks up to
+    // timeout_ms (negative = forever) while there are none
+    std::vector<TaskInfo> wait_finished(int timeout_ms);
+
+    // Drop a finished task from the table
+    bool forget(const std::string& id);
+
+    void set_max_running(size_t max_running);
+    TaskEngineStats stats() const;
+
+private:
+    struct Entry {
+        TaskInfo info;
+        int level = 2;
+        bool cancel_requested = false;
+        std::chrono::steady_clock::time_point queued_at;
+    };
+
+    void admit_locked();
+    void launch(const std::string& id);
+    void complete(int pid, ProcessOutcome outcome);
+    void apply_locked(int pid, ProcessOutcome outcome);
+    void finish_locked(Entry& entry);
+
+    TaskEngineOptions options_;
+    std::shared_ptr<TaskJournal> journal_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> tasks_;
+    std::array<std::deque<std::string>, 4> admission_;     // by level, urgent first
+    std::unordered_map<int, std::string> by_pid_;
+    std::unordered_map<int, ProcessOutcome> early_exits_;  // exited before launch() saw the pid
+    size_t running_ = 0;
+    uint64_t submitted_ = 0;
+    uint64_t finished_count_ = 0;
+    std::vector<TaskInfo> finished_;
+    WakeSignal finished_signal_;
+    bool stopping_ = false;
+
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::unique_ptr<ProcessExecutor> executor_;
+};
+
+} // namespace isaac
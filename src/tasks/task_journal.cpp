@@ -0,0 +1,323 @@
+#include "task_journal.hpp"
+#include "core/file_io.hpp"
+#include "core/mapped_file.hpp"
+#include "core/varint.hpp"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace isaac {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kCheckpointMagic[8] = {'I', 'S', 'A', 'A', 'C', 'T', 'J', '1'};
+
+enum RecordType : uint8_t { FullRecord = 1, TransitionRecord = 2, RemoveRecord = 3 };
+
+int64_t to_us(double seconds) {
+    return static_cast<int64_t>(std::llround(seconds * 1e6));
+}
+
+double from_us(int64_t us) {
+    return static_cast<double>(us) / 1e6;
+}
+
+void put_exit_code(std::vector<uint8_t>& out, std::optional<int> exit_code) {
+    out.push_back(exit_code ? 1 : 0);
+    if (exit_code) varint_encode(out, zigzag_encode(*exit_code));
+}
+
+bool read_exit_code(VarintReader& reader, std::optional<int>& exit_code) {
+    uint8_t present;
+    if (!reader.byte(present)) return false;
+    if (!present) {
+        exit_code.reset();
+        return true;
+    }
+    int64_t value;
+    if (!reader.signed_number(value)) return false;
+    exit_code = static_cast<int>(value);
+    return true;
+}
+
+// Body shared by FullRecord and checkpoint entries
+void encode_task(std::vector<uint8_t>& out, const TaskRecord& task) {
+    put_string(out, task.id);
+    put_string(out, task.command);
+    put_string(out, task.task_type);
+    put_string(out, task.priority);
+    put_string(out, task.status);
+    varint_encode(out, zigzag_encode(to_us(task.created_at)));
+    varint_encode(out, zigzag_encode(to_us(task.start_time)));
+    varint_encode(out, zigzag_encode(to_us(task.end_time)));
+    put_exit_code(out, task.exit_code);
+    put_string(out, task.stdout_data);
+    put_string(out, task.stderr_data);
+    put_string(out, task.metadata);
+}
+
+bool decode_task(VarintReader& reader, TaskRecord& task) {
+    int64_t created_us, start_us, end_us;
+    if (!reader.string(task.id) || !reader.string(task.command) || !reader.string(task.task_type) ||
+        !reader.string(task.priority) || !reader.string(task.status) || !reader.signed_number(created_us) ||
+        !reader.signed_number(start_us) || !reader.signed_number(end_us) ||
+        !read_exit_code(reader, task.exit_code) || !reader.string(task.stdout_data) ||
+        !reader.string(task.stderr_data) || !reader.string(task.metadata)) {
+        return false;
+    }
+    task.created_at = from_us(created_us);
+    task.start_time = from_us(start_us);
+    task.end_time = from_us(end_us);
+    return true;
+}
+
+std::string as_string(const std::vector<uint8_t>& bytes) {
+    return std::string(bytes.begin(), bytes.end());
+}
+
+SegmentLogOptions log_options(const TaskJournalOptions& options) {
+    SegmentLogOptions log;
+    log.segment_bytes = options.segment_bytes;
+    log.sync = options.sync;
+    return log;
+}
+
+} // namespace
+
+TaskJournal::TaskJournal(std::string dir, TaskJournalOptions options)
+    : dir_(std::move(dir)),
+      options_(options),
+      log_((fs::path(dir_) / "log").string(), log_options(options)),
+      ring_(options.ring_capacity) {
+    recover();
+    writer_ = std::thread([this] { run(); });
+}
+
+TaskJournal::~TaskJournal() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // Nothing left to report to; the log keeps whatever made it
+    }
+    stopping_.store(true);
+    wake_.notify();
+    writer_.join();
+}
+
+void TaskJournal::record(const TaskRecord& task) {
+    std::vector<uint8_t> bytes{FullRecord};
+    encode_task(bytes, task);
+    push(Op{as_string(bytes), nullptr});
+}
+
+void TaskJournal::transition(const std::string& id, const std::string& status, double start_time,
+                             double end_time, std::optional<int> exit_code, const std::string& stdout_data,
+                             const std::string& stderr_data) {
+    std::vector<uint8_t> bytes{TransitionRecord};
+    put_string(bytes, id);
+    put_string(bytes, status);
+    varint_encode(bytes, zigzag_encode(to_us(start_time)));
+    varint_encode(bytes, zigzag_encode(to_us(end_time)));
+    put_exit_code(bytes, exit_code);
+    put_string(bytes, stdout_data);
+    put_string(bytes, stderr_data);
+    push(Op{as_string(bytes), nullptr});
+}
+
+void TaskJournal::remove(const std::string& id) {
+    std::vector<uint8_t> bytes{RemoveRecord};
+    put_string(bytes, id);
+    push(Op{as_string(bytes), nullptr});
+}
+
+void TaskJournal::flush() {
+    auto barrier = std::make_shared<std::promise<void>>();
+    std::future<void> done = barrier->get_future();
+    push(Op{std::string(), std::move(barrier)});
+    done.get();
+}
+
+std::vector<TaskRecord> TaskJournal::records() {
+    flush();
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    std::vector<TaskRecord> result;
+    result.reserve(table_.size());
+    for (const auto& [id, task] : table_) result.push_back(task);
+    return result;
+}
+
+TaskJournalStats TaskJournal::stats() const {
+    TaskJournalStats stats;
+    stats.records = records_written_.load(std::memory_order_relaxed);
+    stats.batches = log_.sync_count();
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    stats.tasks = table_.size();
+    return stats;
+}
+
+void TaskJournal::push(Op op) {
+    // Once anything overflowed, keep appending there so the writer sees record order
+    if (has_overflow_.load(std::memory_order_acquire) || !ring_.try_push(std::move(op))) {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        overflow_.push_back(std::move(op));
+        has_overflow_.store(true, std::memory_order_release);
+    }
+    if (writer_idle_.exchange(false)) wake_.notify();
+}
+
+void TaskJournal::run() {
+    std::vector<Op> batch;
+    auto drain = [&] {
+        Op op;
+        while (ring_.try_pop(op)) batch.push_back(std::move(op));
+        if (has_overflow_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(overflow_mutex_);
+            while (ring_.try_pop(op)) batch.push_back(std::move(op));
+            for (auto& pending : overflow_) batch.push_back(std::move(pending));
+            overflow_.clear();
+            has_overflow_.store(false, std::memory_order_release);
+        }
+    };
+
+    while (true) {
+        drain();
+        if (batch.empty()) {
+            if (stopping_.load()) break;
+            // Announce idleness, then re-check so a push racing with it is not missed
+            writer_idle_.store(true);
+            drain();
+            if (batch.empty()) {
+                wake_.wait(-1);
+                writer_idle_.store(false);
+                continue;
+            }
+            writer_idle_.store(false);
+        }
+
+        try {
+            uint64_t lsn = 0;
+            for (const Op& op : batch) {
+                if (op.bytes.empty()) continue;
+                lsn = log_.write(op.bytes);
+                {
+                    std::lock_guard<std::mutex> lock(table_mutex_);
+                    apply(op.bytes);
+                }
+                ++records_since_checkpoint_;
+                records_written_.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (lsn) log_.sync(lsn);
+            if (records_since_checkpoint_ >= options_.checkpoint_records) checkpoint();
+
+            for (Op& op : batch) {
+                if (op.barrier) op.barrier->set_value();
+            }
+        } catch (const std::exception&) {
+            for (Op& op : batch) {
+                if (op.barrier) op.barrier->set_exception(std::current_exception());
+            }
+        }
+        batch.clear();
+    }
+}
+
+// Caller holds table_mutex_ (or is still recovering)
+bool TaskJournal::apply(std::string_view record) {
+    VarintReader reader(record);
+    uint8_t type;
+    if (!reader.byte(type)) return false;
+
+    if (type == FullRecord) {
+        TaskRecord task;
+        if (!decode_task(reader, task)) return false;
+        std::string id = task.id;
+        table_[id] = std::move(task);
+    } else if (type == TransitionRecord) {
+        std::string id, status, stdout_data, stderr_data;
+        int64_t start_us, end_us;
+        std::optional<int> exit_code;
+        if (!reader.string(id) || !reader.string(status) || !reader.signed_number(start_us) ||
+            !reader.signed_number(end_us) || !read_exit_code(reader, exit_code) || !reader.string(stdout_data) ||
+            !reader.string(stderr_data)) {
+            return false;
+        }
+        auto it = table_.find(id);
+        if (it == table_.end()) return false;
+        TaskRecord& task = it->second;
+        task.status = std::move(status);
+        task.start_time = from_us(start_us);
+        task.end_time = from_us(end_us);
+        task.exit_code = exit_code;
+        task.stdout_data = std::move(stdout_data);
+        task.stderr_data = std::move(stderr_data);
+    } else if (type == RemoveRecord) {
+        std::string id;
+        if (!reader.string(id)) return false;
+        table_.erase(id);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Writer thread, after the batch is synced: the log end is durable
+void TaskJournal::checkpoint() {
+    std::vector<uint8_t> snapshot(std::begin(kCheckpointMagic), std::end(kCheckpointMagic));
+    LogPosition position = log_.end();
+    varint_encode(snapshot, position.segment);
+    varint_encode(snapshot, position.offset);
+    {
+        std::lock_guard<std::mutex> lock(table_mutex_);
+        varint_encode(snapshot, table_.size());
+        for (const auto& [id, task] : table_) encode_task(snapshot, task);
+    }
+
+    const std::string path = checkpoint_path();
+    if (!write_file_synced(path + ".tmp", as_string(snapshot))) {
+        throw std::runtime_error("cannot write task journal checkpoint: " + path);
+    }
+    std::error_code ec;
+    fs::rename(path + ".tmp", path, ec);
+    if (ec) {
+        throw std::runtime_error("cannot write task journal checkpoint: " + path);
+    }
+    sync_directory(dir_);
+    log_.drop_before(position.segment);
+    records_since_checkpoint_ = 0;
+}
+
+void TaskJournal::recover() {
+    LogPosition from{0, 0};
+    MappedFile file;
+    if (file.open(checkpoint_path()) && file.size() >= sizeof(kCheckpointMagic) &&
+        std::memcmp(file.data(), kCheckpointMagic, sizeof(kCheckpointMagic)) == 0) {
+        VarintReader reader(file.view().substr(sizeof(kCheckpointMagic)));
+        uint64_t count;
+        bool ok = reader.number(from.segment) && reader.number(from.offset) && reader.number(count);
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            TaskRecord task;
+            ok = decode_task(reader, task);
+            if (ok) {
+                std::string id = task.id;
+                table_.emplace(std::move(id), std::move(task));
+            }
+        }
+        if (!ok) {
+            throw std::runtime_error("corrupt task journal checkpoint: " + checkpoint_path());
+        }
+    }
+
+    log_.replay(from, [this](std::string_view record) {
+        apply(record);
+        ++records_since_checkpoint_;
+    });
+}
+
+std::string TaskJournal::checkpoint_path() const {
+    return (fs::path(dir_) / "checkpoint").string();
+}
+
+} // namespace isaac
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "core/wake_signal.hpp"
+#include "queue/mpmc_ring.hpp"
+#include "queue/segment_log.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace isaac {
+
+// Persisted state of one background task, in the row shape of the old tasks table
+struct TaskRecord {
+    std::string id;
+    std::string command;
+    std::string task_type;
+    std::string priority;
+    std::string status;                 // "pending", "running", "completed", "failed" or "cancelled"
+    double created_at = 0;              // unix seconds; 0 = unset
+    double start_time = 0;
+    double end_time = 0;
+    std::optional<int> exit_code;
+    std::string stdout_data;
+    std::string stderr_data;
+    std::string metadata;               // JSON text
+};
+
+struct TaskJournalStats {
+    uint64_t records = 0;               // records written since open
+    uint64_t batches = 0;               // group commits
+    size_t tasks = 0;
+};
+
+struct TaskJournalOptions {
+    size_t segment_bytes = 4 << 20;
+    bool sync = true;
+    size_t ring_capacity = 4096;        // power of two
+    size_t checkpoint_records = 8192;   // log records between checkpoints
+};
+
+/**
+ * Asynchronous task-state journal.
+ *
+ * Producers encode a record and push it onto a lock-free MPMC ring (with a
+ * locked overflow list when it is full) and return without touching the
+ * disk. A single writer thread drains whatever has accumulated, appends it
+ * to a SegmentLog and syncs once per batch, so a burst of transitions from
+ * many tasks costs one fdatasync. flush() queues a barrier behind the
+ * caller's records and waits for the batch that contains it.
+ *
+ * The writer also maintains the folded task table; every checkpoint_records
+ * records it snapshots that table to <dir>/checkpoint and drops the covered
+ * segments. Opening a journal loads the checkpoint and replays the log
+ * after it; a torn tail from a crash mid-flush is cut off by SegmentLog.
+ */
+class TaskJournal {
+public:
+    explicit TaskJournal(std::string dir, TaskJournalOptions options = {});
+    ~TaskJournal();     // flushes
+
+    TaskJournal(const TaskJournal&) = delete;
+    TaskJournal& operator=(const TaskJournal&) = delete;
+
+    // Full record (creation, or a restored task)
+    void record(const TaskRecord& task);
+    // Status change; output and exit code ride along with the final one
+    void transition(const std::string& id, const std::string& status, double start_time, double end_time,
+                    std::optional<int> exit_code, const std::string& stdout_data,
+                    const std::string& stderr_data);
+    void remove(const std::string& id);
+
+    // Block until everything recorded before the call is durable
+    void flush();
+
+    // Folded table after a flush, ordered by id
+    std::vector<TaskRecord> records();
+
+    TaskJournalStats stats() const;
+
+private:
+    struct Op {
+        std::string bytes;                                  // encoded record; empty for a barrier
+        std::shared_ptr<std::promise<void>> barrier;
+    };
+
+    void push(Op op);
+    void run();
+    bool apply(std::string_view record);
+    void checkpoint();
+    void recover();
+    std::string checkpoint_path() const;
+
+    std::string dir_;
+    TaskJournalOptions options_;
+    SegmentLog log_;
+
+    MpmcRing<Op> ring_;
+    std::mutex overflow_mutex_;
+    std::deque<Op> overflow_;
+    std::atomic<bool> has_overflow_{false};
+
+    WakeSignal wake_;
+    std::atomic<bool> writer_idle_{false};
+    std::atomic<bool> stopping_{false};
+
+    // Owned by the writer thread after recovery; readers go through flush()
+    mutable std::mutex table_mutex_;
+    std::map<std::string, TaskRecord> table_;
+    size_t records_since_checkpoint_ = 0;
+    std::atomic<uint64_t> records_written_{0};
+
+    std::thread writer_;
+};
+
+} // namespace isaac
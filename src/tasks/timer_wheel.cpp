@@ -0,0 +1,169 @@
+#include "timer_wheel.hpp"
+#include <algorithm>
+
+namespace isaac {
+
+namespace {
+
+int count_trailing_zeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+} // namespace
+
+void TimerWheel::schedule(uint64_t id, uint64_t expires) {
+    auto it = timers_.find(id);
+    if (it != timers_.end()) {
+        unlink(id, it->second);
+        it->second.expires = expires;
+        place(id, it->second);
+        return;
+    }
+    Timer& timer = timers_[id];
+    timer.expires = expires;
+    place(id, timer);
+}
+
+bool TimerWheel::cancel(uint64_t id) {
+    auto it = timers_.find(id);
+    if (it == timers_.end()) return false;
+    unlink(id, it->second);
+    timers_.erase(it);
+    return true;
+}
+
+void TimerWheel::place(uint64_t id, Timer& timer) {
+    if (timer.expires <= now_) {
+        timer.level = -1;
+        timer.slot = 0;
+        expired_.push_back(id);
+        return;
+    }
+
+    // Lowest level whose 64-slot window (in that level's units) reaches the expiry
+    int level = kLevels - 1;
+    for (int l = 0; l < kLevels; ++l) {
+        int shift = l * kBits;
+        if ((timer.expires >> shift) - (now_ >> shift) < kSlots) {
+            level = l;
+            break;
+        }
+    }
+    int shift = level * kBits;
+    uint64_t block = std::min(timer.expires >> shift, (now_ >> shift) + kSlots - 1);
+
+    timer.level = level;
+    timer.slot = static_cast<uint32_t>(block & (kSlots - 1));
+    slots_[level][timer.slot].push_back(id);
+    occupied_[level] |= uint64_t{1} << timer.slot;
+}
+
+void TimerWheel::unlink(uint64_t id, const Timer& timer) {
+    std::vector<uint64_t>& list = timer.level < 0 ? expired_ : slots_[timer.level][timer.slot];
+    auto it = std::find(list.begin(), list.end(), id);
+    if (it != list.end()) {
+        *it = list.back();
+        list.pop_back();
+    }
+    if (timer.level >= 0 && list.empty()) {
+        occupied_[timer.level] &= ~(uint64_t{1} << timer.slot);
+    }
+}
+
+// Nearest occupied slot ahead of the current position: (distance in slots, slot)
+std::optional<std::pair<int, uint32_t>> TimerWheel::first_slot(int level) const {
+    uint64_t mask = occupied_[level];
+    if (mask == 0) return std::nullopt;
+    uint32_t position = static_cast<uint32_t>((now_ >> (level * kBits)) & (kSlots - 1));
+    uint32_t start = (position + 1) & (kSlots - 1);
+    uint64_t rotated = start == 0 ? mask : (mask >> start) | (mask << (kSlots - start));
+    int distance = count_trailing_zeros(rotated) + 1;
+    return std::make_pair(distance, static_cast<uint32_t>((position + distance) & (kSlots - 1)));
+}
+
+// Next tick at which a slot fires (level 0) or cascades (higher levels)
+std::optional<uint64_t> TimerWheel::next_event() const {
+    std::optional<uint64_t> next;
+    for (int level = 0; level < kLevels; ++level) {
+        auto slot = first_slot(level);
+        if (!slot) continue;
+        int shift = level * kBits;
+        uint64_t tick = ((now_ >> shift) + slot->first) << shift;
+        if (!next || tick < *next) next = tick;
+    }
+    return next;
+}
+
+std::optional<uint64_t> TimerWheel::next_expiry() const {
+    std::optional<uint64_t> next;
+    auto consider = [&](uint64_t id) {
+        uint64_t expires = timers_.at(id).expires;
+        if (!next || expires < *next) next = expires;
+    };
+    for (uint64_t id : expired_) consider(id);
+    if (next) return next;
+
+    // Within a level, the nearest occupied slot holds that level's earliest timers
+    for (int level = 0; level < kLevels; ++level) {
+        auto slot = first_slot(level);
+        if (!slot) continue;
+        for (uint64_t id : slots_[level][slot->second]) consider(id);
+    }
+    return next;
+}
+
+void TimerWheel::advance(uint64_t to, std::vector<uint64_t>& due) {
+    auto drain_expired = [&] {
+        std::sort(expired_.begin(), expired_.end(), [this](uint64_t a, uint64_t b) {
+            return timers_.at(a).expires < timers_.at(b).expires;
+        });
+        for (uint64_t id : expired_) {
+            timers_.erase(id);
+            due.push_back(id);
+        }
+        expired_.clear();
+    };
+    drain_expired();
+
+    std::vector<uint64_t> moving;
+    while (true) {
+        auto event = next_event();
+        if (!event || *event > to) break;
+        now_ = *event;
+
+        // Entering a new block at a higher level: push its timers down
+        for (int level = kLevels - 1; level >= 1; --level) {
+            int shift = level * kBits;
+            if ((now_ & ((uint64_t{1} << shift) - 1)) != 0) continue;
+            uint32_t slot = static_cast<uint32_t>((now_ >> shift) & (kSlots - 1));
+            if (!(occupied_[level] & (uint64_t{1} << slot))) continue;
+            moving.swap(slots_[level][slot]);
+            occupied_[level] &= ~(uint64_t{1} << slot);
+            for (uint64_t id : moving) place(id, timers_.at(id));
+            moving.clear();
+        }
+
+        uint32_t slot = static_cast<uint32_t>(now_ & (kSlots - 1));
+        if (occupied_[0] & (uint64_t{1} << slot)) {
+            for (uint64_t id : slots_[0][slot]) {
+                timers_.at(id).level = -1;
+                expired_.push_back(id);
+            }
+            slots_[0][slot].clear();
+            occupied_[0] &= ~(uint64_t{1} << slot);
+        }
+        drain_expired();
+    }
+    now_ = std::max(now_, to);
+}
+
+} // namespace isaac
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace isaac {
+
+/**
+ * Hierarchical timer wheel over integer ticks (the scheduler uses 1 ms).
+ *
+ * Six levels of 64 slots; level L covers 64^(L+1) ticks at a granularity
+ * of 64^L, so the wheel spans far beyond any cron schedule. A timer sits at
+ * the lowest level whose window still reaches its expiry and is cascaded
+ * one level down each time the wheel enters its slot. Slot occupancy is
+ * kept in a 64-bit mask per level, so finding the next event skips empty
+ * stretches in one count-trailing-zeros instead of ticking through them.
+ */
+class TimerWheel {
+public:
+    explicit TimerWheel(uint64_t now = 0) : now_(now) {}
+
+    // Add or move a timer; an expiry at or before now fires on the next advance()
+    void schedule(uint64_t id, uint64_t expires);
+    bool cancel(uint64_t id);
+    bool contains(uint64_t id) const { return timers_.count(id) != 0; }
+
+    // Move time forward, appending the ids of timers that expired (by expiry)
+    void advance(uint64_t to, std::vector<uint64_t>& due);
+
+    // Exact earliest expiry, if any timer is pending
+    std::optional<uint64_t> next_expiry() const;
+
+    uint64_t now() const { return now_; }
+    size_t size() const { return timers_.size(); }
+
+private:
+    static constexpr int kLevels = 6;
+    static constexpr int kBits = 6;
+    static constexpr uint64_t kSlots = 1u << kBits;
+
+    struct Timer {
+        uint64_t expires;
+        int level;              // -1 = in expired_
+        uint32_t slot;
+    };
+
+    void place(uint64_t id, Timer& timer);
+    void unlink(uint64_t id, const Timer& timer);
+    std::optional<uint64_t> next_event() const;
+    std::optional<std::pair<int, uint32_t>> first_slot(int level) const;
+
+    uint64_t now_;
+    std::unordered_map<uint64_t, Timer> timers_;
+    std::array<std::array<std::vector<uint64_t>, kSlots>, kLevels> slots_;
+    std::array<uint64_t, kLevels> occupied_{};
+    std::vector<uint64_t> expired_;
+};
+
+} // namespace isaac
@@ -0,0 +1,119 @@
+#include "work_stealing_pool.hpp"
+#include <algorithm>
+
+namespace isaac {
+
+namespace {
+// Owning pool and worker index of the current thread, for local posts
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local size_t current_index = 0;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(2u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread([this, i] { run(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    shutdown();
+}
+
+void WorkStealingPool::post(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        if (stopping_) return;
+    }
+
+    size_t index = current_pool == this
+        ? current_index
+        : next_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        // Count before publishing so a worker never decrements past zero
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        queued_.fetch_add(1, std::memory_order_release);
+        workers_[index]->jobs.push_back(std::move(job));
+    }
+
+    // Taking the sleep lock orders this against a worker that just saw queued_ == 0
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    sleep_cv_.notify_one();
+}
+
+void WorkStealingPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        if (stopping_) return;
+        stopping_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+bool WorkStealingPool::pop_local(size_t index, std::function<void()>& job) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.jobs.empty()) return false;
+    job = std::move(worker.jobs.back());
+    worker.jobs.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, std::function<void()>& job) {
+    size_t count = workers_.size();
+    for (size_t step = 1; step < count; ++step) {
+        Worker& victim = *workers_[(thief + step) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.jobs.empty()) continue;
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run(size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    std::function<void()> job;
+    while (true) {
+        bool found = pop_local(index, job);
+        if (!found && steal(index, job)) {
+            found = true;
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (found) {
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            job();
+            job = nullptr;
+            executed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        if (queued_.load(std::memory_order_acquire) > 0) {
+            // A try_lock steal may have skipped a busy deque; retry
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+        if (stopping_) break;
+        sleep_cv_.wait(lock, [this] {
+            return stopping_ || queued_.load(std::memory_order_acquire) > 0;
+        });
+    }
+
+    current_pool = nullptr;
+}
+
+} // namespace isaac
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace isaac {
+
+/**
+ * Fixed worker pool with per-worker deques.
+ *
+ * A job posted from a worker goes to that worker's own deque and is popped
+ * LIFO (it is likely still hot); jobs from outside threads are spread
+ * round-robin. An idle worker steals the oldest job from another worker's
+ * deque before going to sleep, so one busy producer cannot pin a backlog
+ * to a single thread.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void post(std::function<void()> job);
+
+    // Run every queued job, then join the workers; post() afterwards is dropped
+    void shutdown();
+
+    size_t thread_count() const { return workers_.size(); }
+    uint64_t executed() const { return executed_.load(std::memory_order_relaxed); }
+    uint64_t stolen() const { return stolen_.load(std::memory_order_relaxed); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> jobs;
+        std::thread thread;
+    };
+
+    void run(size_t index);
+    bool pop_local(size_t index, std::function<void()>& job);
+    bool steal(size_t thief, std::function<void()>& job);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_{0};
+    std::atomic<size_t> queued_{0};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stopping_ = false;
+};
+
+} // namespace isaac
@@ -0,0 +1,129 @@
+"""
+Test Suite for RAG local lexical search
+
+Covers query routing between the local BM25 index and the remote
+knowledge base, plus the native Bm25Index when the C++ core is built.
+"""
+
+import pytest
+from unittest.mock import Mock
+
+from isaac.ai.rag_engine import RAGQueryEngine
+
+
+# ============================================================================
+# FIXTURES
+# ============================================================================
+
+@pytest.fixture
+def local_kb():
+    """Knowledge base exposing both local and remote search."""
+    kb = Mock()
+    kb.local_index = Mock()
+    kb.local_search = Mock(return_value={
+        'success': True,
+        'results': [{'content': 'class XaiClient: ...', 'metadata': {'file': 'xai.py'}, 'score': 1.0}],
+    })
+    kb.search = Mock(return_value={
+        'success': True,
+        'results': [{'content': 'remote chunk', 'metadata': {}, 'score': 0.9}],
+    })
+    return kb
+
+
+@pytest.fixture
+def rag_engine(local_kb):
+    return RAGQueryEngine(xai_client=Mock(), knowledge_base=local_kb)
+
+
+# ============================================================================
+# ROUTING TESTS
+# ============================================================================
+
+@pytest.mark.parametrize('query', ['XaiClient', 'parse_http_request', 'config.load', 'retry backoff'])
+def test_lexical_queries_stay_local(rag_engine, local_kb, query):
+    results = rag_engine._search_codebase(query, top_k=5)
+
+    assert results[0]['metadata']['file'] == 'xai.py'
+    local_kb.search.assert_not_called()
+
+
+def test_semantic_query_uses_remote(rag_engine, local_kb):
+    results = rag_engine._search_codebase('how does authentication work', top_k=5)
+
+    assert results[0]['content'] == 'remote chunk'
+    local_kb.local_search.assert_not_called()
+
+
+def test_semantic_query_falls_back_to_local(rag_engine, local_kb):
+    local_kb.search.return_value = {'success': False, 'error': 'Project not indexed'}
+
+    results = rag_engine._search_codebase('how does authentication work', top_k=5)
+
+    assert results[0]['metadata']['file'] == 'xai.py'
+
+
+def test_without_local_index_uses_remote(local_kb):
+    local_kb.local_index = None
+    engine = RAGQueryEngine(xai_client=Mock(), knowledge_base=local_kb)
+
+    results = engine._search_codebase('XaiClient', top_k=5)
+
+    assert results[0]['content'] == 'remote chunk'
+
+
+def test_context_used_lists_only_packed_chunks(local_kb, monkeypatch):
+    from isaac.ai import rag_engine as rag_module
+    monkeypatch.setattr(rag_module, 'ContextChunk', lambda **chunk: chunk, raising=False)
+    local_kb.search.return_value = {
+        'success': True,
+        'results': [{'content': c, 'metadata': {}, 'score': 0.9} for c in ('a', 'b', 'c')],
+    }
+    engine = RAGQueryEngine(xai_client=Mock(chat=Mock(return_value='ok')), knowledge_base=local_kb)
+    engine.context_builder = Mock()
+    engine.context_builder.build.return_value = Mock(
+        context='[packed]', tokens=10, candidate_tokens=30, selected=[2, 0], overlaps_removed=1)
+
+    result = engine.query('how does authentication work')
+
+    # The builder dropped 'b', so it never reached the prompt
+    assert [chunk['content'] for chunk in result['context_used']] == ['c', 'a']
+    assert engine.last_context_stats['chunks_used'] == 2
+
+
+# ============================================================================
+# NATIVE INDEX TESTS
+# ============================================================================
+
+def test_native_bm25_identifier_search():
+    isaac_core = pytest.importorskip('isaac.isaac_core')
+    index = isaac_core.Bm25Index()
+
+    index.add_chunk('a.py', 1, 3, 'def parse_http_request(req): return req')
+    index.add_chunk('b.py', 1, 3, 'class XaiClient:\n    def chat(self): pass')
+
+    hits = index.search('parseHttpRequest', 5)
+    assert [h.file for h in hits] == ['a.py']
+
+    assert index.remove_file('b.py') == 1
+    assert index.search('XaiClient', 5) == []
+
+
+def test_native_context_builder_respects_budget():
+    isaac_core = pytest.importorskip('isaac.isaac_core')
+    lines = [f"line {i} of module" for i in range(1, 41)]
+    chunks = [
+        isaac_core.ContextChunk(file='a.py', start_line=1, end_line=20,
+                                content='\n'.join(lines[0:20]), score=0.9),
+        isaac_core.ContextChunk(file='a.py', start_line=5, end_line=10,
+                                content='\n'.join(lines[4:10]), score=0.8),
+        isaac_core.ContextChunk(file='a.py', start_line=15, end_line=30,
+                                content='\n'.join(lines[14:30]), score=0.7),
+    ]
+
+    packed = isaac_core.ContextBuilder().build(chunks, 400)
+
+    assert packed.overlaps_removed == 1
+    assert packed.selected == [0, 2]
+    assert '[a.py:21-30]' in packed.context
+    assert isaac_core.ContextBuilder.estimate_tokens(packed.context) <= 400
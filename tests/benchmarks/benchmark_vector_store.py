@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""
+Vector Store Benchmark
+Recall/latency harness for the native HNSW VectorStore on synthetic embeddings.
+
+Runs entirely on CPU with generated data (no network, no GPU):
+
+    python tests/benchmarks/benchmark_vector_store.py --count 20000 --dim 384
+"""
+
+import argparse
+import random
+import statistics
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+# Add parent to path for imports
+sys.path.insert(0, str(Path(__file__).parent.parent.parent))
+
+try:
+    from isaac.isaac_core import VectorStore
+except ImportError:
+    VectorStore = None
+
+
+def make_centroids(dim, clusters, seed):
+    rng = random.Random(seed)
+    return [[rng.gauss(0, 1) for _ in range(dim)] for _ in range(clusters)]
+
+
+def sample_vectors(centroids, count, seed):
+    """Gaussian blobs around centroids - closer to real embeddings than pure noise"""
+    rng = random.Random(seed)
+    vectors = []
+    for _ in range(count):
+        centroid = centroids[rng.randrange(len(centroids))]
+        vectors.append([c + rng.gauss(0, 0.35) for c in centroid])
+    return vectors
+
+
+def percentile(samples, pct):
+    ordered = sorted(samples)
+    index = min(len(ordered) - 1, int(round(pct / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def benchmark_build(store, vectors):
+    """Measure incremental insert throughput"""
+    print("\n1. Build (incremental insert)")
+    print("-" * 60)
+
+    start = time.perf_counter()
+    for chunk_id, vector in enumerate(vectors):
+        store.insert(chunk_id, vector)
+    elapsed = time.perf_counter() - start
+
+    print(f"  Vectors: {len(vectors)}")
+    print(f"  Total time: {elapsed:.2f}s ({len(vectors) / elapsed:.0f} inserts/sec)")
+    print(f"  Heap usage: {store.memory_usage() / (1024 * 1024):.1f} MB")
+    return {'inserts_per_sec': len(vectors) / elapsed}
+
+
+def benchmark_search(store, queries, k, ef_values, target_recall):
+    """Measure recall@k against exhaustive search and per-query latency"""
+    print(f"\n2. Search (recall@{k} vs exact scan)")
+    print("-" * 60)
+
+    truth = [{hit.chunk_id for hit in store.exact_search(q, k)} for q in queries]
+
+    results = {}
+    for ef in ef_values:
+        latencies = []
+        recall_total = 0.0
+        for query, expected in zip(queries, truth):
+            start = time.perf_counter()
+            hits = store.search(query, k, ef)
+            latencies.append((time.perf_counter() - start) * 1e6)
+            recall_total += len(expected.intersection(h.chunk_id for h in hits)) / max(1, len(expected))
+
+        recall = recall_total / len(queries)
+        status = "✅ PASS" if recall >= target_recall else "❌ FAIL"
+        print(f"  ef={ef:<4} recall={recall:.3f}  p50={percentile(latencies, 50):.0f}us  "
+              f"p99={percentile(latencies, 99):.0f}us  mean={statistics.mean(latencies):.0f}us  {status}")
+        results[ef] = {'recall': recall, 'p50_us': percentile(latencies, 50),
+                       'p99_us': percentile(latencies, 99), 'pass': recall >= target_recall}
+    return results
+
+
+def benchmark_delete(store, vectors, fraction):
+    """Tombstone a fraction of vectors and confirm they never come back"""
+    print("\n3. Delete + compact")
+    print("-" * 60)
+
+    removed = list(range(0, len(vectors), max(1, int(1 / fraction))))
+    for chunk_id in removed:
+        store.remove(chunk_id)
+
+    removed_set = set(removed)
+    leaks = sum(1 for chunk_id in removed[:200]
+                for hit in store.search(vectors[chunk_id], 10) if hit.chunk_id in removed_set)
+    print(f"  Removed: {len(removed)} (tombstones: {store.deleted_count()})")
+    print(f"  Deleted IDs returned: {leaks} {'✅' if leaks == 0 else '❌'}")
+
+    start = time.perf_counter()
+    store.compact()
+    print(f"  Compact: {time.perf_counter() - start:.2f}s, live={store.size()}")
+    return {'leaks': leaks}
+
+
+def benchmark_segment(store, queries, k):
+    """Save to a segment file and query the mmap'd copy"""
+    print("\n4. Segment save/open (mmap)")
+    print("-" * 60)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = str(Path(tmp) / "vectors.seg")
+        start = time.perf_counter()
+        store.save(path)
+        save_time = time.perf_counter() - start
+
+        start = time.perf_counter()
+        mapped = VectorStore.open(path)
+        open_time = time.perf_counter() - start
+
+        same = sum(
+            [h.chunk_id for h in store.search(q, k)] == [h.chunk_id for h in mapped.search(q, k)]
+            for q in queries
+        )
+        print(f"  Save: {save_time * 1000:.1f}ms  Open: {open_time * 1000:.1f}ms")
+        print(f"  Heap after open: {mapped.memory_usage() / (1024 * 1024):.1f} MB")
+        print(f"  Identical results: {same}/{len(queries)}")
+        return {'identical': same == len(queries)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Native VectorStore recall/latency benchmark")
+    parser.add_argument("--count", type=int, default=20000)
+    parser.add_argument("--dim", type=int, default=384)
+    parser.add_argument("--clusters", type=int, default=64)
+    parser.add_argument("--queries", type=int, default=200)
+    parser.add_argument("--k", type=int, default=10)
+    parser.add_argument("--ef", type=int, nargs="+", default=[32, 64, 128, 256])
+    parser.add_argument("--target-recall", type=float, default=0.9)
+    parser.add_argument("--seed", type=int, default=7)
+    args = parser.parse_args()
+
+    if VectorStore is None:
+        print("isaac_core not built - native VectorStore unavailable, skipping")
+        return 0
+
+    print("=" * 60)
+    print("VECTOR STORE BENCHMARK")
+    print("=" * 60)
+    print(f"count={args.count} dim={args.dim} clusters={args.clusters} k={args.k}")
+
+    centroids = make_centroids(args.dim, args.clusters, args.seed)
+    vectors = sample_vectors(centroids, args.count, args.seed + 1)
+    queries = sample_vectors(centroids, args.queries, args.seed + 2)
+
+    store = VectorStore(args.dim)
+    benchmark_build(store, vectors)
+    search_results = benchmark_search(store, queries, args.k, args.ef, args.target_recall)
+    delete_results = benchmark_delete(store, vectors, fraction=0.1)
+    segment_results = benchmark_segment(store, queries, args.k)
+
+    passed = (any(r['pass'] for r in search_results.values())
+              and delete_results['leaks'] == 0 and segment_results['identical'])
+    print("\n" + "=" * 60)
+    print("✅ ALL TARGETS MET" if passed else "❌ NEEDS IMPROVEMENT")
+    print("=" * 60)
+    return 0 if passed else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,107 @@
+"""
+Test Suite for project dependency analysis
+
+Covers analyze_dependencies, find_dependents and impacted_files. The native
+DependencyGraph tests skip when the C++ extension is not built.
+"""
+
+import pytest
+
+from isaac.core import multifile_ops
+from isaac.core.multifile_ops import MultiFileOperationManager
+
+
+# ============================================================================
+# FIXTURES
+# ============================================================================
+
+@pytest.fixture
+def project(tmp_path):
+    (tmp_path / "pkg").mkdir()
+    (tmp_path / "pkg" / "__init__.py").write_text("")
+    (tmp_path / "pkg" / "base.py").write_text("import os\n")
+    (tmp_path / "pkg" / "client.py").write_text("from . import base\nimport requests\n")
+    (tmp_path / "app.py").write_text("from pkg.client import Client\n")
+    (tmp_path / "web").mkdir()
+    (tmp_path / "web" / "index.ts").write_text(
+        "import React from 'react';\nimport { helper } from './util.js';\n"
+    )
+    (tmp_path / "web" / "util.ts").write_text("const fs = require('fs');\n")
+    return tmp_path
+
+
+@pytest.fixture
+def native_manager(project):
+    if not multifile_ops.NATIVE_GREP_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    return MultiFileOperationManager(project)
+
+
+# ============================================================================
+# ANALYZE TESTS
+# ============================================================================
+
+def test_python_fallback_reports_imports(project):
+    mgr = MultiFileOperationManager(project)
+    mgr.dependency_graph = None
+
+    result = mgr.analyze_dependencies(project / "pkg" / "client.py")
+
+    assert result["dependencies"]["from_imports"] == ["."]
+    assert result["dependencies"]["imports"] == ["requests"]
+    assert mgr.find_dependents(project / "pkg" / "base.py") == []
+
+
+def test_native_analyze_resolves_project_and_external_imports(native_manager, project):
+    result = native_manager.analyze_dependencies(project / "pkg" / "client.py")
+
+    assert result["file"] == "pkg/client.py"
+    assert result["dependencies"]["from_imports"] == ["."]
+    assert result["resolved"] == ["pkg/base.py"]
+    assert result["external"] == ["requests"]
+    assert result["dependents"] == ["app.py"]
+
+
+def test_native_analyze_resolves_typescript_paths(native_manager, project):
+    result = native_manager.analyze_dependencies(project / "web" / "index.ts")
+
+    assert result["dependencies"]["imports"] == ["react", "./util.js"]
+    assert result["resolved"] == ["web/util.ts"]
+    assert native_manager.find_dependents("fs") == ["web/util.ts"]
+
+
+# ============================================================================
+# IMPACT TESTS
+# ============================================================================
+
+def test_impacted_files_are_transitive(native_manager, project):
+    assert native_manager.impacted_files([project / "pkg" / "base.py"]) == [
+        "app.py",
+        "pkg/client.py",
+    ]
+    assert native_manager.impacted_files(["pkg/base.py"], max_depth=1) == ["pkg/client.py"]
+    assert native_manager.find_dependents("pkg/base.py", transitive=True) == [
+        "app.py",
+        "pkg/client.py",
+    ]
+
+
+def test_watched_changes_update_graph(native_manager, project):
+    native_manager.impacted_files(["pkg/base.py"])
+
+    (project / "cli.py").write_text("import pkg.base\n")
+    (project / "app.py").unlink()
+    native_manager.on_files_changed(["cli.py"], ["app.py"])
+
+    assert native_manager.impacted_files(["pkg/base.py"]) == ["cli.py", "pkg/client.py"]
+
+
+def test_graph_cache_survives_sessions(native_manager, project):
+    native_manager.impacted_files(["pkg/base.py"])
+    assert (project / ".isaac" / "dependency_graph.bin").exists()
+
+    second = MultiFileOperationManager(project)
+    graph = second._ensure_dependency_graph()
+
+    assert graph.file_count() == 6
+    assert graph.build() == 0
@@ -0,0 +1,225 @@
+"""
+Test Suite for multi-file search and replace
+
+Covers batch_search, batch_search_stream, find_definition and batch_replace
+on a small project tree. The same assertions hold for the native FileSearcher and the
+pure-Python re fallback.
+"""
+
+import pytest
+
+from isaac.core import multifile_ops
+from isaac.core.multifile_ops import MultiFileOperationManager
+
+
+# ============================================================================
+# FIXTURES
+# ============================================================================
+
+@pytest.fixture
+def project(tmp_path):
+    (tmp_path / "pkg").mkdir()
+    (tmp_path / "pkg" / "client.py").write_text(
+        "import os\n\nclass XaiClient:\n    pass\n\n\ndef connect(host):\n    return XaiClient()\n"
+    )
+    (tmp_path / "web.js").write_text("function connect(url) {\n  return fetch(url);\n}\n")
+    (tmp_path / "node_modules").mkdir()
+    (tmp_path / "node_modules" / "dep.js").write_text("function connect() {}\n")
+    (tmp_path / "blob.py").write_bytes(b"def connect(\x00\x01\x02")
+    return tmp_path
+
+
+@pytest.fixture(params=["native", "python"])
+def manager(request, project):
+    mgr = MultiFileOperationManager(project)
+    if request.param == "native":
+        if mgr.searcher is None:
+            pytest.skip("isaac_core not built")
+    else:
+        mgr.searcher = None
+        mgr.replacer = None
+        mgr.symbol_index = None
+    return mgr
+
+
+# ============================================================================
+# SEARCH TESTS
+# ============================================================================
+
+def test_batch_search_reports_lines_and_context(manager):
+    results = manager.batch_search(r"XaiClient\(\)")
+
+    assert list(results) == ["pkg/client.py"]
+    (match,) = results["pkg/client.py"]
+    assert match["line"] == 8
+    assert match["match"] == "XaiClient()"
+    assert "return XaiClient()" in match["context"]
+
+
+def test_batch_search_stream_yields_every_file(manager):
+    streamed = dict(manager.batch_search_stream(r"connect\(", ["**/*.py", "**/*.js"]))
+
+    assert "pkg/client.py" in streamed
+    assert "web.js" in streamed
+
+
+def test_find_definition_classifies_types(manager):
+    definitions = manager.find_definition("connect", ["**/*.py", "**/*.js"])
+    found = {(d["file"], d["line"], d["type"]) for d in definitions}
+
+    assert ("pkg/client.py", 7, "^def") in found
+    assert ("web.js", 1, "function") in found
+
+
+def test_batch_search_survives_a_minified_line(manager, project):
+    # std::regex recurses per character; a repeat over an 80 KB line used to
+    # overflow the stack and kill the process
+    (project / "bundle.js").write_text("var a=1;" * 10000 + "foo bar\n")
+
+    results = manager.batch_search(r"(var a=1;)+foo", ["**/*.js"])
+    (match,) = results["bundle.js"]
+    assert match["line"] == 1
+    assert match["match"] == "var a=1;" * 10000 + "foo"
+
+    streamed = dict(manager.batch_search_stream(r"(.)*bar", ["**/*.js"]))
+    assert list(streamed) == ["bundle.js"]
+
+
+# ============================================================================
+# REPLACE TESTS
+# ============================================================================
+
+def test_batch_replace_dry_run_leaves_files(manager, project):
+    result = manager.batch_replace(r"XaiClient", "GrokClient", ["**/*.py"], dry_run=True)
+
+    assert result["changes"]["pkg/client.py"]["replacements"] == 2
+    assert "XaiClient" in (project / "pkg" / "client.py").read_text()
+
+
+def test_batch_replace_applies_group_references(manager, project):
+    result = manager.batch_replace(r"def (\w+)\(host\)", r"def \1(host, port)", ["**/*.py"], dry_run=False)
+
+    assert result["total_replacements"] == 1
+    assert "def connect(host, port):" in (project / "pkg" / "client.py").read_text()
+
+
+def test_batch_replace_survives_a_minified_file(manager, project):
+    (project / "bundle.js").write_text("var a=1;" * 10000 + "foo bar\n")
+
+    result = manager.batch_replace(r"(var a=1;)+foo", "init()", ["**/*.js"], dry_run=False)
+
+    assert result["changes"]["bundle.js"]["replacements"] == 1
+    assert (project / "bundle.js").read_text() == "init() bar\n"
+
+
+# ============================================================================
+# NATIVE ENGINE TESTS
+# ============================================================================
+
+@pytest.mark.skipif(not multifile_ops.NATIVE_GREP_AVAILABLE, reason="isaac_core not built")
+def test_native_search_skips_ignored_and_binary_files(project):
+    mgr = MultiFileOperationManager(project)
+    results = mgr.batch_search(r"connect\(", ["**/*.py", "**/*.js"])
+
+    assert "node_modules/dep.js" not in results
+    assert "blob.py" not in results
+
+
+@pytest.mark.skipif(not multifile_ops.NATIVE_GREP_AVAILABLE, reason="isaac_core not built")
+def test_required_literal_extraction():
+    from isaac.isaac_core import FileSearcher
+
+    assert FileSearcher.required_literal(r"def foo\(") == "def foo("
+    assert FileSearcher.required_literal(r"a|b") == ""
+    assert FileSearcher.required_literal(r"x[abc]yz") == "yz"
+    assert FileSearcher.required_literal(r"\x41BC") == "BC"
+    assert FileSearcher.required_literal(r"\u0041BC") == "BC"
+    assert FileSearcher.required_literal(r"\cJabc") == "abc"
+    assert FileSearcher.required_literal(r"(a)\1xyz") == "xyz"
+
+
+@pytest.mark.skipif(not multifile_ops.NATIVE_GREP_AVAILABLE, reason="isaac_core not built")
+def test_max_regex_subject_scales_with_the_repeated_atom():
+    from isaac.isaac_core import FileSearcher
+
+    assert FileSearcher.max_regex_subject(r"def foo\(") > 10**9
+    assert FileSearcher.max_regex_subject(r"\d{4}-\d{2}") < 10**9
+    assert FileSearcher.max_regex_subject(r"(a|b|c|d|e)*") < FileSearcher.max_regex_subject(r"\w+")
+
+
+@pytest.mark.skipif(not multifile_ops.NATIVE_GREP_AVAILABLE, reason="isaac_core not built")
+def test_native_replace_diff_and_undo(project):
+    mgr = MultiFileOperationManager(project)
+    original = (project / "web.js").read_text()
+
+    result = mgr.batch_replace(r"fetch", "request", ["**/*.js"], dry_run=False, show_diff=True)
+    diff = result["changes"]["web.js"]["diff"]
+    assert "-  return fetch(url);" in diff
+    assert "+  return request(url);" in diff
+    assert not list(project.glob(".*.tmp"))
+
+    undo = mgr.undo_batch_replace(result["transaction_id"])
+    assert undo == {"success": True, "files_restored": 1}
+    assert (project / "web.js").read_text() == original
+
+
+@pytest.mark.skipif(not multifile_ops.NATIVE_GREP_AVAILABLE, reason="isaac_core not built")
+def test_native_dry_run_stages_nothing_and_undo_keeps_later_edits(project):
+    mgr = MultiFileOperationManager(project)
+
+    preview = mgr.batch_replace(r"fetch", "request", ["**/*.js"], dry_run=True, show_diff=True)
+    assert "+  return request(url);" in preview["changes"]["web.js"]["diff"]
+    assert not list(project.glob(".*.tmp"))
+
+    result = mgr.batch_replace(r"fetch", "request", ["**/*.js"], dry_run=False)
+    (project / "web.js").write_text("// edited after the replace\n")
+
+    undo = mgr.undo_batch_replace(result["transaction_id"])
+    assert undo["success"] is False
+    assert (project / "web.js").read_text() == "// edited after the replace\n"
+    assert mgr.undo_batch_replace(result["transaction_id"], force=True)["success"] is True
+
+
+@pytest.mark.skipif(not multifile_ops.NATIVE_GREP_AVAILABLE, reason="isaac_core not built")
+def test_symbol_index_prefix_search_and_updates(project):
+    mgr = MultiFileOperationManager(project)
+
+    assert [s["name"] for s in mgr.find_symbols("Xai")] == ["XaiClient"]
+    assert mgr.find_definition("XaiClient")[0]["kind"] == "class"
+
+    (project / "pkg" / "server.py").write_text("class XaiServer:\n    def serve(self):\n        pass\n")
+    (project / "web.js").unlink()
+    mgr.on_files_changed(["pkg/server.py"], ["web.js"])
+
+    assert [s["name"] for s in mgr.find_symbols("Xai")] == ["XaiClient", "XaiServer"]
+    assert mgr.find_symbols("serve")[0]["kind"] == "method"
+    assert {d["file"] for d in mgr.find_definition("connect", ["**/*.py", "**/*.js"])} == {"pkg/client.py"}
+
+
+@pytest.mark.skipif(not multifile_ops.NATIVE_GREP_AVAILABLE, reason="isaac_core not built")
+def test_recover_waits_for_a_commit_in_another_process(project):
+    import fcntl
+    import threading
+
+    # A commit in flight: journal still pending, journal lock held
+    journals = project / ".isaac" / "undo"
+    journal = journals / "20260101T000000-inflight"
+    journal.mkdir(parents=True)
+    (journal / "manifest").write_text("web.js\t.web.js.tmp\n")
+    (journal / "state").write_text("pending\n")
+    lock = open(journals / "lock", "w")
+    fcntl.flock(lock, fcntl.LOCK_EX)
+
+    def finish_commit():
+        (journal / "state").write_text("committed\n")
+        fcntl.flock(lock, fcntl.LOCK_UN)
+
+    timer = threading.Timer(0.2, finish_commit)
+    timer.start()
+    try:
+        MultiFileOperationManager(project)
+    finally:
+        timer.join()
+        lock.close()
+
+    assert (journal / "state").read_text() == "committed\n"
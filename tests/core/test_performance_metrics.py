@@ -0,0 +1,86 @@
+"""
+Tests for latency histograms, the metrics export and /status metrics.
+
+The monitor is forced onto its Python histograms so the tests do not
+depend on the C++ extension being built.
+"""
+
+import pytest
+
+from isaac.analytics.database import AnalyticsDatabase
+from isaac.commands.status.command_impl import StatusCommand
+from isaac.core import performance_manager
+from isaac.core.performance_manager import (
+    LatencyHistogram,
+    MetricsExporter,
+    PerformanceMonitor,
+    read_exported_metrics,
+)
+
+
+@pytest.fixture
+def monitor(monkeypatch):
+    monkeypatch.setattr(performance_manager, "NATIVE_METRICS_AVAILABLE", False)
+    return PerformanceMonitor()
+
+
+def test_histogram_buckets_cover_values():
+    for nanos in (0, 1, 15, 16, 17, 31, 32, 1000, 123456789, 2**63):
+        bucket = LatencyHistogram.bucket_of(nanos)
+        assert LatencyHistogram.bucket_floor(bucket) <= nanos < LatencyHistogram.bucket_floor(bucket + 1)
+
+
+def test_histogram_quantiles_within_bucket_error():
+    histogram = LatencyHistogram()
+    for ms in range(1, 1001):
+        histogram.record(float(ms))
+
+    stats = histogram.snapshot()
+    assert stats["count"] == 1000
+    assert stats["min_ms"] == 1.0 and stats["max_ms"] == 1000.0
+    assert stats["p50_ms"] == pytest.approx(500, rel=0.0625)
+    assert stats["p99_ms"] == pytest.approx(990, rel=0.0625)
+    assert stats["p999_ms"] == pytest.approx(999, rel=0.0625)
+    assert LatencyHistogram().snapshot()["p99_ms"] == 0.0
+
+
+def test_monitor_snapshot(monitor):
+    with monitor.time_block("router.pipe"):
+        pass
+    monitor.record_metric("boot_total_time", 120.0, "ms")
+    monitor.record_metric("boot_commands_loaded", 42, "")
+    monitor.increment("shell.failures", 2)
+
+    samples = {sample["name"]: sample for sample in monitor.snapshot()}
+    assert samples["router.pipe"]["kind"] == "histogram"
+    assert samples["router.pipe"]["count"] == 1
+    assert samples["boot_total_time"]["p50_ms"] == pytest.approx(120.0, rel=0.0625)
+    assert samples["boot_commands_loaded"] == {"name": "boot_commands_loaded", "kind": "gauge", "value": 42}
+    assert samples["shell.failures"]["value"] == 2
+
+
+def test_export_and_status_metrics(monitor, tmp_path, monkeypatch):
+    db = AnalyticsDatabase(str(tmp_path / "analytics.db"))
+    for ms in (1.0, 2.0, 3.0, 400.0):
+        monitor.record_latency("router.tier_execution", ms)
+    monitor.increment("tier.unknown_commands")
+
+    exporter = MetricsExporter(monitor, db)
+    assert exporter.export() == len(MetricsExporter.HISTOGRAM_STATS) + 1
+    exporter.export()
+
+    # Each stat keeps only its latest value, outside the row and series tables
+    assert len(db.query_metric_snapshot()) == len(MetricsExporter.HISTOGRAM_STATS) + 1
+    assert db.query_metrics("custom_metrics") == []
+
+    exported = read_exported_metrics(db)
+    assert exported["router.tier_execution"]["kind"] == "histogram"
+    assert exported["router.tier_execution"]["count"] == 4
+    assert exported["router.tier_execution"]["max_ms"] == 400.0
+    assert exported["tier.unknown_commands"]["value"] == 1
+
+    monkeypatch.setattr(performance_manager, "read_exported_metrics", lambda: read_exported_metrics(db))
+    response = StatusCommand().execute(["metrics"])
+    assert response.success
+    assert "router.tier_execution" in response.data
+    assert "p999" in response.data
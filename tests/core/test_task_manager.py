@@ -0,0 +1,197 @@
+"""
+Test Suite for TaskManager
+
+Covers the thread-per-task fallback, the native TaskEngine facade and
+TaskJournal crash recovery. The native tests skip when the C++ extension is
+not built.
+"""
+
+import os
+import signal
+import subprocess
+import sys
+import textwrap
+import time
+from pathlib import Path
+
+import pytest
+
+from isaac.core import task_manager
+from isaac.core.task_manager import TaskManager, TaskStatus
+
+
+# ============================================================================
+# FIXTURES
+# ============================================================================
+
+@pytest.fixture
+def native_manager(tmp_path):
+    if not task_manager.NATIVE_TASKS_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    manager = TaskManager(max_concurrent_tasks=1, db_path=tmp_path / "tasks.db")
+    yield manager
+    manager.shutdown()
+
+
+def wait_for(manager, task_id, timeout=10):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        task = manager.get_task(task_id)
+        if task.status not in (TaskStatus.PENDING, TaskStatus.RUNNING):
+            return task
+        time.sleep(0.02)
+    raise AssertionError(f"task {task_id} did not finish")
+
+
+# ============================================================================
+# FALLBACK TESTS
+# ============================================================================
+
+def test_fallback_runs_and_persists(tmp_path):
+    manager = TaskManager(db_path=tmp_path / "tasks.db", use_native=False)
+    done = []
+
+    task_id = manager.spawn_task("echo hello", callback=done.append)
+    task = wait_for(manager, task_id)
+
+    assert task.status == TaskStatus.COMPLETED
+    assert task.stdout == "hello\n"
+    assert done == [task]
+
+
+def test_interrupted_tasks_are_failed_on_restart(tmp_path):
+    manager = TaskManager(db_path=tmp_path / "tasks.db", use_native=False)
+    task = task_manager.Task("abc12345", "sleep 10")
+    manager._save_task_to_db(task)
+
+    reloaded = TaskManager(db_path=tmp_path / "tasks.db", use_native=False)
+
+    assert reloaded.get_task("abc12345").status == TaskStatus.FAILED
+
+
+# ============================================================================
+# NATIVE ENGINE TESTS
+# ============================================================================
+
+def test_native_queues_instead_of_rejecting(native_manager):
+    order = []
+    native_manager.on_task_complete = lambda task: order.append(task.command)
+
+    blocker = native_manager.spawn_task("sleep 0.3")
+    low = native_manager.spawn_task("echo low", priority="low")
+    urgent = native_manager.spawn_task("echo urgent", priority="urgent")
+
+    assert native_manager.get_task(low).status == TaskStatus.PENDING
+    assert native_manager.get_statistics()["engine"]["queued"] == 2
+
+    for task_id in (blocker, low, urgent):
+        assert wait_for(native_manager, task_id).status == TaskStatus.COMPLETED
+    deadline = time.time() + 5
+    while len(order) < 3 and time.time() < deadline:
+        time.sleep(0.01)
+    assert order == ["sleep 0.3", "echo urgent", "echo low"]
+
+
+def test_native_cancel_kills_process_group(native_manager):
+    task_id = native_manager.spawn_task("sh -c 'sleep 30 & sleep 30'")
+    queued = native_manager.spawn_task("echo never")
+    time.sleep(0.2)
+
+    assert native_manager.cancel_task(queued)
+    assert native_manager.cancel_task(task_id)
+
+    start = time.time()
+    while native_manager.get_statistics()["engine"]["running"] and time.time() - start < 5:
+        time.sleep(0.02)
+    assert time.time() - start < 5
+    assert native_manager.get_task(task_id).status == TaskStatus.CANCELLED
+    assert native_manager.get_task(queued).stdout == ""
+
+
+def test_native_spawn_errors_fail_the_task(native_manager):
+    task_id = native_manager.spawn_task("/nonexistent/binary --flag")
+    task = wait_for(native_manager, task_id)
+
+    assert task.status == TaskStatus.FAILED
+    assert task.exit_code == -1
+    assert "Task execution error" in task.stderr
+
+
+# ============================================================================
+# JOURNAL TESTS
+# ============================================================================
+
+JOURNAL_WRITER = textwrap.dedent(
+    """
+    import sys
+    from isaac.isaac_core import TaskJournal, TaskRecord
+
+    journal = TaskJournal(sys.argv[1], checkpoint_records=300)
+    i = 0
+    while True:
+        record = TaskRecord()
+        record.id = f"t{i:06d}"
+        record.command = "echo"
+        record.task_type = "code"
+        record.priority = "normal"
+        record.status = "pending"
+        record.created_at = 1.0
+        record.metadata = "{}"
+        journal.record(record)
+        journal.transition(record.id, "completed", 1.0, 2.0, 0, "x" * 100, "")
+        i += 1
+        if i % 50 == 0:
+            journal.flush()
+            print(i, flush=True)
+    """
+)
+
+
+def test_native_state_survives_restart(native_manager, tmp_path):
+    task_id = native_manager.spawn_task("echo persisted", metadata={"origin": "test"})
+    wait_for(native_manager, task_id)
+    native_manager._journal.flush()
+
+    reloaded = TaskManager(db_path=tmp_path / "tasks.db")
+    task = reloaded.get_task(task_id)
+
+    assert task.status == TaskStatus.COMPLETED
+    assert task.stdout == "persisted\n"
+    assert task.metadata == {"origin": "test"}
+    reloaded.shutdown()
+
+
+def test_native_shutdown_joins_collector(native_manager):
+    collector = native_manager._collector
+    native_manager.shutdown()
+
+    assert not collector.is_alive()
+
+
+@pytest.mark.parametrize("delay", [0.05, 0.15, 0.4])
+def test_journal_recovers_after_kill_mid_flush(tmp_path, delay):
+    if not task_manager.NATIVE_TASKS_AVAILABLE:
+        pytest.skip("isaac_core not built")
+
+    repo_root = Path(__file__).resolve().parents[2]
+    writer = subprocess.Popen(
+        [sys.executable, "-c", JOURNAL_WRITER, str(tmp_path / "journal")],
+        stdout=subprocess.PIPE,
+        text=True,
+        env={**os.environ, "PYTHONPATH": str(repo_root)},
+    )
+    time.sleep(delay)
+    writer.send_signal(signal.SIGKILL)
+    output, _ = writer.communicate()
+    acknowledged = int(output.split()[-1]) if output.split() else 0
+
+    records = task_manager.TaskJournal(str(tmp_path / "journal")).records()
+    ids = [record.id for record in records]
+
+    # Everything flushed before the kill is there, and nothing after a gap
+    assert len(records) >= acknowledged
+    assert ids == [f"t{i:06d}" for i in range(len(records))]
+    for record in records:
+        assert record.status in ("pending", "completed")
+        if record.status == "completed":
+            assert record.stdout == "x" * 100 and record.exit_code == 0
@@ -87,6 +87,83 @@ class TestAnalyticsDatabase:
 
             assert len(metrics) >= 1
 
+    def test_aggregate_stats_and_daily_rollups(self):
+        """Test aggregates and daily rollups over recorded values"""
+        with tempfile.TemporaryDirectory() as tmpdir:
+            db_path = os.path.join(tmpdir, "test.db")
+            db = AnalyticsDatabase(db_path)
+
+            for value in (1.0, 2.0, 6.0):
+                db.record_productivity_metric('time_saved', 'auto', value)
+            db.record_productivity_metric('command_execution', 'ls', 0.5)
+
+            stats = db.get_aggregate_stats('productivity_metrics', 'metric_value')
+            assert stats['count'] == 4
+            assert stats['sum'] == pytest.approx(9.5)
+            assert stats['min'] == 0.5 and stats['max'] == 6.0
+
+            grouped = db.get_aggregate_stats(
+                'productivity_metrics', 'metric_value', group_by='metric_type'
+            )
+            by_type = {row['metric_type']: row for row in grouped}
+            assert by_type['time_saved']['avg'] == pytest.approx(3.0)
+            assert by_type['command_execution']['count'] == 1
+
+            future = (datetime.now() + timedelta(days=1)).isoformat()
+            empty = db.get_aggregate_stats('productivity_metrics', 'metric_value', start_date=future)
+            assert empty['count'] == 0 and empty['sum'] is None
+
+            today = datetime.now().date().isoformat()
+            rollups = db.get_daily_rollups('productivity_metrics')
+            assert rollups[today]['time_saved'] == {
+                'count': 3, 'sum': 9.0, 'min': 1.0, 'max': 6.0
+            }
+            assert db.get_daily_rollups('productivity_metrics', start_date=future) == {}
+
+            trend = ProductivityTracker(db).get_efficiency_trend()
+            assert trend[-1]['date'] == today
+            assert trend[-1]['commands'] == 1
+            assert trend[-1]['time_saved'] == pytest.approx(9.0)
+
+    def test_series_store_survives_reopen(self):
+        """Test the native series store is seeded from and kept beside SQLite"""
+        from isaac.analytics import database
+
+        if not database.NATIVE_METRIC_STORE_AVAILABLE:
+            pytest.skip("isaac_core not built")
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            db_path = os.path.join(tmpdir, "test.db")
+            db = AnalyticsDatabase(db_path)
+            db.record_command_execution('git status', 0.25, True)
+            db.record_command_execution('git status', 0.75, True)
+
+            # A separate store instance reads what the shared one wrote
+            db._series.flush()
+            assert os.path.exists(os.path.join(tmpdir, "test.tsdb"))
+            store = database.MetricStore(os.path.join(tmpdir, "test.tsdb"))
+            summary = store.summarize('command_analytics/git status')
+            assert summary.count == 2 and summary.sum == pytest.approx(1.0)
+
+    def test_series_store_is_seeded_once(self):
+        """Test a second process opening the database does not import rows again"""
+        from isaac.analytics import database
+
+        if not database.NATIVE_METRIC_STORE_AVAILABLE:
+            pytest.skip("isaac_core not built")
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            db_path = os.path.join(tmpdir, "test.db")
+            db = AnalyticsDatabase(db_path)
+            db.record_command_execution('git status', 0.25, True)
+            db.record_command_execution('git status', 0.75, True)
+
+            # Nothing sealed yet, so no .tsdb: a fresh process must still skip the import
+            database._metric_stores.pop(os.path.realpath(os.path.join(tmpdir, "test.tsdb")))
+            other = AnalyticsDatabase(db_path)
+            db._series.flush()
+            assert other._series.summarize('command_analytics/git status').count == 2
+
 
 class TestProductivityTracker:
     """Test productivity tracker"""
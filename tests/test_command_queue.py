@@ -0,0 +1,201 @@
+"""
+Test Suite for the offline command queue
+
+Covers both backends of CommandQueue and the SyncWorker wakeup path. The
+native tests skip when the C++ extension is not built.
+"""
+
+import sqlite3
+import threading
+import time
+
+import pytest
+
+from isaac.queue import command_queue
+from isaac.queue.command_queue import CommandQueue
+from isaac.queue.sync_worker import SyncWorker
+
+
+# ============================================================================
+# FIXTURES
+# ============================================================================
+
+@pytest.fixture(params=["sqlite", "native"])
+def queue(request, tmp_path):
+    if request.param == "native" and not command_queue.NATIVE_QUEUE_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    return CommandQueue(tmp_path / "queue.db", use_native=request.param == "native")
+
+
+@pytest.fixture
+def native_path(tmp_path):
+    if not command_queue.NATIVE_QUEUE_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    return tmp_path / "queue.db"
+
+
+class FakeCloud:
+    def __init__(self):
+        self.available = True
+        self.routed = []
+
+    def is_available(self):
+        return self.available
+
+    def route_command(self, device, command):
+        self.routed.append((device, command))
+        return True
+
+
+# ============================================================================
+# QUEUE TESTS
+# ============================================================================
+
+def test_fifo_lifecycle(queue):
+    first = queue.enqueue("ls", "device_route", "laptop", {"user": "a"})
+    second = queue.enqueue("pwd", "meta")
+
+    pending = queue.dequeue_pending(limit=10)
+    assert [cmd["id"] for cmd in pending] == [first, second]
+    assert pending[0]["target_device"] == "laptop"
+    assert pending[1]["target_device"] is None
+    assert '"user"' in pending[0]["metadata"]
+
+    queue.mark_syncing(first)
+    queue.mark_done(first)
+    queue.mark_failed(second, "offline")
+
+    status = queue.get_queue_status()
+    assert status["done"] == 1
+    assert status["last_sync"] is not None
+
+
+def test_list_pending_does_not_claim(queue):
+    ids = [queue.enqueue(f"cmd {i}", "shell") for i in range(3)]
+
+    assert [cmd["id"] for cmd in queue.list_pending(limit=2)] == ids[:2]
+    assert [cmd["id"] for cmd in queue.list_pending(limit=10)] == ids
+    assert queue.get_queue_status()["pending"] == 3
+    assert [cmd["id"] for cmd in queue.dequeue_pending(limit=10)] == ids
+
+
+def test_wait_wakes_on_enqueue_and_notify(queue):
+    assert queue.wait(0.01) is False
+
+    threading.Timer(0.05, queue.enqueue, args=("ls", "shell")).start()
+    assert queue.wait(5) is True
+
+    queue.notify()
+    assert queue.wait(5) is True
+
+
+def test_wait_ignores_commands_already_pending(queue):
+    queue.enqueue("ls", "shell")
+    assert queue.wait(5) is True
+
+    # Still pending, but nothing new happened: the wait runs out
+    assert queue.wait(0.05) is False
+
+
+def test_native_queue_survives_reopen(native_path):
+    queue = CommandQueue(native_path)
+    ids = [queue.enqueue(f"cmd {i}", "shell") for i in range(5)]
+    claimed = queue.dequeue_pending(limit=2)
+    queue.mark_done(claimed[0]["id"])
+    del queue
+
+    reopened = CommandQueue(native_path)
+    pending = reopened.dequeue_pending(limit=10)
+
+    # The claimed-but-unfinished command returns to pending on recovery
+    assert [cmd["id"] for cmd in pending] == ids[1:]
+    assert reopened.get_queue_status()["done"] == 1
+
+
+def test_native_queues_sharing_a_log_stay_in_step(native_path):
+    # Two handles on one log stand in for the shell and a command subprocess
+    shell = CommandQueue(native_path)
+    worker = CommandQueue(native_path)
+
+    first = shell.enqueue("ls", "shell")
+    second = worker.enqueue("pwd", "shell")
+    assert first != second
+
+    claimed = worker.dequeue_pending(limit=10)
+    assert [cmd["id"] for cmd in claimed] == [first, second]
+    assert shell.dequeue_pending(limit=10) == []
+
+    # Opening while the other handle lives must not release its claims
+    assert CommandQueue(native_path).dequeue_pending(limit=10) == []
+
+    worker.mark_done(first)
+    shell.mark_failed(second, "offline")
+    status = shell.get_queue_status()
+    assert status["done"] == 1 and status["failed"] == 1
+
+    del shell, worker
+    reopened = CommandQueue(native_path)
+    assert reopened.enqueue("whoami", "shell") == second + 1
+    status = reopened.get_queue_status()
+    assert status["done"] == 1 and status["failed"] == 1 and status["pending"] == 1
+
+
+def test_native_queue_migrates_sqlite_rows(native_path):
+    legacy = CommandQueue(native_path, use_native=False)
+    legacy.enqueue("ls", "device_route", "desktop")
+    done = legacy.enqueue("pwd", "shell")
+    legacy.mark_done(done)
+
+    queue = CommandQueue(native_path)
+
+    pending = queue.dequeue_pending()
+    assert [(cmd["command_text"], cmd["target_device"]) for cmd in pending] == [("ls", "desktop")]
+    assert not native_path.exists()
+    assert native_path.with_name("queue.db.migrated").exists()
+
+
+def test_sqlite_backend_schema_unchanged(tmp_path):
+    queue = CommandQueue(tmp_path / "queue.db", use_native=False)
+    queue.enqueue("ls", "shell")
+
+    conn = sqlite3.connect(str(tmp_path / "queue.db"))
+    assert conn.execute("SELECT COUNT(*) FROM command_queue").fetchone()[0] == 1
+    conn.close()
+
+
+# ============================================================================
+# WORKER TESTS
+# ============================================================================
+
+def test_worker_wakes_on_enqueue(queue):
+    cloud = FakeCloud()
+    worker = SyncWorker(queue, cloud, check_interval=60)
+    worker.start()
+    try:
+        # First pass finds nothing, then the loop waits up to 60s
+        time.sleep(0.1)
+        queue.enqueue("ls", "device_route", "laptop")
+
+        deadline = time.time() + 5
+        while not cloud.routed and time.time() < deadline:
+            time.sleep(0.01)
+        assert cloud.routed == [("laptop", "ls")]
+    finally:
+        worker.stop()
+
+
+def test_worker_sleeps_while_cloud_is_offline(queue):
+    cloud = FakeCloud()
+    cloud.available = False
+    checks = []
+    cloud.is_available = lambda: checks.append(1) or False
+    queue.enqueue("ls", "device_route", "laptop")
+
+    worker = SyncWorker(queue, cloud, check_interval=60)
+    worker.start()
+    try:
+        time.sleep(0.3)
+        # One check, plus at most one for the enqueue signal left from before start
+        assert len(checks) <= 2
+    finally:
+        worker.stop()
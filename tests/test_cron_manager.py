@@ -0,0 +1,122 @@
+"""Tests for the periodic task scheduler."""
+
+import threading
+import time
+from datetime import datetime, timedelta
+
+import pytest
+
+from isaac.scheduler.cron_manager import NATIVE_CRON_AVAILABLE, CronManager
+
+
+@pytest.fixture(params=["python", "native"])
+def manager(request):
+    if request.param == "native" and not NATIVE_CRON_AVAILABLE:
+        pytest.skip("native scheduler not built")
+    cron = CronManager(use_native=request.param == "native")
+    yield cron
+    cron.stop()
+
+
+def test_sub_minute_interval_runs_on_schedule(manager):
+    runs = []
+    manager.register_task("tick", lambda: runs.append(time.monotonic()), interval_seconds=0.05)
+    manager.start()
+    time.sleep(0.53)
+    manager.stop()
+
+    assert 8 <= len(runs) <= 11
+    assert manager.get_task_info("tick")["runs"] == len(runs)
+
+
+def test_run_immediately_and_interval_minutes(manager):
+    ran = threading.Event()
+    manager.register_task("upload", ran.set, 60, run_immediately=True)
+    manager.start()
+
+    assert ran.wait(2)
+    info = manager.get_task_info("upload")
+    assert info["next_run"] is not None
+
+
+def test_task_registered_after_start_wakes_scheduler(manager):
+    manager.start()
+    ran = threading.Event()
+    manager.register_task("late", ran.set, interval_seconds=0.05)
+    assert ran.wait(2)
+
+
+def test_failures_are_counted_and_do_not_stop_the_schedule(manager):
+    calls = []
+
+    def flaky():
+        calls.append(1)
+        raise RuntimeError("boom")
+
+    manager.register_task("flaky", flaky, interval_seconds=0.05)
+    manager.start()
+    time.sleep(0.3)
+    manager.stop()
+
+    info = manager.get_task_info("flaky")
+    assert len(calls) >= 3
+    assert info["failures"] == len(calls)
+    assert "boom" in info["last_error"]
+
+
+def test_unregister_stops_task(manager):
+    runs = []
+    manager.register_task("gone", lambda: runs.append(1), interval_seconds=0.03)
+    manager.start()
+    time.sleep(0.15)
+    assert manager.unregister_task("gone")
+    count = len(runs)
+    time.sleep(0.15)
+
+    assert len(runs) <= count + 1
+    assert manager.get_task_info("gone") is None
+    assert not manager.unregister_task("gone")
+
+
+def test_invalid_schedules_are_rejected():
+    cron = CronManager(use_native=False)
+    with pytest.raises(ValueError):
+        cron.register_task("none", lambda: None)
+    with pytest.raises(ValueError):
+        cron.register_task("both", lambda: None, 1, interval_seconds=5)
+    with pytest.raises(ValueError):
+        cron.register_task("bad", lambda: None, interval_seconds=1, catch_up="sometimes")
+    with pytest.raises(ValueError):
+        cron.register_task("cron", lambda: None, cron="*/5 * * * *")
+
+
+def test_fallback_catch_up_policies():
+    cron = CronManager(use_native=False)
+    for policy in ("once", "skip", "all"):
+        cron.register_task(policy, lambda: None, interval_seconds=10, catch_up=policy)
+
+    # Pretend the machine slept through three occurrences
+    late = datetime.now()
+    owed = {}
+    for policy, task in cron.tasks.items():
+        task["next_run"] = late - timedelta(seconds=35)
+        owed[policy] = cron._advance(task, late)
+        assert task["next_run"] > late
+        assert task["missed"] == 3
+
+    assert owed == {"once": 1, "skip": 0, "all": 4}
+
+
+@pytest.mark.skipif(not NATIVE_CRON_AVAILABLE, reason="native scheduler not built")
+def test_native_cron_expression():
+    cron = CronManager()
+    ran = threading.Event()
+    cron.register_task("every_second", ran.set, cron="* * * * * *")
+    cron.start()
+    try:
+        assert ran.wait(3)
+        assert cron.get_task_info("every_second")["schedule"] == "* * * * * *"
+        with pytest.raises(ValueError):
+            cron.register_task("broken", lambda: None, cron="61 * * * *")
+    finally:
+        cron.stop()
@@ -9,7 +9,8 @@ import pytest
 import tempfile
 import os
 from pathlib import Path
-from isaac.tools.file_ops import ReadTool, SearchReplaceTool
+from isaac.tools import file_ops
+from isaac.tools.file_ops import EditTool, ReadTool, SearchReplaceTool
 from isaac.tools.code_analysis import CodeAnalysisTool
 
 
@@ -232,4 +233,178 @@ export default MyComponent;
             assert len(functions) >= 1  # Should find MyComponent
 
         finally:
-            os.unlink(temp_path)
\ No newline at end of file
+            os.unlink(temp_path)
+
+
+class _FakeBuffer:
+    """Pure-Python stand-in for the native EditBuffer (byte offsets, '\\n' lines)"""
+
+    def __init__(self, path):
+        self._path = path
+        self.data = Path(path).read_bytes()
+        self.flushes = 0
+        self.copies = 0
+        self.edited = False
+
+    def path(self):
+        return self._path
+
+    def valid_utf8(self):
+        return True
+
+    def has_carriage_returns(self):
+        return b"\r" in self.data
+
+    def line_count(self):
+        return len(self.data.decode().splitlines())
+
+    def lines(self, first, last):
+        return "".join(file_ops._split_lines(self.data.decode())[first:last])
+
+    def line_offset(self, line):
+        return sum(len(text.encode()) for text in file_ops._split_lines(self.data.decode())[:line])
+
+    def line_of(self, offset):
+        return self.data[:offset].count(b"\n")
+
+    def substr(self, offset, length):
+        return self.data[offset : offset + length].decode()
+
+    def text(self):
+        self.copies += 1
+        return self.data.decode()
+
+    def find_all(self, needle, limit=0):
+        positions = []
+        pos = self.data.find(needle.encode())
+        while pos != -1 and (not limit or len(positions) < limit):
+            positions.append(pos)
+            pos = self.data.find(needle.encode(), pos + len(needle.encode()))
+        return positions
+
+    def replace(self, offset, length, text):
+        self.data = self.data[:offset] + text.encode() + self.data[offset + length :]
+        self.edited = True
+
+    def replace_all(self, needle, replacement, limit=0):
+        count = len(self.find_all(needle, limit))
+        self.data = self.data.replace(needle.encode(), replacement.encode(), count)
+        self.edited = True
+        return count
+
+    def dirty(self):
+        return self.edited
+
+    def flush(self):
+        if self.edited:
+            Path(self._path).write_bytes(self.data)
+            self.flushes += 1
+            self.edited = False
+
+
+class _FakeCache:
+    def __init__(self):
+        self.buffers = {}
+
+    def open(self, path):
+        return self.buffers.setdefault(path, _FakeBuffer(path))
+
+    def evict(self, path):
+        self.buffers.pop(path, None)
+
+    def flush_all(self):
+        for buffer in self.buffers.values():
+            buffer.flush()
+
+
+class TestEditBuffers:
+    """File tools routed through cached edit buffers"""
+
+    @pytest.fixture
+    def cache(self, monkeypatch):
+        cache = _FakeCache()
+        monkeypatch.setattr(file_ops, "_BUFFER_CACHE", cache)
+        return cache
+
+    def test_edits_reuse_cached_buffer(self, cache, tmp_path):
+        path = tmp_path / "module.py"
+        path.write_text("def old():\n    return 'ü'\n\nold()\n")
+
+        result = EditTool().execute(file_path=str(path), old_string="old", new_string="new", replace_all=True)
+        assert result["replacements"] == 2
+        result = SearchReplaceTool().execute(
+            file_path=str(path), pattern=r"'(.)'", replacement=r"'\1\1'", regex=True, preview=False
+        )
+        assert result["replacements"] == 1
+
+        # The edits are written once, when the turn ends
+        assert path.read_text() == "def old():\n    return 'ü'\n\nold()\n"
+        file_ops.flush_edits()
+        assert path.read_text() == "def new():\n    return 'üü'\n\nnew()\n"
+        (buffer,) = cache.buffers.values()
+        assert buffer.flushes == 1
+
+    def test_literal_search_stays_in_buffer(self, cache, tmp_path):
+        path = tmp_path / "calls.py"
+        path.write_text("a = f(1)\nb = g(f(2))\nc = 3\n")
+
+        result = SearchReplaceTool().execute(
+            file_path=str(path), pattern="f(", replacement="h(", replace_all=True,
+            preview=False, context_lines=1,
+        )
+
+        assert [(m["line_number"], m["start_col"]) for m in result["matches"]] == [(1, 4), (2, 6)]
+        assert result["matches"][1]["context_after"] == ["c = 3\n"]
+        (buffer,) = cache.buffers.values()
+        assert buffer.copies == 0
+        file_ops.flush_edits()
+        assert path.read_text() == "a = h(1)\nb = g(h(2))\nc = 3\n"
+
+    def test_read_line_range_from_buffer(self, cache, tmp_path):
+        path = tmp_path / "notes.txt"
+        path.write_text("".join(f"line {i}\n" for i in range(1, 11)))
+
+        result = ReadTool().execute(file_path=str(path), start_line=4, end_line=6, show_line_numbers=False)
+
+        assert result["total_lines"] == 10
+        assert result["content"] == "line 4\nline 5\nline 6\n"
+
+    def test_unique_edit_is_enforced(self, cache, tmp_path):
+        path = tmp_path / "dup.txt"
+        path.write_text("x\nx\n")
+
+        result = EditTool().execute(file_path=str(path), old_string="x", new_string="y")
+
+        assert result["success"] is False
+        assert path.read_text() == "x\nx\n"
+
+    @pytest.mark.parametrize("buffered", [True, False])
+    def test_per_line_matches_on_both_paths(self, monkeypatch, tmp_path, buffered):
+        monkeypatch.setattr(file_ops, "_BUFFER_CACHE", _FakeCache() if buffered else None)
+        path = tmp_path / "anchors.txt"
+        path.write_text("x\nx\n")
+
+        result = SearchReplaceTool().execute(
+            file_path=str(path), pattern="^x", replacement="y", regex=True, replace_all=True, preview=False
+        )
+
+        assert result["replacements"] == 2
+        file_ops.flush_edits()
+        assert path.read_text() == "y\ny\n"
+
+    def test_native_buffer_round_trip(self, tmp_path):
+        isaac_core = pytest.importorskip("isaac.isaac_core")
+        path = tmp_path / "big.txt"
+        path.write_text("".join(f"row {i}\n" for i in range(1000)))
+
+        buffer = isaac_core.EditBuffer.load(str(path))
+        for i in range(100):
+            buffer.replace(buffer.line_offset(i * 10), 3, "ROW")
+        assert buffer.lines(10, 11) == "ROW 10\n"
+        assert buffer.line_of(buffer.line_offset(500)) == 500
+        assert buffer.find_all("ROW 10\nrow 11") == [buffer.line_offset(10)]  # spans two pieces
+
+        buffer.flush()
+        assert path.read_text().count("ROW") == 100
+        assert [entry.name for entry in tmp_path.iterdir()] == ["big.txt"]
+        assert buffer.piece_count() == 1
@@ -0,0 +1,93 @@
+"""
+Test Suite for memory search
+
+Runs the SQLite fallback always, and the native index path when
+isaac_core is built.
+"""
+
+import time
+
+import pytest
+
+from isaac.memory import database
+from isaac.memory.database import MemoryDatabase, MemoryEntry
+
+native = pytest.mark.skipif(not database.NATIVE_MEMORY_INDEX_AVAILABLE, reason="isaac_core not built")
+
+
+def memory(text, importance=0.5, age_days=0.0, session_id="s1", memory_type="fact", tags=None):
+    return MemoryEntry(
+        session_id=session_id,
+        timestamp=time.time() - age_days * 86400,
+        memory_type=memory_type,
+        content={"text": text},
+        importance=importance,
+        tags=tags or [],
+    )
+
+
+@pytest.fixture
+def db(tmp_path):
+    db = MemoryDatabase(tmp_path / "memory.db")
+    db.store_memory(memory("The deploy script uses rsync over ssh", importance=0.9, tags=["deploy"]))
+    db.store_memory(memory("How do I deploy the docs site", importance=0.2, memory_type="conversation"))
+    db.store_memory(memory("Python virtualenv lives in .venv", session_id="s2", tags=["python"]))
+    return db
+
+
+@pytest.fixture
+def fallback_db(tmp_path, monkeypatch):
+    monkeypatch.setattr(database, "NATIVE_MEMORY_INDEX_AVAILABLE", False)
+    return MemoryDatabase(tmp_path / "fallback.db")
+
+
+def texts(entries):
+    return [entry.content["text"] for entry in entries]
+
+
+def test_fallback_filters(fallback_db):
+    fallback_db.store_memory(memory("deploy with rsync", importance=0.9, tags=["deploy"]))
+    fallback_db.store_memory(memory("deploy the docs", importance=0.2, memory_type="conversation"))
+
+    assert texts(fallback_db.search_memories("deploy")) == ["deploy with rsync", "deploy the docs"]
+    assert texts(fallback_db.search_memories("deploy", memory_type="conversation")) == ["deploy the docs"]
+    assert texts(fallback_db.search_memories("deploy", tags=["deploy"])) == ["deploy with rsync"]
+    assert texts(fallback_db.search_memories("deploy", min_importance=0.5)) == ["deploy with rsync"]
+
+
+@native
+def test_ranked_search(db):
+    assert texts(db.search_memories("deploy")) == [
+        "The deploy script uses rsync over ssh",
+        "How do I deploy the docs site",
+    ]
+    assert texts(db.search_memories("rsync ssh", session_id="s1")) == ["The deploy script uses rsync over ssh"]
+    assert db.search_memories("deploy", session_id="s2") == []
+    assert texts(db.search_memories("deploy", tags=["deploy"])) == ["The deploy script uses rsync over ssh"]
+    assert texts(db.search_memories("docs", memory_type="conversation")) == ["How do I deploy the docs site"]
+    assert texts(db.search_memories("virtualenv", min_importance=0.5)) == ["Python virtualenv lives in .venv"]
+
+
+@native
+def test_recency_breaks_ties(db):
+    db.store_memory(memory("cache warmup notes", age_days=60))
+    db.store_memory(memory("cache warmup steps", age_days=1))
+    assert texts(db.search_memories("cache warmup")) == ["cache warmup steps", "cache warmup notes"]
+
+
+@native
+def test_index_follows_store_and_prune(db, tmp_path):
+    # A second handle on the same file shares the index
+    other = MemoryDatabase(tmp_path / "memory.db")
+    other.store_memory(memory("kubectl rollout restart", importance=0.1, age_days=90))
+    assert texts(db.search_memories("rollout")) == ["kubectl rollout restart"]
+
+    assert db.prune_old_memories(days_old=30, min_importance=0.3) == 1
+    assert db.search_memories("rollout") == []
+
+
+@native
+def test_index_catches_up_on_existing_rows(db, tmp_path, monkeypatch):
+    monkeypatch.setattr(database, "_memory_indexes", {})
+    reopened = MemoryDatabase(tmp_path / "memory.db")
+    assert texts(reopened.search_memories("virtualenv")) == ["Python virtualenv lives in .venv"]
@@ -0,0 +1,134 @@
+"""
+Test Suite for the notification message queue
+
+Covers both backends of MessageQueue. The native tests skip when the C++
+extension is not built.
+"""
+
+import sqlite3
+
+import pytest
+
+from isaac.core import message_queue
+from isaac.core.message_queue import MessagePriority, MessageQueue, MessageType
+
+
+# ============================================================================
+# FIXTURES
+# ============================================================================
+
+@pytest.fixture(params=["sqlite", "native"])
+def queue(request, tmp_path):
+    if request.param == "native" and not message_queue.NATIVE_MESSAGES_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    return MessageQueue(tmp_path / "messages.db", use_native=request.param == "native")
+
+
+# ============================================================================
+# BOTH BACKENDS
+# ============================================================================
+
+def test_prompt_indicator_tracks_pending_messages(queue):
+    assert queue.get_prompt_indicator() == "$>"
+
+    first = queue.add_message(MessageType.SYSTEM, "disk", "full", MessagePriority.URGENT)
+    queue.add_message(MessageType.CODE, "lint", "3 issues")
+    queue.add_message(MessageType.CODE, "tests", "2 failing", MessagePriority.HIGH)
+
+    assert queue.get_pending_counts() == {"system": 1, "code": 2}
+    assert queue.get_prompt_indicator() == "[3$]>"
+
+    assert queue.acknowledge_message(first)
+    assert not queue.acknowledge_message(first)
+    assert queue.get_prompt_indicator() == "[2$]>"
+    assert queue.acknowledge_all(MessageType.CODE) == 2
+    assert queue.get_prompt_indicator() == "$>"
+
+
+def test_messages_keep_row_shape(queue):
+    message_id = queue.add_message(
+        MessageType.CODE, "lint", "details", MessagePriority.HIGH, {"file": "a.py"}
+    )
+    queue.add_message(MessageType.SYSTEM, "update", "")
+
+    message = queue.get_message_by_id(message_id)
+    assert message["title"] == "lint" and message["priority"] == "high"
+    assert message["metadata"] == {"file": "a.py"} and message["status"] == "pending"
+
+    newest_first = [m["title"] for m in queue.get_messages()]
+    assert newest_first == ["update", "lint"]
+    assert [m["id"] for m in queue.get_messages(MessageType.CODE)] == [message_id]
+
+    queue.acknowledge_message(message_id)
+    assert queue.get_messages(status="acknowledged")[0]["acknowledged_at"]
+    assert len(queue.get_messages(status="all")) == 2
+
+
+def test_delete_and_clear(queue):
+    ids = [queue.add_message(MessageType.SYSTEM, f"s{i}") for i in range(3)]
+    queue.add_message(MessageType.CODE, "c")
+
+    assert queue.delete_message(ids[0]) and not queue.delete_message(ids[0])
+    queue.acknowledge_message(ids[1])
+    assert queue.clear_messages(status="acknowledged") == 1
+    assert queue.clear_messages(message_type=MessageType.SYSTEM) == 1
+    assert queue.clear_messages() == 1
+    assert queue.get_pending_counts() == {"system": 0, "code": 0}
+
+
+# ============================================================================
+# NATIVE BACKEND
+# ============================================================================
+
+@pytest.mark.skipif(not message_queue.NATIVE_MESSAGES_AVAILABLE, reason="isaac_core not built")
+def test_native_store_survives_reopen_and_compaction(tmp_path):
+    queue = MessageQueue(tmp_path / "messages.db")
+    for i in range(10):
+        queue.add_message(MessageType.CODE, f"m{i}")
+    queue.acknowledge_all()
+    queue.add_message(MessageType.SYSTEM, "kept")
+    queue._native.compact()
+
+    store = message_queue.MessageStore(str(tmp_path / "messages_log"))
+    assert store.pending_total() == 1 and store.size() == 11
+
+
+@pytest.mark.skipif(not message_queue.NATIVE_MESSAGES_AVAILABLE, reason="isaac_core not built")
+def test_native_store_migrates_sqlite_queue(tmp_path):
+    db_path = tmp_path / "messages.db"
+    old = MessageQueue(db_path, use_native=False)
+    old.add_message(MessageType.SYSTEM, "pending one", "", MessagePriority.HIGH, {"k": 1})
+    acked = old.add_message(MessageType.CODE, "done one")
+    old.acknowledge_message(acked)
+
+    queue = MessageQueue(db_path)
+
+    assert not db_path.exists()
+    assert queue.get_pending_counts() == {"system": 1, "code": 0}
+    migrated = queue.get_messages(status="all")
+    assert {m["title"] for m in migrated} == {"pending one", "done one"}
+    assert sqlite3.connect(str(db_path) + ".migrated").execute(
+        "SELECT COUNT(*) FROM messages"
+    ).fetchone() == (2,)
+
+
+@pytest.mark.skipif(not message_queue.NATIVE_MESSAGES_AVAILABLE, reason="isaac_core not built")
+def test_native_stores_sharing_a_log_stay_in_step(tmp_path):
+    # Two handles on one directory stand in for the shell and a monitor process
+    shell = message_queue.MessageStore(str(tmp_path / "log"), compact_records=4)
+    monitor = message_queue.MessageStore(str(tmp_path / "log"), compact_records=4)
+
+    first = monitor.add("system", "high", "disk")
+    second = shell.add("code", "normal", "lint")
+    assert first != second
+    assert shell.pending_total() == 2 and monitor.pending("code") == 1
+
+    assert shell.acknowledge(first)
+    assert not monitor.acknowledge(first)
+    for i in range(6):  # crosses the compaction threshold on the monitor's side
+        monitor.add("code", "low", f"m{i}")
+    assert shell.size() == 8 and shell.pending_total() == 7
+
+    shell.remove(second)
+    reopened = message_queue.MessageStore(str(tmp_path / "log"))
+    assert reopened.size() == monitor.size() == 7
@@ -0,0 +1,119 @@
+"""
+Test Suite for command profiling from exact counters
+
+The Python path (wait4 rusage) always runs; the perf_event_open path runs
+when isaac_core is built.
+"""
+
+import os
+import sys
+
+import pytest
+
+from isaac.debugging import performance_profiler
+from isaac.debugging.performance_profiler import PerformanceProfiler, run_counted
+
+pytestmark = pytest.mark.skipif(not hasattr(os, "wait4"), reason="needs wait4")
+
+CPU_LOOP = f"{sys.executable} -c 'sum(range(10**7))'"
+
+
+@pytest.fixture
+def python_counters(monkeypatch):
+    monkeypatch.setattr(performance_profiler, "NATIVE_COUNTERS_AVAILABLE", False)
+
+
+def counters(**overrides):
+    base = {
+        "wall_seconds": 1.0,
+        "user_seconds": 0.9,
+        "system_seconds": 0.05,
+        "max_rss_bytes": 10 * 1024 * 1024,
+        "major_faults": 0,
+        "voluntary_switches": 10,
+        "involuntary_switches": 10,
+        "exit_code": 0,
+        "timed_out": False,
+    }
+    base.update(overrides)
+    return base
+
+
+def test_rusage_counters(python_counters):
+    result = run_counted(CPU_LOOP)
+    assert result["exit_code"] == 0 and not result["timed_out"]
+    assert result["user_seconds"] > 0
+    assert result["max_rss_bytes"] > 1024 * 1024
+    assert "task_clock_ns" not in result
+
+    assert run_counted("exit 3")["exit_code"] == 3
+
+
+def test_timeout_kills_the_command(python_counters):
+    result = run_counted("sleep 5", timeout=1)
+    assert result["timed_out"] and result["exit_code"] == 124
+    assert result["wall_seconds"] < 3
+
+
+@pytest.mark.skipif(not performance_profiler.NATIVE_COUNTERS_AVAILABLE, reason="isaac_core not built")
+def test_native_counters():
+    result = run_counted("echo hello; true")
+    assert result["exit_code"] == 0
+    if "task_clock_ns" in result:
+        assert result["task_clock_ns"] > 0 and result["page_faults"] > 0
+
+
+def test_profile_uses_command_figures(python_counters):
+    profile = PerformanceProfiler().profile_command(CPU_LOOP)
+    assert profile.counters["exit_code"] == 0
+    assert profile.duration == profile.counters["wall_seconds"]
+    assert profile.cpu_usage > 50
+    assert "Command Counters:" in PerformanceProfiler().generate_performance_report(profile)
+
+
+def test_counter_bottlenecks():
+    profiler = PerformanceProfiler()
+
+    assert profiler._counter_bottlenecks(counters()) == []
+
+    idle = profiler._counter_bottlenecks(counters(user_seconds=0.01, system_seconds=0.01))
+    assert idle == ["Waiting on I/O or locks (CPU busy <20% of wall time)"]
+
+    perf = counters(
+        task_clock_ns=900_000_000,
+        context_switches=8000,
+        cpu_migrations=0,
+        page_faults=90_000,
+        cycles=2_000_000_000,
+        instructions=1_000_000_000,
+    )
+    assert profiler._counter_bottlenecks(perf) == [
+        "Frequent context switches (>5000/s)",
+        "Heavy page faulting (>50k faults per CPU second)",
+        "Low instructions per cycle (<0.7, stalled on memory or branches)",
+    ]
+
+    recommendations = profiler._generate_recommendations(profiler._counter_bottlenecks(perf), "make", 1.0)
+    assert "Reuse buffers instead of allocating fresh memory" in recommendations
+
+
+def test_analysis_refuses_unsafe_tiers(tmp_path):
+    from isaac.debugging.debug_command import DebugCommand
+
+    class Recorder:
+        commands = []
+
+        def profile_command(self, command):
+            self.commands.append(command)
+
+    debug = DebugCommand.__new__(DebugCommand)
+    debug.performance_profiler = Recorder()
+    marker = tmp_path / "ran"
+
+    for command in (f"rm -f {marker}", f"ls; touch {marker}", f"echo x > {marker}"):
+        result = debug.execute_performance_analysis(command, iterations=1)
+        assert result["error"].startswith("Command not profiled")
+    assert Recorder.commands == [] and not marker.exists()
+
+    debug.execute_performance_analysis("ls", iterations=1)
+    assert Recorder.commands == ["ls"]
@@ -0,0 +1,250 @@
+"""Tests for DAG pipeline execution."""
+
+import time
+
+import pytest
+
+from isaac.pipelines.executor import NATIVE_PIPELINES_AVAILABLE, StepExecutor
+from isaac.pipelines.models import Pipeline, PipelineStatus, PipelineStep, StepType
+from isaac.pipelines.runner import PipelineRunner
+
+
+def command(step_id, cmd, depends_on=(), **kwargs):
+    return PipelineStep(
+        id=step_id,
+        name=step_id,
+        type=StepType.COMMAND,
+        config={"command": cmd},
+        depends_on=list(depends_on),
+        **kwargs,
+    )
+
+
+@pytest.fixture(params=["threaded", "native"])
+def runner(request, tmp_path):
+    if request.param == "native" and not NATIVE_PIPELINES_AVAILABLE:
+        pytest.skip("native pipeline engine not built")
+    return PipelineRunner(use_native=request.param == "native", cache_dir=tmp_path / "cache")
+
+
+def test_independent_steps_run_concurrently(runner):
+    pipeline = Pipeline(
+        id="diamond",
+        name="diamond",
+        steps=[
+            command("a", "echo a"),
+            command("b", "sleep 0.4; echo b", ["a"]),
+            command("c", "sleep 0.4; echo c", ["a"]),
+            command("d", "echo d", ["b", "c"]),
+        ],
+    )
+    started = time.time()
+    execution = runner.run_pipeline_sync(pipeline)
+
+    assert execution.status == PipelineStatus.SUCCESS
+    assert time.time() - started < 1.5
+    assert set(execution.steps_results) == {"a", "b", "c", "d"}
+    path = execution.metadata["critical_path"]
+    assert path[0] == "a" and path[-1] == "d" and len(path) == 3
+
+
+def test_variables_are_substituted(runner):
+    pipeline = Pipeline(
+        id="vars",
+        name="vars",
+        variables={"name": "world"},
+        steps=[command("greet", "echo 'hello ${name} $name $names'")],
+    )
+    execution = runner.run_pipeline_sync(pipeline, {"name": "isaac"})
+
+    assert execution.steps_results["greet"]["output"] == "hello isaac isaac $names\n"
+
+
+def test_stdin_from_feeds_upstream_output(runner):
+    pipeline = Pipeline(
+        id="stdin",
+        name="stdin",
+        steps=[
+            command("produce", "printf 'b\\na\\nc\\n'"),
+            command("sort", "sort", stdin_from="produce"),
+        ],
+    )
+    execution = runner.run_pipeline_sync(pipeline)
+
+    assert execution.status == PipelineStatus.SUCCESS
+    assert execution.steps_results["sort"]["output"] == "a\nb\nc\n"
+
+
+def test_failure_stops_pipeline_and_skips_dependents(runner):
+    pipeline = Pipeline(
+        id="fail",
+        name="fail",
+        steps=[command("broken", "echo nope >&2; exit 4"), command("after", "echo x", ["broken"])],
+    )
+    execution = runner.run_pipeline_sync(pipeline)
+
+    assert execution.status == PipelineStatus.FAILED
+    assert "broken" in execution.error_message
+    assert execution.steps_results["broken"]["exit_code"] == 4
+    assert "after" not in execution.steps_results
+
+
+def test_continue_on_failure_keeps_other_branches(runner):
+    pipeline = Pipeline(
+        id="continue",
+        name="continue",
+        steps=[
+            command("broken", "exit 1", on_failure="continue"),
+            command("other", "echo fine"),
+        ],
+    )
+    execution = runner.run_pipeline_sync(pipeline)
+
+    assert execution.status == PipelineStatus.SUCCESS
+    assert execution.steps_results["other"]["success"]
+
+
+def test_stdin_consumer_of_failed_step_is_skipped(runner):
+    pipeline = Pipeline(
+        id="partial",
+        name="partial",
+        steps=[
+            command("produce", "echo partial; sleep 0.2; exit 1", on_failure="continue"),
+            command("consume", "cat", stdin_from="produce", on_failure="continue"),
+            command("after", "echo x", ["consume"]),
+        ],
+    )
+    execution = runner.run_pipeline_sync(pipeline)
+
+    assert not execution.steps_results["produce"]["success"]
+    # Streamed or not, the consumer's result on partial input never counts
+    assert not execution.steps_results.get("consume", {}).get("success", False)
+    assert "after" not in execution.steps_results
+
+
+def test_non_command_steps_run(runner):
+    pipeline = Pipeline(
+        id="mixed",
+        name="mixed",
+        variables={"ready": True},
+        steps=[
+            PipelineStep(id="wait", name="wait", type=StepType.WAIT, config={"seconds": 0.1}),
+            PipelineStep(
+                id="check",
+                name="check",
+                type=StepType.CONDITION,
+                config={"condition": "ready"},
+                depends_on=["wait"],
+            ),
+        ],
+    )
+    execution = runner.run_pipeline_sync(pipeline)
+
+    assert execution.status == PipelineStatus.SUCCESS
+    assert execution.steps_results["check"]["success"]
+
+
+def test_cycles_and_unknown_stdin_are_rejected():
+    with pytest.raises(ValueError, match="cycle"):
+        Pipeline(
+            id="cycle",
+            name="cycle",
+            steps=[command("a", "true", ["b"]), command("b", "true", ["a"])],
+        )
+    with pytest.raises(ValueError):
+        Pipeline(id="stdin", name="stdin", steps=[command("a", "cat", stdin_from="missing")])
+
+
+def test_parallel_and_loop_steps():
+    executor = StepExecutor()
+    parallel = PipelineStep(
+        id="p",
+        name="p",
+        type=StepType.PARALLEL,
+        config={"commands": ["sleep 0.3; echo one", "sleep 0.3; echo two"]},
+    )
+    result = executor.execute_step(parallel, {})
+    assert result["success"]
+    assert "one" in result["output"] and "two" in result["output"]
+    assert result["duration"] < 0.55
+
+    loop = PipelineStep(
+        id="l",
+        name="l",
+        type=StepType.LOOP,
+        config={"items": "$targets", "command": "echo build-${item}"},
+    )
+    result = executor.execute_step(loop, {"targets": "x y"})
+    assert result["success"]
+    assert "build-x" in result["output"] and "build-y" in result["output"]
+
+
+def test_step_round_trips_stdin_from():
+    pipeline = Pipeline(
+        id="rt",
+        name="rt",
+        steps=[
+            command("a", "echo"),
+            command("b", "cat", stdin_from="a", cache=True, inputs=["src"], env=["CC"]),
+        ],
+    )
+    restored = Pipeline.from_dict(pipeline.to_dict())
+
+    step = restored.get_step("b")
+    assert step.stdin_from == "a"
+    assert step.cache and step.inputs == ["src"] and step.env == ["CC"]
+    assert [step.id for step in restored.get_roots()] == ["a"]
+
+
+@pytest.mark.skipif(not NATIVE_PIPELINES_AVAILABLE, reason="native pipeline engine not built")
+def test_cached_steps_replay_until_inputs_change(tmp_path):
+    source = tmp_path / "input.txt"
+    source.write_text("one")
+    log = tmp_path / "runs.log"
+    runner = PipelineRunner(cache_dir=tmp_path / "cache")
+    pipeline = Pipeline(
+        id="cached",
+        name="cached",
+        steps=[
+            command("read", f"cat {source}; echo run >> {log}", cache=True, inputs=[str(source)]),
+            command("upper", "tr a-z A-Z", stdin_from="read", cache=True),
+        ],
+    )
+
+    first = runner.run_pipeline_sync(pipeline)
+    time.sleep(0.2)  # results are stored in the background
+    second = runner.run_pipeline_sync(pipeline)
+    source.write_text("two")
+    third = runner.run_pipeline_sync(pipeline)
+
+    assert not first.steps_results["read"]["cached"]
+    assert second.steps_results["read"]["cached"] and second.steps_results["upper"]["cached"]
+    assert second.steps_results["upper"]["output"] == "ONE"
+    assert not third.steps_results["read"]["cached"]
+    assert third.steps_results["upper"]["output"] == "TWO"
+    assert log.read_text().count("run") == 2
+
+
+@pytest.mark.skipif(not NATIVE_PIPELINES_AVAILABLE, reason="native pipeline engine not built")
+def test_cache_is_pruned_to_its_cap(tmp_path):
+    log = tmp_path / "runs.log"
+    pipeline = Pipeline(
+        id="capped",
+        name="capped",
+        steps=[command("big", f"yes | head -c 65536; echo run >> {log}", cache=True)],
+    )
+
+    runner = PipelineRunner(cache_dir=tmp_path / "cache", cache_max_bytes=32 * 1024)
+    first = runner.run_pipeline_sync(pipeline)
+    time.sleep(0.2)  # results are stored in the background
+    assert runner.step_cache.stats().actions == 1
+    second = runner.run_pipeline_sync(pipeline)
+
+    # The 64 KiB result does not fit, so the next run evicted it and ran again
+    assert not first.steps_results["big"]["cached"]
+    assert not second.steps_results["big"]["cached"]
+    assert log.read_text().count("run") == 2
+
+    time.sleep(0.2)
+    roomy = PipelineRunner(cache_dir=tmp_path / "cache", cache_max_bytes=1024 * 1024)
+    assert roomy.run_pipeline_sync(pipeline).steps_results["big"]["cached"]
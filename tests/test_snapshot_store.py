@@ -0,0 +1,242 @@
+"""
+Test Suite for bubble storage and the time machine timeline
+
+Covers both BubbleManager backends (JSON files and the native snapshot
+store), the append-only timeline file and timeline queries with and without
+the native index. The native tests skip when the C++ extension is not built.
+"""
+
+import json
+import time
+from datetime import datetime
+
+import pytest
+
+from isaac.bubbles import manager as bubble_module
+from isaac.bubbles.manager import BubbleManager, WorkspaceState
+from isaac.timemachine import time_machine as time_machine_module
+from isaac.timemachine.time_machine import TimelineEntry, TimeMachine
+
+
+def make_state(bubble_id, step=0, processes=50):
+    return WorkspaceState(
+        bubble_id=bubble_id,
+        timestamp=1700000000.0 + step,
+        name=f"Bubble {bubble_id}",
+        description="",
+        cwd="/work",
+        git_branch="main",
+        git_status={"modified": [f"file{step}.py"]},
+        environment={"PATH": "/usr/bin", "HOME": "/home/user"},
+        running_processes=[{"pid": pid, "name": f"proc{pid}"} for pid in range(processes)],
+        open_files=[],
+        system_info={"load": step},
+        tags=["timeline"],
+    )
+
+
+# ============================================================================
+# FIXTURES
+# ============================================================================
+
+@pytest.fixture(params=["json", "native"])
+def manager(request, tmp_path):
+    if request.param == "native" and not bubble_module.NATIVE_SNAPSHOTS_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    return BubbleManager(tmp_path / "bubbles", use_native=request.param == "native")
+
+
+@pytest.fixture
+def time_machine(manager, tmp_path, monkeypatch):
+    steps = iter(range(1000))
+
+    def create_bubble(name="", description="", tags=None):
+        step = next(steps)
+        state = make_state(f"b{step}", step)
+        manager._save_bubble(state)
+        return state
+
+    monkeypatch.setattr(manager, "create_bubble", create_bubble)
+    monkeypatch.setattr(manager, "restore_bubble", lambda bubble_id: True)
+    machine = TimeMachine(manager, tmp_path / "time_machine")
+    machine.stop_auto_snapshot()
+    yield machine
+
+
+# ============================================================================
+# BOTH BACKENDS
+# ============================================================================
+
+def test_bubbles_round_trip(manager):
+    manager._save_bubble(make_state("a", 1))
+    manager._save_bubble(make_state("b", 2))
+
+    assert manager.get_bubble("a") == make_state("a", 1)
+    assert [b.bubble_id for b in manager.list_bubbles()] == ["b", "a"]
+    assert manager.get_bubble("missing") is None
+
+    assert manager.delete_bubble("a")
+    assert not manager.delete_bubble("a")
+    assert [b.bubble_id for b in manager.list_bubbles()] == ["b"]
+
+
+def test_resaving_a_bubble_replaces_it(manager):
+    state = make_state("a", 1)
+    manager._save_bubble(state)
+    state.description = "suspended"
+    manager._save_bubble(state)
+
+    assert manager.get_bubble("a").description == "suspended"
+    assert len(manager.list_bubbles()) == 1
+
+
+def test_timeline_trims_old_snapshots(time_machine, manager):
+    time_machine.max_snapshots = 3
+    for _ in range(5):
+        time_machine.create_snapshot(force=True)
+
+    assert [e.bubble_id for e in time_machine.get_timeline()] == ["b4", "b3", "b2"]
+    assert manager.get_bubble("b1") is None
+    assert time_machine.timeline.current_index == 2
+
+
+def test_timeline_is_appended_and_reloaded(time_machine, manager, tmp_path):
+    time_machine.create_snapshot(force=True)
+    time_machine.create_snapshot(force=True)
+    assert time_machine.restore_to_entry(0)
+
+    lines = (tmp_path / "time_machine" / "timeline.jsonl").read_text().splitlines()
+    assert len(lines) == len(time_machine.timeline.entries)
+
+    reloaded = TimeMachine(manager, tmp_path / "time_machine")
+    reloaded.stop_auto_snapshot()
+    assert [e.bubble_id for e in reloaded.timeline.entries] == [
+        e.bubble_id for e in time_machine.timeline.entries
+    ]
+    assert reloaded.timeline.current_index == len(reloaded.timeline.entries) - 1
+
+
+def test_timeline_file_is_rewritten_when_mostly_dropped(time_machine, tmp_path):
+    time_machine.max_snapshots = 2
+    for _ in range(10):
+        time_machine.create_snapshot(force=True)
+
+    timeline_file = tmp_path / "time_machine" / "timeline.jsonl"
+    assert len(timeline_file.read_text().splitlines()) <= 2 * time_machine.max_snapshots + 1
+
+    reloaded = TimeMachine(time_machine.bubble_manager, tmp_path / "time_machine")
+    reloaded.stop_auto_snapshot()
+    assert [e.bubble_id for e in reloaded.timeline.entries] == ["b8", "b9"]
+
+
+def test_legacy_timeline_is_converted(manager, tmp_path):
+    storage = tmp_path / "time_machine"
+    storage.mkdir()
+    entry = {"timestamp": time.time(), "bubble_id": "x", "change_type": "manual",
+             "description": "", "metadata": {}}
+    (storage / "timeline.json").write_text(json.dumps({"entries": [entry], "current_index": 0}))
+
+    machine = TimeMachine(manager, storage)
+    machine.stop_auto_snapshot()
+    assert [e.bubble_id for e in machine.timeline.entries] == ["x"]
+    assert (storage / "timeline.jsonl").exists()
+    assert (storage / "timeline.json.migrated").exists()
+
+
+# ============================================================================
+# TIMELINE QUERIES
+# ============================================================================
+
+@pytest.fixture(params=["python", "native"])
+def indexed_machine(request, time_machine):
+    if request.param == "native":
+        if not time_machine_module.NATIVE_TIMELINE_AVAILABLE:
+            pytest.skip("isaac_core not built")
+    else:
+        time_machine._index = None
+    return time_machine
+
+
+def add_entry(machine, bubble_id, timestamp, branch, description=""):
+    machine._add_entry(
+        TimelineEntry(
+            timestamp=timestamp,
+            bubble_id=bubble_id,
+            change_type="manual",
+            description=description,
+            metadata={"git_branch": branch, "bubble_name": f"Timeline {bubble_id}"},
+        )
+    )
+
+
+def test_state_at_and_last_snapshot_on_branch(indexed_machine):
+    add_entry(indexed_machine, "a", 100.0, "main")
+    add_entry(indexed_machine, "b", 200.0, "dev")
+    add_entry(indexed_machine, "c", 300.0, "main")
+
+    assert indexed_machine.state_at(250).bubble_id == "b"
+    assert indexed_machine.state_at(300).bubble_id == "c"
+    assert indexed_machine.state_at(50) is None
+    assert indexed_machine.last_snapshot_on_branch("main").bubble_id == "c"
+    assert indexed_machine.last_snapshot_on_branch("main", before=250).bubble_id == "a"
+    assert indexed_machine.last_snapshot_on_branch("release") is None
+
+
+def test_search_timeline_skips_trimmed_entries(indexed_machine):
+    indexed_machine.max_snapshots = 3
+    for i, description in enumerate(["parser fix", "lexer fix", "parser cleanup", "docs"]):
+        add_entry(indexed_machine, f"b{i}", 100.0 + i, "main", description)
+        indexed_machine.bubble_manager._save_bubble(make_state(f"b{i}", i))
+        indexed_machine._cleanup_old_snapshots()
+
+    found = [r["entry"].bubble_id for r in indexed_machine.search_timeline("fix")]
+    assert found == ["b1"]
+    found = [r["entry"].bubble_id for r in indexed_machine.search_timeline("parser")]
+    assert found == ["b2"]
+    found = [r["entry"].bubble_id for r in indexed_machine.search_timeline("timeline", until=102)]
+    assert found == ["b2", "b1"]
+    assert indexed_machine.restore_to_timestamp(102.5)
+    assert indexed_machine.timeline.entries[-1].bubble_id == "b2"
+
+
+def test_parse_time():
+    now = datetime(2024, 5, 2, 9, 0, 0)
+    parse = TimeMachine.parse_time
+
+    assert parse("14:32 yesterday", now) == datetime(2024, 5, 1, 14, 32).timestamp()
+    assert parse("yesterday 14:32:10", now) == datetime(2024, 5, 1, 14, 32, 10).timestamp()
+    assert parse("8:15", now) == datetime(2024, 5, 2, 8, 15).timestamp()
+    assert parse("2h ago", now) == now.timestamp() - 7200
+    assert parse("90 minutes ago", now) == now.timestamp() - 5400
+    assert parse("2024-01-01 12:00", now) == datetime(2024, 1, 1, 12).timestamp()
+    assert parse("1700000000") == 1700000000.0
+    with pytest.raises(ValueError):
+        parse("next tuesday", now)
+
+
+# ============================================================================
+# NATIVE STORE
+# ============================================================================
+
+def test_native_store_deduplicates_consecutive_states(tmp_path):
+    if not bubble_module.NATIVE_SNAPSHOTS_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    manager = BubbleManager(tmp_path / "bubbles")
+    for step in range(20):
+        manager._save_bubble(make_state(f"b{step}", step, processes=200))
+
+    stats = manager.storage_stats()
+    assert stats["bubbles"] == 20
+    assert stats["dedup_ratio"] > 4
+    assert manager.get_bubble("b7") == make_state("b7", 7, processes=200)
+
+
+def test_native_store_imports_json_bubbles(tmp_path):
+    if not bubble_module.NATIVE_SNAPSHOTS_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    json_manager = BubbleManager(tmp_path / "bubbles", use_native=False)
+    json_manager._save_bubble(make_state("old", 1))
+
+    manager = BubbleManager(tmp_path / "bubbles")
+    assert manager.get_bubble("old") == make_state("old", 1)
+    assert not (tmp_path / "bubbles" / "old.json").exists()
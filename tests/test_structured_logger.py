@@ -0,0 +1,212 @@
+"""
+Test Suite for the structured logger
+
+Covers both backends (monthly JSONL files and the native event log). The
+native tests skip when the C++ extension is not built.
+"""
+
+import json
+import threading
+from datetime import datetime, timedelta
+
+import pytest
+
+from isaac.logging import structured_logger as logger_module
+from isaac.logging.structured_logger import StructuredLogger
+
+
+# ============================================================================
+# FIXTURES
+# ============================================================================
+
+@pytest.fixture(params=["json", "native"])
+def logger(request, tmp_path):
+    if request.param == "native" and not logger_module.NATIVE_EVENT_LOG_AVAILABLE:
+        pytest.skip("isaac_core not built")
+    return StructuredLogger(tmp_path / "logs", use_native=request.param == "native")
+
+
+def native_only():
+    if not logger_module.NATIVE_EVENT_LOG_AVAILABLE:
+        pytest.skip("isaac_core not built")
+
+
+# ============================================================================
+# BOTH BACKENDS
+# ============================================================================
+
+def test_events_round_trip(logger):
+    logger.log_pattern_learned("p1", "command_error", "typo in git", 0.8)
+    logger.log_suggestion_generated("s1", "workflow", "Run tests", "after edits", 0.6)
+    logger.log_warning("disk", "low space", "monitor", details={"free": 1.5})
+
+    patterns = logger.get_recent_patterns()
+    assert len(patterns) == 1
+    assert patterns[0].data["pattern_id"] == "p1"
+    assert patterns[0].data["confidence"] == 0.8
+    assert patterns[0].collection == "log-learning"
+    datetime.fromisoformat(patterns[0].timestamp)
+
+    warnings = logger.get_recent_warnings()
+    assert warnings[0].data["details"] == {"free": 1.5}
+    assert logger.query_collection("log-missing") == []
+
+
+def test_filters_and_limit(logger):
+    for i in range(5):
+        logger.log_pattern_learned(f"p{i}", "command_error", "", 0.5)
+        logger.log_mistake_recorded(f"m{i}", "typo", "", "fix", "low")
+
+    assert len(logger.query_collection("log-learning")) == 10
+    assert len(logger.query_collection("log-learning", event_type="mistake_recorded")) == 5
+    assert len(logger.query_collection("log-learning", limit=3)) == 3
+    future = datetime.now() + timedelta(days=1)
+    assert logger.query_collection("log-learning", since=future) == []
+
+
+def test_export_jsonl(logger, tmp_path):
+    logger.log_workflow_detected("w1", ["git add", "git commit"], 3, 0.9)
+    logger.log_workflow_detected("w2", ["make"], 2, 0.7)
+
+    out = tmp_path / "export.jsonl"
+    assert logger.export_jsonl("log-learning", out) == 2
+    lines = [json.loads(line) for line in out.read_text().splitlines()]
+    assert [line["data"]["workflow_id"] for line in lines] == ["w1", "w2"]
+    assert lines[0]["collection"] == "log-learning"
+    assert lines[0]["event_type"] == "workflow_detected"
+
+
+def test_summarize_collection(logger):
+    for i, (kind, confidence) in enumerate([("typo", 0.5), ("typo", 1.0), ("path", 0.75), ("", 0)]):
+        logger.log_pattern_learned(f"p{i}", kind, "", confidence, extra={"nested": {"ok": i % 2 == 0}})
+    logger.log_mistake_recorded("m1", "typo", "", "fix", "low")
+
+    summary = logger.summarize_collection(
+        "log-learning",
+        event_type="pattern_learned",
+        group_by=["data.pattern_type", "data.extra.nested.ok", "event_type"],
+        values=["data.confidence", "data.missing"],
+    )
+    assert summary["events"] == 4
+    assert summary["groups"]["data.pattern_type"] == {"typo": 2, "path": 1}
+    assert summary["groups"]["data.extra.nested.ok"] == {"True": 2}
+    assert summary["groups"]["event_type"] == {"pattern_learned": 4}
+    confidence = summary["values"]["data.confidence"]
+    assert (confidence["count"], confidence["min"], confidence["max"]) == (4, 0, 1.0)
+    assert confidence["avg"] == pytest.approx(2.25 / 4)
+    assert summary["values"]["data.missing"] == {"count": 0, "sum": 0, "min": None, "max": None, "avg": None}
+
+    future = datetime.now() + timedelta(days=1)
+    assert logger.summarize_collection("log-learning", since=future)["events"] == 0
+    assert logger.summarize_collection("log-missing")["events"] == 0
+
+
+def test_summarize_groups_lists_and_dicts_by_json(logger):
+    for tags in (["a", "b"], ["a", "b"], {"k": 1}, [], {}):
+        logger.log_event("tagged", "log-tags", {"tags": tags})
+
+    groups = logger.summarize_collection("log-tags", group_by=["data.tags"])["groups"]
+    assert groups["data.tags"] == {'["a", "b"]': 2, '{"k": 1}': 1}
+
+
+def test_learning_summary(logger):
+    logger.log_pattern_learned("p1", "command_error", "", 0.8)
+    logger.log_pattern_learned("p2", "command_error", "", 0.6)
+    logger.log_suggestion_generated("s1", "workflow", "Run tests", "after edits", 0.5)
+    logger.log_mistake_recorded("m1", "typo", "", "fix", "low")
+
+    summary = logger.get_learning_summary(days=7)
+    assert summary["patterns_learned"] == 2
+    assert summary["suggestions_generated"] == 1
+    assert summary["mistakes_recorded"] == 1
+    assert summary["pattern_types"] == {"command_error": 2}
+    assert summary["suggestion_types"] == {"workflow": 1}
+    assert summary["avg_pattern_confidence"] == pytest.approx(0.7)
+    assert summary["avg_suggestion_confidence"] == pytest.approx(0.5)
+
+
+def test_concurrent_logging(logger):
+    def worker(n):
+        for i in range(200):
+            logger.log_event("tick", "log-threads", {"worker": n, "i": i})
+
+    threads = [threading.Thread(target=worker, args=(n,)) for n in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    events = logger.query_collection("log-threads")
+    assert len(events) == 800
+    assert {(e.data["worker"], e.data["i"]) for e in events} == {
+        (n, i) for n in range(4) for i in range(200)
+    }
+
+
+# ============================================================================
+# NATIVE LOG
+# ============================================================================
+
+def test_native_queries_return_newest_first(tmp_path):
+    native_only()
+    logger = StructuredLogger(tmp_path / "logs")
+    for i in range(20):
+        logger.log_event("tick", "log-order", {"i": i})
+
+    assert [e.data["i"] for e in logger.query_collection("log-order", limit=3)] == [19, 18, 17]
+    assert list((tmp_path / "logs" / "log-order").glob("*.evlog"))
+    assert not list((tmp_path / "logs" / "log-order").glob("*.jsonl"))
+
+
+def test_native_log_imports_jsonl_files(tmp_path):
+    native_only()
+    json_logger = StructuredLogger(tmp_path / "logs", use_native=False)
+    json_logger.log_suggestion_accepted("s1", "ran it")
+    json_file = next((tmp_path / "logs" / "log-suggestions").glob("*.jsonl"))
+
+    logger = StructuredLogger(tmp_path / "logs")
+    events = logger.query_collection("log-suggestions")
+    assert [e.data["suggestion_id"] for e in events] == ["s1"]
+    assert not json_file.exists()
+    assert json_file.with_name(json_file.name + ".migrated").exists()
+
+
+def test_loggers_share_one_native_log(tmp_path):
+    native_only()
+    first = StructuredLogger(tmp_path / "logs")
+    second = StructuredLogger(tmp_path / "logs")
+    first.log_event("a", "log-shared", {})
+    second.log_event("b", "log-shared", {})
+
+    assert first._native is second._native
+    assert {e.event_type for e in second.query_collection("log-shared")} == {"a", "b"}
+
+
+def test_native_summary_skips_old_blocks(tmp_path):
+    native_only()
+    logger = StructuredLogger(tmp_path / "logs")
+    start = datetime(2026, 3, 15).timestamp()
+    for i in range(5000):
+        logger._native.log("log-bulk", "tick", json.dumps({"n": i}), "{}", start + i)
+
+    recent = logger._native.aggregate("log-bulk", "tick", [], ["data.n"], start + 4900)
+    assert recent.events == 100
+    assert recent.values[0].min == 4900
+    assert recent.blocks_skipped > 0 and recent.blocks_read == 1
+    assert logger._native.aggregate("log-bulk", "other").events == 0
+    assert list((tmp_path / "logs" / "log-bulk").glob("*.evidx"))
+
+
+def test_native_log_reads_past_a_torn_frame(tmp_path):
+    native_only()
+    logger = StructuredLogger(tmp_path / "logs")
+    logger.log_event("before", "log-torn", {})
+    assert len(logger.query_collection("log-torn")) == 1
+
+    # A crashed writer left half a frame; appends after it must stay readable
+    evlog = next((tmp_path / "logs" / "log-torn").glob("*.evlog"))
+    with open(evlog, "ab") as handle:
+        handle.write(b"\x40\x00\x00\x00torn")
+    logger.log_event("after", "log-torn", {})
+
+    assert [e.event_type for e in logger.query_collection("log-torn")] == ["after", "before"]
@@ -0,0 +1,76 @@
+"""
+Test Suite for the native system sampler
+
+Compares the /proc and cgroup readings with what the kernel files report
+and checks the sample ring. Skips when the C++ extension is not built or
+the platform has no /proc.
+"""
+
+import os
+import time
+
+import pytest
+
+from isaac.monitoring import system_sampler
+
+pytestmark = pytest.mark.skipif(
+    system_sampler.get_system_sampler() is None, reason="isaac_core not built or no /proc"
+)
+
+
+def meminfo_total():
+    with open("/proc/meminfo") as f:
+        for line in f:
+            if line.startswith("MemTotal:"):
+                return int(line.split()[1]) * 1024
+
+
+def test_sample_matches_kernel_files():
+    sample = system_sampler.SystemSampler().sample()
+    assert sample.sequence == 1
+    assert sample.cpu_count == os.cpu_count()
+    assert sample.memory_total == meminfo_total()
+    assert 0 < sample.memory_percent < 100
+    assert len(sample.load_average) == 3 and sample.tasks > 0
+    assert sample.disk_free > 0
+
+
+def test_ring_keeps_the_newest_samples():
+    sampler = system_sampler.SystemSampler(interval_ms=5, capacity=4)
+    assert sampler.latest().sequence == 0
+    sampler.start()
+    time.sleep(0.1)
+    sampler.stop()
+    assert not sampler.running()
+
+    samples = sampler.since(0)
+    assert len(samples) == 4
+    assert [s.sequence for s in samples] == list(range(samples[0].sequence, samples[0].sequence + 4))
+    assert samples[-1].sequence == sampler.latest().sequence
+    assert sampler.since(samples[-1].sequence) == []
+
+
+def test_cgroup_files(tmp_path):
+    (tmp_path / "cpu.stat").write_text("usage_usec 1000\nuser_usec 600\n")
+    (tmp_path / "memory.current").write_text("52428800\n")
+    (tmp_path / "memory.max").write_text("104857600\n")
+
+    sampler = system_sampler.SystemSampler(cgroup_path=str(tmp_path))
+    assert sampler.has_cgroup()
+    sample = sampler.sample()
+    assert sample.cgroup and sample.cgroup_memory_current == 52428800
+    assert system_sampler.cgroup_memory_percent(sample) == pytest.approx(50.0)
+
+    (tmp_path / "memory.max").write_text("max\n")
+    assert system_sampler.cgroup_memory_percent(sampler.sample()) is None
+
+
+def test_invalid_options():
+    with pytest.raises(ValueError):
+        system_sampler.SystemSampler(capacity=0)
+
+
+def test_sample_metrics_shape():
+    metrics = system_sampler.sample_metrics(system_sampler.latest_sample())
+    assert set(metrics) >= {"cpu_percent", "memory", "disk", "network", "load_average", "process_count"}
+    assert metrics["memory"]["total"] == meminfo_total()
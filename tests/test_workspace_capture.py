@@ -0,0 +1,108 @@
+"""
+Test Suite for native workspace capture
+
+Compares the /proc and .git readers with what git and the OS report. Skips
+when the C++ extension is not built.
+"""
+
+import os
+import shutil
+import subprocess
+import time
+
+import pytest
+
+from isaac.bubbles import manager as bubble_module
+
+pytestmark = pytest.mark.skipif(
+    not bubble_module.NATIVE_CAPTURE_AVAILABLE, reason="isaac_core not built"
+)
+
+
+def git(repo, *args):
+    subprocess.run(
+        ["git", "-c", "user.email=t@t", "-c", "user.name=t", *args],
+        cwd=repo,
+        check=True,
+        capture_output=True,
+    )
+
+
+@pytest.fixture
+def repo(tmp_path):
+    if shutil.which("git") is None:
+        pytest.skip("git not installed")
+    (tmp_path / "src").mkdir()
+    for name in ("a.py", "b.py", "c.py"):
+        (tmp_path / "src" / name).write_text(f"# {name}\n")
+    (tmp_path / ".gitignore").write_text("*.log\n")
+    git(tmp_path, "init", "-q", "-b", "main")
+    git(tmp_path, "add", "-A")
+    git(tmp_path, "commit", "-qm", "initial")
+    return tmp_path
+
+
+def test_git_state_matches_git_status(repo):
+    (repo / "src" / "a.py").write_text("# changed\n")
+    (repo / "src" / "c.py").unlink()
+    (repo / "notes.txt").write_text("new\n")
+    (repo / "debug.log").write_text("ignored\n")
+
+    state = bubble_module.WorkspaceCapture().git(str(repo / "src"))
+    assert state.is_repo and state.branch == "main" and len(state.head) == 40
+    assert list(state.modified_files) == ["src/a.py"]
+    assert list(state.deleted_files) == ["src/c.py"]
+    assert list(state.untracked_files) == ["notes.txt"]
+
+
+def test_touched_but_unchanged_file_is_clean(repo):
+    later = time.time() + 10
+    os.utime(repo / "src" / "b.py", (later, later))
+    git(repo, "update-index", "--index-version", "4")
+
+    state = bubble_module.WorkspaceCapture().git(str(repo))
+    assert list(state.modified_files) == []
+    assert state.tracked_files == 4
+
+
+def test_detached_head_has_no_branch(repo):
+    git(repo, "checkout", "-q", "--detach")
+    state = bubble_module.WorkspaceCapture().git(str(repo))
+    assert state.branch == "" and len(state.head) == 40
+
+
+def test_processes_inside_root(tmp_path):
+    held = tmp_path / "held.txt"
+    held.write_text("x")
+    child = subprocess.Popen(
+        ["python3", "-c", "import sys, time; f = open(sys.argv[1]); time.sleep(30)", str(held)],
+        cwd=tmp_path,
+    )
+    try:
+        deadline = time.time() + 5
+        found = []
+        while time.time() < deadline and not found:
+            found = [
+                p
+                for p in bubble_module.WorkspaceCapture().processes(str(tmp_path))
+                if p.pid == child.pid and str(held) in p.open_files
+            ]
+            time.sleep(0.05)
+        assert found and found[0].cwd == str(tmp_path.resolve())
+    finally:
+        child.kill()
+        child.wait()
+
+
+def test_bubble_capture_uses_native_state(tmp_path, monkeypatch):
+    monkeypatch.chdir(tmp_path)
+    (tmp_path / "recent.py").write_text("x = 1\n")
+    manager = bubble_module.BubbleManager(tmp_path / "bubbles")
+
+    assert "recent.py" in manager._get_open_files()
+    info = manager._get_system_info()
+    assert 0 < info["memory_total_gb"] and 0 <= info["disk_percent"] <= 100
+    assert manager._get_git_state() == (
+        None,
+        {"is_git_repo": False, "modified_files": [], "untracked_files": [], "staged_files": []},
+    )